@@ -0,0 +1,208 @@
+#include <Magma/Framework/File/AsyncReader.h>
+#include <Magma/Framework/File/FolderArchive.h>
+#include <Magma/Framework/File/Path.h>
+#include <Magma/Framework/Memory/Allocator.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Measures how long it takes to load ASSET_COUNT assets of different sizes from a folder archive.
+	The assets are loaded sequentially with file streams (how assets used to be loaded), sequentially with mffReadFile,
+	and in parallel with an asynchronous reader, submitted as a single batch, using only its thread pool and using its default
+	backend (io_uring on Linux, when available).
+	The files are written before each run, so they are usually on the page cache and this mostly measures the per file overhead.
+*/
+
+#define ASSET_COUNT 1000
+#define RUN_COUNT 5
+
+typedef struct
+{
+	mfsUTF8CodeUnit path[MFF_MAX_FILE_PATH_SIZE];
+	mffFile* file;
+} BenchmarkAsset;
+
+static BenchmarkAsset assets[ASSET_COUNT];
+static mffAsyncRead reads[ASSET_COUNT];
+static mfmU8* buffers[ASSET_COUNT];
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static void Report(const char* name, mfmU64 assetSize, mfmF64 elapsed)
+{
+	mfmF64 megabytes = (mfmF64)(assetSize * ASSET_COUNT) / (1024.0 * 1024.0);
+	printf("  %-28s %10.2f ms %10.1f MiB/s\n", name, elapsed * 1000.0 / RUN_COUNT, megabytes * RUN_COUNT / elapsed);
+}
+
+static void LoadWithStreams(mfmU64 assetSize)
+{
+	for (mfmU64 i = 0; i < ASSET_COUNT; ++i)
+	{
+		mfsStream* stream;
+		mfmU64 readSize;
+		if (mffOpenFile(&stream, assets[i].file, MFF_FILE_READ) != MF_ERROR_OKAY)
+			abort();
+		mfError err = mfsRead(stream, buffers[i], assetSize, &readSize);
+		if ((err != MF_ERROR_OKAY && err != MFS_ERROR_EOF) || readSize != assetSize)
+			abort();
+		mffCloseFile(stream);
+	}
+}
+
+static void LoadWithReadFile(mfmU64 assetSize)
+{
+	for (mfmU64 i = 0; i < ASSET_COUNT; ++i)
+	{
+		mfmU64 readSize;
+		if (mffReadFile(assets[i].file, 0, buffers[i], assetSize, &readSize) != MF_ERROR_OKAY || readSize != assetSize)
+			abort();
+	}
+}
+
+static void LoadAsync(mffAsyncReader* reader, mfmU64 assetSize)
+{
+	memset(reads, 0, sizeof(reads));
+	for (mfmU64 i = 0; i < ASSET_COUNT; ++i)
+	{
+		reads[i].file = assets[i].file;
+		reads[i].size = assetSize;
+		reads[i].buffer = buffers[i];
+	}
+
+	if (mffSubmitAsyncReads(reader, reads, ASSET_COUNT) != MF_ERROR_OKAY ||
+		mffWaitForAsyncReads(reads, ASSET_COUNT) != MF_ERROR_OKAY)
+		abort();
+	for (mfmU64 i = 0; i < ASSET_COUNT; ++i)
+		if (reads[i].readSize != assetSize)
+			abort();
+}
+
+static void Run(mfmU64 assetSize, mffAsyncReader* threadReader, mffAsyncReader* defaultReader)
+{
+	printf("%llu assets of %llu bytes:\n", (unsigned long long)ASSET_COUNT, (unsigned long long)assetSize);
+
+	// Create assets
+	mfmU8* data = malloc(assetSize);
+	if (data == NULL)
+		abort();
+	for (mfmU64 i = 0; i < assetSize; ++i)
+		data[i] = (mfmU8)(i * 31);
+
+	for (mfmU64 i = 0; i < ASSET_COUNT; ++i)
+	{
+		mfsStringStream ss;
+		if (mfsCreateLocalStringStream(&ss, assets[i].path, sizeof(assets[i].path)) != MF_ERROR_OKAY ||
+			mfsPrintFormat(&ss, u8"/bench/asyncReaderBenchmark/asset%d.bin", (mfmI32)i) != MF_ERROR_OKAY)
+			abort();
+		mfsDestroyLocalStringStream(&ss);
+
+		mfsStream* stream;
+		if (mffCreateFile(&assets[i].file, assets[i].path) != MF_ERROR_OKAY ||
+			mffOpenFile(&stream, assets[i].file, MFF_FILE_WRITE) != MF_ERROR_OKAY ||
+			mfsWrite(stream, data, assetSize, NULL) != MF_ERROR_OKAY)
+			abort();
+		mffCloseFile(stream);
+
+		buffers[i] = malloc(assetSize);
+		if (buffers[i] == NULL)
+			abort();
+	}
+
+	mfmF64 start = GetSeconds();
+	for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+		LoadWithStreams(assetSize);
+	Report("sequential streams", assetSize, GetSeconds() - start);
+
+	start = GetSeconds();
+	for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+		LoadWithReadFile(assetSize);
+	Report("sequential mffReadFile", assetSize, GetSeconds() - start);
+
+	start = GetSeconds();
+	for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+		LoadAsync(threadReader, assetSize);
+	Report("async (thread pool)", assetSize, GetSeconds() - start);
+
+	mffEnum backend;
+	if (mffGetAsyncReaderBackend(defaultReader, &backend) != MF_ERROR_OKAY)
+		abort();
+	if (backend == MFF_ASYNC_READER_IO_URING)
+	{
+		start = GetSeconds();
+		for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+			LoadAsync(defaultReader, assetSize);
+		Report("async (io_uring)", assetSize, GetSeconds() - start);
+	}
+
+	for (mfmU64 i = 0; i < ASSET_COUNT; ++i)
+		if (memcmp(buffers[i], data, assetSize) != 0)
+			abort();
+
+	// Delete assets
+	for (mfmU64 i = 0; i < ASSET_COUNT; ++i)
+	{
+		if (mffDeleteFile(assets[i].file) != MF_ERROR_OKAY)
+			abort();
+		free(buffers[i]);
+	}
+	free(data);
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	mfsUTF8CodeUnit archivePath[MFF_MAX_FILE_PATH_SIZE];
+	{
+		mfsStringStream ss;
+		if (mfsCreateLocalStringStream(&ss, archivePath, sizeof(archivePath)) != MF_ERROR_OKAY ||
+			mfsPutString(&ss, mffMagmaRootDirectory) != MF_ERROR_OKAY ||
+			mfsPutString(&ss, u8"/resources/FileSystem-Example") != MF_ERROR_OKAY)
+			abort();
+		mfsDestroyLocalStringStream(&ss);
+	}
+
+	mffArchive* archive;
+	if (mffCreateFolderArchive(&archive, NULL, archivePath) != MF_ERROR_OKAY ||
+		mffRegisterArchive(archive, u8"bench") != MF_ERROR_OKAY)
+		abort();
+
+	mffDirectory* root;
+	if (mffCreateDirectory(&root, u8"/bench/asyncReaderBenchmark") != MF_ERROR_OKAY)
+		abort();
+
+	mffAsyncReaderDesc desc;
+	desc.threadCount = 0;
+	desc.queueSize = 0;
+	desc.backend = MFF_ASYNC_READER_THREADS;
+	mffAsyncReader* threadReader;
+	mffAsyncReader* defaultReader;
+	if (mffCreateAsyncReader(&threadReader, &desc, NULL) != MF_ERROR_OKAY ||
+		mffCreateAsyncReader(&defaultReader, NULL, NULL) != MF_ERROR_OKAY)
+		abort();
+
+	Run(4 * 1024, threadReader, defaultReader);
+	Run(64 * 1024, threadReader, defaultReader);
+	Run(1024 * 1024, threadReader, defaultReader);
+
+	mffDestroyAsyncReader(defaultReader);
+	mffDestroyAsyncReader(threadReader);
+
+	if (mffDeleteDirectory(root) != MF_ERROR_OKAY ||
+		mffUnregisterArchive(archive) != MF_ERROR_OKAY)
+		abort();
+
+	mfTerminate();
+	return 0;
+}
@@ -0,0 +1,203 @@
+#include <Magma/Framework/File/FolderArchive.h>
+#include <Magma/Framework/File/Path.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Thread/Thread.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Measures folder archive lookups per second (mffGetFile) against the number of files in the archive.
+	The files are spread over directories with FILES_PER_DIRECTORY files each, and are deleted after each run.
+	Lookups are compared against a linear strcmp scan over the same paths, which is how the archive used to find files,
+	and are also run from THREAD_COUNT threads at once, since lookups only take the archive lock for reading.
+*/
+
+#define FILES_PER_DIRECTORY 100
+#define LOOKUP_COUNT 1000000
+#define LINEAR_LOOKUP_WORK 100000000
+#define THREAD_COUNT 4
+
+typedef struct
+{
+	mfsUTF8CodeUnit path[MFF_MAX_FILE_PATH_SIZE];
+} BenchmarkPath;
+
+typedef struct
+{
+	mfmU64 seed;
+	mfmU64 found;
+} BenchmarkThread;
+
+static BenchmarkPath* paths;
+static mfmU64 pathCount;
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static mfmU64 NextRandom(mfmU64* state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+static void Report(const char* name, mfmU64 lookups, mfmF64 start)
+{
+	mfmF64 elapsed = GetSeconds() - start;
+	printf("  %-28s %12.0f lookups/s\n", name, (mfmF64)lookups / elapsed);
+}
+
+static void LookupThread(void* args)
+{
+	BenchmarkThread* thread = args;
+	for (mfmU64 i = 0; i < LOOKUP_COUNT; ++i)
+	{
+		mffFile* file;
+		if (mffGetFile(&file, paths[NextRandom(&thread->seed) % pathCount].path) == MF_ERROR_OKAY)
+			++thread->found;
+	}
+}
+
+static void Run(mfmU64 fileCount)
+{
+	printf("%llu files:\n", (unsigned long long)fileCount);
+
+	// Create files
+	paths = malloc(fileCount * sizeof(BenchmarkPath));
+	mffFile** files = malloc(fileCount * sizeof(mffFile*));
+	mffDirectory** dirs = malloc((fileCount / FILES_PER_DIRECTORY + 1) * sizeof(mffDirectory*));
+	if (paths == NULL || files == NULL || dirs == NULL)
+		abort();
+
+	mfmU64 dirCount = 0;
+	mfsUTF8CodeUnit dirPath[MFF_MAX_FILE_PATH_SIZE];
+	for (pathCount = 0; pathCount < fileCount; ++pathCount)
+	{
+		mfsStringStream ss;
+		if (pathCount % FILES_PER_DIRECTORY == 0)
+		{
+			if (mfsCreateLocalStringStream(&ss, dirPath, sizeof(dirPath)) != MF_ERROR_OKAY ||
+				mfsPrintFormat(&ss, u8"/bench/folderArchiveBenchmark/dir%d", (mfmI32)dirCount) != MF_ERROR_OKAY)
+				abort();
+			mfsDestroyLocalStringStream(&ss);
+			if (mffCreateDirectory(&dirs[dirCount++], dirPath) != MF_ERROR_OKAY)
+				abort();
+		}
+
+		if (mfsCreateLocalStringStream(&ss, paths[pathCount].path, sizeof(paths[pathCount].path)) != MF_ERROR_OKAY ||
+			mfsPrintFormat(&ss, u8"%s/asset%d.bin", dirPath, (mfmI32)pathCount) != MF_ERROR_OKAY)
+			abort();
+		mfsDestroyLocalStringStream(&ss);
+		if (mffCreateFile(&files[pathCount], paths[pathCount].path) != MF_ERROR_OKAY)
+			abort();
+	}
+
+	// Linear scan
+	mfmU64 state = 0x9E3779B97F4A7C15;
+	mfmU64 linearLookups = LINEAR_LOOKUP_WORK / fileCount;
+	mfmU64 found = 0;
+	mfmF64 start = GetSeconds();
+	for (mfmU64 i = 0; i < linearLookups; ++i)
+	{
+		const mfsUTF8CodeUnit* path = paths[NextRandom(&state) % pathCount].path;
+		for (mfmU64 j = 0; j < pathCount; ++j)
+			if (strcmp(paths[j].path, path) == 0)
+			{
+				++found;
+				break;
+			}
+	}
+	Report("linear strcmp scan", linearLookups, start);
+	if (found != linearLookups)
+		abort();
+
+	// Indexed lookups
+	found = 0;
+	start = GetSeconds();
+	for (mfmU64 i = 0; i < LOOKUP_COUNT; ++i)
+	{
+		mffFile* file;
+		if (mffGetFile(&file, paths[NextRandom(&state) % pathCount].path) == MF_ERROR_OKAY)
+			++found;
+	}
+	Report("mffGetFile", LOOKUP_COUNT, start);
+	if (found != LOOKUP_COUNT)
+		abort();
+
+	// Indexed lookups from several threads
+	BenchmarkThread threadData[THREAD_COUNT];
+	mftThread* threads[THREAD_COUNT];
+	start = GetSeconds();
+	for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+	{
+		threadData[i].seed = state + i * 0x2545F4914F6CDD1D;
+		threadData[i].found = 0;
+		if (mftCreateThread(&threads[i], &LookupThread, &threadData[i], NULL) != MF_ERROR_OKAY)
+			abort();
+	}
+	for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+	{
+		if (mftWaitForThread(threads[i], 0) != MF_ERROR_OKAY ||
+			mftDestroyThread(threads[i]) != MF_ERROR_OKAY ||
+			threadData[i].found != LOOKUP_COUNT)
+			abort();
+	}
+	Report("mffGetFile (4 threads)", LOOKUP_COUNT * THREAD_COUNT, start);
+
+	// Delete files
+	for (mfmU64 i = 0; i < fileCount; ++i)
+		if (mffDeleteFile(files[i]) != MF_ERROR_OKAY)
+			abort();
+	for (mfmU64 i = 0; i < dirCount; ++i)
+		if (mffDeleteDirectory(dirs[i]) != MF_ERROR_OKAY)
+			abort();
+
+	free(dirs);
+	free(files);
+	free(paths);
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	mfsUTF8CodeUnit archivePath[MFF_MAX_FILE_PATH_SIZE];
+	{
+		mfsStringStream ss;
+		if (mfsCreateLocalStringStream(&ss, archivePath, sizeof(archivePath)) != MF_ERROR_OKAY ||
+			mfsPutString(&ss, mffMagmaRootDirectory) != MF_ERROR_OKAY ||
+			mfsPutString(&ss, u8"/resources/FileSystem-Example") != MF_ERROR_OKAY)
+			abort();
+		mfsDestroyLocalStringStream(&ss);
+	}
+
+	mffArchive* archive;
+	if (mffCreateFolderArchive(&archive, NULL, archivePath) != MF_ERROR_OKAY ||
+		mffRegisterArchive(archive, u8"bench") != MF_ERROR_OKAY)
+		abort();
+
+	mffDirectory* root;
+	if (mffCreateDirectory(&root, u8"/bench/folderArchiveBenchmark") != MF_ERROR_OKAY)
+		abort();
+
+	Run(1000);
+	Run(10000);
+	Run(50000);
+
+	if (mffDeleteDirectory(root) != MF_ERROR_OKAY ||
+		mffUnregisterArchive(archive) != MF_ERROR_OKAY)
+		abort();
+
+	mfTerminate();
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include <Magma/Framework/Memory/Deflate.h>
+#include <Magma/Framework/Memory/Inflate.h>
+#include <Magma/Framework/Thread/JobSystem.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Measures the compression ratio of a deflate stream written in small pieces (which used to be fully flushed on every write),
+	and the throughput of block compressed frames, compressed and decompressed on the calling thread and on a job system.
+*/
+
+#define DATA_SIZE (32 * 1024 * 1024)
+#define BLOCK_SIZE (1024 * 1024)
+#define WRITE_SIZE 64
+#define RUN_COUNT 3
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static void Report(const char* name, mfmF64 elapsed)
+{
+	mfmF64 megabytes = (mfmF64)DATA_SIZE / (1024.0 * 1024.0);
+	printf("  %-28s %10.2f ms %10.1f MiB/s\n", name, elapsed * 1000.0 / RUN_COUNT, megabytes * RUN_COUNT / elapsed);
+}
+
+static mfmU64 CompressWithStream(const mfmU8* data, mfmU8* out, mfmU64 outSize, mfmBool flushEveryWrite)
+{
+	mfmU8 buffer[64 * 1024];
+	mfsStream* stream;
+	if (mfmCreateDeflateStream(&stream, buffer, sizeof(buffer), MFM_FAST_COMPRESSION, NULL) != MF_ERROR_OKAY)
+		abort();
+
+	mfmU64 size = 0;
+	mfmU64 offset = 0;
+	while (offset < DATA_SIZE)
+	{
+		mfmU64 writeSize;
+		mfError err = mfsWrite(stream, data + offset, WRITE_SIZE, &writeSize);
+		if (err == MF_ERROR_OKAY && flushEveryWrite != MFM_FALSE && writeSize == WRITE_SIZE)
+			err = mfsFlush(stream);
+		if (err != MF_ERROR_OKAY && err != MFM_ERROR_BUFFER_FULL)
+			abort();
+		offset += writeSize;
+
+		mfmU64 readSize;
+		if (mfsRead(stream, out + size, outSize - size, &readSize) != MF_ERROR_OKAY)
+			abort();
+		size += readSize;
+	}
+
+	mfError err;
+	do
+	{
+		err = mfmFinishDeflateStream(stream);
+		if (err != MF_ERROR_OKAY && err != MFM_ERROR_BUFFER_FULL)
+			abort();
+		mfmU64 readSize;
+		if (mfsRead(stream, out + size, outSize - size, &readSize) != MF_ERROR_OKAY)
+			abort();
+		size += readSize;
+	} while (err == MFM_ERROR_BUFFER_FULL);
+
+	mfmDestroyDeflateStream(stream);
+	return size;
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	// Text-like data, which compresses reasonably well
+	mfmU64 bound = mfmGetDeflateBlocksBound(DATA_SIZE, BLOCK_SIZE);
+	mfmU8* data = malloc(DATA_SIZE);
+	mfmU8* compressed = malloc(bound);
+	mfmU8* decompressed = malloc(DATA_SIZE);
+	if (data == NULL || compressed == NULL || decompressed == NULL)
+		abort();
+	mfmU32 seed = 1234;
+	for (mfmU64 i = 0; i < DATA_SIZE; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		data[i] = (mfmU8)('a' + (seed >> 16) % 16 + (i % 7 == 0 ? 1 : 0));
+	}
+
+	printf("%u byte writes on a deflate stream (%u MiB):\n", WRITE_SIZE, DATA_SIZE / (1024 * 1024));
+	{
+		mfmU64 oneShotSize;
+		if (mfmDeflate(data, DATA_SIZE, compressed, bound, &oneShotSize, MFM_FAST_COMPRESSION, NULL) != MF_ERROR_OKAY)
+			abort();
+		printf("  %-28s %10llu bytes\n", "single mfmDeflate", (unsigned long long)oneShotSize);
+		printf("  %-28s %10llu bytes\n", "stream, flushed on write", (unsigned long long)CompressWithStream(data, compressed, bound, MFM_TRUE));
+		printf("  %-28s %10llu bytes\n", "stream", (unsigned long long)CompressWithStream(data, compressed, bound, MFM_FALSE));
+	}
+
+	mftJobSystem* jobSystem;
+	if (mftCreateJobSystem(&jobSystem, NULL, NULL) != MF_ERROR_OKAY)
+		abort();
+
+	printf("Block compressed frames (%u KiB blocks, %u workers):\n", BLOCK_SIZE / 1024, mftGetJobSystemWorkerCount(jobSystem));
+	{
+		mfmU64 compressedSize;
+		mfmU64 decompressedSize;
+
+		mfmF64 start = GetSeconds();
+		for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+			if (mfmDeflateBlocks(data, DATA_SIZE, compressed, bound, &compressedSize, BLOCK_SIZE, MFM_FAST_COMPRESSION, NULL, NULL) != MF_ERROR_OKAY)
+				abort();
+		Report("deflate (calling thread)", GetSeconds() - start);
+
+		start = GetSeconds();
+		for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+			if (mfmDeflateBlocks(data, DATA_SIZE, compressed, bound, &compressedSize, BLOCK_SIZE, MFM_FAST_COMPRESSION, jobSystem, NULL) != MF_ERROR_OKAY)
+				abort();
+		Report("deflate (job system)", GetSeconds() - start);
+
+		start = GetSeconds();
+		for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+			if (mfmInflateBlocks(compressed, compressedSize, decompressed, DATA_SIZE, &decompressedSize, NULL, NULL) != MF_ERROR_OKAY)
+				abort();
+		Report("inflate (calling thread)", GetSeconds() - start);
+
+		start = GetSeconds();
+		for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+			if (mfmInflateBlocks(compressed, compressedSize, decompressed, DATA_SIZE, &decompressedSize, jobSystem, NULL) != MF_ERROR_OKAY)
+				abort();
+		Report("inflate (job system)", GetSeconds() - start);
+
+		if (decompressedSize != DATA_SIZE || memcmp(decompressed, data, DATA_SIZE) != 0)
+			abort();
+	}
+
+	if (mftDestroyJobSystem(jobSystem) != MF_ERROR_OKAY)
+		abort();
+
+	free(decompressed);
+	free(compressed);
+	free(data);
+
+	mfTerminate();
+	return 0;
+}
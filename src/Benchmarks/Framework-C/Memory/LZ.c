@@ -0,0 +1,192 @@
+#include <Magma/Framework/Memory/Deflate.h>
+#include <Magma/Framework/Memory/Inflate.h>
+#include <Magma/Framework/Memory/LZ.h>
+#include <Magma/Framework/File/FolderArchive.h>
+#include <Magma/Framework/File/Path.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Compares the compression ratio and the compression and decompression speeds of the LZ codec against zlib.
+	Every file of a folder is compressed separately, like a packed archive does, on two sets of files: the repository's resources
+	(which are few and small, so this mostly measures the per file overhead) and the framework's source code (a bigger, text
+	heavy set). Each measurement is repeated for at least MIN_SECONDS.
+*/
+
+#define MAX_FILE_COUNT 4096
+#define MIN_SECONDS 0.5
+
+typedef struct
+{
+	mfmU8* data;
+	mfmU64 size;
+	mfmU8* compressed;
+	mfmU64 compressedSize;
+	mfmU64 bound;
+} BenchmarkFile;
+
+static BenchmarkFile files[MAX_FILE_COUNT];
+static mfmU64 fileCount;
+static mfmU64 totalSize;
+static mfmU8* decompressed;
+static mfmU64 decompressedBound;
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+// Loads every file in a directory (or in the root if directory is NULL) and its subdirectories
+static void LoadFiles(mffArchive* archive, mffDirectory* directory)
+{
+	mffFile* file;
+	if (archive->getFirstFile(archive, &file, directory) != MF_ERROR_OKAY)
+		abort();
+	while (file != NULL)
+	{
+		mffEnum type;
+		if (mffGetFileType(file, &type) != MF_ERROR_OKAY)
+			abort();
+
+		if (type == MFF_DIRECTORY)
+			LoadFiles(archive, file);
+		else if (fileCount < MAX_FILE_COUNT)
+		{
+			BenchmarkFile* f = &files[fileCount++];
+			mfmU64 readSize;
+			if (mffGetFileSize(file, &f->size) != MF_ERROR_OKAY)
+				abort();
+			// The bound of a block compressed frame with a single block also bounds a single mfmDeflate call, for every codec
+			f->bound = mfmGetDeflateBlocksBound(f->size, f->size + 1);
+			f->data = malloc(f->size + 1);
+			f->compressed = malloc(f->bound);
+			if (f->data == NULL || f->compressed == NULL ||
+				mffReadFile(file, 0, f->data, f->size, &readSize) != MF_ERROR_OKAY || readSize != f->size)
+				abort();
+			totalSize += f->size;
+			if (f->size > decompressedBound)
+				decompressedBound = f->size;
+		}
+
+		if (archive->getNextFile(archive, &file, file) != MF_ERROR_OKAY)
+			abort();
+	}
+}
+
+static void FreeFiles(void)
+{
+	for (mfmU64 i = 0; i < fileCount; ++i)
+	{
+		free(files[i].data);
+		free(files[i].compressed);
+	}
+	fileCount = 0;
+	totalSize = 0;
+}
+
+static mfmF64 Compress(mfmEnum compression, mfmU64* compressedSize)
+{
+	mfmU64 runCount = 0;
+	mfmF64 start = GetSeconds();
+	mfmF64 elapsed;
+	do
+	{
+		*compressedSize = 0;
+		for (mfmU64 i = 0; i < fileCount; ++i)
+		{
+			if (mfmDeflate(files[i].data, files[i].size, files[i].compressed, files[i].bound, &files[i].compressedSize, compression, NULL) != MF_ERROR_OKAY)
+				abort();
+			*compressedSize += files[i].compressedSize;
+		}
+		++runCount;
+		elapsed = GetSeconds() - start;
+	} while (elapsed < MIN_SECONDS);
+	return (mfmF64)(totalSize * runCount) / (1024.0 * 1024.0) / elapsed;
+}
+
+static mfmF64 Decompress(void)
+{
+	mfmU64 runCount = 0;
+	mfmF64 start = GetSeconds();
+	mfmF64 elapsed;
+	do
+	{
+		for (mfmU64 i = 0; i < fileCount; ++i)
+		{
+			mfmU64 size;
+			if (mfmInflate(files[i].compressed, files[i].compressedSize, decompressed, files[i].size, &size, NULL) != MF_ERROR_OKAY || size != files[i].size)
+				abort();
+		}
+		++runCount;
+		elapsed = GetSeconds() - start;
+	} while (elapsed < MIN_SECONDS);
+
+	for (mfmU64 i = 0; i < fileCount; ++i)
+	{
+		mfmU64 size;
+		if (mfmInflate(files[i].compressed, files[i].compressedSize, decompressed, files[i].size, &size, NULL) != MF_ERROR_OKAY ||
+			memcmp(decompressed, files[i].data, files[i].size) != 0)
+			abort();
+	}
+	return (mfmF64)(totalSize * runCount) / (1024.0 * 1024.0) / elapsed;
+}
+
+static void Run(const mfsUTF8CodeUnit* name, const mfsUTF8CodeUnit* relativePath)
+{
+	mfsUTF8CodeUnit path[MFF_MAX_FILE_PATH_SIZE];
+	{
+		mfsStringStream ss;
+		if (mfsCreateLocalStringStream(&ss, path, sizeof(path)) != MF_ERROR_OKAY ||
+			mfsPutString(&ss, mffMagmaRootDirectory) != MF_ERROR_OKAY ||
+			mfsPutString(&ss, relativePath) != MF_ERROR_OKAY)
+			abort();
+		mfsDestroyLocalStringStream(&ss);
+	}
+
+	mffArchive* archive;
+	if (mffCreateFolderArchive(&archive, NULL, path) != MF_ERROR_OKAY)
+		abort();
+	LoadFiles(archive, NULL);
+	mffDestroyFolderArchive(archive);
+
+	decompressed = malloc(decompressedBound + 1);
+	if (decompressed == NULL)
+		abort();
+
+	printf("%s (%llu files, %llu bytes):\n", name, (unsigned long long)fileCount, (unsigned long long)totalSize);
+	printf("  %-22s %10s %8s %16s %16s\n", "codec", "size", "ratio", "compress", "decompress");
+
+	const mfmEnum compressions[] = { MFM_BEST_COMPRESSION, MFM_FAST_COMPRESSION, MFM_LZ_COMPRESSION };
+	const char* compressionNames[] = { "zlib (best)", "zlib (fast)", "LZ" };
+	for (mfmU64 i = 0; i < sizeof(compressions) / sizeof(compressions[0]); ++i)
+	{
+		mfmU64 compressedSize;
+		mfmF64 compressSpeed = Compress(compressions[i], &compressedSize);
+		mfmF64 decompressSpeed = Decompress();
+		printf("  %-22s %10llu %8.3f %10.1f MiB/s %10.1f MiB/s\n", compressionNames[i], (unsigned long long)compressedSize,
+			   (mfmF64)totalSize / (mfmF64)compressedSize, compressSpeed, decompressSpeed);
+	}
+
+	free(decompressed);
+	decompressedBound = 0;
+	FreeFiles();
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	Run(u8"Resources", u8"/resources");
+	Run(u8"Framework source", u8"/src/Magma/Framework");
+
+	mfTerminate();
+	return 0;
+}
@@ -0,0 +1,154 @@
+#include <Magma/Framework/String/Conversion.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Dumps a large amount of numbers to a text buffer and parses them back, comparing the conversion functions against snprintf, strtoll and strtod.
+	The floats are printed both with a fixed number of decimal places and with the shortest representation which is parsed back to the same value.
+*/
+
+#define VALUE_COUNT 1000000
+#define DUMP_SIZE (VALUE_COUNT * 32)
+
+static mfsUTF8CodeUnit* dump;
+static mfmU64 dumpSize;
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static void Report(const char* name, mfmF64 start)
+{
+	mfmF64 elapsed = GetSeconds() - start;
+	printf("%-32s %8.2f ms  %8.2f Mvalues/s  %8.2f MB/s\n",
+		   name, elapsed * 1e3, VALUE_COUNT / elapsed * 1e-6, (mfmF64)dumpSize / elapsed * 1e-6);
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	dump = malloc(DUMP_SIZE);
+	mfmI64* integers = malloc(VALUE_COUNT * sizeof(mfmI64));
+	mfmF64* floats = malloc(VALUE_COUNT * sizeof(mfmF64));
+	if (dump == NULL || integers == NULL || floats == NULL)
+		abort();
+
+	mfmU64 state = 1;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+	{
+		state = state * 6364136223846793005 + 1442695040888963407;
+		integers[i] = (mfmI64)(state >> (state % 48)) * ((state & 1) ? -1 : 1);
+		floats[i] = (mfmF64)(state >> 11) / (mfmF64)((mfmU64)1 << 53) * 20000.0 - 10000.0;
+	}
+
+	// Integers
+	mfmF64 start = GetSeconds();
+	dumpSize = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+		dumpSize += snprintf(dump + dumpSize, DUMP_SIZE - dumpSize, "%lld ", (long long)integers[i]);
+	Report("snprintf %lld", start);
+
+	start = GetSeconds();
+	dumpSize = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+	{
+		mfmU64 size = 0;
+		if (mfsPrintToBufferI64(dump + dumpSize, DUMP_SIZE - dumpSize, integers[i], 10, &size) != MF_ERROR_OKAY)
+			abort();
+		dumpSize += size;
+		dump[dumpSize++] = ' ';
+	}
+	Report("mfsPrintToBufferI64", start);
+
+	start = GetSeconds();
+	char* end = dump;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+		if (strtoll(end, &end, 10) != integers[i])
+			abort();
+	Report("strtoll", start);
+
+	start = GetSeconds();
+	mfmU64 index = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+	{
+		mfmI64 value = 0;
+		mfmU64 size = 0;
+		if (mfsParseFromBufferI64(dump + index, dumpSize - index, &value, 10, &size) != MF_ERROR_OKAY || value != integers[i])
+			abort();
+		index += size + 1;
+	}
+	Report("mfsParseFromBufferI64", start);
+
+	// Floats with fixed decimal places
+	start = GetSeconds();
+	dumpSize = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+		dumpSize += snprintf(dump + dumpSize, DUMP_SIZE - dumpSize, "%.4f ", floats[i]);
+	Report("snprintf %.4f", start);
+
+	start = GetSeconds();
+	dumpSize = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+	{
+		mfmU64 size = 0;
+		if (mfsPrintToBufferF64(dump + dumpSize, DUMP_SIZE - dumpSize, floats[i], 10, 4, &size) != MF_ERROR_OKAY)
+			abort();
+		dumpSize += size;
+		dump[dumpSize++] = ' ';
+	}
+	Report("mfsPrintToBufferF64 (4 places)", start);
+
+	// Floats with the shortest representation
+	start = GetSeconds();
+	dumpSize = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+		dumpSize += snprintf(dump + dumpSize, DUMP_SIZE - dumpSize, "%.17g ", floats[i]);
+	Report("snprintf %.17g", start);
+
+	start = GetSeconds();
+	dumpSize = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+	{
+		mfmU64 size = 0;
+		if (mfsPrintToBufferF64(dump + dumpSize, DUMP_SIZE - dumpSize, floats[i], 10, MFS_SHORTEST_DECIMAL_PLACES, &size) != MF_ERROR_OKAY)
+			abort();
+		dumpSize += size;
+		dump[dumpSize++] = ' ';
+	}
+	Report("mfsPrintToBufferF64 (shortest)", start);
+
+	start = GetSeconds();
+	end = dump;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+		if (strtod(end, &end) != floats[i])
+			abort();
+	Report("strtod", start);
+
+	start = GetSeconds();
+	index = 0;
+	for (mfmU64 i = 0; i < VALUE_COUNT; ++i)
+	{
+		mfmF64 value = 0.0;
+		mfmU64 size = 0;
+		if (mfsParseFromBufferF64(dump + index, dumpSize - index, &value, 10, &size) != MF_ERROR_OKAY || value != floats[i])
+			abort();
+		index += size + 1;
+	}
+	Report("mfsParseFromBufferF64", start);
+
+	free(floats);
+	free(integers);
+	free(dump);
+
+	mfTerminate();
+	return 0;
+}
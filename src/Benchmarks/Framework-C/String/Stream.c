@@ -0,0 +1,174 @@
+#include <Magma/Framework/String/Stream.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Compares writing and reading text through the stream functions against writing and reading it byte by byte.
+	mfsPutByte and mfsGetByte call the stream's write and read functions once per byte, which is what the print and parse functions used to do.
+	The stream is a string stream whose read and write functions are wrapped to count how many times they are called.
+	The last runs parse whitespace separated numbers and read long lines, where most of the time goes to scanning for the separator.
+*/
+
+#define STREAM_SIZE (16 << 20)
+#define LINE_COUNT 200000
+#define NUMBER_COUNT 1000000
+#define LONG_LINE_SIZE 4000
+
+static mfsStringStream stream;
+static mfsStreamReadFunction stringStreamRead;
+static mfsStreamWriteFunction stringStreamWrite;
+static mfmU64 callCount;
+
+static mfError CountingRead(void* stream, mfmU8* data, mfmU64 dataSize, mfmU64* outSize)
+{
+	++callCount;
+	return stringStreamRead(stream, data, dataSize, outSize);
+}
+
+static mfError CountingWrite(void* stream, const mfmU8* data, mfmU64 dataSize, mfmU64* outSize)
+{
+	++callCount;
+	return stringStreamWrite(stream, data, dataSize, outSize);
+}
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static void Report(const char* name, mfmF64 start, mfmU64 lineCount)
+{
+	mfmF64 elapsed = GetSeconds() - start;
+	printf("%-28s %8.2f ms  %8.2f MB/s  %6.1f calls/line\n",
+		   name, elapsed * 1e3, (mfmF64)stream.head / elapsed * 1e-6, (mfmF64)callCount / lineCount);
+}
+
+static void Reset(void)
+{
+	if (mfsSeekBegin((mfsStream*)&stream, 0) != MF_ERROR_OKAY)
+		abort();
+	callCount = 0;
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	mfmU8* memory = malloc(STREAM_SIZE);
+	if (memory == NULL || mfsCreateLocalStringStream(&stream, memory, STREAM_SIZE) != MF_ERROR_OKAY)
+		abort();
+	stringStreamRead = stream.base.read;
+	stringStreamWrite = stream.base.write;
+	stream.base.read = &CountingRead;
+	stream.base.write = &CountingWrite;
+
+	const mfsUTF8CodeUnit* line = u8"[info] frame 1234 took 16.6667 ms (draw calls: 512, triangles: 1048576)\n";
+	mfmU64 lineSize = strlen(line);
+
+	// Writing
+	Reset();
+	mfmF64 start = GetSeconds();
+	for (mfmU64 i = 0; i < LINE_COUNT; ++i)
+		for (mfmU64 j = 0; j < lineSize; ++j)
+			if (mfsPutByte((mfsStream*)&stream, line[j]) != MF_ERROR_OKAY)
+				abort();
+	Report("mfsPutByte", start, LINE_COUNT);
+
+	Reset();
+	start = GetSeconds();
+	for (mfmU64 i = 0; i < LINE_COUNT; ++i)
+		if (mfsPutString((mfsStream*)&stream, line) != MF_ERROR_OKAY)
+			abort();
+	Report("mfsPutString", start, LINE_COUNT);
+
+	Reset();
+	start = GetSeconds();
+	for (mfmU64 i = 0; i < LINE_COUNT; ++i)
+		if (mfsPrintFormat((mfsStream*)&stream, u8"[%s] frame %%ul took %%-d4f ms (draw calls: %d, triangles: %d)\n",
+						   u8"info", (mfmU64)1234, 16.6667, 512, 1048576) != MF_ERROR_OKAY)
+			abort();
+	Report("mfsPrintFormat", start, LINE_COUNT);
+
+	// Reading the lines written by mfsPutString
+	Reset();
+	for (mfmU64 i = 0; i < LINE_COUNT; ++i)
+		if (mfsPutString((mfsStream*)&stream, line) != MF_ERROR_OKAY)
+			abort();
+	mfmU64 textSize = stream.head;
+
+	mfsUTF8CodeUnit out[256];
+	Reset();
+	start = GetSeconds();
+	while (stream.head < textSize)
+	{
+		mfmU64 size = 0;
+		for (;;)
+		{
+			mfmU8 byte;
+			if (mfsGetByte((mfsStream*)&stream, &byte) != MF_ERROR_OKAY)
+				abort();
+			if (byte == '\n')
+				break;
+			out[size++] = byte;
+		}
+		out[size] = '\0';
+	}
+	Report("mfsGetByte", start, LINE_COUNT);
+
+	Reset();
+	start = GetSeconds();
+	while (stream.head < textSize)
+		if (mfsReadUntil((mfsStream*)&stream, out, sizeof(out), NULL, u8"\n") != MF_ERROR_OKAY)
+			abort();
+	Report("mfsReadUntil", start, LINE_COUNT);
+
+	// Parsing numbers
+	Reset();
+	for (mfmU64 i = 0; i < NUMBER_COUNT; ++i)
+		if (mfsPrintFormat((mfsStream*)&stream, u8"%d ", (mfmI32)(i * 2654435761u % 1000000)) != MF_ERROR_OKAY)
+			abort();
+	textSize = stream.head;
+
+	Reset();
+	mfmU64 sum = 0;
+	start = GetSeconds();
+	for (mfmU64 i = 0; i < NUMBER_COUNT; ++i)
+	{
+		mfmU32 value = 0;
+		if (mfsParseU32((mfsStream*)&stream, &value, 10, u8" ") != MF_ERROR_OKAY)
+			abort();
+		sum += value;
+	}
+	if (stream.head != textSize)
+		abort();
+	mfmF64 elapsed = GetSeconds() - start;
+	printf("%-28s %8.2f ms  %8.2f Mnumbers/s  (checksum %llu)\n", "mfsParseU32", elapsed * 1e3, NUMBER_COUNT / elapsed * 1e-6, (unsigned long long)sum);
+
+	// Reading long lines
+	Reset();
+	memset(memory, 'x', STREAM_SIZE);
+	for (mfmU64 i = LONG_LINE_SIZE - 1; i < STREAM_SIZE; i += LONG_LINE_SIZE)
+		memory[i] = '\n';
+	textSize = STREAM_SIZE / LONG_LINE_SIZE * LONG_LINE_SIZE;
+
+	mfsUTF8CodeUnit longOut[LONG_LINE_SIZE + 1];
+	start = GetSeconds();
+	while (stream.head < textSize)
+		if (mfsReadUntil((mfsStream*)&stream, longOut, sizeof(longOut), NULL, u8"\n") != MF_ERROR_OKAY)
+			abort();
+	Report("mfsReadUntil (long lines)", start, STREAM_SIZE / LONG_LINE_SIZE);
+
+	mfsDestroyLocalStringStream(&stream);
+	free(memory);
+
+	mfTerminate();
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <Magma/Framework/String/UTF8.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+	Compares the buffer functions (mfsValidateUTF8, mfsUTF8ToUTF32 and mfsUTF32ToUTF8) against loops over the per character functions.
+	Runs on plain ASCII text, which is what most asset and config files are, and on text mixed with two, three and four byte characters.
+*/
+
+#define TEXT_SIZE (16 << 20)
+
+static mfsUTF8CodeUnit* text;
+static mfsUTF32CodeUnit* utf32;
+static mfmU64 textSize;
+static mfmU64 utf32Size;
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static void Report(const char* name, mfmF64 start)
+{
+	mfmF64 elapsed = GetSeconds() - start;
+	printf("%-36s %8.2f ms  %8.2f MB/s\n", name, elapsed * 1e3, (mfmF64)textSize / elapsed * 1e-6);
+}
+
+static void Run(const char* name)
+{
+	printf("%s:\n", name);
+
+	// Validation
+	mfmF64 start = GetSeconds();
+	for (mfmU64 i = 0; i < textSize;)
+	{
+		mfmU64 size;
+		if (mfsIsValidUTF8Char(text + i) == MFM_FALSE || mfsGetUTF8CharSize(text + i, &size) != MF_ERROR_OKAY)
+			abort();
+		i += size;
+	}
+	Report("mfsIsValidUTF8Char loop", start);
+
+	start = GetSeconds();
+	if (mfsValidateUTF8(text, textSize, NULL) != MF_ERROR_OKAY)
+		abort();
+	Report("mfsValidateUTF8", start);
+
+	// UTF-8 to UTF-32
+	start = GetSeconds();
+	utf32Size = 0;
+	for (mfmU64 i = 0; i < textSize; ++utf32Size)
+	{
+		mfmU64 size;
+		if (mfsGetUTF8Char(text + i, &utf32[utf32Size]) != MF_ERROR_OKAY || mfsGetUTF8CharSize(text + i, &size) != MF_ERROR_OKAY)
+			abort();
+		i += size;
+	}
+	Report("mfsGetUTF8Char loop", start);
+
+	start = GetSeconds();
+	if (mfsUTF8ToUTF32(text, textSize, utf32, TEXT_SIZE, &utf32Size) != MF_ERROR_OKAY)
+		abort();
+	Report("mfsUTF8ToUTF32", start);
+
+	// UTF-32 to UTF-8
+	start = GetSeconds();
+	mfmU64 size = 0;
+	for (mfmU64 i = 0; i < utf32Size; ++i)
+	{
+		mfmU64 chrSize;
+		if (mfsSetUTF8Char(utf32[i], text + size, &chrSize, TEXT_SIZE - size) != MF_ERROR_OKAY)
+			abort();
+		size += chrSize;
+	}
+	Report("mfsSetUTF8Char loop", start);
+
+	start = GetSeconds();
+	if (mfsUTF32ToUTF8(utf32, utf32Size, text, TEXT_SIZE, &size) != MF_ERROR_OKAY || size != textSize)
+		abort();
+	Report("mfsUTF32ToUTF8", start);
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	text = malloc(TEXT_SIZE + 4);
+	utf32 = malloc(TEXT_SIZE * sizeof(mfsUTF32CodeUnit));
+	if (text == NULL || utf32 == NULL)
+		abort();
+
+	// ASCII text
+	for (textSize = 0; textSize < TEXT_SIZE; ++textSize)
+		text[textSize] = (textSize % 64 == 63) ? '\n' : (mfsUTF8CodeUnit)('a' + textSize % 26);
+	Run("ASCII");
+
+	// Mixed text, one in four characters isn't ASCII
+	static const mfsUnicodePoint mixed[] = { 'a', 'b', ' ', 0xE7, 'c', 0x20AC, 'd', 0x1F600 };
+	textSize = 0;
+	for (mfmU64 i = 0; textSize + 4 <= TEXT_SIZE; ++i)
+	{
+		mfmU64 chrSize;
+		if (mfsSetUTF8Char(mixed[i % 8], text + textSize, &chrSize, 4) != MF_ERROR_OKAY)
+			abort();
+		textSize += chrSize;
+	}
+	Run("Mixed");
+
+	free(utf32);
+	free(text);
+
+	mfTerminate();
+	return 0;
+}
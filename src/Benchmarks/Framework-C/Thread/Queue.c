@@ -0,0 +1,245 @@
+#include <Magma/Framework/Thread/Queue.h>
+#include <Magma/Framework/Thread/Thread.h>
+#include <Magma/Framework/Thread/Mutex.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#define YIELD() SwitchToThread()
+#else
+#include <sched.h>
+#define YIELD() sched_yield()
+#endif
+
+/*
+	Compares the throughput of the lock-free queues against a ring buffer protected by a mftMutex.
+	Each run moves ITEM_COUNT 64 bit values per producer from the producers to the consumers.
+	Every variant yields when the queue is full or empty, so that the results are comparable with more threads than cores.
+*/
+
+#define ITEM_COUNT (1 << 20)
+#define CAPACITY 1024
+#define BATCH_SIZE 64
+
+typedef struct
+{
+	mftMutex* mutex;
+	mfmU64 buffer[CAPACITY];
+	mfmU64 head;
+	mfmU64 tail;
+} MutexQueue;
+
+typedef struct
+{
+	int kind;
+	mfmU64 count;
+	mfmU64 sum;
+} BenchmarkThread;
+
+enum
+{
+	KIND_SPSC,
+	KIND_SPSC_BATCH,
+	KIND_MPMC,
+	KIND_MPMC_BATCH,
+	KIND_MUTEX,
+};
+
+static mftSPSCQueue* spsc;
+static mftMPMCQueue* mpmc;
+static MutexQueue mutexQueue;
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static void MutexQueuePush(mfmU64 value)
+{
+	for (;;)
+	{
+		mftLockMutex(mutexQueue.mutex, 0);
+		if (mutexQueue.tail - mutexQueue.head < CAPACITY)
+		{
+			mutexQueue.buffer[mutexQueue.tail++ % CAPACITY] = value;
+			mftUnlockMutex(mutexQueue.mutex);
+			return;
+		}
+		mftUnlockMutex(mutexQueue.mutex);
+		YIELD();
+	}
+}
+
+static mfmU64 MutexQueuePop(void)
+{
+	for (;;)
+	{
+		mftLockMutex(mutexQueue.mutex, 0);
+		if (mutexQueue.tail != mutexQueue.head)
+		{
+			mfmU64 value = mutexQueue.buffer[mutexQueue.head++ % CAPACITY];
+			mftUnlockMutex(mutexQueue.mutex);
+			return value;
+		}
+		mftUnlockMutex(mutexQueue.mutex);
+		YIELD();
+	}
+}
+
+static void ProducerFunction(void* args)
+{
+	BenchmarkThread* thread = (BenchmarkThread*)args;
+	mfmU64 batch[BATCH_SIZE];
+
+	for (mfmU64 i = 0; i < thread->count;)
+	{
+		mfmU64 pushed = 1;
+		switch (thread->kind)
+		{
+			case KIND_SPSC:
+				mftPushSPSCQueue(spsc, &i, 0);
+				break;
+			case KIND_MPMC:
+				mftPushMPMCQueue(mpmc, &i, 0);
+				break;
+			case KIND_MUTEX:
+				MutexQueuePush(i);
+				break;
+			case KIND_SPSC_BATCH:
+			case KIND_MPMC_BATCH:
+			{
+				mfmU64 count = thread->count - i < BATCH_SIZE ? thread->count - i : BATCH_SIZE;
+				for (mfmU64 j = 0; j < count; ++j)
+					batch[j] = i + j;
+				if (thread->kind == KIND_SPSC_BATCH)
+					mftPushSPSCQueueBatch(spsc, batch, count, &pushed);
+				else
+					mftPushMPMCQueueBatch(mpmc, batch, count, &pushed);
+				if (pushed == 0)
+					YIELD();
+				break;
+			}
+		}
+		i += pushed;
+	}
+}
+
+static void ConsumerFunction(void* args)
+{
+	BenchmarkThread* thread = (BenchmarkThread*)args;
+	mfmU64 batch[BATCH_SIZE];
+
+	for (mfmU64 i = 0; i < thread->count;)
+	{
+		mfmU64 value = 0;
+		mfmU64 popped = 1;
+		switch (thread->kind)
+		{
+			case KIND_SPSC:
+				mftPopSPSCQueue(spsc, &value, 0);
+				thread->sum += value;
+				break;
+			case KIND_MPMC:
+				mftPopMPMCQueue(mpmc, &value, 0);
+				thread->sum += value;
+				break;
+			case KIND_MUTEX:
+				thread->sum += MutexQueuePop();
+				break;
+			case KIND_SPSC_BATCH:
+			case KIND_MPMC_BATCH:
+			{
+				mfmU64 count = thread->count - i < BATCH_SIZE ? thread->count - i : BATCH_SIZE;
+				if (thread->kind == KIND_SPSC_BATCH)
+					mftPopSPSCQueueBatch(spsc, batch, count, &popped);
+				else
+					mftPopMPMCQueueBatch(mpmc, batch, count, &popped);
+				for (mfmU64 j = 0; j < popped; ++j)
+					thread->sum += batch[j];
+				if (popped == 0)
+					YIELD();
+				break;
+			}
+		}
+		i += popped;
+	}
+}
+
+static void Run(const char* name, int kind, mfmU32 producerCount, mfmU32 consumerCount)
+{
+	BenchmarkThread producers[4];
+	BenchmarkThread consumers[4];
+	mftThread* threads[8];
+
+	mfmU64 total = (mfmU64)ITEM_COUNT * producerCount;
+	for (mfmU32 i = 0; i < producerCount; ++i)
+	{
+		producers[i].kind = kind;
+		producers[i].count = ITEM_COUNT;
+		producers[i].sum = 0;
+	}
+	for (mfmU32 i = 0; i < consumerCount; ++i)
+	{
+		consumers[i].kind = kind;
+		consumers[i].count = total / consumerCount + (i < total % consumerCount ? 1 : 0);
+		consumers[i].sum = 0;
+	}
+
+	mfmF64 start = GetSeconds();
+	for (mfmU32 i = 0; i < consumerCount; ++i)
+		if (mftCreateThread(&threads[i], &ConsumerFunction, &consumers[i], NULL) != MF_ERROR_OKAY)
+			abort();
+	for (mfmU32 i = 0; i < producerCount; ++i)
+		if (mftCreateThread(&threads[consumerCount + i], &ProducerFunction, &producers[i], NULL) != MF_ERROR_OKAY)
+			abort();
+	for (mfmU32 i = 0; i < producerCount + consumerCount; ++i)
+		if (mftWaitForThread(threads[i], 0) != MF_ERROR_OKAY || mftDestroyThread(threads[i]) != MF_ERROR_OKAY)
+			abort();
+	mfmF64 elapsed = GetSeconds() - start;
+
+	// Check that every value went through
+	mfmU64 sum = 0;
+	for (mfmU32 i = 0; i < consumerCount; ++i)
+		sum += consumers[i].sum;
+	if (sum != (mfmU64)ITEM_COUNT * (ITEM_COUNT - 1) / 2 * producerCount)
+		abort();
+
+	printf("%-24s %up/%uc  %8.2f ms  %8.2f Mitems/s  %6.1f ns/item\n",
+		   name, producerCount, consumerCount, elapsed * 1e3, (mfmF64)total / elapsed * 1e-6, elapsed * 1e9 / (mfmF64)total);
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	if (mftCreateSPSCQueue(&spsc, sizeof(mfmU64), CAPACITY, NULL) != MF_ERROR_OKAY ||
+		mftCreateMPMCQueue(&mpmc, sizeof(mfmU64), CAPACITY, NULL) != MF_ERROR_OKAY ||
+		mftCreateMutex(&mutexQueue.mutex, NULL) != MF_ERROR_OKAY)
+		abort();
+	mutexQueue.head = 0;
+	mutexQueue.tail = 0;
+
+	Run("mutex queue", KIND_MUTEX, 1, 1);
+	Run("spsc queue", KIND_SPSC, 1, 1);
+	Run("spsc queue (batch)", KIND_SPSC_BATCH, 1, 1);
+	Run("mpmc queue", KIND_MPMC, 1, 1);
+	Run("mpmc queue (batch)", KIND_MPMC_BATCH, 1, 1);
+	Run("mutex queue", KIND_MUTEX, 4, 4);
+	Run("mpmc queue", KIND_MPMC, 4, 4);
+	Run("mpmc queue (batch)", KIND_MPMC_BATCH, 4, 4);
+
+	if (mftDestroyMutex(mutexQueue.mutex) != MF_ERROR_OKAY ||
+		mftDestroyMPMCQueue(mpmc) != MF_ERROR_OKAY ||
+		mftDestroySPSCQueue(spsc) != MF_ERROR_OKAY)
+		abort();
+
+	mfTerminate();
+	return 0;
+}
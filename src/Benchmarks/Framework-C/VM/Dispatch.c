@@ -0,0 +1,127 @@
+#include <Magma/Framework/VM/VirtualMachine.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+	Compares running arithmetic heavy bytecode by calling mfvStepVirtualMachine once per instruction (which is what
+	mfvRunVirtualMachine used to do) against mfvRunVirtualMachine's dispatch loop, and the same loop written with version 2
+	register instructions. Version 1 code is partly translated to register instructions when it is loaded, so the instruction
+	counts differ between the versions and the times are what should be compared.
+*/
+
+#define ITERATION_COUNT 2000000
+#define RUN_COUNT 3
+
+#define U16(x) (mfmU8)((x) >> 8), (mfmU8)(x)
+#define U32(x) (mfmU8)((x) >> 24), (mfmU8)((x) >> 16), (mfmU8)((x) >> 8), (mfmU8)(x)
+
+// Computes x = x * 3 + i and y = y * 0.5 + i for i from ITERATION_COUNT to 1 (x in register 1, y in register 2, i in register 0)
+static const mfmU8 code[] =
+{
+	MFV_BYTECODE_PUSH32, U32(0), MFV_BYTECODE_STORE32, U32(1),
+	MFV_BYTECODE_PUSH32, U32(0), MFV_BYTECODE_STORE32, U32(2),
+	MFV_BYTECODE_PUSH32, U32(ITERATION_COUNT), MFV_BYTECODE_STORE32, U32(0),
+	// Loop (address 30)
+	MFV_BYTECODE_LOAD32, U32(0), MFV_BYTECODE_PUSH32, U32(3), MFV_BYTECODE_LOAD32, U32(1), MFV_BYTECODE_MULU32, MFV_BYTECODE_ADDU32,
+	MFV_BYTECODE_STORE32, U32(1),
+	MFV_BYTECODE_PUSH32, U32(0x3F000000), MFV_BYTECODE_LOAD32, U32(2), MFV_BYTECODE_MULF32, MFV_BYTECODE_PUSH32, U32(0x3F800000),
+	MFV_BYTECODE_ADDF32, MFV_BYTECODE_STORE32, U32(2),
+	MFV_BYTECODE_PUSH32, U32(1), MFV_BYTECODE_LOAD32, U32(0), MFV_BYTECODE_SUBU32, MFV_BYTECODE_PUSH_COPY, 4, MFV_BYTECODE_STORE32, U32(0),
+	MFV_BYTECODE_PUSH32, U32(30), MFV_BYTECODE_JUMP_I32_NOT_ZERO,
+	MFV_BYTECODE_LOAD32, U32(1),
+	MFV_BYTECODE_END,
+};
+
+// Same as above, with 3 in register 3, 0.5 in register 4, 1.0 in register 5 and 1 in register 6
+static const mfmU8 codeV2[] =
+{
+	0xFE, 0x02, 0x00,
+	MFV_BYTECODE_SET_R, U16(1), U32(0), MFV_BYTECODE_SET_R, U16(2), U32(0), MFV_BYTECODE_SET_R, U16(0), U32(ITERATION_COUNT),
+	MFV_BYTECODE_SET_R, U16(3), U32(3), MFV_BYTECODE_SET_R, U16(4), U32(0x3F000000), MFV_BYTECODE_SET_R, U16(5), U32(0x3F800000),
+	MFV_BYTECODE_SET_R, U16(6), U32(1),
+	// Loop (address 52)
+	MFV_BYTECODE_MULU32_R, U16(1), U16(1), U16(3), MFV_BYTECODE_ADDU32_R, U16(1), U16(1), U16(0),
+	MFV_BYTECODE_MULF32_R, U16(2), U16(2), U16(4), MFV_BYTECODE_ADDF32_R, U16(2), U16(2), U16(5),
+	MFV_BYTECODE_SUBU32_R, U16(0), U16(0), U16(6),
+	MFV_BYTECODE_JUMP_NOT_ZERO_R, U16(0), U32(52),
+	MFV_BYTECODE_LOAD32, U32(1),
+	MFV_BYTECODE_END,
+};
+
+static mfmF64 GetSeconds(void)
+{
+	struct timespec now;
+	timespec_get(&now, TIME_UTC);
+	return (mfmF64)now.tv_sec + (mfmF64)now.tv_nsec * 1e-9;
+}
+
+static mfvVirtualMachine* CreateVM(const mfmU8* code, mfmU64 size)
+{
+	mfvVirtualMachine* vm;
+	mfvVirtualMachineDesc desc;
+	desc.callStackSize = 16;
+	desc.functionTableSize = 16;
+	desc.registerCount = 16;
+	desc.stackSize = 256;
+	if (mfvCreateVirtualMachine(&vm, &desc, NULL) != MF_ERROR_OKAY ||
+		mfvSetVirtualMachineCode(vm, 0, code, size) != MF_ERROR_OKAY)
+		abort();
+	return vm;
+}
+
+static mfmU64 RunWithSteps(mfvVirtualMachine* vm)
+{
+	mfmU64 executed = 0;
+	mfvVirtualMachineState state;
+	do
+	{
+		if (mfvStepVirtualMachine(vm, &state) != MF_ERROR_OKAY)
+			abort();
+		++executed;
+	} while (state != MFV_STATE_FINISHED);
+	return executed;
+}
+
+static mfmU64 RunWithLoop(mfvVirtualMachine* vm)
+{
+	mfmU64 executed;
+	mfvVirtualMachineState state;
+	if (mfvRunVirtualMachine(vm, NULL, &executed, &state) != MF_ERROR_OKAY || state != MFV_STATE_FINISHED)
+		abort();
+	return executed;
+}
+
+static void Measure(const char* name, const mfmU8* code, mfmU64 size, mfmU64(*run)(mfvVirtualMachine*))
+{
+	mfvVirtualMachine* vm = CreateVM(code, size);
+	mfmU64 executed = 0;
+	mfmU32 result = 0;
+	mfmF64 start = GetSeconds();
+	for (mfmU64 i = 0; i < RUN_COUNT; ++i)
+	{
+		executed += run(vm);
+		if (mfvVirtualMachinePop32(vm, &result) != MF_ERROR_OKAY)
+			abort();
+	}
+	mfmF64 elapsed = GetSeconds() - start;
+	printf("  %-20s %10.2f ms %10.1f M instructions/s (result %08X)\n", name, elapsed * 1000.0 / RUN_COUNT,
+		   (mfmF64)executed / elapsed / 1e6, result);
+	mfvDestroyVirtualMachine(vm);
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	printf("Arithmetic loop (%u iterations):\n", ITERATION_COUNT);
+	Measure("step loop", code, sizeof(code), &RunWithSteps);
+	Measure("run loop", code, sizeof(code), &RunWithLoop);
+	Measure("run loop (version 2)", codeV2, sizeof(codeV2), &RunWithLoop);
+
+	mfTerminate();
+	return 0;
+}
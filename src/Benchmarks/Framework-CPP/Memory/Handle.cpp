@@ -0,0 +1,84 @@
+#include <Magma/Framework/Memory/Handle.hpp>
+#include <Magma/Framework/Entry.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+using namespace Magma::Framework;
+
+/*
+	Measures the cost of copying and destroying handles, which acquire and release the object they point to.
+	Compares objects with atomic reference counting (the default) against objects set to non atomic reference counting.
+	Moving a handle doesn't touch the reference count, so it is measured too as a baseline.
+*/
+
+constexpr mfmU64 IterationCount = 10000000;
+
+static void Destructor(void* object)
+{
+	if (mfmDeinitObject(static_cast<mfmObject*>(object)) != MF_ERROR_OKAY)
+		abort();
+}
+
+static void Run(const char* name, bool nonAtomic)
+{
+	mfmObject object;
+	if (mfmInitObject(&object) != MF_ERROR_OKAY)
+		abort();
+	object.destructorFunc = &Destructor;
+	if (mfmSetObjectNonAtomic(&object, nonAtomic ? MFM_TRUE : MFM_FALSE) != MF_ERROR_OKAY)
+		abort();
+
+	{
+		Memory::Handle handle = object;
+
+		// Copy and destroy one handle at a time
+		auto start = std::chrono::high_resolution_clock::now();
+		for (mfmU64 i = 0; i < IterationCount; ++i)
+		{
+			Memory::Handle copy = handle;
+		}
+		std::chrono::duration<double> single = std::chrono::high_resolution_clock::now() - start;
+
+		// Copy into a vector and destroy it, like passing handles around in a render loop
+		std::vector<Memory::Handle> handles;
+		handles.reserve(1024);
+		start = std::chrono::high_resolution_clock::now();
+		for (mfmU64 i = 0; i < IterationCount / 1024; ++i)
+		{
+			for (mfmU64 j = 0; j < 1024; ++j)
+				handles.push_back(handle);
+			handles.clear();
+		}
+		std::chrono::duration<double> vector = std::chrono::high_resolution_clock::now() - start;
+
+		// Move the handle back and forth
+		start = std::chrono::high_resolution_clock::now();
+		for (mfmU64 i = 0; i < IterationCount; ++i)
+		{
+			Memory::Handle moved = std::move(handle);
+			handle = std::move(moved);
+		}
+		std::chrono::duration<double> move = std::chrono::high_resolution_clock::now() - start;
+
+		std::printf("%-12s copy/destroy %6.2f ns  vector copy/destroy %6.2f ns  move %6.2f ns\n",
+					name,
+					single.count() * 1e9 / IterationCount,
+					vector.count() * 1e9 / (IterationCount / 1024 * 1024),
+					move.count() * 1e9 / IterationCount);
+	}
+}
+
+int main(int argc, const char** argv)
+{
+	Magma::Framework::Init(argc, argv);
+
+	Run("atomic", false);
+	Run("non atomic", true);
+
+	Magma::Framework::Terminate();
+	return 0;
+}
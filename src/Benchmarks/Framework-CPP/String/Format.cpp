@@ -0,0 +1,70 @@
+#include <Magma/Framework/String/Format.hpp>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace Magma::Framework;
+
+/*
+	Measures the cost of printing a typical log line to a string stream.
+	Compares mfsPrintFormat, which parses its format string on every call, against the compile-time format strings of
+	String::PrintFormat, and snprintf followed by a single write as a reference.
+*/
+
+constexpr mfmU64 IterationCount = 1000000;
+
+static void Report(const char* name, std::chrono::duration<double> elapsed)
+{
+	std::printf("%-24s %8.2f ns/line\n", name, elapsed.count() * 1e9 / IterationCount);
+}
+
+int main(int argc, const char** argv)
+{
+	Magma::Framework::Init(argc, argv);
+
+	mfmU8 buffer[256];
+	mfsStringStream ss;
+	if (mfsCreateLocalStringStream(&ss, buffer, sizeof(buffer)) != MF_ERROR_OKAY)
+		abort();
+	mfsStream* stream = reinterpret_cast<mfsStream*>(&ss);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (mfmU64 i = 0; i < IterationCount; ++i)
+	{
+		ss.head = 0;
+		if (mfsPrintFormat(stream, u8"[render] frame %%ul: %%-d2f ms, %%u draw calls, pass %s\n",
+						   (mfmU64)i, 16.6667, (mfmU32)(i & 1023), u8"shadow") != MF_ERROR_OKAY)
+			abort();
+	}
+	Report("mfsPrintFormat", std::chrono::high_resolution_clock::now() - start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (mfmU64 i = 0; i < IterationCount; ++i)
+	{
+		ss.head = 0;
+		String::PrintFormat(stream, MFS_FORMAT(u8"[render] frame %%ul: %%-d2f ms, %%u draw calls, pass %s\n"),
+							(mfmU64)i, 16.6667, (mfmU32)(i & 1023), u8"shadow");
+	}
+	Report("String::PrintFormat", std::chrono::high_resolution_clock::now() - start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (mfmU64 i = 0; i < IterationCount; ++i)
+	{
+		ss.head = 0;
+		char line[256];
+		int size = std::snprintf(line, sizeof(line), "[render] frame %llu: %.2f ms, %u draw calls, pass %s\n",
+								 (unsigned long long)i, 16.6667, (unsigned)(i & 1023), "shadow");
+		mfmU64 writtenSize = 0;
+		if (mfsWrite(stream, line, (mfmU64)size, &writtenSize) != MF_ERROR_OKAY)
+			abort();
+	}
+	Report("snprintf + mfsWrite", std::chrono::high_resolution_clock::now() - start);
+
+	mfsDestroyLocalStringStream(&ss);
+
+	Magma::Framework::Terminate();
+	return 0;
+}
@@ -0,0 +1,147 @@
+#include <Magma/Framework/Memory/TrackingAllocator.h>
+#include <Magma/Framework/Memory/Endianness.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+	mfmU32 id;
+	char name[128];
+	mfmU64 allocationCount;
+	mfmU64 liveBytes;
+	mfmU64 peakBytes;
+} TagSummary;
+
+static void ReadLittleEndian(const mfmU8* src, void* dst, mfmU64 size)
+{
+	memcpy(dst, src, size);
+	if (size == 2)
+		mfmFromLittleEndian2(dst, dst);
+	else if (size == 4)
+		mfmFromLittleEndian4(dst, dst);
+	else
+		mfmFromLittleEndian8(dst, dst);
+}
+
+static TagSummary* GetTag(TagSummary* tags, mfmU64* tagCount, mfmU32 id)
+{
+	for (mfmU64 i = 0; i < *tagCount; ++i)
+		if (tags[i].id == id)
+			return &tags[i];
+	memset(&tags[*tagCount], 0, sizeof(TagSummary));
+	tags[*tagCount].id = id;
+	strcpy(tags[*tagCount].name, "(untagged)");
+	return &tags[(*tagCount)++];
+}
+
+// Summarises an allocation trace per tag, the same way an offline tool would
+static void Summarise(const mfmU8* trace, mfmU64 size)
+{
+	TagSummary tags[MFM_TRACKING_MAX_TAGS + 1];
+	mfmU64 tagCount = 0;
+
+	if (size < 5 || memcmp(trace, "MFMT", 4) != 0 || trace[4] != MFM_TRACKING_TRACE_VERSION)
+		abort();
+
+	for (mfmU64 i = 5; i < size;)
+	{
+		mfmU8 type = trace[i];
+		mfmU32 id;
+		ReadLittleEndian(&trace[i + 1], &id, sizeof(id));
+		TagSummary* tag = GetTag(tags, &tagCount, id);
+
+		if (type == MFM_TRACKING_RECORD_TAG)
+		{
+			mfmU16 nameSize;
+			ReadLittleEndian(&trace[i + 5], &nameSize, sizeof(nameSize));
+			mfmU64 copySize = nameSize < sizeof(tag->name) - 1 ? nameSize : sizeof(tag->name) - 1;
+			memcpy(tag->name, &trace[i + 7], copySize);
+			tag->name[copySize] = '\0';
+			i += 7 + nameSize;
+		}
+		else
+		{
+			mfmU64 allocationSize;
+			ReadLittleEndian(&trace[i + 13], &allocationSize, sizeof(allocationSize));
+			if (type == MFM_TRACKING_RECORD_ALLOCATE)
+			{
+				++tag->allocationCount;
+				tag->liveBytes += allocationSize;
+				if (tag->liveBytes > tag->peakBytes)
+					tag->peakBytes = tag->liveBytes;
+			}
+			else
+				tag->liveBytes -= allocationSize;
+			i += 21;
+		}
+	}
+
+	for (mfmU64 i = 0; i < tagCount; ++i)
+		printf("%s: %llu allocations, %llu bytes peak, %llu bytes never freed\n", tags[i].name,
+			   (unsigned long long)tags[i].allocationCount,
+			   (unsigned long long)tags[i].peakBytes,
+			   (unsigned long long)tags[i].liveBytes);
+}
+
+int main(int argc, const char** argv)
+{
+	if (mfInit(argc, argv) != MF_ERROR_OKAY)
+		abort();
+
+	static mfmU8 traceBuffer[4096];
+	mfsStringStream traceStream;
+	if (mfsCreateLocalStringStream(&traceStream, traceBuffer, sizeof(traceBuffer)) != MF_ERROR_OKAY)
+		abort();
+
+	// Create tracking allocator
+	mfmTrackingAllocator* tracking;
+	{
+		mfmTrackingAllocatorDesc desc;
+		desc.backingAllocator = NULL;
+		desc.traceStream = &traceStream;
+		desc.threadSafe = MFM_FALSE;
+		if (mfmCreateTrackingAllocator(&tracking, &desc) != MF_ERROR_OKAY)
+			abort();
+	}
+
+	// Allocations made by a subsystem through the generic allocator interface
+	const mfsUTF8CodeUnit* previousTag = mfmTrackingSetTag(tracking, u8"Subsystem");
+	void* values[8];
+	for (mfmU64 i = 0; i < 8; ++i)
+		if (mfmAllocate(tracking, &values[i], 64 * (i + 1)) != MF_ERROR_OKAY)
+			abort();
+	for (mfmU64 i = 0; i < 8; ++i)
+		if (mfmDeallocate(tracking, values[i]) != MF_ERROR_OKAY)
+			abort();
+	mfmTrackingSetTag(tracking, previousTag);
+
+	// Allocation tagged with its callsite, which is never freed
+	void* leaked;
+	if (MFM_TRACKING_ALLOCATE(tracking, &leaked, 100) != MF_ERROR_OKAY)
+		abort();
+
+	mfmTrackingStats stats;
+	if (mfmTrackingGetStats(tracking, &stats) != MF_ERROR_OKAY)
+		abort();
+	printf("Live bytes: %llu\n", (unsigned long long)stats.liveBytes);
+	printf("Peak bytes: %llu\n", (unsigned long long)stats.peakBytes);
+	printf("Allocation count: %llu\n", (unsigned long long)stats.allocationCount);
+	for (mfmU64 i = 0; i < MFM_TRACKING_HISTOGRAM_SIZE; ++i)
+		if (stats.histogram[i] != 0)
+			printf("Allocations between %llu and %llu bytes: %llu\n", 1ULL << i, (2ULL << i) - 1, (unsigned long long)stats.histogram[i]);
+
+	if (mfmDeallocate(tracking, leaked) != MF_ERROR_OKAY)
+		abort();
+	mfmDestroyTrackingAllocator(tracking);
+
+	Summarise(traceBuffer, traceStream.head);
+
+	printf("Program finished. Enter any input to quit.\n");
+	getchar();
+
+	mfTerminate();
+	return 0;
+}
@@ -53,7 +53,7 @@ int main(int argc, const char** argv)
 	
 	if (mfvSetVirtualMachineFunction(vm, 0x0001, &PrintU8) != MF_ERROR_OKAY)
 		abort();
-	if (mfvSetVirtualMachineCode(vm, 0, code) != MF_ERROR_OKAY)
+	if (mfvSetVirtualMachineCode(vm, 0, code, sizeof(code)) != MF_ERROR_OKAY)
 		abort();
 	if (mfvRunVirtualMachine(vm, NULL, NULL, NULL) != MF_ERROR_OKAY)
 	{
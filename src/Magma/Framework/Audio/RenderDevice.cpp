@@ -74,7 +74,7 @@ mfmU64 Magma::Framework::Audio::HSource::GetProcessedBuffers()
 	return out;
 }
 
-void Magma::Framework::Audio::HSource::QueueBuffer(HBuffer buffer)
+void Magma::Framework::Audio::HSource::QueueBuffer(const HBuffer& buffer)
 {
 	auto src = (mfaSource*)&this->Get();
 	mfError err = mfaSourceQueueBuffer(src->renderDevice, src, (mfaBuffer*)buffer.GetNoChecks());
@@ -160,7 +160,7 @@ void Magma::Framework::Audio::HSource::SetLooping(bool looping)
 	CHECK_ERROR(src->renderDevice, err);
 }
 
-void Magma::Framework::Audio::HSource::Bind(HBuffer buffer)
+void Magma::Framework::Audio::HSource::Bind(const HBuffer& buffer)
 {
 	auto src = (mfaSource*)&this->Get();
 	mfError err = mfaSetSourceBuffer(src->renderDevice, src, (mfaBuffer*)buffer.GetNoChecks());
@@ -27,12 +27,12 @@ namespace Magma
 			///		Used as a buffer handle.
 			///		Destroys the buffer automatically when there are no more references to it.
 			/// </summary>
-			class HBuffer : public Memory::Handle
+			class HBuffer : public Memory::TypedHandle<mfaBuffer>
 			{
 			public:
-				using Handle::Handle;
-				using Handle::operator=;
-				explicit inline HBuffer(const Memory::Handle& object) : Memory::Handle(object) {}
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				explicit inline HBuffer(const Memory::Handle& object) : TypedHandle(object) {}
 
 				/// <summary>
 				///		Updates a buffer's data.
@@ -48,12 +48,12 @@ namespace Magma
 			///		Used as a source handle.
 			///		Destroys the source automatically when there are no more references to it.
 			/// </summary>
-			class HSource : public Memory::Handle
+			class HSource : public Memory::TypedHandle<mfaSource>
 			{
 			public:
-				using Handle::Handle;
-				using Handle::operator=;
-				explicit inline HSource(const Memory::Handle& object) : Memory::Handle(object) {}
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				explicit inline HSource(const Memory::Handle& object) : TypedHandle(object) {}
 
 				/// <summary>
 				///		Plays audio on this source (asynchronously).
@@ -91,7 +91,7 @@ namespace Magma
 				///		Queues an audio buffer to later play on this source.
 				/// </summary>
 				/// <param name="buffer">Buffer handle</param>
-				void QueueBuffer(HBuffer buffer);
+				void QueueBuffer(const HBuffer& buffer);
 
 				/// <summary>
 				///		Unqueues an audio buffer that was played by this source.
@@ -169,19 +169,19 @@ namespace Magma
 				///		Binds a buffer to this source.
 				/// </summary>
 				/// <param name="buffer">Buffer handle (set to NULL to unbind the current buffer)</param>
-				void Bind(HBuffer buffer);
+				void Bind(const HBuffer& buffer);
 			};
 
 			/// <summary>
 			///		Used as a render device handle.
 			///		Destroys the render device automatically when there are no more references to it.
 			/// </summary>
-			class HRenderDevice : public Memory::Handle
+			class HRenderDevice : public Memory::TypedHandle<mfaRenderDevice>
 			{
 			public:
-				using Handle::Handle;
-				using Handle::operator=;
-				explicit inline HRenderDevice(const Memory::Handle& object) : Memory::Handle(object) {}
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				explicit inline HRenderDevice(const Memory::Handle& object) : TypedHandle(object) {}
 
 				/// <summary>
 				///		Creates a new source object.
@@ -3,6 +3,8 @@
 #include "../Memory/Endianness.h"
 #include "../Memory/Allocator.h"
 
+#include <string.h>
+
 mfError mfaLoadWAV(void * stream, mfaWAVData * data, void * allocator)
 {
 	if (stream == NULL || data == NULL)
@@ -266,6 +268,10 @@ mfError mfaLoadWAVDataChunkNoHeader(void * stream, mfaWAVDataChunk * out, const
 	if (stream == NULL || out == NULL)
 		return MFA_ERROR_INVALID_ARGUMENTS;
 
+	// 16 bit samples are converted two bytes at a time, so their data must hold whole samples
+	if (format->bitsPerSample == 16 && out->header.size % 2 != 0)
+		return MFA_ERROR_INVALID_DATA;
+
 	mfError err;
 	mfmU64 readSize = 0;
 
@@ -273,6 +279,25 @@ mfError mfaLoadWAVDataChunkNoHeader(void * stream, mfaWAVDataChunk * out, const
 	if (err != MF_ERROR_OKAY)
 		return err;
 
+	// Mapped streams expose their data directly, so the samples are converted while being copied from it
+	const mfmU8* span = NULL;
+	err = mfsGetSpan(stream, out->header.size, &span, &readSize);
+	if (err == MF_ERROR_OKAY)
+	{
+		if (readSize < out->header.size)
+			return MFA_ERROR_INVALID_DATA;
+
+		if (format->bitsPerSample == 16)
+			for (mfmU64 i = 0; i < out->header.size; i += 2)
+				mfmFromLittleEndian2(span + i, (mfmU8*)out->pcmData + i);
+		else
+			memcpy(out->pcmData, span, out->header.size);
+
+		return MF_ERROR_OKAY;
+	}
+	else if (err != MFS_ERROR_UNSUPPORTED_FUNCTION)
+		return err;
+
 	err = mfsRead(stream, out->pcmData, out->header.size, &readSize);
 	if (err != MF_ERROR_OKAY)
 		return err;
@@ -122,6 +122,7 @@ extern "C"
 	/// <param name="allocator">Allocator where the PCM data will be allocated on</param>
 	/// <returns>
 	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFA_ERROR_INVALID_DATA if the data is truncated or if 16 bit data has an odd size.
 	///		Otherwise returns an error code.
 	/// </returns>
 	mfError mfaLoadWAVDataChunkNoHeader(void* stream, mfaWAVDataChunk* out, const mfaWAVFormatChunk* format, void* allocator);
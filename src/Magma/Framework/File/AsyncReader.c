@@ -0,0 +1,909 @@
+#include "AsyncReader.h"
+#include "Config.h"
+
+#include "../Memory/Allocator.h"
+#include "../Thread/Thread.h"
+#include "../Thread/Mutex.h"
+#include "../Thread/Atomic.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+
+#include <Windows.h>
+
+typedef struct
+{
+	SRWLOCK lock;
+	CONDITION_VARIABLE workCond;
+	CONDITION_VARIABLE doneCond;
+} mffAsyncMonitor;
+
+static mfError mffInitAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	InitializeSRWLock(&monitor->lock);
+	InitializeConditionVariable(&monitor->workCond);
+	InitializeConditionVariable(&monitor->doneCond);
+	return MF_ERROR_OKAY;
+}
+
+static void mffDeinitAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	// SRW locks and condition variables don't need to be destroyed
+}
+
+static void mffLockAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	AcquireSRWLockExclusive(&monitor->lock);
+}
+
+static void mffUnlockAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	ReleaseSRWLockExclusive(&monitor->lock);
+}
+
+static void mffWaitForAsyncWork(mffAsyncMonitor* monitor)
+{
+	SleepConditionVariableSRW(&monitor->workCond, &monitor->lock, INFINITE, 0);
+}
+
+static void mffWaitForAsyncDone(mffAsyncMonitor* monitor)
+{
+	SleepConditionVariableSRW(&monitor->doneCond, &monitor->lock, INFINITE, 0);
+}
+
+static void mffSignalAsyncWork(mffAsyncMonitor* monitor, mfmU64 count)
+{
+	if (count == 1)
+		WakeConditionVariable(&monitor->workCond);
+	else
+		WakeAllConditionVariable(&monitor->workCond);
+}
+
+static void mffSignalAsyncDone(mffAsyncMonitor* monitor)
+{
+	WakeAllConditionVariable(&monitor->doneCond);
+}
+
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+#include <pthread.h>
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	pthread_cond_t workCond;
+	pthread_cond_t doneCond;
+} mffAsyncMonitor;
+
+static mfError mffInitAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	if (pthread_mutex_init(&monitor->lock, NULL) != 0)
+		return MFF_ERROR_INTERNAL;
+	if (pthread_cond_init(&monitor->workCond, NULL) != 0)
+	{
+		pthread_mutex_destroy(&monitor->lock);
+		return MFF_ERROR_INTERNAL;
+	}
+	if (pthread_cond_init(&monitor->doneCond, NULL) != 0)
+	{
+		pthread_cond_destroy(&monitor->workCond);
+		pthread_mutex_destroy(&monitor->lock);
+		return MFF_ERROR_INTERNAL;
+	}
+	return MF_ERROR_OKAY;
+}
+
+static void mffDeinitAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	pthread_cond_destroy(&monitor->doneCond);
+	pthread_cond_destroy(&monitor->workCond);
+	pthread_mutex_destroy(&monitor->lock);
+}
+
+static void mffLockAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	pthread_mutex_lock(&monitor->lock);
+}
+
+static void mffUnlockAsyncMonitor(mffAsyncMonitor* monitor)
+{
+	pthread_mutex_unlock(&monitor->lock);
+}
+
+static void mffWaitForAsyncWork(mffAsyncMonitor* monitor)
+{
+	pthread_cond_wait(&monitor->workCond, &monitor->lock);
+}
+
+static void mffWaitForAsyncDone(mffAsyncMonitor* monitor)
+{
+	pthread_cond_wait(&monitor->doneCond, &monitor->lock);
+}
+
+static void mffSignalAsyncWork(mffAsyncMonitor* monitor, mfmU64 count)
+{
+	if (count == 1)
+		pthread_cond_signal(&monitor->workCond);
+	else
+		pthread_cond_broadcast(&monitor->workCond);
+}
+
+static void mffSignalAsyncDone(mffAsyncMonitor* monitor)
+{
+	pthread_cond_broadcast(&monitor->doneCond);
+}
+
+#else
+#error No magma framework thread library support
+#endif
+
+#if defined(MAGMA_FRAMEWORK_USE_IO_URING) && defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+#define MFF_ASYNC_READER_HAS_IO_URING
+#endif
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+
+// liburing isn't required, the few system calls needed are made directly
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <errno.h>
+#include <unistd.h>
+
+// Reads are split in chunks of at most 1 GiB, since the SQE length is 32 bits
+#define MFF_IO_URING_MAX_CHUNK_SIZE 0x40000000
+
+typedef struct
+{
+	int fd;
+	void* sqRing;
+	mfmU64 sqRingSize;
+	void* cqRing;
+	mfmU64 cqRingSize;
+	struct io_uring_sqe* sqes;
+	mfmU64 sqesSize;
+
+	volatile mfmI32* sqHead;
+	volatile mfmI32* sqTail;
+	mfmU32 sqMask;
+	mfmU32 sqEntries;
+	mfmU32* sqArray;
+
+	volatile mfmI32* cqHead;
+	volatile mfmI32* cqTail;
+	mfmU32 cqMask;
+	mfmU32 cqEntries;
+	struct io_uring_cqe* cqes;
+
+	// Protected by the reader's ring mutex
+	mfmU32 unsubmitted;
+	mfmU32 inFlight;
+} mffIOURing;
+
+#endif
+
+struct mffAsyncReader
+{
+	mfmObject object;
+	void* allocator;
+	mffEnum backend;
+
+	// The monitor protects the thread pool queue, the pending count and the read states
+	mffAsyncMonitor monitor;
+	mffAsyncRead* queueHead;
+	mffAsyncRead* queueTail;
+	mfmU64 pending;
+	mfmBool quit;
+
+	mftThread** threads;
+	mfmU32 threadCount;
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+	mffIOURing ring;
+	mftMutex* ringMutex;
+	mftThread* reaper;
+#endif
+};
+
+static void mffQueueAsyncReads(mffAsyncReader* reader, mffAsyncRead* first, mffAsyncRead* last, mfmU64 count)
+{
+	mffLockAsyncMonitor(&reader->monitor);
+	if (reader->queueTail == NULL)
+		reader->queueHead = first;
+	else
+		reader->queueTail->next = first;
+	reader->queueTail = last;
+	mffSignalAsyncWork(&reader->monitor, count);
+	mffUnlockAsyncMonitor(&reader->monitor);
+}
+
+static void mffCompleteAsyncRead(mffAsyncRead* read, mfError result, mfmU64 readSize)
+{
+	mffAsyncReader* reader = read->reader;
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+	if (read->region.ownsHandle != MFM_FALSE)
+		close((int)read->region.handle);
+#endif
+
+	if (read->acquiredFile != NULL)
+		if (mfmReleaseObject(&read->acquiredFile->object) != MF_ERROR_OKAY)
+			abort();
+
+	read->result = result;
+	read->readSize = readSize;
+
+	// A thread waiting on the read may free or resubmit it as soon as it is marked as done, so it isn't touched after that and
+	// the callback gets a copy of it instead
+	mffAsyncRead completed = *read;
+	completed.state = MFF_ASYNC_READ_DONE;
+	completed.next = NULL;
+
+	mffLockAsyncMonitor(&reader->monitor);
+	mftAtomic32Store(&read->state, MFF_ASYNC_READ_DONE);
+	mffSignalAsyncDone(&reader->monitor);
+	mffUnlockAsyncMonitor(&reader->monitor);
+
+	if (completed.callback != NULL)
+		completed.callback(&completed, completed.userData);
+
+	mffLockAsyncMonitor(&reader->monitor);
+	reader->pending -= 1;
+	if (reader->pending == 0)
+		mffSignalAsyncDone(&reader->monitor);
+	mffUnlockAsyncMonitor(&reader->monitor);
+}
+
+static void mffAsyncReaderThread(void* args)
+{
+	mffAsyncReader* reader = args;
+
+	for (;;)
+	{
+		mffLockAsyncMonitor(&reader->monitor);
+		while (reader->queueHead == NULL && reader->quit == MFM_FALSE)
+			mffWaitForAsyncWork(&reader->monitor);
+		mffAsyncRead* read = reader->queueHead;
+		if (read != NULL)
+		{
+			reader->queueHead = read->next;
+			if (reader->queueHead == NULL)
+				reader->queueTail = NULL;
+		}
+		mffUnlockAsyncMonitor(&reader->monitor);
+
+		if (read == NULL)
+			break;
+
+		mfmU64 readSize = 0;
+		mfError err = read->acquiredFile->archive->readFile(read->acquiredFile->archive, read->acquiredFile, read->offset, read->buffer, read->size, &readSize);
+		mffCompleteAsyncRead(read, err, readSize);
+	}
+}
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+
+static int mffIOURingSetup(mfmU32 entries, struct io_uring_params* params)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int mffIOURingEnter(int fd, mfmU32 toSubmit, mfmU32 minComplete, mfmU32 flags)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+static mfError mffInitIOURing(mffIOURing* ring, mfmU32 entries)
+{
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	memset(ring, 0, sizeof(*ring));
+
+	ring->fd = mffIOURingSetup(entries, &params);
+	if (ring->fd < 0)
+		return MFF_ERROR_NOT_SUPPORTED;
+
+	ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(mfmU32);
+	ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ring->cqRingSize > ring->sqRingSize)
+			ring->sqRingSize = ring->cqRingSize;
+		ring->cqRingSize = ring->sqRingSize;
+	}
+
+	ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if (ring->sqRing == MAP_FAILED)
+	{
+		close(ring->fd);
+		return MFF_ERROR_NOT_SUPPORTED;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		ring->cqRing = ring->sqRing;
+	else
+	{
+		ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+		if (ring->cqRing == MAP_FAILED)
+		{
+			munmap(ring->sqRing, ring->sqRingSize);
+			close(ring->fd);
+			return MFF_ERROR_NOT_SUPPORTED;
+		}
+	}
+
+	ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED)
+	{
+		if (ring->cqRing != ring->sqRing)
+			munmap(ring->cqRing, ring->cqRingSize);
+		munmap(ring->sqRing, ring->sqRingSize);
+		close(ring->fd);
+		return MFF_ERROR_NOT_SUPPORTED;
+	}
+
+	mfmU8* sq = ring->sqRing;
+	ring->sqHead = (volatile mfmI32*)(sq + params.sq_off.head);
+	ring->sqTail = (volatile mfmI32*)(sq + params.sq_off.tail);
+	ring->sqMask = *(mfmU32*)(sq + params.sq_off.ring_mask);
+	ring->sqEntries = *(mfmU32*)(sq + params.sq_off.ring_entries);
+	ring->sqArray = (mfmU32*)(sq + params.sq_off.array);
+
+	mfmU8* cq = ring->cqRing;
+	ring->cqHead = (volatile mfmI32*)(cq + params.cq_off.head);
+	ring->cqTail = (volatile mfmI32*)(cq + params.cq_off.tail);
+	ring->cqMask = *(mfmU32*)(cq + params.cq_off.ring_mask);
+	ring->cqEntries = *(mfmU32*)(cq + params.cq_off.ring_entries);
+	ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	return MF_ERROR_OKAY;
+}
+
+static void mffDeinitIOURing(mffIOURing* ring)
+{
+	munmap(ring->sqes, ring->sqesSize);
+	if (ring->cqRing != ring->sqRing)
+		munmap(ring->cqRing, ring->cqRingSize);
+	munmap(ring->sqRing, ring->sqRingSize);
+	close(ring->fd);
+}
+
+// Submits the queued SQEs, must be called with the ring mutex locked
+static mfError mffFlushIOURing(mffIOURing* ring)
+{
+	while (ring->unsubmitted > 0)
+	{
+		int ret = mffIOURingEnter(ring->fd, ring->unsubmitted, 0, 0);
+		if (ret < 0)
+		{
+			if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+				continue;
+			return MFF_ERROR_INTERNAL;
+		}
+		ring->unsubmitted -= (mfmU32)ret;
+	}
+	return MF_ERROR_OKAY;
+}
+
+/*
+	Takes back the SQEs which the kernel hasn't consumed, after a submission failed (for example, because the kernel ran out of
+	memory), and returns their reads linked by their next pointers. Must be called with the ring mutex locked.
+	Without SQ polling the kernel only consumes SQEs inside io_uring_enter calls with a submit count, which are only made with the
+	ring mutex locked, so rewinding the SQ tail is safe.
+*/
+static mffAsyncRead* mffReclaimIOURingEntries(mffIOURing* ring)
+{
+	mffAsyncRead* reclaimed = NULL;
+	mfmU32 tail = (mfmU32)*ring->sqTail;
+	for (; ring->unsubmitted > 0; --ring->unsubmitted)
+	{
+		tail -= 1;
+		mffAsyncRead* read = (mffAsyncRead*)(uintptr_t)ring->sqes[tail & ring->sqMask].user_data;
+		ring->inFlight -= 1;
+		if (read != NULL)
+		{
+			read->next = reclaimed;
+			reclaimed = read;
+		}
+	}
+	mftAtomic32Store(ring->sqTail, (mfmI32)tail);
+	return reclaimed;
+}
+
+// Queues an SQE, must be called with the ring mutex locked
+static mfError mffPushIOURingEntry(mffIOURing* ring, mfmU8 opcode, mffAsyncRead* read)
+{
+	mfmI32 head, tail;
+	mftAtomic32Load(ring->sqHead, &head);
+	tail = *ring->sqTail; // Only written by this thread
+	if ((mfmU32)tail - (mfmU32)head == ring->sqEntries)
+	{
+		mfError err = mffFlushIOURing(ring);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	mfmU32 index = (mfmU32)tail & ring->sqMask;
+	struct io_uring_sqe* sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->user_data = (mfmU64)(uintptr_t)read;
+	if (read != NULL)
+	{
+		mfmU64 remaining = read->size - read->readSize;
+		sqe->fd = (int)read->region.handle;
+		sqe->addr = (mfmU64)(uintptr_t)(read->buffer + read->readSize);
+		sqe->len = (mfmU32)(remaining > MFF_IO_URING_MAX_CHUNK_SIZE ? MFF_IO_URING_MAX_CHUNK_SIZE : remaining);
+		sqe->off = read->region.offset + read->offset + read->readSize;
+	}
+	ring->sqArray[index] = index;
+
+	mftAtomic32Store(ring->sqTail, (mfmI32)((mfmU32)tail + 1));
+	ring->unsubmitted += 1;
+	ring->inFlight += 1;
+	return MF_ERROR_OKAY;
+}
+
+// Sends a read which can't go through the ring to the thread pool
+static void mffFallBackAsyncRead(mffAsyncReader* reader, mffAsyncRead* read)
+{
+	if (read->region.ownsHandle != MFM_FALSE)
+		close((int)read->region.handle);
+	read->region.ownsHandle = MFM_FALSE;
+	read->readSize = 0;
+	read->next = NULL;
+	mffQueueAsyncReads(reader, read, read, 1);
+}
+
+// Sends the reads returned by mffReclaimIOURingEntries to the thread pool
+static void mffFallBackAsyncReads(mffAsyncReader* reader, mffAsyncRead* reads)
+{
+	while (reads != NULL)
+	{
+		mffAsyncRead* next = reads->next;
+		mffFallBackAsyncRead(reader, reads);
+		reads = next;
+	}
+}
+
+/*
+	Completions are reaped by a single thread, which blocks on io_uring_enter until at least one CQE is available.
+	Short reads are resubmitted from where they stopped, and a read which returns 0 bytes has reached the end of the file.
+	The reaper stops when it finds the NOP with user data 0 submitted by mffDestroyAsyncReader.
+*/
+static void mffAsyncReaderReaperThread(void* args)
+{
+	mffAsyncReader* reader = args;
+	mffIOURing* ring = &reader->ring;
+	mfmBool quit = MFM_FALSE;
+
+	while (quit == MFM_FALSE)
+	{
+		int ret = mffIOURingEnter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS);
+		if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			abort();
+
+		mfmI32 head, tail;
+		head = *ring->cqHead; // Only written by this thread
+		mftAtomic32Load(ring->cqTail, &tail);
+
+		for (; head != tail; head = (mfmI32)((mfmU32)head + 1))
+		{
+			struct io_uring_cqe* cqe = &ring->cqes[(mfmU32)head & ring->cqMask];
+			mffAsyncRead* read = (mffAsyncRead*)(uintptr_t)cqe->user_data;
+			mfmI32 res = cqe->res;
+
+			if (mftLockMutex(reader->ringMutex, 0) != MF_ERROR_OKAY)
+				abort();
+			ring->inFlight -= 1;
+			if (mftUnlockMutex(reader->ringMutex) != MF_ERROR_OKAY)
+				abort();
+
+			if (read == NULL)
+			{
+				quit = MFM_TRUE;
+				continue;
+			}
+
+			if (res == -EINTR || res == -EAGAIN)
+				res = 0;
+			else if (res == -EINVAL || res == -EOPNOTSUPP)
+			{
+				// Kernels older than 5.6 don't support IORING_OP_READ
+				mffFallBackAsyncRead(reader, read);
+				continue;
+			}
+			else if (res < 0)
+			{
+				mffCompleteAsyncRead(read, MFF_ERROR_INTERNAL, read->readSize);
+				continue;
+			}
+			else if (res == 0)
+			{
+				mffCompleteAsyncRead(read, MF_ERROR_OKAY, read->readSize);
+				continue;
+			}
+
+			read->readSize += (mfmU64)res;
+			if (read->readSize == read->size)
+			{
+				mffCompleteAsyncRead(read, MF_ERROR_OKAY, read->readSize);
+				continue;
+			}
+
+			// Short read, submit the rest
+			if (mftLockMutex(reader->ringMutex, 0) != MF_ERROR_OKAY)
+				abort();
+			mfError err = mffPushIOURingEntry(ring, IORING_OP_READ, read);
+			mfmBool pushed = err == MF_ERROR_OKAY ? MFM_TRUE : MFM_FALSE;
+			if (pushed != MFM_FALSE)
+				err = mffFlushIOURing(ring);
+			mffAsyncRead* reclaimed = err != MF_ERROR_OKAY ? mffReclaimIOURingEntries(ring) : NULL;
+			if (mftUnlockMutex(reader->ringMutex) != MF_ERROR_OKAY)
+				abort();
+			if (pushed == MFM_FALSE)
+				mffFallBackAsyncRead(reader, read);
+			mffFallBackAsyncReads(reader, reclaimed);
+		}
+
+		mftAtomic32Store(ring->cqHead, head);
+	}
+}
+
+#endif
+
+// Resolves the file, size and buffer of a read, before it is sent to the ring or to the thread pool
+static mfError mffPrepareAsyncRead(mffAsyncReader* reader, mffAsyncRead* read)
+{
+	mfError err;
+
+	if (read->file != NULL)
+		read->acquiredFile = read->file;
+	else
+	{
+		err = mffGetFile(&read->acquiredFile, read->path);
+		if (err != MF_ERROR_OKAY)
+			return err;
+		if (read->acquiredFile == NULL)
+			return MFF_ERROR_NOT_A_FILE;
+	}
+
+	err = mfmAcquireObject(&read->acquiredFile->object);
+	if (err != MF_ERROR_OKAY)
+	{
+		read->acquiredFile = NULL;
+		return err;
+	}
+
+	if (read->size == MFF_ASYNC_READ_TO_END)
+	{
+		mfmU64 fileSize;
+		err = read->acquiredFile->archive->getFileSize(read->acquiredFile->archive, read->acquiredFile, &fileSize);
+		if (err != MF_ERROR_OKAY)
+			return err;
+		read->size = fileSize > read->offset ? fileSize - read->offset : 0;
+	}
+
+	if (read->buffer == NULL)
+	{
+		// Allocate at least one byte, so empty reads still get a buffer which can be deallocated
+		err = mfmAllocate(reader->allocator, &read->buffer, read->size == 0 ? 1 : read->size);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+
+// Tries to send a prepared read to the ring, returns MFM_FALSE if it must go to the thread pool instead
+static mfmBool mffSubmitAsyncReadToRing(mffAsyncReader* reader, mffAsyncRead* read)
+{
+	mffArchive* archive = read->acquiredFile->archive;
+	if (archive->openFileRegion == NULL)
+		return MFM_FALSE;
+	if (archive->openFileRegion(archive, read->acquiredFile, &read->region) != MF_ERROR_OKAY)
+	{
+		read->region.ownsHandle = MFM_FALSE;
+		return MFM_FALSE;
+	}
+
+	// Clamp the read to the region, so that reads on packed files don't go past their end
+	if (read->offset >= read->region.size)
+		read->size = 0;
+	else if (read->size > read->region.size - read->offset)
+		read->size = read->region.size - read->offset;
+
+	if (read->size == 0)
+	{
+		mffCompleteAsyncRead(read, MF_ERROR_OKAY, 0);
+		return MFM_TRUE;
+	}
+
+	// The ring mutex is never held while calling callbacks, since they may submit more reads
+	if (mftLockMutex(reader->ringMutex, 0) != MF_ERROR_OKAY)
+		abort();
+
+	// One CQ entry is always kept free for the NOP which stops the reaper, so the CQ never overflows
+	mfmBool pushed = reader->ring.inFlight + 1 < reader->ring.cqEntries &&
+					 mffPushIOURingEntry(&reader->ring, IORING_OP_READ, read) == MF_ERROR_OKAY;
+
+	if (mftUnlockMutex(reader->ringMutex) != MF_ERROR_OKAY)
+		abort();
+
+	if (pushed == MFM_FALSE)
+	{
+		if (read->region.ownsHandle != MFM_FALSE)
+			close((int)read->region.handle);
+		read->region.ownsHandle = MFM_FALSE;
+		return MFM_FALSE;
+	}
+
+	return MFM_TRUE;
+}
+
+#endif
+
+static void mffDestroyAsyncReaderThreads(mffAsyncReader* reader, mfmU32 count)
+{
+	mffLockAsyncMonitor(&reader->monitor);
+	reader->quit = MFM_TRUE;
+	mffSignalAsyncWork(&reader->monitor, count);
+	mffUnlockAsyncMonitor(&reader->monitor);
+
+	for (mfmU32 i = 0; i < count; ++i)
+		if (mftWaitForThread(reader->threads[i], 0) != MF_ERROR_OKAY ||
+			mftDestroyThread(reader->threads[i]) != MF_ERROR_OKAY)
+			abort();
+}
+
+mfError mffCreateAsyncReader(mffAsyncReader ** outReader, const mffAsyncReaderDesc * desc, void * allocator)
+{
+	if (outReader == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mfmU32 threadCount = (desc == NULL || desc->threadCount == 0) ? MFF_ASYNC_READER_DEFAULT_THREAD_COUNT : desc->threadCount;
+	mfmU32 queueSize = (desc == NULL || desc->queueSize == 0) ? MFF_ASYNC_READER_DEFAULT_QUEUE_SIZE : desc->queueSize;
+	mffEnum backend = desc == NULL ? MFF_ASYNC_READER_DEFAULT : desc->backend;
+	if (backend != MFF_ASYNC_READER_DEFAULT && backend != MFF_ASYNC_READER_THREADS)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mfError err;
+	mffAsyncReader* reader;
+
+	// Allocate the reader and its thread handles on a single block
+	err = mfmAllocate(allocator, &reader, sizeof(mffAsyncReader) + threadCount * sizeof(mftThread*));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memset(reader, 0, sizeof(mffAsyncReader));
+	reader->allocator = allocator;
+	reader->threads = (mftThread**)(reader + 1);
+	reader->backend = MFF_ASYNC_READER_THREADS;
+
+	err = mffInitAsyncMonitor(&reader->monitor);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeallocate(allocator, reader);
+		return err;
+	}
+
+	for (reader->threadCount = 0; reader->threadCount < threadCount; ++reader->threadCount)
+	{
+		err = mftCreateThread(&reader->threads[reader->threadCount], &mffAsyncReaderThread, reader, allocator);
+		if (err != MF_ERROR_OKAY)
+		{
+			mffDestroyAsyncReaderThreads(reader, reader->threadCount);
+			mffDeinitAsyncMonitor(&reader->monitor);
+			mfmDeallocate(allocator, reader);
+			return err;
+		}
+	}
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+	// If io_uring isn't available the reader silently uses only the thread pool
+	if (backend == MFF_ASYNC_READER_DEFAULT && mffInitIOURing(&reader->ring, queueSize) == MF_ERROR_OKAY)
+	{
+		err = mftCreateMutex(&reader->ringMutex, allocator);
+		if (err == MF_ERROR_OKAY)
+		{
+			err = mftCreateThread(&reader->reaper, &mffAsyncReaderReaperThread, reader, allocator);
+			if (err != MF_ERROR_OKAY)
+				mftDestroyMutex(reader->ringMutex);
+		}
+
+		if (err != MF_ERROR_OKAY)
+		{
+			mffDeinitIOURing(&reader->ring);
+			mffDestroyAsyncReaderThreads(reader, reader->threadCount);
+			mffDeinitAsyncMonitor(&reader->monitor);
+			mfmDeallocate(allocator, reader);
+			return err;
+		}
+
+		reader->backend = MFF_ASYNC_READER_IO_URING;
+	}
+#else
+	(void)queueSize;
+#endif
+
+	err = mfmInitObject(&reader->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	reader->object.destructorFunc = &mffDestroyAsyncReader;
+
+	*outReader = reader;
+	return MF_ERROR_OKAY;
+}
+
+void mffDestroyAsyncReader(void * reader)
+{
+	if (reader == NULL)
+		abort();
+
+	mffAsyncReader* asyncReader = reader;
+
+	// Wait for the pending reads
+	mffLockAsyncMonitor(&asyncReader->monitor);
+	while (asyncReader->pending != 0)
+		mffWaitForAsyncDone(&asyncReader->monitor);
+	mffUnlockAsyncMonitor(&asyncReader->monitor);
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+	if (asyncReader->backend == MFF_ASYNC_READER_IO_URING)
+	{
+		if (mftLockMutex(asyncReader->ringMutex, 0) != MF_ERROR_OKAY ||
+			mffPushIOURingEntry(&asyncReader->ring, IORING_OP_NOP, NULL) != MF_ERROR_OKAY ||
+			mffFlushIOURing(&asyncReader->ring) != MF_ERROR_OKAY ||
+			mftUnlockMutex(asyncReader->ringMutex) != MF_ERROR_OKAY)
+			abort();
+
+		if (mftWaitForThread(asyncReader->reaper, 0) != MF_ERROR_OKAY ||
+			mftDestroyThread(asyncReader->reaper) != MF_ERROR_OKAY ||
+			mftDestroyMutex(asyncReader->ringMutex) != MF_ERROR_OKAY)
+			abort();
+		mffDeinitIOURing(&asyncReader->ring);
+	}
+#endif
+
+	mffDestroyAsyncReaderThreads(asyncReader, asyncReader->threadCount);
+	mffDeinitAsyncMonitor(&asyncReader->monitor);
+
+	if (mfmDeinitObject(&asyncReader->object) != MF_ERROR_OKAY)
+		abort();
+	if (mfmDeallocate(asyncReader->allocator, asyncReader) != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mffGetAsyncReaderBackend(mffAsyncReader * reader, mffEnum * outBackend)
+{
+	if (reader == NULL || outBackend == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+	*outBackend = reader->backend;
+	return MF_ERROR_OKAY;
+}
+
+mfError mffSubmitAsyncReads(mffAsyncReader * reader, mffAsyncRead * reads, mfmU64 count)
+{
+	if (reader == NULL || (reads == NULL && count != 0))
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	for (mfmU64 i = 0; i < count; ++i)
+		if ((reads[i].file == NULL && reads[i].path == NULL) ||
+			(reads[i].buffer != NULL && reads[i].size == MFF_ASYNC_READ_TO_END))
+			return MFF_ERROR_INVALID_ARGUMENTS;
+
+	if (count == 0)
+		return MF_ERROR_OKAY;
+
+	for (mfmU64 i = 0; i < count; ++i)
+	{
+		reads[i].state = MFF_ASYNC_READ_PENDING;
+		reads[i].reader = reader;
+		reads[i].next = NULL;
+		reads[i].acquiredFile = NULL;
+		reads[i].region.handle = -1;
+		reads[i].region.ownsHandle = MFM_FALSE;
+		reads[i].result = MF_ERROR_OKAY;
+		reads[i].readSize = 0;
+	}
+
+	mffLockAsyncMonitor(&reader->monitor);
+	reader->pending += count;
+	mffUnlockAsyncMonitor(&reader->monitor);
+
+	// Reads which go to the thread pool are linked and queued at once
+	mffAsyncRead* first = NULL;
+	mffAsyncRead* last = NULL;
+	mfmU64 queued = 0;
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+	mfmBool useRing = reader->backend == MFF_ASYNC_READER_IO_URING;
+#endif
+
+	for (mfmU64 i = 0; i < count; ++i)
+	{
+		mffAsyncRead* read = &reads[i];
+
+		mfError err = mffPrepareAsyncRead(reader, read);
+		if (err != MF_ERROR_OKAY)
+		{
+			mffCompleteAsyncRead(read, err, 0);
+			continue;
+		}
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+		if (useRing && mffSubmitAsyncReadToRing(reader, read) != MFM_FALSE)
+			continue;
+#endif
+
+		if (last == NULL)
+			first = read;
+		else
+			last->next = read;
+		last = read;
+		++queued;
+	}
+
+#ifdef MFF_ASYNC_READER_HAS_IO_URING
+	if (useRing)
+	{
+		// A single system call for the whole batch, and the reads which couldn't be submitted go to the thread pool instead
+		if (mftLockMutex(reader->ringMutex, 0) != MF_ERROR_OKAY)
+			abort();
+		mffAsyncRead* reclaimed = NULL;
+		if (mffFlushIOURing(&reader->ring) != MF_ERROR_OKAY)
+			reclaimed = mffReclaimIOURingEntries(&reader->ring);
+		if (mftUnlockMutex(reader->ringMutex) != MF_ERROR_OKAY)
+			abort();
+		mffFallBackAsyncReads(reader, reclaimed);
+	}
+#endif
+
+	if (queued != 0)
+		mffQueueAsyncReads(reader, first, last, queued);
+
+	return MF_ERROR_OKAY;
+}
+
+mfmBool mffIsAsyncReadDone(const mffAsyncRead * read)
+{
+	mfmI32 state;
+	mftAtomic32Load(&read->state, &state);
+	return state == MFF_ASYNC_READ_DONE ? MFM_TRUE : MFM_FALSE;
+}
+
+mfError mffWaitForAsyncRead(mffAsyncRead * read)
+{
+	if (read == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mffAsyncReader* reader = read->reader;
+	if (mffIsAsyncReadDone(read) == MFM_FALSE)
+	{
+		mffLockAsyncMonitor(&reader->monitor);
+		while (read->state != MFF_ASYNC_READ_DONE)
+			mffWaitForAsyncDone(&reader->monitor);
+		mffUnlockAsyncMonitor(&reader->monitor);
+	}
+
+	return read->result;
+}
+
+mfError mffWaitForAsyncReads(mffAsyncRead * reads, mfmU64 count)
+{
+	if (reads == NULL && count != 0)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mfError result = MF_ERROR_OKAY;
+	for (mfmU64 i = 0; i < count; ++i)
+	{
+		mfError err = mffWaitForAsyncRead(&reads[i]);
+		if (err != MF_ERROR_OKAY && result == MF_ERROR_OKAY)
+			result = err;
+	}
+	return result;
+}
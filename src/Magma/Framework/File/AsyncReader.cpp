@@ -0,0 +1,126 @@
+#include "AsyncReader.hpp"
+#include "Exception.hpp"
+#include "../ErrorString.h"
+
+#include <cstring>
+
+namespace
+{
+	// Heap allocated state of a read started from C++, deleted by its completion callback
+	template <typename T>
+	struct AsyncReadState
+	{
+		mffAsyncRead read;
+		std::promise<T> promise;
+		std::vector<mfmU8> data;
+	};
+
+	template <typename T>
+	AsyncReadState<T>* CreateAsyncReadState(const Magma::Framework::File::HFile& file, mfmU64 offset, mfmU8* buffer, mfmU64 size, mffAsyncReadCallback callback)
+	{
+		auto state = new AsyncReadState<T>();
+		std::memset(&state->read, 0, sizeof(state->read));
+		state->read.file = (mffFile*)&file.Get();
+		state->read.offset = offset;
+		state->read.size = size;
+		state->read.buffer = buffer;
+		state->read.callback = callback;
+		state->read.userData = state;
+		return state;
+	}
+
+	void OnDataRead(mffAsyncRead* read, void* userData)
+	{
+		auto state = static_cast<AsyncReadState<std::vector<mfmU8>>*>(userData);
+		if (read->result == MF_ERROR_OKAY)
+		{
+			state->data.resize(read->readSize);
+			state->promise.set_value(std::move(state->data));
+		}
+		else
+			state->promise.set_exception(std::make_exception_ptr(Magma::Framework::File::FileSystemError(mfErrorToString(read->result))));
+		delete state;
+	}
+
+	void OnBufferRead(mffAsyncRead* read, void* userData)
+	{
+		auto state = static_cast<AsyncReadState<mfmU64>*>(userData);
+		if (read->result == MF_ERROR_OKAY)
+			state->promise.set_value(read->readSize);
+		else
+			state->promise.set_exception(std::make_exception_ptr(Magma::Framework::File::FileSystemError(mfErrorToString(read->result))));
+		delete state;
+	}
+}
+
+void Magma::Framework::File::HAsyncReader::Submit(mffAsyncRead * reads, mfmU64 count)
+{
+	mfError err = mffSubmitAsyncReads(&this->Get(), reads, count);
+	if (err != MF_ERROR_OKAY)
+		throw FileSystemError(mfErrorToString(err));
+}
+
+std::future<std::vector<mfmU8>> Magma::Framework::File::HAsyncReader::Read(const HFile & file, mfmU64 offset, mfmU64 size)
+{
+	// The size is resolved here so that the data can be read straight into the vector
+	if (size == MFF_ASYNC_READ_TO_END)
+	{
+		mfmU64 fileSize;
+		mfError err = mffGetFileSize((mffFile*)&file.Get(), &fileSize);
+		if (err != MF_ERROR_OKAY)
+			throw FileSystemError(mfErrorToString(err));
+		size = fileSize > offset ? fileSize - offset : 0;
+	}
+
+	auto state = CreateAsyncReadState<std::vector<mfmU8>>(file, offset, nullptr, size, &OnDataRead);
+	state->data.resize(size == 0 ? 1 : size);
+	state->read.buffer = state->data.data();
+	auto future = state->promise.get_future();
+
+	mfError err = mffSubmitAsyncReads(&this->Get(), &state->read, 1);
+	if (err != MF_ERROR_OKAY)
+	{
+		delete state;
+		throw FileSystemError(mfErrorToString(err));
+	}
+
+	return future;
+}
+
+std::future<mfmU64> Magma::Framework::File::HAsyncReader::Read(const HFile & file, mfmU64 offset, mfmU8 * buffer, mfmU64 size)
+{
+	auto state = CreateAsyncReadState<mfmU64>(file, offset, buffer, size, &OnBufferRead);
+	auto future = state->promise.get_future();
+
+	mfError err = mffSubmitAsyncReads(&this->Get(), &state->read, 1);
+	if (err != MF_ERROR_OKAY)
+	{
+		delete state;
+		throw FileSystemError(mfErrorToString(err));
+	}
+
+	return future;
+}
+
+Magma::Framework::File::AsyncReaderBackend Magma::Framework::File::HAsyncReader::GetBackend()
+{
+	mffEnum backend;
+	mfError err = mffGetAsyncReaderBackend(&this->Get(), &backend);
+	if (err != MF_ERROR_OKAY)
+		throw FileSystemError(mfErrorToString(err));
+	return static_cast<AsyncReaderBackend>(backend);
+}
+
+Magma::Framework::File::HAsyncReader Magma::Framework::File::CreateAsyncReader(mfmU32 threadCount, AsyncReaderBackend backend, Memory::HAllocator allocator)
+{
+	mffAsyncReaderDesc desc;
+	desc.threadCount = threadCount;
+	desc.queueSize = 0;
+	desc.backend = static_cast<mffEnum>(backend);
+
+	mffAsyncReader* reader = NULL;
+	mfError err = mffCreateAsyncReader(&reader, &desc, allocator.GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw FileSystemError(mfErrorToString(err));
+	return reader;
+}
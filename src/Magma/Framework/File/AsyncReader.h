@@ -0,0 +1,187 @@
+#pragma once
+
+#include "FileSystem.h"
+
+/*
+	Asynchronous file reads.
+	Reads are submitted in batches and complete on the reader's threads, where they can notify a callback, and they can also be
+	polled or waited on. Files which the archive can expose as a region of an operating system file are read with io_uring on
+	Linux (with one system call per batch), and every other read is done by a small pool of I/O threads with mffReadFile.
+	If io_uring isn't available at run time (old kernels, seccomp filters), every read goes to the thread pool.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MFF_ASYNC_READ_TO_END						MFM_U64_MAX
+
+#define MFF_ASYNC_READER_DEFAULT_THREAD_COUNT		4
+#define MFF_ASYNC_READER_DEFAULT_QUEUE_SIZE			256
+
+#define MFF_ASYNC_READER_DEFAULT					0x00
+#define MFF_ASYNC_READER_THREADS					0x01
+#define MFF_ASYNC_READER_IO_URING					0x02
+
+#define MFF_ASYNC_READ_PENDING						0x00
+#define MFF_ASYNC_READ_DONE							0x01
+
+	// Is an mfmObject
+	typedef struct mffAsyncReader mffAsyncReader;
+
+	typedef struct mffAsyncRead mffAsyncRead;
+
+	/// <summary>
+	///		Called on one of the reader's threads (or on the submitting thread, if the read fails before starting) when a read completes.
+	///		The reader doesn't touch the read after calling this, so it may be freed here.
+	/// </summary>
+	typedef void(*mffAsyncReadCallback)(mffAsyncRead* read, void* userData);
+
+	/// <summary>
+	///		Describes an asynchronous read. Must stay alive and unchanged until it completes.
+	/// </summary>
+	struct mffAsyncRead
+	{
+		/// <summary>
+		///		File to read (set to NULL to use the path instead).
+		/// </summary>
+		mffFile* file;
+
+		/// <summary>
+		///		Path of the file to read, only used if file is NULL.
+		/// </summary>
+		const mfsUTF8CodeUnit* path;
+
+		/// <summary>
+		///		Offset in the file where the read starts.
+		/// </summary>
+		mfmU64 offset;
+
+		/// <summary>
+		///		Maximum number of bytes to read (set to MFF_ASYNC_READ_TO_END to read until the end of the file).
+		/// </summary>
+		mfmU64 size;
+
+		/// <summary>
+		///		Buffer where the data is read to (set to NULL to allocate it with the reader's allocator, in which case it must be
+		///		deallocated by the caller). Must be at least size bytes big, and can't be set when size is MFF_ASYNC_READ_TO_END.
+		/// </summary>
+		mfmU8* buffer;
+
+		/// <summary>
+		///		Completion callback (optional, may be NULL).
+		///		It is called on one of the reader's threads with a copy of the read, made when the read was done, since by then
+		///		the read itself may have been freed or resubmitted by a thread which waited on it.
+		/// </summary>
+		mffAsyncReadCallback callback;
+
+		/// <summary>
+		///		User data passed to the callback.
+		/// </summary>
+		void* userData;
+
+		/// <summary>
+		///		Out read error code, valid once the read is done.
+		/// </summary>
+		mfError result;
+
+		/// <summary>
+		///		Out number of bytes read, valid once the read is done (smaller than size only if the end of the file was reached).
+		/// </summary>
+		mfmU64 readSize;
+
+		// Internal state
+		volatile mfmI32 state;
+		mffAsyncReader* reader;
+		mffAsyncRead* next;
+		mffFile* acquiredFile;
+		mffFileRegion region;
+	};
+
+	typedef struct
+	{
+		/// <summary>
+		///		Number of I/O threads (set to 0 to use MFF_ASYNC_READER_DEFAULT_THREAD_COUNT).
+		/// </summary>
+		mfmU32 threadCount;
+
+		/// <summary>
+		///		Number of io_uring submission queue entries (set to 0 to use MFF_ASYNC_READER_DEFAULT_QUEUE_SIZE).
+		/// </summary>
+		mfmU32 queueSize;
+
+		/// <summary>
+		///		MFF_ASYNC_READER_DEFAULT to use io_uring when available, or MFF_ASYNC_READER_THREADS to only use the thread pool.
+		/// </summary>
+		mffEnum backend;
+	} mffAsyncReaderDesc;
+
+	/// <summary>
+	///		Creates a new asynchronous file reader and starts its threads.
+	/// </summary>
+	/// <param name="outReader">Out reader handle</param>
+	/// <param name="desc">Reader description (set to NULL to use the default values)</param>
+	/// <param name="allocator">Allocator used for the reader and for the buffers it allocates (must be thread safe)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFF_ERROR_INVALID_ARGUMENTS if outReader is NULL or the backend is invalid.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mffCreateAsyncReader(mffAsyncReader** outReader, const mffAsyncReaderDesc* desc, void* allocator);
+
+	/// <summary>
+	///		Destroys an asynchronous file reader, waiting for its pending reads to complete.
+	/// </summary>
+	/// <param name="reader">Reader handle</param>
+	void mffDestroyAsyncReader(void* reader);
+
+	/// <summary>
+	///		Gets the backend used by a reader for files which support it (MFF_ASYNC_READER_THREADS or MFF_ASYNC_READER_IO_URING).
+	/// </summary>
+	/// <param name="reader">Reader handle</param>
+	/// <param name="outBackend">Out backend</param>
+	/// <returns>Error code</returns>
+	mfError mffGetAsyncReaderBackend(mffAsyncReader* reader, mffEnum* outBackend);
+
+	/// <summary>
+	///		Submits a batch of reads.
+	///		Reads which fail before starting (e.g.: file not found) complete before this function returns.
+	///		Reads which the kernel doesn't accept through io_uring (e.g.: when it is out of memory) are done by the thread pool instead.
+	/// </summary>
+	/// <param name="reader">Reader handle</param>
+	/// <param name="reads">Reads to submit</param>
+	/// <param name="count">Number of reads</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFF_ERROR_INVALID_ARGUMENTS if any of the reads is invalid, in which case none of them is submitted.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mffSubmitAsyncReads(mffAsyncReader* reader, mffAsyncRead* reads, mfmU64 count);
+
+	/// <summary>
+	///		Checks if a read is done, without blocking.
+	/// </summary>
+	/// <param name="read">Read</param>
+	/// <returns>MFM_TRUE if the read is done, otherwise MFM_FALSE</returns>
+	mfmBool mffIsAsyncReadDone(const mffAsyncRead* read);
+
+	/// <summary>
+	///		Waits for a read to complete.
+	///		Reads with a callback which frees them can't be waited on.
+	/// </summary>
+	/// <param name="read">Read</param>
+	/// <returns>The read's result</returns>
+	mfError mffWaitForAsyncRead(mffAsyncRead* read);
+
+	/// <summary>
+	///		Waits for a batch of reads to complete.
+	/// </summary>
+	/// <param name="reads">Reads</param>
+	/// <param name="count">Number of reads</param>
+	/// <returns>MF_ERROR_OKAY if every read succeeded, otherwise the result of the first read which failed</returns>
+	mfError mffWaitForAsyncReads(mffAsyncRead* reads, mfmU64 count);
+
+#ifdef __cplusplus
+}
+#endif
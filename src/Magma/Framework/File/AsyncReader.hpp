@@ -0,0 +1,81 @@
+#pragma once
+
+#include "FileSystem.hpp"
+#include "AsyncReader.h"
+#include "../Memory/Allocator.hpp"
+
+#include <future>
+#include <vector>
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace File
+		{
+			/// <summary>
+			///		Represents an asynchronous reader backend.
+			/// </summary>
+			enum class AsyncReaderBackend : mffEnum
+			{
+				Default		= MFF_ASYNC_READER_DEFAULT,
+				Threads		= MFF_ASYNC_READER_THREADS,
+				IOURing		= MFF_ASYNC_READER_IO_URING,
+			};
+
+			/// <summary>
+			///		Asynchronous file reader handle.
+			/// </summary>
+			class HAsyncReader : public Memory::TypedHandle<mffAsyncReader>
+			{
+			public:
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				explicit inline HAsyncReader(const Memory::Handle& object) : TypedHandle(object) {}
+
+				/// <summary>
+				///		Submits a batch of reads (see mffSubmitAsyncReads).
+				/// </summary>
+				/// <param name="reads">Reads to submit</param>
+				/// <param name="count">Number of reads</param>
+				void Submit(mffAsyncRead* reads, mfmU64 count);
+
+				/// <summary>
+				///		Reads part of a file into a new buffer.
+				///		The future throws a FileSystemError if the read fails.
+				/// </summary>
+				/// <param name="file">File handle</param>
+				/// <param name="offset">Offset in the file where the read starts</param>
+				/// <param name="size">Maximum number of bytes to read (MFF_ASYNC_READ_TO_END to read until the end of the file)</param>
+				/// <returns>Future with the data read</returns>
+				std::future<std::vector<mfmU8>> Read(const HFile& file, mfmU64 offset = 0, mfmU64 size = MFF_ASYNC_READ_TO_END);
+
+				/// <summary>
+				///		Reads part of a file into a buffer, which must stay alive until the read completes.
+				///		The future throws a FileSystemError if the read fails.
+				/// </summary>
+				/// <param name="file">File handle</param>
+				/// <param name="offset">Offset in the file where the read starts</param>
+				/// <param name="buffer">Buffer where the data will be read to</param>
+				/// <param name="size">Maximum number of bytes to read</param>
+				/// <returns>Future with the number of bytes read</returns>
+				std::future<mfmU64> Read(const HFile& file, mfmU64 offset, mfmU8* buffer, mfmU64 size);
+
+				/// <summary>
+				///		Gets the backend used for files which support it.
+				/// </summary>
+				/// <returns>Backend</returns>
+				AsyncReaderBackend GetBackend();
+			};
+
+			/// <summary>
+			///		Creates an asynchronous file reader.
+			/// </summary>
+			/// <param name="threadCount">Number of I/O threads (set to 0 to use MFF_ASYNC_READER_DEFAULT_THREAD_COUNT)</param>
+			/// <param name="backend">Default to use io_uring when available, or Threads to only use the thread pool</param>
+			/// <param name="allocator">Allocator used by the reader</param>
+			/// <returns>Asynchronous reader handle</returns>
+			HAsyncReader CreateAsyncReader(mfmU32 threadCount = 0, AsyncReaderBackend backend = AsyncReaderBackend::Default, Memory::HAllocator allocator = Memory::StandardAllocator);
+		}
+	}
+}
@@ -20,6 +20,7 @@ extern "C"
 #define MFF_ERROR_MUST_BE_EMPTY			0x070B
 #define MFF_ERROR_INVALID_MODE			0x070C
 #define MFF_ERROR_ALREADY_EXISTS		0x070D
+#define MFF_ERROR_INVALID_ARCHIVE		0x070E
 
 #ifdef __cplusplus
 }
@@ -32,6 +32,8 @@ const mfsUTF8CodeUnit * mffErrorToString(mfError err)
 			return u8"[MFF_ERROR_INVALID_MODE] Invalid file open mode";
 		case MFF_ERROR_ALREADY_EXISTS:
 			return u8"[MFF_ERROR_ALREADY_EXISTS] File/directory already exists";
+		case MFF_ERROR_INVALID_ARCHIVE:
+			return u8"[MFF_ERROR_INVALID_ARCHIVE] Invalid or corrupted archive";
 		default:
 			return NULL;
 	}
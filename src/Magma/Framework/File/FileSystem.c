@@ -224,6 +224,14 @@ mfError mffGetParent(mffDirectory ** outParent, mffFile * file)
 	return file->archive->getParent(file->archive, outParent, file);
 }
 
+mfError mffGetFilePath(const mfsUTF8CodeUnit ** outPath, mffFile * file)
+{
+	if (outPath == NULL || file == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	return file->archive->getFilePath(file->archive, outPath, file);
+}
+
 mfError mffCreateDirectory(mffDirectory ** outDir, const mfsUTF8CodeUnit * path)
 {
 	if (path == NULL)
@@ -277,6 +285,27 @@ mfError mffOpenFile(mfsStream ** outStream, mffFile * file, mffEnum mode)
 	return file->archive->openFile(file->archive, outStream, file, mode);
 }
 
+mfError mffGetFileSize(mffFile * file, mfmU64 * outSize)
+{
+	if (file == NULL || outSize == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+	return file->archive->getFileSize(file->archive, file, outSize);
+}
+
+mfError mffReadFile(mffFile * file, mfmU64 offset, mfmU8 * buffer, mfmU64 size, mfmU64 * outReadSize)
+{
+	if (file == NULL || (buffer == NULL && size != 0))
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mfmU64 readSize;
+	mfError err = file->archive->readFile(file->archive, file, offset, buffer, size, &readSize);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (outReadSize != NULL)
+		*outReadSize = readSize;
+	return MF_ERROR_OKAY;
+}
+
 mfError mffCloseFile(mfsStream * stream)
 {
 	if (stream == NULL)
@@ -2,7 +2,7 @@
 #include "Exception.hpp"
 #include "../ErrorString.h"
 
-void Magma::Framework::File::RegisterArchive(HArchive archive, const mfsUTF8CodeUnit* name)
+void Magma::Framework::File::RegisterArchive(const HArchive& archive, const mfsUTF8CodeUnit* name)
 {
 	mfError err;
 	err = mffRegisterArchive((mffArchive*)&archive.Get(), name);
@@ -10,7 +10,7 @@ void Magma::Framework::File::RegisterArchive(HArchive archive, const mfsUTF8Code
 		throw FileSystemError(mfErrorToString(err));
 }
 
-void Magma::Framework::File::UnregisterArchive(HArchive archive)
+void Magma::Framework::File::UnregisterArchive(const HArchive& archive)
 {
 	mfError err;
 	err = mffUnregisterArchive((mffArchive*)&archive.Get());
@@ -58,6 +58,36 @@ Magma::Framework::File::HFile Magma::Framework::File::HFile::GetParent()
 	return file;
 }
 
+const mfsUTF8CodeUnit* Magma::Framework::File::HFile::GetPath()
+{
+	mfError err;
+	const mfsUTF8CodeUnit* path;
+	err = mffGetFilePath(&path, (mffFile*)&this->Get());
+	if (err != MF_ERROR_OKAY)
+		throw FileSystemError(mfErrorToString(err));
+	return path;
+}
+
+mfmU64 Magma::Framework::File::HFile::GetSize()
+{
+	mfError err;
+	mfmU64 size;
+	err = mffGetFileSize((mffFile*)&this->Get(), &size);
+	if (err != MF_ERROR_OKAY)
+		throw FileSystemError(mfErrorToString(err));
+	return size;
+}
+
+mfmU64 Magma::Framework::File::HFile::Read(mfmU64 offset, mfmU8 * buffer, mfmU64 size)
+{
+	mfError err;
+	mfmU64 readSize;
+	err = mffReadFile((mffFile*)&this->Get(), offset, buffer, size, &readSize);
+	if (err != MF_ERROR_OKAY)
+		throw FileSystemError(mfErrorToString(err));
+	return readSize;
+}
+
 Magma::Framework::File::HFile Magma::Framework::File::GetFile(const mfsUTF8CodeUnit * path)
 {
 	mfError err;
@@ -110,7 +140,7 @@ void Magma::Framework::File::DeleteFile(HFile & file)
 		throw FileSystemError(mfErrorToString(err));
 }
 
-Magma::Framework::String::HStream Magma::Framework::File::OpenFile(HFile file, FileMode mode)
+Magma::Framework::String::HStream Magma::Framework::File::OpenFile(const HFile& file, FileMode mode)
 {
 	mfError err;
 	mfsStream* stream;
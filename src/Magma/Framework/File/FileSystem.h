@@ -16,6 +16,7 @@ extern "C"
 
 #define MFF_FILE_WRITE	0x01
 #define MFF_FILE_READ	0x02
+#define MFF_FILE_READ_MAPPED	0x06
 
 #define MFF_FILE		0x03
 #define MFF_DIRECTORY	0x04
@@ -25,17 +26,48 @@ extern "C"
 	typedef struct mffFile mffFile;
 	typedef mffFile mffDirectory;
 	typedef struct mffArchive mffArchive;
+	typedef struct mffFileRegion mffFileRegion;
 
 	typedef mfError(*mffArchiveGetFileFunc)(mffArchive* archive, mffFile** outFile, const mfsUTF8CodeUnit* path);
 	typedef mfError(*mffArchiveGetFileTypeFunc)(mffArchive* archive, mffFile* file, mffEnum* outType);
 	typedef mfError(*mffArchiveGetFirstFileFunc)(mffArchive* archive, mffFile** outFile, mffDirectory* directory);
 	typedef mfError(*mffArchiveGetNextFileFunc)(mffArchive* archive, mffFile** outFile, mffFile* file);
 	typedef mfError(*mffArchiveGetParentFunc)(mffArchive* archive, mffDirectory** outParent, mffFile* file);
+	typedef mfError(*mffArchiveGetFilePathFunc)(mffArchive* archive, const mfsUTF8CodeUnit** outPath, mffFile* file);
 	typedef mfError(*mffArchiveCreateDirectoryFunc)(mffArchive* archive, mffDirectory** outDir, const mfsUTF8CodeUnit* path);
 	typedef mfError(*mffArchiveDeleteDirectoryFunc)(mffArchive* archive, mffDirectory* dir);
 	typedef mfError(*mffArchiveCreateFileFunc)(mffArchive* archive, mffFile** outFile, const mfsUTF8CodeUnit* path);
 	typedef mfError(*mffArchiveDeleteFileFunc)(mffArchive* archive, mffFile* file);
 	typedef mfError(*mffArchiveOpenFileFunc)(mffArchive* archive, mfsStream** outStream, mffFile* file, mffEnum mode);
+	typedef mfError(*mffArchiveGetFileSizeFunc)(mffArchive* archive, mffFile* file, mfmU64* outSize);
+	typedef mfError(*mffArchiveReadFileFunc)(mffArchive* archive, mffFile* file, mfmU64 offset, mfmU8* buffer, mfmU64 size, mfmU64* outReadSize);
+	typedef mfError(*mffArchiveOpenFileRegionFunc)(mffArchive* archive, mffFile* file, mffFileRegion* outRegion);
+
+	/// <summary>
+	///		Region of an operating system file which holds the contents of an archive file, used by asynchronous reads.
+	/// </summary>
+	struct mffFileRegion
+	{
+		/// <summary>
+		///		Operating system file handle (a file descriptor on POSIX systems).
+		/// </summary>
+		mfmI64 handle;
+
+		/// <summary>
+		///		Offset of the file contents in the operating system file.
+		/// </summary>
+		mfmU64 offset;
+
+		/// <summary>
+		///		Size of the file contents.
+		/// </summary>
+		mfmU64 size;
+
+		/// <summary>
+		///		If MFM_TRUE, the handle must be closed by whoever opened the region.
+		/// </summary>
+		mfmBool ownsHandle;
+	};
 
 	struct mffFile
 	{
@@ -53,11 +85,19 @@ extern "C"
 		mffArchiveGetFirstFileFunc getFirstFile;
 		mffArchiveGetNextFileFunc getNextFile;
 		mffArchiveGetParentFunc getParent;
+		mffArchiveGetFilePathFunc getFilePath;
 		mffArchiveCreateDirectoryFunc createDirectory;
 		mffArchiveDeleteDirectoryFunc deleteDirectory;
 		mffArchiveCreateFileFunc createFile;
 		mffArchiveDeleteFileFunc deleteFile;
 		mffArchiveOpenFileFunc openFile;
+		mffArchiveGetFileSizeFunc getFileSize;
+
+		// Must be safe to call from several threads at once
+		mffArchiveReadFileFunc readFile;
+
+		// Optional (may be NULL), returns MFF_ERROR_NOT_SUPPORTED for files which aren't stored as is in an operating system file
+		mffArchiveOpenFileRegionFunc openFileRegion;
 	};
 
 	/// <summary>
@@ -127,6 +167,15 @@ extern "C"
 	/// <returns>Error code</returns>
 	mfError mffGetParent(mffDirectory** outParent, mffFile* file);
 
+	/// <summary>
+	///		Gets the path of a file inside its archive (e.g.: "/dir/file.txt" for the file "/archive/dir/file.txt").
+	///		The path is valid for as long as the file exists.
+	/// </summary>
+	/// <param name="outPath">Out file path</param>
+	/// <param name="file">FileHandle handle</param>
+	/// <returns>Error code</returns>
+	mfError mffGetFilePath(const mfsUTF8CodeUnit** outPath, mffFile* file);
+
 	/// <summary>
 	///		Creates a new directory.
 	/// </summary>
@@ -159,12 +208,35 @@ extern "C"
 
 	/// <summary>
 	///		Opens a file stream.
+	///		Files opened with MFF_FILE_READ_MAPPED are read only and mapped to memory, so seeking is cheap and mfsGetSpan reads without copying.
+	///		File contents are raw bytes and aren't validated as UTF-8, text read from them should be checked with mfsValidateUTF8.
 	/// </summary>
 	/// <param name="outStream">Out file stream handle</param>
 	/// <param name="file">FileHandle handle</param>
-	/// <param name="mode">Open mode (MFF_FILE_WRITE or MFF_FILE_READ)</param>
+	/// <param name="mode">Open mode (MFF_FILE_WRITE, MFF_FILE_READ or MFF_FILE_READ_MAPPED)</param>
 	mfError mffOpenFile(mfsStream** outStream, mffFile* file, mffEnum mode);
 
+	/// <summary>
+	///		Gets the size of a file in bytes.
+	/// </summary>
+	/// <param name="file">FileHandle handle</param>
+	/// <param name="outSize">Out file size</param>
+	/// <returns>Error code</returns>
+	mfError mffGetFileSize(mffFile* file, mfmU64* outSize);
+
+	/// <summary>
+	///		Reads part of a file into a buffer without opening a stream.
+	///		Can be called from several threads at once, and stops early without errors at the end of the file.
+	///		The contents aren't validated as UTF-8, like with mffOpenFile.
+	/// </summary>
+	/// <param name="file">FileHandle handle</param>
+	/// <param name="offset">Offset in the file where the read starts</param>
+	/// <param name="buffer">Buffer where the data will be read to</param>
+	/// <param name="size">Maximum number of bytes to read</param>
+	/// <param name="outReadSize">Out number of bytes read (optional, may be NULL)</param>
+	/// <returns>Error code</returns>
+	mfError mffReadFile(mffFile* file, mfmU64 offset, mfmU8* buffer, mfmU64 size, mfmU64* outReadSize);
+
 	/// <summary>
 	///		Closes a file stream.
 	/// </summary>
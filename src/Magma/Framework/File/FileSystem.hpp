@@ -29,30 +29,31 @@ namespace Magma
 			{
 				Write		= MFF_FILE_WRITE,
 				Read		= MFF_FILE_READ,		
+				ReadMapped	= MFF_FILE_READ_MAPPED,
 			};
 
 			/// <summary>
 			///		Used as an handle to an archive in the file system.
 			///		Automatically disposes of the archive if there are no more references to it.
 			/// </summary>
-			class HArchive : public Memory::Handle
+			class HArchive : public Memory::TypedHandle<mffArchive>
 			{
 			public:
-				using Handle::Handle;
-				using Handle::operator=;
-				inline HArchive(const Memory::Handle& object) : Memory::Handle(object) {}
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				inline HArchive(const Memory::Handle& object) : TypedHandle(object) {}
 			};
 
 			/// <summary>
 			///		Used as an handle to a file in the file system.
 			///		Prevents the file from being deleted while there are still references to it.
 			/// </summary>
-			class HFile : public Memory::Handle
+			class HFile : public Memory::TypedHandle<mffFile>
 			{
 			public:
-				using Handle::Handle;
-				using Handle::operator=;
-				inline HFile(const Memory::Handle& object) : Memory::Handle(object) {}
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				inline HFile(const Memory::Handle& object) : TypedHandle(object) {}
 
 				/// <summary>
 				///		Gets the file's type.
@@ -77,6 +78,27 @@ namespace Magma
 				/// </summary>
 				/// <returns>FileHandle's parent directory</returns>
 				HFile GetParent();
+
+				/// <summary>
+				///		Gets this file's path inside its archive.
+				/// </summary>
+				/// <returns>FileHandle's path inside its archive</returns>
+				const mfsUTF8CodeUnit* GetPath();
+
+				/// <summary>
+				///		Gets this file's size in bytes.
+				/// </summary>
+				/// <returns>FileHandle's size</returns>
+				mfmU64 GetSize();
+
+				/// <summary>
+				///		Reads part of this file without opening a stream (stops early at the end of the file).
+				/// </summary>
+				/// <param name="offset">Offset in the file where the read starts</param>
+				/// <param name="buffer">Buffer where the data will be read to</param>
+				/// <param name="size">Maximum number of bytes to read</param>
+				/// <returns>Number of bytes read</returns>
+				mfmU64 Read(mfmU64 offset, mfmU8* buffer, mfmU64 size);
 			};
 
 			/// <summary>
@@ -84,13 +106,13 @@ namespace Magma
 			/// </summary>
 			/// <param name="archive">ArchiveHandle handle</param>
 			/// <param name="name">ArchiveHandle name</param>
-			void RegisterArchive(HArchive archive, const mfsUTF8CodeUnit* name);
+			void RegisterArchive(const HArchive& archive, const mfsUTF8CodeUnit* name);
 
 			/// <summary>
 			///		Unregisters an archive from the file system.
 			/// </summary>
 			/// <param name="archive">ArchiveHandle handle</param>
-			void UnregisterArchive(HArchive archive);
+			void UnregisterArchive(const HArchive& archive);
 
 			/// <summary>
 			///		Gets a file from the file system.
@@ -130,7 +152,7 @@ namespace Magma
 			/// </summary>
 			/// <param name="file">FileHandle handle</param>
 			/// <returns>FileHandle stream handle</returns>
-			String::HStream OpenFile(HFile file, FileMode mode);
+			String::HStream OpenFile(const HFile& file, FileMode mode);
 		}
 	}
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "FolderArchive.h"
+#include "MappedFileStream.h"
 #include "Path.h"
 #include "Config.h"
 
 #include "../Memory/Allocator.h"
 #include "../String/StringStream.h"
-#include "../Thread/Mutex.h"
+#include "../String/StringBuilder.h"
+#include "../String/UTF8.h"
+#include "../Thread/RWLock.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -12,29 +15,48 @@
 
 #if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
 #include <Windows.h>
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #else
-#error MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM must be defined. File system library still only supports Windows.
+#error No magma framework file system library support
 #endif
 
+#define MFF_FOLDER_ARCHIVE_MIN_BUCKET_COUNT 64
+
 typedef struct mffFolderFile mffFolderFile;
 
 struct mffFolderFile
 {
 	mffFile base;
 	mfsUTF8CodeUnit path[MFF_MAX_FILE_PATH_SIZE];
+	void* allocator; // Kept here, as the file may outlive its archive
 	mffFolderFile* parent;
 	mffFolderFile* next;
 	mffFolderFile* first;
 	mffEnum type;
+	mfmU64 hash;
+	mffFolderFile* nextInBucket;
 };
 
+/*
+	Besides the file tree, the archive keeps a hash table from paths to files, so lookups don't have to walk the whole tree.
+	The table uses separate chaining and doubles its bucket count when it holds more files than buckets.
+	Lookups only take the lock for reading, while anything that changes the tree or the table takes it for writing.
+*/
 typedef struct
 {
 	mffArchive base;
 	mfsUTF8CodeUnit path[MFF_MAX_FILE_PATH_SIZE];
 	void* allocator;
 	mffFolderFile* firstFile;
-	mftMutex* mutex;
+	mffFolderFile** buckets;
+	mfmU64 bucketCount;
+	mfmU64 fileCount;
+	mftRWLock* lock;
 } mffFolderArchive;
 
 static void mffDestroyFile(void* file)
@@ -49,15 +71,103 @@ static void mffDestroyFile(void* file)
 	if (err != MF_ERROR_OKAY)
 		abort();
 
-	err = mfmDeallocate(((mffFolderArchive*)folderFile->base.archive)->allocator, folderFile);
+	err = mfmDeallocate(folderFile->allocator, folderFile);
 	if (err != MF_ERROR_OKAY)
 		abort();
 }
 
+// 64 bit FNV-1a hash
+static mfmU64 mffHashPath(const mfsUTF8CodeUnit* path)
+{
+	mfmU64 hash = 0xCBF29CE484222325;
+	for (const mfmU8* it = (const mfmU8*)path; *it != '\0'; ++it)
+	{
+		hash ^= *it;
+		hash *= 0x100000001B3;
+	}
+	return hash;
+}
+
+static mfError mffGrowFolderArchiveIndex(mffFolderArchive* archive)
+{
+	mfmU64 bucketCount = archive->bucketCount * 2;
+	mffFolderFile** buckets;
+	mfError err = mfmAllocate(archive->allocator, &buckets, bucketCount * sizeof(mffFolderFile*));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memset(buckets, 0, bucketCount * sizeof(mffFolderFile*));
+
+	// The bucket count is a power of two, so the bucket is given by the lower bits of the hash
+	for (mfmU64 i = 0; i < archive->bucketCount; ++i)
+	{
+		mffFolderFile* file = archive->buckets[i];
+		while (file != NULL)
+		{
+			mffFolderFile* next = file->nextInBucket;
+			mfmU64 bucket = file->hash & (bucketCount - 1);
+			file->nextInBucket = buckets[bucket];
+			buckets[bucket] = file;
+			file = next;
+		}
+	}
+
+	err = mfmDeallocate(archive->allocator, archive->buckets);
+	if (err != MF_ERROR_OKAY && err != MFM_ERROR_UNSUPPORTED_FUNCTION)
+		return err;
+
+	archive->buckets = buckets;
+	archive->bucketCount = bucketCount;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffIndexFile(mffFolderArchive* archive, mffFolderFile* file)
+{
+	if (archive->fileCount >= archive->bucketCount)
+	{
+		mfError err = mffGrowFolderArchiveIndex(archive);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	file->hash = mffHashPath(file->path);
+	mfmU64 bucket = file->hash & (archive->bucketCount - 1);
+	file->nextInBucket = archive->buckets[bucket];
+	archive->buckets[bucket] = file;
+	++archive->fileCount;
+	return MF_ERROR_OKAY;
+}
+
+static void mffUnindexFile(mffFolderArchive* archive, mffFolderFile* file)
+{
+	mffFolderFile** it = &archive->buckets[file->hash & (archive->bucketCount - 1)];
+	while (*it != file)
+		it = &(*it)->nextInBucket;
+	*it = file->nextInBucket;
+	--archive->fileCount;
+}
+
+// Joins the archive path with an internal path, the string builder must be destroyed by the caller
+static mfError mffCreateRealPath(mffFolderArchive* archive, mfsStringBuilder* realPath, const mfsUTF8CodeUnit* path)
+{
+	mfError err = mfsCreateLocalStringBuilder(realPath, archive->allocator);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mfsPutString(&realPath->base, archive->path);
+	if (err == MF_ERROR_OKAY)
+		err = mfsPutString(&realPath->base, path);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfsDestroyLocalStringBuilder(realPath);
+		return err;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
 static mfError mffArchiveGetFileUnsafe(mffArchive* archive, mffFile** outFile, const mfsUTF8CodeUnit* path)
 {
 	mffFolderArchive* folderArchive = archive;
-	mfError err;
 
 	if (strcmp(path, u8"/") == 0)
 	{
@@ -65,39 +175,16 @@ static mfError mffArchiveGetFileUnsafe(mffArchive* archive, mffFile** outFile, c
 		return MF_ERROR_OKAY;
 	}
 
-	mffFolderFile* currentFile = folderArchive->firstFile;
-	while (currentFile != NULL)
+	mfmU64 hash = mffHashPath(path);
+	mffFolderFile* file = folderArchive->buckets[hash & (folderArchive->bucketCount - 1)];
+	while (file != NULL)
 	{
-		if (strcmp(currentFile->path, path) == 0)
+		if (file->hash == hash && strcmp(file->path, path) == 0)
 		{
-			*outFile = currentFile;
+			*outFile = file;
 			return MF_ERROR_OKAY;
 		}
-
-		// Next file
-		if (currentFile->first != NULL)
-			currentFile = currentFile->first;
-		else
-		{
-			if (currentFile->next == NULL)
-			{
-				if (currentFile->parent == NULL)
-					break;
-				mffFolderFile* nextParent = currentFile;
-				do
-				{
-					nextParent = nextParent->parent;
-					if (nextParent == NULL)
-						break;
-				} while (nextParent->next == NULL);
-				if (nextParent == NULL)
-					currentFile = NULL;
-				else
-					currentFile = nextParent->next;
-			}
-			else
-				currentFile = currentFile->next;
-		}
+		file = file->nextInBucket;
 	}
 
 	return MFF_ERROR_FILE_NOT_FOUND;
@@ -108,18 +195,18 @@ static mfError mffArchiveGetFile(mffArchive* archive, mffFile** outFile, const m
 	mffFolderArchive* folderArchive = archive;
 	mfError err;
 
-	err = mftLockMutex(folderArchive->mutex, 0);
+	err = mftLockRead(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	err = mffArchiveGetFileUnsafe(archive, outFile, path);
 	if (err != MF_ERROR_OKAY)
 	{
-		mftUnlockMutex(folderArchive->mutex);
+		mftUnlockRead(folderArchive->lock);
 		return err;
 	}
 
-	err = mftUnlockMutex(folderArchive->mutex);
+	err = mftUnlockRead(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -157,12 +244,20 @@ static mfError mffArchiveGetParent(mffArchive* archive, mffDirectory** outParent
 	return MF_ERROR_OKAY;
 }
 
+static mfError mffArchiveGetFilePath(mffArchive* archive, const mfsUTF8CodeUnit** outPath, mffFile* file)
+{
+	mffFolderFile* folderFile = file;
+	*outPath = folderFile->path;
+	return MF_ERROR_OKAY;
+}
+
 static mfError mffArchiveCreateDirectoryUnsafe(mffArchive* archive, mffDirectory** outDir, const mfsUTF8CodeUnit* path)
 {
 	mfError err;
 	mffFolderArchive* folderArchive = archive;
 
-	err = mffArchiveGetFile(archive, outDir, path);
+	mffFile* existingFile;
+	err = mffArchiveGetFileUnsafe(archive, &existingFile, path);
 	if (err == MF_ERROR_OKAY)
 		return MFF_ERROR_ALREADY_EXISTS;
 	else if (err != MFF_ERROR_FILE_NOT_FOUND)
@@ -207,25 +302,19 @@ static mfError mffArchiveCreateDirectoryUnsafe(mffArchive* archive, mffDirectory
 
 	// Create real file
 	{
-		mfsUTF8CodeUnit realPath[256];
-		{
-			mfsStringStream ss;
-			err = mfsCreateLocalStringStream(&ss, realPath, sizeof(realPath));
-			if (err != MF_ERROR_OKAY)
-				return err;
-			err = mfsPutString(&ss, folderArchive->path);
-			if (err != MF_ERROR_OKAY)
-				return err;
-			err = mfsPutString(&ss, path);
-			if (err != MF_ERROR_OKAY)
-				return err;
-			mfsDestroyLocalStringStream(&ss);
-		}
+		mfsStringBuilder realPath;
+		err = mffCreateRealPath(folderArchive, &realPath, path);
+		if (err != MF_ERROR_OKAY)
+			return err;
 	
 #if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
-		if (!CreateDirectory(realPath, NULL))
-			return MFF_ERROR_INTERNAL;
+		BOOL created = CreateDirectory((const mfsUTF8CodeUnit*)realPath.base.buffer, NULL);
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+		mfmBool created = mkdir((const mfsUTF8CodeUnit*)realPath.base.buffer, 0777) == 0;
 #endif
+		mfsDestroyLocalStringBuilder(&realPath);
+		if (!created)
+			return MFF_ERROR_INTERNAL;
 	}
 
 	// Create file
@@ -244,6 +333,7 @@ static mfError mffArchiveCreateDirectoryUnsafe(mffArchive* archive, mffDirectory
 
 		file->base.object.destructorFunc = &mffDestroyFile;
 		file->base.archive = archive;
+		file->allocator = folderArchive->allocator;
 		file->first = NULL;
 		file->next = NULL;
 		file->parent = parentFile;
@@ -257,6 +347,10 @@ static mfError mffArchiveCreateDirectoryUnsafe(mffArchive* archive, mffDirectory
 		if (err != MF_ERROR_OKAY)
 			return err;
 		mfsDestroyLocalStringStream(&ss);
+
+		err = mffIndexFile(folderArchive, file);
+		if (err != MF_ERROR_OKAY)
+			return err;
 	}
 
 	// Add new file to parent file
@@ -296,18 +390,18 @@ static mfError mffArchiveCreateDirectory(mffArchive* archive, mffDirectory** out
 	mffFolderArchive* folderArchive = archive;
 	mfError err;
 
-	err = mftLockMutex(folderArchive->mutex, 0);
+	err = mftLockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	err = mffArchiveCreateDirectoryUnsafe(archive, outDir, path);
 	if (err != MF_ERROR_OKAY)
 	{
-		mftUnlockMutex(folderArchive->mutex);
+		mftUnlockWrite(folderArchive->lock);
 		return err;
 	}
 
-	err = mftUnlockMutex(folderArchive->mutex);
+	err = mftUnlockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -331,32 +425,22 @@ static mfError mffArchiveDeleteDirectoryUnsafe(mffArchive* archive, mffDirectory
 		mfmGetObjectRefCount(&dir->object, &refCount);
 
 		if (refCount != 1)return MFM_ERROR_STILL_HAS_REFERENCES;
-
-		err = mfmReleaseObject(&dir->object);
-		if (err != MF_ERROR_OKAY)
-			return err;
 	}
 
 	// Delete file
-	mfsUTF8CodeUnit realPath[256];
-	{
-		mfsStringStream ss;
-		err = mfsCreateLocalStringStream(&ss, realPath, sizeof(realPath));
-		if (err != MF_ERROR_OKAY)
-			return err;
-		err = mfsPutString(&ss, folderArchive->path);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		err = mfsPutString(&ss, folderFile->path);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		mfsDestroyLocalStringStream(&ss);
-	}
+	mfsStringBuilder realPath;
+	err = mffCreateRealPath(folderArchive, &realPath, folderFile->path);
+	if (err != MF_ERROR_OKAY)
+		return err;
 
 #if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
-	if (!RemoveDirectory(realPath))
-		return MFF_ERROR_INTERNAL;
+	BOOL removed = RemoveDirectory((const mfsUTF8CodeUnit*)realPath.base.buffer);
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+	mfmBool removed = rmdir((const mfsUTF8CodeUnit*)realPath.base.buffer) == 0;
 #endif
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (!removed)
+		return MFF_ERROR_INTERNAL;
 
 	// Remove file from tree
 	if (folderFile->parent == NULL)
@@ -384,8 +468,12 @@ static mfError mffArchiveDeleteDirectoryUnsafe(mffArchive* archive, mffDirectory
 		}
 	}
 
-	// Call file destructor
-	folderFile->base.object.destructorFunc(folderFile);
+	mffUnindexFile(folderArchive, folderFile);
+
+	// Release the archive's reference, which destroys the file
+	err = mfmReleaseObject(&folderFile->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
 
 	return MF_ERROR_OKAY;
 }
@@ -395,18 +483,18 @@ static mfError mffArchiveDeleteDirectory(mffArchive* archive, mffDirectory* dir)
 	mffFolderArchive* folderArchive = archive;
 	mfError err;
 
-	err = mftLockMutex(folderArchive->mutex, 0);
+	err = mftLockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	err = mffArchiveDeleteDirectoryUnsafe(archive, dir);
 	if (err != MF_ERROR_OKAY)
 	{
-		mftUnlockMutex(folderArchive->mutex);
+		mftUnlockWrite(folderArchive->lock);
 		return err;
 	}
 
-	err = mftUnlockMutex(folderArchive->mutex);
+	err = mftUnlockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -418,7 +506,8 @@ static mfError mffArchiveCreateFileUnsafe(mffArchive* archive, mffFile** outFile
 	mfError err;
 	mffFolderArchive* folderArchive = archive;
 
-	err = mffArchiveGetFile(archive, outFile, path);
+	mffFile* existingFile;
+	err = mffArchiveGetFileUnsafe(archive, &existingFile, path);
 	if (err == MF_ERROR_OKAY)
 		return MFF_ERROR_ALREADY_EXISTS;
 	else if (err != MFF_ERROR_FILE_NOT_FOUND)
@@ -463,27 +552,24 @@ static mfError mffArchiveCreateFileUnsafe(mffArchive* archive, mffFile** outFile
 
 	// Create real file
 	{
-		mfsUTF8CodeUnit realPath[256];
-		{
-			mfsStringStream ss;
-			err = mfsCreateLocalStringStream(&ss, realPath, sizeof(realPath));
-			if (err != MF_ERROR_OKAY)
-				return err;
-			err = mfsPutString(&ss, folderArchive->path);
-			if (err != MF_ERROR_OKAY)
-				return err;
-			err = mfsPutString(&ss, path);
-			if (err != MF_ERROR_OKAY)
-				return err;
-			mfsDestroyLocalStringStream(&ss);
-		}
+		mfsStringBuilder realPath;
+		err = mffCreateRealPath(folderArchive, &realPath, path);
+		if (err != MF_ERROR_OKAY)
+			return err;
 
 #if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
-		HANDLE f = CreateFile(realPath, 0, 0, NULL, CREATE_NEW, 0, NULL);
+		HANDLE f = CreateFile((const mfsUTF8CodeUnit*)realPath.base.buffer, 0, 0, NULL, CREATE_NEW, 0, NULL);
+		mfsDestroyLocalStringBuilder(&realPath);
 		if (f == INVALID_HANDLE_VALUE)
 			return MFF_ERROR_INTERNAL;
 		GetLastError();
 		CloseHandle(f);
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+		int f = open((const mfsUTF8CodeUnit*)realPath.base.buffer, O_WRONLY | O_CREAT | O_EXCL, 0666);
+		mfsDestroyLocalStringBuilder(&realPath);
+		if (f == -1)
+			return MFF_ERROR_INTERNAL;
+		close(f);
 #endif
 	}
 
@@ -503,6 +589,7 @@ static mfError mffArchiveCreateFileUnsafe(mffArchive* archive, mffFile** outFile
 
 		file->base.object.destructorFunc = &mffDestroyFile;
 		file->base.archive = archive;
+		file->allocator = folderArchive->allocator;
 		file->first = NULL;
 		file->next = NULL;
 		file->parent = parentFile;
@@ -516,6 +603,10 @@ static mfError mffArchiveCreateFileUnsafe(mffArchive* archive, mffFile** outFile
 		if (err != MF_ERROR_OKAY)
 			return err;
 		mfsDestroyLocalStringStream(&ss);
+
+		err = mffIndexFile(folderArchive, file);
+		if (err != MF_ERROR_OKAY)
+			return err;
 	}
 
 	// Add new file to parent file
@@ -555,18 +646,18 @@ static mfError mffArchiveCreateFile(mffArchive* archive, mffFile** outFile, cons
 	mffFolderArchive* folderArchive = archive;
 	mfError err;
 
-	err = mftLockMutex(folderArchive->mutex, 0);
+	err = mftLockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	err = mffArchiveCreateFileUnsafe(archive, outFile, path);
 	if (err != MF_ERROR_OKAY)
 	{
-		mftUnlockMutex(folderArchive->mutex);
+		mftUnlockWrite(folderArchive->lock);
 		return err;
 	}
 
-	err = mftUnlockMutex(folderArchive->mutex);
+	err = mftUnlockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -587,32 +678,22 @@ static mfError mffArchiveDeleteFileUnsafe(mffArchive* archive, mffFile* file)
 		mfmGetObjectRefCount(&file->object, &refCount);
 
 		if (refCount != 1)return MFM_ERROR_STILL_HAS_REFERENCES;
-
-		err = mfmReleaseObject(&file->object);
-		if (err != MF_ERROR_OKAY)
-			return err;
 	}
 
 	// Delete file
-	mfsUTF8CodeUnit realPath[256];
-	{
-		mfsStringStream ss;
-		err = mfsCreateLocalStringStream(&ss, realPath, sizeof(realPath));
-		if (err != MF_ERROR_OKAY)
-			return err;
-		err = mfsPutString(&ss, folderArchive->path);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		err = mfsPutString(&ss, folderFile->path);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		mfsDestroyLocalStringStream(&ss);
-	}
+	mfsStringBuilder realPath;
+	err = mffCreateRealPath(folderArchive, &realPath, folderFile->path);
+	if (err != MF_ERROR_OKAY)
+		return err;
 
 #if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
-	if (!DeleteFile(realPath))
-		return MFF_ERROR_INTERNAL;
+	BOOL deleted = DeleteFile((const mfsUTF8CodeUnit*)realPath.base.buffer);
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+	mfmBool deleted = unlink((const mfsUTF8CodeUnit*)realPath.base.buffer) == 0;
 #endif
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (!deleted)
+		return MFF_ERROR_INTERNAL;
 
 	// Remove file from tree
 	if (folderFile->parent == NULL)
@@ -640,8 +721,12 @@ static mfError mffArchiveDeleteFileUnsafe(mffArchive* archive, mffFile* file)
 		}
 	}
 
-	// Call file destructor
-	folderFile->base.object.destructorFunc(folderFile);
+	mffUnindexFile(folderArchive, folderFile);
+
+	// Release the archive's reference, which destroys the file
+	err = mfmReleaseObject(&folderFile->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
 
 	return MF_ERROR_OKAY;
 }
@@ -651,18 +736,18 @@ static mfError mffArchiveDeleteFile(mffArchive* archive, mffFile* file)
 	mffFolderArchive* folderArchive = archive;
 	mfError err;
 
-	err = mftLockMutex(folderArchive->mutex, 0);
+	err = mftLockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	err = mffArchiveDeleteFileUnsafe(archive, file);
 	if (err != MF_ERROR_OKAY)
 	{
-		mftUnlockMutex(folderArchive->mutex);
+		mftUnlockWrite(folderArchive->lock);
 		return err;
 	}
 
-	err = mftUnlockMutex(folderArchive->mutex);
+	err = mftUnlockWrite(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -677,6 +762,13 @@ typedef struct
 	FILE* handle;
 } mffFolderFileStream;
 
+typedef struct
+{
+	mffMappedFileStream base;
+	mffFolderArchive* archive;
+	mffFolderFile* file;
+} mffFolderMappedFileStream;
+
 static void mffArchiveCloseFileUnsafe(mffFolderFileStream* stream)
 {
 	mfError err;
@@ -694,8 +786,6 @@ static void mffArchiveCloseFileUnsafe(mffFolderFileStream* stream)
 	err = mfmDeallocate(stream->archive->allocator, stream);
 	if (err != MF_ERROR_OKAY)
 		abort();
-
-	return MF_ERROR_OKAY;
 }
 
 static mfError mffFileStreamWrite(void* stream, const mfmU8* memory, mfmU64 memorySize, mfmU64* writtenSize)
@@ -706,8 +796,7 @@ static mfError mffFileStreamWrite(void* stream, const mfmU8* memory, mfmU64 memo
 	if (writtenSize != NULL)
 		*writtenSize = size;
 
-	errno_t e = errno;
-	if (e != 0)
+	if (ferror(folderStream->handle))
 		return MFS_ERROR_INTERNAL;
 
 	return MF_ERROR_OKAY;
@@ -722,8 +811,7 @@ static mfError mffFileStreamRead(void* stream, mfmU8* memory, mfmU64 memorySize,
 	if (readSize != NULL)
 		*readSize = size;
 
-	errno_t e = errno;
-	if (e != 0)
+	if (ferror(folderStream->handle))
 		return MFS_ERROR_INTERNAL;
 
 	return MF_ERROR_OKAY;
@@ -812,68 +900,161 @@ static void mffArchiveCloseFile(void* stream)
 	mffFolderArchive* archive = folderStream->archive;
 	mfError err;
 
-	err = mftLockMutex(archive->mutex, 0);
+	err = mftLockRead(archive->lock);
 	if (err != MF_ERROR_OKAY)
 		abort();
 
 	mffArchiveCloseFileUnsafe(folderStream);
 
-	err = mftUnlockMutex(archive->mutex);
+	err = mftUnlockRead(archive->lock);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	// Release the stream's reference to the archive last, as it may destroy it
+	err = mfmReleaseObject(&archive->base.object);
 	if (err != MF_ERROR_OKAY)
 		abort();
 }
 
-static mfError mffArchiveOpenFileUnsafe(mffArchive* archive, mfsStream** outStream, mffFile* file, mffEnum mode)
+static void mffArchiveCloseMappedFile(void* stream)
 {
+	mffFolderMappedFileStream* mappedStream = stream;
+	mffFolderArchive* archive = mappedStream->archive;
 	mfError err;
 
-	mffFolderArchive* folderArchive = archive;
-	mffFolderFile* folderFile = file;
-	mffFolderFileStream* stream;
+	err = mftLockRead(archive->lock);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	mffDestroyLocalMappedFileStream(&mappedStream->base);
+
+	err = mfmReleaseObject(&mappedStream->file->base.object);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	err = mfmDeallocate(archive->allocator, mappedStream);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	err = mftUnlockRead(archive->lock);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	// Release the stream's reference to the archive last, as it may destroy it
+	err = mfmReleaseObject(&archive->base.object);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+static mfError mffArchiveOpenMappedFileUnsafe(mffFolderArchive* archive, mfsStream** outStream, mffFolderFile* file, const mfsUTF8CodeUnit* realPath)
+{
+	mfError err;
+	mffFolderMappedFileStream* stream;
 
-	mfsUTF8CodeUnit realPath[256];
+	err = mfmAllocate(archive->allocator, &stream, sizeof(mffFolderMappedFileStream));
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mffCreateLocalMappedFileStream(&stream->base, realPath);
+	if (err != MF_ERROR_OKAY)
 	{
-		mfsStringStream ss;
-		err = mfsCreateLocalStringStream(&ss, realPath, sizeof(realPath));
-		if (err != MF_ERROR_OKAY)
-			return err;
-		err = mfsPutString(&ss, folderArchive->path);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		err = mfsPutString(&ss, folderFile->path);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		mfsDestroyLocalStringStream(&ss);
+		mfmDeallocate(archive->allocator, stream);
+		return err;
 	}
+	stream->base.base.object.destructorFunc = &mffArchiveCloseMappedFile;
 
-	FILE* handle = NULL;
-	if (mode == MFF_FILE_READ)
+	err = mfmAcquireObject(file);
+	if (err != MF_ERROR_OKAY)
 	{
-		errno_t e = fopen_s(&handle, realPath, u8"rb");
-		if (e != 0)
-			return MFF_ERROR_INTERNAL;
+		mffDestroyLocalMappedFileStream(&stream->base);
+		mfmDeallocate(archive->allocator, stream);
+		return err;
 	}
-	else if (mode == MFF_FILE_WRITE)
+
+	// Open streams keep their archive alive, as closing them uses its lock and allocator
+	err = mfmAcquireObject(&archive->base.object);
+	if (err != MF_ERROR_OKAY)
 	{
-		errno_t e = fopen_s(&handle, realPath, u8"wb");
-		if (e != 0)
-			return MFF_ERROR_INTERNAL;
+		mfmReleaseObject(file);
+		mffDestroyLocalMappedFileStream(&stream->base);
+		mfmDeallocate(archive->allocator, stream);
+		return err;
 	}
-	else
+
+	stream->archive = archive;
+	stream->file = file;
+
+	*outStream = stream;
+
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveOpenFileUnsafe(mffArchive* archive, mfsStream** outStream, mffFile* file, mffEnum mode)
+{
+	mfError err;
+
+	mffFolderArchive* folderArchive = archive;
+	mffFolderFile* folderFile = file;
+	mffFolderFileStream* stream;
+
+	if (mode != MFF_FILE_READ && mode != MFF_FILE_WRITE && mode != MFF_FILE_READ_MAPPED)
 		return MFF_ERROR_INVALID_MODE;
 
+	mfsStringBuilder realPath;
+	err = mffCreateRealPath(folderArchive, &realPath, folderFile->path);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	if (mode == MFF_FILE_READ_MAPPED)
+	{
+		err = mffArchiveOpenMappedFileUnsafe(folderArchive, outStream, folderFile, (const mfsUTF8CodeUnit*)realPath.base.buffer);
+		mfsDestroyLocalStringBuilder(&realPath);
+		return err;
+	}
+
+	FILE* handle = NULL;
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
+	fopen_s(&handle, (const mfsUTF8CodeUnit*)realPath.base.buffer, mode == MFF_FILE_READ ? u8"rb" : u8"wb");
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+	handle = fopen((const mfsUTF8CodeUnit*)realPath.base.buffer, mode == MFF_FILE_READ ? u8"rb" : u8"wb");
+#endif
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (handle == NULL)
+		return MFF_ERROR_INTERNAL;
+
 	err = mfmAllocate(folderArchive->allocator, &stream, sizeof(mffFolderFileStream));
 	if (err != MF_ERROR_OKAY)
+	{
+		fclose(handle);
 		return err;
+	}
 
 	err = mfmInitObject(&stream->base.object);
 	if (err != MF_ERROR_OKAY)
+	{
+		fclose(handle);
+		mfmDeallocate(folderArchive->allocator, stream);
 		return err;
+	}
 	stream->base.object.destructorFunc = &mffArchiveCloseFile;
 
 	err = mfmAcquireObject(file);
 	if (err != MF_ERROR_OKAY)
+	{
+		fclose(handle);
+		mfmDeallocate(folderArchive->allocator, stream);
+		return err;
+	}
+
+	// Open streams keep their archive alive, as closing them uses its lock and allocator
+	err = mfmAcquireObject(&folderArchive->base.object);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmReleaseObject(file);
+		fclose(handle);
+		mfmDeallocate(folderArchive->allocator, stream);
 		return err;
+	}
 
 	stream->archive = archive;
 	stream->file = file;
@@ -890,6 +1071,7 @@ static mfError mffArchiveOpenFileUnsafe(mffArchive* archive, mfsStream** outStre
 	stream->base.buffer = NULL;
 	stream->base.bufferSize = 0;
 	stream->base.eof = &mffFileStreamEOF;
+	stream->base.getSpan = NULL;
 
 	*outStream = stream;
 
@@ -901,149 +1083,347 @@ static mfError mffArchiveOpenFile(mffArchive* archive, mfsStream** outStream, mf
 	mffFolderArchive* folderArchive = archive;
 	mfError err;
 
-	err = mftLockMutex(folderArchive->mutex, 0);
+	// Opening a file doesn't change the tree, and the file reference counts are atomic
+	err = mftLockRead(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	err = mffArchiveOpenFileUnsafe(archive, outStream, file, mode);
 	if (err != MF_ERROR_OKAY)
 	{
-		mftUnlockMutex(folderArchive->mutex);
+		mftUnlockRead(folderArchive->lock);
 		return err;
 	}
 
-	err = mftUnlockMutex(folderArchive->mutex);
+	err = mftUnlockRead(folderArchive->lock);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	return MF_ERROR_OKAY;
 }
 
+// File paths never change, so reads don't need the archive lock, only a reference to the file
+static mfError mffArchiveGetFileSize(mffArchive* archive, mffFile* file, mfmU64* outSize)
+{
+	mffFolderFile* folderFile = file;
+	if (folderFile->type != MFF_FILE)
+		return MFF_ERROR_NOT_A_FILE;
+
+	mfsStringBuilder realPath;
+	mfError err = mffCreateRealPath(archive, &realPath, folderFile->path);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
 #if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
-static mfError mffFillWindowsFiles(mffFolderArchive * archive, void* allocator, const mfsUTF8CodeUnit* path, const mfsUTF8CodeUnit* internalPath, mffFolderFile* parent, mffFolderFile** first)
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	BOOL found = GetFileAttributesEx((const mfsUTF8CodeUnit*)realPath.base.buffer, GetFileExInfoStandard, &data);
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (!found)
+		return GetLastError() == ERROR_FILE_NOT_FOUND ? MFF_ERROR_FILE_NOT_FOUND : MFF_ERROR_INTERNAL;
+	*outSize = ((mfmU64)data.nFileSizeHigh << 32) | (mfmU64)data.nFileSizeLow;
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+	struct stat st;
+	int ret = stat((const mfsUTF8CodeUnit*)realPath.base.buffer, &st);
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (ret != 0)
+		return errno == ENOENT ? MFF_ERROR_FILE_NOT_FOUND : MFF_ERROR_INTERNAL;
+	*outSize = (mfmU64)st.st_size;
+#endif
+
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveReadFile(mffArchive* archive, mffFile* file, mfmU64 offset, mfmU8* buffer, mfmU64 size, mfmU64* outReadSize)
 {
-	
+	mffFolderFile* folderFile = file;
+	if (folderFile->type != MFF_FILE)
+		return MFF_ERROR_NOT_A_FILE;
+
+	mfsStringBuilder realPath;
+	mfError err = mffCreateRealPath(archive, &realPath, folderFile->path);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	mfmU64 readSize = 0;
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
+	HANDLE handle = CreateFile((const mfsUTF8CodeUnit*)realPath.base.buffer, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (handle == INVALID_HANDLE_VALUE)
+		return GetLastError() == ERROR_FILE_NOT_FOUND ? MFF_ERROR_FILE_NOT_FOUND : MFF_ERROR_INTERNAL;
+
+	while (readSize < size)
+	{
+		// ReadFile takes 32 bit sizes and the offset is passed on each call, so the file position is never shared
+		mfmU64 position = offset + readSize;
+		OVERLAPPED overlapped;
+		memset(&overlapped, 0, sizeof(overlapped));
+		overlapped.Offset = (DWORD)(position & 0xFFFFFFFF);
+		overlapped.OffsetHigh = (DWORD)(position >> 32);
+
+		DWORD chunkSize = (size - readSize) > 0x40000000 ? 0x40000000 : (DWORD)(size - readSize);
+		DWORD chunkReadSize = 0;
+		if (!ReadFile(handle, buffer + readSize, chunkSize, &chunkReadSize, &overlapped))
+		{
+			if (GetLastError() == ERROR_HANDLE_EOF)
+				break;
+			CloseHandle(handle);
+			return MFF_ERROR_INTERNAL;
+		}
+		if (chunkReadSize == 0)
+			break;
+		readSize += chunkReadSize;
+	}
+
+	CloseHandle(handle);
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+	int fd = open((const mfsUTF8CodeUnit*)realPath.base.buffer, O_RDONLY);
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (fd < 0)
+		return errno == ENOENT ? MFF_ERROR_FILE_NOT_FOUND : MFF_ERROR_INTERNAL;
+
+	while (readSize < size)
+	{
+		mfmU64 chunkSize = (size - readSize) > 0x40000000 ? 0x40000000 : (size - readSize);
+		ssize_t ret = pread(fd, buffer + readSize, chunkSize, (off_t)(offset + readSize));
+		if (ret < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			close(fd);
+			return MFF_ERROR_INTERNAL;
+		}
+		if (ret == 0)
+			break;
+		readSize += (mfmU64)ret;
+	}
+
+	close(fd);
+#endif
+
+	*outReadSize = readSize;
+	return MF_ERROR_OKAY;
+}
+
+#if defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+static mfError mffArchiveOpenFileRegion(mffArchive* archive, mffFile* file, mffFileRegion* outRegion)
+{
+	mffFolderFile* folderFile = file;
+	if (folderFile->type != MFF_FILE)
+		return MFF_ERROR_NOT_A_FILE;
+
+	mfsStringBuilder realPath;
+	mfError err = mffCreateRealPath(archive, &realPath, folderFile->path);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	int fd = open((const mfsUTF8CodeUnit*)realPath.base.buffer, O_RDONLY);
+	mfsDestroyLocalStringBuilder(&realPath);
+	if (fd < 0)
+		return errno == ENOENT ? MFF_ERROR_FILE_NOT_FOUND : MFF_ERROR_INTERNAL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return MFF_ERROR_INTERNAL;
+	}
+
+	outRegion->handle = fd;
+	outRegion->offset = 0;
+	outRegion->size = (mfmU64)st.st_size;
+	outRegion->ownsHandle = MFM_TRUE;
+	return MF_ERROR_OKAY;
+}
+#endif
 
+// Adds a file found when scanning the archive folder to the tree and to the index
+static mfError mffAddFoundFile(mffFolderArchive* archive, void* allocator, const mfsUTF8CodeUnit* internalPath, const mfsUTF8CodeUnit* name, mffEnum type, mffFolderFile* parent, mffFolderFile*** first, mffFolderFile** outFile)
+{
+	mfError err;
+	mffFolderFile* file;
+
+	err = mfmAllocate(allocator, &file, sizeof(mffFolderFile));
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mfmInitObject(&file->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mfmAcquireObject(&file->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	file->base.object.destructorFunc = &mffDestroyFile;
+	file->base.archive = archive;
+	file->allocator = allocator;
+	file->first = NULL;
+	file->next = NULL;
+	file->parent = parent;
+	file->type = type;
+
+	// Get internal path
+	mfsStringStream ss;
+	err = mfsCreateLocalStringStream(&ss, file->path, sizeof(file->path));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	err = mfsPrintFormat(&ss, u8"%s/%s", internalPath, name);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	mfsDestroyLocalStringStream(&ss);
+
+	err = mffIndexFile(archive, file);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	**first = file;
+	*first = &file->next;
+	*outFile = file;
+	return MF_ERROR_OKAY;
+}
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
+static mfError mffFillWindowsFiles(mffFolderArchive * archive, void* allocator, const mfsUTF8CodeUnit* path, const mfsUTF8CodeUnit* internalPath, mffFolderFile* parent, mffFolderFile** first)
+{
 	mfError err;
 	WIN32_FIND_DATA data;
 	HANDLE hFind;
 
 	{
-		mfsUTF8CodeUnit searchPath[MFF_PATH_MAX_SIZE];
-
-		mfsStringStream ss;
-		err = mfsCreateLocalStringStream(&ss, searchPath, sizeof(searchPath));
+		mfsStringBuilder searchPath;
+		err = mfsCreateLocalStringBuilder(&searchPath, allocator);
 		if (err != MF_ERROR_OKAY)
 			return err;
-		err = mfsPrintFormat(&ss, u8"%s/*.*", path);
+		err = mfsPrintFormat(&searchPath, u8"%s/*.*", path);
 		if (err != MF_ERROR_OKAY)
+		{
+			mfsDestroyLocalStringBuilder(&searchPath);
 			return err;
-		mfsDestroyLocalStringStream(&ss);
+		}
 
-		hFind = FindFirstFile(searchPath, &data);
+		hFind = FindFirstFile((const mfsUTF8CodeUnit*)searchPath.base.buffer, &data);
+		mfsDestroyLocalStringBuilder(&searchPath);
 	}
 
+	if (hFind == INVALID_HANDLE_VALUE)
+		return MF_ERROR_OKAY;
 
-	if (hFind != INVALID_HANDLE_VALUE)
+	// Iterate over files in directory
+	do
 	{
-		// Iterate over files in directory
-		do
+		if (strcmp(data.cFileName, u8".") == 0 ||
+			strcmp(data.cFileName, u8"..") == 0)
+			continue;
+
+		// Names which aren't valid UTF-8 can't be represented as paths
+		if (mfsValidateUTF8(data.cFileName, strlen(data.cFileName), NULL) != MF_ERROR_OKAY)
+			continue;
+
+		mffEnum type = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? MFF_DIRECTORY : MFF_FILE;
+		mffFolderFile* file;
+		err = mffAddFoundFile(archive, allocator, internalPath, data.cFileName, type, parent, &first, &file);
+		if (err != MF_ERROR_OKAY)
 		{
-			if (strcmp(data.cFileName, u8".") == 0 ||
-				strcmp(data.cFileName, u8"..") == 0)
-				continue;
+			FindClose(hFind);
+			return err;
+		}
 
-			// If is directory
-			if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		if (type == MFF_DIRECTORY)
+		{
+			// Get real path
+			mfsStringBuilder realPath;
+			err = mfsCreateLocalStringBuilder(&realPath, allocator);
+			if (err == MF_ERROR_OKAY)
 			{
-				mffFolderFile* file;
-
-				err = mfmAllocate(allocator, &file, sizeof(mffFolderFile));
-				if (err != MF_ERROR_OKAY)
-					return err;
-
-				err = mfmInitObject(&file->base.object);
-				if (err != MF_ERROR_OKAY)
-					return err;
-
-				err = mfmAcquireObject(&file->base.object);
-				if (err != MF_ERROR_OKAY)
-					return err;
-
-				file->base.object.destructorFunc = &mffDestroyFile;
-				file->base.archive = archive;
-				file->first = NULL;
-				file->next = NULL;
-				file->parent = parent;
-				file->type = MFF_DIRECTORY;
-
-				mfsStringStream ss;
-				
-				// Get internal path
-				err = mfsCreateLocalStringStream(&ss, file->path, sizeof(file->path));
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfsPrintFormat(&ss, u8"%s/%s", internalPath, data.cFileName);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfsDestroyLocalStringStream(&ss);
-
-				// Get real path
-				mfsUTF8CodeUnit realPath[MFF_MAX_FILE_PATH_SIZE];
-				err = mfsCreateLocalStringStream(&ss, realPath, sizeof(realPath));
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfsPrintFormat(&ss, u8"%s/%s", path, data.cFileName);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfsDestroyLocalStringStream(&ss);
-
-				*first = file;
-				first = &(*first)->next;
-
-				err = mffFillWindowsFiles(archive, allocator, realPath, file->path, file, &file->first);
-				if (err != MF_ERROR_OKAY)
-					return err;
+				err = mfsPrintFormat(&realPath, u8"%s/%s", path, data.cFileName);
+				if (err == MF_ERROR_OKAY)
+					err = mffFillWindowsFiles(archive, allocator, (const mfsUTF8CodeUnit*)realPath.base.buffer, file->path, file, &file->first);
+				mfsDestroyLocalStringBuilder(&realPath);
 			}
-			// If is file
-			else
+
+			if (err != MF_ERROR_OKAY)
+			{
+				FindClose(hFind);
+				return err;
+			}
+		}
+	}
+	while (FindNextFile(hFind, &data));
+
+	FindClose(hFind);
+	return MF_ERROR_OKAY;
+}
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+static mfError mffFillPOSIXFiles(mffFolderArchive * archive, void* allocator, const mfsUTF8CodeUnit* path, const mfsUTF8CodeUnit* internalPath, mffFolderFile* parent, mffFolderFile** first)
+{
+	mfError err;
+
+	DIR* dir = opendir(path);
+	if (dir == NULL)
+		return MF_ERROR_OKAY;
+
+	// Iterate over files in directory
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (strcmp(entry->d_name, u8".") == 0 ||
+			strcmp(entry->d_name, u8"..") == 0)
+			continue;
+
+		// Names which aren't valid UTF-8 can't be represented as paths
+		if (mfsValidateUTF8(entry->d_name, strlen(entry->d_name), NULL) != MF_ERROR_OKAY)
+			continue;
+
+		// Get real path
+		mfsStringBuilder realPath;
+		err = mfsCreateLocalStringBuilder(&realPath, allocator);
+		if (err != MF_ERROR_OKAY)
+		{
+			closedir(dir);
+			return err;
+		}
+		err = mfsPrintFormat(&realPath, u8"%s/%s", path, entry->d_name);
+		if (err != MF_ERROR_OKAY)
+		{
+			mfsDestroyLocalStringBuilder(&realPath);
+			closedir(dir);
+			return err;
+		}
+
+		// Some file systems don't report the entry type, so it must be checked with stat
+		mffEnum type;
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(DT_DIR)
+		if (entry->d_type == DT_DIR)
+			type = MFF_DIRECTORY;
+		else if (entry->d_type == DT_REG)
+			type = MFF_FILE;
+		else
+#endif
+		{
+			struct stat st;
+			if (stat((const mfsUTF8CodeUnit*)realPath.base.buffer, &st) != 0)
 			{
-				mffFolderFile* file;
-
-				err = mfmAllocate(allocator, &file, sizeof(mffFolderFile));
-				if (err != MF_ERROR_OKAY)
-					return err;
-
-				err = mfmInitObject(&file->base.object);
-				if (err != MF_ERROR_OKAY)
-					return err;
-
-				err = mfmAcquireObject(&file->base.object);
-				if (err != MF_ERROR_OKAY)
-					return err;
-
-				file->base.object.destructorFunc = &mffDestroyFile;
-				file->base.archive = archive;
-				file->first = NULL;
-				file->next = NULL;
-				file->parent = parent;
-				file->type = MFF_FILE;
-
-				mfsStringStream ss;
-				err = mfsCreateLocalStringStream(&ss, file->path, sizeof(file->path));
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfsPrintFormat(&ss, u8"%s/%s", internalPath, data.cFileName);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfsDestroyLocalStringStream(&ss);
-
-				*first = file;
-				first = &(*first)->next;
+				mfsDestroyLocalStringBuilder(&realPath);
+				continue;
 			}
+			type = S_ISDIR(st.st_mode) ? MFF_DIRECTORY : MFF_FILE;
+		}
+
+		mffFolderFile* file;
+		err = mffAddFoundFile(archive, allocator, internalPath, entry->d_name, type, parent, &first, &file);
+		if (err == MF_ERROR_OKAY && type == MFF_DIRECTORY)
+			err = mffFillPOSIXFiles(archive, allocator, (const mfsUTF8CodeUnit*)realPath.base.buffer, file->path, file, &file->first);
+		mfsDestroyLocalStringBuilder(&realPath);
+		if (err != MF_ERROR_OKAY)
+		{
+			closedir(dir);
+			return err;
 		}
-		while (FindNextFile(hFind, &data));
 	}
+
+	closedir(dir);
+	return MF_ERROR_OKAY;
 }
 #endif
 
@@ -1062,32 +1442,55 @@ mfError mffCreateFolderArchive(mffArchive ** outArchive, void* allocator, const
 	folderArchive->base.object.destructorFunc = &mffDestroyFolderArchive;
 	folderArchive->allocator = allocator;
 	strcpy(folderArchive->path, path);
-	strcpy(folderArchive->base.name, mffGetPathName(path));
+	const mfsUTF8CodeUnit* name = mffGetPathName(path);
+	if (name == NULL)
+		name = path;
+	if (strlen(name) >= MFF_MAX_ARCHIVE_NAME_SIZE)
+		name = u8"folder";
+	strcpy(folderArchive->base.name, name);
 
 	folderArchive->base.getFile = &mffArchiveGetFile;
 	folderArchive->base.getFileType = &mffArchiveGetFileType;
 	folderArchive->base.getFirstFile = &mffArchiveGetFirstFile;
 	folderArchive->base.getNextFile = &mffArchiveGetNextFile;
 	folderArchive->base.getParent = &mffArchiveGetParent;
+	folderArchive->base.getFilePath = &mffArchiveGetFilePath;
 	folderArchive->base.createDirectory = &mffArchiveCreateDirectory;
 	folderArchive->base.deleteDirectory = &mffArchiveDeleteDirectory;
 	folderArchive->base.createFile = &mffArchiveCreateFile;
 	folderArchive->base.deleteFile = &mffArchiveDeleteFile;
 	folderArchive->base.openFile = &mffArchiveOpenFile;
+	folderArchive->base.getFileSize = &mffArchiveGetFileSize;
+	folderArchive->base.readFile = &mffArchiveReadFile;
+#if defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+	folderArchive->base.openFileRegion = &mffArchiveOpenFileRegion;
+#else
+	folderArchive->base.openFileRegion = NULL;
+#endif
 
 	folderArchive->firstFile = NULL;
 
-	// Create mutex
-	err = mftCreateMutex(&folderArchive->mutex, allocator);
+	// Create index
+	folderArchive->bucketCount = MFF_FOLDER_ARCHIVE_MIN_BUCKET_COUNT;
+	folderArchive->fileCount = 0;
+	err = mfmAllocate(allocator, &folderArchive->buckets, folderArchive->bucketCount * sizeof(mffFolderFile*));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memset(folderArchive->buckets, 0, folderArchive->bucketCount * sizeof(mffFolderFile*));
+
+	// Create lock
+	err = mftCreateRWLock(&folderArchive->lock, allocator);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
 	// Get files in folder
 #if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
 	err = mffFillWindowsFiles(folderArchive, allocator, path, u8"", NULL, &folderArchive->firstFile);
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+	err = mffFillPOSIXFiles(folderArchive, allocator, path, u8"", NULL, &folderArchive->firstFile);
+#endif
 	if (err != MF_ERROR_OKAY)
 		return err;
-#endif
 
 	*outArchive = folderArchive;
 	return MF_ERROR_OKAY;
@@ -1101,7 +1504,24 @@ void mffDestroyFolderArchive(void * archive)
 	mfError err;
 	mffFolderArchive* folderArchive = archive;
 
-	err = mftDestroyMutex(folderArchive->mutex);
+	err = mftDestroyRWLock(folderArchive->lock);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	// Release the archive's references to its files
+	for (mfmU64 i = 0; i < folderArchive->bucketCount; ++i)
+	{
+		mffFolderFile* file = folderArchive->buckets[i];
+		while (file != NULL)
+		{
+			mffFolderFile* next = file->nextInBucket;
+			if (mfmReleaseObject(&file->base.object) != MF_ERROR_OKAY)
+				abort();
+			file = next;
+		}
+	}
+
+	err = mfmDeallocate(folderArchive->allocator, folderArchive->buckets);
 	if (err != MF_ERROR_OKAY)
 		abort();
 
@@ -0,0 +1,278 @@
+#include "MappedFileStream.h"
+#include "Config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
+#include <Windows.h>
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_FILESYSTEM)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error No magma framework file system library support
+#endif
+
+static mfError mffMappedFileStreamRead(void* stream, mfmU8* data, mfmU64 size, mfmU64* readSize)
+{
+	if (stream == NULL || data == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	mffMappedFileStream* mapped = stream;
+
+	mfmU64 available = mapped->size - mapped->head;
+	if (size > available)
+	{
+		if (available > 0)
+			memcpy(data, mapped->data + mapped->head, available);
+		if (readSize != NULL)
+			*readSize = available;
+		mapped->head = mapped->size;
+		return MFS_ERROR_EOF;
+	}
+
+	memcpy(data, mapped->data + mapped->head, size);
+	if (readSize != NULL)
+		*readSize = size;
+	mapped->head += size;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMappedFileStreamFlush(void* stream)
+{
+	// Do nothing
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMappedFileStreamSeekBegin(void* stream, mfmU64 position)
+{
+	mffMappedFileStream* mapped = stream;
+	if (position > mapped->size)
+	{
+		mapped->head = mapped->size;
+		return MFS_ERROR_EOF;
+	}
+
+	mapped->head = position;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMappedFileStreamSeekEnd(void* stream, mfmU64 position)
+{
+	mffMappedFileStream* mapped = stream;
+	if (position + 1 > mapped->size)
+	{
+		mapped->head = 0;
+		return MFS_ERROR_EOF;
+	}
+
+	mapped->head = mapped->size - position - 1;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMappedFileStreamSeekHead(void* stream, mfmI64 offset)
+{
+	mffMappedFileStream* mapped = stream;
+	if (offset >= 0 && mapped->head + offset > mapped->size)
+	{
+		mapped->head = mapped->size;
+		return MFS_ERROR_EOF;
+	}
+	else if (offset < 0 && (mfmU64)-offset > mapped->head)
+	{
+		mapped->head = 0;
+		return MFS_ERROR_EOF;
+	}
+
+	mapped->head += offset;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMappedFileStreamTell(void* stream, mfmU64* position)
+{
+	mffMappedFileStream* mapped = stream;
+	*position = mapped->head;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMappedFileStreamEOF(void* stream, mfmBool* eof)
+{
+	mffMappedFileStream* mapped = stream;
+	*eof = mapped->head >= mapped->size ? MFM_TRUE : MFM_FALSE;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMappedFileStreamGetSpan(void* stream, mfmU64 size, const mfmU8** data, mfmU64* outSize)
+{
+	mffMappedFileStream* mapped = stream;
+	if (mapped->head >= mapped->size)
+		return MFS_ERROR_EOF;
+
+	if (size > mapped->size - mapped->head)
+		size = mapped->size - mapped->head;
+	*data = mapped->data + mapped->head;
+	*outSize = size;
+	mapped->head += size;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffMapFile(mffMappedFileStream* stream, const mfsUTF8CodeUnit* path)
+{
+	stream->data = NULL;
+	stream->size = 0;
+	stream->fileHandle = NULL;
+	stream->mappingHandle = NULL;
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
+	HANDLE file = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return GetLastError() == ERROR_FILE_NOT_FOUND ? MFF_ERROR_FILE_NOT_FOUND : MFF_ERROR_INTERNAL;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return MFF_ERROR_INTERNAL;
+	}
+	stream->fileHandle = file;
+	stream->size = (mfmU64)size.QuadPart;
+
+	// Empty files can't be mapped
+	if (stream->size == 0)
+		return MF_ERROR_OKAY;
+
+	HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return MFF_ERROR_INTERNAL;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return MFF_ERROR_INTERNAL;
+	}
+
+	stream->mappingHandle = mapping;
+	stream->data = view;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return errno == ENOENT ? MFF_ERROR_FILE_NOT_FOUND : MFF_ERROR_INTERNAL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return MFF_ERROR_INTERNAL;
+	}
+	stream->size = (mfmU64)st.st_size;
+
+	// Empty files can't be mapped
+	if (stream->size == 0)
+	{
+		close(fd);
+		return MF_ERROR_OKAY;
+	}
+
+	void* view = mmap(NULL, (size_t)stream->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping keeps its own reference to the file
+	if (view == MAP_FAILED)
+		return MFF_ERROR_INTERNAL;
+
+	// Assets are mostly decoded from start to end, so ask for aggressive read ahead
+	madvise(view, (size_t)stream->size, MADV_SEQUENTIAL);
+	stream->data = view;
+#endif
+
+	return MF_ERROR_OKAY;
+}
+
+static void mffUnmapFile(mffMappedFileStream* stream)
+{
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_FILESYSTEM)
+	if (stream->data != NULL)
+		UnmapViewOfFile(stream->data);
+	if (stream->mappingHandle != NULL)
+		CloseHandle(stream->mappingHandle);
+	if (stream->fileHandle != NULL)
+		CloseHandle(stream->fileHandle);
+#else
+	if (stream->data != NULL)
+		munmap((void*)stream->data, (size_t)stream->size);
+#endif
+}
+
+static mfError mffInitMappedStream(mffMappedFileStream* stream)
+{
+	mfError err = mfmInitObject(&stream->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	stream->base.object.destructorFunc = &mffDestroyLocalMappedFileStream;
+
+	stream->base.read = &mffMappedFileStreamRead;
+	stream->base.write = NULL;
+	stream->base.flush = &mffMappedFileStreamFlush;
+	stream->base.setBuffer = NULL;
+	stream->base.seekBegin = &mffMappedFileStreamSeekBegin;
+	stream->base.seekEnd = &mffMappedFileStreamSeekEnd;
+	stream->base.seekHead = &mffMappedFileStreamSeekHead;
+	stream->base.tell = &mffMappedFileStreamTell;
+	stream->base.eof = &mffMappedFileStreamEOF;
+	stream->base.getSpan = &mffMappedFileStreamGetSpan;
+	stream->base.buffer = NULL;
+	stream->base.bufferSize = 0;
+
+	stream->head = 0;
+
+	return MF_ERROR_OKAY;
+}
+
+mfError mffCreateLocalMappedFileStream(mffMappedFileStream* stream, const mfsUTF8CodeUnit* path)
+{
+	if (stream == NULL || path == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mfError err = mffMapFile(stream, path);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	stream->ownsMapping = MFM_TRUE;
+
+	err = mffInitMappedStream(stream);
+	if (err != MF_ERROR_OKAY)
+	{
+		mffUnmapFile(stream);
+		return err;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+mfError mffCreateLocalMappedMemoryStream(mffMappedFileStream* stream, const mfmU8* data, mfmU64 size)
+{
+	if (stream == NULL || (data == NULL && size != 0))
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	stream->data = data;
+	stream->size = size;
+	stream->fileHandle = NULL;
+	stream->mappingHandle = NULL;
+	stream->ownsMapping = MFM_FALSE;
+
+	return mffInitMappedStream(stream);
+}
+
+void mffDestroyLocalMappedFileStream(mffMappedFileStream* stream)
+{
+	if (stream == NULL)
+		abort();
+	if (mfmDeinitObject(&stream->base.object) != MF_ERROR_OKAY)
+		abort();
+	if (stream->ownsMapping)
+		mffUnmapFile(stream);
+}
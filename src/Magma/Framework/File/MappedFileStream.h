@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Error.h"
+
+#include "../String/Stream.h"
+
+/*
+	Read only memory mapped file streams.
+	The whole file is mapped when the stream is created, so reads are a single copy from the mapping, seeks only move the
+	stream head, and mfsGetSpan returns pointers straight into the mapping.
+	Streams can also be created over memory which is already mapped (e.g.: a slice of a packed archive), in which case
+	nothing is unmapped when they are destroyed.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	typedef struct
+	{
+		mfsStream base;
+		const mfmU8* data;
+		mfmU64 size;
+		mfmU64 head;
+		void* fileHandle;
+		void* mappingHandle;
+		mfmBool ownsMapping;
+	} mffMappedFileStream;
+
+	/// <summary>
+	///		Maps a file and creates a read only stream over it, without allocating space for it.
+	/// </summary>
+	/// <param name="stream">Pointer to mapped file stream</param>
+	/// <param name="path">Real path of the file on the operating system's file system</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFF_ERROR_INVALID_ARGUMENTS if <paramref name="stream">stream</paramref> or <paramref name="path">path</paramref> are NULL.
+	///		Returns MFF_ERROR_FILE_NOT_FOUND if the file doesn't exist.
+	///		Returns MFF_ERROR_INTERNAL if the file couldn't be mapped.
+	/// </returns>
+	mfError mffCreateLocalMappedFileStream(mffMappedFileStream* stream, const mfsUTF8CodeUnit* path);
+
+	/// <summary>
+	///		Creates a read only stream over memory which is already mapped, without allocating space for it.
+	///		The memory must stay valid until the stream is destroyed.
+	/// </summary>
+	/// <param name="stream">Pointer to mapped file stream</param>
+	/// <param name="data">Pointer to the mapped memory (may be NULL if <paramref name="size">size</paramref> is 0)</param>
+	/// <param name="size">Size of the mapped memory</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFF_ERROR_INVALID_ARGUMENTS if <paramref name="stream">stream</paramref> is NULL or <paramref name="data">data</paramref> is NULL and <paramref name="size">size</paramref> isn't 0.
+	/// </returns>
+	mfError mffCreateLocalMappedMemoryStream(mffMappedFileStream* stream, const mfmU8* data, mfmU64 size);
+
+	/// <summary>
+	///		Destroys a stream created by mffCreateLocalMappedFileStream or mffCreateLocalMappedMemoryStream, unmapping its file if it has one.
+	/// </summary>
+	/// <param name="stream">Pointer to mapped file stream</param>
+	void mffDestroyLocalMappedFileStream(mffMappedFileStream* stream);
+
+#ifdef __cplusplus
+}
+#endif
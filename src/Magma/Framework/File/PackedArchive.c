@@ -0,0 +1,951 @@
+#include "PackedArchive.h"
+#include "MappedFileStream.h"
+#include "Path.h"
+
+#include "../Memory/Allocator.h"
+#include "../Memory/Endianness.h"
+#include "../Memory/Deflate.h"
+#include "../Memory/Inflate.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MFF_PACKED_ARCHIVE_MAGIC		u8"MFPK"
+#define MFF_PACKED_ARCHIVE_BLOCK_SIZE	64
+#define MFF_PACKED_ARCHIVE_ENTRY_SIZE	64
+
+#define MFF_PACKED_ENTRY_DIRECTORY		0x01
+#define MFF_PACKED_ENTRY_DEFLATE		0x02
+
+// Compressed entries are decompressed with mfmInflate, so they may be zlib streams or LZ frames.
+// Deflate can't compress data by more than about 1032:1 (and LZ frames by even less), so larger uncompressed sizes mean the entry is corrupted
+#define MFF_PACKED_ARCHIVE_MAX_DEFLATE_RATIO	1032
+
+typedef struct mffPackedFile mffPackedFile;
+
+struct mffPackedFile
+{
+	mffFile base;
+	const mfsUTF8CodeUnit* path;
+	const mfmU8* data;
+	mfmU64 dataSize;
+	mfmU64 size;
+	mfmU64 hash;
+	mffEnum type;
+	mfmBool deflated;
+	mffPackedFile* parent;
+	mffPackedFile* next;
+	mffPackedFile* first;
+};
+
+/*
+	The files are kept in the same order as the entries in the archive, which are sorted by hash, so lookups are a binary search.
+	Nothing changes after the archive is created, so no lock is needed.
+*/
+typedef struct
+{
+	mffArchive base;
+	void* allocator;
+	mffMappedFileStream mapping;
+	mffPackedFile* files;
+	mfmU64 fileCount;
+	mffPackedFile* firstFile;
+} mffPackedArchive;
+
+typedef struct
+{
+	mffMappedFileStream base;
+	mffPackedArchive* archive;
+	mffPackedFile* file;
+	mfmU8* inflated;
+} mffPackedFileStream;
+
+// FNV-1a hash of a path, which is stored on the archive entries so it must never change
+static mfmU64 mffHashPackedPath(const mfsUTF8CodeUnit* path)
+{
+	mfmU64 hash = 0xCBF29CE484222325;
+	for (const mfmU8* it = (const mfmU8*)path; *it != '\0'; ++it)
+	{
+		hash ^= *it;
+		hash *= 0x100000001B3;
+	}
+	return hash;
+}
+
+// Values are copied through locals since the endianness functions need aligned pointers
+static mfmU64 mffReadPackedU64(const mfmU8* data)
+{
+	mfmU64 raw, value;
+	memcpy(&raw, data, sizeof(raw));
+	mfmFromLittleEndian8(&raw, &value);
+	return value;
+}
+
+static mfmU32 mffReadPackedU32(const mfmU8* data)
+{
+	mfmU32 raw, value;
+	memcpy(&raw, data, sizeof(raw));
+	mfmFromLittleEndian4(&raw, &value);
+	return value;
+}
+
+static void mffWritePackedU64(mfmU8* data, mfmU64 value)
+{
+	mfmU64 raw;
+	mfmToLittleEndian8(&value, &raw);
+	memcpy(data, &raw, sizeof(raw));
+}
+
+static void mffWritePackedU32(mfmU8* data, mfmU32 value)
+{
+	mfmU32 raw;
+	mfmToLittleEndian4(&value, &raw);
+	memcpy(data, &raw, sizeof(raw));
+}
+
+static void mffDestroyPackedFile(void* file)
+{
+	if (file == NULL)
+		abort();
+
+	// The file memory belongs to the archive
+	mffPackedFile* packedFile = file;
+	if (mfmDeinitObject(&packedFile->base.object) != MF_ERROR_OKAY)
+		abort();
+}
+
+static mfError mffArchiveGetFile(mffArchive* archive, mffFile** outFile, const mfsUTF8CodeUnit* path)
+{
+	mffPackedArchive* packedArchive = archive;
+
+	if (strcmp(path, u8"/") == 0)
+	{
+		*outFile = NULL;
+		return MF_ERROR_OKAY;
+	}
+
+	// Find the first file with the same hash
+	mfmU64 hash = mffHashPackedPath(path);
+	mfmU64 low = 0;
+	mfmU64 high = packedArchive->fileCount;
+	while (low < high)
+	{
+		mfmU64 middle = low + (high - low) / 2;
+		if (packedArchive->files[middle].hash < hash)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	for (mfmU64 i = low; i < packedArchive->fileCount && packedArchive->files[i].hash == hash; ++i)
+		if (strcmp(packedArchive->files[i].path, path) == 0)
+		{
+			*outFile = &packedArchive->files[i];
+			return MF_ERROR_OKAY;
+		}
+
+	return MFF_ERROR_FILE_NOT_FOUND;
+}
+
+static mfError mffArchiveGetFileType(mffArchive* archive, mffFile* file, mffEnum* outType)
+{
+	mffPackedFile* packedFile = file;
+	*outType = packedFile->type;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveGetFirstFile(mffArchive* archive, mffFile** outFile, mffDirectory* directory)
+{
+	mffPackedFile* packedFile = directory;
+	if (directory == NULL)
+		*outFile = ((mffPackedArchive*)archive)->firstFile;
+	else
+		*outFile = packedFile->first;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveGetNextFile(mffArchive* archive, mffFile** outFile, mffFile* file)
+{
+	mffPackedFile* packedFile = file;
+	*outFile = packedFile->next;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveGetParent(mffArchive* archive, mffDirectory** outParent, mffFile* file)
+{
+	mffPackedFile* packedFile = file;
+	*outParent = packedFile->parent;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveGetFilePath(mffArchive* archive, const mfsUTF8CodeUnit** outPath, mffFile* file)
+{
+	mffPackedFile* packedFile = file;
+	*outPath = packedFile->path;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveCreateDirectory(mffArchive* archive, mffDirectory** outDir, const mfsUTF8CodeUnit* path)
+{
+	return MFF_ERROR_NOT_SUPPORTED;
+}
+
+static mfError mffArchiveDeleteDirectory(mffArchive* archive, mffDirectory* dir)
+{
+	return MFF_ERROR_NOT_SUPPORTED;
+}
+
+static mfError mffArchiveCreateFile(mffArchive* archive, mffFile** outFile, const mfsUTF8CodeUnit* path)
+{
+	return MFF_ERROR_NOT_SUPPORTED;
+}
+
+static mfError mffArchiveDeleteFile(mffArchive* archive, mffFile* file)
+{
+	return MFF_ERROR_NOT_SUPPORTED;
+}
+
+static void mffArchiveCloseFile(void* stream)
+{
+	mffPackedFileStream* packedStream = stream;
+	mffPackedArchive* archive = packedStream->archive;
+	mfError err;
+
+	mffDestroyLocalMappedFileStream(&packedStream->base);
+
+	err = mfmReleaseObject(&packedStream->file->base.object);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	if (packedStream->inflated != NULL)
+	{
+		err = mfmDeallocate(archive->allocator, packedStream->inflated);
+		if (err != MF_ERROR_OKAY)
+			abort();
+	}
+
+	err = mfmDeallocate(archive->allocator, packedStream);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+static mfError mffArchiveOpenFile(mffArchive* archive, mfsStream** outStream, mffFile* file, mffEnum mode)
+{
+	mfError err;
+
+	mffPackedArchive* packedArchive = archive;
+	mffPackedFile* packedFile = file;
+	mffPackedFileStream* stream;
+
+	if (mode != MFF_FILE_READ && mode != MFF_FILE_READ_MAPPED)
+		return MFF_ERROR_INVALID_MODE;
+	if (packedFile->type != MFF_FILE)
+		return MFF_ERROR_NOT_A_FILE;
+
+	err = mfmAllocate(packedArchive->allocator, &stream, sizeof(mffPackedFileStream));
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	// Compressed files are inflated to a buffer owned by the stream, other files are read straight from the archive mapping
+	stream->inflated = NULL;
+	const mfmU8* data = packedFile->data;
+	if (packedFile->deflated)
+	{
+		err = mfmAllocate(packedArchive->allocator, &stream->inflated, packedFile->size);
+		if (err != MF_ERROR_OKAY)
+		{
+			mfmDeallocate(packedArchive->allocator, stream);
+			return err;
+		}
+
+		mfmU64 inflatedSize;
+		err = mfmInflate(packedFile->data, packedFile->dataSize, stream->inflated, packedFile->size, &inflatedSize, packedArchive->allocator);
+		if (err != MF_ERROR_OKAY || inflatedSize != packedFile->size)
+		{
+			mfmDeallocate(packedArchive->allocator, stream->inflated);
+			mfmDeallocate(packedArchive->allocator, stream);
+			return MFF_ERROR_INVALID_ARCHIVE;
+		}
+
+		data = stream->inflated;
+	}
+
+	err = mffCreateLocalMappedMemoryStream(&stream->base, data, packedFile->size);
+	if (err != MF_ERROR_OKAY)
+	{
+		if (stream->inflated != NULL)
+			mfmDeallocate(packedArchive->allocator, stream->inflated);
+		mfmDeallocate(packedArchive->allocator, stream);
+		return err;
+	}
+	stream->base.base.object.destructorFunc = &mffArchiveCloseFile;
+
+	err = mfmAcquireObject(&packedFile->base.object);
+	if (err != MF_ERROR_OKAY)
+	{
+		mffDestroyLocalMappedFileStream(&stream->base);
+		if (stream->inflated != NULL)
+			mfmDeallocate(packedArchive->allocator, stream->inflated);
+		mfmDeallocate(packedArchive->allocator, stream);
+		return err;
+	}
+
+	stream->archive = packedArchive;
+	stream->file = packedFile;
+
+	*outStream = stream;
+
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveGetFileSize(mffArchive* archive, mffFile* file, mfmU64* outSize)
+{
+	mffPackedFile* packedFile = file;
+	if (packedFile->type != MFF_FILE)
+		return MFF_ERROR_NOT_A_FILE;
+	*outSize = packedFile->size;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffArchiveReadFile(mffArchive* archive, mffFile* file, mfmU64 offset, mfmU8* buffer, mfmU64 size, mfmU64* outReadSize)
+{
+	mffPackedArchive* packedArchive = archive;
+	mffPackedFile* packedFile = file;
+	if (packedFile->type != MFF_FILE)
+		return MFF_ERROR_NOT_A_FILE;
+
+	if (offset >= packedFile->size)
+	{
+		*outReadSize = 0;
+		return MF_ERROR_OKAY;
+	}
+	if (size > packedFile->size - offset)
+		size = packedFile->size - offset;
+
+	if (!packedFile->deflated)
+	{
+		memcpy(buffer, packedFile->data + offset, size);
+		*outReadSize = size;
+		return MF_ERROR_OKAY;
+	}
+
+	// Whole compressed files are inflated straight into the buffer, otherwise they go through a temporary buffer
+	mfError err;
+	mfmU8* inflated = buffer;
+	if (offset != 0 || size != packedFile->size)
+	{
+		err = mfmAllocate(packedArchive->allocator, &inflated, packedFile->size);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	mfmU64 inflatedSize;
+	err = mfmInflate(packedFile->data, packedFile->dataSize, inflated, packedFile->size, &inflatedSize, packedArchive->allocator);
+	if (err != MF_ERROR_OKAY || inflatedSize != packedFile->size)
+		err = MFF_ERROR_INVALID_ARCHIVE;
+
+	if (inflated != buffer)
+	{
+		if (err == MF_ERROR_OKAY)
+			memcpy(buffer, inflated + offset, size);
+		mfmDeallocate(packedArchive->allocator, inflated);
+	}
+
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	*outReadSize = size;
+	return MF_ERROR_OKAY;
+}
+
+static mffPackedFile* mffGetPackedFile(mffPackedArchive* archive, mfmU32 index)
+{
+	return index == MFF_PACKED_ARCHIVE_NO_ENTRY ? NULL : &archive->files[index];
+}
+
+// Validates the header and the footer, and decodes the table of contents into the archive's files
+static mfError mffLoadPackedArchiveTable(mffPackedArchive* archive)
+{
+	mfError err;
+
+	const mfmU8* data = archive->mapping.data;
+	mfmU64 size = archive->mapping.size;
+
+	if (size < 2 * MFF_PACKED_ARCHIVE_BLOCK_SIZE || size % MFF_PACKED_ARCHIVE_ALIGNMENT != 0)
+		return MFF_ERROR_INVALID_ARCHIVE;
+
+	const mfmU8* header = data;
+	const mfmU8* footer = data + size - MFF_PACKED_ARCHIVE_BLOCK_SIZE;
+	if (memcmp(header, MFF_PACKED_ARCHIVE_MAGIC, 4) != 0 || mffReadPackedU32(header + 4) != MFF_PACKED_ARCHIVE_VERSION ||
+		memcmp(footer, MFF_PACKED_ARCHIVE_MAGIC, 4) != 0 || mffReadPackedU32(footer + 4) != MFF_PACKED_ARCHIVE_VERSION)
+		return MFF_ERROR_INVALID_ARCHIVE;
+
+	mfmU64 entryCount = mffReadPackedU64(footer + 8);
+	mfmU64 entriesOffset = mffReadPackedU64(footer + 16);
+	mfmU64 namesOffset = mffReadPackedU64(footer + 24);
+	mfmU64 namesSize = mffReadPackedU64(footer + 32);
+	mfmU32 rootFirst = mffReadPackedU32(footer + 40);
+
+	mfmU64 tableEnd = size - MFF_PACKED_ARCHIVE_BLOCK_SIZE;
+	if (entryCount >= MFF_PACKED_ARCHIVE_NO_ENTRY || entryCount > tableEnd / MFF_PACKED_ARCHIVE_ENTRY_SIZE ||
+		entriesOffset % MFF_PACKED_ARCHIVE_ALIGNMENT != 0 || entriesOffset < MFF_PACKED_ARCHIVE_BLOCK_SIZE ||
+		entriesOffset > tableEnd - entryCount * MFF_PACKED_ARCHIVE_ENTRY_SIZE ||
+		namesOffset > tableEnd || namesSize > tableEnd - namesOffset ||
+		(rootFirst != MFF_PACKED_ARCHIVE_NO_ENTRY && rootFirst >= entryCount))
+		return MFF_ERROR_INVALID_ARCHIVE;
+
+	archive->fileCount = entryCount;
+	archive->files = NULL;
+	if (entryCount == 0)
+	{
+		archive->firstFile = NULL;
+		return MF_ERROR_OKAY;
+	}
+
+	err = mfmAllocate(archive->allocator, &archive->files, entryCount * sizeof(mffPackedFile));
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	const mfsUTF8CodeUnit* names = (const mfsUTF8CodeUnit*)(data + namesOffset);
+	for (mfmU64 i = 0; i < entryCount; ++i)
+	{
+		const mfmU8* entry = data + entriesOffset + i * MFF_PACKED_ARCHIVE_ENTRY_SIZE;
+		mffPackedFile* file = &archive->files[i];
+
+		file->hash = mffReadPackedU64(entry + 0);
+		mfmU64 dataOffset = mffReadPackedU64(entry + 8);
+		file->dataSize = mffReadPackedU64(entry + 16);
+		file->size = mffReadPackedU64(entry + 24);
+		mfmU32 nameOffset = mffReadPackedU32(entry + 32);
+		mfmU32 nameSize = mffReadPackedU32(entry + 36);
+		mfmU32 flags = mffReadPackedU32(entry + 40);
+		mfmU32 parent = mffReadPackedU32(entry + 44);
+		mfmU32 first = mffReadPackedU32(entry + 48);
+		mfmU32 next = mffReadPackedU32(entry + 52);
+
+		// Names must be null terminated and entries must be sorted, since lookups do a binary search over the hashes
+		if (nameOffset >= namesSize || nameSize >= namesSize - nameOffset || names[nameOffset + nameSize] != '\0' ||
+			dataOffset > tableEnd || file->dataSize > tableEnd - dataOffset ||
+			(flags & ~(MFF_PACKED_ENTRY_DIRECTORY | MFF_PACKED_ENTRY_DEFLATE)) != 0 ||
+			((flags & MFF_PACKED_ENTRY_DEFLATE) != 0 && ((flags & MFF_PACKED_ENTRY_DIRECTORY) != 0 || file->size == 0 ||
+				file->size / MFF_PACKED_ARCHIVE_MAX_DEFLATE_RATIO > file->dataSize)) ||
+			((flags & MFF_PACKED_ENTRY_DEFLATE) == 0 && file->dataSize != file->size) ||
+			(parent != MFF_PACKED_ARCHIVE_NO_ENTRY && parent >= entryCount) ||
+			(first != MFF_PACKED_ARCHIVE_NO_ENTRY && first >= entryCount) ||
+			(next != MFF_PACKED_ARCHIVE_NO_ENTRY && next >= entryCount) ||
+			(i > 0 && file->hash < archive->files[i - 1].hash))
+		{
+			mfmDeallocate(archive->allocator, archive->files);
+			return MFF_ERROR_INVALID_ARCHIVE;
+		}
+
+		file->base.archive = archive;
+		file->path = names + nameOffset;
+		file->data = data + dataOffset;
+		file->type = (flags & MFF_PACKED_ENTRY_DIRECTORY) != 0 ? MFF_DIRECTORY : MFF_FILE;
+		file->deflated = (flags & MFF_PACKED_ENTRY_DEFLATE) != 0 ? MFM_TRUE : MFM_FALSE;
+		file->parent = mffGetPackedFile(archive, parent);
+		file->first = mffGetPackedFile(archive, first);
+		file->next = mffGetPackedFile(archive, next);
+	}
+
+	// The entries must form a single tree, so it is walked once from the root checking each entry's parent.
+	// Walking a cycle would visit more entries than there are, and entries which aren't reached would have a broken parent chain
+	archive->firstFile = mffGetPackedFile(archive, rootFirst);
+	mffPackedFile* file = archive->firstFile;
+	mffPackedFile* parent = NULL;
+	mfmU64 visitedCount = 0;
+	while (file != NULL)
+	{
+		if (++visitedCount > entryCount || file->parent != parent || (file->first != NULL && file->type != MFF_DIRECTORY))
+		{
+			mfmDeallocate(archive->allocator, archive->files);
+			return MFF_ERROR_INVALID_ARCHIVE;
+		}
+
+		if (file->first != NULL)
+		{
+			parent = file;
+			file = file->first;
+			continue;
+		}
+
+		while (file->next == NULL && parent != NULL)
+		{
+			file = parent;
+			parent = file->parent;
+		}
+		file = file->next;
+	}
+	if (visitedCount != entryCount)
+	{
+		mfmDeallocate(archive->allocator, archive->files);
+		return MFF_ERROR_INVALID_ARCHIVE;
+	}
+
+	// The archive keeps a reference to each file until it is destroyed
+	for (mfmU64 i = 0; i < entryCount; ++i)
+	{
+		err = mfmInitObject(&archive->files[i].base.object);
+		if (err == MF_ERROR_OKAY)
+		{
+			archive->files[i].base.object.destructorFunc = &mffDestroyPackedFile;
+			err = mfmAcquireObject(&archive->files[i].base.object);
+		}
+		if (err != MF_ERROR_OKAY)
+		{
+			mfmDeallocate(archive->allocator, archive->files);
+			return err;
+		}
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+mfError mffCreatePackedArchive(mffArchive ** outArchive, void * allocator, const mfsUTF8CodeUnit * path)
+{
+	if (outArchive == NULL || path == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mfError err;
+	mffPackedArchive* packedArchive;
+
+	err = mfmAllocate(allocator, &packedArchive, sizeof(mffPackedArchive));
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mffCreateLocalMappedFileStream(&packedArchive->mapping, path);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeallocate(allocator, packedArchive);
+		return err;
+	}
+
+	packedArchive->allocator = allocator;
+	err = mffLoadPackedArchiveTable(packedArchive);
+	if (err != MF_ERROR_OKAY)
+	{
+		mffDestroyLocalMappedFileStream(&packedArchive->mapping);
+		mfmDeallocate(allocator, packedArchive);
+		return err;
+	}
+
+	err = mfmInitObject(&packedArchive->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	packedArchive->base.object.destructorFunc = &mffDestroyPackedArchive;
+
+	const mfsUTF8CodeUnit* name = mffGetPathName(path);
+	if (name == NULL)
+		name = path;
+	if (strlen(name) >= MFF_MAX_ARCHIVE_NAME_SIZE)
+		name = u8"packed";
+	strcpy(packedArchive->base.name, name);
+
+	packedArchive->base.getFile = &mffArchiveGetFile;
+	packedArchive->base.getFileType = &mffArchiveGetFileType;
+	packedArchive->base.getFirstFile = &mffArchiveGetFirstFile;
+	packedArchive->base.getNextFile = &mffArchiveGetNextFile;
+	packedArchive->base.getParent = &mffArchiveGetParent;
+	packedArchive->base.getFilePath = &mffArchiveGetFilePath;
+	packedArchive->base.createDirectory = &mffArchiveCreateDirectory;
+	packedArchive->base.deleteDirectory = &mffArchiveDeleteDirectory;
+	packedArchive->base.createFile = &mffArchiveCreateFile;
+	packedArchive->base.deleteFile = &mffArchiveDeleteFile;
+	packedArchive->base.openFile = &mffArchiveOpenFile;
+	packedArchive->base.getFileSize = &mffArchiveGetFileSize;
+	packedArchive->base.readFile = &mffArchiveReadFile;
+	packedArchive->base.openFileRegion = NULL; // Files are read from the mapping, which is faster than going through the kernel again
+
+	*outArchive = packedArchive;
+	return MF_ERROR_OKAY;
+}
+
+void mffDestroyPackedArchive(void * archive)
+{
+	if (archive == NULL)
+		abort();
+
+	mfError err;
+	mffPackedArchive* packedArchive = archive;
+
+	// Release the archive's references to its files (files must be closed before the archive is destroyed)
+	for (mfmU64 i = 0; i < packedArchive->fileCount; ++i)
+	{
+		err = mfmReleaseObject(&packedArchive->files[i].base.object);
+		if (err != MF_ERROR_OKAY)
+			abort();
+	}
+
+	if (packedArchive->files != NULL)
+	{
+		err = mfmDeallocate(packedArchive->allocator, packedArchive->files);
+		if (err != MF_ERROR_OKAY)
+			abort();
+	}
+
+	mffDestroyLocalMappedFileStream(&packedArchive->mapping);
+
+	err = mfmDeinitObject(&packedArchive->base.object);
+	if (err != MF_ERROR_OKAY)
+		abort();
+
+	err = mfmDeallocate(packedArchive->allocator, packedArchive);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+typedef struct
+{
+	mffFile* file;
+	const mfsUTF8CodeUnit* path;
+	mfmU64 hash;
+	mfmU64 dataOffset;
+	mfmU64 dataSize;
+	mfmU64 size;
+	mfmU32 flags;
+	mfmU32 parent;
+	mfmU32 first;
+	mfmU32 next;
+	mfmU32 sortedIndex;
+} mffPackedWriterEntry;
+
+typedef struct
+{
+	mfsStream* stream;
+	mffArchive* source;
+	mffEnum flags;
+	void* allocator;
+	mffPackedWriterEntry* entries;
+	mfmU64 entryCount;
+	mfmU64 entryCapacity;
+	mfmU32 rootFirst;
+	mfmU64 offset;
+	mfmU8* buffer;
+	mfmU64 bufferSize;
+} mffPackedWriter;
+
+static mfError mffWritePackedData(mffPackedWriter* writer, const void* data, mfmU64 size)
+{
+	if (size == 0)
+		return MF_ERROR_OKAY;
+
+	mfmU64 writtenSize;
+	mfError err = mfsWrite(writer->stream, data, size, &writtenSize);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (writtenSize != size)
+		return MFF_ERROR_INTERNAL;
+	writer->offset += size;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mffWritePackedPadding(mffPackedWriter* writer)
+{
+	static const mfmU8 zeros[MFF_PACKED_ARCHIVE_ALIGNMENT] = { 0 };
+	mfmU64 remainder = writer->offset % MFF_PACKED_ARCHIVE_ALIGNMENT;
+	if (remainder == 0)
+		return MF_ERROR_OKAY;
+	return mffWritePackedData(writer, zeros, MFF_PACKED_ARCHIVE_ALIGNMENT - remainder);
+}
+
+// Adds the files in a directory (or in the root if directory is NULL) to the writer entries, depth first
+static mfError mffCollectPackedEntries(mffPackedWriter* writer, mffDirectory* directory, mfmU32 parent)
+{
+	mfError err;
+	mffArchive* source = writer->source;
+
+	mffFile* file;
+	err = source->getFirstFile(source, &file, directory);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	mfmU32 previous = MFF_PACKED_ARCHIVE_NO_ENTRY;
+	while (file != NULL)
+	{
+		// Grow entry array
+		if (writer->entryCount == writer->entryCapacity)
+		{
+			if (writer->entryCapacity >= MFF_PACKED_ARCHIVE_NO_ENTRY / 2)
+				return MFF_ERROR_NOT_SUPPORTED;
+
+			mfmU64 newCapacity = writer->entryCapacity == 0 ? 64 : writer->entryCapacity * 2;
+			mffPackedWriterEntry* newEntries;
+			err = mfmAllocate(writer->allocator, &newEntries, newCapacity * sizeof(mffPackedWriterEntry));
+			if (err != MF_ERROR_OKAY)
+				return err;
+			if (writer->entries != NULL)
+			{
+				memcpy(newEntries, writer->entries, writer->entryCount * sizeof(mffPackedWriterEntry));
+				err = mfmDeallocate(writer->allocator, writer->entries);
+				if (err != MF_ERROR_OKAY)
+					return err;
+			}
+			writer->entries = newEntries;
+			writer->entryCapacity = newCapacity;
+		}
+
+		// The entry array may be reallocated when recursing, so entries are always accessed by index
+		mfmU32 index = (mfmU32)writer->entryCount++;
+		mffPackedWriterEntry* entry = &writer->entries[index];
+		entry->file = file;
+		entry->parent = parent;
+		entry->first = MFF_PACKED_ARCHIVE_NO_ENTRY;
+		entry->next = MFF_PACKED_ARCHIVE_NO_ENTRY;
+		entry->dataOffset = 0;
+		entry->dataSize = 0;
+		entry->size = 0;
+
+		err = source->getFilePath(source, &entry->path, file);
+		if (err != MF_ERROR_OKAY)
+			return err;
+		entry->hash = mffHashPackedPath(entry->path);
+
+		mffEnum type;
+		err = source->getFileType(source, file, &type);
+		if (err != MF_ERROR_OKAY)
+			return err;
+		entry->flags = type == MFF_DIRECTORY ? MFF_PACKED_ENTRY_DIRECTORY : 0;
+
+		if (previous != MFF_PACKED_ARCHIVE_NO_ENTRY)
+			writer->entries[previous].next = index;
+		else if (parent != MFF_PACKED_ARCHIVE_NO_ENTRY)
+			writer->entries[parent].first = index;
+		else
+			writer->rootFirst = index;
+		previous = index;
+
+		if (type == MFF_DIRECTORY)
+		{
+			err = mffCollectPackedEntries(writer, file, index);
+			if (err != MF_ERROR_OKAY)
+				return err;
+		}
+
+		err = source->getNextFile(source, &file, file);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+// Writes the contents of a file, compressing them if that makes them smaller
+static mfError mffWritePackedFileData(mffPackedWriter* writer, mffPackedWriterEntry* entry)
+{
+	mfError err;
+	mffArchive* source = writer->source;
+
+	mfsStream* stream;
+	err = source->openFile(source, &stream, entry->file, MFF_FILE_READ_MAPPED);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	const mfmU8* data = NULL;
+	mfmU64 size = 0;
+	err = mfsGetSpan(stream, MFM_U64_MAX, &data, &size);
+	if (err == MFS_ERROR_EOF)
+	{
+		data = NULL;
+		size = 0;
+	}
+	else if (err != MF_ERROR_OKAY)
+	{
+		mffCloseFile(stream);
+		return err;
+	}
+
+	entry->dataOffset = writer->offset;
+	entry->size = size;
+	entry->dataSize = size;
+
+	if ((writer->flags & (MFF_PACKED_ARCHIVE_DEFLATE | MFF_PACKED_ARCHIVE_LZ)) != 0 && size > 0)
+	{
+		// The compression buffer is reused between files and only grows
+		if (writer->bufferSize < size)
+		{
+			if (writer->buffer != NULL)
+			{
+				err = mfmDeallocate(writer->allocator, writer->buffer);
+				writer->buffer = NULL;
+				writer->bufferSize = 0;
+				if (err != MF_ERROR_OKAY)
+				{
+					mffCloseFile(stream);
+					return err;
+				}
+			}
+
+			err = mfmAllocate(writer->allocator, &writer->buffer, size);
+			if (err != MF_ERROR_OKAY)
+			{
+				mffCloseFile(stream);
+				return err;
+			}
+			writer->bufferSize = size;
+		}
+
+		// Files whose compressed data doesn't fit in a buffer smaller than the original are stored uncompressed
+		mfmU64 compressedSize;
+		mfmEnum compression = (writer->flags & MFF_PACKED_ARCHIVE_LZ) != 0 ? MFM_LZ_COMPRESSION : MFM_BEST_COMPRESSION;
+		err = mfmDeflate(data, size, writer->buffer, size - 1, &compressedSize, compression, writer->allocator);
+		if (err == MF_ERROR_OKAY)
+		{
+			data = writer->buffer;
+			entry->dataSize = compressedSize;
+			entry->flags |= MFF_PACKED_ENTRY_DEFLATE;
+		}
+		else if (err != MFM_ERROR_BUFFER_FULL)
+		{
+			mffCloseFile(stream);
+			return err;
+		}
+	}
+
+	err = mffWritePackedData(writer, data, entry->dataSize);
+	mffCloseFile(stream);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	return mffWritePackedPadding(writer);
+}
+
+static int mffComparePackedEntries(const void* a, const void* b)
+{
+	const mffPackedWriterEntry* entryA = *(const mffPackedWriterEntry* const*)a;
+	const mffPackedWriterEntry* entryB = *(const mffPackedWriterEntry* const*)b;
+	if (entryA->hash != entryB->hash)
+		return entryA->hash < entryB->hash ? -1 : 1;
+	return strcmp(entryA->path, entryB->path);
+}
+
+static mfmU32 mffGetSortedIndex(mffPackedWriter* writer, mfmU32 index)
+{
+	return index == MFF_PACKED_ARCHIVE_NO_ENTRY ? MFF_PACKED_ARCHIVE_NO_ENTRY : writer->entries[index].sortedIndex;
+}
+
+static mfError mffWritePackedArchiveUnsafe(mffPackedWriter* writer, mffPackedWriterEntry*** sorted)
+{
+	mfError err;
+
+	err = mffCollectPackedEntries(writer, NULL, MFF_PACKED_ARCHIVE_NO_ENTRY);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	// Header
+	mfmU8 block[MFF_PACKED_ARCHIVE_BLOCK_SIZE];
+	memset(block, 0, sizeof(block));
+	memcpy(block, MFF_PACKED_ARCHIVE_MAGIC, 4);
+	mffWritePackedU32(block + 4, MFF_PACKED_ARCHIVE_VERSION);
+	err = mffWritePackedData(writer, block, sizeof(block));
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	// File data
+	for (mfmU64 i = 0; i < writer->entryCount; ++i)
+		if ((writer->entries[i].flags & MFF_PACKED_ENTRY_DIRECTORY) == 0)
+		{
+			err = mffWritePackedFileData(writer, &writer->entries[i]);
+			if (err != MF_ERROR_OKAY)
+				return err;
+		}
+
+	// Sort entries by hash
+	if (writer->entryCount > 0)
+	{
+		err = mfmAllocate(writer->allocator, sorted, writer->entryCount * sizeof(mffPackedWriterEntry*));
+		if (err != MF_ERROR_OKAY)
+			return err;
+		for (mfmU64 i = 0; i < writer->entryCount; ++i)
+			(*sorted)[i] = &writer->entries[i];
+		qsort(*sorted, writer->entryCount, sizeof(mffPackedWriterEntry*), &mffComparePackedEntries);
+		for (mfmU64 i = 0; i < writer->entryCount; ++i)
+			(*sorted)[i]->sortedIndex = (mfmU32)i;
+	}
+
+	// Entries
+	mfmU64 entriesOffset = writer->offset;
+	mfmU64 namesSize = 0;
+	for (mfmU64 i = 0; i < writer->entryCount; ++i)
+	{
+		mffPackedWriterEntry* entry = (*sorted)[i];
+		mfmU64 nameSize = strlen(entry->path);
+		if (namesSize + nameSize + 1 >= MFF_PACKED_ARCHIVE_NO_ENTRY)
+			return MFF_ERROR_NOT_SUPPORTED;
+
+		memset(block, 0, sizeof(block));
+		mffWritePackedU64(block + 0, entry->hash);
+		mffWritePackedU64(block + 8, entry->dataOffset);
+		mffWritePackedU64(block + 16, entry->dataSize);
+		mffWritePackedU64(block + 24, entry->size);
+		mffWritePackedU32(block + 32, (mfmU32)namesSize);
+		mffWritePackedU32(block + 36, (mfmU32)nameSize);
+		mffWritePackedU32(block + 40, entry->flags);
+		mffWritePackedU32(block + 44, mffGetSortedIndex(writer, entry->parent));
+		mffWritePackedU32(block + 48, mffGetSortedIndex(writer, entry->first));
+		mffWritePackedU32(block + 52, mffGetSortedIndex(writer, entry->next));
+		err = mffWritePackedData(writer, block, sizeof(block));
+		if (err != MF_ERROR_OKAY)
+			return err;
+
+		namesSize += nameSize + 1;
+	}
+
+	// Names
+	mfmU64 namesOffset = writer->offset;
+	for (mfmU64 i = 0; i < writer->entryCount; ++i)
+	{
+		err = mffWritePackedData(writer, (*sorted)[i]->path, strlen((*sorted)[i]->path) + 1);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+	err = mffWritePackedPadding(writer);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	// Footer
+	memset(block, 0, sizeof(block));
+	memcpy(block, MFF_PACKED_ARCHIVE_MAGIC, 4);
+	mffWritePackedU32(block + 4, MFF_PACKED_ARCHIVE_VERSION);
+	mffWritePackedU64(block + 8, writer->entryCount);
+	mffWritePackedU64(block + 16, entriesOffset);
+	mffWritePackedU64(block + 24, namesOffset);
+	mffWritePackedU64(block + 32, namesSize);
+	mffWritePackedU32(block + 40, mffGetSortedIndex(writer, writer->rootFirst));
+	err = mffWritePackedData(writer, block, sizeof(block));
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	return mfsFlush(writer->stream);
+}
+
+mfError mffWritePackedArchive(mfsStream * stream, mffArchive * source, mffEnum flags, void * allocator)
+{
+	if (stream == NULL || source == NULL)
+		return MFF_ERROR_INVALID_ARGUMENTS;
+
+	mffPackedWriter writer;
+	writer.stream = stream;
+	writer.source = source;
+	writer.flags = flags;
+	writer.allocator = allocator;
+	writer.entries = NULL;
+	writer.entryCount = 0;
+	writer.entryCapacity = 0;
+	writer.rootFirst = MFF_PACKED_ARCHIVE_NO_ENTRY;
+	writer.offset = 0;
+	writer.buffer = NULL;
+	writer.bufferSize = 0;
+
+	mffPackedWriterEntry** sorted = NULL;
+	mfError err = mffWritePackedArchiveUnsafe(&writer, &sorted);
+
+	if (sorted != NULL)
+		mfmDeallocate(allocator, sorted);
+	if (writer.buffer != NULL)
+		mfmDeallocate(allocator, writer.buffer);
+	if (writer.entries != NULL)
+		mfmDeallocate(allocator, writer.entries);
+
+	return err;
+}
@@ -0,0 +1,14 @@
+#include "PackedArchive.hpp"
+#include "PackedArchive.h"
+#include "Exception.hpp"
+#include "../ErrorString.h"
+
+Magma::Framework::File::HArchive Magma::Framework::File::CreatePackedArchive(const mfsUTF8CodeUnit* path, Memory::HAllocator allocator)
+{
+	mffArchive* archive = NULL;
+	mfError err;
+	err = mffCreatePackedArchive(&archive, allocator.GetNoChecks(), path);
+	if (err != MF_ERROR_OKAY)
+		throw ArchiveError(mfErrorToString(err));
+	return archive;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "FileSystem.h"
+
+/*
+	Packed archives are read only archives stored in a single file, built by mffWritePackedArchive (e.g.: with the Magma-Packer tool).
+	The whole file is mapped when the archive is created and its table of contents is decoded in a single pass, so lookups never
+	touch the disk and file streams are slices of the mapping.
+
+	File layout (integers are little endian and every block starts at a multiple of MFF_PACKED_ARCHIVE_ALIGNMENT):
+		Header (64 bytes): magic "MFPK", U32 version.
+		File data, one block per file, which may be compressed with zlib.
+		Entries (64 bytes each), sorted by path hash and then by path:
+			U64 hash, U64 data offset, U64 data size, U64 uncompressed size,
+			U32 name offset, U32 name size, U32 flags, U32 parent, U32 first child, U32 next sibling, U32[2] reserved.
+			Parent, first child and next sibling are entry indices, or MFF_PACKED_ARCHIVE_NO_ENTRY if there is none.
+			The entries must form a single tree starting at the first root entry, and only directories may have children.
+		Names: null terminated path of every entry inside the archive (e.g.: "/dir/file.txt").
+		Footer (64 bytes): magic "MFPK", U32 version, U64 entry count, U64 entries offset, U64 names offset, U64 names size, U32 first root entry.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MFF_PACKED_ARCHIVE_VERSION		1
+#define MFF_PACKED_ARCHIVE_ALIGNMENT	64
+#define MFF_PACKED_ARCHIVE_NO_ENTRY		0xFFFFFFFF
+
+#define MFF_PACKED_ARCHIVE_DEFLATE		0x01
+#define MFF_PACKED_ARCHIVE_LZ			0x02
+
+	/// <summary>
+	///		Maps a packed archive file and creates an archive from it.
+	///		Packed archives are read only, so files and directories can't be created nor deleted, and files can't be opened with MFF_FILE_WRITE.
+	/// </summary>
+	/// <param name="outArchive">Out archive handle</param>
+	/// <param name="allocator">Allocator used for internal allocations</param>
+	/// <param name="path">Real path of the packed archive file on the operating system's file system</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFF_ERROR_FILE_NOT_FOUND if the file doesn't exist.
+	///		Returns MFF_ERROR_INVALID_ARCHIVE if the file isn't a valid packed archive.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mffCreatePackedArchive(mffArchive** outArchive, void* allocator, const mfsUTF8CodeUnit* path);
+
+	void mffDestroyPackedArchive(void* archive);
+
+	/// <summary>
+	///		Writes every file and directory of an archive into a stream as a packed archive.
+	///		The stream is written sequentially, without seeking, and the source archive must support MFF_FILE_READ_MAPPED.
+	/// </summary>
+	/// <param name="stream">Stream where the packed archive will be written</param>
+	/// <param name="source">Archive which will be packed</param>
+	/// <param name="flags">
+	///		MFF_PACKED_ARCHIVE_DEFLATE to compress files with DEFLATE, MFF_PACKED_ARCHIVE_LZ to compress them with the much faster to
+	///		decompress MFM_LZ_COMPRESSION (files which don't get smaller are stored uncompressed), or 0
+	/// </param>
+	/// <param name="allocator">Allocator used for temporary allocations</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFF_ERROR_INVALID_ARGUMENTS if <paramref name="stream">stream</paramref> or <paramref name="source">source</paramref> are NULL.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mffWritePackedArchive(mfsStream* stream, mffArchive* source, mffEnum flags, void* allocator);
+
+#ifdef __cplusplus
+}
+#endif
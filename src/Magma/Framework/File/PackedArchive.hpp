@@ -0,0 +1,22 @@
+#pragma once
+
+#include "FileSystem.hpp"
+#include "../Memory/Allocator.hpp"
+#include "../String/UTF8.hpp"
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace File
+		{
+			/// <summary>
+			///		Creates a read only archive from a packed archive file.
+			/// </summary>
+			/// <param name="path">Packed archive file path</param>
+			/// <param name="allocator">AllocatorHandle used for internal allocations</param>
+			/// <returns>Packed archive handle</returns>
+			HArchive CreatePackedArchive(const mfsUTF8CodeUnit* path, Memory::HAllocator allocator = Memory::StandardAllocator);
+		}
+	}
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "../../Memory/StackAllocator.h"
 #include "../../Memory/PoolAllocator.h"
 #include "../../String/StringStream.h"
+#include "../../String/StringBuilder.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -308,27 +309,27 @@ mfError mfgD3D11CreateVertexShader(mfgV2XRenderDevice* rd, mfgV2XVertexShader**
 	d3dVS->base.object.destructorFunc = &mfgD3D11DestroyVertexShader;
 	d3dVS->base.renderDevice = rd;
 
-	// Create string stream
-	mfsStream* ss;
-	char buffer[4096];
-	if (mfsCreateStringStream(&ss, buffer, sizeof(buffer), d3dRD->stack) != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string stream for mfgD3D11Assemble");
-	mfError err = mfgV2XD3D11Assemble(bytecode, bytecodeSize, metaData, ss);
+	// Assemble shader source
+	mfsStream* source;
+	if (mfsCreateStringBuilder(&source, d3dRD->stack) != MF_ERROR_OKAY)
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string builder for mfgD3D11Assemble");
+	mfError err = mfgV2XD3D11Assemble(bytecode, bytecodeSize, metaData, source);
 	if (err != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgD3D11Assemble failed");
-	if (mfsPutByte(ss, '\0') != MF_ERROR_OKAY)
 	{
-		mfsDestroyStringStream(ss);
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfsPutByte returned error");
+		mfsDestroyStringBuilder(source);
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgD3D11Assemble failed");
 	}
 
-	mfsDestroyStringStream(ss);
+	const char* buffer = NULL;
+	mfmU64 bufferSize = 0;
+	mfsGetStringBuilderData(source, &buffer, &bufferSize);
 	mfsPutString(mfsOutStream, buffer);
 
 	// Compile shader
 	{
 		ID3DBlob* errorMessages;
-		HRESULT hr = D3DCompile(buffer, sizeof(buffer), NULL, NULL, NULL, "VS", "vs_4_0", D3D10_SHADER_PACK_MATRIX_COLUMN_MAJOR, 0, &d3dVS->blob, &errorMessages);
+		HRESULT hr = D3DCompile(buffer, (SIZE_T)bufferSize, NULL, NULL, NULL, "VS", "vs_4_0", D3D10_SHADER_PACK_MATRIX_COLUMN_MAJOR, 0, &d3dVS->blob, &errorMessages);
+		mfsDestroyStringBuilder(source);
 		if (FAILED(hr))
 		{
 			mfsPutString(mfsErrStream, errorMessages->lpVtbl->GetBufferPointer(errorMessages));
@@ -460,27 +461,27 @@ mfError mfgD3D11CreatePixelShader(mfgV2XRenderDevice* rd, mfgV2XPixelShader** ps
 	d3dPS->base.object.destructorFunc = &mfgD3D11DestroyPixelShader;
 	d3dPS->base.renderDevice = rd;
 
-	// Create string stream
-	mfsStream* ss;
-	char buffer[4096];
-	if (mfsCreateStringStream(&ss, buffer, sizeof(buffer), d3dRD->stack) != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string stream for mfgD3D11Assemble");
-	mfError err = mfgV2XD3D11Assemble(bytecode, bytecodeSize, metaData, ss);
+	// Assemble shader source
+	mfsStream* source;
+	if (mfsCreateStringBuilder(&source, d3dRD->stack) != MF_ERROR_OKAY)
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string builder for mfgD3D11Assemble");
+	mfError err = mfgV2XD3D11Assemble(bytecode, bytecodeSize, metaData, source);
 	if (err != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgD3D11Assemble failed");
-	if (mfsPutByte(ss, '\0') != MF_ERROR_OKAY)
 	{
-		mfsDestroyStringStream(ss);
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfsPutByte returned error");
+		mfsDestroyStringBuilder(source);
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgD3D11Assemble failed");
 	}
 
-	mfsDestroyStringStream(ss);
+	const char* buffer = NULL;
+	mfmU64 bufferSize = 0;
+	mfsGetStringBuilderData(source, &buffer, &bufferSize);
 	mfsPutString(mfsOutStream, buffer);
 
 	// Compile shader
 	{
 		ID3DBlob* errorMessages;
-		HRESULT hr = D3DCompile(buffer, sizeof(buffer), NULL, NULL, NULL, "PS", "ps_4_0", D3D10_SHADER_PACK_MATRIX_COLUMN_MAJOR, 0, &d3dPS->blob, &errorMessages);
+		HRESULT hr = D3DCompile(buffer, (SIZE_T)bufferSize, NULL, NULL, NULL, "PS", "ps_4_0", D3D10_SHADER_PACK_MATRIX_COLUMN_MAJOR, 0, &d3dPS->blob, &errorMessages);
+		mfsDestroyStringBuilder(source);
 		if (FAILED(hr))
 		{
 			mfsPutString(mfsErrStream, errorMessages->lpVtbl->GetBufferPointer(errorMessages));
@@ -5,6 +5,7 @@
 #include "../../Memory/StackAllocator.h"
 #include "../../Memory/PoolAllocator.h"
 #include "../../String/StringStream.h"
+#include "../../String/StringBuilder.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -324,21 +325,19 @@ mfError mfgOGL4CreateVertexShader(mfgV2XRenderDevice* rd, mfgV2XVertexShader** v
 	oglVS->base.object.destructorFunc = &mfgOGL4DestroyVertexShader;
 	oglVS->base.renderDevice = rd;
 
-	// Create string stream
-	mfsStream* ss;
-	GLchar buffer[4096];
-	if (mfsCreateStringStream(&ss, buffer, sizeof(buffer), oglRD->stack) != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string stream for mfgOGL4Assemble");
-	mfError err = mfgV2XOGL4Assemble(bytecode, bytecodeSize, metaData, ss);
+	// Assemble shader source
+	mfsStream* source;
+	if (mfsCreateStringBuilder(&source, oglRD->stack) != MF_ERROR_OKAY)
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string builder for mfgOGL4Assemble");
+	mfError err = mfgV2XOGL4Assemble(bytecode, bytecodeSize, metaData, source);
 	if (err != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgOGL4Assemble failed");
-	if (mfsPutByte(ss, '\0') != MF_ERROR_OKAY)
 	{
-		mfsDestroyStringStream(ss);
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfsPutByte returned error");
+		mfsDestroyStringBuilder(source);
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgOGL4Assemble failed");
 	}
 
-	mfsDestroyStringStream(ss);
+	const GLchar* buffer = NULL;
+	mfsGetStringBuilderData(source, &buffer, NULL);
 	mfsPutString(mfsOutStream, buffer);
 
 	// Create shader program
@@ -358,9 +357,11 @@ mfError mfgOGL4CreateVertexShader(mfgV2XRenderDevice* rd, mfgV2XVertexShader** v
 			mfsPrintFormat(mfsOutStream, bufferSrc);
 			mfsPrintFormat(mfsOutStream, u8"\n");
 			mfsFlush(mfsOutStream);
+			mfsDestroyStringBuilder(source);
 			MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, infoLog);
 		}
 	}
+	mfsDestroyStringBuilder(source);
 
 	// Init binding points
 	for (mfmU16 i = 0; i < MFG_OGL4_SHADER_MAX_BP_COUNT; ++i)
@@ -371,6 +372,7 @@ mfError mfgOGL4CreateVertexShader(mfgV2XRenderDevice* rd, mfgV2XVertexShader** v
 		oglVS->bps[i].boundSampler = NULL;
 	}
 
+	mfsStream* ss;
 	{
 		mfgMetaDataBindingPoint* bp = oglVS->md->firstBindingPoint;
 		for (mfmU16 i = 0; i < MFG_OGL4_SHADER_MAX_BP_COUNT && bp != NULL; ++i)
@@ -570,21 +572,19 @@ mfError mfgOGL4CreatePixelShader(mfgV2XRenderDevice* rd, mfgV2XPixelShader** ps,
 	oglPS->base.object.destructorFunc = &mfgOGL4DestroyPixelShader;
 	oglPS->base.renderDevice = rd;
 
-	// Create string stream
-	mfsStream* ss;
-	GLchar buffer[4096];
-	if (mfsCreateStringStream(&ss, buffer, sizeof(buffer), oglRD->stack) != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string stream for mfgOGL4Assemble");
-	mfError err = mfgV2XOGL4Assemble(bytecode, bytecodeSize, metaData, ss);
+	// Assemble shader source
+	mfsStream* source;
+	if (mfsCreateStringBuilder(&source, oglRD->stack) != MF_ERROR_OKAY)
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"Failed to create string builder for mfgOGL4Assemble");
+	mfError err = mfgV2XOGL4Assemble(bytecode, bytecodeSize, metaData, source);
 	if (err != MF_ERROR_OKAY)
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgOGL4Assemble failed");
-	if (mfsPutByte(ss, '\0') != MF_ERROR_OKAY)
 	{
-		mfsDestroyStringStream(ss);
-		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfsPutByte returned error");
+		mfsDestroyStringBuilder(source);
+		MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, u8"mfgOGL4Assemble failed");
 	}
-	mfsDestroyStringStream(ss);
 
+	const GLchar* buffer = NULL;
+	mfsGetStringBuilderData(source, &buffer, NULL);
 	mfsPutString(mfsOutStream, buffer);
 
 	// Create shader program
@@ -604,9 +604,11 @@ mfError mfgOGL4CreatePixelShader(mfgV2XRenderDevice* rd, mfgV2XPixelShader** ps,
 			mfsPrintFormat(mfsOutStream, bufferSrc);
 			mfsPrintFormat(mfsOutStream, u8"\n");
 			mfsFlush(mfsOutStream);
+			mfsDestroyStringBuilder(source);
 			MFG_RETURN_ERROR(MFG_ERROR_INTERNAL, infoLog);
 		}
 	}
+	mfsDestroyStringBuilder(source);
 
 	// Init binding points
 	for (mfmU16 i = 0; i < MFG_OGL4_SHADER_MAX_BP_COUNT; ++i)
@@ -617,6 +619,7 @@ mfError mfgOGL4CreatePixelShader(mfgV2XRenderDevice* rd, mfgV2XPixelShader** ps,
 		oglPS->bps[i].boundSampler = NULL;
 	}
 
+	mfsStream* ss;
 	{
 		mfgMetaDataBindingPoint* bp = oglPS->md->firstBindingPoint;
 		for (mfmU16 i = 0; i < MFG_OGL4_SHADER_MAX_BP_COUNT && bp != NULL; ++i)
@@ -23,6 +23,10 @@
 #define CHECK_ERROR(err) do {} while(false)
 #endif
 
+// Handle arrays are passed to the C API as object pointer arrays
+static_assert(sizeof(Magma::Framework::Graphics::V2X::HVertexBuffer) == sizeof(mfgV2XVertexBuffer*), "HVertexBuffer must have the size of a pointer");
+static_assert(sizeof(Magma::Framework::Graphics::V2X::HRenderTexture) == sizeof(mfgV2XRenderTexture*), "HRenderTexture must have the size of a pointer");
+
 void * Magma::Framework::Graphics::V2X::HVertexShader::GetBindingPoint(const mfsUTF8CodeUnit * name)
 {
 	auto vs = (mfgV2XVertexShader*)&this->Get();
@@ -151,7 +155,7 @@ Magma::Framework::Graphics::V2X::HPixelShader Magma::Framework::Graphics::V2X::H
 	return ps;
 }
 
-Magma::Framework::Graphics::V2X::HPipeline Magma::Framework::Graphics::V2X::HRenderDevice::CreatePipeline(HVertexShader vs, HPixelShader ps)
+Magma::Framework::Graphics::V2X::HPipeline Magma::Framework::Graphics::V2X::HRenderDevice::CreatePipeline(const HVertexShader& vs, const HPixelShader& ps)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfgV2XPipeline* pp = NULL;
@@ -160,56 +164,56 @@ Magma::Framework::Graphics::V2X::HPipeline Magma::Framework::Graphics::V2X::HRen
 	return pp;
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::SetPipeline(HPipeline pipeline)
+void Magma::Framework::Graphics::V2X::HRenderDevice::SetPipeline(const HPipeline& pipeline)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XSetPipeline(rd, (mfgV2XPipeline*)pipeline.GetNoChecks());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::BindConstantBuffer(void * bp, HConstantBuffer cb)
+void Magma::Framework::Graphics::V2X::HRenderDevice::BindConstantBuffer(void * bp, const HConstantBuffer& cb)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XBindConstantBuffer(rd, (mfgV2XBindingPoint*)bp, (mfgV2XConstantBuffer*)&cb.Get());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::BindConstantBufferRange(void * bp, HConstantBuffer cb, mfmU64 offset, mfmU64 size)
+void Magma::Framework::Graphics::V2X::HRenderDevice::BindConstantBufferRange(void * bp, const HConstantBuffer& cb, mfmU64 offset, mfmU64 size)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XBindConstantBufferRange(rd, (mfgV2XBindingPoint*)bp, (mfgV2XConstantBuffer*)&cb.Get(), offset, size);
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::BindTexture1D(void * bp, HTexture1D tex)
+void Magma::Framework::Graphics::V2X::HRenderDevice::BindTexture1D(void * bp, const HTexture1D& tex)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XBindTexture1D(rd, (mfgV2XBindingPoint*)bp, (mfgV2XTexture1D*)&tex.Get());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::BindTexture2D(void * bp, HTexture2D tex)
+void Magma::Framework::Graphics::V2X::HRenderDevice::BindTexture2D(void * bp, const HTexture2D& tex)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XBindTexture2D(rd, (mfgV2XBindingPoint*)bp, (mfgV2XTexture2D*)tex.GetNoChecks());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::BindTexture3D(void * bp, HTexture3D tex)
+void Magma::Framework::Graphics::V2X::HRenderDevice::BindTexture3D(void * bp, const HTexture3D& tex)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XBindTexture3D(rd, (mfgV2XBindingPoint*)bp, (mfgV2XTexture3D*)tex.GetNoChecks());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::BindRenderTexture(void * bp, HRenderTexture tex)
+void Magma::Framework::Graphics::V2X::HRenderDevice::BindRenderTexture(void * bp, const HRenderTexture& tex)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XBindRenderTexture(rd, (mfgV2XBindingPoint*)bp, (mfgV2XRenderTexture*)tex.GetNoChecks());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::BindSampler(void * bp, HSampler sampler)
+void Magma::Framework::Graphics::V2X::HRenderDevice::BindSampler(void * bp, const HSampler& sampler)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XBindSampler(rd, (mfgV2XBindingPoint*)bp, (mfgV2XSampler*)sampler.GetNoChecks());
@@ -234,7 +238,7 @@ Magma::Framework::Graphics::V2X::HVertexBuffer Magma::Framework::Graphics::V2X::
 	return vb;
 }
 
-Magma::Framework::Graphics::V2X::HVertexLayout Magma::Framework::Graphics::V2X::HRenderDevice::CreateVertexLayout(mfmU64 elementCount, const VertexElement * elements, HVertexShader vs)
+Magma::Framework::Graphics::V2X::HVertexLayout Magma::Framework::Graphics::V2X::HRenderDevice::CreateVertexLayout(mfmU64 elementCount, const VertexElement * elements, const HVertexShader& vs)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 
@@ -255,21 +259,16 @@ Magma::Framework::Graphics::V2X::HVertexLayout Magma::Framework::Graphics::V2X::
 	return vl;
 }
 
-Magma::Framework::Graphics::V2X::HVertexArray Magma::Framework::Graphics::V2X::HRenderDevice::CreateVertexArray(mfmU64 bufferCount, HVertexBuffer * buffers, HVertexLayout layout)
+Magma::Framework::Graphics::V2X::HVertexArray Magma::Framework::Graphics::V2X::HRenderDevice::CreateVertexArray(mfmU64 bufferCount, HVertexBuffer * buffers, const HVertexLayout& layout)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
-
-	auto c_buffers = (mfgV2XVertexBuffer**)alloca(sizeof(mfgV2XVertexBuffer*) * (size_t)bufferCount);
-	for (mfmU64 i = 0; i < bufferCount; ++i)
-		c_buffers[i] = (mfgV2XVertexBuffer*)&buffers[i].Get();
-
 	mfgV2XVertexArray* va = NULL;
-	mfError err = mfgV2XCreateVertexArray(rd, &va, bufferCount, c_buffers, (mfgV2XVertexLayout*)&layout.Get());
+	mfError err = mfgV2XCreateVertexArray(rd, &va, bufferCount, HVertexBuffer::GetArray(buffers), (mfgV2XVertexLayout*)&layout.Get());
 	CHECK_ERROR(rd, err);
 	return va;
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::SetVertexArray(HVertexArray va)
+void Magma::Framework::Graphics::V2X::HRenderDevice::SetVertexArray(const HVertexArray& va)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XSetVertexArray(rd, (mfgV2XVertexArray*)va.GetNoChecks());
@@ -285,7 +284,7 @@ Magma::Framework::Graphics::V2X::HIndexBuffer Magma::Framework::Graphics::V2X::H
 	return ib;
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::SetIndexBuffer(HIndexBuffer ib)
+void Magma::Framework::Graphics::V2X::HRenderDevice::SetIndexBuffer(const HIndexBuffer& ib)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XSetIndexBuffer(rd, (mfgV2XIndexBuffer*)ib.GetNoChecks());
@@ -409,21 +408,21 @@ Magma::Framework::Graphics::V2X::HBlendState Magma::Framework::Graphics::V2X::HR
 	return state;
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::SetRasterState(HRasterState state)
+void Magma::Framework::Graphics::V2X::HRenderDevice::SetRasterState(const HRasterState& state)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XSetRasterState(rd, (mfgV2XRasterState*)&state.Get());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::SetDepthStencilState(HDepthStencilState state)
+void Magma::Framework::Graphics::V2X::HRenderDevice::SetDepthStencilState(const HDepthStencilState& state)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XSetDepthStencilState(rd, (mfgV2XDepthStencilState*)&state.Get());
 	CHECK_ERROR(rd, err);
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::SetBlendState(HBlendState state)
+void Magma::Framework::Graphics::V2X::HRenderDevice::SetBlendState(const HBlendState& state)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XSetBlendState(rd, (mfgV2XBlendState*)&state.Get());
@@ -448,21 +447,16 @@ Magma::Framework::Graphics::V2X::HDepthStencilTexture Magma::Framework::Graphics
 	return tex;
 }
 
-Magma::Framework::Graphics::V2X::HFramebuffer Magma::Framework::Graphics::V2X::HRenderDevice::CreateFramebuffer(mfmU64 textureCount, HRenderTexture * textures, HDepthStencilTexture depthStencilTexture)
+Magma::Framework::Graphics::V2X::HFramebuffer Magma::Framework::Graphics::V2X::HRenderDevice::CreateFramebuffer(mfmU64 textureCount, HRenderTexture * textures, const HDepthStencilTexture& depthStencilTexture)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
-
-	auto c_textures = (mfgV2XRenderTexture**)alloca(sizeof(mfgV2XRenderTexture*) * (size_t)textureCount);
-	for (mfmU64 i = 0; i < textureCount; ++i)
-		c_textures[i] = (mfgV2XRenderTexture*)&textures[i].Get();
-
 	mfgV2XFramebuffer* fb = NULL;
-	mfError err = mfgV2XCreateFramebuffer(rd, &fb, textureCount, c_textures, (mfgV2XDepthStencilTexture*)&depthStencilTexture.Get());
+	mfError err = mfgV2XCreateFramebuffer(rd, &fb, textureCount, HRenderTexture::GetArray(textures), depthStencilTexture.GetNoChecks());
 	CHECK_ERROR(rd, err);
 	return fb;
 }
 
-void Magma::Framework::Graphics::V2X::HRenderDevice::SetFramebuffer(HFramebuffer framebuffer)
+void Magma::Framework::Graphics::V2X::HRenderDevice::SetFramebuffer(const HFramebuffer& framebuffer)
 {
 	auto rd = (mfgV2XRenderDevice*)&this->Get();
 	mfError err = mfgV2XSetFramebuffer(rd, (mfgV2XFramebuffer*)&framebuffer.Get());
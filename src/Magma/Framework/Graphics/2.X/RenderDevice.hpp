@@ -625,12 +625,12 @@ namespace Magma
 				///		Used as a vertex shader handle.
 				///		Destroys the vertex shader automatically when there are no more references to it.
 				/// </summary>
-				class HVertexShader : public Memory::Handle
+				class HVertexShader : public Memory::TypedHandle<mfgV2XVertexShader>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HVertexShader(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HVertexShader(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Gets a binding point from this shader.
@@ -644,12 +644,12 @@ namespace Magma
 				///		Used as a pixel shader handle.
 				///		Destroys the pixel shader automatically when there are no more references to it.
 				/// </summary>
-				class HPixelShader : public Memory::Handle
+				class HPixelShader : public Memory::TypedHandle<mfgV2XPixelShader>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HPixelShader(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HPixelShader(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Gets a binding point from this shader.
@@ -663,24 +663,24 @@ namespace Magma
 				///		Used as a pipeline handle.
 				///		Destroys the pipeline automatically when there are no more references to it.
 				/// </summary>
-				class HPipeline : public Memory::Handle
+				class HPipeline : public Memory::TypedHandle<mfgV2XPipeline>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HPipeline(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HPipeline(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a constant buffer handle.
 				///		Destroys the constant buffer automatically when there are no more references to it.
 				/// </summary>
-				class HConstantBuffer : public Memory::Handle
+				class HConstantBuffer : public Memory::TypedHandle<mfgV2XConstantBuffer>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HConstantBuffer(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HConstantBuffer(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Maps the constant buffer to a region in memory.
@@ -698,12 +698,12 @@ namespace Magma
 				///		Used as a texture 1D handle.
 				///		Destroys the texture 1D automatically when there are no more references to it.
 				/// </summary>
-				class HTexture1D : public Memory::Handle
+				class HTexture1D : public Memory::TypedHandle<mfgV2XTexture1D>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HTexture1D(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HTexture1D(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Updates a texture with new data.
@@ -723,12 +723,12 @@ namespace Magma
 				///		Used as a texture 2D handle.
 				///		Destroys the texture 2D automatically when there are no more references to it.
 				/// </summary>
-				class HTexture2D : public Memory::Handle
+				class HTexture2D : public Memory::TypedHandle<mfgV2XTexture2D>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HTexture2D(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HTexture2D(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Updates a texture with new data.
@@ -750,12 +750,12 @@ namespace Magma
 				///		Used as a texture 3D handle.
 				///		Destroys the texture 3D automatically when there are no more references to it.
 				/// </summary>
-				class HTexture3D : public Memory::Handle
+				class HTexture3D : public Memory::TypedHandle<mfgV2XTexture3D>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HTexture3D(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HTexture3D(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Updates a texture with new data.
@@ -779,24 +779,24 @@ namespace Magma
 				///		Used as a sampler handle.
 				///		Destroys the sampler automatically when there are no more references to it.
 				/// </summary>
-				class HSampler : public Memory::Handle
+				class HSampler : public Memory::TypedHandle<mfgV2XSampler>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HSampler(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HSampler(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a vertex buffer handle.
 				///		Destroys the vertex buffer automatically when there are no more references to it.
 				/// </summary>
-				class HVertexBuffer : public Memory::Handle
+				class HVertexBuffer : public Memory::TypedHandle<mfgV2XVertexBuffer>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HVertexBuffer(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HVertexBuffer(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Maps the vertex buffer to a region in memory.
@@ -814,36 +814,36 @@ namespace Magma
 				///		Used as a vertex layout handle.
 				///		Destroys the vertex layout automatically when there are no more references to it.
 				/// </summary>
-				class HVertexLayout : public Memory::Handle
+				class HVertexLayout : public Memory::TypedHandle<mfgV2XVertexLayout>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HVertexLayout(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HVertexLayout(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a vertex array handle.
 				///		Destroys the vertex array automatically when there are no more references to it.
 				/// </summary>
-				class HVertexArray : public Memory::Handle
+				class HVertexArray : public Memory::TypedHandle<mfgV2XVertexArray>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HVertexArray(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HVertexArray(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a index buffer handle.
 				///		Destroys the index buffer automatically when there are no more references to it.
 				/// </summary>
-				class HIndexBuffer : public Memory::Handle
+				class HIndexBuffer : public Memory::TypedHandle<mfgV2XIndexBuffer>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HIndexBuffer(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HIndexBuffer(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Maps the index buffer to a region in memory.
@@ -861,84 +861,84 @@ namespace Magma
 				///		Used as a rasterizer state handle.
 				///		Destroys the state automatically when there are no more references to it.
 				/// </summary>
-				class HRasterState : public Memory::Handle
+				class HRasterState : public Memory::TypedHandle<mfgV2XRasterState>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HRasterState(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HRasterState(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a depth stencil state handle.
 				///		Destroys the state automatically when there are no more references to it.
 				/// </summary>
-				class HDepthStencilState : public Memory::Handle
+				class HDepthStencilState : public Memory::TypedHandle<mfgV2XDepthStencilState>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HDepthStencilState(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HDepthStencilState(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a blend state handle.
 				///		Destroys the state automatically when there are no more references to it.
 				/// </summary>
-				class HBlendState : public Memory::Handle
+				class HBlendState : public Memory::TypedHandle<mfgV2XBlendState>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HBlendState(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HBlendState(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a render texture handle.
 				///		Destroys the texture automatically when there are no more references to it.
 				/// </summary>
-				class HRenderTexture : public Memory::Handle
+				class HRenderTexture : public Memory::TypedHandle<mfgV2XRenderTexture>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HRenderTexture(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HRenderTexture(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a depth stencil texture handle.
 				///		Destroys the texture automatically when there are no more references to it.
 				/// </summary>
-				class HDepthStencilTexture : public Memory::Handle
+				class HDepthStencilTexture : public Memory::TypedHandle<mfgV2XDepthStencilTexture>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HDepthStencilTexture(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HDepthStencilTexture(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a framebuffer handle.
 				///		Destroys the framebuffer automatically when there are no more references to it.
 				/// </summary>
-				class HFramebuffer : public Memory::Handle
+				class HFramebuffer : public Memory::TypedHandle<mfgV2XFramebuffer>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HFramebuffer(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HFramebuffer(const Memory::Handle& object) : TypedHandle(object) {}
 				};
 
 				/// <summary>
 				///		Used as a render device handle.
 				///		Destroys the render device automatically when there are no more references to it.
 				/// </summary>
-				class HRenderDevice : public Memory::Handle
+				class HRenderDevice : public Memory::TypedHandle<mfgV2XRenderDevice>
 				{
 				public:
-					using Handle::Handle;
-					using Handle::operator=;
-					explicit inline HRenderDevice(const Memory::Handle& object) : Memory::Handle(object) {}
+					using TypedHandle::TypedHandle;
+					using TypedHandle::operator=;
+					explicit inline HRenderDevice(const Memory::Handle& object) : TypedHandle(object) {}
 
 					/// <summary>
 					///		Creates a new vertex shader.
@@ -962,20 +962,20 @@ namespace Magma
 					/// <param name="vs">Vertex shader handle</param>
 					/// <param name="ps">Pixel shader handle</param>
 					/// <returns>Pipeline handle</returns>
-					HPipeline CreatePipeline(HVertexShader vs, HPixelShader ps);
+					HPipeline CreatePipeline(const HVertexShader& vs, const HPixelShader& ps);
 
 					/// <summary>
 					///		Sets the pipeline used for rendering.
 					/// </summary>
 					/// <param name="pipeline">Pipeline handle</param>
-					void SetPipeline(HPipeline pipeline);
+					void SetPipeline(const HPipeline& pipeline);
 
 					/// <summary>
 					///		Binds a constant buffer to a binding point.
 					/// </summary>
 					/// <param name="bp">Binding point</param>
 					/// <param name="cb">Cosntant buffer handle</param>
-					void BindConstantBuffer(void* bp, HConstantBuffer cb);
+					void BindConstantBuffer(void* bp, const HConstantBuffer& cb);
 
 					/// <summary>
 					///		Binds a section of a constant buffer to a binding point.
@@ -984,42 +984,42 @@ namespace Magma
 					/// <param name="cb">Cosntant buffer handle</param>
 					/// <param name="offset">Offset in the constant buffer (in shader constants, one shader constant = 16 bytes, the number of constants must be a multiple of MFG_CONSTANT_ALIGN)</param>
 					/// <param name="size">Memory size in the constant buffer (in shader constants, one shader constant = 16 bytes, the number of constants must be a multiple of MFG_CONSTANT_ALIGN)</param>
-					void BindConstantBufferRange(void* bp, HConstantBuffer cb, mfmU64 offset, mfmU64 size);
+					void BindConstantBufferRange(void* bp, const HConstantBuffer& cb, mfmU64 offset, mfmU64 size);
 
 					/// <summary>
 					///		Binds a 1D texture to a binding point.
 					/// </summary>
 					/// <param name="bp">Binding point</param>
 					/// <param name="tex">Texture handle</param>
-					void BindTexture1D(void* bp, HTexture1D tex);
+					void BindTexture1D(void* bp, const HTexture1D& tex);
 
 					/// <summary>
 					///		Binds a 2D texture to a binding point.
 					/// </summary>
 					/// <param name="bp">Binding point</param>
 					/// <param name="tex">Texture handle</param>
-					void BindTexture2D(void* bp, HTexture2D tex);
+					void BindTexture2D(void* bp, const HTexture2D& tex);
 
 					/// <summary>
 					///		Binds a 3D texture to a binding point.
 					/// </summary>
 					/// <param name="bp">Binding point</param>
 					/// <param name="tex">Texture handle</param>
-					void BindTexture3D(void* bp, HTexture3D tex);
+					void BindTexture3D(void* bp, const HTexture3D& tex);
 
 					/// <summary>
 					///		Binds a render texture to a binding point.
 					/// </summary>
 					/// <param name="bp">Binding point</param>
 					/// <param name="tex">Render texture handle</param>
-					void BindRenderTexture(void* bp, HRenderTexture tex);
+					void BindRenderTexture(void* bp, const HRenderTexture& tex);
 
 					/// <summary>
 					///		Binds a sampler to a binding point.
 					/// </summary>
 					/// <param name="bp">Binding point</param>
 					/// <param name="sampler">Sampler handle</param>
-					void BindSampler(void* bp, HSampler sampler);
+					void BindSampler(void* bp, const HSampler& sampler);
 
 					/// <summary>
 					///		Creates a new constant buffer.
@@ -1046,7 +1046,7 @@ namespace Magma
 					/// <param name="elements">Vertex elements</param>
 					/// <param name="vs">Vertex shader handle</param>
 					/// <returns>Vertex layout handle</returns>
-					HVertexLayout CreateVertexLayout(mfmU64 elementCount, const VertexElement* elements, HVertexShader vs);
+					HVertexLayout CreateVertexLayout(mfmU64 elementCount, const VertexElement* elements, const HVertexShader& vs);
 
 					/// <summary>
 					///		Creates a new vertex array.
@@ -1055,13 +1055,13 @@ namespace Magma
 					/// <param name="buffers">Vertex buffer handles</param>
 					/// <param name="layout">Vertex layout handle</param>
 					/// <returns>Vertex array handle</returns>
-					HVertexArray CreateVertexArray(mfmU64 bufferCount, HVertexBuffer* buffers, HVertexLayout layout);
+					HVertexArray CreateVertexArray(mfmU64 bufferCount, HVertexBuffer* buffers, const HVertexLayout& layout);
 
 					/// <summary>
 					///		Sets the currently active vertex array.
 					/// </summary>
 					/// <param name="ib">Vertex array handle</param>
-					void SetVertexArray(HVertexArray va);
+					void SetVertexArray(const HVertexArray& va);
 
 					/// <summary>
 					///		Creates a new index buffer.
@@ -1077,7 +1077,7 @@ namespace Magma
 					///		Sets the currently active index buffer.
 					/// </summary>
 					/// <param name="ib">Index buffer handle</param>
-					void SetIndexBuffer(HIndexBuffer ib);
+					void SetIndexBuffer(const HIndexBuffer& ib);
 
 					/// <summary>
 					///		Creates a new 1D texture.
@@ -1144,19 +1144,19 @@ namespace Magma
 					///		Sets the currently active rasterizer state.
 					/// </summary>
 					/// <param name="state">State handle</param>
-					void SetRasterState(HRasterState state);
+					void SetRasterState(const HRasterState& state);
 
 					/// <summary>
 					///		Sets the currently active depth stencil state.
 					/// </summary>
 					/// <param name="state">State handle</param>
-					void SetDepthStencilState(HDepthStencilState state);
+					void SetDepthStencilState(const HDepthStencilState& state);
 
 					/// <summary>
 					///		Sets the currently active blend state.
 					/// </summary>
 					/// <param name="state">State handle</param>
-					void SetBlendState(HBlendState state);
+					void SetBlendState(const HBlendState& state);
 
 					/// <summary>
 					///		Creates a new render texture.
@@ -1183,13 +1183,13 @@ namespace Magma
 					/// <param name="textures">Render texture handles</param>
 					/// <param name="depthStencilTexture">Depth stencil texture handle (optional, may be NULL)</param>
 					/// <returns>Framebuffer handle</returns>
-					HFramebuffer CreateFramebuffer(mfmU64 textureCount, HRenderTexture* textures, HDepthStencilTexture depthStencilTexture);
+					HFramebuffer CreateFramebuffer(mfmU64 textureCount, HRenderTexture* textures, const HDepthStencilTexture& depthStencilTexture);
 
 					/// <summary>
 					///		Sets the currently active framebuffer.
 					/// </summary>
 					/// <param name="framebuffer">Framebuffer handle</param>
-					void SetFramebuffer(HFramebuffer framebuffer);
+					void SetFramebuffer(const HFramebuffer& framebuffer);
 
 					/// <summary>
 					///		Clears the current framebuffer color textures.
@@ -4,6 +4,7 @@
 #include "../String/Stream.h"
 
 #include <stdlib.h>
+#include <limits.h>
 
 static void* currentAllocator = NULL;
 static mftMutex* currentAllocatorMutex = NULL;
@@ -127,8 +128,20 @@ mfError mfgLoadTexture(void * stream, mfgTextureData * textureData, mfgEnum form
 			return MFG_ERROR_UNSUPPORTED_TYPE;
 	}
 
+	// Decode straight from the stream data when it is exposed (mapped files and string streams)
 	int x, y;
-	textureData->data = stbi_load_from_callbacks(&callbacks, stream, &x, &y, NULL, req_comp);
+	const mfmU8* span = NULL;
+	mfmU64 spanSize = 0;
+	err = mfsGetSpan(stream, MFM_U64_MAX, &span, &spanSize);
+	if (err == MF_ERROR_OKAY && spanSize <= INT_MAX)
+		textureData->data = stbi_load_from_memory(span, (int)spanSize, &x, &y, NULL, req_comp);
+	else if (err == MFS_ERROR_UNSUPPORTED_FUNCTION)
+		textureData->data = stbi_load_from_callbacks(&callbacks, stream, &x, &y, NULL, req_comp);
+	else
+	{
+		mftUnlockMutex(currentAllocatorMutex);
+		return err == MF_ERROR_OKAY ? MFG_ERROR_INVALID_DATA : err;
+	}
 	textureData->width = x;
 	textureData->height = y;
 	textureData->allocator = allocator;
@@ -136,4 +149,6 @@ mfError mfgLoadTexture(void * stream, mfgTextureData * textureData, mfgEnum form
 	err = mftUnlockMutex(currentAllocatorMutex);
 	if (err != MF_ERROR_OKAY)
 		return err;
+
+	return MF_ERROR_OKAY;
 }
@@ -56,6 +56,12 @@ mfError mfiRegisterWindowCreator(const mfsUTF8CodeUnit* type, mfiWindowCreatorFu
 
 mfError mfiCreateWindow(const mfsUTF8CodeUnit * type, mfiWindow ** window, mfmU32 width, mfmU32 height, mfiEnum mode, const mfsUTF8CodeUnit * title)
 {
+	// The title is passed straight to the platform, so invalid UTF-8 is rejected here (NULL is the same as an empty title)
+	if (title == NULL)
+		title = u8"";
+	else if (mfsValidateUTF8(title, strlen(title), NULL) != MF_ERROR_OKAY)
+		return MFI_ERROR_INVALID_ARGUMENTS;
+
 	for (mfmU64 i = 0; i < MFI_MAX_WINDOW_CREATOR_REGISTER_ENTRIES; ++i)
 		if (mfiWindowCreatorRegisterEntries[i].active == MFM_TRUE &&
 			strcmp(type, mfiWindowCreatorRegisterEntries[i].type) == 0)
@@ -106,10 +106,11 @@ extern "C"
 	/// <param name="width">WindowHandle width</param>
 	/// <param name="height">WindowHandle height</param>
 	/// <param name="mode">WindowHandle mode</param>
-	/// <param name="title">WindowHandle title</param>
+	/// <param name="title">WindowHandle title (NULL is the same as an empty title)</param>
 	/// <returns>
 	///		MF_ERROR_OKAY if there were no errors.
 	///		MFI_ERROR_TYPE_NOT_REGISTERED if there isn't a creator with the type registered.
+	///		MFI_ERROR_INVALID_ARGUMENTS if the title isn't valid UTF-8.
 	///		Otherwise returns a window creation error code.
 	/// </returns>
 	mfError mfiCreateWindow(const mfsUTF8CodeUnit* type, mfiWindow** window, mfmU32 width, mfmU32 height, mfiEnum mode, const mfsUTF8CodeUnit* title);
@@ -1,6 +1,19 @@
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
 #include "Allocator.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 mfError mfmAllocate(void * allocator, void ** memory, mfmU64 size)
 {
@@ -61,30 +74,117 @@ mfError mfmReallocate(void * allocator, void * memory, mfmU64 prevSize, mfmU64 s
 	}
 }
 
+static mfError mfmDefaultAllocateAligned(void ** memory, mfmU64 size, mfmU64 alignment)
+{
+#if defined(_WIN32)
+	*memory = _aligned_malloc((size_t)size, (size_t)alignment);
+	if (*memory == NULL)
+		return MFM_ERROR_ALLOCATION_FAILED;
+#else
+	// posix_memalign requires the alignment to be a multiple of sizeof(void*)
+	if (alignment < sizeof(void*))
+		alignment = sizeof(void*);
+	if (posix_memalign(memory, (size_t)alignment, (size_t)size) != 0)
+		return MFM_ERROR_ALLOCATION_FAILED;
+#if defined(MADV_HUGEPAGE)
+	// Ask for the memory to be backed by huge pages (only the whole huge pages inside the allocation)
+	mfmU64 hugePageSize = mfmGetHugePageSize();
+	if (alignment >= hugePageSize && size >= hugePageSize)
+		madvise(*memory, (size_t)(size - size % hugePageSize), MADV_HUGEPAGE);
+#endif
+#endif
+	return MF_ERROR_OKAY;
+}
+
+static void mfmDefaultDeallocateAligned(void * memory)
+{
+#if defined(_WIN32)
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
 mfError mfmAllocateAligned(void * allocator, void ** memory, mfmU64 size, mfmU64 alignment)
 {
-	if (memory == NULL || size == 0 || alignment == 0 || alignment > 256)
+	if (memory == NULL || size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
 		return MFM_ERROR_INVALID_ARGUMENTS;
 
-	mfmU64 realSize = size + alignment;
-	void* realMemory;
+	if (allocator == NULL)
+		return mfmDefaultAllocateAligned(memory, size, alignment);
+	else if (((mfmAllocator*)allocator)->allocateAligned != NULL)
+		return ((mfmAllocator*)allocator)->allocateAligned(allocator, memory, size, alignment);
 
-	mfError err = mfmAllocate(allocator, &realMemory, realSize);
+	// The allocator has no native aligned allocation, so over-allocate and store the original pointer before the aligned memory
+	void* realMemory;
+	mfError err = mfmAllocate(allocator, &realMemory, size + alignment - 1 + sizeof(void*));
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	mfmU64 remainder = ((mfmU64)realMemory) % alignment;
-	mfmU64 offset = alignment - remainder;
-
-	*memory = (mfmU8*)realMemory + offset;
-	((mfmU8*)*memory)[-1] = (mfmU8)offset;
+	mfmU64 address = ((mfmU64)realMemory + sizeof(void*) + alignment - 1) & ~(alignment - 1);
+	*memory = (void*)address;
+	memcpy((mfmU8*)*memory - sizeof(void*), &realMemory, sizeof(void*));
 
 	return MF_ERROR_OKAY;
 }
 
 mfError mfmDeallocateAligned(void * allocator, void * memory)
 {
-	mfmU64 offset = ((mfmU8*)memory)[-1];
-	void* realMemory = (mfmU8*)memory - offset;
+	if (memory == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	if (allocator == NULL)
+	{
+		mfmDefaultDeallocateAligned(memory);
+		return MF_ERROR_OKAY;
+	}
+	else if (((mfmAllocator*)allocator)->deallocateAligned != NULL)
+		return ((mfmAllocator*)allocator)->deallocateAligned(allocator, memory);
+
+	void* realMemory;
+	memcpy(&realMemory, (mfmU8*)memory - sizeof(void*), sizeof(void*));
 	return mfmDeallocate(allocator, realMemory);
 }
+
+mfmU64 mfmGetPageSize(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+#else
+	return (mfmU64)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+mfmU64 mfmGetHugePageSize(void)
+{
+#if defined(_WIN32)
+	mfmU64 size = GetLargePageMinimum();
+	return size != 0 ? size : mfmGetPageSize();
+#elif defined(__linux__)
+	static mfmU64 hugePageSize = 0;
+	if (hugePageSize == 0)
+	{
+		// Read the default huge page size from /proc/meminfo
+		mfmU64 size = 0;
+		FILE* file = fopen("/proc/meminfo", "r");
+		if (file != NULL)
+		{
+			char line[128];
+			unsigned long long kibibytes;
+			while (fgets(line, sizeof(line), file) != NULL)
+				if (sscanf(line, "Hugepagesize: %llu kB", &kibibytes) == 1)
+				{
+					size = kibibytes * 1024;
+					break;
+				}
+			fclose(file);
+		}
+		hugePageSize = size != 0 ? size : mfmGetPageSize();
+	}
+	return hugePageSize;
+#else
+	return mfmGetPageSize();
+#endif
+}
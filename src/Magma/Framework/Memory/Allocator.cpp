@@ -19,3 +19,19 @@ void Magma::Framework::Memory::HAllocator::Deallocate(void * memory)
 	if (err != MF_ERROR_OKAY)
 		throw AllocatorError(mfErrorToString(err));
 }
+
+void * Magma::Framework::Memory::HAllocator::AllocateAligned(mfmU64 size, mfmU64 alignment)
+{
+	void* mem;
+	mfError err = mfmAllocateAligned(this->GetNoChecks(), &mem, size, alignment);
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+	return mem;
+}
+
+void Magma::Framework::Memory::HAllocator::DeallocateAligned(void * memory)
+{
+	mfError err = mfmDeallocateAligned(this->GetNoChecks(), memory);
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+}
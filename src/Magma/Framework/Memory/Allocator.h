@@ -15,6 +15,8 @@ extern "C"
 	typedef mfError (*mfmAllocateFunction)(void* allocator, void** memory, mfmU64 size);
 	typedef mfError(*mfmDeallocateFunction)(void* allocator, void* memory);
 	typedef mfError (*mfmReallocateFunction)(void* allocator, void* memory, mfmU64 prevSize, mfmU64 size, void** newMemory);
+	typedef mfError (*mfmAllocateAlignedFunction)(void* allocator, void** memory, mfmU64 size, mfmU64 alignment);
+	typedef mfError (*mfmDeallocateAlignedFunction)(void* allocator, void* memory);
 
 	typedef struct
 	{
@@ -22,6 +24,13 @@ extern "C"
 		mfmAllocateFunction allocate;
 		mfmDeallocateFunction deallocate;
 		mfmReallocateFunction reallocate;
+
+		/// <summary>
+		///		Native aligned allocation functions.
+		///		If set to NULL, mfmAllocateAligned over-allocates with the allocate function and stores the original pointer before the aligned memory.
+		/// </summary>
+		mfmAllocateAlignedFunction allocateAligned;
+		mfmDeallocateAlignedFunction deallocateAligned;
 	} mfmAllocator;
 
 	/// <summary>
@@ -73,17 +82,21 @@ extern "C"
 	/// <param name="allocator">Magma framework memory allocator (set to NULL to use the default allocator)</param>
 	/// <param name="memory">Pointer to allocated memory pointer</param>
 	/// <param name="size">Memory allocation size in bytes</param>
-	/// <param name="alignment">Memory alignment in bytes (MUST be less than or equal to 256 bytes)</param>
+	/// <param name="alignment">
+	///		Memory alignment in bytes (must be a power of two).
+	///		Page alignment (mfmGetPageSize) and huge page alignment (mfmGetHugePageSize) are supported by the default allocator,
+	///		and on platforms which support it, memory allocated with huge page alignment is backed by huge pages when possible.
+	/// </param>
 	/// <returns>
 	///		Returns MF_ERROR_OKAY if there were no errors.
 	///		Returns MFM_ERROR_UNSUPPORTED_FUNCTION if the allocator doesn't support this function.
-	///		Returns MFM_ERROR_INVALID_ARGUMENTS if memory is NULL or size is 0.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if memory is NULL, size is 0 or the alignment isn't a power of two.
 	///		Returns other errors specific to the allocator type.
 	/// </returns>
 	mfError mfmAllocateAligned(void* allocator, void** memory, mfmU64 size, mfmU64 alignment);
 
 	/// <summary>
-	///		Deallocates aligned memory on a magma framework memory allocator.
+	///		Deallocates memory allocated by mfmAllocateAligned on a magma framework memory allocator.
 	/// </summary>
 	/// <param name="allocator">Magma framework memory allocator (set to NULL to use the default allocator)</param>
 	/// <param name="memory">Pointer to memory</param>
@@ -95,6 +108,18 @@ extern "C"
 	/// </returns>
 	mfError mfmDeallocateAligned(void* allocator, void* memory);
 
+	/// <summary>
+	///		Gets the size of a virtual memory page.
+	/// </summary>
+	/// <returns>Page size in bytes</returns>
+	mfmU64 mfmGetPageSize(void);
+
+	/// <summary>
+	///		Gets the size of a huge (large) virtual memory page.
+	/// </summary>
+	/// <returns>Huge page size in bytes (the normal page size if huge pages aren't supported)</returns>
+	mfmU64 mfmGetHugePageSize(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,20 @@ namespace Magma
 				/// </summary>
 				/// <param name="data">Data pointer</param>
 				void Deallocate(void* memory);
+
+				/// <summary>
+				///		Allocates data on this allocator using a specified alignment.
+				/// </summary>
+				/// <param name="size">Data size in bytes</param>
+				/// <param name="alignment">Data alignment in bytes (must be a power of two)</param>
+				/// <returns>Pointer to allocated data</returns>
+				void* AllocateAligned(mfmU64 size, mfmU64 alignment);
+
+				/// <summary>
+				///		Deallocates data previously allocated by AllocateAligned.
+				/// </summary>
+				/// <param name="data">Data pointer</param>
+				void DeallocateAligned(void* memory);
 			};
 
 			extern HAllocator StandardAllocator;
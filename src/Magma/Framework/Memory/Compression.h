@@ -9,6 +9,47 @@ extern "C"
 
 #define MFM_BEST_COMPRESSION	0x01
 #define MFM_FAST_COMPRESSION	0x02
+#define MFM_LZ_COMPRESSION		0x03
+
+/*
+	Compressed frames.
+	MFM_BEST_COMPRESSION and MFM_FAST_COMPRESSION write plain zlib streams, which identify themselves. Data compressed with other
+	codecs (currently only MFM_LZ_COMPRESSION) is stored in a frame which records the codec used, so that mfmInflate and inflate
+	streams can pick the right decoder. The frame magic is never a valid zlib header.
+
+	Frame header (8 bytes): magic "MFCF", U8 codec id, U8 codec version, U16 reserved (zero).
+
+	LZ frames (MFM_CODEC_LZ) are a sequence of independently compressed blocks of up to MFM_LZ_BLOCK_SIZE bytes (see LZ.h).
+	Each block starts with a little endian U32, whose low 31 bits are the size of the block data and whose high bit is set if
+	the block is stored uncompressed. A U32 with value 0 ends the frame.
+*/
+
+#define MFM_COMPRESSED_FRAME_MAGIC			u8"MFCF"
+#define MFM_COMPRESSED_FRAME_HEADER_SIZE	8
+
+#define MFM_CODEC_LZ						0x01
+
+#define MFM_LZ_VERSION						1
+#define MFM_LZ_BLOCK_SIZE					(64 * 1024)
+#define MFM_LZ_STORED_BLOCK					0x80000000
+
+/*
+	Block compressed frames, written by mfmDeflateBlocks and read by mfmInflateBlocks and mfmInflateBlocksRange.
+	The data is split in blocks of the same size (except the last one), which are compressed independently as complete zlib
+	streams, so they can be compressed and decompressed in parallel, and any byte range can be decompressed without
+	decompressing the blocks before it.
+
+	Frame layout (integers are little endian):
+		Header (32 bytes): magic "MFDB", U32 version, U64 block size, U64 uncompressed size, U64 block count.
+		Seek table: block count + 1 U64 offsets from the start of the frame, where block i is stored between offsets i and i + 1.
+		Compressed blocks.
+	The block size is at most MFM_DEFLATE_BLOCKS_MAX_BLOCK_SIZE, which bounds the memory needed to decompress a single block.
+*/
+
+#define MFM_DEFLATE_BLOCKS_VERSION				1
+#define MFM_DEFLATE_BLOCKS_HEADER_SIZE			32
+#define MFM_DEFLATE_BLOCKS_DEFAULT_BLOCK_SIZE	(1024 * 1024)
+#define MFM_DEFLATE_BLOCKS_MAX_BLOCK_SIZE		(64 * 1024 * 1024)
 
 #ifdef __cplusplus
 }
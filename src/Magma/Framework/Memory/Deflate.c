@@ -1,16 +1,40 @@
 #include "Deflate.h"
 
 #include "../Memory/Allocator.h"
+#include "../Memory/Endianness.h"
+#include "LZ.h"
 
 #include <zlib.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
+/*
+	The stream buffer is a ring buffer: the compressed data starts at readHead and is size bytes long, wrapping around the end
+	of the buffer, so reads never have to move the data left in the buffer.
+	zlib may hold compressed data which didn't fit in the buffer, in which case pending is set and it is written on the next read,
+	continuing the last flush mode (zlib requires the same mode to be used until a flush or finish is complete).
+	LZ streams don't use zlib: the data written is kept in lzInput until a whole block is written or the stream is flushed, and
+	each compressed block is kept in lzOutput until it is moved to the stream buffer. They use the zlib input fields as their
+	input cursor, so writes work the same way for both codecs.
+*/
 typedef struct
 {
 	mfsStream base;
 	z_stream stream;
-	mfmU64 bufferHead;
+	void* allocator;
+	mfmU64 readHead;
+	mfmU64 size;
+	int flushMode;
+	mfmBool pending;
+	mfmBool finished;
+	mfmEnum compression;
+	mfmU8* lzInput;
+	mfmU64 lzInputSize;
+	mfmU8* lzOutput;
+	mfmU64 lzOutputHead;
+	mfmU64 lzOutputSize;
+	mfmBool lzEnded;
 } mfmDeflateStream;
 
 static voidpf mfmDeflateAllocate(voidpf opaque, uInt items, uInt size)
@@ -29,71 +53,304 @@ static void mfmDeflateDeallocate(voidpf opaque, voidpf address)
 		abort();
 }
 
+// Gets the free contiguous space after the data on the ring buffer
+static mfmU8* mfmGetDeflateFreeSpace(mfmDeflateStream* stream, mfmU64* freeSize)
+{
+	if (stream->size == 0)
+		stream->readHead = 0;
+
+	mfmU64 tail = stream->readHead + stream->size;
+	if (tail >= stream->base.bufferSize)
+	{
+		tail -= stream->base.bufferSize;
+		*freeSize = stream->readHead - tail;
+	}
+	else
+		*freeSize = stream->base.bufferSize - tail;
+	return stream->base.buffer + tail;
+}
+
+static void mfmWriteLZU32(mfmU8* data, mfmU32 value)
+{
+	data[0] = (mfmU8)(value & 0xFF);
+	data[1] = (mfmU8)((value >> 8) & 0xFF);
+	data[2] = (mfmU8)((value >> 16) & 0xFF);
+	data[3] = (mfmU8)((value >> 24) & 0xFF);
+}
+
+static void mfmWriteLZFrameHeader(mfmU8* data)
+{
+	memcpy(data, MFM_COMPRESSED_FRAME_MAGIC, 4);
+	data[4] = MFM_CODEC_LZ;
+	data[5] = MFM_LZ_VERSION;
+	data[6] = 0;
+	data[7] = 0;
+}
+
+// Writes a block (its size word and data) to out, storing it uncompressed if it doesn't get smaller, and returns its total size
+static mfmU64 mfmWriteLZBlock(const mfmU8* data, mfmU64 dataSize, mfmU8* out)
+{
+	mfmU64 compressedSize;
+	if (mfmLZCompressBlock(data, dataSize, out + sizeof(mfmU32), dataSize - 1, &compressedSize) == MF_ERROR_OKAY)
+	{
+		mfmWriteLZU32(out, (mfmU32)compressedSize);
+		return sizeof(mfmU32) + compressedSize;
+	}
+
+	mfmWriteLZU32(out, (mfmU32)dataSize | MFM_LZ_STORED_BLOCK);
+	memcpy(out + sizeof(mfmU32), data, dataSize);
+	return sizeof(mfmU32) + dataSize;
+}
+
+// Same as mfmPumpDeflateStream, for LZ streams
+static mfError mfmPumpLZDeflateStream(mfmDeflateStream* stream, int flush)
+{
+	stream->flushMode = flush;
+	for (;;)
+	{
+		// Move the compressed data to the stream buffer
+		while (stream->lzOutputSize > 0)
+		{
+			mfmU64 freeSize;
+			mfmU8* out = mfmGetDeflateFreeSpace(stream, &freeSize);
+			if (freeSize == 0)
+			{
+				stream->pending = MFM_TRUE;
+				return MFM_ERROR_BUFFER_FULL;
+			}
+
+			mfmU64 size = freeSize < stream->lzOutputSize ? freeSize : stream->lzOutputSize;
+			memcpy(out, stream->lzOutput + stream->lzOutputHead, size);
+			stream->size += size;
+			stream->lzOutputHead += size;
+			stream->lzOutputSize -= size;
+		}
+		stream->pending = MFM_FALSE;
+
+		if (stream->lzEnded != MFM_FALSE)
+		{
+			stream->finished = MFM_TRUE;
+			return MF_ERROR_OKAY;
+		}
+
+		if (stream->stream.avail_in > 0)
+		{
+			mfmU64 size = MFM_LZ_BLOCK_SIZE - stream->lzInputSize;
+			if (size > stream->stream.avail_in)
+				size = stream->stream.avail_in;
+			memcpy(stream->lzInput + stream->lzInputSize, stream->stream.next_in, size);
+			stream->lzInputSize += size;
+			stream->stream.next_in += size;
+			stream->stream.avail_in -= (uInt)size;
+		}
+
+		// Blocks are compressed once they are full, or when the stream is flushed
+		stream->lzOutputHead = 0;
+		if (stream->lzInputSize == MFM_LZ_BLOCK_SIZE || (flush != Z_NO_FLUSH && stream->lzInputSize > 0))
+		{
+			stream->lzOutputSize = mfmWriteLZBlock(stream->lzInput, stream->lzInputSize, stream->lzOutput);
+			stream->lzInputSize = 0;
+		}
+		else if (flush == Z_FINISH)
+		{
+			mfmWriteLZU32(stream->lzOutput, 0);
+			stream->lzOutputSize = sizeof(mfmU32);
+			stream->lzEnded = MFM_TRUE;
+		}
+		else
+			return MF_ERROR_OKAY;
+	}
+}
+
+// Runs deflate on the current input until it is consumed and all the output for the flush mode is written, or the buffer is full
+static mfError mfmPumpDeflateStream(mfmDeflateStream* stream, int flush)
+{
+	if (stream->compression == MFM_LZ_COMPRESSION)
+		return mfmPumpLZDeflateStream(stream, flush);
+
+	for (;;)
+	{
+		mfmU64 freeSize;
+		mfmU8* out = mfmGetDeflateFreeSpace(stream, &freeSize);
+		if (freeSize == 0)
+			return MFM_ERROR_BUFFER_FULL;
+
+		stream->stream.next_out = out;
+		stream->stream.avail_out = freeSize > UINT_MAX ? UINT_MAX : (uInt)freeSize;
+		uInt outAvailable = stream->stream.avail_out;
+		stream->flushMode = flush;
+		int ret = deflate(&stream->stream, flush);
+		stream->size += outAvailable - stream->stream.avail_out;
+
+		if (ret == Z_STREAM_END)
+		{
+			stream->pending = MFM_FALSE;
+			stream->finished = MFM_TRUE;
+			return MF_ERROR_OKAY;
+		}
+		if (ret != Z_OK && ret != Z_BUF_ERROR)
+			return MFM_ERROR_INTERNAL;
+
+		// If deflate didn't fill the output, the input was consumed and the flush is complete
+		stream->pending = stream->stream.avail_out == 0 ? MFM_TRUE : MFM_FALSE;
+		if (stream->pending == MFM_FALSE)
+			return MF_ERROR_OKAY;
+	}
+}
+
 static mfError mfmFlush(void* stream)
 {
-	return MF_ERROR_OKAY;
+	mfmDeflateStream* defStream = stream;
+	if (defStream->finished != MFM_FALSE)
+		return MF_ERROR_OKAY;
+
+	defStream->stream.next_in = NULL;
+	defStream->stream.avail_in = 0;
+	return mfmPumpDeflateStream(defStream, defStream->flushMode == Z_FINISH ? Z_FINISH : Z_SYNC_FLUSH);
 }
 
 static mfError mfmRead(void* stream, mfmU8* buffer, mfmU64 bufferSize, mfmU64* readSize)
 {
 	mfmDeflateStream* defStream = stream;
+	mfmU64 totalSize = 0;
 
-	if (bufferSize >= defStream->bufferHead)
+	while (totalSize < bufferSize)
 	{
-		memcpy(buffer, defStream->base.buffer, defStream->bufferHead);
-		if (readSize != NULL)
-			*readSize = defStream->bufferHead;
-		defStream->bufferHead = 0;
+		// Compressed data held by zlib is written to the buffer once there is space for it
+		if (defStream->size == 0 && defStream->pending != MFM_FALSE)
+		{
+			defStream->stream.next_in = NULL;
+			defStream->stream.avail_in = 0;
+			mfError err = mfmPumpDeflateStream(defStream, defStream->flushMode);
+			if (err != MF_ERROR_OKAY && err != MFM_ERROR_BUFFER_FULL)
+				return err;
+		}
+
+		if (defStream->size == 0)
+			break;
+
+		// Copy the data up to the end of the buffer, and wrap around on the next iteration
+		mfmU64 size = defStream->base.bufferSize - defStream->readHead;
+		if (size > defStream->size)
+			size = defStream->size;
+		if (size > bufferSize - totalSize)
+			size = bufferSize - totalSize;
+		memcpy(buffer + totalSize, defStream->base.buffer + defStream->readHead, size);
+		totalSize += size;
+		defStream->readHead += size;
+		if (defStream->readHead == defStream->base.bufferSize)
+			defStream->readHead = 0;
+		defStream->size -= size;
 	}
-	else
+
+	if (readSize != NULL)
+		*readSize = totalSize;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfmGetSpan(void* stream, mfmU64 size, const mfmU8** data, mfmU64* outSize)
+{
+	mfmDeflateStream* defStream = stream;
+
+	if (defStream->size == 0 && defStream->pending != MFM_FALSE)
 	{
-		memcpy(buffer, defStream->base.buffer, bufferSize);
-		memcpy(defStream->base.buffer, defStream->base.buffer + bufferSize, defStream->bufferHead - bufferSize);
-		defStream->bufferHead -= bufferSize;
-		if (readSize != NULL)
-			*readSize = bufferSize;
+		defStream->stream.next_in = NULL;
+		defStream->stream.avail_in = 0;
+		mfError err = mfmPumpDeflateStream(defStream, defStream->flushMode);
+		if (err != MF_ERROR_OKAY && err != MFM_ERROR_BUFFER_FULL)
+			return err;
 	}
 
+	// The span is the contiguous data up to the end of the buffer, which stays valid until the next write or flush
+	mfmU64 contiguous = defStream->base.bufferSize - defStream->readHead;
+	if (contiguous > defStream->size)
+		contiguous = defStream->size;
+	if (size > contiguous)
+		size = contiguous;
+
+	*data = defStream->base.buffer + defStream->readHead;
+	*outSize = size;
+	defStream->readHead += size;
+	if (defStream->readHead == defStream->base.bufferSize)
+		defStream->readHead = 0;
+	defStream->size -= size;
 	return MF_ERROR_OKAY;
 }
 
 static mfError mfmWrite(void* stream, const mfmU8* buffer, mfmU64 bufferSize, mfmU64* writeSize)
 {
 	mfmDeflateStream* defStream = stream;
-	defStream->stream.avail_in = bufferSize;
-	defStream->stream.next_in = buffer;
-	defStream->stream.avail_out = defStream->base.bufferSize - defStream->bufferHead;
-	defStream->stream.next_out = defStream->base.buffer + defStream->bufferHead;
+	if (defStream->finished != MFM_FALSE || defStream->flushMode == Z_FINISH)
+		return MFM_ERROR_INVALID_ARGUMENTS;
 
-	if (defStream->stream.avail_out == 0)
-		return MFM_ERROR_BUFFER_FULL;
+	// A flush must be completed before more data is compressed
+	if (defStream->pending != MFM_FALSE && defStream->flushMode != Z_NO_FLUSH)
+	{
+		defStream->stream.next_in = NULL;
+		defStream->stream.avail_in = 0;
+		mfError err = mfmPumpDeflateStream(defStream, defStream->flushMode);
+		if (err != MF_ERROR_OKAY)
+		{
+			if (writeSize != NULL)
+				*writeSize = 0;
+			return err;
+		}
+	}
 
-	int err = deflate(&defStream->stream, Z_FULL_FLUSH);
-	if (err != Z_OK)
-		return MFM_ERROR_INTERNAL;
-	defStream->bufferHead += (defStream->base.bufferSize - defStream->bufferHead) - defStream->stream.avail_out;
+	// zlib sizes are 32 bits wide, so bigger buffers are fed in pieces
+	mfmU64 writtenSize = 0;
+	mfError err = MF_ERROR_OKAY;
+	while (writtenSize < bufferSize)
+	{
+		mfmU64 left = bufferSize - writtenSize;
+		defStream->stream.next_in = (Bytef*)(buffer + writtenSize);
+		defStream->stream.avail_in = left > UINT_MAX ? UINT_MAX : (uInt)left;
+		uInt inAvailable = defStream->stream.avail_in;
+		err = mfmPumpDeflateStream(defStream, Z_NO_FLUSH);
+		writtenSize += inAvailable - defStream->stream.avail_in;
+		if (err != MF_ERROR_OKAY)
+			break;
+	}
+
+	defStream->stream.next_in = NULL;
+	defStream->stream.avail_in = 0;
 
 	if (writeSize != NULL)
-		*writeSize = bufferSize - defStream->stream.avail_in;
+		*writeSize = writtenSize;
 
-	return MF_ERROR_OKAY;
+	// Partial writes succeed, the caller must read the compressed data and write the rest
+	if (err == MFM_ERROR_BUFFER_FULL && writtenSize != 0)
+		return MF_ERROR_OKAY;
+	return err;
 }
 
 static mfError mfmSetBuffer(void* stream, mfmU8* buffer, mfmU64 bufferSize)
 {
 	mfmDeflateStream* defStream = stream;
 
-	if (defStream->bufferHead != 0)
+	if (defStream->size != 0)
 		return MFM_ERROR_BUFFER_FULL;
 
 	defStream->base.buffer = buffer;
 	defStream->base.bufferSize = bufferSize;
+	defStream->readHead = 0;
 
 	return MF_ERROR_OKAY;
 }
 
 mfError mfmCreateDeflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bufferSize, mfmEnum compression, void * allocator)
 {
+	if (outStream == NULL || buffer == NULL || bufferSize == 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	int level = Z_DEFAULT_COMPRESSION;
+	if (compression == MFM_BEST_COMPRESSION)
+		level = Z_BEST_COMPRESSION;
+	else if (compression == MFM_FAST_COMPRESSION)
+		level = Z_BEST_SPEED;
+	else if (compression != MFM_LZ_COMPRESSION)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
 	mfError err;
 
 	mfmDeflateStream* stream;
@@ -102,6 +359,41 @@ mfError mfmCreateDeflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bu
 	if (err != MF_ERROR_OKAY)
 		return err;
 
+	stream->compression = compression;
+	stream->lzInput = NULL;
+	stream->lzInputSize = 0;
+	stream->lzOutput = NULL;
+	stream->lzOutputHead = 0;
+	stream->lzOutputSize = 0;
+	stream->lzEnded = MFM_FALSE;
+	stream->stream.next_in = NULL;
+	stream->stream.avail_in = 0;
+
+	if (compression == MFM_LZ_COMPRESSION)
+	{
+		// The output block has room for a stored block, and starts with the frame header
+		err = mfmAllocate(allocator, &stream->lzInput, MFM_LZ_BLOCK_SIZE + sizeof(mfmU32) + MFM_LZ_BLOCK_SIZE);
+		if (err != MF_ERROR_OKAY)
+		{
+			mfmDeallocate(allocator, stream);
+			return err;
+		}
+		stream->lzOutput = stream->lzInput + MFM_LZ_BLOCK_SIZE;
+		mfmWriteLZFrameHeader(stream->lzOutput);
+		stream->lzOutputSize = MFM_COMPRESSED_FRAME_HEADER_SIZE;
+	}
+	else
+	{
+		stream->stream.zalloc = &mfmDeflateAllocate;
+		stream->stream.zfree = &mfmDeflateDeallocate;
+		stream->stream.opaque = allocator;
+		if (deflateInit(&stream->stream, level) != Z_OK)
+		{
+			mfmDeallocate(allocator, stream);
+			return MFM_ERROR_INTERNAL;
+		}
+	}
+
 	err = mfmInitObject(&stream->base.object);
 	if (err != MF_ERROR_OKAY)
 		return err;
@@ -109,7 +401,12 @@ mfError mfmCreateDeflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bu
 
 	stream->base.buffer = buffer;
 	stream->base.bufferSize = bufferSize;
-	stream->bufferHead = 0;
+	stream->allocator = allocator;
+	stream->readHead = 0;
+	stream->size = 0;
+	stream->flushMode = Z_NO_FLUSH;
+	stream->pending = stream->lzOutputSize > 0 ? MFM_TRUE : MFM_FALSE;
+	stream->finished = MFM_FALSE;
 
 	stream->base.flush = &mfmFlush;
 	stream->base.read = &mfmRead;
@@ -120,31 +417,293 @@ mfError mfmCreateDeflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bu
 	stream->base.seekHead = NULL;
 	stream->base.tell = NULL;
 	stream->base.eof = NULL;
+	stream->base.getSpan = &mfmGetSpan;
+
+	*outStream = stream;
 
-	stream->stream.zalloc = &mfmDeflateAllocate;
-	stream->stream.zfree = &mfmDeflateDeallocate;
-	stream->stream.opaque = allocator;
+	return MF_ERROR_OKAY;
+}
 
-	if (compression == MFM_BEST_COMPRESSION)
+void mfmDestroyDeflateStream(mfsStream * stream)
+{
+	if (stream == NULL)
+		abort();
+
+	mfmDeflateStream* defStream = stream;
+
+	if (defStream->compression == MFM_LZ_COMPRESSION)
 	{
-		if (deflateInit(&stream->stream, Z_BEST_COMPRESSION) != Z_OK)
-			return MFM_ERROR_INTERNAL;
+		if (mfmDeallocate(defStream->allocator, defStream->lzInput) != MF_ERROR_OKAY)
+			abort();
 	}
-	else if (compression == MFM_FAST_COMPRESSION)
+	else
+		deflateEnd(&defStream->stream);
+
+	if (mfmDeinitObject(&defStream->base.object) != MF_ERROR_OKAY)
+		abort();
+	if (mfmDeallocate(defStream->allocator, defStream) != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mfmFinishDeflateStream(mfsStream * stream)
+{
+	if (stream == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmDeflateStream* defStream = stream;
+	if (defStream->finished != MFM_FALSE)
+		return MF_ERROR_OKAY;
+
+	defStream->stream.next_in = NULL;
+	defStream->stream.avail_in = 0;
+	mfError err = mfmPumpDeflateStream(defStream, Z_FINISH);
+	if (err == MF_ERROR_OKAY && defStream->finished == MFM_FALSE)
+		return MFM_ERROR_BUFFER_FULL;
+	return err;
+}
+
+// Same as mfmDeflate, for MFM_LZ_COMPRESSION
+static mfError mfmDeflateLZ(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* compressedSize)
+{
+	if (outSize < MFM_COMPRESSED_FRAME_HEADER_SIZE + sizeof(mfmU32))
+		return MFM_ERROR_BUFFER_FULL;
+	mfmWriteLZFrameHeader(out);
+	mfmU64 size = MFM_COMPRESSED_FRAME_HEADER_SIZE;
+
+	for (mfmU64 offset = 0; offset < dataSize; offset += MFM_LZ_BLOCK_SIZE)
 	{
-		if (deflateInit(&stream->stream, Z_BEST_SPEED) != Z_OK)
-			return MFM_ERROR_INTERNAL;
+		mfmU64 blockSize = dataSize - offset < MFM_LZ_BLOCK_SIZE ? dataSize - offset : MFM_LZ_BLOCK_SIZE;
+
+		// Blocks are compressed straight to the output, and only fall back to being stored if they don't get smaller
+		mfmU64 available = outSize - size - sizeof(mfmU32);
+		mfmU64 blockDataSize;
+		mfError err = mfmLZCompressBlock(data + offset, blockSize, out + size + sizeof(mfmU32), available < blockSize - 1 ? available : blockSize - 1, &blockDataSize);
+		if (err == MF_ERROR_OKAY)
+			mfmWriteLZU32(out + size, (mfmU32)blockDataSize);
+		else if (err == MFM_ERROR_BUFFER_FULL && available >= blockSize)
+		{
+			blockDataSize = blockSize;
+			mfmWriteLZU32(out + size, (mfmU32)blockSize | MFM_LZ_STORED_BLOCK);
+			memcpy(out + size + sizeof(mfmU32), data + offset, blockSize);
+		}
+		else
+			return err;
+		size += sizeof(mfmU32) + blockDataSize;
+
+		// There must always be room left for the end of the frame
+		if (outSize - size < sizeof(mfmU32))
+			return MFM_ERROR_BUFFER_FULL;
 	}
-	else return MFM_ERROR_INVALID_ARGUMENTS;
 
-	*outStream = stream;
+	mfmWriteLZU32(out + size, 0);
+	*compressedSize = size + sizeof(mfmU32);
+	return MF_ERROR_OKAY;
+}
 
+mfError mfmDeflate(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* compressedSize, mfmEnum compression, void* allocator)
+{
+	if ((data == NULL && dataSize != 0) || out == NULL || compressedSize == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	int level;
+	if (compression == MFM_BEST_COMPRESSION)
+		level = Z_BEST_COMPRESSION;
+	else if (compression == MFM_FAST_COMPRESSION)
+		level = Z_BEST_SPEED;
+	else if (compression == MFM_LZ_COMPRESSION)
+		return mfmDeflateLZ(data, dataSize, out, outSize, compressedSize);
+	else
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	z_stream stream;
+	stream.zalloc = &mfmDeflateAllocate;
+	stream.zfree = &mfmDeflateDeallocate;
+	stream.opaque = allocator;
+	if (deflateInit(&stream, level) != Z_OK)
+		return MFM_ERROR_INTERNAL;
+
+	// zlib sizes are 32 bits wide, so bigger buffers are fed in pieces
+	stream.next_in = (Bytef*)data;
+	stream.avail_in = 0;
+	stream.next_out = out;
+	stream.avail_out = 0;
+	mfmU64 inLeft = dataSize;
+	mfmU64 outLeft = outSize;
+	int ret;
+	do
+	{
+		if (stream.avail_in == 0)
+		{
+			stream.avail_in = inLeft > UINT_MAX ? UINT_MAX : (uInt)inLeft;
+			inLeft -= stream.avail_in;
+		}
+		if (stream.avail_out == 0)
+		{
+			if (outLeft == 0)
+			{
+				deflateEnd(&stream);
+				return MFM_ERROR_BUFFER_FULL;
+			}
+			stream.avail_out = outLeft > UINT_MAX ? UINT_MAX : (uInt)outLeft;
+			outLeft -= stream.avail_out;
+		}
+
+		ret = deflate(&stream, inLeft == 0 ? Z_FINISH : Z_NO_FLUSH);
+	} while (ret == Z_OK || ret == Z_BUF_ERROR);
+
+	*compressedSize = stream.total_out;
+	deflateEnd(&stream);
+	if (ret != Z_STREAM_END)
+		return MFM_ERROR_INTERNAL;
 	return MF_ERROR_OKAY;
 }
 
-void mfmDestroyDeflateStream(mfsStream * stream)
+typedef struct
 {
-	mfmDeflateStream* defStream = stream;
+	const mfmU8* data;
+	mfmU64 dataSize;
+	mfmU8* out;
+	mfmU64 outSize;
+	mfmU64 compressedSize;
+	mfmEnum compression;
+	void* allocator;
+	mfError err;
+} mfmDeflateBlockJob;
 
-	deflateEnd(&defStream->stream);
+static void mfmDeflateBlockJobFunction(void* args)
+{
+	mfmDeflateBlockJob* job = args;
+	job->err = mfmDeflate(job->data, job->dataSize, job->out, job->outSize, &job->compressedSize, job->compression, job->allocator);
+}
+
+static mfmU64 mfmGetDeflateBlockBound(mfmU64 blockSize)
+{
+	// compressBound takes a 32 bit size on some platforms, and zlib's worst case expansion is linear
+	mfmU64 bound;
+	if (blockSize <= 0xFFFFFFFF)
+		bound = compressBound((uLong)blockSize);
+	else
+		bound = blockSize + (blockSize >> 12) + (blockSize >> 14) + (blockSize >> 25) + 13;
+
+	// Blocks may also be LZ frames, which have a different worst case
+	mfmU64 lzBound = mfmGetLZFrameBound(blockSize);
+	return bound > lzBound ? bound : lzBound;
+}
+
+static void mfmWriteDeflateBlocksU64(mfmU8* data, mfmU64 value)
+{
+	mfmU64 raw;
+	mfmToLittleEndian8(&value, &raw);
+	memcpy(data, &raw, sizeof(raw));
+}
+
+mfmU64 mfmGetDeflateBlocksBound(mfmU64 dataSize, mfmU64 blockSize)
+{
+	if (blockSize == 0)
+		blockSize = MFM_DEFLATE_BLOCKS_DEFAULT_BLOCK_SIZE;
+	mfmU64 blockCount = (dataSize + blockSize - 1) / blockSize;
+	return MFM_DEFLATE_BLOCKS_HEADER_SIZE + (blockCount + 1) * sizeof(mfmU64) + blockCount * mfmGetDeflateBlockBound(blockSize);
+}
+
+mfError mfmDeflateBlocks(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* compressedSize, mfmU64 blockSize, mfmEnum compression, mftJobSystem* jobSystem, void* allocator)
+{
+	if ((data == NULL && dataSize != 0) || out == NULL || compressedSize == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	if (compression != MFM_BEST_COMPRESSION && compression != MFM_FAST_COMPRESSION && compression != MFM_LZ_COMPRESSION)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	if (blockSize == 0)
+		blockSize = MFM_DEFLATE_BLOCKS_DEFAULT_BLOCK_SIZE;
+	else if (blockSize > MFM_DEFLATE_BLOCKS_MAX_BLOCK_SIZE)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	mfmU64 blockCount = (dataSize + blockSize - 1) / blockSize;
+	mfmU64 tableSize = (blockCount + 1) * sizeof(mfmU64);
+	if (outSize < MFM_DEFLATE_BLOCKS_HEADER_SIZE + tableSize)
+		return MFM_ERROR_BUFFER_FULL;
+
+	// Each block is compressed to its own slot of a scratch buffer, and the slots are then packed after the seek table
+	mfError err;
+	mfmU64 blockBound = mfmGetDeflateBlockBound(blockSize);
+	mfmDeflateBlockJob* jobs = NULL;
+	mfmU8* scratch = NULL;
+	if (blockCount != 0)
+	{
+		err = mfmAllocate(allocator, &jobs, blockCount * sizeof(mfmDeflateBlockJob));
+		if (err != MF_ERROR_OKAY)
+			return err;
+		err = mfmAllocate(allocator, &scratch, blockCount * blockBound);
+		if (err != MF_ERROR_OKAY)
+		{
+			mfmDeallocate(allocator, jobs);
+			return err;
+		}
+	}
+
+	for (mfmU64 i = 0; i < blockCount; ++i)
+	{
+		jobs[i].data = data + i * blockSize;
+		jobs[i].dataSize = (i + 1 == blockCount) ? dataSize - i * blockSize : blockSize;
+		jobs[i].out = scratch + i * blockBound;
+		jobs[i].outSize = blockBound;
+		jobs[i].compression = compression;
+		jobs[i].allocator = allocator;
+		jobs[i].err = MF_ERROR_OKAY;
+	}
+
+	if (jobSystem != NULL && blockCount > 1)
+	{
+		mftJobCounter counter;
+		mftInitJobCounter(&counter);
+		err = mftSubmitJobBatch(jobSystem, &mfmDeflateBlockJobFunction, jobs, sizeof(mfmDeflateBlockJob), blockCount, &counter);
+		if (err == MF_ERROR_OKAY)
+			err = mftWaitForJobCounter(jobSystem, &counter);
+		if (err != MF_ERROR_OKAY)
+			abort();
+	}
+	else
+		for (mfmU64 i = 0; i < blockCount; ++i)
+			mfmDeflateBlockJobFunction(&jobs[i]);
+
+	// Write the header, the seek table and the blocks
+	err = MF_ERROR_OKAY;
+	memcpy(out, u8"MFDB", 4);
+	{
+		mfmU32 version = MFM_DEFLATE_BLOCKS_VERSION, raw;
+		mfmToLittleEndian4(&version, &raw);
+		memcpy(out + 4, &raw, sizeof(raw));
+	}
+	mfmWriteDeflateBlocksU64(out + 8, blockSize);
+	mfmWriteDeflateBlocksU64(out + 16, dataSize);
+	mfmWriteDeflateBlocksU64(out + 24, blockCount);
+
+	mfmU64 offset = MFM_DEFLATE_BLOCKS_HEADER_SIZE + tableSize;
+	for (mfmU64 i = 0; i < blockCount; ++i)
+	{
+		if (jobs[i].err != MF_ERROR_OKAY)
+		{
+			err = jobs[i].err;
+			break;
+		}
+		if (jobs[i].compressedSize > outSize - offset)
+		{
+			err = MFM_ERROR_BUFFER_FULL;
+			break;
+		}
+
+		mfmWriteDeflateBlocksU64(out + MFM_DEFLATE_BLOCKS_HEADER_SIZE + i * sizeof(mfmU64), offset);
+		memcpy(out + offset, jobs[i].out, jobs[i].compressedSize);
+		offset += jobs[i].compressedSize;
+	}
+	mfmWriteDeflateBlocksU64(out + MFM_DEFLATE_BLOCKS_HEADER_SIZE + blockCount * sizeof(mfmU64), offset);
+
+	if (blockCount != 0)
+	{
+		mfmDeallocate(allocator, scratch);
+		mfmDeallocate(allocator, jobs);
+	}
+
+	if (err != MF_ERROR_OKAY)
+		return err;
+	*compressedSize = offset;
+	return MF_ERROR_OKAY;
 }
@@ -5,6 +5,16 @@
 
 #include "Compression.h"
 
+#include "../Thread/JobSystem.h"
+
+/*
+	DEFLATE streams compress the data written to them into the stream buffer, which is used as a ring buffer, from where the
+	compressed data is read (or taken with mfsGetSpan, without copying it).
+	Data is only flushed when requested with mfsFlush (a zlib sync flush, which keeps the dictionary) or mfmFinishDeflateStream,
+	so many small writes compress as well as a single big one.
+	With MFM_LZ_COMPRESSION, the data is written as an LZ frame (see Compression.h) instead of a zlib stream, and flushing ends
+	the current block.
+*/
 #ifdef __cplusplus
 extern "C"
 {
@@ -12,11 +22,13 @@ extern "C"
 
 	/// <summary>
 	///		Creates a stream that compresses data using DEFLATE.
+	///		Writes return MFM_ERROR_BUFFER_FULL if the buffer is full and no data could be written, in which case the compressed
+	///		data must be read before writing more.
 	/// </summary>
 	/// <param name="stream">Out stream handle</param>
-	/// <param name="buffer">Stream buffer</param>
+	/// <param name="buffer">Stream buffer, where the compressed data is kept until it is read</param>
 	/// <param name="bufferSize">Stream buffer size</param>
-	/// <param name="compression">Compression mode</param>
+	/// <param name="compression">Compression mode (MFM_BEST_COMPRESSION, MFM_FAST_COMPRESSION or MFM_LZ_COMPRESSION)</param>
 	/// <param name="allocator">Stream internal allocator</param>
 	mfError mfmCreateDeflateStream(mfsStream** stream, mfmU8* buffer, mfmU64 bufferSize, mfmEnum compression, void* allocator);
 
@@ -26,6 +38,66 @@ extern "C"
 	/// <param name="stream">Stream handle</param>
 	void mfmDestroyDeflateStream(mfsStream* stream);
 
+	/// <summary>
+	///		Flushes all the data written to a DEFLATE stream and ends the zlib stream (or LZ frame), so that the compressed data can be
+	///		decompressed with mfmInflate. Nothing can be written to the stream afterwards.
+	/// </summary>
+	/// <param name="stream">Stream handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_BUFFER_FULL if the compressed data doesn't fit in the stream buffer, in which case it must be read and this function called again.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mfmFinishDeflateStream(mfsStream* stream);
+
+	/// <summary>
+	///		Compresses a whole buffer using DEFLATE in a single call, writing the compressed data directly to the output buffer.
+	///		The output is a complete zlib stream (or an LZ frame, with MFM_LZ_COMPRESSION), which can be decompressed with mfmInflate
+	///		or with an inflate stream.
+	/// </summary>
+	/// <param name="data">Data to compress</param>
+	/// <param name="dataSize">Data size</param>
+	/// <param name="out">Output buffer</param>
+	/// <param name="outSize">Output buffer size</param>
+	/// <param name="compressedSize">Out compressed data size</param>
+	/// <param name="compression">Compression mode</param>
+	/// <param name="allocator">Internal allocator</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL or if the compression mode is invalid.
+	///		Returns MFM_ERROR_BUFFER_FULL if the compressed data doesn't fit in the output buffer.
+	///		Returns MFM_ERROR_INTERNAL if zlib failed.
+	/// </returns>
+	mfError mfmDeflate(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* compressedSize, mfmEnum compression, void* allocator);
+
+	/// <summary>
+	///		Gets the maximum size of a block compressed frame.
+	/// </summary>
+	/// <param name="dataSize">Uncompressed data size</param>
+	/// <param name="blockSize">Block size (set to 0 to use MFM_DEFLATE_BLOCKS_DEFAULT_BLOCK_SIZE)</param>
+	/// <returns>Maximum frame size</returns>
+	mfmU64 mfmGetDeflateBlocksBound(mfmU64 dataSize, mfmU64 blockSize);
+
+	/// <summary>
+	///		Compresses a whole buffer into a block compressed frame (see Compression.h), compressing the blocks in parallel.
+	/// </summary>
+	/// <param name="data">Data to compress</param>
+	/// <param name="dataSize">Data size</param>
+	/// <param name="out">Output buffer (mfmGetDeflateBlocksBound bytes are always enough)</param>
+	/// <param name="outSize">Output buffer size</param>
+	/// <param name="compressedSize">Out frame size</param>
+	/// <param name="blockSize">Block size, at most MFM_DEFLATE_BLOCKS_MAX_BLOCK_SIZE (set to 0 to use MFM_DEFLATE_BLOCKS_DEFAULT_BLOCK_SIZE)</param>
+	/// <param name="compression">Compression mode</param>
+	/// <param name="jobSystem">Job system where the blocks are compressed (set to NULL to compress them on the calling thread)</param>
+	/// <param name="allocator">Internal allocator (must be thread safe if a job system is used)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL, if the block size is too big or if the compression mode is invalid.
+	///		Returns MFM_ERROR_BUFFER_FULL if the frame doesn't fit in the output buffer.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mfmDeflateBlocks(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* compressedSize, mfmU64 blockSize, mfmEnum compression, mftJobSystem* jobSystem, void* allocator);
+
 #ifdef __cplusplus
 }
 #endif
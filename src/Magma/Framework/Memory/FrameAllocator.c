@@ -0,0 +1,154 @@
+#include "FrameAllocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(_Alignof(mfmLinearAllocator) <= MFM_FRAME_ALLOCATOR_ARENA_ALIGNMENT, u8"The arenas must be aligned for their linear allocators");
+_Static_assert(MFM_FRAME_ALLOCATOR_BASE_SIZE % MFM_FRAME_ALLOCATOR_ARENA_ALIGNMENT == 0, u8"The first arena must be aligned for its linear allocator");
+
+mfError mfmInternalFrameAllocate(void* allocator, void** memory, mfmU64 size)
+{
+	return mfmFrameAllocate((mfmFrameAllocator*)allocator, memory, size);
+}
+
+mfError mfmInternalFrameAllocateAligned(void* allocator, void** memory, mfmU64 size, mfmU64 alignment)
+{
+	return mfmFrameAllocateAligned((mfmFrameAllocator*)allocator, memory, size, alignment);
+}
+
+mfError mfmInternalFrameDeallocate(void* allocator, void* memory)
+{
+	// The memory is only reclaimed when the arena is reset
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmInternalFrameReallocate(void* allocator, void* memory, mfmU64 prevSize, mfmU64 size, void** newMemory)
+{
+	mfmFrameAllocator* frameAllocator = allocator;
+	mfmLinearAllocator* arena = frameAllocator->arenas[frameAllocator->currentArena];
+
+	// Resize in place if this is the last allocation on the current arena
+	if (arena->head - prevSize == memory)
+		return arena->base.reallocate(arena, memory, prevSize, size, newMemory);
+
+	mfError err = mfmFrameAllocate(frameAllocator, newMemory, size);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memcpy(*newMemory, memory, (size_t)(prevSize < size ? prevSize : size));
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfmInitFrameAllocator(mfmFrameAllocator** frameAllocator, mfmU64 arenaSize, mfmU64 arenaCount, mfmU8* memory, mfmBool onMemory)
+{
+	// Get data pointers
+	*frameAllocator = (mfmFrameAllocator*)(memory + 0);
+
+	// Init object
+	mfError err = mfmInitObject(&(*frameAllocator)->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	(*frameAllocator)->arenaCount = arenaCount;
+	(*frameAllocator)->currentArena = 0;
+	(*frameAllocator)->onMemory = onMemory;
+
+	// Create arenas
+	for (mfmU64 i = 0; i < arenaCount; ++i)
+	{
+		err = mfmCreateLinearAllocatorOnMemory(
+			&(*frameAllocator)->arenas[i],
+			arenaSize,
+			memory + MFM_FRAME_ALLOCATOR_BASE_SIZE + i * MFM_FRAME_ALLOCATOR_ARENA_STRIDE(arenaSize),
+			MFM_LINEAR_ALLOCATOR_SIZE(arenaSize));
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	// Set functions
+	(*frameAllocator)->base.allocate = &mfmInternalFrameAllocate;
+	(*frameAllocator)->base.deallocate = &mfmInternalFrameDeallocate;
+	(*frameAllocator)->base.reallocate = &mfmInternalFrameReallocate;
+	(*frameAllocator)->base.allocateAligned = &mfmInternalFrameAllocateAligned;
+	(*frameAllocator)->base.deallocateAligned = &mfmInternalFrameDeallocate;
+
+	// Set destructor function
+	(*frameAllocator)->base.object.destructorFunc = &mfmDestroyFrameAllocator;
+
+	// Successfully created a frame allocator
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmCreateFrameAllocator(mfmFrameAllocator ** frameAllocator, mfmU64 arenaSize, mfmU64 arenaCount)
+{
+	// Check if the arguments are valid
+	if (frameAllocator == NULL || arenaSize == 0 || arenaCount == 0 || arenaCount > MFM_FRAME_ALLOCATOR_MAX_ARENAS)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	// Allocate memory for the frame allocator and its arenas
+	mfmU8 * memory = NULL;
+	if (mfmAllocate(NULL, &memory, MFM_FRAME_ALLOCATOR_SIZE(arenaSize, arenaCount)) != MF_ERROR_OKAY)
+		return MFM_ERROR_ALLOCATION_FAILED;
+
+	mfError err = mfmInitFrameAllocator(frameAllocator, arenaSize, arenaCount, memory, MFM_FALSE);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeallocate(NULL, memory);
+		return err;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmCreateFrameAllocatorOnMemory(mfmFrameAllocator ** frameAllocator, mfmU64 arenaSize, mfmU64 arenaCount, void * memory, mfmU64 memorySize)
+{
+	// Check if the arguments are valid
+	if (frameAllocator == NULL || arenaSize == 0 || arenaCount == 0 || arenaCount > MFM_FRAME_ALLOCATOR_MAX_ARENAS ||
+		memory == NULL || memorySize < MFM_FRAME_ALLOCATOR_SIZE(arenaSize, arenaCount))
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	return mfmInitFrameAllocator(frameAllocator, arenaSize, arenaCount, (mfmU8*)memory, MFM_TRUE);
+}
+
+void mfmDestroyFrameAllocator(void * frameAllocator)
+{
+	if (frameAllocator == NULL)
+		abort();
+	if (mfmDeinitObject(&((mfmFrameAllocator*)frameAllocator)->base.object) != MF_ERROR_OKAY)
+		abort();
+
+	// The arenas live on the frame allocator memory
+	if (((mfmFrameAllocator*)frameAllocator)->onMemory == MFM_FALSE)
+		if (mfmDeallocate(NULL, frameAllocator) != MF_ERROR_OKAY)
+			abort();
+}
+
+mfError mfmFrameAllocate(mfmFrameAllocator * frameAllocator, void ** memory, mfmU64 size)
+{
+	if (frameAllocator == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	return mfmLinearAllocateAligned(frameAllocator->arenas[frameAllocator->currentArena], memory, size, MFM_FRAME_ALLOCATOR_DEFAULT_ALIGNMENT);
+}
+
+mfError mfmFrameAllocateAligned(mfmFrameAllocator * frameAllocator, void ** memory, mfmU64 size, mfmU64 alignment)
+{
+	if (frameAllocator == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	return mfmLinearAllocateAligned(frameAllocator->arenas[frameAllocator->currentArena], memory, size, alignment);
+}
+
+mfError mfmFrameEnd(mfmFrameAllocator * frameAllocator)
+{
+	if (frameAllocator == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	// Move to the next arena and reset it
+	frameAllocator->currentArena = (frameAllocator->currentArena + 1) % frameAllocator->arenaCount;
+	return mfmLinearReset(frameAllocator->arenas[frameAllocator->currentArena]);
+}
+
+mfmU64 mfmFrameGetHighWaterMark(mfmFrameAllocator * frameAllocator, mfmU64 arena)
+{
+	if (frameAllocator == NULL || arena >= frameAllocator->arenaCount)
+		return 0;
+	return mfmLinearGetHighWaterMark(frameAllocator->arenas[arena]);
+}
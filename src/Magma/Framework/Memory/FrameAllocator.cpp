@@ -0,0 +1,23 @@
+#include "FrameAllocator.hpp"
+#include "../ErrorString.h"
+
+void Magma::Framework::Memory::FrameAllocatorHandle::EndFrame()
+{
+	mfError err = mfmFrameEnd((mfmFrameAllocator*)this->GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+}
+
+mfmU64 Magma::Framework::Memory::FrameAllocatorHandle::GetHighWaterMark(mfmU64 arena)
+{
+	return mfmFrameGetHighWaterMark((mfmFrameAllocator*)this->GetNoChecks(), arena);
+}
+
+Magma::Framework::Memory::FrameAllocatorHandle Magma::Framework::Memory::CreateFrameAllocator(mfmU64 arenaSize, mfmU64 arenaCount)
+{
+	mfmFrameAllocator* alloc;
+	mfError err = mfmCreateFrameAllocator(&alloc, arenaSize, arenaCount);
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+	return alloc;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+	Implementation of a frame allocator in C.
+	A frame allocator has multiple linear allocators (arenas) and uses one per frame, rotating between them.
+	Memory allocated during a frame stays valid until the same arena is used again, so with N arenas the data of the last N - 1 frames is kept alive.
+	Deallocations do nothing, the memory is reclaimed when the arena is reset.
+*/
+
+#include "LinearAllocator.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MFM_FRAME_ALLOCATOR_MAX_ARENAS 4
+#define MFM_FRAME_ALLOCATOR_DEFAULT_ALIGNMENT 16
+
+	typedef struct
+	{
+		mfmAllocator base;
+		mfmU64 arenaCount;
+		mfmU64 currentArena;
+		mfmLinearAllocator* arenas[MFM_FRAME_ALLOCATOR_MAX_ARENAS];
+		mfmBool onMemory;
+	} mfmFrameAllocator;
+
+// Each arena starts with its linear allocator, so the arenas are placed on multiples of this alignment
+#define MFM_FRAME_ALLOCATOR_ARENA_ALIGNMENT 8
+#define MFM_FRAME_ALLOCATOR_ARENA_STRIDE(arenaSize) ((MFM_LINEAR_ALLOCATOR_SIZE(arenaSize) + MFM_FRAME_ALLOCATOR_ARENA_ALIGNMENT - 1) & ~(mfmU64)(MFM_FRAME_ALLOCATOR_ARENA_ALIGNMENT - 1))
+#define MFM_FRAME_ALLOCATOR_BASE_SIZE (sizeof(mfmFrameAllocator))
+#define MFM_FRAME_ALLOCATOR_SIZE(arenaSize, arenaCount) (MFM_FRAME_ALLOCATOR_BASE_SIZE + (arenaCount) * MFM_FRAME_ALLOCATOR_ARENA_STRIDE(arenaSize))
+
+	/// <summary>
+	///		Creates a new magma framework memory frame allocator.
+	/// </summary>
+	/// <param name="frameAllocator">Pointer to allocator pointer</param>
+	/// <param name="arenaSize">Size in bytes of each arena</param>
+	/// <param name="arenaCount">Number of arenas (between 1 and MFM_FRAME_ALLOCATOR_MAX_ARENAS)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_ALLOCATION_FAILED if the function couldn't allocate memory for the arenas.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the allocator pointer is null or the size or arena count are invalid.
+	/// </returns>
+	mfError mfmCreateFrameAllocator(mfmFrameAllocator** frameAllocator, mfmU64 arenaSize, mfmU64 arenaCount);
+
+	/// <summary>
+	///		Creates a new magma framework memory frame allocator.
+	/// </summary>
+	/// <param name="frameAllocator">Pointer to allocator pointer</param>
+	/// <param name="arenaSize">Size in bytes of each arena</param>
+	/// <param name="arenaCount">Number of arenas (between 1 and MFM_FRAME_ALLOCATOR_MAX_ARENAS)</param>
+	///	<param name="memory">Pointer to memory adress where the frame allocator will be created</param>
+	/// <param name="memorySize">Size of the reserved memory (get it with MFM_FRAME_ALLOCATOR_SIZE)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the allocator pointer is null, the size or arena count are invalid or if the allocator doesn't fit on the memory passed.
+	/// </returns>
+	mfError mfmCreateFrameAllocatorOnMemory(mfmFrameAllocator** frameAllocator, mfmU64 arenaSize, mfmU64 arenaCount, void* memory, mfmU64 memorySize);
+
+	/// <summary>
+	///		Destroys a magma framework memory frame allocator.
+	/// </summary>
+	/// <param name="frameAllocator">Frame allocator to destroy</param>
+	void mfmDestroyFrameAllocator(void* frameAllocator);
+
+	/// <summary>
+	///		Allocates on the current arena of a magma framework memory frame allocator.
+	///		The memory is aligned to MFM_FRAME_ALLOCATOR_DEFAULT_ALIGNMENT bytes.
+	/// </summary>
+	/// <param name="frameAllocator">Magma framework memory frame allocator</param>
+	/// <param name="memory">Pointer to allocated memory pointer</param>
+	/// <param name="size">Memory allocation size in bytes</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_ALLOCATOR_OVERFLOW if the current arena overflows.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS the frame allocator or memory are NULL or size is 0.
+	/// </returns>
+	mfError mfmFrameAllocate(mfmFrameAllocator* frameAllocator, void** memory, mfmU64 size);
+
+	/// <summary>
+	///		Allocates on the current arena of a magma framework memory frame allocator using a specified alignment.
+	/// </summary>
+	/// <param name="frameAllocator">Magma framework memory frame allocator</param>
+	/// <param name="memory">Pointer to allocated memory pointer</param>
+	/// <param name="size">Memory allocation size in bytes</param>
+	/// <param name="alignment">Memory alignment in bytes (must be a power of two)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_ALLOCATOR_OVERFLOW if the current arena overflows.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS the frame allocator or memory are NULL, size is 0 or the alignment isn't a power of two.
+	/// </returns>
+	mfError mfmFrameAllocateAligned(mfmFrameAllocator* frameAllocator, void** memory, mfmU64 size, mfmU64 alignment);
+
+	/// <summary>
+	///		Ends the current frame on a magma framework memory frame allocator.
+	///		Moves to the next arena and resets it, invalidating the memory allocated on it arenaCount frames ago.
+	/// </summary>
+	/// <param name="frameAllocator">Magma framework memory frame allocator</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS the frame allocator is NULL.
+	/// </returns>
+	mfError mfmFrameEnd(mfmFrameAllocator* frameAllocator);
+
+	/// <summary>
+	///		Gets the maximum number of bytes used on a frame allocator arena during a single frame.
+	/// </summary>
+	/// <param name="frameAllocator">Magma framework memory frame allocator</param>
+	/// <param name="arena">Arena index</param>
+	/// <returns>High water mark in bytes (0 if the arena index is invalid)</returns>
+	mfmU64 mfmFrameGetHighWaterMark(mfmFrameAllocator* frameAllocator, mfmU64 arena);
+
+#ifdef __cplusplus
+}
+#endif
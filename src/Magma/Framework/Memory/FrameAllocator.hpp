@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Exception.hpp"
+#include "Allocator.hpp"
+#include "FrameAllocator.h"
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace Memory
+		{
+			/// <summary>
+			///		Encapsulates the magma framework C frame allocator declared on FrameAllocator.h.
+			/// </summary>
+			class FrameAllocatorHandle final : public HAllocator
+			{
+			public:
+				using HAllocator::HAllocator;
+
+				/// <summary>
+				///		Ends the current frame, moving to the next arena and resetting it.
+				/// </summary>
+				void EndFrame();
+
+				/// <summary>
+				///		Gets the maximum number of bytes used on an arena during a single frame.
+				/// </summary>
+				/// <param name="arena">Arena index</param>
+				/// <returns>High water mark in bytes</returns>
+				mfmU64 GetHighWaterMark(mfmU64 arena);
+			};
+
+			/// <summary>
+			///		Creates a frame allocator.
+			/// </summary>
+			/// <param name="arenaSize">Size of each arena in bytes</param>
+			/// <param name="arenaCount">Number of arenas</param>
+			/// <returns>Frame allocator handle</returns>
+			FrameAllocatorHandle CreateFrameAllocator(mfmU64 arenaSize, mfmU64 arenaCount = 2);
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #include "Handle.hpp"
+#include "Config.h"
 #include "Exception.hpp"
 
 #include <cstdlib>
@@ -38,19 +39,18 @@ Magma::Framework::Memory::Handle::Handle(const Handle & rhs)
 	}
 }
 
-Magma::Framework::Memory::Handle::Handle(Handle && rhs)
-{
-	m_obj = rhs.m_obj;
-	rhs.m_obj = nullptr;
-}
-
 Magma::Framework::Memory::Handle::~Handle()
 {
 	if (m_obj != nullptr)
 	{
+		// Same policy as the move assignment, the error is only checked on debug builds
 		mfError err = mfmReleaseObject(m_obj);
+#ifdef MAGMA_FRAMEWORK_DEBUG
 		if (err != MF_ERROR_OKAY)
 			abort();
+#else
+		(void)err;
+#endif
 	}
 }
 
@@ -95,12 +95,44 @@ Magma::Framework::Memory::Handle & Magma::Framework::Memory::Handle::operator=(m
 	return *this;
 }
 
-Magma::Framework::Memory::Handle & Magma::Framework::Memory::Handle::operator=(Handle obj)
+Magma::Framework::Memory::Handle & Magma::Framework::Memory::Handle::operator=(const Handle& obj)
+{
+	// Acquire the new object first, in case both handles point to the same object
+	if (obj.m_obj != nullptr)
+	{
+		mfError err = mfmAcquireObject(obj.m_obj);
+		if (err != MF_ERROR_OKAY)
+			throw ObjectError("Failed to increase object reference count");
+	}
+	mfmObject* old = m_obj;
+	m_obj = obj.m_obj;
+	if (old != nullptr)
+	{
+		mfError err = mfmReleaseObject(old);
+		if (err != MF_ERROR_OKAY)
+			throw ObjectError("Failed to decrease object reference count");
+	}
+	return *this;
+}
+
+Magma::Framework::Memory::Handle & Magma::Framework::Memory::Handle::operator=(Handle && obj) noexcept
 {
-	if (obj.GetNoChecks() == nullptr)
-		this->Release();
-	else
-		this->Set(obj.Get());
+	if (this == &obj)
+		return *this;
+	mfmObject* old = m_obj;
+	m_obj = obj.m_obj;
+	obj.m_obj = nullptr;
+	if (old != nullptr)
+	{
+		// This can't throw, and releasing only fails on invalid objects, so the error is only checked on debug builds
+		mfError err = mfmReleaseObject(old);
+#ifdef MAGMA_FRAMEWORK_DEBUG
+		if (err != MF_ERROR_OKAY)
+			abort();
+#else
+		(void)err;
+#endif
+	}
 	return *this;
 }
 
@@ -2,6 +2,8 @@
 
 #include "Object.h"
 
+#include <type_traits>
+
 namespace Magma
 {
 	namespace Framework
@@ -11,6 +13,8 @@ namespace Magma
 			/// <summary>
 			///		Used as an object handle.
 			///		Destroys the object automatically when there are no more references to it.
+			///		Has no virtual functions and only holds a pointer to the object, so it has the size of a pointer.
+			///		Moving a handle doesn't change the object's reference count.
 			/// </summary>
 			class Handle
 			{
@@ -19,8 +23,8 @@ namespace Magma
 				Handle(mfmObject& obj);
 				Handle(void* obj);
 				Handle(const Handle& rhs);
-				Handle(Handle&& rhs);
-				virtual ~Handle();
+				inline Handle(Handle&& rhs) noexcept : m_obj(rhs.m_obj) { rhs.m_obj = nullptr; }
+				~Handle();
 
 				/// <summary>
 				///		Sets a new object to where this handle will point.
@@ -42,7 +46,8 @@ namespace Magma
 				mfmObject& Get() const;
 
 				Handle& operator=(mfmObject& obj);
-				Handle& operator=(Handle obj);
+				Handle& operator=(const Handle& obj);
+				Handle& operator=(Handle&& obj) noexcept;
 				mfmObject* operator->() const;
 
 				/// <summary>
@@ -55,6 +60,47 @@ namespace Magma
 			private:
 				mfmObject* m_obj;
 			};
+
+			/// <summary>
+			///		Typed object handle.
+			///		T must be a C object type which starts with an mfmObject (the reference count is stored in the object itself).
+			///		Arrays of typed handles have the same layout as arrays of T pointers, so they can be passed to the C API directly.
+			/// </summary>
+			template<typename T>
+			class TypedHandle : public Handle
+			{
+			public:
+				using Handle::operator=;
+
+				inline TypedHandle(T* obj = nullptr) : Handle(static_cast<void*>(obj)) {}
+				explicit inline TypedHandle(const Handle& object) : Handle(object) {}
+
+				/// <summary>
+				///		Gets the currently set object (throws error when there isn't an object set).
+				/// </summary>
+				/// <returns>Reference to the currently set object</returns>
+				inline T& Get() const { return *reinterpret_cast<T*>(&Handle::Get()); }
+
+				/// <summary>
+				///		Gets a pointer to the currently set object without checking if it is NULL or not.
+				///		USE WITH CAUTION.
+				/// </summary>
+				/// <returns>Currently set pointer</returns>
+				inline T* GetNoChecks() const { return reinterpret_cast<T*>(Handle::GetNoChecks()); }
+
+				inline T* operator->() const { return &this->Get(); }
+
+				/// <summary>
+				///		Gets an array of handles as an array of object pointers, without changing their reference counts.
+				///		The returned array is only valid while the handles are.
+				/// </summary>
+				/// <param name="handles">Handle array</param>
+				/// <returns>Object pointer array</returns>
+				inline static T** GetArray(TypedHandle* handles) { return reinterpret_cast<T**>(handles); }
+			};
+
+			static_assert(sizeof(Handle) == sizeof(void*), "Memory::Handle must have the size of a pointer");
+			static_assert(std::is_standard_layout<TypedHandle<mfmObject>>::value, "Memory::TypedHandle must be standard layout");
 		}
 	}
 }
\ No newline at end of file
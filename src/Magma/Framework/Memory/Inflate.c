@@ -1,16 +1,50 @@
 #include "Inflate.h"
 
 #include "../Memory/Allocator.h"
+#include "../Memory/Endianness.h"
+#include "LZ.h"
 
 #include <zlib.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+
+/*
+	The stream buffer is a ring buffer: the decompressed data starts at readHead and is size bytes long, wrapping around the end
+	of the buffer, so reads never have to move the data left in the buffer.
+	zlib may hold decompressed data which didn't fit in the buffer, in which case pending is set and it is written on the next read.
+	The format is picked from the first byte written: compressed frames (see Compression.h) start with the frame magic, which is
+	never a valid zlib header. LZ frames are decoded a unit at a time (the frame header, a block size word or a block), which is
+	gathered in lzInput if it isn't written all at once, and each decompressed block is kept in lzOutput until it is moved to the
+	stream buffer. Like deflate streams, they use the zlib input fields as their input cursor.
+*/
+
+#define MFM_INFLATE_FORMAT_UNKNOWN		0x00
+#define MFM_INFLATE_FORMAT_ZLIB			0x01
+#define MFM_INFLATE_FORMAT_LZ			0x02
+
+#define MFM_INFLATE_LZ_HEADER			0x00
+#define MFM_INFLATE_LZ_BLOCK_SIZE		0x01
+#define MFM_INFLATE_LZ_BLOCK			0x02
 
 typedef struct
 {
 	mfsStream base;
 	z_stream stream;
-	mfmU64 bufferHead;
+	void* allocator;
+	mfmU64 readHead;
+	mfmU64 size;
+	mfmBool pending;
+	mfmBool ended;
+	mfmEnum format;
+	mfmEnum lzState;
+	mfmU32 lzBlockWord;
+	mfmU8* lzInput;
+	mfmU64 lzInputSize;
+	mfmU64 lzRequiredSize;
+	mfmU8* lzOutput;
+	mfmU64 lzOutputHead;
+	mfmU64 lzOutputSize;
 } mfmInflateStream;
 
 static voidpf mfmInflateAllocate(voidpf opaque, uInt items, uInt size)
@@ -29,6 +63,200 @@ static void mfmInflateDeallocate(voidpf opaque, voidpf address)
 		abort();
 }
 
+// Gets the free contiguous space after the data on the ring buffer
+static mfmU8* mfmGetInflateFreeSpace(mfmInflateStream* stream, mfmU64* freeSize)
+{
+	if (stream->size == 0)
+		stream->readHead = 0;
+
+	mfmU64 tail = stream->readHead + stream->size;
+	if (tail >= stream->base.bufferSize)
+	{
+		tail -= stream->base.bufferSize;
+		*freeSize = stream->readHead - tail;
+	}
+	else
+		*freeSize = stream->base.bufferSize - tail;
+	return stream->base.buffer + tail;
+}
+
+static mfmU32 mfmReadLZU32(const mfmU8* data)
+{
+	return (mfmU32)data[0] | ((mfmU32)data[1] << 8) | ((mfmU32)data[2] << 16) | ((mfmU32)data[3] << 24);
+}
+
+static mfmBool mfmIsCompressedFrame(const mfmU8* data, mfmU64 dataSize)
+{
+	return (dataSize > 0 && data[0] == MFM_COMPRESSED_FRAME_MAGIC[0]) ? MFM_TRUE : MFM_FALSE;
+}
+
+static mfError mfmCheckLZFrameHeader(const mfmU8* data)
+{
+	if (memcmp(data, MFM_COMPRESSED_FRAME_MAGIC, 4) != 0 || data[4] != MFM_CODEC_LZ || data[5] != MFM_LZ_VERSION)
+		return MFM_ERROR_INTERNAL;
+	return MF_ERROR_OKAY;
+}
+
+// Gets the block data size from a block size word, or returns MFM_FALSE if it is invalid
+static mfmBool mfmGetLZBlockDataSize(mfmU32 word, mfmU64* dataSize)
+{
+	*dataSize = word & ~MFM_LZ_STORED_BLOCK;
+	return (*dataSize != 0 && *dataSize <= MFM_LZ_BLOCK_SIZE) ? MFM_TRUE : MFM_FALSE;
+}
+
+// Decodes a complete unit (the frame header, a block size word or a block) of an LZ frame
+static mfError mfmDecodeLZUnit(mfmInflateStream* stream, const mfmU8* unit)
+{
+	if (stream->lzState == MFM_INFLATE_LZ_HEADER)
+	{
+		if (mfmCheckLZFrameHeader(unit) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+		stream->lzState = MFM_INFLATE_LZ_BLOCK_SIZE;
+		stream->lzRequiredSize = sizeof(mfmU32);
+	}
+	else if (stream->lzState == MFM_INFLATE_LZ_BLOCK_SIZE)
+	{
+		stream->lzBlockWord = mfmReadLZU32(unit);
+		if (stream->lzBlockWord == 0)
+		{
+			stream->ended = MFM_TRUE;
+			return MF_ERROR_OKAY;
+		}
+		if (mfmGetLZBlockDataSize(stream->lzBlockWord, &stream->lzRequiredSize) == MFM_FALSE)
+			return MFM_ERROR_INTERNAL;
+		stream->lzState = MFM_INFLATE_LZ_BLOCK;
+	}
+	else
+	{
+		if ((stream->lzBlockWord & MFM_LZ_STORED_BLOCK) != 0)
+		{
+			memcpy(stream->lzOutput, unit, stream->lzRequiredSize);
+			stream->lzOutputSize = stream->lzRequiredSize;
+		}
+		else if (mfmLZDecompressBlock(unit, stream->lzRequiredSize, stream->lzOutput, MFM_LZ_BLOCK_SIZE, &stream->lzOutputSize) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+		stream->lzOutputHead = 0;
+		stream->lzState = MFM_INFLATE_LZ_BLOCK_SIZE;
+		stream->lzRequiredSize = sizeof(mfmU32);
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+// Same as mfmPumpInflateStream, for LZ frames
+static mfError mfmPumpLZInflateStream(mfmInflateStream* stream)
+{
+	for (;;)
+	{
+		// Move the decompressed data to the stream buffer
+		while (stream->lzOutputSize > 0)
+		{
+			mfmU64 freeSize;
+			mfmU8* out = mfmGetInflateFreeSpace(stream, &freeSize);
+			if (freeSize == 0)
+			{
+				stream->pending = MFM_TRUE;
+				return MFM_ERROR_BUFFER_FULL;
+			}
+
+			mfmU64 size = freeSize < stream->lzOutputSize ? freeSize : stream->lzOutputSize;
+			memcpy(out, stream->lzOutput + stream->lzOutputHead, size);
+			stream->size += size;
+			stream->lzOutputHead += size;
+			stream->lzOutputSize -= size;
+		}
+		stream->pending = MFM_FALSE;
+
+		if (stream->ended != MFM_FALSE)
+			return MF_ERROR_OKAY;
+
+		// Units which are written all at once are decoded straight from the input
+		const mfmU8* unit;
+		if (stream->lzInputSize == 0 && stream->stream.avail_in >= stream->lzRequiredSize)
+			unit = stream->stream.next_in;
+		else
+		{
+			if (stream->stream.avail_in == 0)
+				return MF_ERROR_OKAY;
+			mfmU64 size = stream->lzRequiredSize - stream->lzInputSize;
+			if (size > stream->stream.avail_in)
+				size = stream->stream.avail_in;
+			memcpy(stream->lzInput + stream->lzInputSize, stream->stream.next_in, size);
+			stream->lzInputSize += size;
+			stream->stream.next_in += size;
+			stream->stream.avail_in -= (uInt)size;
+			if (stream->lzInputSize < stream->lzRequiredSize)
+				return MF_ERROR_OKAY;
+			unit = stream->lzInput;
+		}
+
+		mfmU64 unitSize = stream->lzRequiredSize;
+		mfError err = mfmDecodeLZUnit(stream, unit);
+		if (err != MF_ERROR_OKAY)
+			return err;
+		if (unit == stream->lzInput)
+			stream->lzInputSize = 0;
+		else
+		{
+			stream->stream.next_in += unitSize;
+			stream->stream.avail_in -= (uInt)unitSize;
+		}
+	}
+}
+
+// Runs inflate on the current input until it is consumed and all its output is written, or the buffer is full
+static mfError mfmPumpInflateStream(mfmInflateStream* stream)
+{
+	if (stream->format == MFM_INFLATE_FORMAT_UNKNOWN)
+	{
+		if (stream->stream.avail_in == 0)
+			return MF_ERROR_OKAY;
+
+		if (mfmIsCompressedFrame(stream->stream.next_in, stream->stream.avail_in) == MFM_FALSE)
+			stream->format = MFM_INFLATE_FORMAT_ZLIB;
+		else
+		{
+			// The input buffer fits any unit, and the output buffer a whole block
+			mfError err = mfmAllocate(stream->allocator, &stream->lzInput, 2 * MFM_LZ_BLOCK_SIZE);
+			if (err != MF_ERROR_OKAY)
+				return err;
+			stream->lzOutput = stream->lzInput + MFM_LZ_BLOCK_SIZE;
+			stream->format = MFM_INFLATE_FORMAT_LZ;
+		}
+	}
+
+	if (stream->format == MFM_INFLATE_FORMAT_LZ)
+		return mfmPumpLZInflateStream(stream);
+
+	for (;;)
+	{
+		mfmU64 freeSize;
+		mfmU8* out = mfmGetInflateFreeSpace(stream, &freeSize);
+		if (freeSize == 0)
+			return MFM_ERROR_BUFFER_FULL;
+
+		stream->stream.next_out = out;
+		stream->stream.avail_out = freeSize > UINT_MAX ? UINT_MAX : (uInt)freeSize;
+		uInt outAvailable = stream->stream.avail_out;
+		int ret = inflate(&stream->stream, Z_NO_FLUSH);
+		stream->size += outAvailable - stream->stream.avail_out;
+
+		if (ret == Z_STREAM_END)
+		{
+			stream->pending = MFM_FALSE;
+			stream->ended = MFM_TRUE;
+			return MF_ERROR_OKAY;
+		}
+		if (ret != Z_OK && ret != Z_BUF_ERROR)
+			return MFM_ERROR_INTERNAL;
+
+		// If inflate didn't fill the output, the input was consumed
+		stream->pending = stream->stream.avail_out == 0 ? MFM_TRUE : MFM_FALSE;
+		if (stream->pending == MFM_FALSE)
+			return MF_ERROR_OKAY;
+	}
+}
+
 static mfError mfmFlush(void* stream)
 {
 	return MF_ERROR_OKAY;
@@ -36,64 +264,140 @@ static mfError mfmFlush(void* stream)
 
 static mfError mfmRead(void* stream, mfmU8* buffer, mfmU64 bufferSize, mfmU64* readSize)
 {
-	mfmInflateStream* defStream = stream;
+	mfmInflateStream* infStream = stream;
+	mfmU64 totalSize = 0;
 
-	if (bufferSize >= defStream->bufferHead)
+	while (totalSize < bufferSize)
 	{
-		memcpy(buffer, defStream->base.buffer, defStream->bufferHead);
-		if (readSize != NULL)
-			*readSize = defStream->bufferHead;
-		defStream->bufferHead = 0;
+		// Decompressed data held by zlib is written to the buffer once there is space for it
+		if (infStream->size == 0 && infStream->pending != MFM_FALSE)
+		{
+			infStream->stream.next_in = NULL;
+			infStream->stream.avail_in = 0;
+			mfError err = mfmPumpInflateStream(infStream);
+			if (err != MF_ERROR_OKAY && err != MFM_ERROR_BUFFER_FULL)
+				return err;
+		}
+
+		if (infStream->size == 0)
+			break;
+
+		// Copy the data up to the end of the buffer, and wrap around on the next iteration
+		mfmU64 size = infStream->base.bufferSize - infStream->readHead;
+		if (size > infStream->size)
+			size = infStream->size;
+		if (size > bufferSize - totalSize)
+			size = bufferSize - totalSize;
+		memcpy(buffer + totalSize, infStream->base.buffer + infStream->readHead, size);
+		totalSize += size;
+		infStream->readHead += size;
+		if (infStream->readHead == infStream->base.bufferSize)
+			infStream->readHead = 0;
+		infStream->size -= size;
 	}
-	else
+
+	if (readSize != NULL)
+		*readSize = totalSize;
+	if (totalSize == 0 && infStream->ended != MFM_FALSE)
+		return MFS_ERROR_EOF;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfmGetSpan(void* stream, mfmU64 size, const mfmU8** data, mfmU64* outSize)
+{
+	mfmInflateStream* infStream = stream;
+
+	if (infStream->size == 0 && infStream->pending != MFM_FALSE)
 	{
-		memcpy(buffer, defStream->base.buffer, bufferSize);
-		memcpy(defStream->base.buffer, defStream->base.buffer + bufferSize, defStream->bufferHead - bufferSize);
-		defStream->bufferHead -= bufferSize;
-		if (readSize != NULL)
-			*readSize = bufferSize;
+		infStream->stream.next_in = NULL;
+		infStream->stream.avail_in = 0;
+		mfError err = mfmPumpInflateStream(infStream);
+		if (err != MF_ERROR_OKAY && err != MFM_ERROR_BUFFER_FULL)
+			return err;
 	}
 
+	if (infStream->size == 0 && infStream->ended != MFM_FALSE)
+		return MFS_ERROR_EOF;
+
+	// The span is the contiguous data up to the end of the buffer, which stays valid until the next write
+	mfmU64 contiguous = infStream->base.bufferSize - infStream->readHead;
+	if (contiguous > infStream->size)
+		contiguous = infStream->size;
+	if (size > contiguous)
+		size = contiguous;
+
+	*data = infStream->base.buffer + infStream->readHead;
+	*outSize = size;
+	infStream->readHead += size;
+	if (infStream->readHead == infStream->base.bufferSize)
+		infStream->readHead = 0;
+	infStream->size -= size;
 	return MF_ERROR_OKAY;
 }
 
 static mfError mfmWrite(void* stream, const mfmU8* buffer, mfmU64 bufferSize, mfmU64* writeSize)
 {
-	mfmInflateStream* defStream = stream;
-	defStream->stream.avail_in = bufferSize;
-	defStream->stream.next_in = buffer;
-	defStream->stream.avail_out = defStream->base.bufferSize - defStream->bufferHead;
-	defStream->stream.next_out = defStream->base.buffer + defStream->bufferHead;
+	mfmInflateStream* infStream = stream;
+	if (infStream->ended != MFM_FALSE)
+	{
+		if (writeSize != NULL)
+			*writeSize = 0;
+		return MFS_ERROR_EOF;
+	}
 
-	if (defStream->stream.avail_out == 0)
-		return MFM_ERROR_BUFFER_FULL;
+	// zlib sizes are 32 bits wide, so bigger buffers are fed in pieces
+	mfmU64 writtenSize = 0;
+	mfError err = MF_ERROR_OKAY;
+	while (writtenSize < bufferSize && infStream->ended == MFM_FALSE)
+	{
+		mfmU64 left = bufferSize - writtenSize;
+		infStream->stream.next_in = (Bytef*)(buffer + writtenSize);
+		infStream->stream.avail_in = left > UINT_MAX ? UINT_MAX : (uInt)left;
+		uInt inAvailable = infStream->stream.avail_in;
+		err = mfmPumpInflateStream(infStream);
+		writtenSize += inAvailable - infStream->stream.avail_in;
+		if (err != MF_ERROR_OKAY)
+			break;
+	}
 
-	int err = inflate(&defStream->stream, Z_NO_FLUSH);
-	if (err != Z_OK)
-		return MFM_ERROR_INTERNAL;
-	defStream->bufferHead += (defStream->base.bufferSize - defStream->bufferHead) - defStream->stream.avail_out;
+	infStream->stream.next_in = NULL;
+	infStream->stream.avail_in = 0;
 
 	if (writeSize != NULL)
-		*writeSize = bufferSize - defStream->stream.avail_in;
+		*writeSize = writtenSize;
 
+	// Partial writes succeed, the caller must read the decompressed data and write the rest
+	if (err == MFM_ERROR_BUFFER_FULL && writtenSize != 0)
+		return MF_ERROR_OKAY;
+	return err;
+}
+
+static mfError mfmEOF(void* stream, mfmBool* eof)
+{
+	mfmInflateStream* infStream = stream;
+	*eof = (infStream->ended != MFM_FALSE && infStream->size == 0) ? MFM_TRUE : MFM_FALSE;
 	return MF_ERROR_OKAY;
 }
 
 static mfError mfmSetBuffer(void* stream, mfmU8* buffer, mfmU64 bufferSize)
 {
-	mfmInflateStream* defStream = stream;
+	mfmInflateStream* infStream = stream;
 
-	if (defStream->bufferHead != 0)
+	if (infStream->size != 0)
 		return MFM_ERROR_BUFFER_FULL;
 
-	defStream->base.buffer = buffer;
-	defStream->base.bufferSize = bufferSize;
+	infStream->base.buffer = buffer;
+	infStream->base.bufferSize = bufferSize;
+	infStream->readHead = 0;
 
 	return MF_ERROR_OKAY;
 }
 
 mfError mfmCreateInflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bufferSize, void * allocator)
 {
+	if (outStream == NULL || buffer == NULL || bufferSize == 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
 	mfError err;
 
 	mfmInflateStream* stream;
@@ -102,6 +406,17 @@ mfError mfmCreateInflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bu
 	if (err != MF_ERROR_OKAY)
 		return err;
 
+	stream->stream.zalloc = &mfmInflateAllocate;
+	stream->stream.zfree = &mfmInflateDeallocate;
+	stream->stream.opaque = allocator;
+	stream->stream.next_in = NULL;
+	stream->stream.avail_in = 0;
+	if (inflateInit(&stream->stream) != Z_OK)
+	{
+		mfmDeallocate(allocator, stream);
+		return MFM_ERROR_INTERNAL;
+	}
+
 	err = mfmInitObject(&stream->base.object);
 	if (err != MF_ERROR_OKAY)
 		return err;
@@ -109,7 +424,20 @@ mfError mfmCreateInflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bu
 
 	stream->base.buffer = buffer;
 	stream->base.bufferSize = bufferSize;
-	stream->bufferHead = 0;
+	stream->allocator = allocator;
+	stream->readHead = 0;
+	stream->size = 0;
+	stream->pending = MFM_FALSE;
+	stream->ended = MFM_FALSE;
+	stream->format = MFM_INFLATE_FORMAT_UNKNOWN;
+	stream->lzState = MFM_INFLATE_LZ_HEADER;
+	stream->lzBlockWord = 0;
+	stream->lzInput = NULL;
+	stream->lzInputSize = 0;
+	stream->lzRequiredSize = MFM_COMPRESSED_FRAME_HEADER_SIZE;
+	stream->lzOutput = NULL;
+	stream->lzOutputHead = 0;
+	stream->lzOutputSize = 0;
 
 	stream->base.flush = &mfmFlush;
 	stream->base.read = &mfmRead;
@@ -119,23 +447,346 @@ mfError mfmCreateInflateStream(mfsStream ** outStream, mfmU8 * buffer, mfmU64 bu
 	stream->base.seekEnd = NULL;
 	stream->base.seekHead = NULL;
 	stream->base.tell = NULL;
-	stream->base.eof = NULL;
+	stream->base.eof = &mfmEOF;
+	stream->base.getSpan = &mfmGetSpan;
 
-	stream->stream.zalloc = &mfmInflateAllocate;
-	stream->stream.zfree = &mfmInflateDeallocate;
-	stream->stream.opaque = allocator;
+	*outStream = stream;
 
-	if (inflateInit(&stream->stream) != Z_OK)
+	return MF_ERROR_OKAY;
+}
+
+void mfmDestroyInflateStream(mfsStream * stream)
+{
+	if (stream == NULL)
+		abort();
+
+	mfmInflateStream* infStream = stream;
+
+	inflateEnd(&infStream->stream);
+	if (infStream->lzInput != NULL && mfmDeallocate(infStream->allocator, infStream->lzInput) != MF_ERROR_OKAY)
+		abort();
+
+	if (mfmDeinitObject(&infStream->base.object) != MF_ERROR_OKAY)
+		abort();
+	if (mfmDeallocate(infStream->allocator, infStream) != MF_ERROR_OKAY)
+		abort();
+}
+
+// Same as mfmInflate, for LZ frames
+static mfError mfmInflateLZ(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* decompressedSize)
+{
+	if (dataSize < MFM_COMPRESSED_FRAME_HEADER_SIZE || mfmCheckLZFrameHeader(data) != MF_ERROR_OKAY)
 		return MFM_ERROR_INTERNAL;
 
-	*outStream = stream;
+	// Blocks are decompressed straight to the output
+	mfmU64 offset = MFM_COMPRESSED_FRAME_HEADER_SIZE;
+	mfmU64 size = 0;
+	for (;;)
+	{
+		if (dataSize - offset < sizeof(mfmU32))
+			return MFM_ERROR_INTERNAL;
+		mfmU32 word = mfmReadLZU32(data + offset);
+		offset += sizeof(mfmU32);
+		if (word == 0)
+			break;
 
+		mfmU64 blockDataSize;
+		if (mfmGetLZBlockDataSize(word, &blockDataSize) == MFM_FALSE || blockDataSize > dataSize - offset)
+			return MFM_ERROR_INTERNAL;
+
+		mfmU64 blockSize;
+		if ((word & MFM_LZ_STORED_BLOCK) != 0)
+		{
+			if (outSize - size < blockDataSize)
+				return MFM_ERROR_BUFFER_FULL;
+			memcpy(out + size, data + offset, blockDataSize);
+			blockSize = blockDataSize;
+		}
+		else
+		{
+			// Blocks can't decompress to more than the block size, so only a smaller output can be full
+			mfmU64 available = outSize - size;
+			mfError err = mfmLZDecompressBlock(data + offset, blockDataSize, out + size, available < MFM_LZ_BLOCK_SIZE ? available : MFM_LZ_BLOCK_SIZE, &blockSize);
+			if (err == MFM_ERROR_BUFFER_FULL && available >= MFM_LZ_BLOCK_SIZE)
+				return MFM_ERROR_INTERNAL;
+			if (err != MF_ERROR_OKAY)
+				return err;
+		}
+
+		offset += blockDataSize;
+		size += blockSize;
+	}
+
+	*decompressedSize = size;
 	return MF_ERROR_OKAY;
 }
 
-void mfmDestroyInflateStream(mfsStream * stream)
+mfError mfmInflate(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* decompressedSize, void* allocator)
+{
+	if (data == NULL || out == NULL || decompressedSize == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	if (mfmIsCompressedFrame(data, dataSize) != MFM_FALSE)
+		return mfmInflateLZ(data, dataSize, out, outSize, decompressedSize);
+
+	z_stream stream;
+	stream.zalloc = &mfmInflateAllocate;
+	stream.zfree = &mfmInflateDeallocate;
+	stream.opaque = allocator;
+	stream.next_in = (Bytef*)data;
+	stream.avail_in = 0;
+	if (inflateInit(&stream) != Z_OK)
+		return MFM_ERROR_INTERNAL;
+
+	// zlib sizes are 32 bits wide, so bigger buffers are fed in pieces
+	stream.next_out = out;
+	stream.avail_out = 0;
+	mfmU64 inLeft = dataSize;
+	mfmU64 outLeft = outSize;
+	int ret;
+	do
+	{
+		if (stream.avail_in == 0 && inLeft > 0)
+		{
+			stream.avail_in = inLeft > UINT_MAX ? UINT_MAX : (uInt)inLeft;
+			inLeft -= stream.avail_in;
+		}
+		if (stream.avail_out == 0)
+		{
+			if (outLeft == 0)
+			{
+				// The output may be exactly full with only the end of the stream left, which is checked with a spare byte
+				mfmU8 spare;
+				stream.next_out = &spare;
+				stream.avail_out = 1;
+				ret = inflate(&stream, Z_NO_FLUSH);
+				if (ret == Z_STREAM_END && stream.avail_out == 1)
+					break;
+				inflateEnd(&stream);
+				return ret == Z_OK || ret == Z_STREAM_END ? MFM_ERROR_BUFFER_FULL : MFM_ERROR_INTERNAL;
+			}
+			stream.avail_out = outLeft > UINT_MAX ? UINT_MAX : (uInt)outLeft;
+			outLeft -= stream.avail_out;
+		}
+
+		ret = inflate(&stream, Z_NO_FLUSH);
+	} while (ret == Z_OK || (ret == Z_BUF_ERROR && stream.avail_out == 0));
+
+	*decompressedSize = stream.total_out;
+	inflateEnd(&stream);
+	if (ret != Z_STREAM_END)
+		return MFM_ERROR_INTERNAL;
+	return MF_ERROR_OKAY;
+}
+
+typedef struct
+{
+	const mfmU8* data;
+	mfmU64 dataSize;
+	mfmU8* out;
+	mfmU64 outSize;
+	void* allocator;
+	mfError err;
+} mfmInflateBlockJob;
+
+typedef struct
+{
+	mfmU64 blockSize;
+	mfmU64 size;
+	mfmU64 blockCount;
+	const mfmU8* table;
+} mfmInflateBlocksFrame;
+
+static void mfmInflateBlockJobFunction(void* args)
+{
+	mfmInflateBlockJob* job = args;
+	mfmU64 decompressedSize;
+	job->err = mfmInflate(job->data, job->dataSize, job->out, job->outSize, &decompressedSize, job->allocator);
+	if (job->err == MF_ERROR_OKAY && decompressedSize != job->outSize)
+		job->err = MFM_ERROR_INTERNAL;
+	else if (job->err == MFM_ERROR_BUFFER_FULL)
+		job->err = MFM_ERROR_INTERNAL; // Blocks can't be bigger than the block size
+}
+
+// Values are copied through locals since they may be unaligned
+static mfmU64 mfmReadInflateBlocksU64(const mfmU8* data)
 {
-	mfmInflateStream* defStream = stream;
+	mfmU64 raw, value;
+	memcpy(&raw, data, sizeof(raw));
+	mfmFromLittleEndian8(&raw, &value);
+	return value;
+}
+
+// Validates the header and the seek table of a block compressed frame
+static mfError mfmReadInflateBlocksFrame(const mfmU8* data, mfmU64 dataSize, mfmInflateBlocksFrame* frame)
+{
+	if (dataSize < MFM_DEFLATE_BLOCKS_HEADER_SIZE || memcmp(data, u8"MFDB", 4) != 0)
+		return MFM_ERROR_INTERNAL;
+
+	mfmU32 raw, version;
+	memcpy(&raw, data + 4, sizeof(raw));
+	mfmFromLittleEndian4(&raw, &version);
+	if (version != MFM_DEFLATE_BLOCKS_VERSION)
+		return MFM_ERROR_INTERNAL;
+
+	frame->blockSize = mfmReadInflateBlocksU64(data + 8);
+	frame->size = mfmReadInflateBlocksU64(data + 16);
+	frame->blockCount = mfmReadInflateBlocksU64(data + 24);
+	frame->table = data + MFM_DEFLATE_BLOCKS_HEADER_SIZE;
+
+	// Bounding the block size also bounds the temporary buffer mfmInflateBlocksRange allocates for a partial block
+	if (frame->blockSize == 0 || frame->blockSize > MFM_DEFLATE_BLOCKS_MAX_BLOCK_SIZE)
+		return MFM_ERROR_INTERNAL;
+	if (frame->blockCount != frame->size / frame->blockSize + (frame->size % frame->blockSize != 0))
+		return MFM_ERROR_INTERNAL;
+	if (frame->blockCount >= (dataSize - MFM_DEFLATE_BLOCKS_HEADER_SIZE) / sizeof(mfmU64))
+		return MFM_ERROR_INTERNAL;
+
+	// Block offsets must be increasing and inside the frame
+	mfmU64 previous = MFM_DEFLATE_BLOCKS_HEADER_SIZE + (frame->blockCount + 1) * sizeof(mfmU64);
+	for (mfmU64 i = 0; i <= frame->blockCount; ++i)
+	{
+		mfmU64 offset = mfmReadInflateBlocksU64(frame->table + i * sizeof(mfmU64));
+		if (offset < previous || offset > dataSize)
+			return MFM_ERROR_INTERNAL;
+		previous = offset;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+static void mfmGetInflateBlock(const mfmU8* data, const mfmInflateBlocksFrame* frame, mfmU64 index, mfmInflateBlockJob* job)
+{
+	mfmU64 begin = mfmReadInflateBlocksU64(frame->table + index * sizeof(mfmU64));
+	mfmU64 end = mfmReadInflateBlocksU64(frame->table + (index + 1) * sizeof(mfmU64));
+	job->data = data + begin;
+	job->dataSize = end - begin;
+	job->outSize = (index + 1 == frame->blockCount) ? frame->size - index * frame->blockSize : frame->blockSize;
+	job->err = MF_ERROR_OKAY;
+}
+
+mfError mfmGetInflateBlocksSize(const mfmU8* data, mfmU64 dataSize, mfmU64* uncompressedSize)
+{
+	if (data == NULL || uncompressedSize == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmInflateBlocksFrame frame;
+	mfError err = mfmReadInflateBlocksFrame(data, dataSize, &frame);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	*uncompressedSize = frame.size;
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmInflateBlocks(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* decompressedSize, mftJobSystem* jobSystem, void* allocator)
+{
+	if (data == NULL || out == NULL || decompressedSize == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmInflateBlocksFrame frame;
+	mfError err = mfmReadInflateBlocksFrame(data, dataSize, &frame);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (frame.size > outSize)
+		return MFM_ERROR_BUFFER_FULL;
+
+	// Every block is decompressed straight to its place in the output buffer
+	mfmInflateBlockJob* jobs = NULL;
+	if (frame.blockCount != 0)
+	{
+		err = mfmAllocate(allocator, &jobs, frame.blockCount * sizeof(mfmInflateBlockJob));
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	for (mfmU64 i = 0; i < frame.blockCount; ++i)
+	{
+		mfmGetInflateBlock(data, &frame, i, &jobs[i]);
+		jobs[i].out = out + i * frame.blockSize;
+		jobs[i].allocator = allocator;
+	}
+
+	if (jobSystem != NULL && frame.blockCount > 1)
+	{
+		mftJobCounter counter;
+		mftInitJobCounter(&counter);
+		err = mftSubmitJobBatch(jobSystem, &mfmInflateBlockJobFunction, jobs, sizeof(mfmInflateBlockJob), frame.blockCount, &counter);
+		if (err == MF_ERROR_OKAY)
+			err = mftWaitForJobCounter(jobSystem, &counter);
+		if (err != MF_ERROR_OKAY)
+			abort();
+	}
+	else
+		for (mfmU64 i = 0; i < frame.blockCount; ++i)
+			mfmInflateBlockJobFunction(&jobs[i]);
+
+	err = MF_ERROR_OKAY;
+	for (mfmU64 i = 0; i < frame.blockCount; ++i)
+		if (jobs[i].err != MF_ERROR_OKAY)
+		{
+			err = jobs[i].err;
+			break;
+		}
+
+	if (jobs != NULL)
+		mfmDeallocate(allocator, jobs);
+
+	if (err != MF_ERROR_OKAY)
+		return err;
+	*decompressedSize = frame.size;
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmInflateBlocksRange(const mfmU8* data, mfmU64 dataSize, mfmU64 offset, mfmU8* out, mfmU64 size, void* allocator)
+{
+	if (data == NULL || (out == NULL && size != 0))
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmInflateBlocksFrame frame;
+	mfError err = mfmReadInflateBlocksFrame(data, dataSize, &frame);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (offset > frame.size || size > frame.size - offset)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	if (size == 0)
+		return MF_ERROR_OKAY;
+
+	// Blocks which are only partially inside the range are decompressed to a temporary buffer
+	mfmU8* temp = NULL;
+	mfmU64 first = offset / frame.blockSize;
+	mfmU64 last = (offset + size - 1) / frame.blockSize;
+	for (mfmU64 i = first; i <= last && err == MF_ERROR_OKAY; ++i)
+	{
+		mfmInflateBlockJob job;
+		mfmGetInflateBlock(data, &frame, i, &job);
+		job.allocator = allocator;
+
+		mfmU64 blockBegin = i * frame.blockSize;
+		mfmU64 begin = offset > blockBegin ? offset - blockBegin : 0;
+		mfmU64 end = offset + size - blockBegin < job.outSize ? offset + size - blockBegin : job.outSize;
+
+		if (begin == 0 && end == job.outSize)
+		{
+			job.out = out + (blockBegin - offset);
+			mfmInflateBlockJobFunction(&job);
+			err = job.err;
+			continue;
+		}
+
+		if (temp == NULL)
+		{
+			err = mfmAllocate(allocator, &temp, frame.blockSize);
+			if (err != MF_ERROR_OKAY)
+				break;
+		}
+		job.out = temp;
+		mfmInflateBlockJobFunction(&job);
+		err = job.err;
+		if (err == MF_ERROR_OKAY)
+			memcpy(out + (blockBegin + begin - offset), temp + begin, end - begin);
+	}
 
-	inflateEnd(&defStream->stream);
+	if (temp != NULL)
+		mfmDeallocate(allocator, temp);
+	return err;
 }
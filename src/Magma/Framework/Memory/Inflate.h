@@ -2,7 +2,16 @@
 
 #include "../Error.h"
 #include "../String/Stream.h"
+#include "../Thread/JobSystem.h"
 
+#include "Compression.h"
+
+/*
+	Inflate streams decompress the data written to them into the stream buffer, which is used as a ring buffer, from where the
+	decompressed data is read (or taken with mfsGetSpan, without copying it).
+	Both zlib streams and compressed frames (see Compression.h) are accepted, and told apart by their first byte.
+	Once the end of the zlib stream is reached, writes return MFS_ERROR_EOF, and reads return MFS_ERROR_EOF after all the data is read.
+*/
 #ifdef __cplusplus
 extern "C"
 {
@@ -10,9 +19,11 @@ extern "C"
 
 	/// <summary>
 	///		Creates a stream that decompresses data using DEFLATE.
+	///		Writes return MFM_ERROR_BUFFER_FULL if the buffer is full and no data could be written, in which case the decompressed
+	///		data must be read before writing more.
 	/// </summary>
 	/// <param name="stream">Out stream handle</param>
-	/// <param name="buffer">Stream buffer</param>
+	/// <param name="buffer">Stream buffer, where the decompressed data is kept until it is read</param>
 	/// <param name="bufferSize">Stream buffer size</param>
 	/// <param name="allocator">Stream internal allocator</param>
 	mfError mfmCreateInflateStream(mfsStream** stream, mfmU8* buffer, mfmU64 bufferSize, void* allocator);
@@ -23,6 +34,70 @@ extern "C"
 	/// <param name="stream">Stream handle</param>
 	void mfmDestroyInflateStream(mfsStream* stream);
 
+	/// <summary>
+	///		Decompresses a whole zlib stream or compressed frame in a single call, writing the decompressed data directly to the output buffer.
+	/// </summary>
+	/// <param name="data">Compressed data</param>
+	/// <param name="dataSize">Compressed data size</param>
+	/// <param name="out">Output buffer</param>
+	/// <param name="outSize">Output buffer size</param>
+	/// <param name="decompressedSize">Out decompressed data size</param>
+	/// <param name="allocator">Internal allocator</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL.
+	///		Returns MFM_ERROR_BUFFER_FULL if the decompressed data doesn't fit in the output buffer.
+	///		Returns MFM_ERROR_INTERNAL if the data is corrupted or truncated.
+	/// </returns>
+	mfError mfmInflate(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* decompressedSize, void* allocator);
+
+	/// <summary>
+	///		Gets the uncompressed size of a block compressed frame (see Compression.h).
+	/// </summary>
+	/// <param name="data">Frame data</param>
+	/// <param name="dataSize">Frame size</param>
+	/// <param name="uncompressedSize">Out uncompressed data size</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL.
+	///		Returns MFM_ERROR_INTERNAL if the frame header or seek table are invalid.
+	/// </returns>
+	mfError mfmGetInflateBlocksSize(const mfmU8* data, mfmU64 dataSize, mfmU64* uncompressedSize);
+
+	/// <summary>
+	///		Decompresses a whole block compressed frame, decompressing the blocks in parallel.
+	/// </summary>
+	/// <param name="data">Frame data</param>
+	/// <param name="dataSize">Frame size</param>
+	/// <param name="out">Output buffer</param>
+	/// <param name="outSize">Output buffer size</param>
+	/// <param name="decompressedSize">Out decompressed data size</param>
+	/// <param name="jobSystem">Job system where the blocks are decompressed (set to NULL to decompress them on the calling thread)</param>
+	/// <param name="allocator">Internal allocator (must be thread safe if a job system is used)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL.
+	///		Returns MFM_ERROR_BUFFER_FULL if the decompressed data doesn't fit in the output buffer.
+	///		Returns MFM_ERROR_INTERNAL if the frame is corrupted or truncated.
+	/// </returns>
+	mfError mfmInflateBlocks(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* decompressedSize, mftJobSystem* jobSystem, void* allocator);
+
+	/// <summary>
+	///		Decompresses a range of a block compressed frame, using the seek table to only decompress the blocks which contain it.
+	/// </summary>
+	/// <param name="data">Frame data</param>
+	/// <param name="dataSize">Frame size</param>
+	/// <param name="offset">Offset of the range in the uncompressed data</param>
+	/// <param name="out">Output buffer</param>
+	/// <param name="size">Range size, which must be within the uncompressed data</param>
+	/// <param name="allocator">Internal allocator</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL or if the range is out of bounds.
+	///		Returns MFM_ERROR_INTERNAL if the frame is corrupted or truncated.
+	/// </returns>
+	mfError mfmInflateBlocksRange(const mfmU8* data, mfmU64 dataSize, mfmU64 offset, mfmU8* out, mfmU64 size, void* allocator);
+
 #ifdef __cplusplus
 }
 #endif
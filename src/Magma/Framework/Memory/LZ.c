@@ -0,0 +1,238 @@
+#include "LZ.h"
+
+#include <string.h>
+
+#define MFM_LZ_HASH_LOG				12
+#define MFM_LZ_MIN_MATCH			4
+#define MFM_LZ_LAST_LITERALS		5
+#define MFM_LZ_MATCH_FIND_LIMIT		12
+#define MFM_LZ_SKIP_TRIGGER			6
+
+static mfmU32 mfmLZRead32(const mfmU8* data)
+{
+	mfmU32 value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static mfmU64 mfmLZRead64(const mfmU8* data)
+{
+	mfmU64 value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static mfmU32 mfmLZHash(mfmU32 sequence)
+{
+	return (sequence * 2654435761U) >> (32 - MFM_LZ_HASH_LOG);
+}
+
+static mfmU8* mfmLZWriteLength(mfmU8* out, mfmU64 length)
+{
+	while (length >= 255)
+	{
+		*(out++) = 255;
+		length -= 255;
+	}
+	*(out++) = (mfmU8)length;
+	return out;
+}
+
+// Writes a sequence (a match length of 0 writes the last sequence, which only has literals), returns NULL if it doesn't fit
+static mfmU8* mfmLZWriteSequence(mfmU8* out, mfmU8* outEnd, const mfmU8* literals, mfmU64 literalLength, mfmU64 offset, mfmU64 matchLength)
+{
+	mfmU64 requiredSize = 1 + literalLength / 255 + 1 + literalLength;
+	if (matchLength != 0)
+		requiredSize += 2 + matchLength / 255 + 1;
+	if ((mfmU64)(outEnd - out) < requiredSize)
+		return NULL;
+
+	mfmU8* token = out++;
+	if (literalLength >= 15)
+	{
+		*token = 15 << 4;
+		out = mfmLZWriteLength(out, literalLength - 15);
+	}
+	else
+		*token = (mfmU8)(literalLength << 4);
+	memcpy(out, literals, literalLength);
+	out += literalLength;
+
+	if (matchLength == 0)
+		return out;
+
+	*(out++) = (mfmU8)(offset & 0xFF);
+	*(out++) = (mfmU8)(offset >> 8);
+	matchLength -= MFM_LZ_MIN_MATCH;
+	if (matchLength >= 15)
+	{
+		*token |= 15;
+		out = mfmLZWriteLength(out, matchLength - 15);
+	}
+	else
+		*token |= (mfmU8)matchLength;
+	return out;
+}
+
+static mfmBool mfmLZReadLength(const mfmU8** data, const mfmU8* dataEnd, mfmU64* length)
+{
+	mfmU8 byte;
+	do
+	{
+		if (*data == dataEnd)
+			return MFM_FALSE;
+		byte = *((*data)++);
+		*length += byte;
+	} while (byte == 255);
+	return MFM_TRUE;
+}
+
+mfmU64 mfmGetLZBlockBound(mfmU64 dataSize)
+{
+	return dataSize + dataSize / 255 + 16;
+}
+
+mfmU64 mfmGetLZFrameBound(mfmU64 dataSize)
+{
+	// Blocks which don't get smaller are stored, so each block adds only its size word
+	mfmU64 blockCount = (dataSize + MFM_LZ_BLOCK_SIZE - 1) / MFM_LZ_BLOCK_SIZE;
+	return MFM_COMPRESSED_FRAME_HEADER_SIZE + dataSize + (blockCount + 1) * sizeof(mfmU32);
+}
+
+mfError mfmLZCompressBlock(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* compressedSize)
+{
+	if ((data == NULL && dataSize != 0) || out == NULL || compressedSize == NULL || dataSize > MFM_LZ_BLOCK_SIZE)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmU8* op = out;
+	mfmU8* outEnd = out + outSize;
+	mfmU64 anchor = 0;
+
+	// Matches must end MFM_LZ_LAST_LITERALS bytes before the end of the block, like on LZ4 blocks
+	if (dataSize > MFM_LZ_MATCH_FIND_LIMIT)
+	{
+		// Positions fit in 16 bits since blocks are at most 64 KiB, and position 0 is inserted by clearing the table
+		mfmU16 table[1 << MFM_LZ_HASH_LOG];
+		memset(table, 0, sizeof(table));
+
+		const mfmU64 matchFindLimit = dataSize - MFM_LZ_MATCH_FIND_LIMIT;
+		const mfmU64 matchLimit = dataSize - MFM_LZ_LAST_LITERALS;
+		mfmU64 ip = 1;
+		mfmU64 searchCount = 1 << MFM_LZ_SKIP_TRIGGER;
+
+		while (ip < matchFindLimit)
+		{
+			mfmU32 sequence = mfmLZRead32(data + ip);
+			mfmU32 hash = mfmLZHash(sequence);
+			mfmU64 ref = table[hash];
+			table[hash] = (mfmU16)ip;
+
+			// Skip ahead faster the longer no match is found, which makes incompressible data cheap
+			if (mfmLZRead32(data + ref) != sequence)
+			{
+				ip += searchCount++ >> MFM_LZ_SKIP_TRIGGER;
+				continue;
+			}
+
+			while (ip > anchor && ref > 0 && data[ip - 1] == data[ref - 1])
+			{
+				--ip;
+				--ref;
+			}
+
+			mfmU64 length = MFM_LZ_MIN_MATCH;
+			while (ip + length + sizeof(mfmU64) <= matchLimit && mfmLZRead64(data + ip + length) == mfmLZRead64(data + ref + length))
+				length += sizeof(mfmU64);
+			while (ip + length < matchLimit && data[ip + length] == data[ref + length])
+				++length;
+
+			op = mfmLZWriteSequence(op, outEnd, data + anchor, ip - anchor, ip - ref, length);
+			if (op == NULL)
+				return MFM_ERROR_BUFFER_FULL;
+
+			ip += length;
+			anchor = ip;
+			searchCount = 1 << MFM_LZ_SKIP_TRIGGER;
+			if (ip < matchFindLimit)
+				table[mfmLZHash(mfmLZRead32(data + ip - 2))] = (mfmU16)(ip - 2);
+		}
+	}
+
+	op = mfmLZWriteSequence(op, outEnd, data + anchor, dataSize - anchor, 0, 0);
+	if (op == NULL)
+		return MFM_ERROR_BUFFER_FULL;
+
+	*compressedSize = op - out;
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmLZDecompressBlock(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* decompressedSize)
+{
+	if (data == NULL || (out == NULL && outSize != 0) || decompressedSize == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	const mfmU8* ip = data;
+	const mfmU8* dataEnd = data + dataSize;
+	mfmU8* op = out;
+	mfmU8* outEnd = out + outSize;
+
+	for (;;)
+	{
+		if (ip == dataEnd)
+			return MFM_ERROR_INTERNAL;
+		mfmU8 token = *(ip++);
+
+		// Literals (short ones are copied with a fixed size copy when it stays clear of the last literals of the output buffer)
+		mfmU64 length = token >> 4;
+		if (length == 15 && mfmLZReadLength(&ip, dataEnd, &length) == MFM_FALSE)
+			return MFM_ERROR_INTERNAL;
+		if ((mfmU64)(dataEnd - ip) < length)
+			return MFM_ERROR_INTERNAL;
+		if ((mfmU64)(outEnd - op) < length)
+			return MFM_ERROR_BUFFER_FULL;
+		if (length <= 16 && dataEnd - ip >= 16 && outEnd - op >= 16 + MFM_LZ_LAST_LITERALS)
+			memcpy(op, ip, 16);
+		else
+			memcpy(op, ip, length);
+		ip += length;
+		op += length;
+
+		// The last sequence only has literals
+		if (ip == dataEnd)
+			break;
+
+		if (dataEnd - ip < 2)
+			return MFM_ERROR_INTERNAL;
+		mfmU64 offset = (mfmU64)ip[0] | ((mfmU64)ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (mfmU64)(op - out))
+			return MFM_ERROR_INTERNAL;
+
+		length = token & 15;
+		if (length == 15 && mfmLZReadLength(&ip, dataEnd, &length) == MFM_FALSE)
+			return MFM_ERROR_INTERNAL;
+		length += MFM_LZ_MIN_MATCH;
+		if ((mfmU64)(outEnd - op) < length)
+			return MFM_ERROR_BUFFER_FULL;
+
+		// Matches may overlap the data they write, in which case they are copied in pieces no bigger than the offset
+		const mfmU8* match = op - offset;
+		if (offset >= length)
+			memcpy(op, match, length);
+		else if (offset >= sizeof(mfmU64))
+		{
+			mfmU64 i = 0;
+			for (; i + sizeof(mfmU64) <= length; i += sizeof(mfmU64))
+				memcpy(op + i, match + i, sizeof(mfmU64));
+			for (; i < length; ++i)
+				op[i] = match[i];
+		}
+		else
+			for (mfmU64 i = 0; i < length; ++i)
+				op[i] = match[i];
+		op += length;
+	}
+
+	*decompressedSize = op - out;
+	return MF_ERROR_OKAY;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Compression.h"
+#include "Error.h"
+#include "Type.h"
+
+/*
+	Very fast LZ77 block codec, used by MFM_LZ_COMPRESSION.
+	It compresses far worse than DEFLATE, but decompresses several times faster, which makes it a better fit for data which is
+	decompressed often, such as assets streamed at load time.
+	Blocks use the same sequence format as LZ4 blocks: a token with the literal and match lengths, the literals, a little endian
+	U16 match offset and extra length bytes, with the last sequence only having literals.
+*/
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	/// <summary>
+	///		Gets the maximum size of a compressed block.
+	/// </summary>
+	/// <param name="dataSize">Uncompressed block size</param>
+	/// <returns>Maximum compressed block size</returns>
+	mfmU64 mfmGetLZBlockBound(mfmU64 dataSize);
+
+	/// <summary>
+	///		Gets the maximum size of an LZ frame (see Compression.h).
+	/// </summary>
+	/// <param name="dataSize">Uncompressed data size</param>
+	/// <returns>Maximum frame size</returns>
+	mfmU64 mfmGetLZFrameBound(mfmU64 dataSize);
+
+	/// <summary>
+	///		Compresses a single block, without a frame.
+	/// </summary>
+	/// <param name="data">Data to compress</param>
+	/// <param name="dataSize">Data size (at most MFM_LZ_BLOCK_SIZE)</param>
+	/// <param name="out">Output buffer (mfmGetLZBlockBound bytes are always enough)</param>
+	/// <param name="outSize">Output buffer size</param>
+	/// <param name="compressedSize">Out compressed size</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL or if the data is bigger than MFM_LZ_BLOCK_SIZE.
+	///		Returns MFM_ERROR_BUFFER_FULL if the compressed data doesn't fit in the output buffer.
+	/// </returns>
+	mfError mfmLZCompressBlock(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* compressedSize);
+
+	/// <summary>
+	///		Decompresses a single block, without a frame.
+	///		Corrupted data is detected and never makes the decoder read or write out of bounds.
+	///		Nothing is written past outSize bytes of out, but short literal runs are copied 16 bytes at a time, so bytes of out
+	///		after the decompressed data may be overwritten (except for the last 5 bytes of out, which are only written with data).
+	/// </summary>
+	/// <param name="data">Compressed block</param>
+	/// <param name="dataSize">Compressed block size</param>
+	/// <param name="out">Output buffer</param>
+	/// <param name="outSize">Output buffer size</param>
+	/// <param name="decompressedSize">Out decompressed size</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if any of the pointers is NULL.
+	///		Returns MFM_ERROR_BUFFER_FULL if the decompressed data doesn't fit in the output buffer.
+	///		Returns MFM_ERROR_INTERNAL if the block is corrupted.
+	/// </returns>
+	mfError mfmLZDecompressBlock(const mfmU8* data, mfmU64 dataSize, mfmU8* out, mfmU64 outSize, mfmU64* decompressedSize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,12 +1,18 @@
 #include "LinearAllocator.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 mfError mfmInternalLinearAllocate(void* allocator, void** memory, mfmU64 size)
 {
 	return mfmLinearAllocate((mfmLinearAllocator*)allocator, memory, size);
 }
 
+mfError mfmInternalLinearAllocateAligned(void* allocator, void** memory, mfmU64 size, mfmU64 alignment)
+{
+	return mfmLinearAllocateAligned((mfmLinearAllocator*)allocator, memory, size, alignment);
+}
+
 mfError mfmInternalLinearDeallocate(void* allocator, void* memory)
 {
 	return MFM_ERROR_UNSUPPORTED_FUNCTION;
@@ -16,6 +22,7 @@ mfError mfmInternalLinearReallocate(void* allocator, void* memory, mfmU64 prevSi
 {
 	mfmLinearAllocator* linearAllocator = allocator;
 
+	// If this was the last allocation, resize it in place
 	if (linearAllocator->head - prevSize == memory)
 	{
 		if (size >= prevSize)
@@ -30,10 +37,16 @@ mfError mfmInternalLinearReallocate(void* allocator, void* memory, mfmU64 prevSi
 				return MFM_ERROR_ALLOCATOR_UNDERFLOW;;
 			linearAllocator->head -= prevSize - size;
 		}
-		*newMemory = linearAllocator->head;
+		*newMemory = memory;
 		return MF_ERROR_OKAY;
 	}
-	else return mfmLinearAllocate((mfmLinearAllocator*)allocator, newMemory, size);
+
+	// Otherwise allocate new memory and copy the data
+	mfError err = mfmLinearAllocate(linearAllocator, newMemory, size);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memcpy(*newMemory, memory, (size_t)(prevSize < size ? prevSize : size));
+	return MF_ERROR_OKAY;
 }
 
 mfError mfmCreateLinearAllocator(mfmLinearAllocator ** linearAllocator, mfmU64 size)
@@ -53,11 +66,14 @@ mfError mfmCreateLinearAllocator(mfmLinearAllocator ** linearAllocator, mfmU64 s
 	(*linearAllocator)->size = size;
 	(*linearAllocator)->begin = memory + sizeof(mfmLinearAllocator);
 	(*linearAllocator)->head = memory + sizeof(mfmLinearAllocator);
+	(*linearAllocator)->highWaterMark = 0;
 
 	// Set functions
 	(*linearAllocator)->base.allocate = &mfmInternalLinearAllocate;
 	(*linearAllocator)->base.deallocate = &mfmInternalLinearDeallocate;
 	(*linearAllocator)->base.reallocate = &mfmInternalLinearReallocate;
+	(*linearAllocator)->base.allocateAligned = &mfmInternalLinearAllocateAligned;
+	(*linearAllocator)->base.deallocateAligned = &mfmInternalLinearDeallocate;
 
 	// Set destructor function
 	(*linearAllocator)->base.object.destructorFunc = &mfmDestroyLinearAllocator;
@@ -78,11 +94,14 @@ mfError mfmCreateLinearAllocatorOnMemory(mfmLinearAllocator ** linearAllocator,
 	(*linearAllocator)->size = size;
 	(*linearAllocator)->begin = (mfmU8*)memory + sizeof(mfmLinearAllocator);
 	(*linearAllocator)->head = (mfmU8*)memory + sizeof(mfmLinearAllocator);
+	(*linearAllocator)->highWaterMark = 0;
 
 	// Set functions
 	(*linearAllocator)->base.allocate = &mfmInternalLinearAllocate;
 	(*linearAllocator)->base.deallocate = &mfmInternalLinearDeallocate;
 	(*linearAllocator)->base.reallocate = &mfmInternalLinearReallocate;
+	(*linearAllocator)->base.allocateAligned = &mfmInternalLinearAllocateAligned;
+	(*linearAllocator)->base.deallocateAligned = &mfmInternalLinearDeallocate;
 
 	// Set destructor function
 	(*linearAllocator)->base.object.destructorFunc = &mfmDestroyLinearAllocator;
@@ -114,10 +133,38 @@ mfError mfmLinearAllocate(mfmLinearAllocator * linearAllocator, void ** memory,
 	return MF_ERROR_OKAY;
 }
 
+mfError mfmLinearAllocateAligned(mfmLinearAllocator * linearAllocator, void ** memory, mfmU64 size, mfmU64 alignment)
+{
+	if (linearAllocator == NULL || memory == NULL || size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	// Get the padding needed to align the head
+	mfmU64 padding = (alignment - (mfmU64)linearAllocator->head % alignment) % alignment;
+
+	// Check if allocation fits on the linear buffer
+	if ((mfmU64)(linearAllocator->head - linearAllocator->begin) + padding + size > linearAllocator->size)
+		return MFM_ERROR_ALLOCATOR_OVERFLOW;
+
+	// Get aligned head and move it
+	*memory = linearAllocator->head + padding;
+	linearAllocator->head += padding + size;
+	return MF_ERROR_OKAY;
+}
+
 mfError mfmLinearReset(mfmLinearAllocator * linearAllocator)
 {
 	if (linearAllocator == NULL)
 		return MFM_ERROR_INVALID_ARGUMENTS;
-	// Reset the linear allocator head
+	// Update the high water mark and reset the linear allocator head
+	mfmU64 used = (mfmU64)(linearAllocator->head - linearAllocator->begin);
+	if (used > linearAllocator->highWaterMark)
+		linearAllocator->highWaterMark = used;
 	linearAllocator->head = linearAllocator->begin;
+	return MF_ERROR_OKAY;
+}
+
+mfmU64 mfmLinearGetHighWaterMark(mfmLinearAllocator * linearAllocator)
+{
+	mfmU64 used = (mfmU64)(linearAllocator->head - linearAllocator->begin);
+	return used > linearAllocator->highWaterMark ? used : linearAllocator->highWaterMark;
 }
@@ -66,6 +66,32 @@ void * Magma::Framework::Memory::LinearAllocator::Allocate(mfmU64 size)
 	return memory;
 }
 
+void * Magma::Framework::Memory::LinearAllocator::AllocateAligned(mfmU64 size, mfmU64 alignment)
+{
+	void* memory;
+	auto err = ::mfmLinearAllocateAligned(m_linear, &memory, size, alignment);
+	switch (err)
+	{
+		case MF_ERROR_OKAY:
+			break;
+		case MFM_ERROR_ALLOCATOR_OVERFLOW:
+		{
+			std::stringstream ss;
+			ss << "Failed to allocate on LinearAllocator:" << std::endl;
+			ss << "mfmLinearAllocateAligned returned MFM_ERROR_ALLOCATOR_OVERFLOW";
+			throw AllocatorError(ss.str());
+		}
+		default:
+		{
+			std::stringstream ss;
+			ss << "Failed to allocate on LinearAllocator:" << std::endl;
+			ss << "mfmLinearAllocateAligned returned '" << err << "'";
+			throw AllocatorError(ss.str());
+		}
+	}
+	return memory;
+}
+
 void Magma::Framework::Memory::LinearAllocator::Reset()
 {
 	::mfmLinearReset(m_linear);
@@ -16,6 +16,7 @@ extern "C"
 		mfmU64 size;
 		mfmU8* begin;
 		mfmU8* head;
+		mfmU64 highWaterMark;
 		mfmBool onMemory;
 	} mfmLinearAllocator;
 
@@ -67,6 +68,20 @@ extern "C"
 	/// </returns>
 	mfError mfmLinearAllocate(mfmLinearAllocator* linearAllocator, void** memory, mfmU64 size);
 
+	/// <summary>
+	///		Allocates on a magma framework memory linear allocator using a specified alignment.
+	/// </summary>
+	/// <param name="linearAllocator">Magma framework memory linear allocator</param>
+	/// <param name="memory">Pointer to allocated memory pointer</param>
+	/// <param name="size">Memory allocation size in bytes</param>
+	/// <param name="alignment">Memory alignment in bytes (must be a power of two)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_ALLOCATOR_OVERFLOW if the linear buffer overflows.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS the linear allocator or memory are NULL, size is 0 or the alignment isn't a power of two.
+	/// </returns>
+	mfError mfmLinearAllocateAligned(mfmLinearAllocator* linearAllocator, void** memory, mfmU64 size, mfmU64 alignment);
+
 	/// <summary>
 	///		Resets the head on a magma framework memory linear allocator.
 	/// </summary>
@@ -77,6 +92,13 @@ extern "C"
 	/// </returns>
 	mfError mfmLinearReset(mfmLinearAllocator* linearAllocator);
 
+	/// <summary>
+	///		Gets the maximum number of bytes that were in use at once on a magma framework memory linear allocator.
+	/// </summary>
+	/// <param name="linearAllocator">Magma framework memory linear allocator</param>
+	/// <returns>High water mark in bytes</returns>
+	mfmU64 mfmLinearGetHighWaterMark(mfmLinearAllocator* linearAllocator);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,11 +33,25 @@ namespace Magma
 				/// <returns>Returns the allocated memory pointer</returns>
 				void* Allocate(mfmU64 size);
 
+				/// <summary>
+				///		Allocates on a linear allocator using a specified alignment
+				/// </summary>
+				/// <param name="size">Allocation size</param>
+				/// <param name="alignment">Allocation alignment (must be a power of two)</param>
+				/// <returns>Returns the allocated memory pointer</returns>
+				void* AllocateAligned(mfmU64 size, mfmU64 alignment);
+
 				/// <summary>
 				///		Resets the linear allocator head.
 				/// </summary>
 				void Reset();
 
+				/// <summary>
+				///		Gets the maximum number of bytes that were in use at once.
+				/// </summary>
+				/// <returns>High water mark in bytes</returns>
+				inline mfmU64 GetHighWaterMark() const { return mfmLinearGetHighWaterMark(m_linear); }
+
 			private:
 				::mfmLinearAllocator * m_linear;
 			};
@@ -7,6 +7,7 @@ mfError mfmInitObject(mfmObject * obj)
 	if (obj == NULL)
 		return MFM_ERROR_INVALID_ARGUMENTS;
 	obj->destructorFunc = NULL;
+	obj->m_nonAtomic = MFM_FALSE;
 	mfError err = mftAtomic32Store(&obj->m_referenceCount, 0);
 	if (err != MF_ERROR_OKAY)
 		return err;
@@ -30,6 +31,13 @@ mfError mfmAcquireObject(mfmObject* obj)
 {
 	if (obj == NULL)
 		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	if (obj->m_nonAtomic != MFM_FALSE)
+	{
+		++obj->m_referenceCount;
+		return MF_ERROR_OKAY;
+	}
+
 	mfError err = mftAtomic32Add(&obj->m_referenceCount, 1);
 	if (err != MF_ERROR_OKAY)
 		return err;
@@ -41,24 +49,37 @@ mfError mfmReleaseObject(mfmObject* obj)
 	if (obj == NULL)
 		return MFM_ERROR_INVALID_ARGUMENTS;
 
+	// The count is only decremented while it is positive, and its previous value is read in the same atomic operation, so exactly one caller sees the last reference go.
+	// The operation is sequentially consistent, so the destructor sees every write made by the threads which released the object before.
 	mfmI32 refCount;
-	mfError err = mftAtomic32Load(&obj->m_referenceCount, &refCount);
-	if (err != MF_ERROR_OKAY)
-		return err;
-	if (refCount == 0)
-		return MFM_ERROR_HAS_NO_REFERENCES;
-	err = mftAtomic32Add(&obj->m_referenceCount, -1);
-	if (err != MF_ERROR_OKAY)
-		return err;
-
-	if (refCount == 1)
+	if (obj->m_nonAtomic != MFM_FALSE)
+	{
+		refCount = obj->m_referenceCount;
+		if (refCount <= 0)
+			return MFM_ERROR_HAS_NO_REFERENCES;
+		--obj->m_referenceCount;
+	}
+	else
 	{
-		err = mfmDeinitObject(obj);
+		mfError err = mftAtomic32Load(&obj->m_referenceCount, &refCount);
 		if (err != MF_ERROR_OKAY)
 			return err;
-		obj->destructorFunc(obj);
+
+		// Retry until the count is decremented without another thread changing it in the meantime
+		mfmBool exchanged = MFM_FALSE;
+		do
+		{
+			if (refCount <= 0)
+				return MFM_ERROR_HAS_NO_REFERENCES;
+			err = mftAtomic32CompareExchange(&obj->m_referenceCount, &refCount, refCount - 1, &exchanged);
+			if (err != MF_ERROR_OKAY)
+				return err;
+		} while (exchanged == MFM_FALSE);
 	}
 
+	if (refCount == 1)
+		obj->destructorFunc(obj);
+
 	return MF_ERROR_OKAY;
 }
 
@@ -71,3 +92,11 @@ mfError mfmGetObjectRefCount(mfmObject* obj, mfmI32* refCount)
 		return err;
 	return MF_ERROR_OKAY;
 }
+
+mfError mfmSetObjectNonAtomic(mfmObject* obj, mfmBool nonAtomic)
+{
+	if (obj == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	obj->m_nonAtomic = nonAtomic;
+	return MF_ERROR_OKAY;
+}
@@ -13,6 +13,7 @@ extern "C"
 	{
 		mfmDestructor destructorFunc;
 		volatile mfmI32 m_referenceCount;
+		mfmBool m_nonAtomic;
 	} mfmObject;
 
 	/// <summary>
@@ -47,6 +48,7 @@ extern "C"
 
 	/// <summary>
 	///		Decreases an object's reference count.
+	///		The object is destroyed by the call which releases its last reference, even if several threads release it at once.
 	/// </summary>
 	/// <param name="obj">Object pointer</param>
 	/// <returns>
@@ -66,6 +68,19 @@ extern "C"
 	/// </returns>
 	mfError mfmGetObjectRefCount(mfmObject* obj, mfmI32* refCount);
 
+	/// <summary>
+	///		Sets whether an object's reference count is changed with plain (non atomic) operations.
+	///		Non atomic reference counting is cheaper, but the object's references must then only be acquired and released on a single thread.
+	///		Objects are atomic by default.
+	/// </summary>
+	/// <param name="obj">Object pointer</param>
+	/// <param name="nonAtomic">MFM_TRUE to use non atomic reference counting, MFM_FALSE to use atomic reference counting</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there was no error.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mfmSetObjectNonAtomic(mfmObject* obj, mfmBool nonAtomic);
+
 #ifdef __cplusplus
 }
 #endif
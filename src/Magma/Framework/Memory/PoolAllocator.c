@@ -13,6 +13,11 @@ mfError mfmInternalPoolDeallocate(void* allocator, void* memory)
 	return mfmPoolDeallocate((mfmPoolAllocator*)allocator, memory);
 }
 
+mfError mfmInternalPoolAllocateAligned(void* allocator, void** memory, mfmU64 size, mfmU64 alignment)
+{
+	return mfmPoolAllocateAligned((mfmPoolAllocator*)allocator, memory, size, alignment);
+}
+
 mfError mfmInternalPoolReallocate(void* allocator, void* memory, mfmU64 prevSize, mfmU64 size, void** newMemory)
 {
 	mfmPoolAllocator* poolAllocator = allocator;
@@ -25,129 +30,163 @@ mfError mfmInternalPoolReallocate(void* allocator, void* memory, mfmU64 prevSize
 	return MF_ERROR_OKAY;
 }
 
-mfError mfmCreatePoolAllocator(mfmPoolAllocator ** poolAllocator, const mfmPoolAllocatorDesc* desc)
+static void mfmInitPoolAllocatorChunk(mfmPoolAllocator* poolAllocator, mfmPoolAllocatorChunk* chunk, mfmU8* memory)
 {
-	// Check if the arguments are valid
-	if (poolAllocator == NULL || desc == NULL)
-		return MFM_ERROR_INVALID_ARGUMENTS;
+	// Get data pointers
+	chunk->slotStatesPtr = (mfmU64*)memory;
+	chunk->slotDataPtr = (mfmU8*)(((mfmU64)memory + MFM_POOL_ALLOCATOR_BITMAP_SIZE(poolAllocator->desc.slotCount) + poolAllocator->slotAlignment - 1) & ~(poolAllocator->slotAlignment - 1));
+	chunk->freeSlot = NULL;
+	chunk->freeSlotCount = poolAllocator->desc.slotCount;
+	chunk->untouchedSlotIndex = 0;
+	chunk->nextAvailable = NULL;
 
-	// Allocate memory for the pool allocator and its first chunk
-	mfmU8 * memory = NULL;
-	if (mfmAllocate(NULL, &memory, sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk) + desc->slotCount * sizeof(mfmBool) + desc->slotSize * desc->slotCount) != MF_ERROR_OKAY)
-		return MFM_ERROR_ALLOCATION_FAILED;
+	// Initialize slot states to empty
+	memset(chunk->slotStatesPtr, 0, MFM_POOL_ALLOCATOR_BITMAP_SIZE(poolAllocator->desc.slotCount));
+}
 
+static mfError mfmInitPoolAllocator(mfmPoolAllocator** poolAllocator, const mfmPoolAllocatorDesc* desc, mfmU8* memory, mfmBool onMemory)
+{
 	// Get data pointers
 	*poolAllocator = (mfmPoolAllocator*)(memory + 0);
 	(*poolAllocator)->firstChunk = (mfmPoolAllocatorChunk*)(memory + sizeof(mfmPoolAllocator));
-	(*poolAllocator)->firstChunk->slotStatesPtr = memory + sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk);
-	(*poolAllocator)->firstChunk->slotDataPtr = memory + sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk) + desc->slotCount * sizeof(mfmBool);
-	(*poolAllocator)->firstChunk->next = NULL;
+	(*poolAllocator)->availableChunk = (*poolAllocator)->firstChunk;
+	(*poolAllocator)->inlineChunkTable[0] = (*poolAllocator)->firstChunk;
+	(*poolAllocator)->chunkTable = (*poolAllocator)->inlineChunkTable;
+	(*poolAllocator)->chunkTableCapacity = 1;
+	(*poolAllocator)->slotStride = MFM_POOL_ALLOCATOR_SLOT_STRIDE(desc->slotSize);
+	(*poolAllocator)->slotAlignment = MFM_POOL_ALLOCATOR_SLOT_ALIGNMENT(desc->slotSize);
 	(*poolAllocator)->currentFreeSlotCount = desc->slotCount;
 	(*poolAllocator)->currentSlotCount = desc->slotCount;
 	(*poolAllocator)->currentChunkCount = 1;
-	(*poolAllocator)->onMemory = MFM_FALSE;
+	(*poolAllocator)->onMemory = onMemory;
 
 	// Get description
 	memcpy(&(*poolAllocator)->desc, desc, sizeof(mfmPoolAllocatorDesc));
 
+	// Init first chunk
+	mfmInitPoolAllocatorChunk(*poolAllocator, (*poolAllocator)->firstChunk, memory + sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk));
+
 	// Set functions
 	(*poolAllocator)->base.allocate = &mfmInternalPoolAllocate;
 	(*poolAllocator)->base.deallocate = &mfmInternalPoolDeallocate;
 	(*poolAllocator)->base.reallocate = &mfmInternalPoolReallocate;
+	(*poolAllocator)->base.allocateAligned = &mfmInternalPoolAllocateAligned;
+	(*poolAllocator)->base.deallocateAligned = &mfmInternalPoolDeallocate;
 
 	// Set destructor function
 	(*poolAllocator)->base.object.destructorFunc = &mfmDestroyPoolAllocator;
 
-	// Initialize slot states to empty
-	memset((*poolAllocator)->firstChunk->slotStatesPtr, MFM_FALSE, desc->slotCount * sizeof(mfmBool));
-
-	// Successfully created a pool allocator
 	return MF_ERROR_OKAY;
 }
 
-mfError mfmCreatePoolAllocatorOnMemory(mfmPoolAllocator ** poolAllocator, const mfmPoolAllocatorDesc * desc, void * memPtr, mfmU64 memSize)
+mfError mfmCreatePoolAllocator(mfmPoolAllocator ** poolAllocator, const mfmPoolAllocatorDesc* desc)
 {
 	// Check if the arguments are valid
-	if (poolAllocator == NULL || desc == NULL || desc->expandable == MFM_TRUE)
-		return MFM_ERROR_INVALID_ARGUMENTS;
-
-	// Check if there is enough size for the pool
-	if (sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk) + desc->slotCount * sizeof(mfmBool) + desc->slotSize * desc->slotCount > memSize)
+	if (poolAllocator == NULL || desc == NULL || desc->slotCount == 0 || desc->slotSize == 0)
 		return MFM_ERROR_INVALID_ARGUMENTS;
 
 	// Allocate memory for the pool allocator and its first chunk
-	mfmU8* memory = (mfmU8*)memPtr;
-	if (memory == NULL)
+	mfmU8 * memory = NULL;
+	if (mfmAllocate(NULL, &memory, MFM_POOL_ALLOCATOR_SIZE(desc->slotCount, desc->slotSize)) != MF_ERROR_OKAY)
 		return MFM_ERROR_ALLOCATION_FAILED;
 
-	// Get data pointers
-	*poolAllocator = (mfmPoolAllocator*)(memory + 0);
-	(*poolAllocator)->firstChunk = (mfmPoolAllocatorChunk*)(memory + sizeof(mfmPoolAllocator));
-	(*poolAllocator)->firstChunk->slotStatesPtr = memory + sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk);
-	(*poolAllocator)->firstChunk->slotDataPtr = memory + sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk) + desc->slotCount * sizeof(mfmBool);
-	(*poolAllocator)->firstChunk->next = NULL;
-	(*poolAllocator)->currentFreeSlotCount = desc->slotCount;
-	(*poolAllocator)->currentSlotCount = desc->slotCount;
-	(*poolAllocator)->currentChunkCount = 1;
-	(*poolAllocator)->onMemory = MFM_TRUE;
-
-	// Get description
-	memcpy(&(*poolAllocator)->desc, desc, sizeof(mfmPoolAllocatorDesc));
+	// Successfully created a pool allocator
+	return mfmInitPoolAllocator(poolAllocator, desc, memory, MFM_FALSE);
+}
 
-	// Set functions
-	(*poolAllocator)->base.allocate = &mfmInternalPoolAllocate;
-	(*poolAllocator)->base.deallocate = &mfmInternalPoolDeallocate;
-	(*poolAllocator)->base.reallocate = &mfmInternalPoolReallocate;
+mfError mfmCreatePoolAllocatorOnMemory(mfmPoolAllocator ** poolAllocator, const mfmPoolAllocatorDesc * desc, void * memPtr, mfmU64 memSize)
+{
+	// Check if the arguments are valid
+	if (poolAllocator == NULL || desc == NULL || desc->expandable == MFM_TRUE || desc->slotCount == 0 || desc->slotSize == 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
 
-	// Set destructor function
-	(*poolAllocator)->base.object.destructorFunc = &mfmDestroyPoolAllocator;
+	// Align the memory pointer so that the free slots can hold pointers
+	mfmU8* memory = (mfmU8*)memPtr;
+	if (memory == NULL)
+		return MFM_ERROR_ALLOCATION_FAILED;
+	mfmU64 padding = (sizeof(mfmU64) - (mfmU64)memory % sizeof(mfmU64)) % sizeof(mfmU64);
 
-	// Initialize slot states to empty
-	memset((*poolAllocator)->firstChunk->slotStatesPtr, MFM_FALSE, desc->slotCount * sizeof(mfmBool));
+	// Check if there is enough size for the pool, including the padding needed to align the slots
+	mfmU64 slotAlignment = MFM_POOL_ALLOCATOR_SLOT_ALIGNMENT(desc->slotSize);
+	mfmU64 slotData = (mfmU64)memory + padding + sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk) + MFM_POOL_ALLOCATOR_BITMAP_SIZE(desc->slotCount);
+	slotData = (slotData + slotAlignment - 1) & ~(slotAlignment - 1);
+	if (slotData + desc->slotCount * MFM_POOL_ALLOCATOR_SLOT_STRIDE(desc->slotSize) - (mfmU64)memory > memSize)
+		return MFM_ERROR_INVALID_ARGUMENTS;
 
 	// Successfully created a pool allocator
-	return MF_ERROR_OKAY;
+	return mfmInitPoolAllocator(poolAllocator, desc, memory + padding, MFM_TRUE);
 }
 
 void mfmDestroyPoolAllocator(void * poolAllocator)
 {
+	mfmPoolAllocator* pool = poolAllocator;
+
 	// Free extra pool allocator chunks
-	mfmPoolAllocatorChunk* chunk = ((mfmPoolAllocator*)poolAllocator)->firstChunk->next;
-	while (chunk != NULL)
-	{
-		mfmPoolAllocatorChunk* next = (mfmPoolAllocatorChunk*)chunk->next;
-		if (mfmDeallocate(NULL, chunk) != MF_ERROR_OKAY)
+	for (mfmU64 i = 0; i < pool->currentChunkCount; ++i)
+		if (pool->chunkTable[i] != pool->firstChunk)
+			if (mfmDeallocate(NULL, pool->chunkTable[i]) != MF_ERROR_OKAY)
+				abort();
+
+	// Free the chunk table
+	if (pool->chunkTable != pool->inlineChunkTable)
+		if (mfmDeallocate(NULL, pool->chunkTable) != MF_ERROR_OKAY)
 			abort();
-		chunk = next;
-	}
 
 	// Free the pool allocator and its main chunk
-	if (((mfmPoolAllocator*)poolAllocator)->onMemory == MFM_FALSE)
-		if (mfmDeallocate(NULL, poolAllocator) != MF_ERROR_OKAY)
+	if (pool->onMemory == MFM_FALSE)
+		if (mfmDeallocate(NULL, pool) != MF_ERROR_OKAY)
 			abort();
 }
 
+static mfmU64 mfmFindPoolChunkIndex(mfmPoolAllocator* poolAllocator, const void* memory)
+{
+	// Binary search for the number of chunks whose data begins at or before memory
+	mfmU64 low = 0;
+	mfmU64 high = poolAllocator->currentChunkCount;
+	while (low < high)
+	{
+		mfmU64 mid = low + (high - low) / 2;
+		if ((mfmU64)poolAllocator->chunkTable[mid]->slotDataPtr <= (mfmU64)memory)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
 mfError mfmExpandPoolAllocator(mfmPoolAllocator* poolAllocator, mfmPoolAllocatorChunk** newChunk)
 {
+	// Grow the chunk table if it is full
+	if (poolAllocator->currentChunkCount == poolAllocator->chunkTableCapacity)
+	{
+		mfmPoolAllocatorChunk** table = NULL;
+		if (mfmAllocate(NULL, &table, poolAllocator->chunkTableCapacity * 2 * sizeof(mfmPoolAllocatorChunk*)) != MF_ERROR_OKAY)
+			return MFM_ERROR_ALLOCATION_FAILED;
+		memcpy(table, poolAllocator->chunkTable, poolAllocator->currentChunkCount * sizeof(mfmPoolAllocatorChunk*));
+		if (poolAllocator->chunkTable != poolAllocator->inlineChunkTable)
+			if (mfmDeallocate(NULL, poolAllocator->chunkTable) != MF_ERROR_OKAY)
+				return MFM_ERROR_INTERNAL;
+		poolAllocator->chunkTable = table;
+		poolAllocator->chunkTableCapacity *= 2;
+	}
+
 	// Allocate memory for the chunk
 	mfmU8 * memory = NULL;
-	if (mfmAllocate(NULL, &memory, sizeof(mfmPoolAllocatorChunk) + poolAllocator->desc.slotCount * sizeof(mfmBool) + poolAllocator->desc.slotSize * poolAllocator->desc.slotCount) != MF_ERROR_OKAY)
+	if (mfmAllocate(NULL, &memory, sizeof(mfmPoolAllocatorChunk) + MFM_POOL_ALLOCATOR_BITMAP_SIZE(poolAllocator->desc.slotCount) + poolAllocator->slotAlignment + poolAllocator->slotStride * poolAllocator->desc.slotCount) != MF_ERROR_OKAY)
 		return MFM_ERROR_ALLOCATION_FAILED;
 
-	// Get data pointers
 	mfmPoolAllocatorChunk* chunk = (mfmPoolAllocatorChunk*)(memory + 0);
-	chunk->slotStatesPtr = memory + sizeof(mfmPoolAllocatorChunk);
-	chunk->slotDataPtr = memory + sizeof(mfmPoolAllocatorChunk) + poolAllocator->desc.slotCount * sizeof(mfmBool);
-	chunk->next = NULL;
+	mfmInitPoolAllocatorChunk(poolAllocator, chunk, memory + sizeof(mfmPoolAllocatorChunk));
 
-	// Initialize slot states to empty
-	memset(chunk->slotStatesPtr, MFM_FALSE, poolAllocator->desc.slotCount * sizeof(mfmBool));
+	// Insert the chunk on the table, keeping it sorted by address
+	mfmU64 index = mfmFindPoolChunkIndex(poolAllocator, chunk->slotDataPtr);
+	memmove(&poolAllocator->chunkTable[index + 1], &poolAllocator->chunkTable[index], (poolAllocator->currentChunkCount - index) * sizeof(mfmPoolAllocatorChunk*));
+	poolAllocator->chunkTable[index] = chunk;
+
+	// Add chunk to the available chunks list
+	chunk->nextAvailable = poolAllocator->availableChunk;
+	poolAllocator->availableChunk = chunk;
 
-	// Add chunk to pool
-	mfmPoolAllocatorChunk* ck = ((mfmPoolAllocator*)poolAllocator)->firstChunk;
-	while (ck->next != NULL)
-		ck = ck->next;
-	ck->next = chunk;
 	++poolAllocator->currentChunkCount;
 	poolAllocator->currentFreeSlotCount += poolAllocator->desc.slotCount;
 	poolAllocator->currentSlotCount += poolAllocator->desc.slotCount;
@@ -158,89 +197,106 @@ mfError mfmExpandPoolAllocator(mfmPoolAllocator* poolAllocator, mfmPoolAllocator
 	return MF_ERROR_OKAY;
 }
 
-mfError mfmPoolChunkAllocate(mfmPoolAllocator * allocator, mfmPoolAllocatorChunk * chunk, void ** memory, mfmU64 size)
+mfError mfmPoolAllocate(mfmPoolAllocator * allocator, void ** memory, mfmU64 size)
 {
 	// Check if the allocation size fits on a pool slot
 	if (size > allocator->desc.slotSize)
 		return MFM_ERROR_ALLOCATION_TOO_BIG;
 
-	// Search for a free slot
-	for (mfmU64 i = 0; i < allocator->desc.slotCount; ++i)
-		// If this slot is free
-		if (chunk->slotStatesPtr[i] == MFM_FALSE)
+	// Get a chunk with free slots
+	mfmPoolAllocatorChunk* ck = allocator->availableChunk;
+	if (ck == NULL)
+	{
+		// No free slots
+		// If the pool is expandable, expand it
+		if (allocator->desc.expandable)
 		{
-			chunk->slotStatesPtr[i] = MFM_TRUE;
-			*memory = chunk->slotDataPtr + allocator->desc.slotSize * i;
-			--allocator->currentFreeSlotCount;
-			return MF_ERROR_OKAY;
+			mfError err = mfmExpandPoolAllocator(allocator, &ck);
+			if (err != MF_ERROR_OKAY)
+				return err;
 		}
+		// Otherwise return error
+		else return MFM_ERROR_ALLOCATOR_OVERFLOW;
+	}
+
+	// Pop a slot from the free list or take the next untouched slot
+	mfmU8* slot;
+	mfmU64 slotIndex;
+	if (ck->freeSlot != NULL)
+	{
+		slot = ck->freeSlot;
+		ck->freeSlot = *(void**)slot;
+		slotIndex = (mfmU64)(slot - ck->slotDataPtr) / allocator->slotStride;
+	}
+	else
+	{
+		slotIndex = ck->untouchedSlotIndex++;
+		slot = ck->slotDataPtr + allocator->slotStride * slotIndex;
+	}
+
+	// Mark slot as occupied
+	ck->slotStatesPtr[slotIndex / 64] |= (mfmU64)1 << (slotIndex % 64);
 
-	// No free slots
-	return MFM_ERROR_ALLOCATOR_OVERFLOW;
+	// Remove the chunk from the available list if it is now full
+	if (--ck->freeSlotCount == 0)
+	{
+		allocator->availableChunk = ck->nextAvailable;
+		ck->nextAvailable = NULL;
+	}
+
+	--allocator->currentFreeSlotCount;
+	*memory = slot;
+	return MF_ERROR_OKAY;
 }
 
-mfError mfmPoolChunkDeallocate(void * memory, mfmPoolAllocator * allocator, mfmPoolAllocatorChunk * chunk)
+mfError mfmPoolDeallocate(mfmPoolAllocator * allocator, void * memory)
 {
+	// Search for the chunk where the memory was allocated on
+	mfmU64 index = mfmFindPoolChunkIndex(allocator, memory);
+	if (index == 0)
+		return MFM_ERROR_OUT_OF_BOUNDS;
+	mfmPoolAllocatorChunk* ck = allocator->chunkTable[index - 1];
+
 	// Get slot index from memory pointer
-	mfmU64 slotIndex = ((mfmU64)memory - (mfmU64)chunk->slotDataPtr) / allocator->desc.slotSize;
+	mfmU64 offset = (mfmU64)memory - (mfmU64)ck->slotDataPtr;
+	mfmU64 slotIndex = offset / allocator->slotStride;
 
 	// Check if slot index is out of bounds
 	if (slotIndex >= allocator->desc.slotCount)
 		return MFM_ERROR_OUT_OF_BOUNDS;
 
-	// Free slot
-	++allocator->currentFreeSlotCount;
-	chunk->slotStatesPtr[slotIndex] = MFM_FALSE;
-	return MF_ERROR_OKAY;
-}
+	// Check if the memory points to an occupied slot
+	mfmU64 mask = (mfmU64)1 << (slotIndex % 64);
+	if (offset % allocator->slotStride != 0 || (ck->slotStatesPtr[slotIndex / 64] & mask) == 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
 
-mfError mfmPoolAllocate(mfmPoolAllocator * allocator, void ** memory, mfmU64 size)
-{
-	// Check if the allocation size fits on a pool slot
-	if (size > allocator->desc.slotSize)
-		return MFM_ERROR_ALLOCATION_TOO_BIG;
+	// Free slot
+	ck->slotStatesPtr[slotIndex / 64] &= ~mask;
+	*(void**)memory = ck->freeSlot;
+	ck->freeSlot = memory;
 
-	// Search for a free slot
-	mfmPoolAllocatorChunk* ck = allocator->firstChunk;
-	while (ck != NULL)
+	// Add the chunk back to the available list if it was full
+	if (ck->freeSlotCount++ == 0)
 	{
-		mfError err = mfmPoolChunkAllocate(allocator, ck, memory, size);
-		if (err == MF_ERROR_OKAY)
-			return MF_ERROR_OKAY;
-		else if (err != MFM_ERROR_ALLOCATOR_OVERFLOW)
-			return err;
-		ck = (mfmPoolAllocatorChunk*)ck->next;
+		ck->nextAvailable = allocator->availableChunk;
+		allocator->availableChunk = ck;
 	}
 
-	// No free slots
-	// If the pool is expandable, expand it
-	if (allocator->desc.expandable)
-	{
-		mfError err = mfmExpandPoolAllocator(allocator, &ck);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		else
-			return mfmPoolChunkAllocate(allocator, ck, memory, size);
-	}
-	// Otherwise return error
-	else return MFM_ERROR_ALLOCATOR_OVERFLOW;
+	++allocator->currentFreeSlotCount;
+	return MF_ERROR_OKAY;
 }
 
-mfError mfmPoolDeallocate(mfmPoolAllocator * allocator, void * memory)
+mfError mfmPoolAllocateAligned(mfmPoolAllocator * allocator, void ** memory, mfmU64 size, mfmU64 alignment)
 {
-	// Search for the chunk where the memory was allocated on
-	mfmPoolAllocatorChunk* ck = allocator->firstChunk;
-	while (ck != NULL)
-	{
-		mfError err = mfmPoolChunkDeallocate(memory, allocator, ck);
-		if (err == MF_ERROR_OKAY)
-			return MF_ERROR_OKAY;
-		else if (err != MFM_ERROR_OUT_OF_BOUNDS)
-			return err;
-		ck = (mfmPoolAllocatorChunk*)ck->next;
-	}
+	// Every slot has the pool slot alignment, so bigger alignments can't be supported
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > allocator->slotAlignment)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	return mfmPoolAllocate(allocator, memory, size);
+}
 
-	return MFM_ERROR_OUT_OF_BOUNDS;
+mfmU64 mfmPoolGetSlotAlignment(mfmPoolAllocator * allocator)
+{
+	return allocator->slotAlignment;
 }
 
 mfmU64 mfmPoolGetSlotCount(mfmPoolAllocator * allocator)
@@ -262,4 +318,3 @@ mfmU64 mfmPoolGetFreeSlotCount(mfmPoolAllocator * allocator)
 {
 	return allocator->currentFreeSlotCount;
 }
-
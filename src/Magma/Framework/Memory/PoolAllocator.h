@@ -20,24 +20,45 @@ extern "C"
 
 	typedef struct
 	{
-		mfmU8* slotStatesPtr;
-		mfmBool* slotDataPtr;
-		void* next;
+		mfmU64* slotStatesPtr;
+		mfmU8* slotDataPtr;
+		void* freeSlot;
+		mfmU64 freeSlotCount;
+		mfmU64 untouchedSlotIndex;
+		void* nextAvailable;
 	} mfmPoolAllocatorChunk;
 
 	typedef struct
 	{
 		mfmAllocator base;
 		mfmPoolAllocatorDesc desc;
+		mfmU64 slotStride;
+		mfmU64 slotAlignment;
 		mfmPoolAllocatorChunk* firstChunk;
+		mfmPoolAllocatorChunk* availableChunk;
+		mfmPoolAllocatorChunk** chunkTable;
+		mfmPoolAllocatorChunk* inlineChunkTable[1];
+		mfmU64 chunkTableCapacity;
 		mfmU64 currentSlotCount;
 		mfmU64 currentFreeSlotCount;
 		mfmU64 currentChunkCount;
 		mfmBool onMemory;
 	} mfmPoolAllocator;
 
-#define MFM_POOL_ALLOCATOR_BASE_SIZE (sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk))
-#define MFM_POOL_ALLOCATOR_SIZE(slotCount, slotSize) (MFM_POOL_ALLOCATOR_BASE_SIZE + slotCount * slotSize + slotCount * sizeof(mfmBool))
+	/*
+		Each chunk keeps an intrusive free list (the free slots store the pointer to the next free slot) and a bitmap with one bit per slot marking it as occupied.
+		Slots which were never allocated are handed out sequentially, so creating a pool doesn't touch its slot memory.
+		The chunks with free slots are linked through nextAvailable, and the chunk table is kept sorted by address so a slot's chunk can be found with a binary search.
+		The slot data is aligned to the biggest power of two which divides the slot stride (up to MFM_POOL_ALLOCATOR_MAX_SLOT_ALIGNMENT), so every slot has that alignment.
+	*/
+
+#define MFM_POOL_ALLOCATOR_MAX_SLOT_ALIGNMENT 64
+
+#define MFM_POOL_ALLOCATOR_SLOT_STRIDE(slotSize) ((((slotSize) + sizeof(void*) - 1) / sizeof(void*)) * sizeof(void*))
+#define MFM_POOL_ALLOCATOR_SLOT_ALIGNMENT(slotSize) ((MFM_POOL_ALLOCATOR_SLOT_STRIDE(slotSize) & (~MFM_POOL_ALLOCATOR_SLOT_STRIDE(slotSize) + 1)) < MFM_POOL_ALLOCATOR_MAX_SLOT_ALIGNMENT ? (MFM_POOL_ALLOCATOR_SLOT_STRIDE(slotSize) & (~MFM_POOL_ALLOCATOR_SLOT_STRIDE(slotSize) + 1)) : MFM_POOL_ALLOCATOR_MAX_SLOT_ALIGNMENT)
+#define MFM_POOL_ALLOCATOR_BITMAP_SIZE(slotCount) ((((slotCount) + 63) / 64) * sizeof(mfmU64))
+#define MFM_POOL_ALLOCATOR_BASE_SIZE (sizeof(mfmPoolAllocator) + sizeof(mfmPoolAllocatorChunk) + sizeof(mfmU64) + MFM_POOL_ALLOCATOR_MAX_SLOT_ALIGNMENT)
+#define MFM_POOL_ALLOCATOR_SIZE(slotCount, slotSize) (MFM_POOL_ALLOCATOR_BASE_SIZE + MFM_POOL_ALLOCATOR_BITMAP_SIZE(slotCount) + (slotCount) * MFM_POOL_ALLOCATOR_SLOT_STRIDE(slotSize))
 
 	/// <summary>
 	///		Creates a new magma framework memory pool allocator.
@@ -47,12 +68,13 @@ extern "C"
 	/// <returns>
 	///		Returns MF_ERROR_OKAY if there were no errors.
 	///		Returns MFM_ERROR_ALLOCATION_FAILED if the function couldn't allocate memory for the pool.
-	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the pool description or allocator pointers are NULL.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the pool description or allocator pointers are NULL or if the slot size or count are 0.
 	/// </returns>
 	mfError mfmCreatePoolAllocator(mfmPoolAllocator** poolAllocator, const mfmPoolAllocatorDesc* desc);
 
 	/// <summary>
 	///		Creates a new magma framework memory pool allocator.
+	///		The memory size needed can be obtained with MFM_POOL_ALLOCATOR_SIZE.
 	/// </summary>
 	/// <param name="poolAllocator">Pointer to allocator pointer</param>
 	/// <param name="desc">Pointer to pool allocator description</param>
@@ -92,9 +114,33 @@ extern "C"
 	/// <returns>
 	///		Returns MF_ERROR_OKAY if there were no errors.
 	///		Returns MFM_ERROR_OUT_OF_BOUNDS if the memory is out of the pool bounds.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the memory doesn't point to the beginning of an occupied slot.
 	/// </returns>
 	mfError mfmPoolDeallocate(mfmPoolAllocator* allocator, void* memory);
 
+	/// <summary>
+	///		Allocates on a magma framework memory pool allocator using a specified alignment.
+	///		Only alignments up to the pool slot alignment (see mfmPoolGetSlotAlignment) are supported.
+	///		Memory allocated with this function may be freed with mfmPoolDeallocate.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory pool allocator</param>
+	/// <param name="memory">Pointer to allocated memory pointer</param>
+	/// <param name="size">Memory allocation size in bytes</param>
+	/// <param name="alignment">Memory alignment in bytes (must be a power of two)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the alignment isn't a power of two or is bigger than the pool slot alignment.
+	///		Returns the same errors as mfmPoolAllocate.
+	/// </returns>
+	mfError mfmPoolAllocateAligned(mfmPoolAllocator* allocator, void** memory, mfmU64 size, mfmU64 alignment);
+
+	/// <summary>
+	///		Gets the alignment of the slots in a pool allocator.
+	/// </summary>
+	/// <param name="allocator">AllocatorHandle pointer</param>
+	/// <returns>AllocatorHandle slot alignment in bytes</returns>
+	mfmU64 mfmPoolGetSlotAlignment(mfmPoolAllocator* allocator);
+
 	/// <summary>
 	///		Gets the number of slots in a pool allocator.
 	/// </summary>
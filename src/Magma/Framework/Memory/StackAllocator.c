@@ -1,12 +1,18 @@
 #include "StackAllocator.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 mfError mfmInternalStackAllocate(void* allocator, void** memory, mfmU64 size)
 {
 	return mfmStackAllocate((mfmStackAllocator*)allocator, memory, size);
 }
 
+mfError mfmInternalStackAllocateAligned(void* allocator, void** memory, mfmU64 size, mfmU64 alignment)
+{
+	return mfmStackAllocateAligned((mfmStackAllocator*)allocator, memory, size, alignment);
+}
+
 mfError mfmInternalStackDeallocate(void* allocator, void* memory)
 {
 	return MF_ERROR_OKAY;
@@ -31,10 +37,16 @@ mfError mfmInternalStackReallocate(void* allocator, void* memory, mfmU64 prevSiz
 				return MFM_ERROR_ALLOCATOR_UNDERFLOW;;
 			stackAllocator->stackHead -= prevSize - size;
 		}
-		*newMemory = stackAllocator->stackHead;
+		*newMemory = memory;
 		return MF_ERROR_OKAY;
 	}
-	else return mfmStackAllocate(allocator, newMemory, size);
+
+	// Otherwise allocate new memory and copy the data
+	mfError err = mfmStackAllocate(stackAllocator, newMemory, size);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memcpy(*newMemory, memory, (size_t)(prevSize < size ? prevSize : size));
+	return MF_ERROR_OKAY;
 }
 
 mfError mfmCreateStackAllocator(mfmStackAllocator ** stackAllocator, mfmU64 size)
@@ -59,6 +71,8 @@ mfError mfmCreateStackAllocator(mfmStackAllocator ** stackAllocator, mfmU64 size
 	(*stackAllocator)->base.allocate = &mfmInternalStackAllocate;
 	(*stackAllocator)->base.deallocate = &mfmInternalStackDeallocate;
 	(*stackAllocator)->base.reallocate = &mfmInternalStackReallocate;
+	(*stackAllocator)->base.allocateAligned = &mfmInternalStackAllocateAligned;
+	(*stackAllocator)->base.deallocateAligned = &mfmInternalStackDeallocate;
 
 	// Set destructor function
 	(*stackAllocator)->base.object.destructorFunc = &mfmDestroyStackAllocator;
@@ -84,6 +98,8 @@ mfError mfmCreateStackAllocatorOnMemory(mfmStackAllocator ** stackAllocator, mfm
 	(*stackAllocator)->base.allocate = &mfmInternalStackAllocate;
 	(*stackAllocator)->base.deallocate = &mfmInternalStackDeallocate;
 	(*stackAllocator)->base.reallocate = &mfmInternalStackReallocate;
+	(*stackAllocator)->base.allocateAligned = &mfmInternalStackAllocateAligned;
+	(*stackAllocator)->base.deallocateAligned = &mfmInternalStackDeallocate;
 
 	// Set destructor function
 	(*stackAllocator)->base.object.destructorFunc = &mfmDestroyStackAllocator;
@@ -111,6 +127,24 @@ mfError mfmStackAllocate(mfmStackAllocator * allocator, void ** memory, mfmU64 s
 	return MF_ERROR_OKAY;
 }
 
+mfError mfmStackAllocateAligned(mfmStackAllocator * allocator, void ** memory, mfmU64 size, mfmU64 alignment)
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	// Get the padding needed to align the head
+	mfmU64 padding = (alignment - (mfmU64)allocator->stackHead % alignment) % alignment;
+
+	// Check if allocation fits on the stack
+	if ((mfmU64)(allocator->stackHead - allocator->stackBegin) + padding + size > allocator->stackSize)
+		return MFM_ERROR_ALLOCATOR_OVERFLOW;
+
+	// Get aligned stack head and move it
+	*memory = allocator->stackHead + padding;
+	allocator->stackHead += padding + size;
+	return MF_ERROR_OKAY;
+}
+
 mfError mfmStackSetHead(mfmStackAllocator * allocator, void * head)
 {
 	// Check if new head is out of bounds
@@ -66,6 +66,20 @@ extern "C"
 	/// </returns>
 	mfError mfmStackAllocate(mfmStackAllocator* allocator, void** memory, mfmU64 size);
 
+	/// <summary>
+	///		Allocates on a magma framework memory stack allocator using a specified alignment.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory stack allocator</param>
+	/// <param name="memory">Pointer to allocated memory pointer</param>
+	/// <param name="size">Memory allocation size in bytes</param>
+	/// <param name="alignment">Memory alignment in bytes (must be a power of two)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the alignment isn't a power of two.
+	///		Returns MFM_ERROR_ALLOCATOR_OVERFLOW if the stack overflowed.
+	/// </returns>
+	mfError mfmStackAllocateAligned(mfmStackAllocator* allocator, void** memory, mfmU64 size, mfmU64 alignment);
+
 	/// <summary>
 	///		Sets the stack head on a magma framework memory stack allocator.
 	/// </summary>
@@ -0,0 +1,473 @@
+#include "ThreadCacheAllocator.h"
+#include "Config.h"
+
+#include "../Thread/Mutex.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#define MFM_THREAD_CACHE_LARGE_CLASS 0xFFFFFFFF
+
+typedef struct
+{
+	mfmU32 sizeClass;
+	mfmU32 batchCount;
+	union
+	{
+		void* nextBatch;
+		mfmU64 padding;
+	};
+} mfmThreadCacheBlockHeader;
+
+typedef struct
+{
+	void* next;
+	mfmU64 padding;
+} mfmThreadCacheSpanHeader;
+
+typedef struct mfmThreadCache mfmThreadCache;
+
+struct mfmThreadCache
+{
+	mfmThreadCacheAllocator* allocator;
+	void* freeList[MFM_THREAD_CACHE_CLASS_COUNT];
+	mfmU32 freeCount[MFM_THREAD_CACHE_CLASS_COUNT];
+	mfmThreadCache* prev;
+	mfmThreadCache* next;
+};
+
+static const mfmU32 mfmThreadCacheClassSizes[MFM_THREAD_CACHE_CLASS_COUNT] =
+{
+	16, 32, 48, 64, 80, 96, 112, 128,
+	192, 256, 384, 512, 768, 1024, 1536, 2048,
+};
+
+#define MFM_BLOCK_HEADER(memory) ((mfmThreadCacheBlockHeader*)((mfmU8*)(memory) - sizeof(mfmThreadCacheBlockHeader)))
+#define MFM_BLOCK_NEXT(memory) (*(void**)(memory))
+
+static mfmU32 mfmGetThreadCacheClass(mfmU64 size)
+{
+	if (size <= 128)
+		return (mfmU32)((size + 15) / 16) - 1;
+	for (mfmU32 i = 8; i < MFM_THREAD_CACHE_CLASS_COUNT; ++i)
+		if (size <= mfmThreadCacheClassSizes[i])
+			return i;
+	return MFM_THREAD_CACHE_LARGE_CLASS;
+}
+
+static void mfmReleaseThreadCache(mfmThreadCache* cache);
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+
+#include <Windows.h>
+
+static void NTAPI mfmThreadCacheExitCallback(void* cache)
+{
+	if (cache != NULL)
+		mfmReleaseThreadCache((mfmThreadCache*)cache);
+}
+
+static mfError mfmCreateThreadKey(mfmThreadCacheAllocator* allocator)
+{
+	DWORD index = FlsAlloc(&mfmThreadCacheExitCallback);
+	if (index == FLS_OUT_OF_INDEXES)
+		return MFM_ERROR_INTERNAL;
+	allocator->threadKey = index;
+	return MF_ERROR_OKAY;
+}
+
+static void mfmDestroyThreadKey(mfmThreadCacheAllocator* allocator)
+{
+	// Runs the exit callback for the threads which still have a cache
+	FlsFree((DWORD)allocator->threadKey);
+}
+
+static mfmThreadCache* mfmGetThreadKey(mfmThreadCacheAllocator* allocator)
+{
+	return (mfmThreadCache*)FlsGetValue((DWORD)allocator->threadKey);
+}
+
+static void mfmSetThreadKey(mfmThreadCacheAllocator* allocator, mfmThreadCache* cache)
+{
+	FlsSetValue((DWORD)allocator->threadKey, cache);
+}
+
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+#include <pthread.h>
+
+static void mfmThreadCacheExitCallback(void* cache)
+{
+	if (cache != NULL)
+		mfmReleaseThreadCache((mfmThreadCache*)cache);
+}
+
+static mfError mfmCreateThreadKey(mfmThreadCacheAllocator* allocator)
+{
+	pthread_key_t key;
+	if (pthread_key_create(&key, &mfmThreadCacheExitCallback) != 0)
+		return MFM_ERROR_INTERNAL;
+	allocator->threadKey = (mfmU64)key;
+	return MF_ERROR_OKAY;
+}
+
+static void mfmDestroyThreadKey(mfmThreadCacheAllocator* allocator)
+{
+	// Unlike FlsFree, this doesn't run the exit callback, the remaining caches are freed by the caller
+	pthread_key_delete((pthread_key_t)allocator->threadKey);
+}
+
+static mfmThreadCache* mfmGetThreadKey(mfmThreadCacheAllocator* allocator)
+{
+	return (mfmThreadCache*)pthread_getspecific((pthread_key_t)allocator->threadKey);
+}
+
+static void mfmSetThreadKey(mfmThreadCacheAllocator* allocator, mfmThreadCache* cache)
+{
+	pthread_setspecific((pthread_key_t)allocator->threadKey, cache);
+}
+
+#else
+#error No magma framework thread library support
+#endif
+
+static mfError mfmGetThreadCache(mfmThreadCacheAllocator* allocator, mfmThreadCache** outCache)
+{
+	mfmThreadCache* cache = mfmGetThreadKey(allocator);
+	if (cache != NULL)
+	{
+		*outCache = cache;
+		return MF_ERROR_OKAY;
+	}
+
+	// First use of the allocator on this thread, create its cache
+	if (mftLockMutex(allocator->mutex, 0) != MF_ERROR_OKAY)
+		return MFM_ERROR_INTERNAL;
+	mfError err = mfmAllocate(allocator->desc.backingAllocator, &cache, sizeof(mfmThreadCache));
+	if (err == MF_ERROR_OKAY)
+	{
+		memset(cache, 0, sizeof(mfmThreadCache));
+		cache->allocator = allocator;
+		cache->next = allocator->threadCaches;
+		if (cache->next != NULL)
+			cache->next->prev = cache;
+		allocator->threadCaches = cache;
+	}
+	if (mftUnlockMutex(allocator->mutex) != MF_ERROR_OKAY)
+		return MFM_ERROR_INTERNAL;
+	if (err != MF_ERROR_OKAY)
+		return MFM_ERROR_ALLOCATION_FAILED;
+
+	mfmSetThreadKey(allocator, cache);
+	*outCache = cache;
+	return MF_ERROR_OKAY;
+}
+
+static void mfmPushThreadCacheBatch(mfmThreadCacheAllocator* allocator, mfmU32 sizeClass, void* chain, mfmU32 count)
+{
+	// Must be called with the mutex locked
+	MFM_BLOCK_HEADER(chain)->batchCount = count;
+	MFM_BLOCK_HEADER(chain)->nextBatch = allocator->batches[sizeClass];
+	allocator->batches[sizeClass] = chain;
+}
+
+static mfError mfmRefillThreadCache(mfmThreadCache* cache, mfmU32 sizeClass)
+{
+	mfmThreadCacheAllocator* allocator = cache->allocator;
+	mfmU64 stride = sizeof(mfmThreadCacheBlockHeader) + mfmThreadCacheClassSizes[sizeClass];
+	mfmU8* span = NULL;
+
+	if (mftLockMutex(allocator->mutex, 0) != MF_ERROR_OKAY)
+		return MFM_ERROR_INTERNAL;
+
+	// Take a batch from the shared list, or get a new span from the backing allocator
+	void* batch = allocator->batches[sizeClass];
+	mfError err = MF_ERROR_OKAY;
+	if (batch != NULL)
+		allocator->batches[sizeClass] = MFM_BLOCK_HEADER(batch)->nextBatch;
+	else
+	{
+		err = mfmAllocate(allocator->desc.backingAllocator, &span, sizeof(mfmThreadCacheSpanHeader) + stride * allocator->desc.batchSize);
+		if (err == MF_ERROR_OKAY)
+		{
+			((mfmThreadCacheSpanHeader*)span)->next = allocator->spans;
+			allocator->spans = span;
+		}
+	}
+
+	if (mftUnlockMutex(allocator->mutex) != MF_ERROR_OKAY)
+		return MFM_ERROR_INTERNAL;
+	if (err != MF_ERROR_OKAY)
+		return MFM_ERROR_ALLOCATION_FAILED;
+
+	if (batch != NULL)
+	{
+		cache->freeList[sizeClass] = batch;
+		cache->freeCount[sizeClass] = MFM_BLOCK_HEADER(batch)->batchCount;
+		return MF_ERROR_OKAY;
+	}
+
+	// Split the new span into blocks
+	void* chain = NULL;
+	for (mfmU32 i = allocator->desc.batchSize; i > 0; --i)
+	{
+		mfmThreadCacheBlockHeader* header = (mfmThreadCacheBlockHeader*)(span + sizeof(mfmThreadCacheSpanHeader) + stride * (i - 1));
+		header->sizeClass = sizeClass;
+		void* block = header + 1;
+		MFM_BLOCK_NEXT(block) = chain;
+		chain = block;
+	}
+
+	cache->freeList[sizeClass] = chain;
+	cache->freeCount[sizeClass] = allocator->desc.batchSize;
+	return MF_ERROR_OKAY;
+}
+
+static void mfmReleaseThreadCache(mfmThreadCache* cache)
+{
+	mfmThreadCacheAllocator* allocator = cache->allocator;
+
+	if (mftLockMutex(allocator->mutex, 0) != MF_ERROR_OKAY)
+		abort();
+
+	// Return all the cached blocks to the shared lists
+	for (mfmU32 i = 0; i < MFM_THREAD_CACHE_CLASS_COUNT; ++i)
+		if (cache->freeList[i] != NULL)
+			mfmPushThreadCacheBatch(allocator, i, cache->freeList[i], cache->freeCount[i]);
+
+	// Unlink and free the cache
+	if (cache->prev != NULL)
+		cache->prev->next = cache->next;
+	else
+		allocator->threadCaches = cache->next;
+	if (cache->next != NULL)
+		cache->next->prev = cache->prev;
+	if (mfmDeallocate(allocator->desc.backingAllocator, cache) != MF_ERROR_OKAY)
+		abort();
+
+	if (mftUnlockMutex(allocator->mutex) != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mfmInternalThreadCacheAllocate(void* allocator, void** memory, mfmU64 size)
+{
+	return mfmThreadCacheAllocate((mfmThreadCacheAllocator*)allocator, memory, size);
+}
+
+mfError mfmInternalThreadCacheDeallocate(void* allocator, void* memory)
+{
+	return mfmThreadCacheDeallocate((mfmThreadCacheAllocator*)allocator, memory);
+}
+
+mfError mfmInternalThreadCacheReallocate(void* allocator, void* memory, mfmU64 prevSize, mfmU64 size, void** newMemory)
+{
+	// Reallocating NULL is the same as allocating
+	if (memory == NULL)
+		return mfmThreadCacheAllocate((mfmThreadCacheAllocator*)allocator, newMemory, size);
+
+	// Check if the new size still fits on the block
+	mfmU32 sizeClass = MFM_BLOCK_HEADER(memory)->sizeClass;
+	if (sizeClass < MFM_THREAD_CACHE_CLASS_COUNT && size <= mfmThreadCacheClassSizes[sizeClass])
+	{
+		*newMemory = memory;
+		return MF_ERROR_OKAY;
+	}
+
+	// Move the data to a new block
+	mfError err = mfmThreadCacheAllocate((mfmThreadCacheAllocator*)allocator, newMemory, size);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memcpy(*newMemory, memory, (size_t)(prevSize < size ? prevSize : size));
+	return mfmThreadCacheDeallocate((mfmThreadCacheAllocator*)allocator, memory);
+}
+
+mfError mfmCreateThreadCacheAllocator(mfmThreadCacheAllocator** threadCacheAllocator, const mfmThreadCacheAllocatorDesc* desc)
+{
+	// Check if the arguments are valid
+	if (threadCacheAllocator == NULL || desc == NULL || desc->batchSize == 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	// Allocate memory for the thread cache allocator
+	mfmThreadCacheAllocator* allocator = NULL;
+	if (mfmAllocate(desc->backingAllocator, &allocator, sizeof(mfmThreadCacheAllocator)) != MF_ERROR_OKAY)
+		return MFM_ERROR_ALLOCATION_FAILED;
+	memset(allocator, 0, sizeof(mfmThreadCacheAllocator));
+	memcpy(&allocator->desc, desc, sizeof(mfmThreadCacheAllocatorDesc));
+
+	// Create the shared lists mutex and the thread local storage key
+	if (mftCreateMutex((mftMutex**)&allocator->mutex, desc->backingAllocator) != MF_ERROR_OKAY)
+	{
+		mfmDeallocate(desc->backingAllocator, allocator);
+		return MFM_ERROR_INTERNAL;
+	}
+
+	if (mfmCreateThreadKey(allocator) != MF_ERROR_OKAY)
+	{
+		mftDestroyMutex(allocator->mutex);
+		mfmDeallocate(desc->backingAllocator, allocator);
+		return MFM_ERROR_INTERNAL;
+	}
+
+	// Init object
+	mfError err = mfmInitObject(&allocator->base.object);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDestroyThreadKey(allocator);
+		mftDestroyMutex(allocator->mutex);
+		mfmDeallocate(desc->backingAllocator, allocator);
+		return err;
+	}
+
+	// Set functions
+	allocator->base.allocate = &mfmInternalThreadCacheAllocate;
+	allocator->base.deallocate = &mfmInternalThreadCacheDeallocate;
+	allocator->base.reallocate = &mfmInternalThreadCacheReallocate;
+	allocator->base.allocateAligned = NULL;
+	allocator->base.deallocateAligned = NULL;
+
+	// Set destructor function
+	allocator->base.object.destructorFunc = &mfmDestroyThreadCacheAllocator;
+
+	// Successfully created a thread cache allocator
+	*threadCacheAllocator = allocator;
+	return MF_ERROR_OKAY;
+}
+
+void mfmDestroyThreadCacheAllocator(void* threadCacheAllocator)
+{
+	if (threadCacheAllocator == NULL)
+		abort();
+	mfmThreadCacheAllocator* allocator = threadCacheAllocator;
+
+	mfmDestroyThreadKey(allocator);
+
+	// Free the caches of the threads which haven't exited yet
+	mfmThreadCache* cache = allocator->threadCaches;
+	while (cache != NULL)
+	{
+		mfmThreadCache* next = cache->next;
+		if (mfmDeallocate(allocator->desc.backingAllocator, cache) != MF_ERROR_OKAY)
+			abort();
+		cache = next;
+	}
+
+	// Free all spans
+	void* span = allocator->spans;
+	while (span != NULL)
+	{
+		void* next = ((mfmThreadCacheSpanHeader*)span)->next;
+		if (mfmDeallocate(allocator->desc.backingAllocator, span) != MF_ERROR_OKAY)
+			abort();
+		span = next;
+	}
+
+	if (mftDestroyMutex(allocator->mutex) != MF_ERROR_OKAY)
+		abort();
+	if (mfmDeallocate(allocator->desc.backingAllocator, allocator) != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mfmThreadCacheAllocate(mfmThreadCacheAllocator* allocator, void** memory, mfmU64 size)
+{
+	if (allocator == NULL || memory == NULL || size == 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmU32 sizeClass = mfmGetThreadCacheClass(size);
+
+	// Big allocations go directly to the backing allocator
+	if (sizeClass == MFM_THREAD_CACHE_LARGE_CLASS)
+	{
+		mfmThreadCacheBlockHeader* header = NULL;
+		if (mftLockMutex(allocator->mutex, 0) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+		mfError err = mfmAllocate(allocator->desc.backingAllocator, &header, sizeof(mfmThreadCacheBlockHeader) + size);
+		if (mftUnlockMutex(allocator->mutex) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+		if (err != MF_ERROR_OKAY)
+			return MFM_ERROR_ALLOCATION_FAILED;
+		header->sizeClass = MFM_THREAD_CACHE_LARGE_CLASS;
+		*memory = header + 1;
+		return MF_ERROR_OKAY;
+	}
+
+	// Pop a block from this thread's magazine, refilling it if it is empty
+	mfmThreadCache* cache = NULL;
+	mfError err = mfmGetThreadCache(allocator, &cache);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (cache->freeList[sizeClass] == NULL)
+	{
+		err = mfmRefillThreadCache(cache, sizeClass);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	void* block = cache->freeList[sizeClass];
+	cache->freeList[sizeClass] = MFM_BLOCK_NEXT(block);
+	--cache->freeCount[sizeClass];
+	*memory = block;
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmThreadCacheDeallocate(mfmThreadCacheAllocator* allocator, void* memory)
+{
+	if (allocator == NULL || memory == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmU32 sizeClass = MFM_BLOCK_HEADER(memory)->sizeClass;
+
+	// Big allocations go directly to the backing allocator
+	if (sizeClass == MFM_THREAD_CACHE_LARGE_CLASS)
+	{
+		if (mftLockMutex(allocator->mutex, 0) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+		mfError err = mfmDeallocate(allocator->desc.backingAllocator, MFM_BLOCK_HEADER(memory));
+		if (mftUnlockMutex(allocator->mutex) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+		return err;
+	}
+	else if (sizeClass >= MFM_THREAD_CACHE_CLASS_COUNT)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	// Push the block into this thread's magazine
+	mfmThreadCache* cache = NULL;
+	mfError err = mfmGetThreadCache(allocator, &cache);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	MFM_BLOCK_NEXT(memory) = cache->freeList[sizeClass];
+	cache->freeList[sizeClass] = memory;
+	++cache->freeCount[sizeClass];
+
+	// If the magazine holds too many blocks, return a batch to the shared list
+	if (cache->freeCount[sizeClass] >= 2 * allocator->desc.batchSize)
+	{
+		void* chain = cache->freeList[sizeClass];
+		void* last = chain;
+		for (mfmU32 i = 1; i < allocator->desc.batchSize; ++i)
+			last = MFM_BLOCK_NEXT(last);
+		cache->freeList[sizeClass] = MFM_BLOCK_NEXT(last);
+		cache->freeCount[sizeClass] -= allocator->desc.batchSize;
+		MFM_BLOCK_NEXT(last) = NULL;
+
+		if (mftLockMutex(allocator->mutex, 0) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+		mfmPushThreadCacheBatch(allocator, sizeClass, chain, allocator->desc.batchSize);
+		if (mftUnlockMutex(allocator->mutex) != MF_ERROR_OKAY)
+			return MFM_ERROR_INTERNAL;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+mfError mfmThreadCacheFlush(mfmThreadCacheAllocator* allocator)
+{
+	if (allocator == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmThreadCache* cache = mfmGetThreadKey(allocator);
+	if (cache == NULL)
+		return MF_ERROR_OKAY;
+	mfmSetThreadKey(allocator, NULL);
+	mfmReleaseThreadCache(cache);
+	return MF_ERROR_OKAY;
+}
@@ -0,0 +1,22 @@
+#include "ThreadCacheAllocator.hpp"
+#include "../ErrorString.h"
+
+void Magma::Framework::Memory::HThreadCacheAllocator::Flush()
+{
+	mfError err = mfmThreadCacheFlush((mfmThreadCacheAllocator*)this->GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+}
+
+Magma::Framework::Memory::HThreadCacheAllocator Magma::Framework::Memory::CreateThreadCacheAllocator(mfmU32 batchSize, HAllocator backingAllocator)
+{
+	mfmThreadCacheAllocatorDesc desc;
+	desc.backingAllocator = backingAllocator.GetNoChecks();
+	desc.batchSize = batchSize;
+
+	mfmThreadCacheAllocator* alloc;
+	mfError err = mfmCreateThreadCacheAllocator(&alloc, &desc);
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+	return alloc;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+	Implementation of a thread caching allocator in C.
+	Each thread keeps its own free lists (magazines) for a set of size classes, so most allocations and deallocations don't lock.
+	Blocks are moved between the threads' magazines and the shared lists in batches, and the shared lists are refilled from the backing allocator.
+	Blocks freed on a thread other than the one that allocated them go to the freeing thread's magazine, and are returned to the shared lists once it holds too many.
+	Allocations bigger than MFM_THREAD_CACHE_MAX_SIZE go directly to the backing allocator.
+*/
+
+#include "Allocator.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MFM_THREAD_CACHE_CLASS_COUNT 16
+#define MFM_THREAD_CACHE_MAX_SIZE 2048
+#define MFM_THREAD_CACHE_DEFAULT_BATCH_SIZE 32
+
+	typedef struct
+	{
+		void* backingAllocator;
+		mfmU32 batchSize;
+	} mfmThreadCacheAllocatorDesc;
+
+	typedef struct
+	{
+		mfmAllocator base;
+		mfmThreadCacheAllocatorDesc desc;
+		void* mutex;
+		void* batches[MFM_THREAD_CACHE_CLASS_COUNT];
+		void* spans;
+		void* threadCaches;
+		mfmU64 threadKey;
+	} mfmThreadCacheAllocator;
+
+	/// <summary>
+	///		Creates a new magma framework memory thread cache allocator.
+	/// </summary>
+	/// <param name="threadCacheAllocator">Pointer to allocator pointer</param>
+	/// <param name="desc">Pointer to thread cache allocator description (the backing allocator must outlive the thread cache allocator)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_ALLOCATION_FAILED if the function couldn't allocate memory for the allocator.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the description or allocator pointers are NULL or if the batch size is 0.
+	///		Returns MFM_ERROR_INTERNAL if the thread local storage or the mutex couldn't be created.
+	/// </returns>
+	mfError mfmCreateThreadCacheAllocator(mfmThreadCacheAllocator** threadCacheAllocator, const mfmThreadCacheAllocatorDesc* desc);
+
+	/// <summary>
+	///		Destroys a magma framework memory thread cache allocator.
+	///		All the memory allocated on it is returned to the backing allocator.
+	/// </summary>
+	/// <param name="threadCacheAllocator">Thread cache allocator to destroy</param>
+	void mfmDestroyThreadCacheAllocator(void* threadCacheAllocator);
+
+	/// <summary>
+	///		Allocates on a magma framework memory thread cache allocator.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory thread cache allocator</param>
+	/// <param name="memory">Pointer to allocated memory pointer</param>
+	/// <param name="size">Memory allocation size in bytes</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_ALLOCATION_FAILED if the backing allocator failed to allocate.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the allocator or memory are NULL or size is 0.
+	/// </returns>
+	mfError mfmThreadCacheAllocate(mfmThreadCacheAllocator* allocator, void** memory, mfmU64 size);
+
+	/// <summary>
+	///		Deallocates on a magma framework memory thread cache allocator.
+	///		The memory may have been allocated on any thread.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory thread cache allocator</param>
+	/// <param name="memory">Pointer to the allocated memory</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the allocator or memory are NULL or the memory wasn't allocated on this allocator.
+	///		Returns MFM_ERROR_ALLOCATION_FAILED if the calling thread's cache couldn't be created.
+	/// </returns>
+	mfError mfmThreadCacheDeallocate(mfmThreadCacheAllocator* allocator, void* memory);
+
+	/// <summary>
+	///		Returns the calling thread's cached blocks to the shared lists and frees its cache.
+	///		This is done automatically when a thread exits, but may be called earlier to release memory held by an idle thread.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory thread cache allocator</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the allocator is NULL.
+	/// </returns>
+	mfError mfmThreadCacheFlush(mfmThreadCacheAllocator* allocator);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Exception.hpp"
+#include "Allocator.hpp"
+#include "ThreadCacheAllocator.h"
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace Memory
+		{
+			/// <summary>
+			///		Encapsulates the magma framework C thread cache allocator declared on ThreadCacheAllocator.h.
+			/// </summary>
+			class HThreadCacheAllocator final : public HAllocator
+			{
+			public:
+				using HAllocator::HAllocator;
+
+				/// <summary>
+				///		Returns the calling thread's cached blocks to the shared lists.
+				/// </summary>
+				void Flush();
+			};
+
+			/// <summary>
+			///		Creates a thread cache allocator.
+			/// </summary>
+			/// <param name="batchSize">Number of blocks moved at once between the thread caches and the shared lists</param>
+			/// <param name="backingAllocator">Allocator where the memory will be allocated (must outlive the thread cache allocator)</param>
+			/// <returns>Thread cache allocator handle</returns>
+			HThreadCacheAllocator CreateThreadCacheAllocator(mfmU32 batchSize = MFM_THREAD_CACHE_DEFAULT_BATCH_SIZE, HAllocator backingAllocator = StandardAllocator);
+		}
+	}
+}
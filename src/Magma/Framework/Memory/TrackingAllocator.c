@@ -0,0 +1,323 @@
+#include "TrackingAllocator.h"
+#include "Endianness.h"
+
+#include "../Thread/Mutex.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MFM_TRACKING_HEADER_MAGIC 0x4D464D54
+
+typedef struct
+{
+	mfmU64 size;
+	mfmU32 tagId;
+	mfmU32 magic;
+} mfmTrackingHeader;
+
+#define MFM_TRACKING_HEADER(memory) ((mfmTrackingHeader*)((mfmU8*)(memory) - sizeof(mfmTrackingHeader)))
+
+static mfError mfmTrackingLock(mfmTrackingAllocator* allocator)
+{
+	if (allocator->mutex != NULL && mftLockMutex(allocator->mutex, 0) != MF_ERROR_OKAY)
+		return MFM_ERROR_INTERNAL;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfmTrackingUnlock(mfmTrackingAllocator* allocator)
+{
+	if (allocator->mutex != NULL && mftUnlockMutex(allocator->mutex) != MF_ERROR_OKAY)
+		return MFM_ERROR_INTERNAL;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfmTrackingWriteTag(mfmTrackingAllocator* allocator, mfmU32 tagId, const mfsUTF8CodeUnit* tag)
+{
+	mfmU8 record[7];
+	mfmU64 size = strlen(tag);
+	if (size > MFM_U16_MAX)
+		size = MFM_U16_MAX;
+	mfmU16 size16 = (mfmU16)size;
+
+	// Convert to little endian first, as the record fields aren't aligned
+	mfmToLittleEndian4(&tagId, &tagId);
+	mfmToLittleEndian2(&size16, &size16);
+	record[0] = MFM_TRACKING_RECORD_TAG;
+	memcpy(&record[1], &tagId, sizeof(tagId));
+	memcpy(&record[5], &size16, sizeof(size16));
+
+	mfError err = mfsWrite(allocator->desc.traceStream, record, sizeof(record), NULL);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return mfsWrite(allocator->desc.traceStream, tag, size, NULL);
+}
+
+static mfError mfmTrackingWriteEvent(mfmTrackingAllocator* allocator, mfmU8 type, mfmU32 tagId, void* memory, mfmU64 size)
+{
+	mfmU8 record[21];
+	mfmU64 address = (mfmU64)memory;
+
+	// Convert to little endian first, as the record fields aren't aligned
+	mfmToLittleEndian4(&tagId, &tagId);
+	mfmToLittleEndian8(&address, &address);
+	mfmToLittleEndian8(&size, &size);
+	record[0] = type;
+	memcpy(&record[1], &tagId, sizeof(tagId));
+	memcpy(&record[5], &address, sizeof(address));
+	memcpy(&record[13], &size, sizeof(size));
+
+	return mfsWrite(allocator->desc.traceStream, record, sizeof(record), NULL);
+}
+
+static mfError mfmTrackingGetTagId(mfmTrackingAllocator* allocator, const mfsUTF8CodeUnit* tag, mfmU32* tagId)
+{
+	if (tag == NULL)
+	{
+		*tagId = 0;
+		return MF_ERROR_OKAY;
+	}
+
+	// Tags are static strings, so they are looked up by address on an open addressing table
+	mfmU64 slot = ((mfmU64)tag >> 3) % MFM_TRACKING_MAX_TAGS;
+	for (mfmU64 i = 0; i < MFM_TRACKING_MAX_TAGS; ++i)
+	{
+		if (allocator->tags[slot] == tag)
+		{
+			*tagId = (mfmU32)slot + 1;
+			return MF_ERROR_OKAY;
+		}
+		else if (allocator->tags[slot] == NULL)
+		{
+			allocator->tags[slot] = tag;
+			++allocator->tagCount;
+			*tagId = (mfmU32)slot + 1;
+			if (allocator->desc.traceStream != NULL)
+				return mfmTrackingWriteTag(allocator, *tagId, tag);
+			return MF_ERROR_OKAY;
+		}
+		slot = (slot + 1) % MFM_TRACKING_MAX_TAGS;
+	}
+
+	// The tag table is full
+	*tagId = 0;
+	return MF_ERROR_OKAY;
+}
+
+static void mfmTrackingAddAllocation(mfmTrackingAllocator* allocator, mfmU64 size)
+{
+	allocator->stats.liveBytes += size;
+	if (allocator->stats.liveBytes > allocator->stats.peakBytes)
+		allocator->stats.peakBytes = allocator->stats.liveBytes;
+	++allocator->stats.liveAllocationCount;
+	++allocator->stats.allocationCount;
+
+	mfmU64 bucket = 0;
+	while (bucket < MFM_TRACKING_HISTOGRAM_SIZE - 1 && (size >> (bucket + 1)) != 0)
+		++bucket;
+	++allocator->stats.histogram[bucket];
+}
+
+static void mfmTrackingRemoveAllocation(mfmTrackingAllocator* allocator, mfmU64 size)
+{
+	allocator->stats.liveBytes -= size;
+	--allocator->stats.liveAllocationCount;
+	++allocator->stats.deallocationCount;
+}
+
+mfError mfmInternalTrackingAllocate(void* allocator, void** memory, mfmU64 size)
+{
+	return mfmTrackingAllocateTagged((mfmTrackingAllocator*)allocator, memory, size, NULL);
+}
+
+mfError mfmInternalTrackingDeallocate(void* allocator, void* memory)
+{
+	mfmTrackingAllocator* trackingAllocator = allocator;
+	mfmTrackingHeader* header = MFM_TRACKING_HEADER(memory);
+
+	// The event is recorded before the memory is freed, so that another thread can't reuse the address and record it first
+	mfError err = mfmTrackingLock(trackingAllocator);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (header->magic != MFM_TRACKING_HEADER_MAGIC)
+	{
+		mfmTrackingUnlock(trackingAllocator);
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	}
+	mfmU64 size = header->size;
+	mfmTrackingRemoveAllocation(trackingAllocator, size);
+	if (trackingAllocator->desc.traceStream != NULL)
+		err = mfmTrackingWriteEvent(trackingAllocator, MFM_TRACKING_RECORD_DEALLOCATE, header->tagId, memory, size);
+	header->magic = 0;
+
+	mfError deallocateErr = mfmDeallocate(trackingAllocator->desc.backingAllocator, header);
+	mfError unlockErr = mfmTrackingUnlock(trackingAllocator);
+	if (deallocateErr != MF_ERROR_OKAY)
+		return deallocateErr;
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return unlockErr;
+}
+
+mfError mfmInternalTrackingReallocate(void* allocator, void* memory, mfmU64 prevSize, mfmU64 size, void** newMemory)
+{
+	mfmTrackingAllocator* trackingAllocator = allocator;
+	mfmTrackingHeader* header = MFM_TRACKING_HEADER(memory);
+
+	// The lock is held across the reallocation, so the old and new addresses are recorded together
+	mfError err = mfmTrackingLock(trackingAllocator);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (header->magic != MFM_TRACKING_HEADER_MAGIC)
+	{
+		mfmTrackingUnlock(trackingAllocator);
+		return MFM_ERROR_INVALID_ARGUMENTS;
+	}
+	mfmU64 oldSize = header->size;
+	mfmU32 tagId = header->tagId;
+
+	mfmTrackingHeader* newHeader = NULL;
+	err = mfmReallocate(trackingAllocator->desc.backingAllocator, header, sizeof(mfmTrackingHeader) + oldSize, sizeof(mfmTrackingHeader) + size, &newHeader);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmTrackingUnlock(trackingAllocator);
+		return err;
+	}
+	newHeader->size = size;
+	*newMemory = newHeader + 1;
+
+	mfmTrackingRemoveAllocation(trackingAllocator, oldSize);
+	mfmTrackingAddAllocation(trackingAllocator, size);
+	--trackingAllocator->stats.allocationCount;
+	--trackingAllocator->stats.deallocationCount;
+	++trackingAllocator->stats.reallocationCount;
+	if (trackingAllocator->desc.traceStream != NULL)
+	{
+		err = mfmTrackingWriteEvent(trackingAllocator, MFM_TRACKING_RECORD_DEALLOCATE, tagId, memory, oldSize);
+		if (err == MF_ERROR_OKAY)
+			err = mfmTrackingWriteEvent(trackingAllocator, MFM_TRACKING_RECORD_ALLOCATE, tagId, *newMemory, size);
+	}
+	mfError unlockErr = mfmTrackingUnlock(trackingAllocator);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return unlockErr;
+}
+
+mfError mfmCreateTrackingAllocator(mfmTrackingAllocator** trackingAllocator, const mfmTrackingAllocatorDesc* desc)
+{
+	// Check if the arguments are valid
+	if (trackingAllocator == NULL || desc == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	// Allocate memory for the tracking allocator
+	mfmTrackingAllocator* allocator = NULL;
+	if (mfmAllocate(NULL, &allocator, sizeof(mfmTrackingAllocator)) != MF_ERROR_OKAY)
+		return MFM_ERROR_ALLOCATION_FAILED;
+	memset(allocator, 0, sizeof(mfmTrackingAllocator));
+	memcpy(&allocator->desc, desc, sizeof(mfmTrackingAllocatorDesc));
+
+	// Create the mutex
+	if (desc->threadSafe == MFM_TRUE && mftCreateMutex((mftMutex**)&allocator->mutex, NULL) != MF_ERROR_OKAY)
+	{
+		mfmDeallocate(NULL, allocator);
+		return MFM_ERROR_INTERNAL;
+	}
+
+	// Write trace header
+	if (desc->traceStream != NULL)
+	{
+		const mfmU8 header[5] = { 'M', 'F', 'M', 'T', MFM_TRACKING_TRACE_VERSION };
+		if (mfsWrite(desc->traceStream, header, sizeof(header), NULL) != MF_ERROR_OKAY)
+		{
+			if (allocator->mutex != NULL)
+				mftDestroyMutex(allocator->mutex);
+			mfmDeallocate(NULL, allocator);
+			return MFM_ERROR_INTERNAL;
+		}
+	}
+
+	// Init object
+	mfError err = mfmInitObject(&allocator->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	// Set functions
+	allocator->base.allocate = &mfmInternalTrackingAllocate;
+	allocator->base.deallocate = &mfmInternalTrackingDeallocate;
+	allocator->base.reallocate = &mfmInternalTrackingReallocate;
+	allocator->base.allocateAligned = NULL;
+	allocator->base.deallocateAligned = NULL;
+
+	// Set destructor function
+	allocator->base.object.destructorFunc = &mfmDestroyTrackingAllocator;
+
+	// Successfully created a tracking allocator
+	*trackingAllocator = allocator;
+	return MF_ERROR_OKAY;
+}
+
+void mfmDestroyTrackingAllocator(void* trackingAllocator)
+{
+	if (trackingAllocator == NULL)
+		abort();
+	mfmTrackingAllocator* allocator = trackingAllocator;
+
+	if (allocator->desc.traceStream != NULL)
+		mfsFlush(allocator->desc.traceStream);
+	if (allocator->mutex != NULL)
+		if (mftDestroyMutex(allocator->mutex) != MF_ERROR_OKAY)
+			abort();
+	if (mfmDeallocate(NULL, allocator) != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mfmTrackingAllocateTagged(mfmTrackingAllocator* allocator, void** memory, mfmU64 size, const mfsUTF8CodeUnit* tag)
+{
+	if (allocator == NULL || memory == NULL || size == 0)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfmTrackingHeader* header = NULL;
+	mfError err = mfmAllocate(allocator->desc.backingAllocator, &header, sizeof(mfmTrackingHeader) + size);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	*memory = header + 1;
+
+	err = mfmTrackingLock(allocator);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	mfmU32 tagId = 0;
+	err = mfmTrackingGetTagId(allocator, tag != NULL ? tag : allocator->currentTag, &tagId);
+	header->size = size;
+	header->tagId = tagId;
+	header->magic = MFM_TRACKING_HEADER_MAGIC;
+	mfmTrackingAddAllocation(allocator, size);
+	if (err == MF_ERROR_OKAY && allocator->desc.traceStream != NULL)
+		err = mfmTrackingWriteEvent(allocator, MFM_TRACKING_RECORD_ALLOCATE, tagId, *memory, size);
+	mfError unlockErr = mfmTrackingUnlock(allocator);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return unlockErr;
+}
+
+const mfsUTF8CodeUnit* mfmTrackingSetTag(mfmTrackingAllocator* allocator, const mfsUTF8CodeUnit* tag)
+{
+	// The current tag is read by allocations on other threads, so it is swapped under the lock
+	if (mfmTrackingLock(allocator) != MF_ERROR_OKAY)
+		abort();
+	const mfsUTF8CodeUnit* previous = allocator->currentTag;
+	allocator->currentTag = tag;
+	if (mfmTrackingUnlock(allocator) != MF_ERROR_OKAY)
+		abort();
+	return previous;
+}
+
+mfError mfmTrackingGetStats(mfmTrackingAllocator* allocator, mfmTrackingStats* stats)
+{
+	if (allocator == NULL || stats == NULL)
+		return MFM_ERROR_INVALID_ARGUMENTS;
+
+	mfError err = mfmTrackingLock(allocator);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memcpy(stats, &allocator->stats, sizeof(mfmTrackingStats));
+	return mfmTrackingUnlock(allocator);
+}
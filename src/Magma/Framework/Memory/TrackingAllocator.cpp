@@ -0,0 +1,39 @@
+#include "TrackingAllocator.hpp"
+#include "../ErrorString.h"
+
+void * Magma::Framework::Memory::TrackingAllocatorHandle::AllocateTagged(mfmU64 size, const mfsUTF8CodeUnit* tag)
+{
+	void* mem;
+	mfError err = mfmTrackingAllocateTagged((mfmTrackingAllocator*)this->GetNoChecks(), &mem, size, tag);
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+	return mem;
+}
+
+const mfsUTF8CodeUnit * Magma::Framework::Memory::TrackingAllocatorHandle::SetTag(const mfsUTF8CodeUnit* tag)
+{
+	return mfmTrackingSetTag((mfmTrackingAllocator*)this->GetNoChecks(), tag);
+}
+
+mfmTrackingStats Magma::Framework::Memory::TrackingAllocatorHandle::GetStats()
+{
+	mfmTrackingStats stats;
+	mfError err = mfmTrackingGetStats((mfmTrackingAllocator*)this->GetNoChecks(), &stats);
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+	return stats;
+}
+
+Magma::Framework::Memory::TrackingAllocatorHandle Magma::Framework::Memory::CreateTrackingAllocator(HAllocator backingAllocator, Handle traceStream, bool threadSafe)
+{
+	mfmTrackingAllocatorDesc desc;
+	desc.backingAllocator = backingAllocator.GetNoChecks();
+	desc.traceStream = (mfsStream*)traceStream.GetNoChecks();
+	desc.threadSafe = threadSafe ? MFM_TRUE : MFM_FALSE;
+
+	mfmTrackingAllocator* alloc;
+	mfError err = mfmCreateTrackingAllocator(&alloc, &desc);
+	if (err != MF_ERROR_OKAY)
+		throw AllocatorError(mfErrorToString(err));
+	return alloc;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+/*
+	Implementation of a tracking allocator in C.
+	Wraps another allocator and records statistics about the allocations made through it.
+	Optionally writes every allocation event to a binary trace stream, which can be summarised offline.
+
+	Each allocation has a small header before it with its size and tag, so the statistics and the trace have the exact sizes.
+	Tags are static strings identifying the callsite or subsystem (see MFM_TRACKING_CALLSITE and mfmTrackingSetTag).
+
+	Trace format (all values are little endian):
+		Header: the 4 bytes 'M', 'F', 'M', 'T' followed by the u8 version (MFM_TRACKING_TRACE_VERSION).
+		Followed by records, each one starting with an u8 record type:
+			MFM_TRACKING_RECORD_TAG:		u32 tag id, u16 string size, string bytes (no null terminator).
+			MFM_TRACKING_RECORD_ALLOCATE:	u32 tag id, u64 address, u64 size.
+			MFM_TRACKING_RECORD_DEALLOCATE:	u32 tag id, u64 address, u64 size.
+		A tag record is written before the first record that uses its id. The tag id 0 is reserved for untagged allocations.
+		Reallocations are written as a deallocation followed by an allocation.
+*/
+
+#include "Allocator.h"
+#include "../String/Stream.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MFM_TRACKING_HISTOGRAM_SIZE 32
+#define MFM_TRACKING_MAX_TAGS 256
+#define MFM_TRACKING_TRACE_VERSION 0x01
+
+#define MFM_TRACKING_RECORD_TAG			0x01
+#define MFM_TRACKING_RECORD_ALLOCATE	0x02
+#define MFM_TRACKING_RECORD_DEALLOCATE	0x03
+
+#define MFM_TRACKING_STRINGIFY_INTERNAL(x) #x
+#define MFM_TRACKING_STRINGIFY(x) MFM_TRACKING_STRINGIFY_INTERNAL(x)
+
+	/// <summary>
+	///		Tag string identifying the current source file and line.
+	/// </summary>
+#define MFM_TRACKING_CALLSITE (__FILE__ ":" MFM_TRACKING_STRINGIFY(__LINE__))
+
+	typedef struct
+	{
+		mfmU64 liveBytes;
+		mfmU64 peakBytes;
+		mfmU64 liveAllocationCount;
+		mfmU64 allocationCount;
+		mfmU64 deallocationCount;
+		mfmU64 reallocationCount;
+
+		/// <summary>
+		///		Number of allocations by size, the index i counts the allocations with sizes between 2^i and 2^(i+1) - 1.
+		/// </summary>
+		mfmU64 histogram[MFM_TRACKING_HISTOGRAM_SIZE];
+	} mfmTrackingStats;
+
+	typedef struct
+	{
+		void* backingAllocator;
+		mfsStream* traceStream;
+		mfmBool threadSafe;
+	} mfmTrackingAllocatorDesc;
+
+	typedef struct
+	{
+		mfmAllocator base;
+		mfmTrackingAllocatorDesc desc;
+		mfmTrackingStats stats;
+		void* mutex;
+		const mfsUTF8CodeUnit* currentTag;
+		const mfsUTF8CodeUnit* tags[MFM_TRACKING_MAX_TAGS];
+		mfmU32 tagCount;
+	} mfmTrackingAllocator;
+
+	/// <summary>
+	///		Creates a new magma framework memory tracking allocator.
+	/// </summary>
+	/// <param name="trackingAllocator">Pointer to allocator pointer</param>
+	/// <param name="desc">
+	///		Pointer to tracking allocator description.
+	///		The backing allocator and trace stream (set to NULL to disable tracing) must outlive the tracking allocator.
+	///		If threadSafe is MFM_TRUE, the statistics and trace are protected by a mutex (the backing allocator must be thread safe itself).
+	/// </param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_ALLOCATION_FAILED if the function couldn't allocate memory for the allocator.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the description or allocator pointers are NULL.
+	///		Returns MFM_ERROR_INTERNAL if the mutex couldn't be created or the trace header couldn't be written.
+	/// </returns>
+	mfError mfmCreateTrackingAllocator(mfmTrackingAllocator** trackingAllocator, const mfmTrackingAllocatorDesc* desc);
+
+	/// <summary>
+	///		Destroys a magma framework memory tracking allocator.
+	///		Flushes the trace stream, if there is one.
+	/// </summary>
+	/// <param name="trackingAllocator">Tracking allocator to destroy</param>
+	void mfmDestroyTrackingAllocator(void* trackingAllocator);
+
+	/// <summary>
+	///		Allocates on a magma framework memory tracking allocator with a specific tag.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory tracking allocator</param>
+	/// <param name="memory">Pointer to allocated memory pointer</param>
+	/// <param name="size">Memory allocation size in bytes</param>
+	/// <param name="tag">Static tag string (if NULL, the current tag is used)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the allocator or memory are NULL or size is 0.
+	///		Returns the errors returned by the backing allocator or by the trace stream.
+	/// </returns>
+	mfError mfmTrackingAllocateTagged(mfmTrackingAllocator* allocator, void** memory, mfmU64 size, const mfsUTF8CodeUnit* tag);
+
+	/// <summary>
+	///		Allocates on a magma framework memory tracking allocator tagging the allocation with the callsite.
+	/// </summary>
+#define MFM_TRACKING_ALLOCATE(allocator, memory, size) mfmTrackingAllocateTagged(allocator, memory, size, MFM_TRACKING_CALLSITE)
+
+	/// <summary>
+	///		Sets the tag used for allocations which aren't explicitly tagged.
+	///		Can be used to attribute the allocations made by a subsystem through the generic allocator interface.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory tracking allocator</param>
+	/// <param name="tag">Static tag string (set to NULL to stop tagging)</param>
+	/// <returns>Previous tag</returns>
+	const mfsUTF8CodeUnit* mfmTrackingSetTag(mfmTrackingAllocator* allocator, const mfsUTF8CodeUnit* tag);
+
+	/// <summary>
+	///		Gets the current statistics of a magma framework memory tracking allocator.
+	/// </summary>
+	/// <param name="allocator">Magma framework memory tracking allocator</param>
+	/// <param name="stats">Out statistics</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFM_ERROR_INVALID_ARGUMENTS if the allocator or stats are NULL.
+	/// </returns>
+	mfError mfmTrackingGetStats(mfmTrackingAllocator* allocator, mfmTrackingStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
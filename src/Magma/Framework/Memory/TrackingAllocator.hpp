@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Exception.hpp"
+#include "Allocator.hpp"
+#include "TrackingAllocator.h"
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace Memory
+		{
+			/// <summary>
+			///		Encapsulates the magma framework C tracking allocator declared on TrackingAllocator.h.
+			/// </summary>
+			class TrackingAllocatorHandle final : public HAllocator
+			{
+			public:
+				using HAllocator::HAllocator;
+
+				/// <summary>
+				///		Allocates data with a specific tag.
+				/// </summary>
+				/// <param name="size">Data size in bytes</param>
+				/// <param name="tag">Static tag string</param>
+				/// <returns>Pointer to allocated data</returns>
+				void* AllocateTagged(mfmU64 size, const mfsUTF8CodeUnit* tag);
+
+				/// <summary>
+				///		Sets the tag used for allocations which aren't explicitly tagged.
+				/// </summary>
+				/// <param name="tag">Static tag string (set to NULL to stop tagging)</param>
+				/// <returns>Previous tag</returns>
+				const mfsUTF8CodeUnit* SetTag(const mfsUTF8CodeUnit* tag);
+
+				/// <summary>
+				///		Gets the current allocation statistics.
+				/// </summary>
+				/// <returns>Allocation statistics</returns>
+				mfmTrackingStats GetStats();
+			};
+
+			/// <summary>
+			///		Creates a tracking allocator.
+			/// </summary>
+			/// <param name="backingAllocator">Allocator where the memory will be allocated (must outlive the tracking allocator)</param>
+			/// <param name="traceStream">Stream where the allocation trace is written (must outlive the tracking allocator, NULL disables tracing)</param>
+			/// <param name="threadSafe">Should the statistics and trace be protected by a mutex?</param>
+			/// <returns>Tracking allocator handle</returns>
+			TrackingAllocatorHandle CreateTrackingAllocator(HAllocator backingAllocator = StandardAllocator, Handle traceStream = Handle(), bool threadSafe = false);
+		}
+	}
+}
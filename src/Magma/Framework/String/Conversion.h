@@ -8,6 +8,12 @@
 Stream and function declarations.
 */
 
+/// <summary>
+///		When passed as the number of decimal places to mfsPrintToBufferF32 or mfsPrintToBufferF64, the shortest
+///		representation which is parsed back to the same value is printed instead (only supported in base 10).
+/// </summary>
+#define MFS_SHORTEST_DECIMAL_PLACES ((mfmU64)-1)
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -100,7 +106,7 @@ extern "C"
 	/// <param name="bufferSize">Buffer size</param>
 	/// <param name="value">Value to print</param>
 	/// <param name="base">Print base (2-16)</param>
-	/// <param name="decimalPlaces">Number of decimal places to show</param>
+	/// <param name="decimalPlaces">Number of decimal places to show, or MFS_SHORTEST_DECIMAL_PLACES</param>
 	/// <param name="outSize">Out write size</param>
 	mfError mfsPrintToBufferF32(mfsUTF8CodeUnit* buffer, mfmU64 bufferSize, mfmF32 value, mfmU64 base, mfmU64 decimalPlaces, mfmU64* outSize);
 
@@ -111,7 +117,7 @@ extern "C"
 	/// <param name="bufferSize">Buffer size</param>
 	/// <param name="value">Value to print</param>
 	/// <param name="base">Print base (2-16)</param>
-	/// <param name="decimalPlaces">Number of decimal places to show</param>
+	/// <param name="decimalPlaces">Number of decimal places to show, or MFS_SHORTEST_DECIMAL_PLACES</param>
 	/// <param name="outSize">Out write size</param>
 	mfError mfsPrintToBufferF64(mfsUTF8CodeUnit* buffer, mfmU64 bufferSize, mfmF64 value, mfmU64 base, mfmU64 decimalPlaces, mfmU64* outSize);
 
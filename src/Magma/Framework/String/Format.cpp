@@ -0,0 +1,21 @@
+#include "Format.hpp"
+
+void Magma::Framework::String::Format::Buffer::Flush()
+{
+	mfmU64 size = m_size;
+	m_size = 0;
+	this->Write(m_data, size);
+}
+
+void Magma::Framework::String::Format::Buffer::Write(const mfsUTF8CodeUnit * data, mfmU64 size)
+{
+	if (size == 0)
+		return;
+
+	mfmU64 writtenSize = 0;
+	mfError err = mfsWrite(m_stream, data, size, &writtenSize);
+	if (err == MF_ERROR_OKAY && writtenSize != size)
+		err = MFS_ERROR_FAILED_TO_WRITE_ALL;
+	if (err != MF_ERROR_OKAY)
+		throw StreamError(ErrorToString(err));
+}
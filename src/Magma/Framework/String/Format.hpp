@@ -0,0 +1,442 @@
+#pragma once
+
+#include "Stream.h"
+#include "Conversion.h"
+#include "Exception.hpp"
+
+#include <array>
+#include <cstring>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*
+	Compile-time format strings.
+	The format string is parsed and validated while compiling, and each print turns into a fixed sequence of appends to a
+	buffer on the stack, which is written to the stream at the end. No varargs are used and nothing is parsed at runtime.
+
+	The format language is the same as the one used by mfsPrintFormat:
+		"%%" followed by optional parameters and a type:
+			Parameters:
+				"-bX" - sets the base (X: b = 2, f = 4, o = 8, d = 10, h = 16).
+				"-dX" - sets the number of decimal places (X: 0 - 9).
+			Types:
+				"u" - unsigned 32 bit integer.
+				"ul" - unsigned 64 bit integer.
+				"i" - signed 32 bit integer.
+				"il" - signed 64 bit integer.
+				"f" - floating point.
+				"c" - character.
+				"s" - UTF-8 null-terminated string.
+				"p" - pointer.
+		"%d", "%x", "%f", "%c" and "%s" (old formatting).
+		"\" escapes the next character.
+
+	Example:
+		stream.PrintFormat(MFS_FORMAT(u8"%%-bhu, %%-d2f\n"), 255u, 3.14159);
+*/
+
+/// <summary>
+///		Creates a compile-time format string from a UTF-8 string literal, to be used with PrintFormat.
+///		Invalid format strings and arguments whose types don't match their specifiers fail to compile.
+/// </summary>
+#define MFS_FORMAT(str) ([] { \
+	struct FormatString : ::Magma::Framework::String::Format::FormatStringBase \
+	{ static constexpr const mfsUTF8CodeUnit* Get() { return str; } }; \
+	return FormatString(); }())
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace String
+		{
+			namespace Format
+			{
+				/// <summary>
+				///		Base of every format string type created with MFS_FORMAT.
+				/// </summary>
+				struct FormatStringBase {};
+
+				/// <summary>
+				///		Format segment types.
+				/// </summary>
+				enum class SegmentType
+				{
+					Invalid,
+					Literal,
+					U32,
+					U64,
+					I32,
+					I64,
+					F64,
+					Character,
+					String,
+					Pointer,
+				};
+
+				/// <summary>
+				///		A part of a format string: either a literal run of characters or an argument.
+				/// </summary>
+				struct Segment
+				{
+					SegmentType type = SegmentType::Invalid;
+					mfmU64 begin = 0;
+					mfmU64 size = 0;
+					mfmU64 argument = 0;
+					mfmU64 base = 10;
+					mfmU64 decimalPlaces = 4;
+				};
+
+				/// <summary>
+				///		Parses the segment which starts at a position on a format string.
+				///		On return, position points to the next segment.
+				/// </summary>
+				/// <param name="format">Format string</param>
+				/// <param name="position">Segment position</param>
+				/// <param name="segment">Out segment (type is Invalid if the segment is invalid)</param>
+				/// <returns>True if a segment was parsed, false if the end of the string was reached</returns>
+				constexpr bool ParseSegment(const mfsUTF8CodeUnit* format, mfmU64& position, Segment& segment)
+				{
+					segment = Segment();
+					if (format[position] == '\0')
+						return false;
+
+					// New formatting
+					if (format[position] == '%' && format[position + 1] == '%')
+					{
+						position += 2;
+						while (format[position] == '-')
+						{
+							if (format[position + 1] == 'b')
+							{
+								switch (format[position + 2])
+								{
+									case 'b': segment.base = 2; break;
+									case 'f': segment.base = 4; break;
+									case 'o': segment.base = 8; break;
+									case 'd': segment.base = 10; break;
+									case 'h': segment.base = 16; break;
+									default: return true;
+								}
+							}
+							else if (format[position + 1] == 'd')
+							{
+								if (format[position + 2] < '0' || format[position + 2] > '9')
+									return true;
+								segment.decimalPlaces = static_cast<mfmU64>(format[position + 2] - '0');
+							}
+							else
+								return true;
+							position += 3;
+						}
+
+						switch (format[position])
+						{
+							case 'u':
+								segment.type = format[position + 1] == 'l' ? SegmentType::U64 : SegmentType::U32;
+								break;
+							case 'i':
+								segment.type = format[position + 1] == 'l' ? SegmentType::I64 : SegmentType::I32;
+								break;
+							case 'f': segment.type = SegmentType::F64; break;
+							case 'c': segment.type = SegmentType::Character; break;
+							case 's': segment.type = SegmentType::String; break;
+							case 'p': segment.type = SegmentType::Pointer; break;
+							default: return true;
+						}
+						position += (segment.type == SegmentType::U64 || segment.type == SegmentType::I64) ? 2 : 1;
+						return true;
+					}
+
+					// Old formatting
+					if (format[position] == '%')
+					{
+						switch (format[position + 1])
+						{
+							case 'd': segment.type = SegmentType::I32; break;
+							case 'x': segment.type = SegmentType::I32; segment.base = 16; break;
+							case 'f': segment.type = SegmentType::F64; break;
+							case 'c': segment.type = SegmentType::Character; break;
+							case 's': segment.type = SegmentType::String; break;
+							default: return true;
+						}
+						position += 2;
+						return true;
+					}
+
+					// Literal, until the next escape or argument
+					segment.type = SegmentType::Literal;
+					if (format[position] == '\\')
+					{
+						++position;
+						if (format[position] == '\0')
+							return false;
+						segment.begin = position++;
+					}
+					else
+						segment.begin = position;
+					while (format[position] != '\0' && format[position] != '\\' && format[position] != '%')
+						++position;
+					segment.size = position - segment.begin;
+					return true;
+				}
+
+				/// <summary>
+				///		Counts the segments in a format string.
+				/// </summary>
+				/// <param name="format">Format string</param>
+				/// <returns>Segment count</returns>
+				constexpr mfmU64 CountSegments(const mfsUTF8CodeUnit* format)
+				{
+					mfmU64 position = 0, count = 0;
+					Segment segment;
+					while (ParseSegment(format, position, segment))
+					{
+						++count;
+						if (segment.type == SegmentType::Invalid)
+							break;
+					}
+					return count;
+				}
+
+				/// <summary>
+				///		Parses every segment in a format string and numbers their arguments.
+				/// </summary>
+				/// <returns>Segment array</returns>
+				template <typename S, mfmU64 Count = CountSegments(S::Get())>
+				constexpr std::array<Segment, Count> ParseSegments()
+				{
+					std::array<Segment, Count> segments = {};
+					mfmU64 position = 0, argument = 0;
+					for (mfmU64 i = 0; i < Count; ++i)
+					{
+						ParseSegment(S::Get(), position, segments[i]);
+						if (segments[i].type != SegmentType::Literal)
+							segments[i].argument = argument++;
+					}
+					return segments;
+				}
+
+				/// <summary>
+				///		Parsed segments of a format string.
+				/// </summary>
+				template <typename S>
+				constexpr auto Segments = ParseSegments<S>();
+
+				/// <summary>
+				///		Checks if a format string is valid.
+				/// </summary>
+				template <typename S>
+				constexpr bool IsValid()
+				{
+					for (const Segment& segment : Segments<S>)
+						if (segment.type == SegmentType::Invalid)
+							return false;
+					return true;
+				}
+
+				/// <summary>
+				///		Counts the arguments used by a format string.
+				/// </summary>
+				template <typename S>
+				constexpr mfmU64 CountArguments()
+				{
+					mfmU64 count = 0;
+					for (const Segment& segment : Segments<S>)
+						if (segment.type != SegmentType::Literal)
+							++count;
+					return count;
+				}
+
+				/// <summary>
+				///		Checks if an argument type can be printed with a segment type.
+				///		Integers may only be widened and must have the same signedness as the specifier.
+				/// </summary>
+				template <SegmentType Type, typename T>
+				constexpr bool Accepts()
+				{
+					using V = std::remove_cv_t<std::remove_reference_t<T>>;
+					if constexpr (Type == SegmentType::U32 || Type == SegmentType::U64)
+						return std::is_integral<V>::value && std::is_unsigned<V>::value && !std::is_same<V, bool>::value &&
+							sizeof(V) <= (Type == SegmentType::U32 ? sizeof(mfmU32) : sizeof(mfmU64));
+					else if constexpr (Type == SegmentType::I32 || Type == SegmentType::I64)
+						return std::is_integral<V>::value && std::is_signed<V>::value &&
+							sizeof(V) <= (Type == SegmentType::I32 ? sizeof(mfmI32) : sizeof(mfmI64));
+					else if constexpr (Type == SegmentType::F64)
+						return std::is_floating_point<V>::value;
+					else if constexpr (Type == SegmentType::Character)
+						return std::is_integral<V>::value && !std::is_same<V, bool>::value;
+					else if constexpr (Type == SegmentType::String)
+						return std::is_convertible<const V&, const mfsUTF8CodeUnit*>::value;
+					else if constexpr (Type == SegmentType::Pointer)
+						return std::is_pointer<V>::value || std::is_null_pointer<V>::value;
+					else
+						return false;
+				}
+
+				/// <summary>
+				///		Buffer on the stack where formatted data is appended before being written to a stream.
+				/// </summary>
+				class Buffer final
+				{
+				public:
+					inline Buffer(mfsStream* stream) : m_stream(stream), m_size(0) {}
+
+					/// <summary>
+					///		Appends data to the buffer.
+					/// </summary>
+					/// <param name="data">Data</param>
+					/// <param name="size">Data size in bytes</param>
+					inline void Put(const mfsUTF8CodeUnit* data, mfmU64 size)
+					{
+						if (m_size + size <= Size)
+						{
+							memcpy(m_data + m_size, data, size);
+							m_size += size;
+							return;
+						}
+
+						// Data which doesn't fit in the buffer is written directly
+						this->Flush();
+						if (size > Size)
+							this->Write(data, size);
+						else
+						{
+							memcpy(m_data, data, size);
+							m_size = size;
+						}
+					}
+
+					/// <summary>
+					///		Appends a single character to the buffer.
+					/// </summary>
+					/// <param name="character">Character</param>
+					inline void PutCharacter(mfsUTF8CodeUnit character)
+					{
+						if (m_size == Size)
+							this->Flush();
+						m_data[m_size++] = character;
+					}
+
+					/// <summary>
+					///		Prints a number directly into the buffer.
+					/// </summary>
+					/// <param name="value">Value</param>
+					template <SegmentType Type, mfmU64 Base, mfmU64 DecimalPlaces, typename T>
+					inline void PrintNumber(const T& value)
+					{
+						if (m_size + MaxNumberSize > Size)
+							this->Flush();
+
+						mfError err;
+						mfmU64 size = 0;
+						if constexpr (Type == SegmentType::U32)
+							err = mfsPrintToBufferU32(m_data + m_size, Size - m_size, static_cast<mfmU32>(value), Base, &size);
+						else if constexpr (Type == SegmentType::U64)
+							err = mfsPrintToBufferU64(m_data + m_size, Size - m_size, static_cast<mfmU64>(value), Base, &size);
+						else if constexpr (Type == SegmentType::I32)
+							err = mfsPrintToBufferI32(m_data + m_size, Size - m_size, static_cast<mfmI32>(value), Base, &size);
+						else if constexpr (Type == SegmentType::I64)
+							err = mfsPrintToBufferI64(m_data + m_size, Size - m_size, static_cast<mfmI64>(value), Base, &size);
+						else
+							err = mfsPrintToBufferF64(m_data + m_size, Size - m_size, static_cast<mfmF64>(value), Base, DecimalPlaces, &size);
+						if (err != MF_ERROR_OKAY)
+							throw StreamError(ErrorToString(err));
+						m_size += size;
+					}
+
+					/// <summary>
+					///		Writes the buffered data to the stream.
+					/// </summary>
+					void Flush();
+
+				private:
+					void Write(const mfsUTF8CodeUnit* data, mfmU64 size);
+
+					static constexpr mfmU64 Size = 512;
+					static constexpr mfmU64 MaxNumberSize = 128;
+
+					mfsStream* m_stream;
+					mfmU64 m_size;
+					mfsUTF8CodeUnit m_data[Size];
+				};
+
+				template <typename S, mfmU64 Index, typename Tuple>
+				inline void PrintSegment(Buffer& buffer, const Tuple& args)
+				{
+					constexpr Segment segment = Segments<S>[Index];
+					if constexpr (segment.type == SegmentType::Literal)
+					{
+						if constexpr (segment.size == 1)
+							buffer.PutCharacter(S::Get()[segment.begin]);
+						else
+							buffer.Put(S::Get() + segment.begin, segment.size);
+					}
+					else
+					{
+						const auto& arg = std::get<segment.argument>(args);
+						static_assert(Accepts<segment.type, decltype(arg)>(), "Format argument type doesn't match its specifier");
+						if constexpr (segment.type == SegmentType::Character)
+							buffer.PutCharacter(static_cast<mfsUTF8CodeUnit>(arg));
+						else if constexpr (segment.type == SegmentType::String)
+						{
+							const mfsUTF8CodeUnit* str = arg;
+							buffer.Put(str, strlen(str));
+						}
+						else if constexpr (segment.type == SegmentType::Pointer)
+						{
+							constexpr SegmentType type = sizeof(void*) == sizeof(mfmU64) ? SegmentType::U64 : SegmentType::U32;
+							buffer.PrintNumber<type, segment.base, segment.decimalPlaces>(reinterpret_cast<std::uintptr_t>(static_cast<const void*>(arg)));
+						}
+						else
+							buffer.PrintNumber<segment.type, segment.base, segment.decimalPlaces>(arg);
+					}
+				}
+
+				template <typename S, typename Tuple, mfmU64... Indices>
+				inline void PrintSegments(Buffer& buffer, const Tuple& args, std::integer_sequence<mfmU64, Indices...>)
+				{
+					(PrintSegment<S, Indices>(buffer, args), ...);
+				}
+			}
+
+			/// <summary>
+			///		Prints a formatted UTF-8 string to a stream.
+			///		Throws a StreamError on failure (whatever was printed before the error is still written).
+			/// </summary>
+			/// <param name="stream">Stream</param>
+			/// <param name="format">Format string created with MFS_FORMAT</param>
+			/// <param name="args">Arguments</param>
+			template <typename S, typename... Args>
+			inline void PrintFormat(mfsStream* stream, S, const Args&... args)
+			{
+				static_assert(std::is_base_of<Format::FormatStringBase, S>::value, "Format strings must be created with MFS_FORMAT");
+				static_assert(Format::IsValid<S>(), "Invalid format string");
+				if constexpr (Format::IsValid<S>())
+				{
+					static_assert(Format::CountArguments<S>() == sizeof...(Args), "Wrong number of format arguments");
+					if constexpr (Format::CountArguments<S>() == sizeof...(Args))
+					{
+						if (stream == nullptr)
+							throw StreamError(ErrorToString(MFS_ERROR_INVALID_ARGUMENTS));
+
+						Format::Buffer buffer(stream);
+						try
+						{
+							Format::PrintSegments<S>(buffer, std::forward_as_tuple(args...),
+													 std::make_integer_sequence<mfmU64, Format::Segments<S>.size()>());
+						}
+						catch (...)
+						{
+							try { buffer.Flush(); } catch (...) {}
+							throw;
+						}
+						buffer.Flush();
+					}
+				}
+			}
+		}
+	}
+}
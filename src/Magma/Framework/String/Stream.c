@@ -1,12 +1,54 @@
 #include "Stream.h"
+#include "Config.h"
 #include "../Memory/Allocator.h"
 #include "../String/Conversion.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 #include <errno.h>
 
+#if defined(MAGMA_FRAMEWORK_USE_AVX2)
+#include <immintrin.h>
+#elif defined(MAGMA_FRAMEWORK_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(MAGMA_FRAMEWORK_USE_AVX2) || defined(MAGMA_FRAMEWORK_USE_SSE2)
+#ifdef _MSC_VER
+#include <intrin.h>
+static mfmU32 mfsFirstSetBit(mfmU32 mask)
+{
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (mfmU32)index;
+}
+#else
+#define mfsFirstSetBit(mask) ((mfmU32)__builtin_ctz(mask))
+#endif
+#endif
+
+/*
+	The print and parse functions move data in spans instead of calling the stream's read or write function once per byte.
+	Printed output is gathered in a print buffer on the stack and written with a single call when the buffer is full or the print ends.
+	mfsReadUntil reads streams which support seeking in chunks, and seeks back over the bytes read past the end.
+	The chunks are scanned for the terminator (or whitespace) with SSE2 or AVX2 when enabled in the configuration.
+*/
+
+// Size of the buffer where printed output is gathered before being written to the stream
+#define MFS_PRINT_BUFFER_SIZE 256
+
+// Size of the chunks read by mfsReadUntil from streams which support seeking
+#define MFS_READ_CHUNK_SIZE 512
+
+typedef struct
+{
+	mfsStream* stream;
+	mfmU64 size;
+	mfsUTF8CodeUnit data[MFS_PRINT_BUFFER_SIZE];
+} mfsPrintBuffer;
+
 mfsStream* mfsInStream = NULL;
 mfsStream* mfsOutStream = NULL;
 mfsStream* mfsErrStream = NULL;
@@ -106,6 +148,7 @@ static mfsStream* mfsCreateFileStream(FILE* file, mfmU8* buffer, mfmU64 bufferSi
 	stream->base.seekHead = NULL;
 	stream->base.tell = NULL;
 	stream->base.eof = NULL;
+	stream->base.getSpan = NULL;
 
 	return (mfsStream*)stream;
 }
@@ -163,6 +206,126 @@ mfError mfsTerminateStream()
 	return err;
 }
 
+static mfError mfsWriteAll(mfsStream* stream, const void* data, mfmU64 dataSize)
+{
+	if (dataSize == 0)
+		return MF_ERROR_OKAY;
+
+	mfmU64 writeSize = 0;
+	mfError err = mfsWrite(stream, data, dataSize, &writeSize);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (writeSize != dataSize)
+		return MFS_ERROR_FAILED_TO_WRITE_ALL;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsFlushPrintBuffer(mfsPrintBuffer* buffer)
+{
+	mfError err = mfsWriteAll(buffer->stream, buffer->data, buffer->size);
+	buffer->size = 0;
+	return err;
+}
+
+static inline mfError mfsPrintBufferPut(mfsPrintBuffer* buffer, const mfsUTF8CodeUnit* data, mfmU64 dataSize)
+{
+	// Fast path, the data fits in the buffer
+	if (buffer->size + dataSize <= MFS_PRINT_BUFFER_SIZE)
+	{
+		memcpy(buffer->data + buffer->size, data, dataSize);
+		buffer->size += dataSize;
+		return MF_ERROR_OKAY;
+	}
+
+	mfError err = mfsFlushPrintBuffer(buffer);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	// Data which doesn't fit in the buffer is written directly
+	if (dataSize > MFS_PRINT_BUFFER_SIZE)
+		return mfsWriteAll(buffer->stream, data, dataSize);
+	memcpy(buffer->data, data, dataSize);
+	buffer->size = dataSize;
+	return MF_ERROR_OKAY;
+}
+
+static inline mfError mfsPrintBufferPutByte(mfsPrintBuffer* buffer, mfsUTF8CodeUnit byte)
+{
+	if (buffer->size == MFS_PRINT_BUFFER_SIZE)
+	{
+		mfError err = mfsFlushPrintBuffer(buffer);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+
+	buffer->data[buffer->size++] = byte;
+	return MF_ERROR_OKAY;
+}
+
+// Returns the index of the first occurrence of byte in data, or size if there is none
+static mfmU64 mfsFindByte(const mfmU8* data, mfmU64 size, mfmU8 byte)
+{
+	mfmU64 i = 0;
+#if defined(MAGMA_FRAMEWORK_USE_AVX2)
+	__m256i pattern = _mm256_set1_epi8((char)byte);
+	for (; i + 32 <= size; i += 32)
+	{
+		__m256i chunk = _mm256_loadu_si256((const __m256i*)(data + i));
+		mfmU32 mask = (mfmU32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, pattern));
+		if (mask != 0)
+			return i + mfsFirstSetBit(mask);
+	}
+#elif defined(MAGMA_FRAMEWORK_USE_SSE2)
+	__m128i pattern = _mm_set1_epi8((char)byte);
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+		mfmU32 mask = (mfmU32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern));
+		if (mask != 0)
+			return i + mfsFirstSetBit(mask);
+	}
+#endif
+	for (; i < size; ++i)
+		if (data[i] == byte)
+			return i;
+	return size;
+}
+
+// Returns the index of the first space, tab or new line in data, or size if there is none
+static mfmU64 mfsFindWhitespace(const mfmU8* data, mfmU64 size)
+{
+	mfmU64 i = 0;
+#if defined(MAGMA_FRAMEWORK_USE_AVX2)
+	__m256i space = _mm256_set1_epi8(' ');
+	__m256i tab = _mm256_set1_epi8('\t');
+	__m256i newLine = _mm256_set1_epi8('\n');
+	for (; i + 32 <= size; i += 32)
+	{
+		__m256i chunk = _mm256_loadu_si256((const __m256i*)(data + i));
+		__m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)), _mm256_cmpeq_epi8(chunk, newLine));
+		mfmU32 mask = (mfmU32)_mm256_movemask_epi8(matches);
+		if (mask != 0)
+			return i + mfsFirstSetBit(mask);
+	}
+#elif defined(MAGMA_FRAMEWORK_USE_SSE2)
+	__m128i space = _mm_set1_epi8(' ');
+	__m128i tab = _mm_set1_epi8('\t');
+	__m128i newLine = _mm_set1_epi8('\n');
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)), _mm_cmpeq_epi8(chunk, newLine));
+		mfmU32 mask = (mfmU32)_mm_movemask_epi8(matches);
+		if (mask != 0)
+			return i + mfsFirstSetBit(mask);
+	}
+#endif
+	for (; i < size; ++i)
+		if (data[i] == ' ' || data[i] == '\t' || data[i] == '\n')
+			return i;
+	return size;
+}
+
 mfError mfsWrite(mfsStream * stream, const void * data, mfmU64 dataSize, mfmU64 * outSize)
 {
 	if (stream == NULL || data == NULL)
@@ -201,31 +364,92 @@ mfError mfsReadUntil(mfsStream * stream, mfmU8 * data, mfmU64 dataSize, mfmU64 *
 		}
 	}
 
-	mfError err = MF_ERROR_OKAY;
+	if (stream->read == NULL)
+		return MFS_ERROR_UNSUPPORTED_FUNCTION;
+
+	mfmU8 localChunk[MFS_READ_CHUNK_SIZE];
 
 	mfmU64 size = 0;
 	mfmU64 terminatorIndex = 0;
-	while (size < dataSize - 1)
+	mfmBool finished = MFM_FALSE;
+	while (finished == MFM_FALSE)
 	{
-		if (terminator != NULL && terminator[terminatorIndex] == '\0')
+		if (size >= dataSize - 1 || (terminator != NULL && terminator[terminatorIndex] == '\0'))
 			break;
 
-		mfsUTF8CodeUnit chr;
-		err = mfsGetByte(stream, (mfmU8*)&chr);
+		// Streams which don't support seeking are read byte by byte, so that nothing past the terminator is consumed.
+		// When no terminator characters are pending, the chunk is read straight into the output, so the bytes before the terminator are never copied.
+		mfmU8* chunk = localChunk;
+		mfmU64 chunkCapacity = 1;
+		if (stream->seekHead != NULL)
+		{
+			chunkCapacity = MFS_READ_CHUNK_SIZE;
+			if (data != NULL && terminatorIndex == 0)
+			{
+				chunk = data + size;
+				if (chunkCapacity > dataSize - 1 - size)
+					chunkCapacity = dataSize - 1 - size;
+			}
+		}
 
-		if (terminator == NULL && (chr == ' ' || chr == '\t' || chr == '\n'))
-			break;
+		mfmU64 chunkSize = 0;
+		mfError err = stream->read(stream, chunk, chunkCapacity, &chunkSize);
+		if (err == MFS_ERROR_EOF)
+			finished = MFM_TRUE;
+		else if (err != MF_ERROR_OKAY)
+			return err;
+		else if (chunkSize == 0)
+			return MFS_ERROR_FAILED_TO_READ_ALL;
 
-		if (err == MF_ERROR_OKAY)
+		mfmU64 i = 0;
+		while (i < chunkSize)
 		{
+			if (size >= dataSize - 1 || (terminator != NULL && terminator[terminatorIndex] == '\0'))
+			{
+				finished = MFM_TRUE;
+				break;
+			}
+
+			// Fast path: every byte before the next one which may start the terminator is part of the output
+			if (terminatorIndex == 0)
+			{
+				mfmU64 next = i + (terminator == NULL ? mfsFindWhitespace(chunk + i, chunkSize - i) : mfsFindByte(chunk + i, chunkSize - i, terminator[0]));
+				mfmU64 count = next - i;
+				if (data != NULL)
+				{
+					if (count > dataSize - 1 - size)
+						count = dataSize - 1 - size;
+					if (data + size != chunk + i)
+						memmove(data + size, chunk + i, count);
+					size += count;
+				}
+				i += count;
+
+				if (i == chunkSize)
+					break;
+				if (size >= dataSize - 1)
+				{
+					finished = MFM_TRUE;
+					break;
+				}
+			}
+
+			mfsUTF8CodeUnit chr = chunk[i++];
+
+			if (terminator == NULL && (chr == ' ' || chr == '\t' || chr == '\n'))
+			{
+				finished = MFM_TRUE;
+				break;
+			}
+
 			if (terminator != NULL && chr == terminator[terminatorIndex])
 				++terminatorIndex;
 			else
 			{
-				for (mfmU64 i = 0; i < terminatorIndex; ++i)
+				for (mfmU64 j = 0; j < terminatorIndex; ++j)
 					if (data != NULL)
 					{
-						data[size++] = terminator[i];
+						data[size++] = terminator[j];
 						if (size >= dataSize - 1)
 							break;
 					}
@@ -237,16 +461,23 @@ mfError mfsReadUntil(mfsStream * stream, mfmU8 * data, mfmU64 dataSize, mfmU64 *
 				else if (data != NULL)
 				{
 					if (size >= dataSize - 1)
+					{
+						finished = MFM_TRUE;
 						break;
+					}
 					else
 						data[size++] = chr;
 				}
 			}
 		}
-		else if (err == MFS_ERROR_EOF)
-			break;
-		else
-			return err;
+
+		// Give back the bytes which were read past the end
+		if (i < chunkSize)
+		{
+			err = stream->seekHead(stream, -(mfmI64)(chunkSize - i));
+			if (err != MF_ERROR_OKAY)
+				return err;
+		}
 	}
 
 	if (data != NULL)
@@ -322,26 +553,19 @@ mfError mfsPutByte(mfsStream * stream, mfmU8 byte)
 
 mfError mfsPutString(mfsStream * stream, const mfsUTF8CodeUnit * str)
 {
-	while (*str != '\0')
-	{
-		mfError err = mfsPutByte(stream, *str);
-		if (err != MF_ERROR_OKAY)
-			return err;
-		++str;
-	}
-
-	return MF_ERROR_OKAY;
+	return mfsWriteAll(stream, str, strlen(str));
 }
 
 mfError mfsPrintU8(mfsStream * stream, mfmU8 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferU8(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferU8(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -350,13 +574,14 @@ mfError mfsPrintU8(mfsStream * stream, mfmU8 value, mfmU64 base)
 
 mfError mfsPrintU16(mfsStream * stream, mfmU16 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferU16(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferU16(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -365,13 +590,14 @@ mfError mfsPrintU16(mfsStream * stream, mfmU16 value, mfmU64 base)
 
 mfError mfsPrintU32(mfsStream * stream, mfmU32 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferU32(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferU32(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -380,13 +606,14 @@ mfError mfsPrintU32(mfsStream * stream, mfmU32 value, mfmU64 base)
 
 mfError mfsPrintU64(mfsStream * stream, mfmU64 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferU64(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferU64(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -395,13 +622,14 @@ mfError mfsPrintU64(mfsStream * stream, mfmU64 value, mfmU64 base)
 
 mfError mfsPrintI8(mfsStream * stream, mfmI8 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferI8(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferI8(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -410,13 +638,14 @@ mfError mfsPrintI8(mfsStream * stream, mfmI8 value, mfmU64 base)
 
 mfError mfsPrintI16(mfsStream * stream, mfmI16 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferI16(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferI16(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -425,13 +654,14 @@ mfError mfsPrintI16(mfsStream * stream, mfmI16 value, mfmU64 base)
 
 mfError mfsPrintI32(mfsStream * stream, mfmI32 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferI32(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferI32(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -440,13 +670,14 @@ mfError mfsPrintI32(mfsStream * stream, mfmI32 value, mfmU64 base)
 
 mfError mfsPrintI64(mfsStream * stream, mfmI64 value, mfmU64 base)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferI64(buf, sizeof(buf), value, base, NULL);
+	mfError err = mfsPrintToBufferI64(buf, sizeof(buf), value, base, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -455,13 +686,14 @@ mfError mfsPrintI64(mfsStream * stream, mfmI64 value, mfmU64 base)
 
 mfError mfsPrintF32(mfsStream * stream, mfmF32 value, mfmU64 base, mfmU64 decimalPlaces)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferF32(buf, sizeof(buf), value, base, decimalPlaces, NULL);
+	mfError err = mfsPrintToBufferF32(buf, sizeof(buf), value, base, decimalPlaces, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -470,13 +702,14 @@ mfError mfsPrintF32(mfsStream * stream, mfmF32 value, mfmU64 base, mfmU64 decima
 
 mfError mfsPrintF64(mfsStream * stream, mfmF64 value, mfmU64 base, mfmU64 decimalPlaces)
 {
-	mfsUTF8CodeUnit buf[256] = { '\0' };
+	mfsUTF8CodeUnit buf[256];
+	mfmU64 size = 0;
 
-	mfError err = mfsPrintToBufferF64(buf, sizeof(buf), value, base, decimalPlaces, NULL);
+	mfError err = mfsPrintToBufferF64(buf, sizeof(buf), value, base, decimalPlaces, &size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
-	err = mfsPutString(stream, buf);
+	err = mfsWriteAll(stream, buf, size);
 	if (err != MF_ERROR_OKAY)
 		return err;
 
@@ -492,14 +725,17 @@ mfError mfsPrintFormat(mfsStream * stream, const mfsUTF8CodeUnit * format, ...)
 	return err;
 }
 
-mfError mfsPrintFormatList(mfsStream * stream, const mfsUTF8CodeUnit * format, va_list args)
+static mfError mfsPrintFormatToBuffer(mfsPrintBuffer* buffer, const mfsUTF8CodeUnit * format, va_list args)
 {
+	mfsUTF8CodeUnit number[256];
+	mfmU64 numberSize = 0;
+
 	mfmBool escape = MFM_FALSE;
 	while (*format != '\0')
 	{
 		if (escape == MFM_TRUE)
 		{
-			mfError err = mfsPutByte(stream, *format);
+			mfError err = mfsPrintBufferPutByte(buffer, *format);
 			escape = MFM_FALSE;
 			if (err != MF_ERROR_OKAY)
 				return err;
@@ -565,109 +801,104 @@ mfError mfsPrintFormatList(mfsStream * stream, const mfsUTF8CodeUnit * format, v
 					case 'u':
 						if (*(format + 1) == 'l')
 						{
-							err = mfsPrintU64(stream, va_arg(args, mfmU64), base, decimalPlaces);
-							if (err != MF_ERROR_OKAY)
-								return err;
+							err = mfsPrintToBufferU64(number, sizeof(number), va_arg(args, mfmU64), base, &numberSize);
 							++format;
 						}
 						else
-						{
-							err = mfsPrintU32(stream, va_arg(args, mfmU32), base, decimalPlaces);
-							if (err != MF_ERROR_OKAY)
-								return err;
-						}
+							err = mfsPrintToBufferU32(number, sizeof(number), va_arg(args, mfmU32), base, &numberSize);
+						if (err != MF_ERROR_OKAY)
+							return err;
+						err = mfsPrintBufferPut(buffer, number, numberSize);
+						if (err != MF_ERROR_OKAY)
+							return err;
 						break;
 
 					case 'i':
 						if (*(format + 1) == 'l')
 						{
-							err = mfsPrintI64(stream, va_arg(args, mfmI64), base, decimalPlaces);
-							if (err != MF_ERROR_OKAY)
-								return err;
+							err = mfsPrintToBufferI64(number, sizeof(number), va_arg(args, mfmI64), base, &numberSize);
 							++format;
 						}
 						else
-						{
-							err = mfsPrintI32(stream, va_arg(args, mfmI32), base, decimalPlaces);
-							if (err != MF_ERROR_OKAY)
-								return err;
-						}
+							err = mfsPrintToBufferI32(number, sizeof(number), va_arg(args, mfmI32), base, &numberSize);
+						if (err != MF_ERROR_OKAY)
+							return err;
+						err = mfsPrintBufferPut(buffer, number, numberSize);
+						if (err != MF_ERROR_OKAY)
+							return err;
 						break;
 
 					case 'f':
-						err = mfsPrintF64(stream, va_arg(args, mfmF64), base, decimalPlaces);
+						err = mfsPrintToBufferF64(number, sizeof(number), va_arg(args, mfmF64), base, decimalPlaces, &numberSize);
+						if (err != MF_ERROR_OKAY)
+							return err;
+						err = mfsPrintBufferPut(buffer, number, numberSize);
 						if (err != MF_ERROR_OKAY)
 							return err;
 						break;
 
 					case 'c':
-						err = mfsPutByte(stream, va_arg(args, mfsUnicodePoint));
+						err = mfsPrintBufferPutByte(buffer, va_arg(args, mfsUnicodePoint));
 						if (err != MF_ERROR_OKAY)
 							return err;
 						break;
 
 					case 's':
-						err = mfsPutString(stream, va_arg(args, const mfsUTF8CodeUnit*));
+					{
+						const mfsUTF8CodeUnit* str = va_arg(args, const mfsUTF8CodeUnit*);
+						err = mfsPrintBufferPut(buffer, str, strlen(str));
 						if (err != MF_ERROR_OKAY)
 							return err;
 						break;
+					}
 
 					case 'p':
 						if (sizeof(void*) == sizeof(mfmU32))
-						{
-							err = mfsPrintU32(stream, va_arg(args, mfmU32), base, decimalPlaces);
-							if (err != MF_ERROR_OKAY)
-								return err;
-						}
+							err = mfsPrintToBufferU32(number, sizeof(number), va_arg(args, mfmU32), base, &numberSize);
 						else if (sizeof(void*) == sizeof(mfmU64))
-						{
-							err = mfsPrintU32(stream, va_arg(args, mfmU64), base, decimalPlaces);
-							if (err != MF_ERROR_OKAY)
-								return err;
-						}
+							err = mfsPrintToBufferU64(number, sizeof(number), va_arg(args, mfmU64), base, &numberSize);
 						else abort();
+						if (err != MF_ERROR_OKAY)
+							return err;
+						err = mfsPrintBufferPut(buffer, number, numberSize);
+						if (err != MF_ERROR_OKAY)
+							return err;
+						break;
 				}
 			}
 			// Old formatting
 			else if (*format == '%')
 			{
 				++format;
+				mfError err;
 				if (*format == 'd')
-				{
-					mfError err = mfsPrintI32(stream, va_arg(args, mfmI32), 10);
-					if (err != MF_ERROR_OKAY)
-						return err;
-				}
+					err = mfsPrintToBufferI32(number, sizeof(number), va_arg(args, mfmI32), 10, &numberSize);
 				else if (*format == 'x')
-				{
-					mfError err = mfsPrintI32(stream, va_arg(args, mfmI32), 16);
-					if (err != MF_ERROR_OKAY)
-						return err;
-				}
+					err = mfsPrintToBufferI32(number, sizeof(number), va_arg(args, mfmI32), 16, &numberSize);
 				else if (*format == 'f')
-				{
-					mfError err = mfsPrintF64(stream, va_arg(args, mfmF64), 10, 4);
-					if (err != MF_ERROR_OKAY)
-						return err;
-				}
+					err = mfsPrintToBufferF64(number, sizeof(number), va_arg(args, mfmF64), 10, 4, &numberSize);
 				else if (*format == 'c')
 				{
-					mfError err = mfsPutByte(stream, va_arg(args, mfsUnicodePoint));
-					if (err != MF_ERROR_OKAY)
-						return err;
+					err = mfsPrintBufferPutByte(buffer, va_arg(args, mfsUnicodePoint));
+					numberSize = 0;
 				}
 				else if (*format == 's')
 				{
-					mfError err = mfsPutString(stream, va_arg(args, const mfsUTF8CodeUnit*));
-					if (err != MF_ERROR_OKAY)
-						return err;
+					const mfsUTF8CodeUnit* str = va_arg(args, const mfsUTF8CodeUnit*);
+					err = mfsPrintBufferPut(buffer, str, strlen(str));
+					numberSize = 0;
 				}
 				else
 					return MFS_ERROR_INVALID_ARGUMENTS;
+				if (err != MF_ERROR_OKAY)
+					return err;
+				err = mfsPrintBufferPut(buffer, number, numberSize);
+				if (err != MF_ERROR_OKAY)
+					return err;
 			}
 			else
 			{
-				mfError err = mfsPutByte(stream, *format);
+				mfError err = mfsPrintBufferPutByte(buffer, *format);
 				escape = MFM_FALSE;
 				if (err != MF_ERROR_OKAY)
 					return err;
@@ -680,6 +911,23 @@ mfError mfsPrintFormatList(mfsStream * stream, const mfsUTF8CodeUnit * format, v
 	return MF_ERROR_OKAY;
 }
 
+mfError mfsPrintFormatList(mfsStream * stream, const mfsUTF8CodeUnit * format, va_list args)
+{
+	if (stream == NULL || format == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+
+	mfsPrintBuffer buffer;
+	buffer.stream = stream;
+	buffer.size = 0;
+
+	// Whatever was printed before an error is still written to the stream
+	mfError err = mfsPrintFormatToBuffer(&buffer, format, args);
+	mfError flushErr = mfsFlushPrintBuffer(&buffer);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return flushErr;
+}
+
 mfError mfsSeekBegin(mfsStream * stream, mfmU64 offset)
 {
 	if (stream == NULL)
@@ -740,6 +988,15 @@ mfError mfsEOF(mfsStream * stream, mfmBool * eof)
 	return MF_ERROR_OKAY;
 }
 
+mfError mfsGetSpan(mfsStream * stream, mfmU64 size, const mfmU8 ** data, mfmU64 * outSize)
+{
+	if (stream == NULL || data == NULL || outSize == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	if (stream->getSpan == NULL)
+		return MFS_ERROR_UNSUPPORTED_FUNCTION;
+	return stream->getSpan(stream, size, data, outSize);
+}
+
 mfError mfsParseU8(mfsStream * stream, mfmU8 * value, mfmU64 base, const mfsUTF8CodeUnit * sep)
 {
 	mfsUTF8CodeUnit str[256] = { '\0' };
@@ -25,6 +25,7 @@ extern "C"
 	typedef mfError(*mfsStreamSeekHeadFunction)(void*, mfmI64 offset);
 	typedef mfError(*mfsStreamTellFunction)(void*, mfmU64* position);
 	typedef mfError(*mfsStreamEOFFunction)(void*, mfmBool* eof);
+	typedef mfError(*mfsStreamGetSpanFunction)(void*, mfmU64 size, const mfmU8** data, mfmU64* outSize);
 	
 	typedef struct
 	{
@@ -38,6 +39,7 @@ extern "C"
 		mfsStreamSeekHeadFunction seekHead;
 		mfsStreamTellFunction tell;
 		mfsStreamEOFFunction eof;
+		mfsStreamGetSpanFunction getSpan;
 
 		mfmU8* buffer;
 		mfmU64 bufferSize;
@@ -405,6 +407,23 @@ extern "C"
 	/// </returns>
 	mfError mfsEOF(mfsStream* stream, mfmBool* eof);
 
+	/// <summary>
+	///		Gets a pointer to the data at the current position of a stream without copying it, and moves the position past it.
+	///		Only streams which hold all of their data in memory (string streams, memory mapped files) support this function.
+	///		The pointer stays valid until the stream is written to or destroyed.
+	/// </summary>
+	/// <param name="stream">Stream handle</param>
+	/// <param name="size">Maximum span size in bytes (set to MFM_U64_MAX to get the rest of the stream)</param>
+	/// <param name="data">Out data pointer</param>
+	/// <param name="outSize">Out span size in bytes, smaller than size if the stream ends first</param>
+	/// <returns>
+	///		MF_ERROR_OKAY if there were no errors.
+	///		MFS_ERROR_INVALID_ARGUMENTS if stream, data or outSize are NULL.
+	///		MFS_ERROR_EOF if the stream has already reached its end.
+	///		MFS_ERROR_UNSUPPORTED_FUNCTION if the stream doesn't support this function.
+	/// </returns>
+	mfError mfsGetSpan(mfsStream* stream, mfmU64 size, const mfmU8** data, mfmU64* outSize);
+
 	/// <summary>
 	///		Parses an unsigned 8 bit integer from a stream.
 	/// </summary>
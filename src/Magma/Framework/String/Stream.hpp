@@ -2,6 +2,7 @@
 
 #include "../Memory/Handle.hpp"
 #include "Stream.h"
+#include "Format.hpp"
 
 namespace Magma
 {
@@ -119,6 +120,18 @@ namespace Magma
 					return *this;
 				}
 
+				/// <summary>
+				///		Prints a formatted UTF-8 string, with a format string created with MFS_FORMAT.
+				///		The format is parsed and checked against the argument types at compile time.
+				/// </summary>
+				/// <param name="format">Format string</param>
+				/// <param name="args">Arguments</param>
+				template <typename S, typename... Args>
+				inline void PrintFormat(S format, const Args&... args)
+				{
+					String::PrintFormat(reinterpret_cast<mfsStream*>(&this->Get()), format, args...);
+				}
+
 				/// <summary>
 				///		Parses a value from the stream.
 				/// </summary>
@@ -0,0 +1,334 @@
+#include "StringBuilder.h"
+#include "../Memory/Allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+	The data lives in the inline buffer until it doesn't fit, and is then moved to the allocator, doubling its capacity each time it grows.
+	base.buffer always points to the data and base.bufferSize holds its capacity, not counting the null terminator.
+*/
+
+static mfError mfsFreeStringBuilderData(mfsStringBuilder* builder)
+{
+	if (builder->base.buffer == builder->inlineBuffer)
+		return MF_ERROR_OKAY;
+
+	// Linear allocators can't deallocate, their memory is only reclaimed when they are reset
+	mfError err = mfmDeallocate(builder->allocator, builder->base.buffer);
+	if (err == MFM_ERROR_UNSUPPORTED_FUNCTION)
+		return MF_ERROR_OKAY;
+	return err;
+}
+
+static mfError mfsGrowStringBuilder(mfsStringBuilder* builder, mfmU64 capacity)
+{
+	if (capacity <= builder->base.bufferSize)
+		return MF_ERROR_OKAY;
+
+	mfmU64 newCapacity = (builder->base.bufferSize + 1) * 2 - 1;
+	if (newCapacity < capacity)
+		newCapacity = capacity;
+
+	mfError err;
+	void* data;
+
+	if (builder->base.buffer != builder->inlineBuffer)
+	{
+		// Try to grow in place first, linear and stack allocators can do it if this is their last allocation
+		err = mfmReallocate(builder->allocator, builder->base.buffer, builder->base.bufferSize + 1, newCapacity + 1, &data);
+		if (err == MF_ERROR_OKAY)
+		{
+			builder->base.buffer = data;
+			builder->base.bufferSize = newCapacity;
+			return MF_ERROR_OKAY;
+		}
+		else if (err != MFM_ERROR_UNSUPPORTED_FUNCTION)
+			return err;
+	}
+
+	err = mfmAllocate(builder->allocator, &data, newCapacity + 1);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	memcpy(data, builder->base.buffer, builder->size + 1);
+
+	err = mfsFreeStringBuilderData(builder);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	builder->base.buffer = data;
+	builder->base.bufferSize = newCapacity;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderEOF(void* stream, mfmBool* eof)
+{
+	if (stream == NULL || eof == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	mfsStringBuilder* builder = stream;
+	*eof = builder->head >= builder->size ? MFM_TRUE : MFM_FALSE;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderRead(void* stream, mfmU8* data, mfmU64 size, mfmU64* readSize)
+{
+	if (stream == NULL || data == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	mfsStringBuilder* builder = stream;
+
+	mfmU64 available = builder->size - builder->head;
+	if (size > available)
+	{
+		memcpy(data, builder->base.buffer + builder->head, available);
+		if (readSize != NULL)
+			*readSize = available;
+		builder->head = builder->size;
+		return MFS_ERROR_EOF;
+	}
+
+	memcpy(data, builder->base.buffer + builder->head, size);
+	if (readSize != NULL)
+		*readSize = size;
+	builder->head += size;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderWrite(void* stream, const mfmU8* data, mfmU64 size, mfmU64* writeSize)
+{
+	if (stream == NULL || data == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	mfsStringBuilder* builder = stream;
+
+	if (builder->head + size > builder->base.bufferSize)
+	{
+		mfError err = mfsGrowStringBuilder(builder, builder->head + size);
+		if (err != MF_ERROR_OKAY)
+		{
+			if (writeSize != NULL)
+				*writeSize = 0;
+			return err;
+		}
+	}
+
+	memcpy(builder->base.buffer + builder->head, data, size);
+	builder->head += size;
+	if (builder->head > builder->size)
+	{
+		builder->size = builder->head;
+		builder->base.buffer[builder->size] = '\0';
+	}
+
+	if (writeSize != NULL)
+		*writeSize = size;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderFlush(void* stream)
+{
+	// Do nothing
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderSeekBegin(void* stream, mfmU64 position)
+{
+	mfsStringBuilder* builder = stream;
+	if (position > builder->size)
+	{
+		builder->head = builder->size;
+		return MFS_ERROR_EOF;
+	}
+
+	builder->head = position;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderSeekEnd(void* stream, mfmU64 position)
+{
+	mfsStringBuilder* builder = stream;
+	if (position + 1 > builder->size)
+	{
+		builder->head = 0;
+		return MFS_ERROR_EOF;
+	}
+
+	builder->head = builder->size - position - 1;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderSeekHead(void* stream, mfmI64 offset)
+{
+	mfsStringBuilder* builder = stream;
+	if (offset >= 0 && builder->head + offset > builder->size)
+	{
+		builder->head = builder->size;
+		return MFS_ERROR_EOF;
+	}
+	else if (offset < 0 && (mfmU64)-offset > builder->head)
+	{
+		builder->head = 0;
+		return MFS_ERROR_EOF;
+	}
+
+	builder->head += offset;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderTell(void* stream, mfmU64* out)
+{
+	mfsStringBuilder* builder = stream;
+	*out = builder->head;
+	return MF_ERROR_OKAY;
+}
+
+static mfError mfsStringBuilderGetSpan(void* stream, mfmU64 size, const mfmU8** data, mfmU64* outSize)
+{
+	mfsStringBuilder* builder = stream;
+	if (builder->head >= builder->size)
+		return MFS_ERROR_EOF;
+
+	if (size > builder->size - builder->head)
+		size = builder->size - builder->head;
+	*data = builder->base.buffer + builder->head;
+	*outSize = size;
+	builder->head += size;
+	return MF_ERROR_OKAY;
+}
+
+static void mfsInitStringBuilder(mfsStringBuilder* builder, void* allocator)
+{
+	builder->base.read = &mfsStringBuilderRead;
+	builder->base.write = &mfsStringBuilderWrite;
+	builder->base.flush = &mfsStringBuilderFlush;
+	builder->base.setBuffer = NULL;
+	builder->base.seekBegin = &mfsStringBuilderSeekBegin;
+	builder->base.seekEnd = &mfsStringBuilderSeekEnd;
+	builder->base.seekHead = &mfsStringBuilderSeekHead;
+	builder->base.tell = &mfsStringBuilderTell;
+	builder->base.eof = &mfsStringBuilderEOF;
+	builder->base.getSpan = &mfsStringBuilderGetSpan;
+
+	builder->base.buffer = builder->inlineBuffer;
+	builder->base.bufferSize = MFS_STRING_BUILDER_INLINE_SIZE - 1;
+	builder->inlineBuffer[0] = '\0';
+
+	builder->allocator = allocator;
+	builder->head = 0;
+	builder->size = 0;
+}
+
+mfError mfsCreateStringBuilder(mfsStream** stream, void* allocator)
+{
+	if (stream == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+
+	mfsStringBuilder* builder = NULL;
+	if (mfmAllocate(allocator, &builder, sizeof(mfsStringBuilder)) != MF_ERROR_OKAY)
+		return MFM_ERROR_ALLOCATION_FAILED;
+
+	mfError err = mfmInitObject(&builder->base.object);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeallocate(allocator, builder);
+		return err;
+	}
+	builder->base.object.destructorFunc = &mfsDestroyStringBuilder;
+
+	mfsInitStringBuilder(builder, allocator);
+
+	*stream = builder;
+	return MF_ERROR_OKAY;
+}
+
+void mfsDestroyStringBuilder(void* stream)
+{
+	if (stream == NULL)
+		abort();
+	mfsStringBuilder* builder = stream;
+	if (mfsFreeStringBuilderData(builder) != MF_ERROR_OKAY)
+		abort();
+	if (mfmDeinitObject(&builder->base.object) != MF_ERROR_OKAY)
+		abort();
+	mfError err = mfmDeallocate(builder->allocator, builder);
+	if (err != MF_ERROR_OKAY && err != MFM_ERROR_UNSUPPORTED_FUNCTION)
+		abort();
+}
+
+mfError mfsCreateLocalStringBuilder(mfsStringBuilder* builder, void* allocator)
+{
+	if (builder == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+
+	mfError err = mfmInitObject(&builder->base.object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	builder->base.object.destructorFunc = &mfsDestroyLocalStringBuilder;
+
+	mfsInitStringBuilder(builder, allocator);
+	return MF_ERROR_OKAY;
+}
+
+void mfsDestroyLocalStringBuilder(mfsStringBuilder* builder)
+{
+	if (builder == NULL)
+		abort();
+	if (mfsFreeStringBuilderData(builder) != MF_ERROR_OKAY)
+		abort();
+	if (mfmDeinitObject(&builder->base.object) != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mfsReserveStringBuilder(mfsStream* stream, mfmU64 capacity)
+{
+	if (stream == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	return mfsGrowStringBuilder((mfsStringBuilder*)stream, capacity);
+}
+
+mfError mfsGetStringBuilderData(mfsStream* stream, const mfsUTF8CodeUnit** outData, mfmU64* outSize)
+{
+	if (stream == NULL || outData == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	mfsStringBuilder* builder = (mfsStringBuilder*)stream;
+	*outData = (const mfsUTF8CodeUnit*)builder->base.buffer;
+	if (outSize != NULL)
+		*outSize = builder->size;
+	return MF_ERROR_OKAY;
+}
+
+mfError mfsTakeStringBuilderData(mfsStream* stream, mfsUTF8CodeUnit** outData, mfmU64* outSize)
+{
+	if (stream == NULL || outData == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	mfsStringBuilder* builder = (mfsStringBuilder*)stream;
+
+	if (builder->base.buffer == builder->inlineBuffer)
+	{
+		mfError err = mfmAllocate(builder->allocator, outData, builder->size + 1);
+		if (err != MF_ERROR_OKAY)
+			return err;
+		memcpy(*outData, builder->inlineBuffer, builder->size + 1);
+	}
+	else
+		*outData = (mfsUTF8CodeUnit*)builder->base.buffer;
+
+	if (outSize != NULL)
+		*outSize = builder->size;
+
+	builder->base.buffer = builder->inlineBuffer;
+	builder->base.bufferSize = MFS_STRING_BUILDER_INLINE_SIZE - 1;
+	builder->inlineBuffer[0] = '\0';
+	builder->head = 0;
+	builder->size = 0;
+	return MF_ERROR_OKAY;
+}
+
+mfError mfsClearStringBuilder(mfsStream* stream)
+{
+	if (stream == NULL)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+	mfsStringBuilder* builder = (mfsStringBuilder*)stream;
+	builder->base.buffer[0] = '\0';
+	builder->head = 0;
+	builder->size = 0;
+	return MF_ERROR_OKAY;
+}
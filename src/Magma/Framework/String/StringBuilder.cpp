@@ -0,0 +1,67 @@
+#include "StringBuilder.hpp"
+#include "Exception.hpp"
+
+Magma::Framework::String::StringBuilder::StringBuilder(Memory::HAllocator allocator)
+{
+	mfError err = mfsCreateLocalStringBuilder(&m_sb, allocator.GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw StreamError(ErrorToString(err));
+	err = mfmAcquireObject(&m_sb.base.object);
+	if (err != MF_ERROR_OKAY)
+		throw StreamError(ErrorToString(err));
+}
+
+Magma::Framework::String::StringBuilder::~StringBuilder()
+{
+	mfmReleaseObject(&m_sb.base.object);
+	mfsDestroyLocalStringBuilder(&m_sb);
+}
+
+Magma::Framework::String::HStringBuilder Magma::Framework::String::StringBuilder::Get()
+{
+	return &m_sb;
+}
+
+void Magma::Framework::String::HStringBuilder::Clear()
+{
+	mfError err = mfsClearStringBuilder(reinterpret_cast<mfsStream*>(&this->Get()));
+	if (err == MF_ERROR_OKAY)
+		return;
+	throw StreamError(ErrorToString(err));
+}
+
+void Magma::Framework::String::HStringBuilder::Reserve(mfmU64 capacity)
+{
+	mfError err = mfsReserveStringBuilder(reinterpret_cast<mfsStream*>(&this->Get()), capacity);
+	if (err == MF_ERROR_OKAY)
+		return;
+	throw StreamError(ErrorToString(err));
+}
+
+const mfsUTF8CodeUnit* Magma::Framework::String::HStringBuilder::GetData()
+{
+	const mfsUTF8CodeUnit* data = NULL;
+	mfError err = mfsGetStringBuilderData(reinterpret_cast<mfsStream*>(&this->Get()), &data, NULL);
+	if (err != MF_ERROR_OKAY)
+		throw StreamError(ErrorToString(err));
+	return data;
+}
+
+mfmU64 Magma::Framework::String::HStringBuilder::GetSize()
+{
+	const mfsUTF8CodeUnit* data = NULL;
+	mfmU64 size = 0;
+	mfError err = mfsGetStringBuilderData(reinterpret_cast<mfsStream*>(&this->Get()), &data, &size);
+	if (err != MF_ERROR_OKAY)
+		throw StreamError(ErrorToString(err));
+	return size;
+}
+
+Magma::Framework::String::HStringBuilder Magma::Framework::String::CreateStringBuilder(Memory::HAllocator allocator)
+{
+	mfsStream* stream;
+	mfError err = mfsCreateStringBuilder(&stream, allocator.GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw StreamError(ErrorToString(err));
+	return stream;
+}
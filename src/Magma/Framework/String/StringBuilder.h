@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Stream.h"
+
+/*
+	String builder stream implementation.
+	Unlike the string stream, which writes to a fixed buffer, the string builder starts on an inline buffer and grows
+	geometrically on an allocator when more space is needed.
+	The data is always null terminated, so it can be used directly as a string.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MFS_STRING_BUILDER_INLINE_SIZE 256
+
+	typedef struct
+	{
+		mfsStream base;
+		void* allocator;
+		mfmU64 head;
+		mfmU64 size;
+		mfmU8 inlineBuffer[MFS_STRING_BUILDER_INLINE_SIZE];
+	} mfsStringBuilder;
+
+	/// <summary>
+	///		Creates a new string builder.
+	/// </summary>
+	/// <param name="stream">Pointer to stream handle</param>
+	/// <param name="allocator">The allocator where the string builder and its data are allocated (set to NULL to use the standard allocator)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="stream">stream</paramref> is NULL.
+	///		Returns MFM_ERROR_ALLOCATION_FAILED if the string builder couldn't be allocated.
+	/// </returns>
+	mfError mfsCreateStringBuilder(mfsStream** stream, void* allocator);
+
+	/// <summary>
+	///		Destroys a string builder created by mfsCreateStringBuilder.
+	/// </summary>
+	/// <param name="stream">Stream handle</param>
+	void mfsDestroyStringBuilder(void* stream);
+
+	/// <summary>
+	///		Creates a new string builder without allocating space for it.
+	/// </summary>
+	/// <param name="builder">Pointer to string builder</param>
+	/// <param name="allocator">The allocator where the data is allocated when it doesn't fit in the inline buffer (set to NULL to use the standard allocator)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="builder">builder</paramref> is NULL.
+	/// </returns>
+	mfError mfsCreateLocalStringBuilder(mfsStringBuilder* builder, void* allocator);
+
+	/// <summary>
+	///		Destroys a string builder created by mfsCreateLocalStringBuilder.
+	/// </summary>
+	/// <param name="builder">Pointer to string builder</param>
+	void mfsDestroyLocalStringBuilder(mfsStringBuilder* builder);
+
+	/// <summary>
+	///		Makes sure a string builder can hold at least a number of bytes without growing.
+	/// </summary>
+	/// <param name="stream">Stream handle</param>
+	/// <param name="capacity">Minimum capacity in bytes, not counting the null terminator</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="stream">stream</paramref> is NULL.
+	///		Returns an allocator error if the data couldn't be grown.
+	/// </returns>
+	mfError mfsReserveStringBuilder(mfsStream* stream, mfmU64 capacity);
+
+	/// <summary>
+	///		Gets the data written to a string builder.
+	///		The pointer is only valid until the next write, since the data may move when the string builder grows.
+	/// </summary>
+	/// <param name="stream">Stream handle</param>
+	/// <param name="outData">Pointer to the null terminated data pointer</param>
+	/// <param name="outSize">Pointer to the data size, not counting the null terminator (set to NULL to ignore)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="stream">stream</paramref> or <paramref name="outData">outData</paramref> are NULL.
+	/// </returns>
+	mfError mfsGetStringBuilderData(mfsStream* stream, const mfsUTF8CodeUnit** outData, mfmU64* outSize);
+
+	/// <summary>
+	///		Takes the data written to a string builder, which is left empty.
+	///		If the data is on the allocator it is handed off without a copy, otherwise it is copied from the inline buffer to a new allocation.
+	///		The data must be deallocated with mfmDeallocate on the string builder allocator.
+	/// </summary>
+	/// <param name="stream">Stream handle</param>
+	/// <param name="outData">Pointer to the null terminated data pointer</param>
+	/// <param name="outSize">Pointer to the data size, not counting the null terminator (set to NULL to ignore)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="stream">stream</paramref> or <paramref name="outData">outData</paramref> are NULL.
+	///		Returns an allocator error if the inline data couldn't be copied.
+	/// </returns>
+	mfError mfsTakeStringBuilderData(mfsStream* stream, mfsUTF8CodeUnit** outData, mfmU64* outSize);
+
+	/// <summary>
+	///		Clears all data in a string builder.
+	///		The allocated data is kept to be reused.
+	/// </summary>
+	/// <param name="stream">Stream handle</param>
+	/// <returns>The error code (MF_ERROR_OKAY if there no errors).</returns>
+	mfError mfsClearStringBuilder(mfsStream* stream);
+
+#ifdef __cplusplus
+}
+#endif
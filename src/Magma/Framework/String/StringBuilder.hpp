@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Stream.hpp"
+#include "StringBuilder.h"
+#include "../Memory/Allocator.hpp"
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace String
+		{
+			/// <summary>
+			///		Used as an object handle.
+			///		Destroys the object automatically when there are no more references to it.
+			/// </summary>
+			class HStringBuilder : public HStream
+			{
+			public:
+				using HStream::HStream;
+
+				/// <summary>
+				///		Clears the string builder, keeping its allocated data.
+				/// </summary>
+				void Clear();
+
+				/// <summary>
+				///		Makes sure the string builder can hold at least a number of bytes without growing.
+				/// </summary>
+				/// <param name="capacity">Minimum capacity in bytes</param>
+				void Reserve(mfmU64 capacity);
+
+				/// <summary>
+				///		Gets the null terminated data written to the string builder.
+				///		The pointer is only valid until the next write.
+				/// </summary>
+				/// <returns>Data pointer</returns>
+				const mfsUTF8CodeUnit* GetData();
+
+				/// <summary>
+				///		Gets the size of the data written to the string builder, not counting the null terminator.
+				/// </summary>
+				/// <returns>Data size in bytes</returns>
+				mfmU64 GetSize();
+			};
+
+			/// <summary>
+			///		String builder object.
+			/// </summary>
+			class StringBuilder final
+			{
+			public:
+				StringBuilder(Memory::HAllocator allocator = Memory::StandardAllocator);
+				~StringBuilder();
+
+				HStringBuilder Get();
+
+			private:
+				mfsStringBuilder m_sb;
+			};
+
+			/// <summary>
+			///		Creates a new string builder.
+			/// </summary>
+			/// <param name="allocator">AllocatorHandle where the string builder and its data will be created</param>
+			/// <returns>String builder handle</returns>
+			HStringBuilder CreateStringBuilder(Memory::HAllocator allocator = Memory::StandardAllocator);
+		}
+	}
+}
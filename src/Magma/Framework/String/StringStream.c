@@ -146,6 +146,20 @@ static mfError mfsStringStreamTell(void* stream, mfmU64* out)
 	return MF_ERROR_OKAY;
 }
 
+static mfError mfsStringStreamGetSpan(void* stream, mfmU64 size, const mfmU8** data, mfmU64* outSize)
+{
+	mfsStringStream* str = (mfsStringStream*)stream;
+	if (str->head >= str->base.bufferSize)
+		return MFS_ERROR_EOF;
+
+	if (size > str->base.bufferSize - str->head)
+		size = str->base.bufferSize - str->head;
+	*data = str->base.buffer + str->head;
+	*outSize = size;
+	str->head += size;
+	return MF_ERROR_OKAY;
+}
+
 mfError mfsCreateStringStream(mfsStream ** stream, mfmU8 * buffer, mfmU64 size, void * allocator)
 {
 	mfsStringStream* str = NULL;
@@ -172,6 +186,7 @@ mfError mfsCreateStringStream(mfsStream ** stream, mfmU8 * buffer, mfmU64 size,
 	str->base.seekHead = &mfsStringStreamSeekHead;
 	str->base.tell = &mfsStringStreamTell;
 	str->base.eof = &mfsStringStreamEOF;
+	str->base.getSpan = &mfsStringStreamGetSpan;
 
 	str->allocator = allocator;
 	if (str->allocator != NULL)
@@ -227,6 +242,7 @@ mfError mfsCreateLocalStringStream(mfsStringStream * stream, mfmU8 * buffer, mfm
 	stream->base.seekHead = &mfsStringStreamSeekHead;
 	stream->base.tell = &mfsStringStreamTell;
 	stream->base.eof = &mfsStringStreamEOF;
+	stream->base.getSpan = &mfsStringStreamGetSpan;
 
 	stream->allocator = NULL;
 	stream->head = 0;
@@ -1,6 +1,27 @@
 #include "UTF8.h"
+#include "Config.h"
 
-mfmBool mfsIsValidUTF8Char(mfsUTF8CodeUnit * chr)
+#include <string.h>
+
+#if defined(MAGMA_FRAMEWORK_USE_AVX2)
+#include <immintrin.h>
+#elif defined(MAGMA_FRAMEWORK_USE_SSE2)
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define MFS_UTF8_USE_SSSE3
+#endif
+#endif
+
+/*
+	The buffer functions follow the Unicode standard strictly: overlong encodings, surrogates and values past U+10FFFF are rejected.
+	Runs of ASCII are skipped, widened or narrowed 8 to 32 bytes at a time.
+	With AVX2 (or SSSE3, on the SSE2 configuration), mfsValidateUTF8 checks whole blocks with the lookup table algorithm by
+	Keiser and Lemire, where each pair of bytes is classified by the nibbles of the first byte and the high nibble of the
+	second one. The scalar validator finds the exact position of the error after a block with an error.
+*/
+
+mfmBool mfsIsValidUTF8Char(const mfsUTF8CodeUnit * chr)
 {
 	if ((*chr & 0b1000'0000) == 0b0000'0000)
 	{
@@ -155,4 +176,437 @@ mfError mfsSetUTF8Char(mfsUnicodePoint up, mfsUTF8CodeUnit * chr, mfmU64 * chrSi
 		*chrSize = sz;
 
 	return MF_ERROR_OKAY;
-}
\ No newline at end of file
+}
+
+// Decodes the sequence at the start of str, returns its size or 0 if it is invalid or cut at the end of the buffer
+static mfmU64 mfsDecodeUTF8Sequence(const mfmU8* str, mfmU64 size, mfsUnicodePoint* outUp)
+{
+	mfmU8 lead = str[0];
+	if (lead < 0x80)
+	{
+		*outUp = lead;
+		return 1;
+	}
+	else if (lead < 0xC2) // Continuation byte or overlong two byte sequence
+		return 0;
+	else if (lead < 0xE0)
+	{
+		if (size < 2 || (str[1] & 0xC0) != 0x80)
+			return 0;
+		*outUp = ((mfsUnicodePoint)(lead & 0x1F) << 6) | (str[1] & 0x3F);
+		return 2;
+	}
+	else if (lead < 0xF0)
+	{
+		if (size < 3 || (str[1] & 0xC0) != 0x80 || (str[2] & 0xC0) != 0x80)
+			return 0;
+		if ((lead == 0xE0 && str[1] < 0xA0) || // Overlong
+			(lead == 0xED && str[1] >= 0xA0))  // Surrogate
+			return 0;
+		*outUp = ((mfsUnicodePoint)(lead & 0x0F) << 12) | ((mfsUnicodePoint)(str[1] & 0x3F) << 6) | (str[2] & 0x3F);
+		return 3;
+	}
+	else if (lead < 0xF5)
+	{
+		if (size < 4 || (str[1] & 0xC0) != 0x80 || (str[2] & 0xC0) != 0x80 || (str[3] & 0xC0) != 0x80)
+			return 0;
+		if ((lead == 0xF0 && str[1] < 0x90) || // Overlong
+			(lead == 0xF4 && str[1] >= 0x90))  // Past U+10FFFF
+			return 0;
+		*outUp = ((mfsUnicodePoint)(lead & 0x07) << 18) | ((mfsUnicodePoint)(str[1] & 0x3F) << 12) |
+				 ((mfsUnicodePoint)(str[2] & 0x3F) << 6) | (str[3] & 0x3F);
+		return 4;
+	}
+	else
+		return 0;
+}
+
+// Returns the size of the run of ASCII characters at the start of str
+static mfmU64 mfsSkipASCII(const mfmU8* str, mfmU64 size)
+{
+	mfmU64 i = 0;
+#if defined(MAGMA_FRAMEWORK_USE_AVX2)
+	for (; i + 32 <= size; i += 32)
+		if (_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(str + i))) != 0)
+			break;
+#elif defined(MAGMA_FRAMEWORK_USE_SSE2)
+	for (; i + 16 <= size; i += 16)
+		if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(str + i))) != 0)
+			break;
+#endif
+	for (; i + 8 <= size; i += 8)
+	{
+		mfmU64 word;
+		memcpy(&word, str + i, sizeof(word));
+		if ((word & 0x8080808080808080) != 0)
+			break;
+	}
+	while (i < size && str[i] < 0x80)
+		++i;
+	return i;
+}
+
+// Returns the size of the valid part at the start of str
+static mfmU64 mfsValidateUTF8Scalar(const mfmU8* str, mfmU64 size)
+{
+	mfmU64 i = 0;
+	while (i < size)
+	{
+		if (str[i] < 0x80)
+		{
+			i += mfsSkipASCII(str + i, size - i);
+			continue;
+		}
+
+		mfsUnicodePoint up;
+		mfmU64 sequenceSize = mfsDecodeUTF8Sequence(str + i, size - i, &up);
+		if (sequenceSize == 0)
+			return i;
+		i += sequenceSize;
+	}
+	return size;
+}
+
+#if defined(MAGMA_FRAMEWORK_USE_AVX2) || defined(MFS_UTF8_USE_SSSE3)
+// Error bits of the lookup tables, set for the pairs of bytes where each error happens
+#define MFS_UTF8_TOO_SHORT		(1 << 0) // Lead byte not followed by a continuation byte
+#define MFS_UTF8_TOO_LONG		(1 << 1) // ASCII followed by a continuation byte
+#define MFS_UTF8_OVERLONG_3		(1 << 2) // 11100000 100xxxxx
+#define MFS_UTF8_TOO_LARGE		(1 << 3) // 11110100 1001xxxx, 11110100 101xxxxx, or a bigger lead byte
+#define MFS_UTF8_SURROGATE		(1 << 4) // 11101101 101xxxxx
+#define MFS_UTF8_OVERLONG_2		(1 << 5) // 1100000x 10xxxxxx
+#define MFS_UTF8_TOO_LARGE_1000	(1 << 6) // 11110101 1000xxxx or a bigger lead byte
+#define MFS_UTF8_OVERLONG_4		(1 << 6) // 11110000 1000xxxx
+#define MFS_UTF8_TWO_CONTS		(1 << 7) // Continuation byte followed by a continuation byte, valid only inside a sequence
+#define MFS_UTF8_CARRY			(MFS_UTF8_TOO_SHORT | MFS_UTF8_TOO_LONG | MFS_UTF8_TWO_CONTS)
+
+// Indexed by the high nibble of the first byte
+#define MFS_UTF8_BYTE_1_HIGH_TABLE \
+	MFS_UTF8_TOO_LONG, MFS_UTF8_TOO_LONG, MFS_UTF8_TOO_LONG, MFS_UTF8_TOO_LONG, \
+	MFS_UTF8_TOO_LONG, MFS_UTF8_TOO_LONG, MFS_UTF8_TOO_LONG, MFS_UTF8_TOO_LONG, \
+	MFS_UTF8_TWO_CONTS, MFS_UTF8_TWO_CONTS, MFS_UTF8_TWO_CONTS, MFS_UTF8_TWO_CONTS, \
+	MFS_UTF8_TOO_SHORT | MFS_UTF8_OVERLONG_2, \
+	MFS_UTF8_TOO_SHORT, \
+	MFS_UTF8_TOO_SHORT | MFS_UTF8_OVERLONG_3 | MFS_UTF8_SURROGATE, \
+	MFS_UTF8_TOO_SHORT | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000 | MFS_UTF8_OVERLONG_4
+
+// Indexed by the low nibble of the first byte
+#define MFS_UTF8_BYTE_1_LOW_TABLE \
+	MFS_UTF8_CARRY | MFS_UTF8_OVERLONG_3 | MFS_UTF8_OVERLONG_2 | MFS_UTF8_OVERLONG_4, \
+	MFS_UTF8_CARRY | MFS_UTF8_OVERLONG_2, \
+	MFS_UTF8_CARRY, \
+	MFS_UTF8_CARRY, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000 | MFS_UTF8_SURROGATE, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000, \
+	MFS_UTF8_CARRY | MFS_UTF8_TOO_LARGE | MFS_UTF8_TOO_LARGE_1000
+
+// Indexed by the high nibble of the second byte
+#define MFS_UTF8_BYTE_2_HIGH_TABLE \
+	MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, \
+	MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, \
+	MFS_UTF8_TOO_LONG | MFS_UTF8_OVERLONG_2 | MFS_UTF8_TWO_CONTS | MFS_UTF8_OVERLONG_3 | MFS_UTF8_TOO_LARGE_1000 | MFS_UTF8_OVERLONG_4, \
+	MFS_UTF8_TOO_LONG | MFS_UTF8_OVERLONG_2 | MFS_UTF8_TWO_CONTS | MFS_UTF8_OVERLONG_3 | MFS_UTF8_TOO_LARGE, \
+	MFS_UTF8_TOO_LONG | MFS_UTF8_OVERLONG_2 | MFS_UTF8_TWO_CONTS | MFS_UTF8_SURROGATE | MFS_UTF8_TOO_LARGE, \
+	MFS_UTF8_TOO_LONG | MFS_UTF8_OVERLONG_2 | MFS_UTF8_TWO_CONTS | MFS_UTF8_SURROGATE | MFS_UTF8_TOO_LARGE, \
+	MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT, MFS_UTF8_TOO_SHORT
+
+// Largest values of the last bytes of a block which don't start a sequence that continues in the next block
+#define MFS_UTF8_INCOMPLETE_TABLE -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+#define MFS_UTF8_ANY_BYTE_TABLE -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+#endif
+
+#if defined(MAGMA_FRAMEWORK_USE_AVX2)
+// Validates the 32 byte blocks of str, returns the offset of the first block with an error (or after the last block)
+static mfmU64 mfsValidateUTF8Blocks(const mfmU8* str, mfmU64 size)
+{
+	const __m256i byte1HighTable = _mm256_setr_epi8(MFS_UTF8_BYTE_1_HIGH_TABLE, MFS_UTF8_BYTE_1_HIGH_TABLE);
+	const __m256i byte1LowTable = _mm256_setr_epi8(MFS_UTF8_BYTE_1_LOW_TABLE, MFS_UTF8_BYTE_1_LOW_TABLE);
+	const __m256i byte2HighTable = _mm256_setr_epi8(MFS_UTF8_BYTE_2_HIGH_TABLE, MFS_UTF8_BYTE_2_HIGH_TABLE);
+	const __m256i incompleteTable = _mm256_setr_epi8(MFS_UTF8_ANY_BYTE_TABLE, MFS_UTF8_INCOMPLETE_TABLE);
+	const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+
+	__m256i previousInput = _mm256_setzero_si256();
+	__m256i previousIncomplete = _mm256_setzero_si256();
+	mfmU64 i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		__m256i input = _mm256_loadu_si256((const __m256i*)(str + i));
+		__m256i error;
+		if (_mm256_movemask_epi8(input) == 0)
+			error = previousIncomplete; // Only a sequence cut at the end of the previous block can be invalid
+		else
+		{
+			// Bytes 1, 2 and 3 positions before each byte
+			__m256i previousHalf = _mm256_permute2x128_si256(previousInput, input, 0x21);
+			__m256i previous1 = _mm256_alignr_epi8(input, previousHalf, 15);
+			__m256i previous2 = _mm256_alignr_epi8(input, previousHalf, 14);
+			__m256i previous3 = _mm256_alignr_epi8(input, previousHalf, 13);
+
+			__m256i byte1High = _mm256_shuffle_epi8(byte1HighTable, _mm256_and_si256(_mm256_srli_epi16(previous1, 4), lowNibble));
+			__m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(previous1, lowNibble));
+			__m256i byte2High = _mm256_shuffle_epi8(byte2HighTable, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble));
+			__m256i specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+			// The third and fourth bytes of a sequence must be continuation bytes, and are the only ones where two continuation bytes are valid
+			__m256i isThirdByte = _mm256_subs_epu8(previous2, _mm256_set1_epi8(0xE0 - 0x80));
+			__m256i isFourthByte = _mm256_subs_epu8(previous3, _mm256_set1_epi8(0xF0 - 0x80));
+			__m256i mustBeContinuation = _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte), _mm256_set1_epi8((char)0x80));
+			error = _mm256_xor_si256(mustBeContinuation, specialCases);
+
+			previousIncomplete = _mm256_subs_epu8(input, incompleteTable);
+		}
+
+		if (_mm256_testz_si256(error, error) == 0)
+			break;
+		previousInput = input;
+	}
+	return i;
+}
+#elif defined(MFS_UTF8_USE_SSSE3)
+// Validates the 16 byte blocks of str, returns the offset of the first block with an error (or after the last block)
+static mfmU64 mfsValidateUTF8Blocks(const mfmU8* str, mfmU64 size)
+{
+	const __m128i byte1HighTable = _mm_setr_epi8(MFS_UTF8_BYTE_1_HIGH_TABLE);
+	const __m128i byte1LowTable = _mm_setr_epi8(MFS_UTF8_BYTE_1_LOW_TABLE);
+	const __m128i byte2HighTable = _mm_setr_epi8(MFS_UTF8_BYTE_2_HIGH_TABLE);
+	const __m128i incompleteTable = _mm_setr_epi8(MFS_UTF8_INCOMPLETE_TABLE);
+	const __m128i lowNibble = _mm_set1_epi8(0x0F);
+
+	__m128i previousInput = _mm_setzero_si128();
+	__m128i previousIncomplete = _mm_setzero_si128();
+	mfmU64 i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i input = _mm_loadu_si128((const __m128i*)(str + i));
+		__m128i error;
+		if (_mm_movemask_epi8(input) == 0)
+			error = previousIncomplete; // Only a sequence cut at the end of the previous block can be invalid
+		else
+		{
+			// Bytes 1, 2 and 3 positions before each byte
+			__m128i previous1 = _mm_alignr_epi8(input, previousInput, 15);
+			__m128i previous2 = _mm_alignr_epi8(input, previousInput, 14);
+			__m128i previous3 = _mm_alignr_epi8(input, previousInput, 13);
+
+			__m128i byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(previous1, 4), lowNibble));
+			__m128i byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(previous1, lowNibble));
+			__m128i byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble));
+			__m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+			// The third and fourth bytes of a sequence must be continuation bytes, and are the only ones where two continuation bytes are valid
+			__m128i isThirdByte = _mm_subs_epu8(previous2, _mm_set1_epi8(0xE0 - 0x80));
+			__m128i isFourthByte = _mm_subs_epu8(previous3, _mm_set1_epi8(0xF0 - 0x80));
+			__m128i mustBeContinuation = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte), _mm_set1_epi8((char)0x80));
+			error = _mm_xor_si128(mustBeContinuation, specialCases);
+
+			previousIncomplete = _mm_subs_epu8(input, incompleteTable);
+		}
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF)
+			break;
+		previousInput = input;
+	}
+	return i;
+}
+#endif
+
+mfError mfsValidateUTF8(const mfsUTF8CodeUnit * str, mfmU64 size, mfmU64 * outValidSize)
+{
+	if (str == NULL && size != 0)
+		return MFS_ERROR_INVALID_ARGUMENTS;
+
+	const mfmU8* data = (const mfmU8*)str;
+	mfmU64 start = 0;
+#if defined(MAGMA_FRAMEWORK_USE_AVX2) || defined(MFS_UTF8_USE_SSSE3)
+	// The blocks before start are valid, except for a sequence which may continue after them, so the rest is checked from its first byte
+	start = mfsValidateUTF8Blocks(data, size);
+	for (mfmU64 i = 0; i < 3 && start > 0 && (data[start - 1] & 0xC0) == 0x80; ++i)
+		--start;
+	if (start > 0 && data[start - 1] >= 0xC0)
+		--start;
+#endif
+
+	mfmU64 validSize = start + mfsValidateUTF8Scalar(data + start, size - start);
+	if (outValidSize != NULL)
+		*outValidSize = validSize;
+	return validSize == size ? MF_ERROR_OKAY : MFS_ERROR_INVALID_UTF8;
+}
+
+mfError mfsUTF8ToUTF32(const mfsUTF8CodeUnit * src, mfmU64 srcSize, mfsUTF32CodeUnit * dst, mfmU64 dstSize, mfmU64 * outSize)
+{
+	if ((src == NULL && srcSize != 0) || (dst == NULL && outSize == NULL))
+		return MFS_ERROR_INVALID_ARGUMENTS;
+
+	const mfmU8* data = (const mfmU8*)src;
+	mfmU64 i = 0, o = 0;
+	mfError err = MF_ERROR_OKAY;
+	while (i < srcSize)
+	{
+		if (data[i] < 0x80)
+		{
+			if (dst == NULL)
+			{
+				mfmU64 asciiSize = mfsSkipASCII(data + i, srcSize - i);
+				i += asciiSize;
+				o += asciiSize;
+				continue;
+			}
+
+			// Widen runs of ASCII characters
+#if defined(MAGMA_FRAMEWORK_USE_AVX2)
+			for (; i + 16 <= srcSize && o + 16 <= dstSize; i += 16, o += 16)
+			{
+				__m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+				if (_mm_movemask_epi8(chunk) != 0)
+					break;
+				_mm256_storeu_si256((__m256i*)(dst + o), _mm256_cvtepu8_epi32(chunk));
+				_mm256_storeu_si256((__m256i*)(dst + o + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(chunk, 8)));
+			}
+#elif defined(MAGMA_FRAMEWORK_USE_SSE2)
+			for (; i + 16 <= srcSize && o + 16 <= dstSize; i += 16, o += 16)
+			{
+				__m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+				if (_mm_movemask_epi8(chunk) != 0)
+					break;
+				__m128i zero = _mm_setzero_si128();
+				__m128i low = _mm_unpacklo_epi8(chunk, zero);
+				__m128i high = _mm_unpackhi_epi8(chunk, zero);
+				_mm_storeu_si128((__m128i*)(dst + o), _mm_unpacklo_epi16(low, zero));
+				_mm_storeu_si128((__m128i*)(dst + o + 4), _mm_unpackhi_epi16(low, zero));
+				_mm_storeu_si128((__m128i*)(dst + o + 8), _mm_unpacklo_epi16(high, zero));
+				_mm_storeu_si128((__m128i*)(dst + o + 12), _mm_unpackhi_epi16(high, zero));
+			}
+#endif
+			for (; i < srcSize && data[i] < 0x80; ++i, ++o)
+			{
+				if (o == dstSize)
+				{
+					err = MFS_ERROR_EOF;
+					break;
+				}
+				dst[o] = data[i];
+			}
+			if (err != MF_ERROR_OKAY)
+				break;
+			continue;
+		}
+
+		mfsUnicodePoint up;
+		mfmU64 sequenceSize = mfsDecodeUTF8Sequence(data + i, srcSize - i, &up);
+		if (sequenceSize == 0)
+		{
+			err = MFS_ERROR_INVALID_UTF8;
+			break;
+		}
+		if (dst != NULL)
+		{
+			if (o == dstSize)
+			{
+				err = MFS_ERROR_EOF;
+				break;
+			}
+			dst[o] = up;
+		}
+		i += sequenceSize;
+		++o;
+	}
+
+	if (outSize != NULL)
+		*outSize = o;
+	return err;
+}
+
+mfError mfsUTF32ToUTF8(const mfsUTF32CodeUnit * src, mfmU64 srcSize, mfsUTF8CodeUnit * dst, mfmU64 dstSize, mfmU64 * outSize)
+{
+	if ((src == NULL && srcSize != 0) || (dst == NULL && outSize == NULL))
+		return MFS_ERROR_INVALID_ARGUMENTS;
+
+	mfmU8* data = (mfmU8*)dst;
+	mfmU64 i = 0, o = 0;
+	mfError err = MF_ERROR_OKAY;
+	while (i < srcSize)
+	{
+		// Narrow runs of ASCII characters
+#if defined(MAGMA_FRAMEWORK_USE_AVX2) || defined(MAGMA_FRAMEWORK_USE_SSE2)
+		if (src[i] < 0x80 && data != NULL)
+		{
+			const __m128i notASCII = _mm_set1_epi32(~0x7F);
+			for (; i + 8 <= srcSize && o + 8 <= dstSize; i += 8, o += 8)
+			{
+				__m128i low = _mm_loadu_si128((const __m128i*)(src + i));
+				__m128i high = _mm_loadu_si128((const __m128i*)(src + i + 4));
+				__m128i invalid = _mm_and_si128(_mm_or_si128(low, high), notASCII);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(invalid, _mm_setzero_si128())) != 0xFFFF)
+					break;
+				__m128i words = _mm_packs_epi32(low, high);
+				_mm_storel_epi64((__m128i*)(data + o), _mm_packus_epi16(words, words));
+			}
+			if (i == srcSize)
+				break;
+		}
+#endif
+
+		mfsUnicodePoint up = src[i];
+		mfmU64 size;
+		if (up < 0x80)
+			size = 1;
+		else if (up < 0x800)
+			size = 2;
+		else if (up < 0x10000)
+			size = 3;
+		else
+			size = 4;
+		if (up > 0x10FFFF || (up >= 0xD800 && up <= 0xDFFF))
+		{
+			err = MFS_ERROR_INVALID_UNICODE;
+			break;
+		}
+
+		if (data != NULL)
+		{
+			if (o + size > dstSize)
+			{
+				err = MFS_ERROR_EOF;
+				break;
+			}
+
+			switch (size)
+			{
+				case 1:
+					data[o] = (mfmU8)up;
+					break;
+				case 2:
+					data[o + 0] = (mfmU8)(0xC0 | (up >> 6));
+					data[o + 1] = (mfmU8)(0x80 | (up & 0x3F));
+					break;
+				case 3:
+					data[o + 0] = (mfmU8)(0xE0 | (up >> 12));
+					data[o + 1] = (mfmU8)(0x80 | ((up >> 6) & 0x3F));
+					data[o + 2] = (mfmU8)(0x80 | (up & 0x3F));
+					break;
+				default:
+					data[o + 0] = (mfmU8)(0xF0 | (up >> 18));
+					data[o + 1] = (mfmU8)(0x80 | ((up >> 12) & 0x3F));
+					data[o + 2] = (mfmU8)(0x80 | ((up >> 6) & 0x3F));
+					data[o + 3] = (mfmU8)(0x80 | (up & 0x3F));
+					break;
+			}
+		}
+
+		o += size;
+		++i;
+	}
+
+	if (outSize != NULL)
+		*outSize = o;
+	return err;
+}
@@ -71,6 +71,53 @@ extern "C"
 	/// </returns>
 	mfError mfsSetUTF8Char(mfsUnicodePoint up, mfsUTF8CodeUnit* chr, mfmU64* chrSize, mfmU64 maxChrSize);
 
+	/// <summary>
+	///		Checks if a UTF-8 buffer is valid.
+	///		Overlong encodings, surrogates, values past U+10FFFF and sequences cut at the end of the buffer are invalid.
+	/// </summary>
+	/// <param name="str">Pointer to UTF-8 buffer</param>
+	/// <param name="size">Buffer size in bytes</param>
+	/// <param name="outValidSize">Pointer to the size of the valid part at the start of the buffer (set to NULL to ignore)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if the buffer is valid UTF-8.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="str">str</paramref> is NULL and <paramref name="size">size</paramref> isn't 0.
+	///		Returns MFS_ERROR_INVALID_UTF8 if the buffer is invalid UTF-8.
+	/// </returns>
+	mfError mfsValidateUTF8(const mfsUTF8CodeUnit* str, mfmU64 size, mfmU64* outValidSize);
+
+	/// <summary>
+	///		Converts a UTF-8 buffer to UTF-32.
+	///		The source buffer is validated like in mfsValidateUTF8.
+	/// </summary>
+	/// <param name="src">Pointer to UTF-8 source buffer</param>
+	/// <param name="srcSize">Source buffer size in bytes</param>
+	/// <param name="dst">Pointer to UTF-32 destination buffer (set to NULL to only get the converted size)</param>
+	/// <param name="dstSize">Destination buffer size in code units</param>
+	/// <param name="outSize">Pointer to the number of code units converted, or converted before an error (set to NULL to ignore, unless dst is NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="src">src</paramref> is NULL and <paramref name="srcSize">srcSize</paramref> isn't 0, or if both dst and outSize are NULL.
+	///		Returns MFS_ERROR_INVALID_UTF8 if the source buffer is invalid UTF-8.
+	///		Returns MFS_ERROR_EOF if the destination buffer is too small.
+	/// </returns>
+	mfError mfsUTF8ToUTF32(const mfsUTF8CodeUnit* src, mfmU64 srcSize, mfsUTF32CodeUnit* dst, mfmU64 dstSize, mfmU64* outSize);
+
+	/// <summary>
+	///		Converts a UTF-32 buffer to UTF-8.
+	/// </summary>
+	/// <param name="src">Pointer to UTF-32 source buffer</param>
+	/// <param name="srcSize">Source buffer size in code units</param>
+	/// <param name="dst">Pointer to UTF-8 destination buffer (set to NULL to only get the converted size)</param>
+	/// <param name="dstSize">Destination buffer size in bytes</param>
+	/// <param name="outSize">Pointer to the number of bytes converted, or converted before an error (set to NULL to ignore, unless dst is NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFS_ERROR_INVALID_ARGUMENTS if <paramref name="src">src</paramref> is NULL and <paramref name="srcSize">srcSize</paramref> isn't 0, or if both dst and outSize are NULL.
+	///		Returns MFS_ERROR_INVALID_UNICODE if the source buffer has an invalid unicode point value.
+	///		Returns MFS_ERROR_EOF if the destination buffer is too small (characters are never cut).
+	/// </returns>
+	mfError mfsUTF32ToUTF8(const mfsUTF32CodeUnit* src, mfmU64 srcSize, mfsUTF8CodeUnit* dst, mfmU64 dstSize, mfmU64* outSize);
+
 #ifdef __cplusplus
 }
 #endif
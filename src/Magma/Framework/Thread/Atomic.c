@@ -11,7 +11,7 @@ mfError mftAtomicPointerLoad(const volatile void ** atomic, void ** out)
 	if (atomic == NULL || out == NULL)
 		return MFT_ERROR_INVALID_ARGUMENTS;
 #endif
-	*out = *atomic;
+	*out = (void*)*atomic;
 	return MF_ERROR_OKAY;
 }
 
@@ -25,6 +25,18 @@ mfError mftAtomicPointerStore(volatile void ** atomic, void * value)
 	return MF_ERROR_OKAY;
 }
 
+mfError mftAtomicPointerCompareExchange(volatile void ** atomic, void ** expected, void * desired, mfmBool * exchanged)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || expected == NULL || exchanged == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	void* previous = InterlockedCompareExchangePointer(atomic, desired, *expected);
+	*exchanged = (previous == *expected) ? MFM_TRUE : MFM_FALSE;
+	*expected = previous;
+	return MF_ERROR_OKAY;
+}
+
 mfError mftAtomic8Load(const volatile mfmI8 * atomic, mfmI8 * out)
 {
 #if defined(MAGMA_FRAMEWORK_DEBUG)
@@ -85,13 +97,314 @@ mfError mftAtomic32Store(volatile mfmI32 * atomic, mfmI32 value)
 	return MF_ERROR_OKAY;
 }
 
-mfError mftAtomic32Add(const volatile mfmI32 * atomic, mfmI32 value)
+mfError mftAtomic32Add(volatile mfmI32 * atomic, mfmI32 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	InterlockedExchangeAdd(atomic, value);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic32FetchAdd(volatile mfmI32 * atomic, mfmI32 value, mfmI32 * old)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || old == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*old = InterlockedExchangeAdd(atomic, value);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic32CompareExchange(volatile mfmI32 * atomic, mfmI32 * expected, mfmI32 desired, mfmBool * exchanged)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || expected == NULL || exchanged == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	mfmI32 previous = InterlockedCompareExchange(atomic, desired, *expected);
+	*exchanged = (previous == *expected) ? MFM_TRUE : MFM_FALSE;
+	*expected = previous;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64Load(const volatile mfmI64 * atomic, mfmI64 * out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	// Plain 64 bit loads aren't atomic on 32 bit targets
+	*out = InterlockedCompareExchange64((volatile mfmI64*)atomic, 0, 0);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64Store(volatile mfmI64 * atomic, mfmI64 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	InterlockedExchange64(atomic, value);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64LoadAcquire(const volatile mfmI64 * atomic, mfmI64 * out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+#if defined(_M_X64)
+	// Aligned loads are atomic and already have acquire semantics on x64, only the compiler must not reorder them
+	*out = *atomic;
+	_ReadWriteBarrier();
+#else
+	*out = InterlockedCompareExchangeAcquire64((volatile mfmI64*)atomic, 0, 0);
+#endif
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64StoreRelease(volatile mfmI64 * atomic, mfmI64 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+#if defined(_M_X64)
+	_ReadWriteBarrier();
+	*atomic = value;
+#else
+	InterlockedExchange64(atomic, value);
+#endif
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64Add(volatile mfmI64 * atomic, mfmI64 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	InterlockedExchangeAdd64(atomic, value);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64FetchAdd(volatile mfmI64 * atomic, mfmI64 value, mfmI64 * old)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || old == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*old = InterlockedExchangeAdd64(atomic, value);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64CompareExchange(volatile mfmI64 * atomic, mfmI64 * expected, mfmI64 desired, mfmBool * exchanged)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || expected == NULL || exchanged == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	mfmI64 previous = InterlockedCompareExchange64(atomic, desired, *expected);
+	*exchanged = (previous == *expected) ? MFM_TRUE : MFM_FALSE;
+	*expected = previous;
+	return MF_ERROR_OKAY;
+}
+
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+// Uses the GCC/Clang atomic builtins, which work on the plain (non _Atomic) variables used by this API
+
+mfError mftAtomicPointerLoad(const volatile void ** atomic, void ** out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	// The loaded pointer is const volatile qualified like the atomic variable, which the out pointer isn't
+	*out = (void*)__atomic_load_n(atomic, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomicPointerStore(volatile void ** atomic, void * value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	__atomic_store_n(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomicPointerCompareExchange(volatile void ** atomic, void ** expected, void * desired, mfmBool * exchanged)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || expected == NULL || exchanged == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*exchanged = __atomic_compare_exchange_n(atomic, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? MFM_TRUE : MFM_FALSE;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic8Load(const volatile mfmI8 * atomic, mfmI8 * out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*out = __atomic_load_n(atomic, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic8Store(volatile mfmI8 * atomic, mfmI8 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	__atomic_store_n(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic16Load(const volatile mfmI16 * atomic, mfmI16 * out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*out = __atomic_load_n(atomic, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic16Store(volatile mfmI16 * atomic, mfmI16 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	__atomic_store_n(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic32Load(const volatile mfmI32 * atomic, mfmI32 * out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*out = __atomic_load_n(atomic, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic32Store(volatile mfmI32 * atomic, mfmI32 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	__atomic_store_n(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic32Add(volatile mfmI32 * atomic, mfmI32 value)
 {
 #if defined(MAGMA_FRAMEWORK_DEBUG)
 	if (atomic == NULL)
 		return MFT_ERROR_INVALID_ARGUMENTS;
 #endif
-	InterlockedAdd(atomic, value);
+	__atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic32FetchAdd(volatile mfmI32 * atomic, mfmI32 value, mfmI32 * old)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || old == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*old = __atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic32CompareExchange(volatile mfmI32 * atomic, mfmI32 * expected, mfmI32 desired, mfmBool * exchanged)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || expected == NULL || exchanged == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*exchanged = __atomic_compare_exchange_n(atomic, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? MFM_TRUE : MFM_FALSE;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64Load(const volatile mfmI64 * atomic, mfmI64 * out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*out = __atomic_load_n(atomic, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64Store(volatile mfmI64 * atomic, mfmI64 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	__atomic_store_n(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64LoadAcquire(const volatile mfmI64 * atomic, mfmI64 * out)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || out == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*out = __atomic_load_n(atomic, __ATOMIC_ACQUIRE);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64StoreRelease(volatile mfmI64 * atomic, mfmI64 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	__atomic_store_n(atomic, value, __ATOMIC_RELEASE);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64Add(volatile mfmI64 * atomic, mfmI64 value)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	__atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64FetchAdd(volatile mfmI64 * atomic, mfmI64 value, mfmI64 * old)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || old == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*old = __atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftAtomic64CompareExchange(volatile mfmI64 * atomic, mfmI64 * expected, mfmI64 desired, mfmBool * exchanged)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (atomic == NULL || expected == NULL || exchanged == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+	*exchanged = __atomic_compare_exchange_n(atomic, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? MFM_TRUE : MFM_FALSE;
 	return MF_ERROR_OKAY;
 }
 
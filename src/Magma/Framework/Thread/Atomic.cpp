@@ -34,6 +34,18 @@ void Magma::Framework::Thread::Atomic<T*>::Store(T * value)
 		throw AtomicError(mfErrorToString(err));
 }
 
+template<typename T>
+bool Magma::Framework::Thread::Atomic<T*>::CompareExchange(T *& expected, T * desired)
+{
+	void* expectedValue = expected;
+	mfmBool exchanged;
+	mfError err = mftAtomicPointerCompareExchange(&m_value, &expectedValue, desired, &exchanged);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+	expected = (T*)expectedValue;
+	return exchanged != MFM_FALSE;
+}
+
 Magma::Framework::Thread::Atomic<mfmI8>::Atomic(mfmI8 value)
 {
 	m_value = value;
@@ -125,3 +137,95 @@ void Magma::Framework::Thread::Atomic<mfmI32>::Subtract(mfmI32 value)
 	if (err != MF_ERROR_OKAY)
 		throw AtomicError(mfErrorToString(err));
 }
+
+mfmI32 Magma::Framework::Thread::Atomic<mfmI32>::FetchAdd(mfmI32 value)
+{
+	mfmI32 old;
+	mfError err = mftAtomic32FetchAdd(&m_value, value, &old);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+	return old;
+}
+
+bool Magma::Framework::Thread::Atomic<mfmI32>::CompareExchange(mfmI32 & expected, mfmI32 desired)
+{
+	mfmBool exchanged;
+	mfError err = mftAtomic32CompareExchange(&m_value, &expected, desired, &exchanged);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+	return exchanged != MFM_FALSE;
+}
+
+Magma::Framework::Thread::Atomic<mfmI64>::Atomic(mfmI64 value)
+{
+	m_value = value;
+}
+
+Magma::Framework::Thread::Atomic<mfmI64>::~Atomic()
+{
+	// Do nothing
+}
+
+mfmI64 Magma::Framework::Thread::Atomic<mfmI64>::Load() const
+{
+	mfmI64 value;
+	mfError err = mftAtomic64Load(&m_value, &value);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+	return value;
+}
+
+void Magma::Framework::Thread::Atomic<mfmI64>::Store(mfmI64 value)
+{
+	mfError err = mftAtomic64Store(&m_value, value);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+}
+
+mfmI64 Magma::Framework::Thread::Atomic<mfmI64>::LoadAcquire() const
+{
+	mfmI64 value;
+	mfError err = mftAtomic64LoadAcquire(&m_value, &value);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+	return value;
+}
+
+void Magma::Framework::Thread::Atomic<mfmI64>::StoreRelease(mfmI64 value)
+{
+	mfError err = mftAtomic64StoreRelease(&m_value, value);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+}
+
+void Magma::Framework::Thread::Atomic<mfmI64>::Add(mfmI64 value)
+{
+	mfError err = mftAtomic64Add(&m_value, value);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+}
+
+void Magma::Framework::Thread::Atomic<mfmI64>::Subtract(mfmI64 value)
+{
+	mfError err = mftAtomic64Add(&m_value, -value);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+}
+
+mfmI64 Magma::Framework::Thread::Atomic<mfmI64>::FetchAdd(mfmI64 value)
+{
+	mfmI64 old;
+	mfError err = mftAtomic64FetchAdd(&m_value, value, &old);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+	return old;
+}
+
+bool Magma::Framework::Thread::Atomic<mfmI64>::CompareExchange(mfmI64 & expected, mfmI64 desired)
+{
+	mfmBool exchanged;
+	mfError err = mftAtomic64CompareExchange(&m_value, &expected, desired, &exchanged);
+	if (err != MF_ERROR_OKAY)
+		throw AtomicError(mfErrorToString(err));
+	return exchanged != MFM_FALSE;
+}
@@ -33,6 +33,20 @@ extern "C"
 	/// </returns>
 	mfError mftAtomicPointerStore(volatile void** atomic, void* value);
 
+	/// <summary>
+	///		Compares an atomic pointer variable value with an expected value and, if they're equal, replaces it with a new value.
+	///		If they aren't equal, the expected value is set to the current value.
+	/// </summary>
+	/// <param name="atomic">Pointer to pointer atomic variable</param>
+	/// <param name="expected">Pointer to expected value</param>
+	/// <param name="desired">New value</param>
+	/// <param name="exchanged">Out value set to MFM_TRUE if the value was replaced, otherwise MFM_FALSE</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomicPointerCompareExchange(volatile void** atomic, void** expected, void* desired, mfmBool* exchanged);
+
 	/// <summary>
 	///		Gets an atomic 8 bit variable value.
 	/// </summary>
@@ -110,6 +124,115 @@ extern "C"
 	/// </returns>
 	mfError mftAtomic32Add(volatile mfmI32* atomic, mfmI32 value);
 
+	/// <summary>
+	///		Adds a value to an atomic 32 bit variable and gets its previous value.
+	/// </summary>
+	/// <param name="atomic">Pointer to 32 bit atomic variable</param>
+	/// <param name="value">Value to add to atomic variable</param>
+	/// <param name="old">Output value before the addition</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic32FetchAdd(volatile mfmI32* atomic, mfmI32 value, mfmI32* old);
+
+	/// <summary>
+	///		Compares an atomic 32 bit variable value with an expected value and, if they're equal, replaces it with a new value.
+	///		If they aren't equal, the expected value is set to the current value.
+	/// </summary>
+	/// <param name="atomic">Pointer to 32 bit atomic variable</param>
+	/// <param name="expected">Pointer to expected value</param>
+	/// <param name="desired">New value</param>
+	/// <param name="exchanged">Out value set to MFM_TRUE if the value was replaced, otherwise MFM_FALSE</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic32CompareExchange(volatile mfmI32* atomic, mfmI32* expected, mfmI32 desired, mfmBool* exchanged);
+
+	/// <summary>
+	///		Gets an atomic 64 bit variable value.
+	/// </summary>
+	/// <param name="atomic">Pointer to 64 bit atomic variable</param>
+	/// <param name="out">Output value</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic64Load(const volatile mfmI64* atomic, mfmI64* out);
+
+	/// <summary>
+	///		Sets an atomic 64 bit variable value.
+	/// </summary>
+	/// <param name="atomic">Pointer to 64 bit atomic variable</param>
+	/// <param name="value">New value</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic64Store(volatile mfmI64* atomic, mfmI64 value);
+
+	/// <summary>
+	///		Gets an atomic 64 bit variable value with acquire ordering only.
+	///		Cheaper than mftAtomic64Load, pairs with mftAtomic64StoreRelease to publish data written before the store.
+	/// </summary>
+	/// <param name="atomic">Pointer to 64 bit atomic variable</param>
+	/// <param name="out">Output value</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic64LoadAcquire(const volatile mfmI64* atomic, mfmI64* out);
+
+	/// <summary>
+	///		Sets an atomic 64 bit variable value with release ordering only.
+	///		Cheaper than mftAtomic64Store, the writes made before it are visible to threads which read the value with mftAtomic64LoadAcquire.
+	/// </summary>
+	/// <param name="atomic">Pointer to 64 bit atomic variable</param>
+	/// <param name="value">New value</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic64StoreRelease(volatile mfmI64* atomic, mfmI64 value);
+
+	/// <summary>
+	///		Adds a value to an atomic 64 bit variable.
+	/// </summary>
+	/// <param name="atomic">Pointer to 64 bit atomic variable</param>
+	/// <param name="value">Value to add to atomic variable</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic64Add(volatile mfmI64* atomic, mfmI64 value);
+
+	/// <summary>
+	///		Adds a value to an atomic 64 bit variable and gets its previous value.
+	/// </summary>
+	/// <param name="atomic">Pointer to 64 bit atomic variable</param>
+	/// <param name="value">Value to add to atomic variable</param>
+	/// <param name="old">Output value before the addition</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic64FetchAdd(volatile mfmI64* atomic, mfmI64 value, mfmI64* old);
+
+	/// <summary>
+	///		Compares an atomic 64 bit variable value with an expected value and, if they're equal, replaces it with a new value.
+	///		If they aren't equal, the expected value is set to the current value.
+	/// </summary>
+	/// <param name="atomic">Pointer to 64 bit atomic variable</param>
+	/// <param name="expected">Pointer to expected value</param>
+	/// <param name="desired">New value</param>
+	/// <param name="exchanged">Out value set to MFM_TRUE if the value was replaced, otherwise MFM_FALSE</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftAtomic64CompareExchange(volatile mfmI64* atomic, mfmI64* expected, mfmI64 desired, mfmBool* exchanged);
+
 #ifdef __cplusplus
 }
 #endif
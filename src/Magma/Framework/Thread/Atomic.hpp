@@ -40,6 +40,14 @@ namespace Magma
 				/// <param name="value">New value</param>
 				void Store(T* value);
 
+				/// <summary>
+				///		Replaces the current value if it is equal to an expected value (thread-safe).
+				/// </summary>
+				/// <param name="expected">Expected value (set to the current value if they aren't equal)</param>
+				/// <param name="desired">New value</param>
+				/// <returns>True if the value was replaced, otherwise false</returns>
+				bool CompareExchange(T*& expected, T* desired);
+
 			private:
 				volatile void* m_value;
 			};
@@ -130,9 +138,89 @@ namespace Magma
 				/// <param name="value">Value to subtract</param>
 				void Subtract(mfmI32 value);
 
+				/// <summary>
+				///		Adds a value to the current value (thread-safe).
+				/// </summary>
+				/// <param name="value">Value to add</param>
+				/// <returns>Value before the addition</returns>
+				mfmI32 FetchAdd(mfmI32 value);
+
+				/// <summary>
+				///		Replaces the current value if it is equal to an expected value (thread-safe).
+				/// </summary>
+				/// <param name="expected">Expected value (set to the current value if they aren't equal)</param>
+				/// <param name="desired">New value</param>
+				/// <returns>True if the value was replaced, otherwise false</returns>
+				bool CompareExchange(mfmI32& expected, mfmI32 desired);
+
 			private:
 				volatile mfmI32 m_value;
 			};
+
+			/// <summary>
+			///		Encapsulates an atomic 64bit signed integer.
+			/// </summary>
+			template <>
+			class Atomic<mfmI64> final
+			{
+			public:
+				Atomic(mfmI64 value = 0);
+				~Atomic();
+
+				/// <summary>
+				///		Gets the current value (thread-safe).
+				/// </summary>
+				/// <returns>Current value</returns>
+				mfmI64 Load() const;
+
+				/// <summary>
+				///		Sets the current value (thread-safe).
+				/// </summary>
+				/// <param name="value">New value</param>
+				void Store(mfmI64 value);
+
+				/// <summary>
+				///		Gets the current value with acquire ordering only (thread-safe).
+				/// </summary>
+				/// <returns>Current value</returns>
+				mfmI64 LoadAcquire() const;
+
+				/// <summary>
+				///		Sets the current value with release ordering only (thread-safe).
+				/// </summary>
+				/// <param name="value">New value</param>
+				void StoreRelease(mfmI64 value);
+
+				/// <summary>
+				///		Adds a value to the current value (thread-safe).
+				/// </summary>
+				/// <param name="value">Value to add</param>
+				void Add(mfmI64 value);
+
+				/// <summary>
+				///		Subtracts a value from the current value (thread-safe).
+				/// </summary>
+				/// <param name="value">Value to subtract</param>
+				void Subtract(mfmI64 value);
+
+				/// <summary>
+				///		Adds a value to the current value (thread-safe).
+				/// </summary>
+				/// <param name="value">Value to add</param>
+				/// <returns>Value before the addition</returns>
+				mfmI64 FetchAdd(mfmI64 value);
+
+				/// <summary>
+				///		Replaces the current value if it is equal to an expected value (thread-safe).
+				/// </summary>
+				/// <param name="expected">Expected value (set to the current value if they aren't equal)</param>
+				/// <param name="desired">New value</param>
+				/// <returns>True if the value was replaced, otherwise false</returns>
+				bool CompareExchange(mfmI64& expected, mfmI64 desired);
+
+			private:
+				volatile mfmI64 m_value;
+			};
 		}
 	}
 }
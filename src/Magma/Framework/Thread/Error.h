@@ -12,6 +12,8 @@ extern "C"
 #define MFT_ERROR_TIMEOUT				0x0303
 #define MFT_ERROR_STILL_RUNNING			0x0304
 #define MFT_ERROR_MUTEX_LOCKED			0x0305
+#define MFT_ERROR_QUEUE_FULL			0x0306
+#define MFT_ERROR_QUEUE_EMPTY			0x0307
 
 #ifdef __cplusplus
 }
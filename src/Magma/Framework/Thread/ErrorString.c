@@ -16,6 +16,10 @@ const mfsUTF8CodeUnit * mftErrorToString(mfError err)
 			return u8"[MFT_ERROR_STILL_RUNNING] Thread is still running";
 		case MFT_ERROR_MUTEX_LOCKED:
 			return u8"[MFT_ERROR_MUTEX_LOCKED] Mutex is locked";
+		case MFT_ERROR_QUEUE_FULL:
+			return u8"[MFT_ERROR_QUEUE_FULL] Queue is full";
+		case MFT_ERROR_QUEUE_EMPTY:
+			return u8"[MFT_ERROR_QUEUE_EMPTY] Queue is empty";
 
 		default:
 			return NULL;
@@ -36,6 +36,24 @@ namespace Magma
 			public:
 				using std::runtime_error::runtime_error;
 			};
+
+			/// <summary>
+			///		Thrown when there is an error related to job systems.
+			/// </summary>
+			class JobSystemError : public std::runtime_error
+			{
+			public:
+				using std::runtime_error::runtime_error;
+			};
+
+			/// <summary>
+			///		Thrown when there is an error related to queues.
+			/// </summary>
+			class QueueError : public std::runtime_error
+			{
+			public:
+				using std::runtime_error::runtime_error;
+			};
 		}
 	}
 }
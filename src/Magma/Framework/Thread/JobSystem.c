@@ -0,0 +1,978 @@
+#include "JobSystem.h"
+#include "Thread.h"
+#include "Mutex.h"
+#include "Atomic.h"
+#include "Config.h"
+
+#include "../Memory/Object.h"
+#include "../Memory/Allocator.h"
+
+#include <stdlib.h>
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+
+#include <Windows.h>
+
+#define MFT_JOB_THREAD_LOCAL __declspec(thread)
+
+typedef struct
+{
+	HANDLE handle;
+} mftJobSemaphore;
+
+static mfError mftInitJobSemaphore(mftJobSemaphore* semaphore)
+{
+	semaphore->handle = CreateSemaphoreW(NULL, 0, MAXLONG, NULL);
+	if (semaphore->handle == NULL)
+		return MFT_ERROR_INTERNAL;
+	return MF_ERROR_OKAY;
+}
+
+static void mftDeinitJobSemaphore(mftJobSemaphore* semaphore)
+{
+	CloseHandle(semaphore->handle);
+}
+
+static void mftJobSemaphoreWait(mftJobSemaphore* semaphore)
+{
+	WaitForSingleObject(semaphore->handle, INFINITE);
+}
+
+static void mftJobSemaphorePost(mftJobSemaphore* semaphore, mfmU32 count)
+{
+	ReleaseSemaphore(semaphore->handle, (LONG)count, NULL);
+}
+
+// Condition which threads outside the job system sleep on while waiting for a counter
+typedef struct
+{
+	SRWLOCK lock;
+	CONDITION_VARIABLE cond;
+} mftJobCondition;
+
+static mfError mftInitJobCondition(mftJobCondition* condition)
+{
+	InitializeSRWLock(&condition->lock);
+	InitializeConditionVariable(&condition->cond);
+	return MF_ERROR_OKAY;
+}
+
+static void mftDeinitJobCondition(mftJobCondition* condition)
+{
+	// SRW locks and condition variables don't need to be destroyed
+}
+
+static void mftLockJobCondition(mftJobCondition* condition)
+{
+	AcquireSRWLockExclusive(&condition->lock);
+}
+
+static void mftUnlockJobCondition(mftJobCondition* condition)
+{
+	ReleaseSRWLockExclusive(&condition->lock);
+}
+
+static void mftJobConditionWait(mftJobCondition* condition)
+{
+	SleepConditionVariableSRW(&condition->cond, &condition->lock, INFINITE, 0);
+}
+
+static void mftJobConditionBroadcast(mftJobCondition* condition)
+{
+	WakeAllConditionVariable(&condition->cond);
+}
+
+static void mftJobYield(void)
+{
+	SwitchToThread();
+}
+
+static mfmU32 mftGetProcessorCount(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (mfmU32)info.dwNumberOfProcessors;
+}
+
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define MFT_JOB_THREAD_LOCAL _Thread_local
+
+// Unnamed POSIX semaphores aren't available everywhere (macOS), so a counting semaphore is built from a mutex and a condition variable
+typedef struct
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	mfmU32 count;
+} mftJobSemaphore;
+
+static mfError mftInitJobSemaphore(mftJobSemaphore* semaphore)
+{
+	if (pthread_mutex_init(&semaphore->mutex, NULL) != 0)
+		return MFT_ERROR_INTERNAL;
+	if (pthread_cond_init(&semaphore->cond, NULL) != 0)
+	{
+		pthread_mutex_destroy(&semaphore->mutex);
+		return MFT_ERROR_INTERNAL;
+	}
+	semaphore->count = 0;
+	return MF_ERROR_OKAY;
+}
+
+static void mftDeinitJobSemaphore(mftJobSemaphore* semaphore)
+{
+	pthread_cond_destroy(&semaphore->cond);
+	pthread_mutex_destroy(&semaphore->mutex);
+}
+
+static void mftJobSemaphoreWait(mftJobSemaphore* semaphore)
+{
+	pthread_mutex_lock(&semaphore->mutex);
+	while (semaphore->count == 0)
+		pthread_cond_wait(&semaphore->cond, &semaphore->mutex);
+	--semaphore->count;
+	pthread_mutex_unlock(&semaphore->mutex);
+}
+
+static void mftJobSemaphorePost(mftJobSemaphore* semaphore, mfmU32 count)
+{
+	pthread_mutex_lock(&semaphore->mutex);
+	semaphore->count += count;
+	if (count == 1)
+		pthread_cond_signal(&semaphore->cond);
+	else
+		pthread_cond_broadcast(&semaphore->cond);
+	pthread_mutex_unlock(&semaphore->mutex);
+}
+
+// Condition which threads outside the job system sleep on while waiting for a counter
+typedef struct
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} mftJobCondition;
+
+static mfError mftInitJobCondition(mftJobCondition* condition)
+{
+	if (pthread_mutex_init(&condition->mutex, NULL) != 0)
+		return MFT_ERROR_INTERNAL;
+	if (pthread_cond_init(&condition->cond, NULL) != 0)
+	{
+		pthread_mutex_destroy(&condition->mutex);
+		return MFT_ERROR_INTERNAL;
+	}
+	return MF_ERROR_OKAY;
+}
+
+static void mftDeinitJobCondition(mftJobCondition* condition)
+{
+	pthread_cond_destroy(&condition->cond);
+	pthread_mutex_destroy(&condition->mutex);
+}
+
+static void mftLockJobCondition(mftJobCondition* condition)
+{
+	pthread_mutex_lock(&condition->mutex);
+}
+
+static void mftUnlockJobCondition(mftJobCondition* condition)
+{
+	pthread_mutex_unlock(&condition->mutex);
+}
+
+static void mftJobConditionWait(mftJobCondition* condition)
+{
+	pthread_cond_wait(&condition->cond, &condition->mutex);
+}
+
+static void mftJobConditionBroadcast(mftJobCondition* condition)
+{
+	pthread_cond_broadcast(&condition->cond);
+}
+
+static void mftJobYield(void)
+{
+	sched_yield();
+}
+
+static mfmU32 mftGetProcessorCount(void)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count < 1 ? 1 : (mfmU32)count;
+}
+
+#else
+#error No magma framework thread library support
+#endif
+
+#define MFT_JOB_CACHE_LINE_SIZE 64
+#define MFT_JOB_ALIGN_UP(x) (((x) + MFT_JOB_CACHE_LINE_SIZE - 1) & ~((mfmU64)MFT_JOB_CACHE_LINE_SIZE - 1))
+
+// Jobs are referenced by their index plus one, so that 0 can be used as the null reference
+#define MFT_JOB_NULL 0
+
+/*
+	The atomic operations used in this file only fail on NULL arguments, which can't happen here, so their error codes are ignored.
+*/
+
+typedef struct
+{
+	mftJobFunction function;
+	void* args;
+	mftJobCounter* counter;
+
+	// Counters which still have to be checked before the job is queued, dependency holds the single one of mftSubmitJobAfter
+	mftJobCounter* const* dependencies;
+	mftJobCounter* dependency;
+	mfmU32 dependencyCount;
+
+	// Next job in the free list, injection queue or counter waiting list
+	volatile mfmI32 next;
+} mftJob;
+
+typedef struct
+{
+	// Top and bottom are written by different threads, so they're kept on different cache lines
+	volatile mfmI64 top;
+	mfmU8 topPadding[MFT_JOB_CACHE_LINE_SIZE - sizeof(mfmI64)];
+	volatile mfmI64 bottom;
+	mfmU8 bottomPadding[MFT_JOB_CACHE_LINE_SIZE - sizeof(mfmI64)];
+
+	volatile mfmI32* buffer;
+	mftJobSystem* system;
+	mftThread* thread;
+	mfmU32 index;
+	mfmU32 random;
+} mftJobWorker;
+
+struct mftJobSystem
+{
+	mfmObject object;
+	void* allocator;
+
+	mftJobWorker* workers;
+	mfmU64 workerStride;
+	mfmU32 workerCount;
+	mfmI64 queueMask;
+
+	mftJob* jobs;
+
+	// Free job list head, the high 32 bits are a tag incremented on every change to prevent ABA problems
+	volatile mfmI64 freeJobs;
+
+	// Queue for the jobs submitted from outside the workers
+	mftMutex* injectionMutex;
+	mfmI32 injectionHead;
+	mfmI32 injectionTail;
+	volatile mfmI32 injectionCount;
+
+	mftJobSemaphore semaphore;
+	volatile mfmI32 sleepingCount;
+	volatile mfmI32 quit;
+
+	// Threads outside the job system waiting for a counter sleep here until a counter reaches zero
+	mftJobCondition completion;
+	volatile mfmI32 externalWaiterCount;
+};
+
+static MFT_JOB_THREAD_LOCAL mftJobWorker* mftCurrentJobWorker = NULL;
+
+static mftJobWorker* mftGetJobWorker(mftJobSystem* jobSystem, mfmU32 index)
+{
+	return (mftJobWorker*)((mfmU8*)jobSystem->workers + jobSystem->workerStride * index);
+}
+
+static mftJobWorker* mftGetCurrentJobWorker(mftJobSystem* jobSystem)
+{
+	mftJobWorker* worker = mftCurrentJobWorker;
+	if (worker != NULL && worker->system == jobSystem)
+		return worker;
+	return NULL;
+}
+
+static mfmI32 mftAllocateJob(mftJobSystem* jobSystem)
+{
+	mfmI64 head;
+	mftAtomic64Load(&jobSystem->freeJobs, &head);
+	for (;;)
+	{
+		mfmI32 job = (mfmI32)(head & 0xFFFFFFFF);
+		if (job == MFT_JOB_NULL)
+			return MFT_JOB_NULL;
+
+		// The next field may be overwritten if another thread takes this job first, but then the tag changes and the exchange fails
+		mfmI32 next;
+		mftAtomic32Load(&jobSystem->jobs[job - 1].next, &next);
+		mfmI64 newHead = (mfmI64)(((((mfmU64)head >> 32) + 1) << 32) | (mfmU32)next);
+		mfmBool exchanged;
+		mftAtomic64CompareExchange(&jobSystem->freeJobs, &head, newHead, &exchanged);
+		if (exchanged != MFM_FALSE)
+			return job;
+	}
+}
+
+static void mftFreeJob(mftJobSystem* jobSystem, mfmI32 job)
+{
+	mfmI64 head;
+	mftAtomic64Load(&jobSystem->freeJobs, &head);
+	for (;;)
+	{
+		mftAtomic32Store(&jobSystem->jobs[job - 1].next, (mfmI32)(head & 0xFFFFFFFF));
+		mfmI64 newHead = (mfmI64)(((((mfmU64)head >> 32) + 1) << 32) | (mfmU32)job);
+		mfmBool exchanged;
+		mftAtomic64CompareExchange(&jobSystem->freeJobs, &head, newHead, &exchanged);
+		if (exchanged != MFM_FALSE)
+			return;
+	}
+}
+
+static mfmBool mftPushJob(mftJobWorker* worker, mfmI32 job)
+{
+	mfmI64 bottom, top;
+	mftAtomic64Load(&worker->bottom, &bottom);
+	mftAtomic64Load(&worker->top, &top);
+	if (bottom - top > worker->system->queueMask)
+		return MFM_FALSE;
+	mftAtomic32Store(&worker->buffer[bottom & worker->system->queueMask], job);
+	mftAtomic64Store(&worker->bottom, bottom + 1);
+	return MFM_TRUE;
+}
+
+static mfmI32 mftPopJob(mftJobWorker* worker)
+{
+	mfmI64 bottom, top;
+	mftAtomic64Load(&worker->bottom, &bottom);
+	bottom -= 1;
+	mftAtomic64Store(&worker->bottom, bottom);
+	mftAtomic64Load(&worker->top, &top);
+
+	if (top > bottom)
+	{
+		// Empty
+		mftAtomic64Store(&worker->bottom, bottom + 1);
+		return MFT_JOB_NULL;
+	}
+
+	mfmI32 job;
+	mftAtomic32Load(&worker->buffer[bottom & worker->system->queueMask], &job);
+	if (top == bottom)
+	{
+		// Last job, race against the thieves for it
+		mfmBool exchanged;
+		mftAtomic64CompareExchange(&worker->top, &top, top + 1, &exchanged);
+		if (exchanged == MFM_FALSE)
+			job = MFT_JOB_NULL;
+		mftAtomic64Store(&worker->bottom, bottom + 1);
+	}
+
+	return job;
+}
+
+static mfmI32 mftStealJob(mftJobWorker* worker)
+{
+	mfmI64 top, bottom;
+	mftAtomic64Load(&worker->top, &top);
+	mftAtomic64Load(&worker->bottom, &bottom);
+	if (top >= bottom)
+		return MFT_JOB_NULL;
+
+	mfmI32 job;
+	mftAtomic32Load(&worker->buffer[top & worker->system->queueMask], &job);
+	mfmBool exchanged;
+	mftAtomic64CompareExchange(&worker->top, &top, top + 1, &exchanged);
+	if (exchanged == MFM_FALSE)
+		return MFT_JOB_NULL;
+	return job;
+}
+
+static void mftInjectJobs(mftJobSystem* jobSystem, mfmI32 first, mfmI32 last, mfmI32 count)
+{
+	if (mftLockMutex(jobSystem->injectionMutex, 0) != MF_ERROR_OKAY)
+		abort();
+	mftAtomic32Store(&jobSystem->jobs[last - 1].next, MFT_JOB_NULL);
+	if (jobSystem->injectionTail == MFT_JOB_NULL)
+		jobSystem->injectionHead = first;
+	else
+		mftAtomic32Store(&jobSystem->jobs[jobSystem->injectionTail - 1].next, first);
+	jobSystem->injectionTail = last;
+	mftAtomic32Add(&jobSystem->injectionCount, count);
+	if (mftUnlockMutex(jobSystem->injectionMutex) != MF_ERROR_OKAY)
+		abort();
+}
+
+static mfmI32 mftTakeInjectedJob(mftJobSystem* jobSystem)
+{
+	// Avoid locking the mutex when the queue is empty
+	mfmI32 count;
+	mftAtomic32Load(&jobSystem->injectionCount, &count);
+	if (count == 0)
+		return MFT_JOB_NULL;
+
+	if (mftLockMutex(jobSystem->injectionMutex, 0) != MF_ERROR_OKAY)
+		abort();
+	mfmI32 job = jobSystem->injectionHead;
+	if (job != MFT_JOB_NULL)
+	{
+		mftAtomic32Load(&jobSystem->jobs[job - 1].next, &jobSystem->injectionHead);
+		if (jobSystem->injectionHead == MFT_JOB_NULL)
+			jobSystem->injectionTail = MFT_JOB_NULL;
+		mftAtomic32Add(&jobSystem->injectionCount, -1);
+	}
+	if (mftUnlockMutex(jobSystem->injectionMutex) != MF_ERROR_OKAY)
+		abort();
+	return job;
+}
+
+static void mftWakeJobWorkers(mftJobSystem* jobSystem, mfmU64 jobCount)
+{
+	mfmI32 sleeping;
+	mftAtomic32Load(&jobSystem->sleepingCount, &sleeping);
+	if (sleeping <= 0)
+		return;
+	if (jobCount < (mfmU64)sleeping)
+		sleeping = (mfmI32)jobCount;
+	mftJobSemaphorePost(&jobSystem->semaphore, (mfmU32)sleeping);
+}
+
+// Queues a job which is ready to run, without waking any worker
+static void mftEnqueueJob(mftJobSystem* jobSystem, mfmI32 job)
+{
+	mftJobWorker* worker = mftGetCurrentJobWorker(jobSystem);
+	if (worker == NULL || mftPushJob(worker, job) == MFM_FALSE)
+		mftInjectJobs(jobSystem, job, job, 1);
+}
+
+static mfmI32 mftFindJob(mftJobSystem* jobSystem, mftJobWorker* worker)
+{
+	mfmI32 job = MFT_JOB_NULL;
+	mfmU32 start = 0;
+
+	if (worker != NULL)
+	{
+		job = mftPopJob(worker);
+		if (job != MFT_JOB_NULL)
+			return job;
+
+		// Xorshift, to spread the thieves over the workers
+		worker->random ^= worker->random << 13;
+		worker->random ^= worker->random >> 17;
+		worker->random ^= worker->random << 5;
+		start = worker->random;
+	}
+
+	job = mftTakeInjectedJob(jobSystem);
+	if (job != MFT_JOB_NULL)
+		return job;
+
+	for (mfmU32 i = 0; i < jobSystem->workerCount; ++i)
+	{
+		mftJobWorker* victim = mftGetJobWorker(jobSystem, (start + i) % jobSystem->workerCount);
+		if (victim == worker)
+			continue;
+		job = mftStealJob(victim);
+		if (job != MFT_JOB_NULL)
+			return job;
+	}
+
+	return MFT_JOB_NULL;
+}
+
+static void mftLockJobCounter(mftJobCounter* counter)
+{
+	for (;;)
+	{
+		mfmI32 expected = 0;
+		mfmBool exchanged;
+		mftAtomic32CompareExchange(&counter->lock, &expected, 1, &exchanged);
+		if (exchanged != MFM_FALSE)
+			return;
+		mftJobYield();
+	}
+}
+
+static void mftUnlockJobCounter(mftJobCounter* counter)
+{
+	mftAtomic32Store(&counter->lock, 0);
+}
+
+// Queues a job once all of its dependencies are done, returns MFM_FALSE if the job was stored on the waiting list of one of them
+static mfmBool mftQueueJobWhenReady(mftJobSystem* jobSystem, mfmI32 job)
+{
+	mftJob* data = &jobSystem->jobs[job - 1];
+	while (data->dependencyCount != 0)
+	{
+		mftJobCounter* dependency = data->dependencies[0];
+		++data->dependencies;
+		--data->dependencyCount;
+
+		// If the dependency isn't done, the job is stored on its waiting list and checked again by the job which finishes it.
+		// The job may be released as soon as the counter is unlocked, so it isn't accessed afterwards
+		mftLockJobCounter(dependency);
+		mfmI32 value;
+		mftAtomic32Load(&dependency->value, &value);
+		if (value != 0)
+		{
+			mftAtomic32Store(&data->next, dependency->waitingJobs);
+			dependency->waitingJobs = job;
+			mftUnlockJobCounter(dependency);
+			return MFM_FALSE;
+		}
+		mftUnlockJobCounter(dependency);
+	}
+
+	mftEnqueueJob(jobSystem, job);
+	return MFM_TRUE;
+}
+
+static mfmBool mftIsJobCounterDone(mftJobCounter* counter)
+{
+	// The counter is only done once the job which finished it has released its lock
+	mfmI32 value, lock;
+	mftAtomic32Load(&counter->value, &value);
+	if (value != 0)
+		return MFM_FALSE;
+	mftAtomic32Load(&counter->lock, &lock);
+	return lock == 0 ? MFM_TRUE : MFM_FALSE;
+}
+
+static void mftFinishJob(mftJobSystem* jobSystem, mftJobCounter* counter)
+{
+	// The counter is only unlocked after it has been decremented and its waiting jobs taken, and waiters also wait for the lock
+	// to be released, so the counter is never accessed after its owner has stopped waiting on it
+	mftLockJobCounter(counter);
+	mfmI32 old;
+	mftAtomic32FetchAdd(&counter->value, -1, &old);
+	mfmI32 waiting = MFT_JOB_NULL;
+	if (old == 1)
+	{
+		waiting = counter->waitingJobs;
+		counter->waitingJobs = MFT_JOB_NULL;
+	}
+	mftUnlockJobCounter(counter);
+
+	// Wake the threads outside the job system waiting on a counter. The waiters announce themselves before checking the
+	// counter, so either they see it done or this sees them waiting
+	if (old == 1)
+	{
+		mfmI32 waiters;
+		mftAtomic32Load(&jobSystem->externalWaiterCount, &waiters);
+		if (waiters != 0)
+		{
+			mftLockJobCondition(&jobSystem->completion);
+			mftJobConditionBroadcast(&jobSystem->completion);
+			mftUnlockJobCondition(&jobSystem->completion);
+		}
+	}
+
+	// Release the jobs which were waiting for the counter, they're only queued if their remaining dependencies are done too
+	mfmU64 released = 0;
+	while (waiting != MFT_JOB_NULL)
+	{
+		mfmI32 next;
+		mftAtomic32Load(&jobSystem->jobs[waiting - 1].next, &next);
+		if (mftQueueJobWhenReady(jobSystem, waiting) != MFM_FALSE)
+			++released;
+		waiting = next;
+	}
+	if (released != 0)
+		mftWakeJobWorkers(jobSystem, released);
+}
+
+static void mftRunJob(mftJobSystem* jobSystem, mfmI32 job)
+{
+	// The job is freed before running so that it can be reused by the jobs it submits
+	mftJobFunction function = jobSystem->jobs[job - 1].function;
+	void* args = jobSystem->jobs[job - 1].args;
+	mftJobCounter* counter = jobSystem->jobs[job - 1].counter;
+	mftFreeJob(jobSystem, job);
+	function(args);
+	if (counter != NULL)
+		mftFinishJob(jobSystem, counter);
+}
+
+static mfmI32 mftAllocateJobHelping(mftJobSystem* jobSystem, mftJobFunction function, void* args, mftJobCounter* counter)
+{
+	mftJobWorker* worker = mftGetCurrentJobWorker(jobSystem);
+	mfmI32 job;
+	for (;;)
+	{
+		job = mftAllocateJob(jobSystem);
+		if (job != MFT_JOB_NULL)
+			break;
+
+		// No free jobs, run one to free some
+		mfmI32 other = mftFindJob(jobSystem, worker);
+		if (other != MFT_JOB_NULL)
+			mftRunJob(jobSystem, other);
+		else
+			mftJobYield();
+	}
+
+	jobSystem->jobs[job - 1].function = function;
+	jobSystem->jobs[job - 1].args = args;
+	jobSystem->jobs[job - 1].counter = counter;
+	jobSystem->jobs[job - 1].dependencies = NULL;
+	jobSystem->jobs[job - 1].dependencyCount = 0;
+	return job;
+}
+
+static void mftJobWorkerFunction(void* args)
+{
+	mftJobWorker* worker = (mftJobWorker*)args;
+	mftJobSystem* jobSystem = worker->system;
+	mftCurrentJobWorker = worker;
+
+	for (;;)
+	{
+		mfmI32 job = mftFindJob(jobSystem, worker);
+		if (job != MFT_JOB_NULL)
+		{
+			mftRunJob(jobSystem, job);
+			continue;
+		}
+
+		// Announce that this worker is going to sleep and check again, so that a job submitted meanwhile is either found
+		// here or its submitter sees this worker sleeping and wakes it
+		mftAtomic32Add(&jobSystem->sleepingCount, 1);
+		job = mftFindJob(jobSystem, worker);
+		if (job != MFT_JOB_NULL)
+		{
+			mftAtomic32Add(&jobSystem->sleepingCount, -1);
+			mftRunJob(jobSystem, job);
+			continue;
+		}
+
+		mfmI32 quit;
+		mftAtomic32Load(&jobSystem->quit, &quit);
+		if (quit != 0)
+		{
+			mftAtomic32Add(&jobSystem->sleepingCount, -1);
+			break;
+		}
+
+		mftJobSemaphoreWait(&jobSystem->semaphore);
+		mftAtomic32Add(&jobSystem->sleepingCount, -1);
+	}
+
+	mftCurrentJobWorker = NULL;
+}
+
+static void mftDestroyJobSystemNoErrors(void* jobSystem)
+{
+	if (jobSystem == NULL)
+		abort();
+	mfError err = mftDestroyJobSystem((mftJobSystem*)jobSystem);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+static void mftStopJobWorkers(mftJobSystem* jobSystem, mfmU32 count)
+{
+	mftAtomic32Store(&jobSystem->quit, 1);
+	mftJobSemaphorePost(&jobSystem->semaphore, count);
+	for (mfmU32 i = 0; i < count; ++i)
+	{
+		mftJobWorker* worker = mftGetJobWorker(jobSystem, i);
+		if (mftWaitForThread(worker->thread, 0) != MF_ERROR_OKAY ||
+			mftDestroyThread(worker->thread) != MF_ERROR_OKAY)
+			abort();
+	}
+}
+
+mfError mftCreateJobSystem(mftJobSystem ** jobSystem, const mftJobSystemDesc * desc, void * allocator)
+{
+	if (jobSystem == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	mfmU32 workerCount = desc == NULL ? 0 : desc->workerCount;
+	mfmU32 queueSize = (desc == NULL || desc->queueSize == 0) ? MFT_JOB_SYSTEM_DEFAULT_QUEUE_SIZE : desc->queueSize;
+	mfmU32 jobCapacity = (desc == NULL || desc->jobCapacity == 0) ? MFT_JOB_SYSTEM_DEFAULT_JOB_CAPACITY : desc->jobCapacity;
+
+	if ((queueSize & (queueSize - 1)) != 0 || jobCapacity > 0x7FFFFFFF)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	if (workerCount == 0)
+	{
+		workerCount = mftGetProcessorCount();
+		if (workerCount > 1)
+			workerCount -= 1;
+	}
+
+	// Everything is allocated on a single cache line aligned block:
+	// system | workers | worker deques | jobs
+	mfmU64 workerStride = MFT_JOB_ALIGN_UP(sizeof(mftJobWorker));
+	mfmU64 workersOffset = MFT_JOB_ALIGN_UP(sizeof(mftJobSystem));
+	mfmU64 buffersOffset = workersOffset + workerStride * workerCount;
+	mfmU64 jobsOffset = MFT_JOB_ALIGN_UP(buffersOffset + sizeof(mfmI32) * (mfmU64)queueSize * workerCount);
+	mfmU64 size = jobsOffset + sizeof(mftJob) * (mfmU64)jobCapacity;
+
+	mfmU8* memory = NULL;
+	mfError err = mfmAllocateAligned(allocator, (void**)&memory, size, MFT_JOB_CACHE_LINE_SIZE);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	mftJobSystem* js = (mftJobSystem*)memory;
+	err = mfmInitObject(&js->object);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeallocateAligned(allocator, memory);
+		return err;
+	}
+
+	js->object.destructorFunc = &mftDestroyJobSystemNoErrors;
+	js->allocator = allocator;
+	js->workers = (mftJobWorker*)(memory + workersOffset);
+	js->workerStride = workerStride;
+	js->workerCount = workerCount;
+	js->queueMask = (mfmI64)queueSize - 1;
+	js->jobs = (mftJob*)(memory + jobsOffset);
+	js->injectionHead = MFT_JOB_NULL;
+	js->injectionTail = MFT_JOB_NULL;
+	js->injectionCount = 0;
+	js->sleepingCount = 0;
+	js->quit = 0;
+	js->externalWaiterCount = 0;
+
+	// Link all jobs into the free list
+	for (mfmU32 i = 0; i < jobCapacity; ++i)
+	{
+		js->jobs[i].function = NULL;
+		js->jobs[i].args = NULL;
+		js->jobs[i].counter = NULL;
+		js->jobs[i].dependencies = NULL;
+		js->jobs[i].dependency = NULL;
+		js->jobs[i].dependencyCount = 0;
+		js->jobs[i].next = (i + 1 < jobCapacity) ? (mfmI32)(i + 2) : MFT_JOB_NULL;
+	}
+	js->freeJobs = jobCapacity == 0 ? MFT_JOB_NULL : 1;
+
+	err = mftCreateMutex(&js->injectionMutex, allocator);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeinitObject(&js->object);
+		mfmDeallocateAligned(allocator, memory);
+		return err;
+	}
+
+	err = mftInitJobSemaphore(&js->semaphore);
+	if (err != MF_ERROR_OKAY)
+	{
+		mftDestroyMutex(js->injectionMutex);
+		mfmDeinitObject(&js->object);
+		mfmDeallocateAligned(allocator, memory);
+		return err;
+	}
+
+	err = mftInitJobCondition(&js->completion);
+	if (err != MF_ERROR_OKAY)
+	{
+		mftDeinitJobSemaphore(&js->semaphore);
+		mftDestroyMutex(js->injectionMutex);
+		mfmDeinitObject(&js->object);
+		mfmDeallocateAligned(allocator, memory);
+		return err;
+	}
+
+	for (mfmU32 i = 0; i < workerCount; ++i)
+	{
+		mftJobWorker* worker = mftGetJobWorker(js, i);
+		worker->top = 0;
+		worker->bottom = 0;
+		worker->buffer = (volatile mfmI32*)(memory + buffersOffset) + (mfmU64)queueSize * i;
+		worker->system = js;
+		worker->thread = NULL;
+		worker->index = i;
+		worker->random = 0x9E3779B9u * (i + 1);
+	}
+
+	for (mfmU32 i = 0; i < workerCount; ++i)
+	{
+		mftJobWorker* worker = mftGetJobWorker(js, i);
+		err = mftCreateThread(&worker->thread, &mftJobWorkerFunction, worker, allocator);
+		if (err != MF_ERROR_OKAY)
+		{
+			mftStopJobWorkers(js, i);
+			mftDeinitJobCondition(&js->completion);
+			mftDeinitJobSemaphore(&js->semaphore);
+			mftDestroyMutex(js->injectionMutex);
+			mfmDeinitObject(&js->object);
+			mfmDeallocateAligned(allocator, memory);
+			return err;
+		}
+	}
+
+	*jobSystem = js;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftDestroyJobSystem(mftJobSystem * jobSystem)
+{
+	if (jobSystem == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	mftStopJobWorkers(jobSystem, jobSystem->workerCount);
+	mftDeinitJobCondition(&jobSystem->completion);
+	mftDeinitJobSemaphore(&jobSystem->semaphore);
+
+	mfError err = mftDestroyMutex(jobSystem->injectionMutex);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mfmDeinitObject(&jobSystem->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	return mfmDeallocateAligned(jobSystem->allocator, jobSystem);
+}
+
+mfmU32 mftGetJobSystemWorkerCount(mftJobSystem * jobSystem)
+{
+	return jobSystem->workerCount;
+}
+
+void mftInitJobCounter(mftJobCounter * counter)
+{
+	counter->value = 0;
+	counter->lock = 0;
+	counter->waitingJobs = MFT_JOB_NULL;
+}
+
+mfError mftSubmitJob(mftJobSystem * jobSystem, mftJobFunction function, void * args, mftJobCounter * counter)
+{
+	if (jobSystem == NULL || function == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	if (counter != NULL)
+		mftAtomic32Add(&counter->value, 1);
+	mfmI32 job = mftAllocateJobHelping(jobSystem, function, args, counter);
+	mftEnqueueJob(jobSystem, job);
+	mftWakeJobWorkers(jobSystem, 1);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftSubmitJobAfter(mftJobSystem * jobSystem, mftJobFunction function, void * args, mftJobCounter * dependency, mftJobCounter * counter)
+{
+	if (jobSystem == NULL || function == NULL || dependency == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	if (counter != NULL)
+		mftAtomic32Add(&counter->value, 1);
+	mfmI32 job = mftAllocateJobHelping(jobSystem, function, args, counter);
+	jobSystem->jobs[job - 1].dependency = dependency;
+	jobSystem->jobs[job - 1].dependencies = &jobSystem->jobs[job - 1].dependency;
+	jobSystem->jobs[job - 1].dependencyCount = 1;
+
+	if (mftQueueJobWhenReady(jobSystem, job) != MFM_FALSE)
+		mftWakeJobWorkers(jobSystem, 1);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftSubmitJobAfterAll(mftJobSystem * jobSystem, mftJobFunction function, void * args, mftJobCounter * const * dependencies, mfmU32 dependencyCount, mftJobCounter * counter)
+{
+	if (jobSystem == NULL || function == NULL || (dependencies == NULL && dependencyCount != 0))
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	for (mfmU32 i = 0; i < dependencyCount; ++i)
+		if (dependencies[i] == NULL)
+			return MFT_ERROR_INVALID_ARGUMENTS;
+
+	if (counter != NULL)
+		mftAtomic32Add(&counter->value, 1);
+	mfmI32 job = mftAllocateJobHelping(jobSystem, function, args, counter);
+	jobSystem->jobs[job - 1].dependencies = dependencies;
+	jobSystem->jobs[job - 1].dependencyCount = dependencyCount;
+
+	if (mftQueueJobWhenReady(jobSystem, job) != MFM_FALSE)
+		mftWakeJobWorkers(jobSystem, 1);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftSubmitJobBatch(mftJobSystem * jobSystem, mftJobFunction function, void * args, mfmU64 argsStride, mfmU64 count, mftJobCounter * counter)
+{
+	if (jobSystem == NULL || function == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	if (count == 0)
+		return MF_ERROR_OKAY;
+
+	if (counter != NULL)
+		mftAtomic32Add(&counter->value, (mfmI32)count);
+
+	mftJobWorker* worker = mftGetCurrentJobWorker(jobSystem);
+	mfmI32 first = MFT_JOB_NULL, last = MFT_JOB_NULL, injected = 0;
+	mfmI64 freeJobs;
+	for (mfmU64 i = 0; i < count; ++i)
+	{
+		// Jobs held back for injection must be made visible before waiting for free jobs, as they may be the ones to run
+		if (first != MFT_JOB_NULL && mftAtomic64Load(&jobSystem->freeJobs, &freeJobs) == MF_ERROR_OKAY && (freeJobs & 0xFFFFFFFF) == MFT_JOB_NULL)
+		{
+			mftInjectJobs(jobSystem, first, last, injected);
+			mftWakeJobWorkers(jobSystem, injected);
+			first = last = MFT_JOB_NULL;
+			injected = 0;
+		}
+
+		mfmI32 job = mftAllocateJobHelping(jobSystem, function, (mfmU8*)args + i * argsStride, counter);
+		if (worker != NULL && mftPushJob(worker, job) != MFM_FALSE)
+			continue;
+
+		// Jobs which don't fit on the worker's deque are injected with a single lock
+		if (first == MFT_JOB_NULL)
+			first = job;
+		else
+			mftAtomic32Store(&jobSystem->jobs[last - 1].next, job);
+		last = job;
+		++injected;
+
+		// Don't hold too many jobs back, as the pool may run out while they aren't visible to the workers
+		if (injected == 64)
+		{
+			mftInjectJobs(jobSystem, first, last, injected);
+			mftWakeJobWorkers(jobSystem, injected);
+			first = last = MFT_JOB_NULL;
+			injected = 0;
+		}
+	}
+
+	if (first != MFT_JOB_NULL)
+		mftInjectJobs(jobSystem, first, last, injected);
+	mftWakeJobWorkers(jobSystem, count);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftWaitForJobCounter(mftJobSystem * jobSystem, mftJobCounter * counter)
+{
+	if (jobSystem == NULL || counter == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	mftJobWorker* worker = mftGetCurrentJobWorker(jobSystem);
+	for (;;)
+	{
+		if (mftIsJobCounterDone(counter) != MFM_FALSE)
+			return MF_ERROR_OKAY;
+
+		mfmI32 job = mftFindJob(jobSystem, worker);
+		if (job != MFT_JOB_NULL)
+		{
+			mftRunJob(jobSystem, job);
+			continue;
+		}
+
+		// Workers keep looking for jobs, as the ones the counter waits on may be queued on them
+		if (worker != NULL)
+		{
+			mftJobYield();
+			continue;
+		}
+
+		// Other threads sleep until some counter reaches zero, and then look for jobs again
+		mftAtomic32Add(&jobSystem->externalWaiterCount, 1);
+		mftLockJobCondition(&jobSystem->completion);
+		if (mftIsJobCounterDone(counter) == MFM_FALSE)
+			mftJobConditionWait(&jobSystem->completion);
+		mftUnlockJobCondition(&jobSystem->completion);
+		mftAtomic32Add(&jobSystem->externalWaiterCount, -1);
+	}
+}
@@ -0,0 +1,57 @@
+#include "JobSystem.hpp"
+#include "Exception.hpp"
+#include "../ErrorString.h"
+
+void Magma::Framework::Thread::HJobSystem::Submit(mftJobFunction function, void * args, JobCounter * counter)
+{
+	mfError err = mftSubmitJob(&this->Get(), function, args, counter == nullptr ? NULL : counter->Get());
+	if (err != MF_ERROR_OKAY)
+		throw JobSystemError(mfErrorToString(err));
+}
+
+void Magma::Framework::Thread::HJobSystem::SubmitAfter(mftJobFunction function, void * args, JobCounter & dependency, JobCounter * counter)
+{
+	mfError err = mftSubmitJobAfter(&this->Get(), function, args, dependency.Get(), counter == nullptr ? NULL : counter->Get());
+	if (err != MF_ERROR_OKAY)
+		throw JobSystemError(mfErrorToString(err));
+}
+
+void Magma::Framework::Thread::HJobSystem::SubmitAfterAll(mftJobFunction function, void * args, mftJobCounter * const * dependencies, mfmU32 dependencyCount, JobCounter * counter)
+{
+	mfError err = mftSubmitJobAfterAll(&this->Get(), function, args, dependencies, dependencyCount, counter == nullptr ? NULL : counter->Get());
+	if (err != MF_ERROR_OKAY)
+		throw JobSystemError(mfErrorToString(err));
+}
+
+void Magma::Framework::Thread::HJobSystem::SubmitBatch(mftJobFunction function, void * args, mfmU64 argsStride, mfmU64 count, JobCounter * counter)
+{
+	mfError err = mftSubmitJobBatch(&this->Get(), function, args, argsStride, count, counter == nullptr ? NULL : counter->Get());
+	if (err != MF_ERROR_OKAY)
+		throw JobSystemError(mfErrorToString(err));
+}
+
+void Magma::Framework::Thread::HJobSystem::Wait(JobCounter & counter)
+{
+	mfError err = mftWaitForJobCounter(&this->Get(), counter.Get());
+	if (err != MF_ERROR_OKAY)
+		throw JobSystemError(mfErrorToString(err));
+}
+
+mfmU32 Magma::Framework::Thread::HJobSystem::GetWorkerCount()
+{
+	return mftGetJobSystemWorkerCount(&this->Get());
+}
+
+Magma::Framework::Thread::HJobSystem Magma::Framework::Thread::CreateJobSystem(mfmU32 workerCount, Memory::HAllocator allocator)
+{
+	mftJobSystemDesc desc;
+	desc.workerCount = workerCount;
+	desc.queueSize = 0;
+	desc.jobCapacity = 0;
+
+	mftJobSystem* jobSystem = NULL;
+	mfError err = mftCreateJobSystem(&jobSystem, &desc, allocator.GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw JobSystemError(mfErrorToString(err));
+	return jobSystem;
+}
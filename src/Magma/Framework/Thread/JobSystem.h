@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Error.h"
+
+/*
+	Work stealing job system.
+	Each worker thread owns a lock-free deque (Chase-Lev) where it pushes the jobs it submits and pops them in LIFO order.
+	Idle workers steal the oldest jobs from the other workers' deques, and jobs submitted from threads which aren't workers go to a shared queue.
+	Job completion is tracked with counters, which can also be used as dependencies: a job submitted with mftSubmitJobAfter or mftSubmitJobAfterAll
+	is only queued once its dependency counters reach zero, so it never occupies a worker while it can't run.
+	Waiting on a counter runs other jobs, and threads which aren't workers sleep once there are no jobs left to run instead of spinning.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MFT_JOB_SYSTEM_DEFAULT_QUEUE_SIZE 1024
+#define MFT_JOB_SYSTEM_DEFAULT_JOB_CAPACITY 4096
+
+	// Is an mfmObject
+	typedef struct mftJobSystem mftJobSystem;
+
+	typedef void(*mftJobFunction)(void* args);
+
+	/// <summary>
+	///		Counts the unfinished jobs submitted with it.
+	///		Must be initialized with mftInitJobCounter and must outlive the jobs submitted with it.
+	/// </summary>
+	typedef struct
+	{
+		volatile mfmI32 value;
+		volatile mfmI32 lock;
+		volatile mfmI32 waitingJobs;
+	} mftJobCounter;
+
+	typedef struct
+	{
+		/// <summary>
+		///		Number of worker threads (set to 0 to use one less than the number of processors, and at least one).
+		/// </summary>
+		mfmU32 workerCount;
+
+		/// <summary>
+		///		Size of each worker's job deque (must be a power of two, set to 0 to use MFT_JOB_SYSTEM_DEFAULT_QUEUE_SIZE).
+		/// </summary>
+		mfmU32 queueSize;
+
+		/// <summary>
+		///		Maximum number of jobs waiting or running at once (set to 0 to use MFT_JOB_SYSTEM_DEFAULT_JOB_CAPACITY).
+		///		When there are no free jobs, submitting runs queued jobs until one is freed.
+		/// </summary>
+		mfmU32 jobCapacity;
+	} mftJobSystemDesc;
+
+	/// <summary>
+	///		Creates a new job system and starts its worker threads.
+	/// </summary>
+	/// <param name="jobSystem">Out job system handle</param>
+	/// <param name="desc">Job system description (set to NULL to use the default values)</param>
+	/// <param name="allocator">Allocator where the job system will be allocated</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if jobSystem is NULL or the queue size isn't a power of two.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftCreateJobSystem(mftJobSystem** jobSystem, const mftJobSystemDesc* desc, void* allocator);
+
+	/// <summary>
+	///		Destroys a job system, waiting for its worker threads to finish.
+	///		All the jobs submitted must have finished before calling this function.
+	/// </summary>
+	/// <param name="jobSystem">Job system handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftDestroyJobSystem(mftJobSystem* jobSystem);
+
+	/// <summary>
+	///		Gets the number of worker threads of a job system.
+	/// </summary>
+	/// <param name="jobSystem">Job system handle</param>
+	/// <returns>Worker count</returns>
+	mfmU32 mftGetJobSystemWorkerCount(mftJobSystem* jobSystem);
+
+	/// <summary>
+	///		Initializes a job counter to zero.
+	/// </summary>
+	/// <param name="counter">Job counter</param>
+	void mftInitJobCounter(mftJobCounter* counter);
+
+	/// <summary>
+	///		Submits a job.
+	/// </summary>
+	/// <param name="jobSystem">Job system handle</param>
+	/// <param name="function">Job function</param>
+	/// <param name="args">Job function arguments</param>
+	/// <param name="counter">Counter incremented now and decremented when the job finishes (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if jobSystem or function are NULL.
+	/// </returns>
+	mfError mftSubmitJob(mftJobSystem* jobSystem, mftJobFunction function, void* args, mftJobCounter* counter);
+
+	/// <summary>
+	///		Submits a job which only runs after every job submitted with a dependency counter has finished.
+	/// </summary>
+	/// <param name="jobSystem">Job system handle</param>
+	/// <param name="function">Job function</param>
+	/// <param name="args">Job function arguments</param>
+	/// <param name="dependency">Counter which must reach zero before the job runs</param>
+	/// <param name="counter">Counter incremented now and decremented when the job finishes (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if jobSystem, function or dependency are NULL.
+	/// </returns>
+	mfError mftSubmitJobAfter(mftJobSystem* jobSystem, mftJobFunction function, void* args, mftJobCounter* dependency, mftJobCounter* counter);
+
+	/// <summary>
+	///		Submits a job which only runs after every job submitted with each of the dependency counters has finished.
+	///		The dependencies array must stay valid until the job starts running.
+	/// </summary>
+	/// <param name="jobSystem">Job system handle</param>
+	/// <param name="function">Job function</param>
+	/// <param name="args">Job function arguments</param>
+	/// <param name="dependencies">Counters which must reach zero before the job runs</param>
+	/// <param name="dependencyCount">Number of dependency counters (may be 0)</param>
+	/// <param name="counter">Counter incremented now and decremented when the job finishes (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if jobSystem or function are NULL, or if any dependency is NULL.
+	/// </returns>
+	mfError mftSubmitJobAfterAll(mftJobSystem* jobSystem, mftJobFunction function, void* args, mftJobCounter* const* dependencies, mfmU32 dependencyCount, mftJobCounter* counter);
+
+	/// <summary>
+	///		Submits a batch of jobs running the same function on different arguments.
+	///		The job i is called with (mfmU8*)args + i * argsStride.
+	/// </summary>
+	/// <param name="jobSystem">Job system handle</param>
+	/// <param name="function">Job function</param>
+	/// <param name="args">Pointer to the first job's arguments</param>
+	/// <param name="argsStride">Distance in bytes between each job's arguments</param>
+	/// <param name="count">Number of jobs</param>
+	/// <param name="counter">Counter incremented now by count and decremented when each job finishes (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if jobSystem or function are NULL.
+	/// </returns>
+	mfError mftSubmitJobBatch(mftJobSystem* jobSystem, mftJobFunction function, void* args, mfmU64 argsStride, mfmU64 count, mftJobCounter* counter);
+
+	/// <summary>
+	///		Waits until a counter reaches zero, running queued jobs in the meantime.
+	///		Threads which aren't workers of the job system sleep when there are no jobs left to run.
+	///		May be called from inside a job.
+	/// </summary>
+	/// <param name="jobSystem">Job system handle</param>
+	/// <param name="counter">Job counter</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if jobSystem or counter are NULL.
+	/// </returns>
+	mfError mftWaitForJobCounter(mftJobSystem* jobSystem, mftJobCounter* counter);
+
+#ifdef __cplusplus
+}
+#endif
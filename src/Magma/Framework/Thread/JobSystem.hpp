@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../Memory/Handle.hpp"
+#include "../Memory/Allocator.hpp"
+#include "JobSystem.h"
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace Thread
+		{
+			/// <summary>
+			///		Counts the unfinished jobs submitted with it.
+			///		Must outlive the jobs submitted with it.
+			/// </summary>
+			class JobCounter
+			{
+			public:
+				inline JobCounter() { mftInitJobCounter(&m_counter); }
+				JobCounter(const JobCounter&) = delete;
+				JobCounter& operator=(const JobCounter&) = delete;
+
+				/// <summary>
+				///		Gets the underlying C job counter.
+				/// </summary>
+				inline mftJobCounter* Get() { return &m_counter; }
+
+			private:
+				mftJobCounter m_counter;
+			};
+
+			/// <summary>
+			///		Job system handle.
+			/// </summary>
+			class HJobSystem : public Memory::TypedHandle<mftJobSystem>
+			{
+			public:
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				explicit inline HJobSystem(const Memory::Handle& object) : TypedHandle(object) {}
+
+				/// <summary>
+				///		Submits a job.
+				/// </summary>
+				/// <param name="function">Job function</param>
+				/// <param name="args">Job function arguments</param>
+				/// <param name="counter">Counter tracking the job (optional)</param>
+				void Submit(mftJobFunction function, void* args, JobCounter* counter = nullptr);
+
+				/// <summary>
+				///		Submits a job which only runs after all the jobs tracked by a dependency counter have finished.
+				/// </summary>
+				/// <param name="function">Job function</param>
+				/// <param name="args">Job function arguments</param>
+				/// <param name="dependency">Counter which must reach zero before the job runs</param>
+				/// <param name="counter">Counter tracking the job (optional)</param>
+				void SubmitAfter(mftJobFunction function, void* args, JobCounter& dependency, JobCounter* counter = nullptr);
+
+				/// <summary>
+				///		Submits a job which only runs after all the jobs tracked by every dependency counter have finished.
+				///		The dependencies array must stay valid until the job starts running.
+				/// </summary>
+				/// <param name="function">Job function</param>
+				/// <param name="args">Job function arguments</param>
+				/// <param name="dependencies">Counters which must reach zero before the job runs</param>
+				/// <param name="dependencyCount">Number of dependency counters</param>
+				/// <param name="counter">Counter tracking the job (optional)</param>
+				void SubmitAfterAll(mftJobFunction function, void* args, mftJobCounter* const* dependencies, mfmU32 dependencyCount, JobCounter* counter = nullptr);
+
+				/// <summary>
+				///		Submits a batch of jobs, the job i is called with (mfmU8*)args + i * argsStride.
+				/// </summary>
+				/// <param name="function">Job function</param>
+				/// <param name="args">Pointer to the first job's arguments</param>
+				/// <param name="argsStride">Distance in bytes between each job's arguments</param>
+				/// <param name="count">Number of jobs</param>
+				/// <param name="counter">Counter tracking the jobs (optional)</param>
+				void SubmitBatch(mftJobFunction function, void* args, mfmU64 argsStride, mfmU64 count, JobCounter* counter = nullptr);
+
+				/// <summary>
+				///		Waits until a counter reaches zero, running queued jobs in the meantime.
+				///		Threads which aren't workers sleep when there are no jobs left to run.
+				/// </summary>
+				/// <param name="counter">Job counter</param>
+				void Wait(JobCounter& counter);
+
+				/// <summary>
+				///		Gets the number of worker threads.
+				/// </summary>
+				/// <returns>Worker count</returns>
+				mfmU32 GetWorkerCount();
+			};
+
+			/// <summary>
+			///		Creates a job system.
+			/// </summary>
+			/// <param name="workerCount">Number of worker threads (set to 0 to use one less than the number of processors)</param>
+			/// <param name="allocator">Allocator used to allocate the job system</param>
+			/// <returns>Job system handle</returns>
+			HJobSystem CreateJobSystem(mfmU32 workerCount = 0, Memory::HAllocator allocator = Memory::StandardAllocator);
+		}
+	}
+}
@@ -117,6 +117,156 @@ mfError mftUnlockMutex(mftMutex * mutex)
 	return MF_ERROR_OKAY;
 }
 
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct mftMutex
+{
+	mfmObject object;
+	void* allocator;
+	pthread_mutex_t handle;
+};
+
+static void mftDestroyMutexNoErrors(void* mutex)
+{
+	if (mutex == NULL)
+		abort();
+	mfError err = mftDestroyMutex((mftMutex*)mutex);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mftCreateMutex(mftMutex ** mutex, void * allocator)
+{
+	if (mutex == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	mfError err = mfmAllocate(allocator, mutex, sizeof(mftMutex));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	err = mfmInitObject(&(*mutex)->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	(*mutex)->object.destructorFunc = &mftDestroyMutexNoErrors;
+	(*mutex)->allocator = allocator;
+
+	// Windows mutexes can be locked recursively by the thread which owns them, so these must too
+	pthread_mutexattr_t attr;
+	if (pthread_mutexattr_init(&attr) != 0)
+	{
+		mfmDeallocate(allocator, *mutex);
+		return MFT_ERROR_INTERNAL;
+	}
+	int ret = pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	if (ret == 0)
+		ret = pthread_mutex_init(&(*mutex)->handle, &attr);
+	pthread_mutexattr_destroy(&attr);
+	if (ret != 0)
+	{
+		mfmDeallocate(allocator, *mutex);
+		return MFT_ERROR_INTERNAL;
+	}
+	return MF_ERROR_OKAY;
+}
+
+mfError mftDestroyMutex(mftMutex * mutex)
+{
+	if (mutex == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	mfError err;
+
+	// Destroy mutex handle
+	if (pthread_mutex_destroy(&mutex->handle) != 0)
+		return MFT_ERROR_INTERNAL;
+
+	// Destroy and deallocate mutex
+	err = mfmDeinitObject(&mutex->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mfmDeallocate(mutex->allocator, mutex);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftLockMutex(mftMutex * mutex, mfmU32 timeOut)
+{
+	if (mutex == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	int ret;
+	if (timeOut == 0)
+		ret = pthread_mutex_lock(&mutex->handle);
+	else
+	{
+#if defined(_POSIX_TIMEOUTS) && _POSIX_TIMEOUTS > 0
+		// Get the absolute time when the wait times out
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += timeOut / 1000;
+		deadline.tv_nsec += (long)(timeOut % 1000) * 1000000;
+		if (deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000;
+		}
+		ret = pthread_mutex_timedlock(&mutex->handle, &deadline);
+#else
+		// No timed lock, poll the mutex every millisecond
+		ret = pthread_mutex_trylock(&mutex->handle);
+		for (mfmU32 i = 0; ret == EBUSY && i < timeOut; ++i)
+		{
+			usleep(1000);
+			ret = pthread_mutex_trylock(&mutex->handle);
+		}
+		if (ret == EBUSY)
+			ret = ETIMEDOUT;
+#endif
+	}
+
+	switch (ret)
+	{
+		case 0:
+			return MF_ERROR_OKAY;
+		case ETIMEDOUT:
+			return MFT_ERROR_TIMEOUT;
+		default:
+			return MFT_ERROR_INTERNAL;
+	}
+}
+
+mfError mftTryLockMutex(mftMutex * mutex)
+{
+	if (mutex == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	switch (pthread_mutex_trylock(&mutex->handle))
+	{
+		case 0:
+			return MF_ERROR_OKAY;
+		case EBUSY:
+			return MFT_ERROR_MUTEX_LOCKED;
+		default:
+			return MFT_ERROR_INTERNAL;
+	}
+}
+
+mfError mftUnlockMutex(mftMutex * mutex)
+{
+	if (mutex == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	if (pthread_mutex_unlock(&mutex->handle) != 0)
+		return MFT_ERROR_INTERNAL;
+	return MF_ERROR_OKAY;
+}
+
 #else
 #error No magma framework thread library support
 #endif
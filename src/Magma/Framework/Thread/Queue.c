@@ -0,0 +1,575 @@
+#include "Queue.h"
+#include "Atomic.h"
+#include "Config.h"
+
+#include "../Memory/Object.h"
+#include "../Memory/Allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+
+#include <Windows.h>
+
+static void mftQueueYield(void)
+{
+	SwitchToThread();
+}
+
+static void mftQueueSleep(void)
+{
+	Sleep(1);
+}
+
+static mfmU64 mftQueueGetMilliseconds(void)
+{
+	return (mfmU64)GetTickCount64();
+}
+
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+#include <sched.h>
+#include <time.h>
+
+static void mftQueueYield(void)
+{
+	sched_yield();
+}
+
+static void mftQueueSleep(void)
+{
+	struct timespec duration;
+	duration.tv_sec = 0;
+	duration.tv_nsec = 1000000;
+	nanosleep(&duration, NULL);
+}
+
+static mfmU64 mftQueueGetMilliseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (mfmU64)now.tv_sec * 1000 + (mfmU64)now.tv_nsec / 1000000;
+}
+
+#else
+#error No magma framework thread library support
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define MFT_QUEUE_PAUSE() _mm_pause()
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define MFT_QUEUE_PAUSE() __builtin_ia32_pause()
+#else
+#define MFT_QUEUE_PAUSE() ((void)0)
+#endif
+
+#define MFT_QUEUE_CACHE_LINE_SIZE 64
+#define MFT_QUEUE_SPIN_COUNT 64
+#define MFT_QUEUE_YIELD_COUNT 256
+
+/*
+	The atomic operations used in this file only fail on NULL arguments, which can't happen here, so their error codes are ignored.
+*/
+
+typedef struct
+{
+	mfmU32 iteration;
+	mfmU64 start;
+} mftQueueBackoff;
+
+// Waits a bit before retrying an operation on a full or empty queue, returns MFM_FALSE if the timeout has passed
+static mfmBool mftQueueBackoffWait(mftQueueBackoff* backoff, mfmU32 timeOut)
+{
+	if (backoff->iteration < MFT_QUEUE_SPIN_COUNT)
+	{
+		++backoff->iteration;
+		MFT_QUEUE_PAUSE();
+		return MFM_TRUE;
+	}
+
+	if (timeOut != 0)
+	{
+		mfmU64 now = mftQueueGetMilliseconds();
+		if (backoff->iteration == MFT_QUEUE_SPIN_COUNT)
+			backoff->start = now;
+		else if (now - backoff->start >= timeOut)
+			return MFM_FALSE;
+	}
+
+	if (backoff->iteration < MFT_QUEUE_SPIN_COUNT + MFT_QUEUE_YIELD_COUNT)
+	{
+		++backoff->iteration;
+		mftQueueYield();
+	}
+	else
+		mftQueueSleep();
+	return MFM_TRUE;
+}
+
+struct mftSPSCQueue
+{
+	mfmObject object;
+	void* allocator;
+	mfmU8* buffer;
+	mfmU64 elementSize;
+	mfmI64 mask;
+	mfmU8 headerPadding[MFT_QUEUE_CACHE_LINE_SIZE];
+
+	// Producer side: the tail and the last head seen by the producer, so it doesn't read the consumer's line on every push
+	volatile mfmI64 tail;
+	mfmI64 cachedHead;
+	mfmU8 tailPadding[MFT_QUEUE_CACHE_LINE_SIZE];
+
+	// Consumer side
+	volatile mfmI64 head;
+	mfmI64 cachedTail;
+	mfmU8 headPadding[MFT_QUEUE_CACHE_LINE_SIZE];
+};
+
+typedef struct
+{
+	volatile mfmI64 sequence;
+} mftMPMCQueueCell;
+
+struct mftMPMCQueue
+{
+	mfmObject object;
+	void* allocator;
+	mfmU8* cells;
+	mfmU64 cellStride;
+	mfmU64 elementSize;
+	mfmI64 mask;
+	mfmU8 headerPadding[MFT_QUEUE_CACHE_LINE_SIZE];
+
+	volatile mfmI64 enqueuePosition;
+	mfmU8 enqueuePadding[MFT_QUEUE_CACHE_LINE_SIZE];
+
+	volatile mfmI64 dequeuePosition;
+	mfmU8 dequeuePadding[MFT_QUEUE_CACHE_LINE_SIZE];
+};
+
+static void mftDestroySPSCQueueNoErrors(void* queue)
+{
+	if (queue == NULL)
+		abort();
+	mfError err = mftDestroySPSCQueue((mftSPSCQueue*)queue);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+static void mftDestroyMPMCQueueNoErrors(void* queue)
+{
+	if (queue == NULL)
+		abort();
+	mfError err = mftDestroyMPMCQueue((mftMPMCQueue*)queue);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mftCreateSPSCQueue(mftSPSCQueue ** queue, mfmU64 elementSize, mfmU64 capacity, void * allocator)
+{
+	if (queue == NULL || elementSize == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	mfmU64 bufferOffset = (sizeof(mftSPSCQueue) + MFT_QUEUE_CACHE_LINE_SIZE - 1) & ~((mfmU64)MFT_QUEUE_CACHE_LINE_SIZE - 1);
+	mfmU8* memory = NULL;
+	mfError err = mfmAllocateAligned(allocator, (void**)&memory, bufferOffset + elementSize * capacity, MFT_QUEUE_CACHE_LINE_SIZE);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	mftSPSCQueue* q = (mftSPSCQueue*)memory;
+	err = mfmInitObject(&q->object);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeallocateAligned(allocator, memory);
+		return err;
+	}
+
+	q->object.destructorFunc = &mftDestroySPSCQueueNoErrors;
+	q->allocator = allocator;
+	q->buffer = memory + bufferOffset;
+	q->elementSize = elementSize;
+	q->mask = (mfmI64)capacity - 1;
+	q->tail = 0;
+	q->cachedHead = 0;
+	q->head = 0;
+	q->cachedTail = 0;
+
+	*queue = q;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftDestroySPSCQueue(mftSPSCQueue * queue)
+{
+	if (queue == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	mfError err = mfmDeinitObject(&queue->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	return mfmDeallocateAligned(queue->allocator, queue);
+}
+
+mfError mftTryPushSPSCQueue(mftSPSCQueue * queue, const void * element)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (queue == NULL || element == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+
+	// Only the producer writes the tail, so it can be read directly
+	mfmI64 tail = queue->tail;
+	if (tail - queue->cachedHead > queue->mask)
+	{
+		mftAtomic64LoadAcquire(&queue->head, &queue->cachedHead);
+		if (tail - queue->cachedHead > queue->mask)
+			return MFT_ERROR_QUEUE_FULL;
+	}
+
+	memcpy(queue->buffer + (mfmU64)(tail & queue->mask) * queue->elementSize, element, queue->elementSize);
+	mftAtomic64StoreRelease(&queue->tail, tail + 1);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftTryPopSPSCQueue(mftSPSCQueue * queue, void * element)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (queue == NULL || element == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+
+	mfmI64 head = queue->head;
+	if (head == queue->cachedTail)
+	{
+		mftAtomic64LoadAcquire(&queue->tail, &queue->cachedTail);
+		if (head == queue->cachedTail)
+			return MFT_ERROR_QUEUE_EMPTY;
+	}
+
+	memcpy(element, queue->buffer + (mfmU64)(head & queue->mask) * queue->elementSize, queue->elementSize);
+	mftAtomic64StoreRelease(&queue->head, head + 1);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftPushSPSCQueue(mftSPSCQueue * queue, const void * element, mfmU32 timeOut)
+{
+	mftQueueBackoff backoff = { 0, 0 };
+	for (;;)
+	{
+		mfError err = mftTryPushSPSCQueue(queue, element);
+		if (err != MFT_ERROR_QUEUE_FULL)
+			return err;
+		if (mftQueueBackoffWait(&backoff, timeOut) == MFM_FALSE)
+			return MFT_ERROR_TIMEOUT;
+	}
+}
+
+mfError mftPopSPSCQueue(mftSPSCQueue * queue, void * element, mfmU32 timeOut)
+{
+	mftQueueBackoff backoff = { 0, 0 };
+	for (;;)
+	{
+		mfError err = mftTryPopSPSCQueue(queue, element);
+		if (err != MFT_ERROR_QUEUE_EMPTY)
+			return err;
+		if (mftQueueBackoffWait(&backoff, timeOut) == MFM_FALSE)
+			return MFT_ERROR_TIMEOUT;
+	}
+}
+
+mfError mftPushSPSCQueueBatch(mftSPSCQueue * queue, const void * elements, mfmU64 count, mfmU64 * pushed)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (queue == NULL || (elements == NULL && count != 0))
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+
+	mfmI64 tail = queue->tail;
+	mfmU64 capacity = (mfmU64)queue->mask + 1;
+	mfmU64 freeCount = capacity - (mfmU64)(tail - queue->cachedHead);
+	if (freeCount < count)
+	{
+		mftAtomic64LoadAcquire(&queue->head, &queue->cachedHead);
+		freeCount = capacity - (mfmU64)(tail - queue->cachedHead);
+	}
+	if (count > freeCount)
+		count = freeCount;
+
+	if (pushed != NULL)
+		*pushed = count;
+	if (count == 0)
+		return MFT_ERROR_QUEUE_FULL;
+
+	// Copy in at most two parts, as the elements may wrap around the end of the buffer
+	mfmU64 start = (mfmU64)(tail & queue->mask);
+	mfmU64 first = capacity - start < count ? capacity - start : count;
+	memcpy(queue->buffer + start * queue->elementSize, elements, first * queue->elementSize);
+	if (first < count)
+		memcpy(queue->buffer, (const mfmU8*)elements + first * queue->elementSize, (count - first) * queue->elementSize);
+
+	mftAtomic64StoreRelease(&queue->tail, tail + (mfmI64)count);
+	return MF_ERROR_OKAY;
+}
+
+mfError mftPopSPSCQueueBatch(mftSPSCQueue * queue, void * elements, mfmU64 maxCount, mfmU64 * popped)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (queue == NULL || (elements == NULL && maxCount != 0))
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+
+	mfmI64 head = queue->head;
+	mfmU64 available = (mfmU64)(queue->cachedTail - head);
+	if (available < maxCount)
+	{
+		mftAtomic64LoadAcquire(&queue->tail, &queue->cachedTail);
+		available = (mfmU64)(queue->cachedTail - head);
+	}
+	mfmU64 count = maxCount < available ? maxCount : available;
+
+	if (popped != NULL)
+		*popped = count;
+	if (count == 0)
+		return MFT_ERROR_QUEUE_EMPTY;
+
+	mfmU64 capacity = (mfmU64)queue->mask + 1;
+	mfmU64 start = (mfmU64)(head & queue->mask);
+	mfmU64 first = capacity - start < count ? capacity - start : count;
+	memcpy(elements, queue->buffer + start * queue->elementSize, first * queue->elementSize);
+	if (first < count)
+		memcpy((mfmU8*)elements + first * queue->elementSize, queue->buffer, (count - first) * queue->elementSize);
+
+	mftAtomic64StoreRelease(&queue->head, head + (mfmI64)count);
+	return MF_ERROR_OKAY;
+}
+
+static mftMPMCQueueCell* mftGetMPMCQueueCell(mftMPMCQueue* queue, mfmI64 position)
+{
+	return (mftMPMCQueueCell*)(queue->cells + (mfmU64)(position & queue->mask) * queue->cellStride);
+}
+
+mfError mftCreateMPMCQueue(mftMPMCQueue ** queue, mfmU64 elementSize, mfmU64 capacity, void * allocator)
+{
+	if (queue == NULL || elementSize == 0 || capacity < 2 || (capacity & (capacity - 1)) != 0)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	// Each cell has its sequence number followed by the element data
+	mfmU64 cellStride = (sizeof(mftMPMCQueueCell) + elementSize + sizeof(mfmI64) - 1) & ~((mfmU64)sizeof(mfmI64) - 1);
+	mfmU64 cellsOffset = (sizeof(mftMPMCQueue) + MFT_QUEUE_CACHE_LINE_SIZE - 1) & ~((mfmU64)MFT_QUEUE_CACHE_LINE_SIZE - 1);
+	mfmU8* memory = NULL;
+	mfError err = mfmAllocateAligned(allocator, (void**)&memory, cellsOffset + cellStride * capacity, MFT_QUEUE_CACHE_LINE_SIZE);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	mftMPMCQueue* q = (mftMPMCQueue*)memory;
+	err = mfmInitObject(&q->object);
+	if (err != MF_ERROR_OKAY)
+	{
+		mfmDeallocateAligned(allocator, memory);
+		return err;
+	}
+
+	q->object.destructorFunc = &mftDestroyMPMCQueueNoErrors;
+	q->allocator = allocator;
+	q->cells = memory + cellsOffset;
+	q->cellStride = cellStride;
+	q->elementSize = elementSize;
+	q->mask = (mfmI64)capacity - 1;
+	q->enqueuePosition = 0;
+	q->dequeuePosition = 0;
+
+	// A cell is free for the producer at position p when its sequence is p, and full for the consumer at position p when it is p + 1
+	for (mfmU64 i = 0; i < capacity; ++i)
+		mftGetMPMCQueueCell(q, (mfmI64)i)->sequence = (mfmI64)i;
+
+	*queue = q;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftDestroyMPMCQueue(mftMPMCQueue * queue)
+{
+	if (queue == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	mfError err = mfmDeinitObject(&queue->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	return mfmDeallocateAligned(queue->allocator, queue);
+}
+
+mfError mftTryPushMPMCQueue(mftMPMCQueue * queue, const void * element)
+{
+	mfmU64 pushed;
+	return mftPushMPMCQueueBatch(queue, element, 1, &pushed);
+}
+
+mfError mftTryPopMPMCQueue(mftMPMCQueue * queue, void * element)
+{
+	mfmU64 popped;
+	return mftPopMPMCQueueBatch(queue, element, 1, &popped);
+}
+
+mfError mftPushMPMCQueue(mftMPMCQueue * queue, const void * element, mfmU32 timeOut)
+{
+	mftQueueBackoff backoff = { 0, 0 };
+	for (;;)
+	{
+		mfError err = mftTryPushMPMCQueue(queue, element);
+		if (err != MFT_ERROR_QUEUE_FULL)
+			return err;
+		if (mftQueueBackoffWait(&backoff, timeOut) == MFM_FALSE)
+			return MFT_ERROR_TIMEOUT;
+	}
+}
+
+mfError mftPopMPMCQueue(mftMPMCQueue * queue, void * element, mfmU32 timeOut)
+{
+	mftQueueBackoff backoff = { 0, 0 };
+	for (;;)
+	{
+		mfError err = mftTryPopMPMCQueue(queue, element);
+		if (err != MFT_ERROR_QUEUE_EMPTY)
+			return err;
+		if (mftQueueBackoffWait(&backoff, timeOut) == MFM_FALSE)
+			return MFT_ERROR_TIMEOUT;
+	}
+}
+
+mfError mftPushMPMCQueueBatch(mftMPMCQueue * queue, const void * elements, mfmU64 count, mfmU64 * pushed)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (queue == NULL || (elements == NULL && count != 0))
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+
+	if (count == 0)
+	{
+		if (pushed != NULL)
+			*pushed = 0;
+		return MFT_ERROR_QUEUE_FULL;
+	}
+	if (count > (mfmU64)queue->mask + 1)
+		count = (mfmU64)queue->mask + 1;
+
+	mfmI64 position;
+	mfmU64 reserved;
+	mftAtomic64LoadAcquire(&queue->enqueuePosition, &position);
+	for (;;)
+	{
+		// Count the free cells starting at the current position
+		reserved = 0;
+		while (reserved < count)
+		{
+			mfmI64 sequence;
+			mftAtomic64LoadAcquire(&mftGetMPMCQueueCell(queue, position + (mfmI64)reserved)->sequence, &sequence);
+			if (sequence != position + (mfmI64)reserved)
+				break;
+			++reserved;
+		}
+
+		if (reserved == 0)
+		{
+			mfmI64 sequence;
+			mftAtomic64LoadAcquire(&mftGetMPMCQueueCell(queue, position)->sequence, &sequence);
+			if (sequence < position)
+			{
+				// The cell still holds an element from the previous lap
+				if (pushed != NULL)
+					*pushed = 0;
+				return MFT_ERROR_QUEUE_FULL;
+			}
+
+			// Another producer has already taken this position
+			mftAtomic64LoadAcquire(&queue->enqueuePosition, &position);
+			continue;
+		}
+
+		// Reserve the cells, on failure the position is updated and the cells are checked again
+		mfmBool exchanged;
+		mftAtomic64CompareExchange(&queue->enqueuePosition, &position, position + (mfmI64)reserved, &exchanged);
+		if (exchanged != MFM_FALSE)
+			break;
+	}
+
+	for (mfmU64 i = 0; i < reserved; ++i)
+	{
+		mftMPMCQueueCell* cell = mftGetMPMCQueueCell(queue, position + (mfmI64)i);
+		memcpy(cell + 1, (const mfmU8*)elements + i * queue->elementSize, queue->elementSize);
+		mftAtomic64StoreRelease(&cell->sequence, position + (mfmI64)i + 1);
+	}
+
+	if (pushed != NULL)
+		*pushed = reserved;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftPopMPMCQueueBatch(mftMPMCQueue * queue, void * elements, mfmU64 maxCount, mfmU64 * popped)
+{
+#if defined(MAGMA_FRAMEWORK_DEBUG)
+	if (queue == NULL || (elements == NULL && maxCount != 0))
+		return MFT_ERROR_INVALID_ARGUMENTS;
+#endif
+
+	if (maxCount == 0)
+	{
+		if (popped != NULL)
+			*popped = 0;
+		return MFT_ERROR_QUEUE_EMPTY;
+	}
+
+	mfmI64 position;
+	mfmU64 reserved;
+	mftAtomic64LoadAcquire(&queue->dequeuePosition, &position);
+	for (;;)
+	{
+		// Count the full cells starting at the current position
+		reserved = 0;
+		while (reserved < maxCount)
+		{
+			mfmI64 sequence;
+			mftAtomic64LoadAcquire(&mftGetMPMCQueueCell(queue, position + (mfmI64)reserved)->sequence, &sequence);
+			if (sequence != position + (mfmI64)reserved + 1)
+				break;
+			++reserved;
+		}
+
+		if (reserved == 0)
+		{
+			mfmI64 sequence;
+			mftAtomic64LoadAcquire(&mftGetMPMCQueueCell(queue, position)->sequence, &sequence);
+			if (sequence < position + 1)
+			{
+				// The cell hasn't been written yet
+				if (popped != NULL)
+					*popped = 0;
+				return MFT_ERROR_QUEUE_EMPTY;
+			}
+
+			// Another consumer has already taken this position
+			mftAtomic64LoadAcquire(&queue->dequeuePosition, &position);
+			continue;
+		}
+
+		mfmBool exchanged;
+		mftAtomic64CompareExchange(&queue->dequeuePosition, &position, position + (mfmI64)reserved, &exchanged);
+		if (exchanged != MFM_FALSE)
+			break;
+	}
+
+	for (mfmU64 i = 0; i < reserved; ++i)
+	{
+		mftMPMCQueueCell* cell = mftGetMPMCQueueCell(queue, position + (mfmI64)i);
+		memcpy((mfmU8*)elements + i * queue->elementSize, cell + 1, queue->elementSize);
+
+		// Free the cell for the producer on the next lap
+		mftAtomic64StoreRelease(&cell->sequence, position + (mfmI64)i + queue->mask + 1);
+	}
+
+	if (popped != NULL)
+		*popped = reserved;
+	return MF_ERROR_OKAY;
+}
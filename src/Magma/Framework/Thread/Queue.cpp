@@ -0,0 +1,137 @@
+#include "Queue.hpp"
+#include "Exception.hpp"
+#include "../ErrorString.h"
+
+bool Magma::Framework::Thread::HSPSCQueue::TryPush(const void * element)
+{
+	mfError err = mftTryPushSPSCQueue(&this->Get(), element);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_QUEUE_FULL)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+bool Magma::Framework::Thread::HSPSCQueue::TryPop(void * element)
+{
+	mfError err = mftTryPopSPSCQueue(&this->Get(), element);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_QUEUE_EMPTY)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+bool Magma::Framework::Thread::HSPSCQueue::Push(const void * element, mfmU32 timeOut)
+{
+	mfError err = mftPushSPSCQueue(&this->Get(), element, timeOut);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_TIMEOUT)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+bool Magma::Framework::Thread::HSPSCQueue::Pop(void * element, mfmU32 timeOut)
+{
+	mfError err = mftPopSPSCQueue(&this->Get(), element, timeOut);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_TIMEOUT)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+mfmU64 Magma::Framework::Thread::HSPSCQueue::PushBatch(const void * elements, mfmU64 count)
+{
+	mfmU64 pushed = 0;
+	mfError err = mftPushSPSCQueueBatch(&this->Get(), elements, count, &pushed);
+	if (err != MF_ERROR_OKAY && err != MFT_ERROR_QUEUE_FULL)
+		throw QueueError(mfErrorToString(err));
+	return pushed;
+}
+
+mfmU64 Magma::Framework::Thread::HSPSCQueue::PopBatch(void * elements, mfmU64 maxCount)
+{
+	mfmU64 popped = 0;
+	mfError err = mftPopSPSCQueueBatch(&this->Get(), elements, maxCount, &popped);
+	if (err != MF_ERROR_OKAY && err != MFT_ERROR_QUEUE_EMPTY)
+		throw QueueError(mfErrorToString(err));
+	return popped;
+}
+
+bool Magma::Framework::Thread::HMPMCQueue::TryPush(const void * element)
+{
+	mfError err = mftTryPushMPMCQueue(&this->Get(), element);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_QUEUE_FULL)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+bool Magma::Framework::Thread::HMPMCQueue::TryPop(void * element)
+{
+	mfError err = mftTryPopMPMCQueue(&this->Get(), element);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_QUEUE_EMPTY)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+bool Magma::Framework::Thread::HMPMCQueue::Push(const void * element, mfmU32 timeOut)
+{
+	mfError err = mftPushMPMCQueue(&this->Get(), element, timeOut);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_TIMEOUT)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+bool Magma::Framework::Thread::HMPMCQueue::Pop(void * element, mfmU32 timeOut)
+{
+	mfError err = mftPopMPMCQueue(&this->Get(), element, timeOut);
+	if (err == MF_ERROR_OKAY)
+		return true;
+	else if (err == MFT_ERROR_TIMEOUT)
+		return false;
+	throw QueueError(mfErrorToString(err));
+}
+
+mfmU64 Magma::Framework::Thread::HMPMCQueue::PushBatch(const void * elements, mfmU64 count)
+{
+	mfmU64 pushed = 0;
+	mfError err = mftPushMPMCQueueBatch(&this->Get(), elements, count, &pushed);
+	if (err != MF_ERROR_OKAY && err != MFT_ERROR_QUEUE_FULL)
+		throw QueueError(mfErrorToString(err));
+	return pushed;
+}
+
+mfmU64 Magma::Framework::Thread::HMPMCQueue::PopBatch(void * elements, mfmU64 maxCount)
+{
+	mfmU64 popped = 0;
+	mfError err = mftPopMPMCQueueBatch(&this->Get(), elements, maxCount, &popped);
+	if (err != MF_ERROR_OKAY && err != MFT_ERROR_QUEUE_EMPTY)
+		throw QueueError(mfErrorToString(err));
+	return popped;
+}
+
+Magma::Framework::Thread::HSPSCQueue Magma::Framework::Thread::CreateSPSCQueue(mfmU64 elementSize, mfmU64 capacity, Memory::HAllocator allocator)
+{
+	mftSPSCQueue* queue = NULL;
+	mfError err = mftCreateSPSCQueue(&queue, elementSize, capacity, allocator.GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw QueueError(mfErrorToString(err));
+	return queue;
+}
+
+Magma::Framework::Thread::HMPMCQueue Magma::Framework::Thread::CreateMPMCQueue(mfmU64 elementSize, mfmU64 capacity, Memory::HAllocator allocator)
+{
+	mftMPMCQueue* queue = NULL;
+	mfError err = mftCreateMPMCQueue(&queue, elementSize, capacity, allocator.GetNoChecks());
+	if (err != MF_ERROR_OKAY)
+		throw QueueError(mfErrorToString(err));
+	return queue;
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "Error.h"
+
+/*
+	Bounded lock-free ring queues for handing data between threads.
+	Elements have a fixed size set on creation and are copied in and out of the queue.
+
+	mftSPSCQueue: single producer, single consumer. Only one thread may push and only one thread may pop at a time.
+	mftMPMCQueue: multiple producers, multiple consumers (each slot has a sequence number, based on Dmitry Vyukov's bounded queue).
+
+	The producer and consumer indices are kept on different cache lines to avoid false sharing.
+	The blocking functions spin for a short time, then yield and finally sleep while the queue stays full or empty.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	// Is an mfmObject
+	typedef struct mftSPSCQueue mftSPSCQueue;
+
+	// Is an mfmObject
+	typedef struct mftMPMCQueue mftMPMCQueue;
+
+	/// <summary>
+	///		Creates a new single producer, single consumer queue.
+	/// </summary>
+	/// <param name="queue">Out queue handle</param>
+	/// <param name="elementSize">Size of each element in bytes</param>
+	/// <param name="capacity">Maximum number of elements in the queue (must be a power of two)</param>
+	/// <param name="allocator">Allocator where the queue will be allocated</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if queue is NULL, elementSize is 0 or capacity isn't a power of two.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftCreateSPSCQueue(mftSPSCQueue** queue, mfmU64 elementSize, mfmU64 capacity, void* allocator);
+
+	/// <summary>
+	///		Destroys a single producer, single consumer queue.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftDestroySPSCQueue(mftSPSCQueue* queue);
+
+	/// <summary>
+	///		Pushes an element into a single producer, single consumer queue, if it isn't full.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer to the element to copy into the queue</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_FULL if the queue is full.
+	/// </returns>
+	mfError mftTryPushSPSCQueue(mftSPSCQueue* queue, const void* element);
+
+	/// <summary>
+	///		Pops an element from a single producer, single consumer queue, if it isn't empty.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer where the element will be copied to</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_EMPTY if the queue is empty.
+	/// </returns>
+	mfError mftTryPopSPSCQueue(mftSPSCQueue* queue, void* element);
+
+	/// <summary>
+	///		Pushes an element into a single producer, single consumer queue, waiting while it is full.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer to the element to copy into the queue</param>
+	/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_TIMEOUT if the queue was still full after the timeout.
+	/// </returns>
+	mfError mftPushSPSCQueue(mftSPSCQueue* queue, const void* element, mfmU32 timeOut);
+
+	/// <summary>
+	///		Pops an element from a single producer, single consumer queue, waiting while it is empty.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer where the element will be copied to</param>
+	/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_TIMEOUT if the queue was still empty after the timeout.
+	/// </returns>
+	mfError mftPopSPSCQueue(mftSPSCQueue* queue, void* element, mfmU32 timeOut);
+
+	/// <summary>
+	///		Pushes as many elements as fit into a single producer, single consumer queue, publishing them all at once.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="elements">Pointer to the elements to copy into the queue</param>
+	/// <param name="count">Number of elements</param>
+	/// <param name="pushed">Out number of elements pushed (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_FULL if no element could be pushed.
+	/// </returns>
+	mfError mftPushSPSCQueueBatch(mftSPSCQueue* queue, const void* elements, mfmU64 count, mfmU64* pushed);
+
+	/// <summary>
+	///		Pops up to maxCount elements from a single producer, single consumer queue at once.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="elements">Pointer where the elements will be copied to</param>
+	/// <param name="maxCount">Maximum number of elements to pop</param>
+	/// <param name="popped">Out number of elements popped (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_EMPTY if no element could be popped.
+	/// </returns>
+	mfError mftPopSPSCQueueBatch(mftSPSCQueue* queue, void* elements, mfmU64 maxCount, mfmU64* popped);
+
+	/// <summary>
+	///		Creates a new multiple producer, multiple consumer queue.
+	/// </summary>
+	/// <param name="queue">Out queue handle</param>
+	/// <param name="elementSize">Size of each element in bytes</param>
+	/// <param name="capacity">Maximum number of elements in the queue (must be a power of two and at least 2)</param>
+	/// <param name="allocator">Allocator where the queue will be allocated</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_INVALID_ARGUMENTS if queue is NULL, elementSize is 0 or capacity isn't a power of two.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftCreateMPMCQueue(mftMPMCQueue** queue, mfmU64 elementSize, mfmU64 capacity, void* allocator);
+
+	/// <summary>
+	///		Destroys a multiple producer, multiple consumer queue.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftDestroyMPMCQueue(mftMPMCQueue* queue);
+
+	/// <summary>
+	///		Pushes an element into a multiple producer, multiple consumer queue, if it isn't full.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer to the element to copy into the queue</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_FULL if the queue is full.
+	/// </returns>
+	mfError mftTryPushMPMCQueue(mftMPMCQueue* queue, const void* element);
+
+	/// <summary>
+	///		Pops an element from a multiple producer, multiple consumer queue, if it isn't empty.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer where the element will be copied to</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_EMPTY if the queue is empty.
+	/// </returns>
+	mfError mftTryPopMPMCQueue(mftMPMCQueue* queue, void* element);
+
+	/// <summary>
+	///		Pushes an element into a multiple producer, multiple consumer queue, waiting while it is full.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer to the element to copy into the queue</param>
+	/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_TIMEOUT if the queue was still full after the timeout.
+	/// </returns>
+	mfError mftPushMPMCQueue(mftMPMCQueue* queue, const void* element, mfmU32 timeOut);
+
+	/// <summary>
+	///		Pops an element from a multiple producer, multiple consumer queue, waiting while it is empty.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="element">Pointer where the element will be copied to</param>
+	/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_TIMEOUT if the queue was still empty after the timeout.
+	/// </returns>
+	mfError mftPopMPMCQueue(mftMPMCQueue* queue, void* element, mfmU32 timeOut);
+
+	/// <summary>
+	///		Pushes as many elements as fit into a multiple producer, multiple consumer queue.
+	///		The elements are reserved with a single atomic operation, so they are stored contiguously in the queue.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="elements">Pointer to the elements to copy into the queue</param>
+	/// <param name="count">Number of elements</param>
+	/// <param name="pushed">Out number of elements pushed (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_FULL if no element could be pushed.
+	/// </returns>
+	mfError mftPushMPMCQueueBatch(mftMPMCQueue* queue, const void* elements, mfmU64 count, mfmU64* pushed);
+
+	/// <summary>
+	///		Pops up to maxCount elements from a multiple producer, multiple consumer queue.
+	///		The elements are reserved with a single atomic operation.
+	/// </summary>
+	/// <param name="queue">Queue handle</param>
+	/// <param name="elements">Pointer where the elements will be copied to</param>
+	/// <param name="maxCount">Maximum number of elements to pop</param>
+	/// <param name="popped">Out number of elements popped (optional, may be NULL)</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Returns MFT_ERROR_QUEUE_EMPTY if no element could be popped.
+	/// </returns>
+	mfError mftPopMPMCQueueBatch(mftMPMCQueue* queue, void* elements, mfmU64 maxCount, mfmU64* popped);
+
+#ifdef __cplusplus
+}
+#endif
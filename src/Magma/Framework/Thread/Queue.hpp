@@ -0,0 +1,146 @@
+#pragma once
+
+#include "../Memory/Handle.hpp"
+#include "../Memory/Allocator.hpp"
+#include "Queue.h"
+
+namespace Magma
+{
+	namespace Framework
+	{
+		namespace Thread
+		{
+			/// <summary>
+			///		Single producer, single consumer queue handle.
+			/// </summary>
+			class HSPSCQueue : public Memory::TypedHandle<mftSPSCQueue>
+			{
+			public:
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				explicit inline HSPSCQueue(const Memory::Handle& object) : TypedHandle(object) {}
+
+				/// <summary>
+				///		Pushes an element if the queue isn't full.
+				/// </summary>
+				/// <param name="element">Pointer to the element to copy into the queue</param>
+				/// <returns>True if the element was pushed, otherwise false (queue full)</returns>
+				bool TryPush(const void* element);
+
+				/// <summary>
+				///		Pops an element if the queue isn't empty.
+				/// </summary>
+				/// <param name="element">Pointer where the element will be copied to</param>
+				/// <returns>True if an element was popped, otherwise false (queue empty)</returns>
+				bool TryPop(void* element);
+
+				/// <summary>
+				///		Pushes an element, waiting while the queue is full.
+				/// </summary>
+				/// <param name="element">Pointer to the element to copy into the queue</param>
+				/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+				/// <returns>True if the element was pushed, otherwise false (timeout expired)</returns>
+				bool Push(const void* element, mfmU32 timeOut = 0);
+
+				/// <summary>
+				///		Pops an element, waiting while the queue is empty.
+				/// </summary>
+				/// <param name="element">Pointer where the element will be copied to</param>
+				/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+				/// <returns>True if an element was popped, otherwise false (timeout expired)</returns>
+				bool Pop(void* element, mfmU32 timeOut = 0);
+
+				/// <summary>
+				///		Pushes as many elements as fit.
+				/// </summary>
+				/// <param name="elements">Pointer to the elements to copy into the queue</param>
+				/// <param name="count">Number of elements</param>
+				/// <returns>Number of elements pushed</returns>
+				mfmU64 PushBatch(const void* elements, mfmU64 count);
+
+				/// <summary>
+				///		Pops up to maxCount elements.
+				/// </summary>
+				/// <param name="elements">Pointer where the elements will be copied to</param>
+				/// <param name="maxCount">Maximum number of elements to pop</param>
+				/// <returns>Number of elements popped</returns>
+				mfmU64 PopBatch(void* elements, mfmU64 maxCount);
+			};
+
+			/// <summary>
+			///		Multiple producer, multiple consumer queue handle.
+			/// </summary>
+			class HMPMCQueue : public Memory::TypedHandle<mftMPMCQueue>
+			{
+			public:
+				using TypedHandle::TypedHandle;
+				using TypedHandle::operator=;
+				explicit inline HMPMCQueue(const Memory::Handle& object) : TypedHandle(object) {}
+
+				/// <summary>
+				///		Pushes an element if the queue isn't full.
+				/// </summary>
+				/// <param name="element">Pointer to the element to copy into the queue</param>
+				/// <returns>True if the element was pushed, otherwise false (queue full)</returns>
+				bool TryPush(const void* element);
+
+				/// <summary>
+				///		Pops an element if the queue isn't empty.
+				/// </summary>
+				/// <param name="element">Pointer where the element will be copied to</param>
+				/// <returns>True if an element was popped, otherwise false (queue empty)</returns>
+				bool TryPop(void* element);
+
+				/// <summary>
+				///		Pushes an element, waiting while the queue is full.
+				/// </summary>
+				/// <param name="element">Pointer to the element to copy into the queue</param>
+				/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+				/// <returns>True if the element was pushed, otherwise false (timeout expired)</returns>
+				bool Push(const void* element, mfmU32 timeOut = 0);
+
+				/// <summary>
+				///		Pops an element, waiting while the queue is empty.
+				/// </summary>
+				/// <param name="element">Pointer where the element will be copied to</param>
+				/// <param name="timeOut">Wait timeout in milliseconds (set to 0 to be infinite)</param>
+				/// <returns>True if an element was popped, otherwise false (timeout expired)</returns>
+				bool Pop(void* element, mfmU32 timeOut = 0);
+
+				/// <summary>
+				///		Pushes as many elements as fit.
+				/// </summary>
+				/// <param name="elements">Pointer to the elements to copy into the queue</param>
+				/// <param name="count">Number of elements</param>
+				/// <returns>Number of elements pushed</returns>
+				mfmU64 PushBatch(const void* elements, mfmU64 count);
+
+				/// <summary>
+				///		Pops up to maxCount elements.
+				/// </summary>
+				/// <param name="elements">Pointer where the elements will be copied to</param>
+				/// <param name="maxCount">Maximum number of elements to pop</param>
+				/// <returns>Number of elements popped</returns>
+				mfmU64 PopBatch(void* elements, mfmU64 maxCount);
+			};
+
+			/// <summary>
+			///		Creates a single producer, single consumer queue.
+			/// </summary>
+			/// <param name="elementSize">Size of each element in bytes</param>
+			/// <param name="capacity">Maximum number of elements (must be a power of two)</param>
+			/// <param name="allocator">Allocator used to allocate the queue</param>
+			/// <returns>Queue handle</returns>
+			HSPSCQueue CreateSPSCQueue(mfmU64 elementSize, mfmU64 capacity, Memory::HAllocator allocator = Memory::StandardAllocator);
+
+			/// <summary>
+			///		Creates a multiple producer, multiple consumer queue.
+			/// </summary>
+			/// <param name="elementSize">Size of each element in bytes</param>
+			/// <param name="capacity">Maximum number of elements (must be a power of two and at least 2)</param>
+			/// <param name="allocator">Allocator used to allocate the queue</param>
+			/// <returns>Queue handle</returns>
+			HMPMCQueue CreateMPMCQueue(mfmU64 elementSize, mfmU64 capacity, Memory::HAllocator allocator = Memory::StandardAllocator);
+		}
+	}
+}
@@ -0,0 +1,148 @@
+#include "RWLock.h"
+#include "Config.h"
+
+#include "../Memory/Object.h"
+#include "../Memory/Allocator.h"
+
+#include <stdlib.h>
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+
+#include <Windows.h>
+
+struct mftRWLock
+{
+	mfmObject object;
+	void* allocator;
+	SRWLOCK handle;
+};
+
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+#include <pthread.h>
+
+struct mftRWLock
+{
+	mfmObject object;
+	void* allocator;
+	pthread_rwlock_t handle;
+};
+
+#else
+#error No magma framework thread library support
+#endif
+
+static void mftDestroyRWLockNoErrors(void* lock)
+{
+	if (lock == NULL)
+		abort();
+	mfError err = mftDestroyRWLock((mftRWLock*)lock);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mftCreateRWLock(mftRWLock ** lock, void * allocator)
+{
+	if (lock == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	mfError err = mfmAllocate(allocator, lock, sizeof(mftRWLock));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	err = mfmInitObject(&(*lock)->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	(*lock)->object.destructorFunc = &mftDestroyRWLockNoErrors;
+	(*lock)->allocator = allocator;
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+	InitializeSRWLock(&(*lock)->handle);
+#else
+	if (pthread_rwlock_init(&(*lock)->handle, NULL) != 0)
+	{
+		mfmDeallocate(allocator, *lock);
+		return MFT_ERROR_INTERNAL;
+	}
+#endif
+
+	return MF_ERROR_OKAY;
+}
+
+mfError mftDestroyRWLock(mftRWLock * lock)
+{
+	if (lock == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	mfError err;
+
+	// Slim reader-writer locks don't need to be destroyed
+#if defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+	if (pthread_rwlock_destroy(&lock->handle) != 0)
+		return MFT_ERROR_INTERNAL;
+#endif
+
+	// Destroy and deallocate lock
+	err = mfmDeinitObject(&lock->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mfmDeallocate(lock->allocator, lock);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftLockRead(mftRWLock * lock)
+{
+	if (lock == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+	AcquireSRWLockShared(&lock->handle);
+#else
+	if (pthread_rwlock_rdlock(&lock->handle) != 0)
+		return MFT_ERROR_INTERNAL;
+#endif
+	return MF_ERROR_OKAY;
+}
+
+mfError mftUnlockRead(mftRWLock * lock)
+{
+	if (lock == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+	ReleaseSRWLockShared(&lock->handle);
+#else
+	if (pthread_rwlock_unlock(&lock->handle) != 0)
+		return MFT_ERROR_INTERNAL;
+#endif
+	return MF_ERROR_OKAY;
+}
+
+mfError mftLockWrite(mftRWLock * lock)
+{
+	if (lock == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+	AcquireSRWLockExclusive(&lock->handle);
+#else
+	if (pthread_rwlock_wrlock(&lock->handle) != 0)
+		return MFT_ERROR_INTERNAL;
+#endif
+	return MF_ERROR_OKAY;
+}
+
+mfError mftUnlockWrite(mftRWLock * lock)
+{
+	if (lock == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+#if defined(MAGMA_FRAMEWORK_USE_WINDOWS_THREADS)
+	ReleaseSRWLockExclusive(&lock->handle);
+#else
+	if (pthread_rwlock_unlock(&lock->handle) != 0)
+		return MFT_ERROR_INTERNAL;
+#endif
+	return MF_ERROR_OKAY;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Error.h"
+
+/*
+	Reader-writer lock functions.
+	Any number of readers can hold the lock at the same time, while writers hold it alone.
+	Unlike mutexes, these locks can't be locked recursively.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	// Is an mfmObject
+	typedef struct mftRWLock mftRWLock;
+
+	/// <summary>
+	///		Creates a new reader-writer lock.
+	/// </summary>
+	/// <param name="lock">Out lock handle</param>
+	/// <param name="allocator">AllocatorHandle where the lock will be allocated</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftCreateRWLock(mftRWLock** lock, void* allocator);
+
+	/// <summary>
+	///		Destroys a previously created reader-writer lock (the lock must have been unlocked before calling this function).
+	/// </summary>
+	/// <param name="lock">Lock handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftDestroyRWLock(mftRWLock* lock);
+
+	/// <summary>
+	///		Locks a reader-writer lock for reading (waits while a writer holds it).
+	/// </summary>
+	/// <param name="lock">Lock handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftLockRead(mftRWLock* lock);
+
+	/// <summary>
+	///		Unlocks a reader-writer lock locked by mftLockRead.
+	/// </summary>
+	/// <param name="lock">Lock handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftUnlockRead(mftRWLock* lock);
+
+	/// <summary>
+	///		Locks a reader-writer lock for writing (waits while any reader or writer holds it).
+	/// </summary>
+	/// <param name="lock">Lock handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftLockWrite(mftRWLock* lock);
+
+	/// <summary>
+	///		Unlocks a reader-writer lock locked by mftLockWrite.
+	/// </summary>
+	/// <param name="lock">Lock handle</param>
+	/// <returns>
+	///		Returns MF_ERROR_OKAY if there were no errors.
+	///		Otherwise returns an error code.
+	/// </returns>
+	mfError mftUnlockWrite(mftRWLock* lock);
+
+#ifdef __cplusplus
+}
+#endif
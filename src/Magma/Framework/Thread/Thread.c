@@ -112,6 +112,186 @@ mfError mftWaitForThread(mftThread * thread, mfmU32 timeOut)
 		return MF_ERROR_OKAY;
 }
 
+#elif defined(MAGMA_FRAMEWORK_USE_POSIX_THREADS)
+
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#include <stdlib.h>
+
+struct mftThread
+{
+	mfmObject object;
+	pthread_t handle;
+	void* allocator;
+	void* args;
+	void(*function)(void*);
+
+	// pthread_join has no timeout, so the thread signals when it finishes
+	pthread_mutex_t stateMutex;
+	pthread_cond_t finishedCond;
+	mfmBool finished;
+	mfmBool joined;
+
+	volatile mfmBool running;
+};
+
+static void* mftThreadFunc(void* args)
+{
+	mftThread* thread = (mftThread*)args;
+	thread->function(thread->args);
+	if (mftAtomic8Store(&thread->running, MFM_FALSE) != MF_ERROR_OKAY)
+		abort();
+
+	pthread_mutex_lock(&thread->stateMutex);
+	thread->finished = MFM_TRUE;
+	pthread_cond_broadcast(&thread->finishedCond);
+	pthread_mutex_unlock(&thread->stateMutex);
+	return NULL;
+}
+
+static void mftDestroyThreadNoErrors(void* thread)
+{
+	if (thread == NULL)
+		abort();
+	mfError err = mftDestroyThread((mftThread*)thread);
+	if (err != MF_ERROR_OKAY)
+		abort();
+}
+
+mfError mftCreateThread(mftThread ** thread, void(*function)(void*), void* args, void* allocator)
+{
+	if (thread == NULL || function == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	mfError err = mfmAllocate(allocator, thread, sizeof(mftThread));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	err = mfmInitObject(&(*thread)->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	(*thread)->object.destructorFunc = &mftDestroyThreadNoErrors;
+	(*thread)->allocator = allocator;
+	(*thread)->args = args;
+	(*thread)->function = function;
+	(*thread)->finished = MFM_FALSE;
+	(*thread)->joined = MFM_FALSE;
+
+	// Marked as running before starting, so the thread can't be destroyed before it begins
+	(*thread)->running = MFM_TRUE;
+
+	if (pthread_mutex_init(&(*thread)->stateMutex, NULL) != 0)
+	{
+		mfmDeallocate(allocator, *thread);
+		return MFT_ERROR_INTERNAL;
+	}
+
+	if (pthread_cond_init(&(*thread)->finishedCond, NULL) != 0)
+	{
+		pthread_mutex_destroy(&(*thread)->stateMutex);
+		mfmDeallocate(allocator, *thread);
+		return MFT_ERROR_INTERNAL;
+	}
+
+	if (pthread_create(&(*thread)->handle, NULL, &mftThreadFunc, *thread) != 0)
+	{
+		pthread_cond_destroy(&(*thread)->finishedCond);
+		pthread_mutex_destroy(&(*thread)->stateMutex);
+		mfmDeallocate(allocator, *thread);
+		return MFT_ERROR_INTERNAL;
+	}
+
+	return MF_ERROR_OKAY;
+}
+
+mfError mftDestroyThread(mftThread * thread)
+{
+	if (thread == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+	mfError err;
+
+	// Check if the thread is running
+	mfmBool running = MFM_FALSE;
+	err = mftAtomic8Load(&thread->running, &running);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	if (running != MFM_FALSE)
+		return MFT_ERROR_STILL_RUNNING;
+
+	// Release the thread resources (the thread function has already returned or is about to)
+	if (thread->joined == MFM_FALSE)
+	{
+		if (pthread_join(thread->handle, NULL) != 0)
+			return MFT_ERROR_INTERNAL;
+		thread->joined = MFM_TRUE;
+	}
+
+	if (pthread_cond_destroy(&thread->finishedCond) != 0 ||
+		pthread_mutex_destroy(&thread->stateMutex) != 0)
+		return MFT_ERROR_INTERNAL;
+
+	// Destroy and deallocate thread
+	err = mfmDeinitObject(&thread->object);
+	if (err != MF_ERROR_OKAY)
+		return err;
+
+	err = mfmDeallocate(thread->allocator, thread);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	return MF_ERROR_OKAY;
+}
+
+mfError mftWaitForThread(mftThread * thread, mfmU32 timeOut)
+{
+	if (thread == NULL)
+		return MFT_ERROR_INVALID_ARGUMENTS;
+
+	if (pthread_mutex_lock(&thread->stateMutex) != 0)
+		return MFT_ERROR_INTERNAL;
+
+	if (timeOut == 0)
+	{
+		while (thread->finished == MFM_FALSE)
+			if (pthread_cond_wait(&thread->finishedCond, &thread->stateMutex) != 0)
+			{
+				pthread_mutex_unlock(&thread->stateMutex);
+				return MFT_ERROR_INTERNAL;
+			}
+	}
+	else
+	{
+		// Get the absolute time when the wait times out
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += timeOut / 1000;
+		deadline.tv_nsec += (long)(timeOut % 1000) * 1000000;
+		if (deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000;
+		}
+
+		while (thread->finished == MFM_FALSE)
+		{
+			int ret = pthread_cond_timedwait(&thread->finishedCond, &thread->stateMutex, &deadline);
+			if (ret == ETIMEDOUT && thread->finished == MFM_FALSE)
+			{
+				pthread_mutex_unlock(&thread->stateMutex);
+				return MFT_ERROR_TIMEOUT;
+			}
+			else if (ret != 0 && ret != ETIMEDOUT)
+			{
+				pthread_mutex_unlock(&thread->stateMutex);
+				return MFT_ERROR_INTERNAL;
+			}
+		}
+	}
+
+	if (pthread_mutex_unlock(&thread->stateMutex) != 0)
+		return MFT_ERROR_INTERNAL;
+	return MF_ERROR_OKAY;
+}
+
 #else
 #error No magma framework thread library support
 #endif
\ No newline at end of file
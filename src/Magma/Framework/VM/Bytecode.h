@@ -103,6 +103,54 @@ extern "C"
 #define MFV_BYTECODE_THROW_WARNING		0XF0	// Pauses the program execution and throws a warning (null terminated string on stack, with a maximum size of 256 bytes).
 #define MFV_BYTECODE_THROW_ERROR		0xF1	// Halts the program execution and throws an error (null terminated string on stack, with a maximum size of 256 bytes).
 
+	/*
+		MVM Bytecode version 2.0.
+
+		Notes:
+			- Version 2 code starts with the 3 byte header MFV_BYTECODE_V2_HEADER, and may use both the version 1 instructions and
+			  the instructions below, which work directly on the 4 byte registers.
+			- rA, rB and rC are 2 byte register indices, imm is a 4 byte literal and addr is a 4 byte code offset (counted from the
+			  start of the code, header included, where offset 0 is the same as the first instruction's offset). Jumps and calls by
+			  addr are resolved when the code is loaded.
+			- Version 1 code is translated to these instructions when it is loaded, wherever a sequence of stack instructions can be
+			  replaced by one of them (for example, LOAD32, LOAD32, ADDS32 and STORE32 become ADDS32_R). Translated sequences
+			  don't use the stack, so they never overflow it, and count as a single instruction when running.
+
+	*/
+#define MFV_BYTECODE_V2_HEADER			u8"\xFE\x02\x00"
+#define MFV_BYTECODE_V2_HEADER_SIZE		3
+
+	// 4 byte register operations
+#define MFV_BYTECODE_ADDS32_R			0xB0	// rA = rB + rC (4 byte signed integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_SUBS32_R			0xB1	// rA = rB - rC (4 byte signed integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_MULS32_R			0xB2	// rA = rB * rC (4 byte signed integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_DIVS32_R			0xB3	// rA = rB / rC (4 byte signed integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_MODS32_R			0xB4	// rA = rB % rC (4 byte signed integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_ADDU32_R			0xB5	// rA = rB + rC (4 byte unsigned integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_SUBU32_R			0xB6	// rA = rB - rC (4 byte unsigned integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_MULU32_R			0xB7	// rA = rB * rC (4 byte unsigned integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_DIVU32_R			0xB8	// rA = rB / rC (4 byte unsigned integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_MODU32_R			0xB9	// rA = rB % rC (4 byte unsigned integers) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_ADDF32_R			0xBA	// rA = rB + rC (4 byte floating point) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_SUBF32_R			0xBB	// rA = rB - rC (4 byte floating point) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_MULF32_R			0xBC	// rA = rB * rC (4 byte floating point) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_DIVF32_R			0xBD	// rA = rB / rC (4 byte floating point) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_MODF32_R			0xBE	// rA = modulus of rB and rC (4 byte floating point) (rA = param 1, rB = param 2, rC = param 3)
+#define MFV_BYTECODE_MOVE_R				0xC0	// rA = rB (rA = param 1, rB = param 2)
+#define MFV_BYTECODE_SET_R				0xC1	// rA = imm (rA = param 1, imm = param 2)
+#define MFV_BYTECODE_ADDI_R				0xC2	// rA = rB + imm (4 byte integers) (rA = param 1, rB = param 2, imm = param 3)
+
+	// Flow control by address
+#define MFV_BYTECODE_JUMP_TO			0xD0	// Jumps to addr (addr = param 1).
+#define MFV_BYTECODE_CALL_TO			0xD1	// Calls the function at addr (addr = param 1).
+#define MFV_BYTECODE_JUMP_I32_NOT_ZERO_TO	0xD2	// Jumps to addr if the top 4 bytes on the stack, which are popped, aren't zero (integer) (addr = param 1).
+#define MFV_BYTECODE_JUMP_NOT_ZERO_R	0xD3	// Jumps to addr if rA isn't zero (integer) (rA = param 1, addr = param 2).
+#define MFV_BYTECODE_JUMP_EQUAL_R		0xD4	// Jumps to addr if rA == rB (4 byte integers) (rA = param 1, rB = param 2, addr = param 3).
+#define MFV_BYTECODE_JUMP_NOT_EQUAL_R	0xD5	// Jumps to addr if rA != rB (4 byte integers) (rA = param 1, rB = param 2, addr = param 3).
+#define MFV_BYTECODE_JUMP_LESS_S32_R	0xD6	// Jumps to addr if rA < rB (4 byte signed integers) (rA = param 1, rB = param 2, addr = param 3).
+#define MFV_BYTECODE_JUMP_LESS_U32_R	0xD7	// Jumps to addr if rA < rB (4 byte unsigned integers) (rA = param 1, rB = param 2, addr = param 3).
+#define MFV_BYTECODE_JUMP_LESS_F32_R	0xD8	// Jumps to addr if rA < rB (4 byte floating point) (rA = param 1, rB = param 2, addr = param 3).
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,8 @@ extern "C"
 #define MFV_ERROR_UNEXPECTED_EOF			0x0612
 #define MFV_ERROR_INACTIVE_NODE				0x0613
 #define MFV_ERROR_FAILED_TO_PARSE			0x0614
+#define MFV_ERROR_INVALID_ADDRESS			0x0615
+#define MFV_ERROR_INVALID_DIVISION			0x0616
 
 #ifdef __cplusplus
 }
@@ -46,6 +46,10 @@ const mfsUTF8CodeUnit * mfvErrorToString(mfError err)
 			return u8"[MFV_ERROR_INACTIVE_NODE] Inactive node";
 		case MFV_ERROR_FAILED_TO_PARSE:
 			return u8"[MFV_ERROR_FAILED_TO_PARSE] Failed to parse";
+		case MFV_ERROR_INVALID_ADDRESS:
+			return u8"[MFV_ERROR_INVALID_ADDRESS] Code address isn't the start of an instruction";
+		case MFV_ERROR_INVALID_DIVISION:
+			return u8"[MFV_ERROR_INVALID_DIVISION] Integer division by zero or overflow";
 
 
 		default:
@@ -1,19 +1,36 @@
 #include "VirtualMachine.h"
 #include "Config.h"
 #include "../Memory/Allocator.h"
-#include "../Memory/Endianness.h"
 
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
 
+// Marks code offsets which aren't the start of an instruction
+#define MFV_INVALID_ADDRESS 0xFFFFFFFF
+
+// Placed after the last instruction, so that running past the end of the code fails instead of reading out of bounds
+#define MFV_END_OF_CODE 0xFF
+
+// Bytecode is decoded when it is set, into fixed size instructions with aligned, host endian operands
+typedef struct
+{
+	mfmU8 opcode;
+	mfmU8 size; // Number of instructions run by this one, which is bigger than 1 on translated version 1 instruction sequences
+	mfmU16 a, b, c; // Register operands
+	mfmU32 operand; // Literal operand, or the instruction index of the target of jumps and calls by address
+} mfvInstruction;
+
 struct mfvVirtualMachine
 {
 	mfmObject object;
 	mfvVirtualMachineDesc desc;
-	mfvInstructionPointer ip;
+	mfvInstructionPointer ip; // Index of the current decoded instruction
 	void* allocator;
-	const mfmU8* code;
+	mfvInstruction* code;
+	mfmU32* addresses; // Maps code offsets (used by jumps and calls) to decoded instruction indices
+	mfmU64 codeSize;
+	mfmU64 instructionCount; // Number of decoded instructions, not counting the end of code marker
 	mfmU64 stackHead;
 	mfmU64 callStackHead;
 	mfmU8* stack;
@@ -73,6 +90,9 @@ mfError mfvCreateVirtualMachine(mfvVirtualMachine ** vm, const mfvVirtualMachine
 		(*vm)->functionTable[i] = NULL;
 
 	(*vm)->code = NULL;
+	(*vm)->addresses = NULL;
+	(*vm)->codeSize = 0;
+	(*vm)->instructionCount = 0;
 	(*vm)->ip = 0;
 	(*vm)->stackHead = 0;
 	(*vm)->callStackHead = 0;
@@ -85,6 +105,8 @@ void mfvDestroyVirtualMachine(void * vm)
 	if (vm == NULL)
 		abort();
 	mfvVirtualMachine* v = (mfvVirtualMachine*)vm;
+	if (v->code != NULL && mfmDeallocate(v->allocator, v->code) != MF_ERROR_OKAY)
+		abort();
 	if (v->allocator != NULL)
 	{
 		mfError err = mfmReleaseObject((mfmObject*)v->allocator);
@@ -97,1204 +119,1031 @@ void mfvDestroyVirtualMachine(void * vm)
 		abort();
 }
 
-mfError mfvSetVirtualMachineCode(mfvVirtualMachine * vm, mfvInstructionPointer ip, const mfmU8 * instructions)
+// Instruction operand formats (R is a 2 byte register index, I a literal and A a code offset)
+#define MFV_FORMAT_NONE		0x00
+#define MFV_FORMAT_I8		0x01
+#define MFV_FORMAT_I16		0x02
+#define MFV_FORMAT_I32		0x03
+#define MFV_FORMAT_RR		0x04
+#define MFV_FORMAT_RRR		0x05
+#define MFV_FORMAT_RI		0x06
+#define MFV_FORMAT_RRI		0x07
+#define MFV_FORMAT_A		0x08
+#define MFV_FORMAT_RA		0x09
+#define MFV_FORMAT_RRA		0x0A
+
+typedef struct
 {
-	if (vm == NULL)
-		return MFV_ERROR_INVALID_ARGUMENTS;
-	vm->code = instructions;
-	vm->ip = ip;
-	return MF_ERROR_OKAY;
-}
+	mfmU8 size;
+	mfmU8 registerCount;
+	mfmBool isAddress;
+} mfvInstructionFormat;
 
-mfError mfvStepVirtualMachine(mfvVirtualMachine * vm, mfvVirtualMachineState* state)
+static const mfvInstructionFormat mfvInstructionFormats[] =
 {
-#ifdef MAGMA_FRAMEWORK_DEBUG
-	if (vm == NULL)
-		return MFV_ERROR_INVALID_ARGUMENTS;
-	if (vm->code == MFV_ERROR_NULL_CODE)
-		return MFV_ERROR_NULL_CODE;
-#endif
-
-	mfError err = MF_ERROR_OKAY;
+	{ 0, 0, MFM_FALSE },	// MFV_FORMAT_NONE
+	{ 1, 0, MFM_FALSE },	// MFV_FORMAT_I8
+	{ 2, 0, MFM_FALSE },	// MFV_FORMAT_I16
+	{ 4, 0, MFM_FALSE },	// MFV_FORMAT_I32
+	{ 4, 2, MFM_FALSE },	// MFV_FORMAT_RR
+	{ 6, 3, MFM_FALSE },	// MFV_FORMAT_RRR
+	{ 6, 1, MFM_FALSE },	// MFV_FORMAT_RI
+	{ 8, 2, MFM_FALSE },	// MFV_FORMAT_RRI
+	{ 4, 0, MFM_TRUE },		// MFV_FORMAT_A
+	{ 6, 1, MFM_TRUE },		// MFV_FORMAT_RA
+	{ 8, 2, MFM_TRUE },		// MFV_FORMAT_RRA
+};
 
-	if (state != NULL)
-		*state = MFV_STATE_UNFINISHED;
-	
-	switch (vm->code[vm->ip])
+static mfError mfvGetInstructionFormat(mfmU8 opcode, mfmU8 version, mfmU8* format)
+{
+	switch (opcode)
 	{
-		// Stack operations
-		{
-			case MFV_BYTECODE_POP:
-			{
-				mfmU8 size = vm->code[vm->ip + 1];
-				vm->ip += 2;
-				if (vm->stackHead < size)
-					return MFV_ERROR_STACK_UNDERFLOW;
-				vm->stackHead -= size;
-				break;
-			}
-
-			case MFV_BYTECODE_PUSH_COPY:
-			{
-				mfmU8 count = vm->code[vm->ip + 1];
-				vm->ip += 2;
-				if (vm->stackHead < count)
-					return MFV_ERROR_STACK_UNDERFLOW;
-				if (vm->stackHead + count > vm->desc.stackSize)
-					return MFV_ERROR_STACK_OVERFLOW;
-				memcpy(vm->stack + vm->stackHead, vm->stack + vm->stackHead - count, count);
-				vm->stackHead += count;
-				break;
-			}
-
-			case MFV_BYTECODE_PUSH8:
-			{
-				err = mfvVirtualMachinePush8(vm, vm->code + vm->ip + 1);
-				vm->ip += 2;
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
-
-			case MFV_BYTECODE_PUSH16:
-			{
-				mfmU16 value;
-				mfmFromBigEndian2(vm->code + vm->ip + 1, &value);
-				err = mfvVirtualMachinePush16(vm, &value);
-				vm->ip += 3;
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		case MFV_BYTECODE_POP:
+		case MFV_BYTECODE_PUSH_COPY:
+		case MFV_BYTECODE_PUSH8:
+			*format = MFV_FORMAT_I8;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_PUSH16:
+			*format = MFV_FORMAT_I16;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_PUSH32:
+		case MFV_BYTECODE_STORE8:
+		case MFV_BYTECODE_STORE16:
+		case MFV_BYTECODE_STORE32:
+		case MFV_BYTECODE_LOAD8:
+		case MFV_BYTECODE_LOAD16:
+		case MFV_BYTECODE_LOAD32:
+			*format = MFV_FORMAT_I32;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_ADDS8: case MFV_BYTECODE_SUBS8: case MFV_BYTECODE_MULS8: case MFV_BYTECODE_DIVS8: case MFV_BYTECODE_MODS8:
+		case MFV_BYTECODE_ADDU8: case MFV_BYTECODE_SUBU8: case MFV_BYTECODE_MULU8: case MFV_BYTECODE_DIVU8: case MFV_BYTECODE_MODU8:
+		case MFV_BYTECODE_ADDS16: case MFV_BYTECODE_SUBS16: case MFV_BYTECODE_MULS16: case MFV_BYTECODE_DIVS16: case MFV_BYTECODE_MODS16:
+		case MFV_BYTECODE_ADDU16: case MFV_BYTECODE_SUBU16: case MFV_BYTECODE_MULU16: case MFV_BYTECODE_DIVU16: case MFV_BYTECODE_MODU16:
+		case MFV_BYTECODE_ADDS32: case MFV_BYTECODE_SUBS32: case MFV_BYTECODE_MULS32: case MFV_BYTECODE_DIVS32: case MFV_BYTECODE_MODS32:
+		case MFV_BYTECODE_ADDU32: case MFV_BYTECODE_SUBU32: case MFV_BYTECODE_MULU32: case MFV_BYTECODE_DIVU32: case MFV_BYTECODE_MODU32:
+		case MFV_BYTECODE_ADDF32: case MFV_BYTECODE_SUBF32: case MFV_BYTECODE_MULF32: case MFV_BYTECODE_DIVF32: case MFV_BYTECODE_MODF32:
+		case MFV_BYTECODE_FLOORF32: case MFV_BYTECODE_CEILF32: case MFV_BYTECODE_FRACTF32:
+		case MFV_BYTECODE_END: case MFV_BYTECODE_YIELD: case MFV_BYTECODE_CALL: case MFV_BYTECODE_RETURN: case MFV_BYTECODE_JUMP:
+		case MFV_BYTECODE_JUMP_I8_NOT_ZERO: case MFV_BYTECODE_JUMP_I16_NOT_ZERO: case MFV_BYTECODE_JUMP_I32_NOT_ZERO:
+		case MFV_BYTECODE_JUMP_F32_NOT_ZERO: case MFV_BYTECODE_CALL_BUILTIN:
+		case MFV_BYTECODE_STORES8: case MFV_BYTECODE_STORES16: case MFV_BYTECODE_STORES32:
+		case MFV_BYTECODE_LOADS8: case MFV_BYTECODE_LOADS16: case MFV_BYTECODE_LOADS32:
+		case MFV_BYTECODE_THROW_WARNING: case MFV_BYTECODE_THROW_ERROR:
+			*format = MFV_FORMAT_NONE;
+			return MF_ERROR_OKAY;
+	}
 
-			case MFV_BYTECODE_PUSH32:
-			{
-				mfmU32 value;
-				mfmFromBigEndian4(vm->code + vm->ip + 1, &value);
-				err = mfvVirtualMachinePush32(vm, &value);
-				vm->ip += 5;
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
-		}
+	if (version < 2)
+		return MFV_ERROR_INVALID_INSTRUCTION;
 
-		// 8 bit operations
-		{
-			case MFV_BYTECODE_ADDS8:
-			{
-				vm->ip += 1;
-
-				mfmI8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI8 val = val1 + val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	switch (opcode)
+	{
+		case MFV_BYTECODE_ADDS32_R: case MFV_BYTECODE_SUBS32_R: case MFV_BYTECODE_MULS32_R: case MFV_BYTECODE_DIVS32_R: case MFV_BYTECODE_MODS32_R:
+		case MFV_BYTECODE_ADDU32_R: case MFV_BYTECODE_SUBU32_R: case MFV_BYTECODE_MULU32_R: case MFV_BYTECODE_DIVU32_R: case MFV_BYTECODE_MODU32_R:
+		case MFV_BYTECODE_ADDF32_R: case MFV_BYTECODE_SUBF32_R: case MFV_BYTECODE_MULF32_R: case MFV_BYTECODE_DIVF32_R: case MFV_BYTECODE_MODF32_R:
+			*format = MFV_FORMAT_RRR;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_MOVE_R:
+			*format = MFV_FORMAT_RR;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_SET_R:
+			*format = MFV_FORMAT_RI;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_ADDI_R:
+			*format = MFV_FORMAT_RRI;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_JUMP_TO:
+		case MFV_BYTECODE_CALL_TO:
+		case MFV_BYTECODE_JUMP_I32_NOT_ZERO_TO:
+			*format = MFV_FORMAT_A;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_JUMP_NOT_ZERO_R:
+			*format = MFV_FORMAT_RA;
+			return MF_ERROR_OKAY;
+
+		case MFV_BYTECODE_JUMP_EQUAL_R:
+		case MFV_BYTECODE_JUMP_NOT_EQUAL_R:
+		case MFV_BYTECODE_JUMP_LESS_S32_R:
+		case MFV_BYTECODE_JUMP_LESS_U32_R:
+		case MFV_BYTECODE_JUMP_LESS_F32_R:
+			*format = MFV_FORMAT_RRA;
+			return MF_ERROR_OKAY;
 
-			case MFV_BYTECODE_SUBS8:
-			{
-				vm->ip += 1;
-
-				mfmI8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI8 val = val1 - val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		default:
+			return MFV_ERROR_INVALID_INSTRUCTION;
+	}
+}
 
-			case MFV_BYTECODE_MULS8:
-			{
-				vm->ip += 1;
-
-				mfmI8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI8 val = val1 * val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+// Checks the register index of the instructions which have it as an operand
+static mfError mfvCheckRegisterOperands(mfvVirtualMachine* vm, const mfvInstruction* instruction, mfmU8 format)
+{
+	mfmU64 registerCount;
+	switch (instruction->opcode)
+	{
+		case MFV_BYTECODE_STORE8:
+		case MFV_BYTECODE_LOAD8:
+			registerCount = vm->desc.registerCount * 4;
+			break;
+		case MFV_BYTECODE_STORE16:
+		case MFV_BYTECODE_LOAD16:
+			registerCount = vm->desc.registerCount * 2;
+			break;
+		case MFV_BYTECODE_STORE32:
+		case MFV_BYTECODE_LOAD32:
+			registerCount = vm->desc.registerCount;
+			break;
+		default:
+			registerCount = 0;
+			break;
+	}
+	if (registerCount != 0 && instruction->operand >= registerCount)
+		return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
 
-			case MFV_BYTECODE_DIVS8:
-			{
-				vm->ip += 1;
-
-				mfmI8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI8 val = val1 / val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	const mfmU16 registers[] = { instruction->a, instruction->b, instruction->c };
+	for (mfmU64 i = 0; i < mfvInstructionFormats[format].registerCount; ++i)
+		if (registers[i] >= vm->desc.registerCount)
+			return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
+	return MF_ERROR_OKAY;
+}
 
-			case MFV_BYTECODE_MODS8:
-			{
-				vm->ip += 1;
-
-				mfmI8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI8 val = val1 % val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+static mfmU32 mfvReadOperand(const mfmU8* data, mfmU64 size)
+{
+	mfmU32 value = 0;
+	for (mfmU64 i = 0; i < size; ++i)
+		value = (value << 8) | data[i];
+	return value;
+}
 
-			case MFV_BYTECODE_ADDU8:
-			{
-				vm->ip += 1;
-
-				mfmU8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU8 val = val1 + val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+static mfmBool mfvResolveAddress(const mfmU32* addresses, mfmU64 codeSize, mfmU32 address, mfmU32* index)
+{
+	if (address >= codeSize || addresses[address] == MFV_INVALID_ADDRESS)
+		return MFM_FALSE;
+	*index = addresses[address];
+	return MFM_TRUE;
+}
 
-			case MFV_BYTECODE_SUBU8:
-			{
-				vm->ip += 1;
-
-				mfmU8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU8 val = val1 - val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+// Gets the register instruction which does the same as a version 1 4 byte arithmetic instruction
+static mfmBool mfvGetRegisterOperation(mfmU8 opcode, mfmU8* registerOpcode)
+{
+	if (opcode >= MFV_BYTECODE_ADDS32 && opcode <= MFV_BYTECODE_MODS32)
+		*registerOpcode = MFV_BYTECODE_ADDS32_R + (opcode - MFV_BYTECODE_ADDS32);
+	else if (opcode >= MFV_BYTECODE_ADDU32 && opcode <= MFV_BYTECODE_MODU32)
+		*registerOpcode = MFV_BYTECODE_ADDU32_R + (opcode - MFV_BYTECODE_ADDU32);
+	else if (opcode >= MFV_BYTECODE_ADDF32 && opcode <= MFV_BYTECODE_MODF32)
+		*registerOpcode = MFV_BYTECODE_ADDF32_R + (opcode - MFV_BYTECODE_ADDF32);
+	else
+		return MFM_FALSE;
+	return MFM_TRUE;
+}
 
-			case MFV_BYTECODE_MULU8:
-			{
-				vm->ip += 1;
-
-				mfmU8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU8 val = val1 * val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+/*
+	Translates sequences of version 1 stack instructions into single version 2 instructions.
+	The translated instruction replaces the first instruction of the sequence and skips the rest of it when run. The other
+	instructions are kept, so jumps into the middle of a sequence still work.
+*/
+static void mfvTranslateCode(mfvInstruction* code, mfmU64 count, const mfmU32* addresses, mfmU64 codeSize)
+{
+#define MFV_IS(offset, op) (i + (offset) < count && code[i + (offset)].opcode == (op))
+#define MFV_IS_REGISTER(offset, op) (MFV_IS(offset, op) && code[i + (offset)].operand <= 0xFFFF)
 
-			case MFV_BYTECODE_DIVU8:
-			{
-				vm->ip += 1;
-
-				mfmU8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU8 val = val1 / val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	for (mfmU64 i = 0; i < count; ++i)
+	{
+		mfvInstruction* in = &code[i];
+		mfmU8 opcode;
+		mfmU32 index;
 
-			case MFV_BYTECODE_MODU8:
-			{
-				vm->ip += 1;
-
-				mfmU8 val1, val2;
-				err = mfvVirtualMachinePop8(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop8(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU8 val = val1 % val2;
-				err = mfvVirtualMachinePush8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		// LOAD32 x, LOAD32 y, <op>32, STORE32 z -> <op>32_R z, y, x
+		if (MFV_IS_REGISTER(0, MFV_BYTECODE_LOAD32) && MFV_IS_REGISTER(1, MFV_BYTECODE_LOAD32) && i + 3 < count &&
+			mfvGetRegisterOperation(code[i + 2].opcode, &opcode) && MFV_IS_REGISTER(3, MFV_BYTECODE_STORE32))
+		{
+			in->a = (mfmU16)code[i + 3].operand;
+			in->b = (mfmU16)code[i + 1].operand;
+			in->c = (mfmU16)code[i].operand;
+			in->opcode = opcode;
+			in->size = 4;
 		}
-
-		// 16 bit operations
+		// PUSH32 imm, LOAD32 x, ADD32/SUB32, STORE32 z -> ADDI_R z, x, imm/-imm
+		else if (MFV_IS(0, MFV_BYTECODE_PUSH32) && MFV_IS_REGISTER(1, MFV_BYTECODE_LOAD32) &&
+				 (MFV_IS(2, MFV_BYTECODE_ADDS32) || MFV_IS(2, MFV_BYTECODE_ADDU32) ||
+				  MFV_IS(2, MFV_BYTECODE_SUBS32) || MFV_IS(2, MFV_BYTECODE_SUBU32)) &&
+				 MFV_IS_REGISTER(3, MFV_BYTECODE_STORE32))
 		{
-			case MFV_BYTECODE_ADDS16:
-			{
-				vm->ip += 1;
-
-				mfmI16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI16 val = val1 + val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+			mfmBool subtract = code[i + 2].opcode == MFV_BYTECODE_SUBS32 || code[i + 2].opcode == MFV_BYTECODE_SUBU32;
+			in->a = (mfmU16)code[i + 3].operand;
+			in->b = (mfmU16)code[i + 1].operand;
+			in->operand = subtract ? 0 - in->operand : in->operand;
+			in->opcode = MFV_BYTECODE_ADDI_R;
+			in->size = 4;
+		}
+		// LOAD32 x, PUSH32 addr, JUMP_I32_NOT_ZERO -> JUMP_NOT_ZERO_R x, addr
+		else if (MFV_IS_REGISTER(0, MFV_BYTECODE_LOAD32) && MFV_IS(1, MFV_BYTECODE_PUSH32) &&
+				 MFV_IS(2, MFV_BYTECODE_JUMP_I32_NOT_ZERO) && mfvResolveAddress(addresses, codeSize, code[i + 1].operand, &index))
+		{
+			in->a = (mfmU16)in->operand;
+			in->operand = index;
+			in->opcode = MFV_BYTECODE_JUMP_NOT_ZERO_R;
+			in->size = 3;
+		}
+		// PUSH32 imm, STORE32 z -> SET_R z, imm
+		else if (MFV_IS(0, MFV_BYTECODE_PUSH32) && MFV_IS_REGISTER(1, MFV_BYTECODE_STORE32))
+		{
+			in->a = (mfmU16)code[i + 1].operand;
+			in->opcode = MFV_BYTECODE_SET_R;
+			in->size = 2;
+		}
+		// LOAD32 x, STORE32 z -> MOVE_R z, x
+		else if (MFV_IS_REGISTER(0, MFV_BYTECODE_LOAD32) && MFV_IS_REGISTER(1, MFV_BYTECODE_STORE32))
+		{
+			in->a = (mfmU16)code[i + 1].operand;
+			in->b = (mfmU16)in->operand;
+			in->opcode = MFV_BYTECODE_MOVE_R;
+			in->size = 2;
+		}
+		// PUSH32 addr, JUMP/CALL/JUMP_I32_NOT_ZERO -> JUMP_TO/CALL_TO/JUMP_I32_NOT_ZERO_TO addr
+		else if (MFV_IS(0, MFV_BYTECODE_PUSH32) && i + 1 < count &&
+				 (code[i + 1].opcode == MFV_BYTECODE_JUMP || code[i + 1].opcode == MFV_BYTECODE_CALL ||
+				  code[i + 1].opcode == MFV_BYTECODE_JUMP_I32_NOT_ZERO) &&
+				 mfvResolveAddress(addresses, codeSize, in->operand, &index))
+		{
+			if (code[i + 1].opcode == MFV_BYTECODE_JUMP)
+				in->opcode = MFV_BYTECODE_JUMP_TO;
+			else if (code[i + 1].opcode == MFV_BYTECODE_CALL)
+				in->opcode = MFV_BYTECODE_CALL_TO;
+			else
+				in->opcode = MFV_BYTECODE_JUMP_I32_NOT_ZERO_TO;
+			in->operand = index;
+			in->size = 2;
+		}
+	}
 
-			case MFV_BYTECODE_SUBS16:
-			{
-				vm->ip += 1;
-
-				mfmI16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI16 val = val1 - val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#undef MFV_IS_REGISTER
+#undef MFV_IS
+}
 
-			case MFV_BYTECODE_MULS16:
-			{
-				vm->ip += 1;
-
-				mfmI16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI16 val = val1 * val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+mfError mfvSetVirtualMachineCode(mfvVirtualMachine * vm, mfvInstructionPointer ip, const mfmU8 * instructions, mfmU64 size)
+{
+	if (vm == NULL || instructions == NULL || size == 0 || size >= MFV_INVALID_ADDRESS)
+		return MFV_ERROR_INVALID_ARGUMENTS;
 
-			case MFV_BYTECODE_DIVS16:
-			{
-				vm->ip += 1;
-
-				mfmI16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI16 val = val1 / val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	// Version 2 code starts with a header, whose first byte isn't a version 1 instruction
+	mfmU8 version = 1;
+	mfmU64 start = 0;
+	if (instructions[0] == (mfmU8)MFV_BYTECODE_V2_HEADER[0])
+	{
+		if (size < MFV_BYTECODE_V2_HEADER_SIZE || memcmp(instructions, MFV_BYTECODE_V2_HEADER, MFV_BYTECODE_V2_HEADER_SIZE) != 0)
+			return MFV_ERROR_INVALID_INSTRUCTION;
+		version = 2;
+		start = MFV_BYTECODE_V2_HEADER_SIZE;
+	}
 
-			case MFV_BYTECODE_MODS16:
-			{
-				vm->ip += 1;
-
-				mfmI16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI16 val = val1 % val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	// Validate the code and count its instructions
+	mfmU64 instructionCount = 0;
+	for (mfmU64 offset = start; offset < size; ++instructionCount)
+	{
+		mfmU8 format;
+		mfError err = mfvGetInstructionFormat(instructions[offset], version, &format);
+		if (err != MF_ERROR_OKAY)
+			return err;
+		if (size - offset - 1 < mfvInstructionFormats[format].size)
+			return MFV_ERROR_INVALID_INSTRUCTION;
+		offset += 1 + mfvInstructionFormats[format].size;
+	}
 
-			case MFV_BYTECODE_ADDU16:
-			{
-				vm->ip += 1;
-
-				mfmU16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU16 val = val1 + val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	mfvInstruction* code;
+	mfError err = mfmAllocate(vm->allocator, &code, (instructionCount + 1) * sizeof(mfvInstruction) + size * sizeof(mfmU32));
+	if (err != MF_ERROR_OKAY)
+		return err;
+	mfmU32* addresses = (mfmU32*)(code + instructionCount + 1);
+
+	// Decode it
+	for (mfmU64 offset = 0; offset < start; ++offset)
+		addresses[offset] = MFV_INVALID_ADDRESS;
+	addresses[0] = 0; // The start of the code is the first instruction, even if the code has a header
+	mfmU64 offset = start;
+	for (mfmU64 i = 0; i < instructionCount; ++i)
+	{
+		mfmU8 format;
+		mfvGetInstructionFormat(instructions[offset], version, &format);
+		const mfvInstructionFormat* f = &mfvInstructionFormats[format];
+
+		mfvInstruction* in = &code[i];
+		mfmU16 registers[3] = { 0, 0, 0 };
+		for (mfmU64 j = 0; j < f->registerCount; ++j)
+			registers[j] = (mfmU16)mfvReadOperand(instructions + offset + 1 + j * 2, 2);
+		in->opcode = instructions[offset];
+		in->size = 1;
+		in->a = registers[0];
+		in->b = registers[1];
+		in->c = registers[2];
+		in->operand = mfvReadOperand(instructions + offset + 1 + f->registerCount * 2, f->size - f->registerCount * 2);
+
+		err = mfvCheckRegisterOperands(vm, in, format);
+		if (err != MF_ERROR_OKAY)
+		{
+			mfmDeallocate(vm->allocator, code);
+			return err;
+		}
 
-			case MFV_BYTECODE_SUBU16:
-			{
-				vm->ip += 1;
-
-				mfmU16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU16 val = val1 - val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		addresses[offset] = (mfmU32)i;
+		for (mfmU64 j = 1; j <= f->size; ++j)
+			addresses[offset + j] = MFV_INVALID_ADDRESS;
+		offset += 1 + f->size;
+	}
+	code[instructionCount].opcode = MFV_END_OF_CODE;
+	code[instructionCount].size = 1;
 
-			case MFV_BYTECODE_MULU16:
-			{
-				vm->ip += 1;
-
-				mfmU16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU16 val = val1 * val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	// Resolve the addresses of jumps and calls by address, now that every instruction's index is known
+	offset = start;
+	for (mfmU64 i = 0; i < instructionCount; ++i)
+	{
+		mfmU8 format;
+		mfvGetInstructionFormat(instructions[offset], version, &format);
+		if (mfvInstructionFormats[format].isAddress &&
+			mfvResolveAddress(addresses, size, code[i].operand, &code[i].operand) == MFM_FALSE)
+		{
+			mfmDeallocate(vm->allocator, code);
+			return MFV_ERROR_INVALID_ADDRESS;
+		}
+		offset += 1 + mfvInstructionFormats[format].size;
+	}
 
-			case MFV_BYTECODE_DIVU16:
-			{
-				vm->ip += 1;
-
-				mfmU16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU16 val = val1 / val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	if (ip >= size || addresses[ip] == MFV_INVALID_ADDRESS)
+	{
+		mfmDeallocate(vm->allocator, code);
+		return MFV_ERROR_INVALID_ADDRESS;
+	}
 
-			case MFV_BYTECODE_MODU16:
-			{
-				vm->ip += 1;
-
-				mfmU16 val1, val2;
-				err = mfvVirtualMachinePop16(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop16(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU16 val = val1 % val2;
-				err = mfvVirtualMachinePush16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
-		}
+	mfvTranslateCode(code, instructionCount, addresses, size);
 
-		// 32 bit operations
-		{
-			case MFV_BYTECODE_ADDS32:
-			{
-				vm->ip += 1;
-
-				mfmI32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI32 val = val1 + val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	if (vm->code != NULL)
+	{
+		err = mfmDeallocate(vm->allocator, vm->code);
+		if (err != MF_ERROR_OKAY)
+			return err;
+	}
+	vm->code = code;
+	vm->addresses = addresses;
+	vm->codeSize = size;
+	vm->instructionCount = instructionCount;
+	vm->ip = addresses[ip];
+
+	// The return addresses on the call stack are indices into the previous code
+	memset(vm->callStack, 0, vm->callStackHead * sizeof(mfvInstructionPointer));
+	vm->callStackHead = 0;
+	return MF_ERROR_OKAY;
+}
 
-			case MFV_BYTECODE_SUBS32:
-			{
-				vm->ip += 1;
-
-				mfmI32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI32 val = val1 - val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+mfError mfvStepVirtualMachine(mfvVirtualMachine * vm, mfvVirtualMachineState* state)
+{
+	const mfmU64 instructionCount = 1;
+	return mfvRunVirtualMachine(vm, &instructionCount, NULL, state);
+}
 
-			case MFV_BYTECODE_MULS32:
-			{
-				vm->ip += 1;
-
-				mfmI32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI32 val = val1 * val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+// The run loop keeps the instruction pointer and the stack head in locals and dispatches each instruction straight to the next
+// one's handler with computed gotos (direct threading) when the compiler supports them, and with a switch otherwise (MSVC)
+#if defined(__GNUC__) || defined(__clang__)
+#define MFV_DIRECT_THREADING
+#endif
 
-			case MFV_BYTECODE_DIVS32:
-			{
-				vm->ip += 1;
-
-				mfmI32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI32 val = val1 / val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#ifdef MFV_DIRECT_THREADING
+#define MFV_OP(opcode) mfvOp_##opcode
+#define MFV_OP_INVALID mfvOp_INVALID
+#define MFV_DISPATCH() goto *dispatchTable[code[ip].opcode]
+#else
+#define MFV_OP(opcode) case MFV_BYTECODE_##opcode
+#define MFV_OP_INVALID default
+#define MFV_DISPATCH() goto mfvDispatch
+#endif
 
-			case MFV_BYTECODE_MODS32:
-			{
-				vm->ip += 1;
-
-				mfmI32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmI32 val = val1 % val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#define MFV_FAIL(error) do { err = (error); goto mfvFailed; } while (0)
+#define MFV_COUNT() do { if (executed == limit) goto mfvLimitReached; ++executed; } while (0)
+#define MFV_CONTINUE() do { MFV_COUNT(); MFV_DISPATCH(); } while (0)
+#define MFV_NEXT() do { ++ip; MFV_CONTINUE(); } while (0)
+// Moves past the instructions run by the current one
+#define MFV_SKIP() do { ip += code[ip].size; MFV_CONTINUE(); } while (0)
+
+// Jumps to a code offset
+#define MFV_JUMP(address) do {\
+	if ((address) >= codeSize || addresses[(address)] == MFV_INVALID_ADDRESS)\
+		MFV_FAIL(MFV_ERROR_INVALID_ADDRESS);\
+	ip = addresses[(address)];\
+	MFV_CONTINUE();\
+} while (0)
+
+#define MFV_PUSH(value, size) do {\
+	if (head + (size) >= stackSize)\
+		MFV_FAIL(MFV_ERROR_STACK_OVERFLOW);\
+	memcpy(stack + head, (value), (size));\
+	head += (size);\
+} while (0)
+
+#define MFV_POP(value, size) do {\
+	if (head < (size))\
+		MFV_FAIL(MFV_ERROR_STACK_UNDERFLOW);\
+	head -= (size);\
+	memcpy((value), stack + head, (size));\
+} while (0)
+
+// Register indices given as operands were checked when the code was set
+
+// Pops a and b (a is the top value) and pushes the result, which always fits since the operands took more room
+#define MFV_BINARY_OP(opcode, type, expression) MFV_OP(opcode): {\
+	type a, b, r;\
+	MFV_POP(&a, sizeof(type));\
+	MFV_POP(&b, sizeof(type));\
+	r = (type)(expression);\
+	memcpy(stack + head, &r, sizeof(type));\
+	head += sizeof(type);\
+	MFV_NEXT();\
+}
 
-			case MFV_BYTECODE_ADDU32:
-			{
-				vm->ip += 1;
-
-				mfmU32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU32 val = val1 + val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+// Same as MFV_BINARY_OP, but fails with MFV_ERROR_INVALID_DIVISION if invalid is true (the operands are left on the stack)
+#define MFV_DIVISION_OP(opcode, type, invalid, expression) MFV_OP(opcode): {\
+	type a, b, r;\
+	if (head < 2 * sizeof(type))\
+		MFV_FAIL(MFV_ERROR_STACK_UNDERFLOW);\
+	memcpy(&a, stack + head - sizeof(type), sizeof(type));\
+	memcpy(&b, stack + head - 2 * sizeof(type), sizeof(type));\
+	if (invalid)\
+		MFV_FAIL(MFV_ERROR_INVALID_DIVISION);\
+	head -= 2 * sizeof(type);\
+	r = (type)(expression);\
+	memcpy(stack + head, &r, sizeof(type));\
+	head += sizeof(type);\
+	MFV_NEXT();\
+}
 
-			case MFV_BYTECODE_SUBU32:
-			{
-				vm->ip += 1;
-
-				mfmU32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU32 val = val1 - val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#define MFV_UNARY_OP(opcode, type, expression) MFV_OP(opcode): {\
+	type a, r;\
+	if (head < sizeof(type))\
+		MFV_FAIL(MFV_ERROR_STACK_UNDERFLOW);\
+	memcpy(&a, stack + head - sizeof(type), sizeof(type));\
+	r = (type)(expression);\
+	memcpy(stack + head - sizeof(type), &r, sizeof(type));\
+	MFV_NEXT();\
+}
 
-			case MFV_BYTECODE_MULU32:
-			{
-				vm->ip += 1;
-
-				mfmU32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU32 val = val1 * val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#define MFV_JUMP_NOT_ZERO_OP(opcode, type) MFV_OP(opcode): {\
+	mfvInstructionPointer address;\
+	type value;\
+	MFV_POP(&address, sizeof(mfvInstructionPointer));\
+	MFV_POP(&value, sizeof(type));\
+	if (value == 0)\
+		MFV_NEXT();\
+	MFV_JUMP(address);\
+}
 
-			case MFV_BYTECODE_DIVU32:
-			{
-				vm->ip += 1;
-
-				mfmU32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU32 val = val1 / val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#define MFV_STORE_OP(opcode, type, registers) MFV_OP(opcode): {\
+	type value;\
+	MFV_POP(&value, sizeof(type));\
+	vm->registers[code[ip].operand] = value;\
+	MFV_NEXT();\
+}
 
-			case MFV_BYTECODE_MODU32:
-			{
-				vm->ip += 1;
-
-				mfmU32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU32 val = val1 % val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
-		}
+#define MFV_LOAD_OP(opcode, type, registers) MFV_OP(opcode): {\
+	MFV_PUSH(&vm->registers[code[ip].operand], sizeof(type));\
+	MFV_NEXT();\
+}
 
+#define MFV_STORES_OP(opcode, type, registers, count) MFV_OP(opcode): {\
+	mfmU32 id;\
+	type value;\
+	MFV_POP(&id, sizeof(mfmU32));\
+	MFV_POP(&value, sizeof(type));\
+	if (id >= vm->desc.registerCount * (count))\
+		MFV_FAIL(MFV_ERROR_REGISTER_OUT_OF_BOUNDS);\
+	vm->registers[id] = value;\
+	MFV_NEXT();\
+}
 
-		// 32 bit floating point operations
-		{
-			case MFV_BYTECODE_ADDF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 val = val1 + val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#define MFV_LOADS_OP(opcode, type, registers, count) MFV_OP(opcode): {\
+	mfmU32 id;\
+	MFV_POP(&id, sizeof(mfmU32));\
+	if (id >= vm->desc.registerCount * (count))\
+		MFV_FAIL(MFV_ERROR_REGISTER_OUT_OF_BOUNDS);\
+	MFV_PUSH(&vm->registers[id], sizeof(type));\
+	MFV_NEXT();\
+}
 
-			case MFV_BYTECODE_SUBF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 val = val1 - val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+// Register instructions (version 2) read and write 4 byte registers, whose indices and addresses were checked when the code was set
 
-			case MFV_BYTECODE_MULF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 val = val1 * val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+// rA = rB op rC
+#define MFV_REGISTER_OP(opcode, type, expression) MFV_OP(opcode): {\
+	type a, b, r;\
+	memcpy(&a, &registers[code[ip].b], sizeof(type));\
+	memcpy(&b, &registers[code[ip].c], sizeof(type));\
+	r = (type)(expression);\
+	memcpy(&registers[code[ip].a], &r, sizeof(type));\
+	MFV_SKIP();\
+}
 
-			case MFV_BYTECODE_DIVF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 val = val1 / val2;
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+// Same as MFV_REGISTER_OP, but fails with MFV_ERROR_INVALID_DIVISION if invalid is true
+#define MFV_REGISTER_DIVISION_OP(opcode, type, invalid, expression) MFV_OP(opcode): {\
+	type a, b, r;\
+	memcpy(&a, &registers[code[ip].b], sizeof(type));\
+	memcpy(&b, &registers[code[ip].c], sizeof(type));\
+	if (invalid)\
+		MFV_FAIL(MFV_ERROR_INVALID_DIVISION);\
+	r = (type)(expression);\
+	memcpy(&registers[code[ip].a], &r, sizeof(type));\
+	MFV_SKIP();\
+}
 
-			case MFV_BYTECODE_MODF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val1, val2;
-				err = mfvVirtualMachinePop32(vm, &val1);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				err = mfvVirtualMachinePop32(vm, &val2);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 val = fmodf(val1, val2);
-				err = mfvVirtualMachinePush32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#define MFV_JUMP_COMPARE_OP(opcode, type, expression) MFV_OP(opcode): {\
+	type a, b;\
+	memcpy(&a, &registers[code[ip].a], sizeof(type));\
+	memcpy(&b, &registers[code[ip].b], sizeof(type));\
+	if (expression)\
+	{\
+		ip = code[ip].operand;\
+		MFV_CONTINUE();\
+	}\
+	MFV_SKIP();\
+}
 
-			case MFV_BYTECODE_FLOORF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val;
-				err = mfvVirtualMachinePop32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 ret = floorf(val);
-				err = mfvVirtualMachinePush32(vm, &ret);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+mfError mfvRunVirtualMachine(mfvVirtualMachine * vm, const mfmU64 * instructionCount, mfmU64 * executedInstructions, mfvVirtualMachineState* state)
+{
+#ifdef MAGMA_FRAMEWORK_DEBUG
+	if (vm == NULL)
+		return MFV_ERROR_INVALID_ARGUMENTS;
+	if (vm->code == NULL)
+		return MFV_ERROR_NULL_CODE;
+#endif
 
-			case MFV_BYTECODE_CEILF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val;
-				err = mfvVirtualMachinePop32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 ret = ceilf(val);
-				err = mfvVirtualMachinePush32(vm, &ret);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+#ifdef MFV_DIRECT_THREADING
+	// Every entry starts as invalid and the valid opcodes override it, which is exactly what -Woverride-init warns about
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"
+	static const void* const dispatchTable[256] =
+	{
+		[0 ... 255] = &&mfvOp_INVALID,
+
+		[MFV_BYTECODE_POP] = &&mfvOp_POP,
+		[MFV_BYTECODE_PUSH_COPY] = &&mfvOp_PUSH_COPY,
+		[MFV_BYTECODE_PUSH8] = &&mfvOp_PUSH8,
+		[MFV_BYTECODE_PUSH16] = &&mfvOp_PUSH16,
+		[MFV_BYTECODE_PUSH32] = &&mfvOp_PUSH32,
+
+		[MFV_BYTECODE_ADDS8] = &&mfvOp_ADDS8,
+		[MFV_BYTECODE_SUBS8] = &&mfvOp_SUBS8,
+		[MFV_BYTECODE_MULS8] = &&mfvOp_MULS8,
+		[MFV_BYTECODE_DIVS8] = &&mfvOp_DIVS8,
+		[MFV_BYTECODE_MODS8] = &&mfvOp_MODS8,
+		[MFV_BYTECODE_ADDU8] = &&mfvOp_ADDU8,
+		[MFV_BYTECODE_SUBU8] = &&mfvOp_SUBU8,
+		[MFV_BYTECODE_MULU8] = &&mfvOp_MULU8,
+		[MFV_BYTECODE_DIVU8] = &&mfvOp_DIVU8,
+		[MFV_BYTECODE_MODU8] = &&mfvOp_MODU8,
+
+		[MFV_BYTECODE_ADDS16] = &&mfvOp_ADDS16,
+		[MFV_BYTECODE_SUBS16] = &&mfvOp_SUBS16,
+		[MFV_BYTECODE_MULS16] = &&mfvOp_MULS16,
+		[MFV_BYTECODE_DIVS16] = &&mfvOp_DIVS16,
+		[MFV_BYTECODE_MODS16] = &&mfvOp_MODS16,
+		[MFV_BYTECODE_ADDU16] = &&mfvOp_ADDU16,
+		[MFV_BYTECODE_SUBU16] = &&mfvOp_SUBU16,
+		[MFV_BYTECODE_MULU16] = &&mfvOp_MULU16,
+		[MFV_BYTECODE_DIVU16] = &&mfvOp_DIVU16,
+		[MFV_BYTECODE_MODU16] = &&mfvOp_MODU16,
+
+		[MFV_BYTECODE_ADDS32] = &&mfvOp_ADDS32,
+		[MFV_BYTECODE_SUBS32] = &&mfvOp_SUBS32,
+		[MFV_BYTECODE_MULS32] = &&mfvOp_MULS32,
+		[MFV_BYTECODE_DIVS32] = &&mfvOp_DIVS32,
+		[MFV_BYTECODE_MODS32] = &&mfvOp_MODS32,
+		[MFV_BYTECODE_ADDU32] = &&mfvOp_ADDU32,
+		[MFV_BYTECODE_SUBU32] = &&mfvOp_SUBU32,
+		[MFV_BYTECODE_MULU32] = &&mfvOp_MULU32,
+		[MFV_BYTECODE_DIVU32] = &&mfvOp_DIVU32,
+		[MFV_BYTECODE_MODU32] = &&mfvOp_MODU32,
+
+		[MFV_BYTECODE_ADDF32] = &&mfvOp_ADDF32,
+		[MFV_BYTECODE_SUBF32] = &&mfvOp_SUBF32,
+		[MFV_BYTECODE_MULF32] = &&mfvOp_MULF32,
+		[MFV_BYTECODE_DIVF32] = &&mfvOp_DIVF32,
+		[MFV_BYTECODE_MODF32] = &&mfvOp_MODF32,
+		[MFV_BYTECODE_FLOORF32] = &&mfvOp_FLOORF32,
+		[MFV_BYTECODE_CEILF32] = &&mfvOp_CEILF32,
+		[MFV_BYTECODE_FRACTF32] = &&mfvOp_FRACTF32,
+
+		[MFV_BYTECODE_END] = &&mfvOp_END,
+		[MFV_BYTECODE_YIELD] = &&mfvOp_YIELD,
+		[MFV_BYTECODE_CALL] = &&mfvOp_CALL,
+		[MFV_BYTECODE_RETURN] = &&mfvOp_RETURN,
+		[MFV_BYTECODE_JUMP] = &&mfvOp_JUMP,
+		[MFV_BYTECODE_JUMP_I8_NOT_ZERO] = &&mfvOp_JUMP_I8_NOT_ZERO,
+		[MFV_BYTECODE_JUMP_I16_NOT_ZERO] = &&mfvOp_JUMP_I16_NOT_ZERO,
+		[MFV_BYTECODE_JUMP_I32_NOT_ZERO] = &&mfvOp_JUMP_I32_NOT_ZERO,
+		[MFV_BYTECODE_JUMP_F32_NOT_ZERO] = &&mfvOp_JUMP_F32_NOT_ZERO,
+		[MFV_BYTECODE_CALL_BUILTIN] = &&mfvOp_CALL_BUILTIN,
+
+		[MFV_BYTECODE_STORE8] = &&mfvOp_STORE8,
+		[MFV_BYTECODE_STORE16] = &&mfvOp_STORE16,
+		[MFV_BYTECODE_STORE32] = &&mfvOp_STORE32,
+		[MFV_BYTECODE_LOAD8] = &&mfvOp_LOAD8,
+		[MFV_BYTECODE_LOAD16] = &&mfvOp_LOAD16,
+		[MFV_BYTECODE_LOAD32] = &&mfvOp_LOAD32,
+		[MFV_BYTECODE_STORES8] = &&mfvOp_STORES8,
+		[MFV_BYTECODE_STORES16] = &&mfvOp_STORES16,
+		[MFV_BYTECODE_STORES32] = &&mfvOp_STORES32,
+		[MFV_BYTECODE_LOADS8] = &&mfvOp_LOADS8,
+		[MFV_BYTECODE_LOADS16] = &&mfvOp_LOADS16,
+		[MFV_BYTECODE_LOADS32] = &&mfvOp_LOADS32,
+
+		[MFV_BYTECODE_THROW_WARNING] = &&mfvOp_THROW_WARNING,
+		[MFV_BYTECODE_THROW_ERROR] = &&mfvOp_THROW_ERROR,
+
+		[MFV_BYTECODE_ADDS32_R] = &&mfvOp_ADDS32_R,
+		[MFV_BYTECODE_SUBS32_R] = &&mfvOp_SUBS32_R,
+		[MFV_BYTECODE_MULS32_R] = &&mfvOp_MULS32_R,
+		[MFV_BYTECODE_DIVS32_R] = &&mfvOp_DIVS32_R,
+		[MFV_BYTECODE_MODS32_R] = &&mfvOp_MODS32_R,
+		[MFV_BYTECODE_ADDU32_R] = &&mfvOp_ADDU32_R,
+		[MFV_BYTECODE_SUBU32_R] = &&mfvOp_SUBU32_R,
+		[MFV_BYTECODE_MULU32_R] = &&mfvOp_MULU32_R,
+		[MFV_BYTECODE_DIVU32_R] = &&mfvOp_DIVU32_R,
+		[MFV_BYTECODE_MODU32_R] = &&mfvOp_MODU32_R,
+		[MFV_BYTECODE_ADDF32_R] = &&mfvOp_ADDF32_R,
+		[MFV_BYTECODE_SUBF32_R] = &&mfvOp_SUBF32_R,
+		[MFV_BYTECODE_MULF32_R] = &&mfvOp_MULF32_R,
+		[MFV_BYTECODE_DIVF32_R] = &&mfvOp_DIVF32_R,
+		[MFV_BYTECODE_MODF32_R] = &&mfvOp_MODF32_R,
+		[MFV_BYTECODE_MOVE_R] = &&mfvOp_MOVE_R,
+		[MFV_BYTECODE_SET_R] = &&mfvOp_SET_R,
+		[MFV_BYTECODE_ADDI_R] = &&mfvOp_ADDI_R,
+
+		[MFV_BYTECODE_JUMP_TO] = &&mfvOp_JUMP_TO,
+		[MFV_BYTECODE_CALL_TO] = &&mfvOp_CALL_TO,
+		[MFV_BYTECODE_JUMP_I32_NOT_ZERO_TO] = &&mfvOp_JUMP_I32_NOT_ZERO_TO,
+		[MFV_BYTECODE_JUMP_NOT_ZERO_R] = &&mfvOp_JUMP_NOT_ZERO_R,
+		[MFV_BYTECODE_JUMP_EQUAL_R] = &&mfvOp_JUMP_EQUAL_R,
+		[MFV_BYTECODE_JUMP_NOT_EQUAL_R] = &&mfvOp_JUMP_NOT_EQUAL_R,
+		[MFV_BYTECODE_JUMP_LESS_S32_R] = &&mfvOp_JUMP_LESS_S32_R,
+		[MFV_BYTECODE_JUMP_LESS_U32_R] = &&mfvOp_JUMP_LESS_U32_R,
+		[MFV_BYTECODE_JUMP_LESS_F32_R] = &&mfvOp_JUMP_LESS_F32_R,
+
+		[MFV_END_OF_CODE] = &&mfvOp_INVALID,
+	};
+#pragma GCC diagnostic pop
+#endif
 
-			case MFV_BYTECODE_FRACTF32:
-			{
-				vm->ip += 1;
-
-				mfmF32 val;
-				err = mfvVirtualMachinePop32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 temp;
-				mfmF32 ret = modff(val, &temp);
-				err = mfvVirtualMachinePush32(vm, &ret);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+	mfError err = MF_ERROR_OKAY;
+	mfvVirtualMachineState s = MFV_STATE_UNFINISHED;
+	const mfvInstruction* code = vm->code;
+	const mfmU32* addresses = vm->addresses;
+	mfmU64 codeSize = vm->codeSize;
+	mfvInstructionPointer ip = vm->ip;
+	mfmU8* stack = vm->stack;
+	mfmU64 head = vm->stackHead;
+	const mfmU64 stackSize = vm->desc.stackSize;
+	mfmU32* const registers = vm->registers32;
+	const mfmU64 limit = (instructionCount == NULL) ? UINT64_MAX : *instructionCount;
+	mfmU64 executed = 0;
+
+	MFV_COUNT();
+#ifdef MFV_DIRECT_THREADING
+	MFV_DISPATCH();
+	{
+#else
+mfvDispatch:
+	switch (code[ip].opcode)
+	{
+#endif
+		// Stack operations
+		MFV_OP(POP):
+		{
+			mfmU32 size = code[ip].operand;
+			if (head < size)
+				MFV_FAIL(MFV_ERROR_STACK_UNDERFLOW);
+			head -= size;
+			MFV_NEXT();
 		}
 
-		// Flow control
+		MFV_OP(PUSH_COPY):
 		{
-			case MFV_BYTECODE_END:
-			{
-				vm->ip = 0;
-				if (state != NULL)
-					*state = MFV_STATE_FINISHED;
-				break;
-			}
-
-			case MFV_BYTECODE_YIELD:
-			{
-				vm->ip += 1;
-				if (state != NULL)
-					*state = MFV_STATE_UNFINISHED;
-				break;
-			}
-
-			case MFV_BYTECODE_CALL:
-			{
-				mfvInstructionPointer ip = 0;
-				err = mfvVirtualMachinePop32(vm, &ip);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				vm->ip += 1;
-				if (vm->callStackHead >= vm->desc.callStackSize)
-					return MFV_ERROR_CALL_STACK_OVERFLOW;
-				vm->callStack[vm->callStackHead] = vm->ip;
-				++vm->callStackHead;
-				vm->ip = ip;
-				break;
-			}
-
-			case MFV_BYTECODE_RETURN:
-			{
-				vm->ip += 1;
-				if (vm->callStackHead == 0)
-					return MFV_ERROR_CALL_STACK_UNDERFLOW;
-				--vm->callStackHead;
-				vm->ip = vm->callStack[vm->callStackHead];
-				break;
-			}
-
-			case MFV_BYTECODE_JUMP:
-			{
-				mfvInstructionPointer ip = 0;
-				err = mfvVirtualMachinePop32(vm, &ip);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				vm->ip = ip;
-				break;
-			}
-
-			case MFV_BYTECODE_JUMP_I8_NOT_ZERO:
-			{
-				mfvInstructionPointer ip = 0;
-				err = mfvVirtualMachinePop32(vm, &ip);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU8 val = 0;
-				err = mfvVirtualMachinePop8(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (val == 0)
-					vm->ip += 1;
-				else
-					vm->ip = ip;
-				break;
-			}
-
-			case MFV_BYTECODE_JUMP_I16_NOT_ZERO:
-			{
-				mfvInstructionPointer ip = 0;
-				err = mfvVirtualMachinePop32(vm, &ip);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU16 val = 0;
-				err = mfvVirtualMachinePop16(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (val == 0)
-					vm->ip += 1;
-				else
-					vm->ip = ip;
-				break;
-			}
-
-			case MFV_BYTECODE_JUMP_I32_NOT_ZERO:
-			{
-				mfvInstructionPointer ip = 0;
-				err = mfvVirtualMachinePop32(vm, &ip);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU32 val = 0;
-				err = mfvVirtualMachinePop32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (val == 0)
-					vm->ip += 1;
-				else
-					vm->ip = ip;
-				break;
-			}
-
-			case MFV_BYTECODE_JUMP_F32_NOT_ZERO:
-			{
-				mfvInstructionPointer ip = 0;
-				err = mfvVirtualMachinePop32(vm, &ip);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmF32 val = 0;
-				err = mfvVirtualMachinePop32(vm, &val);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (val == 0.0f)
-					vm->ip += 1;
-				else
-					vm->ip = ip;
-				break;
-			}
-
-			case MFV_BYTECODE_CALL_BUILTIN:
-			{
-				vm->ip += 1;
-
-				mfmU16 id;
-				err = mfvVirtualMachinePop16(vm, &id);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.functionTableSize || vm->functionTable[id] == NULL)
-					return MFV_ERROR_FUNCTION_NOT_DEFINED;
-				err = vm->functionTable[id](vm);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+			mfmU32 count = code[ip].operand;
+			if (head < count)
+				MFV_FAIL(MFV_ERROR_STACK_UNDERFLOW);
+			if (head + count > stackSize)
+				MFV_FAIL(MFV_ERROR_STACK_OVERFLOW);
+			memcpy(stack + head, stack + head - count, count);
+			head += count;
+			MFV_NEXT();
 		}
 
-		// Register operations
+		MFV_OP(PUSH8):
 		{
-			case MFV_BYTECODE_STORE8:
-			{
-				mfmU32 id;
-				mfmFromBigEndian4(vm->code + vm->ip + 1, &id);
-				vm->ip += 5;
-				mfmU8 value;
-				err = mfvVirtualMachinePop8(vm, &value);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount * 4)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				vm->registers8[id] = value;
-				break;
-			}
+			mfmU8 value = (mfmU8)code[ip].operand;
+			MFV_PUSH(&value, 1);
+			MFV_NEXT();
+		}
 
-			case MFV_BYTECODE_STORE16:
-			{
-				mfmU32 id;
-				mfmFromBigEndian4(vm->code + vm->ip + 1, &id);
-				vm->ip += 5;
-				mfmU16 value;
-				err = mfvVirtualMachinePop16(vm, &value);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount * 2)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				vm->registers16[id] = value;
-				break;
-			}
+		MFV_OP(PUSH16):
+		{
+			mfmU16 value = (mfmU16)code[ip].operand;
+			MFV_PUSH(&value, 2);
+			MFV_NEXT();
+		}
 
-			case MFV_BYTECODE_STORE32:
-			{
-				mfmU32 id;
-				mfmFromBigEndian4(vm->code + vm->ip + 1, &id);
-				vm->ip += 5;
-				mfmU8 value;
-				err = mfvVirtualMachinePop32(vm, &value);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				vm->registers32[id] = value;
-				break;
-			}
+		MFV_OP(PUSH32):
+		{
+			mfmU32 value = code[ip].operand;
+			MFV_PUSH(&value, 4);
+			MFV_NEXT();
+		}
 
-			case MFV_BYTECODE_LOAD8:
-			{
-				mfmU32 id;
-				mfmFromBigEndian4(vm->code + vm->ip + 1, &id);
-				vm->ip += 5;
-				if (id >= vm->desc.registerCount * 4)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				err = mfvVirtualMachinePush8(vm, &vm->registers8[id]);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		// Integer operations
+		// Signed results wrap around, the operands which could overflow an int are converted to unsigned types first, since signed overflow is undefined
+		MFV_BINARY_OP(ADDS8, mfmI8, a + b)
+		MFV_BINARY_OP(SUBS8, mfmI8, a - b)
+		MFV_BINARY_OP(MULS8, mfmI8, a * b)
+		MFV_DIVISION_OP(DIVS8, mfmI8, b == 0 || (a == MFM_I8_MIN && b == -1), a / b)
+		MFV_DIVISION_OP(MODS8, mfmI8, b == 0 || (a == MFM_I8_MIN && b == -1), a % b)
+		MFV_BINARY_OP(ADDU8, mfmU8, a + b)
+		MFV_BINARY_OP(SUBU8, mfmU8, a - b)
+		MFV_BINARY_OP(MULU8, mfmU8, a * b)
+		MFV_DIVISION_OP(DIVU8, mfmU8, b == 0, a / b)
+		MFV_DIVISION_OP(MODU8, mfmU8, b == 0, a % b)
+
+		MFV_BINARY_OP(ADDS16, mfmI16, a + b)
+		MFV_BINARY_OP(SUBS16, mfmI16, a - b)
+		MFV_BINARY_OP(MULS16, mfmI16, a * b)
+		MFV_DIVISION_OP(DIVS16, mfmI16, b == 0 || (a == MFM_I16_MIN && b == -1), a / b)
+		MFV_DIVISION_OP(MODS16, mfmI16, b == 0 || (a == MFM_I16_MIN && b == -1), a % b)
+		MFV_BINARY_OP(ADDU16, mfmU16, a + b)
+		MFV_BINARY_OP(SUBU16, mfmU16, a - b)
+		MFV_BINARY_OP(MULU16, mfmU16, (mfmU32)a * b)
+		MFV_DIVISION_OP(DIVU16, mfmU16, b == 0, a / b)
+		MFV_DIVISION_OP(MODU16, mfmU16, b == 0, a % b)
+
+		MFV_BINARY_OP(ADDS32, mfmI32, (mfmU32)a + (mfmU32)b)
+		MFV_BINARY_OP(SUBS32, mfmI32, (mfmU32)a - (mfmU32)b)
+		MFV_BINARY_OP(MULS32, mfmI32, (mfmU32)a * (mfmU32)b)
+		MFV_DIVISION_OP(DIVS32, mfmI32, b == 0 || (a == MFM_I32_MIN && b == -1), a / b)
+		MFV_DIVISION_OP(MODS32, mfmI32, b == 0 || (a == MFM_I32_MIN && b == -1), a % b)
+		MFV_BINARY_OP(ADDU32, mfmU32, a + b)
+		MFV_BINARY_OP(SUBU32, mfmU32, a - b)
+		MFV_BINARY_OP(MULU32, mfmU32, a * b)
+		MFV_DIVISION_OP(DIVU32, mfmU32, b == 0, a / b)
+		MFV_DIVISION_OP(MODU32, mfmU32, b == 0, a % b)
 
-			case MFV_BYTECODE_LOAD16:
-			{
-				mfmU32 id;
-				mfmFromBigEndian4(vm->code + vm->ip + 1, &id);
-				vm->ip += 5;
-				if (id >= vm->desc.registerCount * 2)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				err = mfvVirtualMachinePush16(vm, &vm->registers16[id]);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		// 32 bit floating point operations
+		MFV_BINARY_OP(ADDF32, mfmF32, a + b)
+		MFV_BINARY_OP(SUBF32, mfmF32, a - b)
+		MFV_BINARY_OP(MULF32, mfmF32, a * b)
+		MFV_BINARY_OP(DIVF32, mfmF32, a / b)
+		MFV_BINARY_OP(MODF32, mfmF32, fmodf(a, b))
+		MFV_UNARY_OP(FLOORF32, mfmF32, floorf(a))
+		MFV_UNARY_OP(CEILF32, mfmF32, ceilf(a))
+
+		MFV_OP(FRACTF32):
+		{
+			mfmF32 value, integral;
+			if (head < sizeof(mfmF32))
+				MFV_FAIL(MFV_ERROR_STACK_UNDERFLOW);
+			memcpy(&value, stack + head - sizeof(mfmF32), sizeof(mfmF32));
+			value = modff(value, &integral);
+			memcpy(stack + head - sizeof(mfmF32), &value, sizeof(mfmF32));
+			MFV_NEXT();
+		}
 
-			case MFV_BYTECODE_LOAD32:
-			{
-				mfmU32 id;
-				mfmFromBigEndian4(vm->code + vm->ip + 1, &id);
-				vm->ip += 5;
-				if (id >= vm->desc.registerCount)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				err = mfvVirtualMachinePush32(vm, &vm->registers32[id]);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		// Flow control
+		MFV_OP(END):
+		{
+			ip = 0;
+			s = MFV_STATE_FINISHED;
+			goto mfvStopped;
+		}
 
-			case MFV_BYTECODE_STORES8:
-			{
-				vm->ip += 1;
-				mfmU32 id;
-				err = mfvVirtualMachinePop32(vm, &id);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU8 value;
-				err = mfvVirtualMachinePop8(vm, &value);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount * 4)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				vm->registers8[id] = value;
-				break;
-			}
+		MFV_OP(YIELD):
+		{
+			ip += 1;
+			s = MFV_STATE_YIELD;
+			goto mfvStopped;
+		}
 
-			case MFV_BYTECODE_STORES16:
-			{
-				vm->ip += 1;
-				mfmU32 id;
-				err = mfvVirtualMachinePop32(vm, &id);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU16 value;
-				err = mfvVirtualMachinePop16(vm, &value);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount * 2)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				vm->registers16[id] = value;
-				break;
-			}
+		MFV_OP(CALL):
+		{
+			mfvInstructionPointer address;
+			MFV_POP(&address, sizeof(mfvInstructionPointer));
+			if (vm->callStackHead >= vm->desc.callStackSize)
+				MFV_FAIL(MFV_ERROR_CALL_STACK_OVERFLOW);
+			vm->callStack[vm->callStackHead] = ip + 1;
+			++vm->callStackHead;
+			MFV_JUMP(address);
+		}
 
-			case MFV_BYTECODE_STORES32:
-			{
-				vm->ip += 1;
-				mfmU32 id;
-				err = mfvVirtualMachinePop32(vm, &id);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				mfmU32 value;
-				err = mfvVirtualMachinePop32(vm, &value);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				vm->registers32[id] = value;
-				break;
-			}
+		MFV_OP(RETURN):
+		{
+			if (vm->callStackHead == 0)
+				MFV_FAIL(MFV_ERROR_CALL_STACK_UNDERFLOW);
+			--vm->callStackHead;
+			if (vm->callStack[vm->callStackHead] > vm->instructionCount)
+				MFV_FAIL(MFV_ERROR_INVALID_ADDRESS);
+			ip = vm->callStack[vm->callStackHead];
+			MFV_CONTINUE();
+		}
 
-			case MFV_BYTECODE_LOADS8:
-			{
-				vm->ip += 1;
-				mfmU32 id;
-				err = mfvVirtualMachinePop32(vm, &id);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount * 4)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				err = mfvVirtualMachinePush8(vm, &vm->registers8[id]);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		MFV_OP(JUMP):
+		{
+			mfvInstructionPointer address;
+			MFV_POP(&address, sizeof(mfvInstructionPointer));
+			MFV_JUMP(address);
+		}
 
-			case MFV_BYTECODE_LOADS16:
-			{
-				vm->ip += 1;
-				mfmU32 id;
-				err = mfvVirtualMachinePop32(vm, &id);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount * 2)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				err = mfvVirtualMachinePush16(vm, &vm->registers16[id]);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		MFV_JUMP_NOT_ZERO_OP(JUMP_I8_NOT_ZERO, mfmU8)
+		MFV_JUMP_NOT_ZERO_OP(JUMP_I16_NOT_ZERO, mfmU16)
+		MFV_JUMP_NOT_ZERO_OP(JUMP_I32_NOT_ZERO, mfmU32)
+		MFV_JUMP_NOT_ZERO_OP(JUMP_F32_NOT_ZERO, mfmF32)
 
-			case MFV_BYTECODE_LOADS32:
-			{
-				vm->ip += 1;
-				mfmU32 id;
-				err = mfvVirtualMachinePop32(vm, &id);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				if (id >= vm->desc.registerCount)
-					return MFV_ERROR_REGISTER_OUT_OF_BOUNDS;
-				err = mfvVirtualMachinePush32(vm, &vm->registers32[id]);
-				if (err != MF_ERROR_OKAY)
-					return err;
-				break;
-			}
+		MFV_OP(CALL_BUILTIN):
+		{
+			mfmU16 id;
+			MFV_POP(&id, sizeof(mfmU16));
+			if (id >= vm->desc.functionTableSize || vm->functionTable[id] == NULL)
+				MFV_FAIL(MFV_ERROR_FUNCTION_NOT_DEFINED);
+
+			// Built-in functions access the stack through the virtual machine, and may set its code
+			vm->ip = ip + 1;
+			vm->stackHead = head;
+			err = vm->functionTable[id](vm);
+			if (err != MF_ERROR_OKAY)
+				MFV_FAIL(err);
+			code = vm->code;
+			addresses = vm->addresses;
+			codeSize = vm->codeSize;
+			ip = vm->ip;
+			head = vm->stackHead;
+			MFV_CONTINUE();
 		}
 
+		// Register operations
+		MFV_STORE_OP(STORE8, mfmU8, registers8)
+		MFV_STORE_OP(STORE16, mfmU16, registers16)
+		MFV_STORE_OP(STORE32, mfmU32, registers32)
+		MFV_LOAD_OP(LOAD8, mfmU8, registers8)
+		MFV_LOAD_OP(LOAD16, mfmU16, registers16)
+		MFV_LOAD_OP(LOAD32, mfmU32, registers32)
+		MFV_STORES_OP(STORES8, mfmU8, registers8, 4)
+		MFV_STORES_OP(STORES16, mfmU16, registers16, 2)
+		MFV_STORES_OP(STORES32, mfmU32, registers32, 1)
+		MFV_LOADS_OP(LOADS8, mfmU8, registers8, 4)
+		MFV_LOADS_OP(LOADS16, mfmU16, registers16, 2)
+		MFV_LOADS_OP(LOADS32, mfmU32, registers32, 1)
+
 		// Special instructions
+		MFV_OP(THROW_WARNING):
 		{
-			case MFV_BYTECODE_THROW_WARNING:
+			for (mfmU64 i = 0; i < 254; ++i)
 			{
-				vm->ip += 1;
-				for (mfmU64 i = 0; i < 254; ++i)
-				{
-					err = mfvVirtualMachinePop8(vm, &vm->warningMessage[i]);
-					if (err != MF_ERROR_OKAY)
-						return err;
-					if (vm->warningMessage[i] == '\0')
-						break;
-				}
-				vm->warningMessage[255] = '\0';
-				break;
+				MFV_POP(&vm->warningMessage[i], 1);
+				if (vm->warningMessage[i] == '\0')
+					break;
 			}
+			vm->warningMessage[255] = '\0';
+			MFV_NEXT();
+		}
 
-			case MFV_BYTECODE_THROW_ERROR:
+		MFV_OP(THROW_ERROR):
+		{
+			for (mfmU64 i = 0; i < 254; ++i)
 			{
-				vm->ip = 0;
-				for (mfmU64 i = 0; i < 254; ++i)
-				{
-					err = mfvVirtualMachinePop8(vm, &vm->errorMessage[i]);
-					if (err != MF_ERROR_OKAY)
-						return err;
-					if (vm->errorMessage[i] == '\0')
-						break;
-				}
-				vm->errorMessage[255] = '\0';
-				return MFV_ERROR_ERROR_THROWN;
+				MFV_POP(&vm->errorMessage[i], 1);
+				if (vm->errorMessage[i] == '\0')
+					break;
 			}
+			vm->errorMessage[255] = '\0';
+			ip = 0;
+			MFV_FAIL(MFV_ERROR_ERROR_THROWN);
 		}
 
-		default:
-			return MFV_ERROR_INVALID_INSTRUCTION;
-	}
-
-	return err;
-}
+		// Register operations (version 2), signed results wrap around like on the stack operations
+		MFV_REGISTER_OP(ADDS32_R, mfmI32, (mfmU32)a + (mfmU32)b)
+		MFV_REGISTER_OP(SUBS32_R, mfmI32, (mfmU32)a - (mfmU32)b)
+		MFV_REGISTER_OP(MULS32_R, mfmI32, (mfmU32)a * (mfmU32)b)
+		MFV_REGISTER_DIVISION_OP(DIVS32_R, mfmI32, b == 0 || (a == MFM_I32_MIN && b == -1), a / b)
+		MFV_REGISTER_DIVISION_OP(MODS32_R, mfmI32, b == 0 || (a == MFM_I32_MIN && b == -1), a % b)
+		MFV_REGISTER_OP(ADDU32_R, mfmU32, a + b)
+		MFV_REGISTER_OP(SUBU32_R, mfmU32, a - b)
+		MFV_REGISTER_OP(MULU32_R, mfmU32, a * b)
+		MFV_REGISTER_DIVISION_OP(DIVU32_R, mfmU32, b == 0, a / b)
+		MFV_REGISTER_DIVISION_OP(MODU32_R, mfmU32, b == 0, a % b)
+		MFV_REGISTER_OP(ADDF32_R, mfmF32, a + b)
+		MFV_REGISTER_OP(SUBF32_R, mfmF32, a - b)
+		MFV_REGISTER_OP(MULF32_R, mfmF32, a * b)
+		MFV_REGISTER_OP(DIVF32_R, mfmF32, a / b)
+		MFV_REGISTER_OP(MODF32_R, mfmF32, fmodf(a, b))
+
+		MFV_OP(MOVE_R):
+		{
+			registers[code[ip].a] = registers[code[ip].b];
+			MFV_SKIP();
+		}
 
-mfError mfvRunVirtualMachine(mfvVirtualMachine * vm, const mfmU64 * instructionCount, mfmU64 * executedInstructions, mfvVirtualMachineState* state)
-{
-#ifdef MAGMA_FRAMEWORK_DEBUG
-	if (vm == NULL)
-		return MFV_ERROR_INVALID_ARGUMENTS;
-	if (vm->code == MFV_ERROR_NULL_CODE)
-		return MFV_ERROR_NULL_CODE;
-#endif
+		MFV_OP(SET_R):
+		{
+			registers[code[ip].a] = code[ip].operand;
+			MFV_SKIP();
+		}
 
-	mfError err = MF_ERROR_OKAY;
+		MFV_OP(ADDI_R):
+		{
+			registers[code[ip].a] = registers[code[ip].b] + code[ip].operand;
+			MFV_SKIP();
+		}
 
-	if (instructionCount == NULL)
-	{
-		for (mfmU64 i = 0;; ++i)
+		// Flow control by address (version 2)
+		MFV_OP(JUMP_TO):
 		{
-			mfvVirtualMachineState s;
-			err = mfvStepVirtualMachine(vm, &s);
-			if (state != NULL)
-				*state = s;
-			if (err != MF_ERROR_OKAY)
-			{
-				if (executedInstructions != NULL)
-					*executedInstructions = i;
-				return err;
-			}
+			ip = code[ip].operand;
+			MFV_CONTINUE();
+		}
 
-			if (s == MFV_STATE_FINISHED || s == MFV_STATE_YIELD)
-			{
-				if (executedInstructions != NULL)
-					*executedInstructions = i + 1;
-				return MF_ERROR_OKAY;
-			}
+		MFV_OP(CALL_TO):
+		{
+			if (vm->callStackHead >= vm->desc.callStackSize)
+				MFV_FAIL(MFV_ERROR_CALL_STACK_OVERFLOW);
+			vm->callStack[vm->callStackHead] = ip + code[ip].size;
+			++vm->callStackHead;
+			ip = code[ip].operand;
+			MFV_CONTINUE();
 		}
-	}
-	else
-	{
-		for (mfmU64 i = 0; i < *instructionCount; ++i)
+
+		MFV_OP(JUMP_I32_NOT_ZERO_TO):
 		{
-			mfvVirtualMachineState s;
-			err = mfvStepVirtualMachine(vm, &s);
-			if (state != NULL)
-				*state = s;
-			if (err != MF_ERROR_OKAY)
-			{
-				if (executedInstructions != NULL)
-					*executedInstructions = i;
-				return err;
-			}
+			mfmU32 value;
+			MFV_POP(&value, sizeof(mfmU32));
+			if (value == 0)
+				MFV_SKIP();
+			ip = code[ip].operand;
+			MFV_CONTINUE();
+		}
 
-			if (s == MFV_STATE_FINISHED || s == MFV_STATE_YIELD)
-			{
-				if (executedInstructions != NULL)
-					*executedInstructions = i + 1;
-				return MF_ERROR_OKAY;
-			}
+		MFV_OP(JUMP_NOT_ZERO_R):
+		{
+			if (registers[code[ip].a] == 0)
+				MFV_SKIP();
+			ip = code[ip].operand;
+			MFV_CONTINUE();
 		}
 
-		if (executedInstructions != NULL)
-			*executedInstructions = *instructionCount;
-		if (state != NULL)
-			*state = MFV_STATE_UNFINISHED;
+		MFV_JUMP_COMPARE_OP(JUMP_EQUAL_R, mfmU32, a == b)
+		MFV_JUMP_COMPARE_OP(JUMP_NOT_EQUAL_R, mfmU32, a != b)
+		MFV_JUMP_COMPARE_OP(JUMP_LESS_S32_R, mfmI32, a < b)
+		MFV_JUMP_COMPARE_OP(JUMP_LESS_U32_R, mfmU32, a < b)
+		MFV_JUMP_COMPARE_OP(JUMP_LESS_F32_R, mfmF32, a < b)
+
+		MFV_OP_INVALID:
+			MFV_FAIL(MFV_ERROR_INVALID_INSTRUCTION);
 	}
 
+mfvFailed:
+	// The instruction which failed isn't counted, and the instruction pointer is left on it
+	--executed;
+	goto mfvStopped;
+
+mfvLimitReached:
+	s = MFV_STATE_UNFINISHED;
+
+mfvStopped:
+	vm->ip = ip;
+	vm->stackHead = head;
+	if (executedInstructions != NULL)
+		*executedInstructions = executed;
+	if (state != NULL)
+		*state = s;
 	return err;
 }
 
+#undef MFV_JUMP_COMPARE_OP
+#undef MFV_REGISTER_OP
+#undef MFV_LOADS_OP
+#undef MFV_STORES_OP
+#undef MFV_LOAD_OP
+#undef MFV_STORE_OP
+#undef MFV_JUMP_NOT_ZERO_OP
+#undef MFV_UNARY_OP
+#undef MFV_BINARY_OP
+#undef MFV_POP
+#undef MFV_PUSH
+#undef MFV_JUMP
+#undef MFV_SKIP
+#undef MFV_NEXT
+#undef MFV_CONTINUE
+#undef MFV_COUNT
+#undef MFV_FAIL
+#undef MFV_DISPATCH
+#undef MFV_OP_INVALID
+#undef MFV_OP
+
 mfError mfvSetVirtualMachineFunction(mfvVirtualMachine * vm, mfmU16 id, mfvVirtualMachineFunction func)
 {
 	if (vm == NULL)
@@ -1377,7 +1226,7 @@ mfError mfvVirtualMachineGetWarning(mfvVirtualMachine * vm, const mfsUTF8CodeUni
 {
 	if (vm == NULL || msg == NULL)
 		return MFV_ERROR_INVALID_ARGUMENTS;
-	if (vm->warningMessage[0] = '\0')
+	if (vm->warningMessage[0] == '\0')
 		*msg = u8"[No warning message]";
 	else
 		*msg = &vm->warningMessage[0];
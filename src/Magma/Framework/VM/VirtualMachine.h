@@ -40,10 +40,18 @@ extern "C"
 
 	void mfvDestroyVirtualMachine(void* vm);
 
-	mfError mfvSetVirtualMachineCode(mfvVirtualMachine* vm, mfvInstructionPointer ip, const mfmU8* instructions);
+	// Validates and decodes the bytecode (which can be freed afterwards), and sets the instruction pointer to the code offset ip.
+	// The call stack is cleared, as its return addresses point into the previous code.
+	// Accepts version 1 and version 2 code (see Bytecode.h), and translates version 1 instruction sequences into version 2 instructions.
+	// Returns MFV_ERROR_INVALID_INSTRUCTION for unknown or truncated instructions, MFV_ERROR_REGISTER_OUT_OF_BOUNDS for register
+	// operands out of bounds and MFV_ERROR_INVALID_ADDRESS if ip or the address of a jump or call by address isn't the start of
+	// an instruction.
+	mfError mfvSetVirtualMachineCode(mfvVirtualMachine* vm, mfvInstructionPointer ip, const mfmU8* instructions, mfmU64 size);
 	
 	mfError mfvStepVirtualMachine(mfvVirtualMachine* vm, mfvVirtualMachineState* state);
 
+	// Runs until the program ends or yields, or until instructionCount instructions were run (if it isn't NULL).
+	// Much faster than calling mfvStepVirtualMachine in a loop. On errors the instruction pointer is left on the failed instruction.
 	mfError mfvRunVirtualMachine(mfvVirtualMachine* vm, const mfmU64* instructionCount, mfmU64* executedInstructions, mfvVirtualMachineState* state);
 
 	mfError mfvSetVirtualMachineFunction(mfvVirtualMachine* vm, mfmU16 id, mfvVirtualMachineFunction func);
@@ -0,0 +1,232 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/File/AsyncReader.h>
+#include <Magma/Framework/File/FolderArchive.h>
+#include <Magma/Framework/File/PackedArchive.h>
+#include <Magma/Framework/File/Path.h>
+#include <Magma/Framework/Memory/Allocator.h>
+#include <Magma/Framework/String/StringBuilder.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Thread/Atomic.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_FILE_PATH u8"AsyncReader.tmp"
+#define BIG_FILE_SIZE 100000
+#define READ_COUNT 64
+
+static mfmU8 bigData[BIG_FILE_SIZE];
+static volatile mfmI32 callbackCount;
+
+static void Callback(mffAsyncRead* read, void* userData)
+{
+	TEST_REQUIRE_PASS(userData == bigData);
+	TEST_REQUIRE_PASS(mffIsAsyncReadDone(read) == MFM_TRUE);
+	mftAtomic32Add(&callbackCount, 1);
+}
+
+static void Check(mffAsyncReader* reader, const mfsUTF8CodeUnit* dir)
+{
+	mfsUTF8CodeUnit bigPath[256];
+	mfsUTF8CodeUnit testPath[256];
+	mfsUTF8CodeUnit missingPath[256];
+	{
+		mfsStringStream ss;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, bigPath, sizeof(bigPath)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintFormat(&ss, u8"%s/asyncReaderTest/big.bin", dir) == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, testPath, sizeof(testPath)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintFormat(&ss, u8"%s/dir/test.txt", dir) == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, missingPath, sizeof(missingPath)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintFormat(&ss, u8"%s/dir/missing.txt", dir) == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+	}
+
+	mffFile* bigFile;
+	TEST_REQUIRE_PASS(mffGetFile(&bigFile, bigPath) == MF_ERROR_OKAY);
+
+	// Synchronous reads
+	{
+		mfmU64 size;
+		mfmU8 buffer[16];
+		mfmU64 readSize;
+		TEST_REQUIRE_PASS(mffGetFileSize(bigFile, &size) == MF_ERROR_OKAY && size == BIG_FILE_SIZE);
+		TEST_REQUIRE_PASS(mffReadFile(bigFile, 1000, buffer, sizeof(buffer), &readSize) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(readSize == sizeof(buffer) && memcmp(buffer, bigData + 1000, sizeof(buffer)) == 0);
+		TEST_REQUIRE_PASS(mffReadFile(bigFile, BIG_FILE_SIZE - 4, buffer, sizeof(buffer), &readSize) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(readSize == 4 && memcmp(buffer, bigData + BIG_FILE_SIZE - 4, 4) == 0);
+	}
+
+	// A batch of slices of the same file, with callbacks
+	static mfmU8 buffers[READ_COUNT][BIG_FILE_SIZE / READ_COUNT];
+	mffAsyncRead reads[READ_COUNT];
+	memset(reads, 0, sizeof(reads));
+	for (mfmU64 i = 0; i < READ_COUNT; ++i)
+	{
+		reads[i].file = bigFile;
+		reads[i].offset = i * sizeof(buffers[i]);
+		reads[i].size = sizeof(buffers[i]);
+		reads[i].buffer = buffers[i];
+		reads[i].callback = &Callback;
+		reads[i].userData = bigData;
+	}
+	TEST_REQUIRE_PASS(mffSubmitAsyncReads(reader, reads, READ_COUNT) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffWaitForAsyncReads(reads, READ_COUNT) == MF_ERROR_OKAY);
+	for (mfmU64 i = 0; i < READ_COUNT; ++i)
+	{
+		TEST_REQUIRE_PASS(mffIsAsyncReadDone(&reads[i]) == MFM_TRUE);
+		TEST_REQUIRE_PASS(reads[i].readSize == sizeof(buffers[i]));
+		TEST_REQUIRE_PASS(memcmp(buffers[i], bigData + reads[i].offset, sizeof(buffers[i])) == 0);
+	}
+
+	// Whole file by path, into a buffer allocated by the reader
+	{
+		mffAsyncRead read;
+		memset(&read, 0, sizeof(read));
+		read.path = testPath;
+		read.size = MFF_ASYNC_READ_TO_END;
+		TEST_REQUIRE_PASS(mffSubmitAsyncReads(reader, &read, 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffWaitForAsyncRead(&read) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(read.readSize == 5 && memcmp(read.buffer, u8"test\n", 5) == 0);
+		TEST_REQUIRE_PASS(mfmDeallocate(NULL, read.buffer) == MF_ERROR_OKAY);
+	}
+
+	// Mixed batch: whole file by path, read past the end, missing file
+	{
+		mffAsyncRead batch[3];
+		memset(batch, 0, sizeof(batch));
+		batch[0].path = bigPath;
+		batch[0].size = MFF_ASYNC_READ_TO_END;
+		batch[1].file = bigFile;
+		batch[1].offset = BIG_FILE_SIZE - 10;
+		batch[1].size = 100;
+		batch[1].buffer = buffers[0];
+		batch[2].path = missingPath;
+		batch[2].size = 10;
+		batch[2].buffer = buffers[1];
+		TEST_REQUIRE_PASS(mffSubmitAsyncReads(reader, batch, 3) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffWaitForAsyncReads(batch, 3) == MFF_ERROR_FILE_NOT_FOUND);
+
+		TEST_REQUIRE_PASS(batch[0].result == MF_ERROR_OKAY && batch[0].readSize == BIG_FILE_SIZE);
+		TEST_REQUIRE_PASS(memcmp(batch[0].buffer, bigData, BIG_FILE_SIZE) == 0);
+		TEST_REQUIRE_PASS(mfmDeallocate(NULL, batch[0].buffer) == MF_ERROR_OKAY);
+
+		TEST_REQUIRE_PASS(batch[1].result == MF_ERROR_OKAY && batch[1].readSize == 10);
+		TEST_REQUIRE_PASS(memcmp(buffers[0], bigData + BIG_FILE_SIZE - 10, 10) == 0);
+
+		TEST_REQUIRE_PASS(batch[2].result == MFF_ERROR_FILE_NOT_FOUND && batch[2].readSize == 0);
+	}
+
+	// Invalid reads are rejected before anything is submitted
+	{
+		mffAsyncRead read;
+		memset(&read, 0, sizeof(read));
+		TEST_REQUIRE_PASS(mffSubmitAsyncReads(reader, &read, 1) == MFF_ERROR_INVALID_ARGUMENTS);
+		read.file = bigFile;
+		read.buffer = buffers[0];
+		read.size = MFF_ASYNC_READ_TO_END;
+		TEST_REQUIRE_PASS(mffSubmitAsyncReads(reader, &read, 1) == MFF_ERROR_INVALID_ARGUMENTS);
+	}
+}
+
+static void CheckReaders(const mfsUTF8CodeUnit* dir)
+{
+	mffAsyncReader* reader;
+	mffEnum backend;
+
+	// Default backend (io_uring if available)
+	TEST_REQUIRE_PASS(mffCreateAsyncReader(&reader, NULL, NULL) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffGetAsyncReaderBackend(reader, &backend) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(backend == MFF_ASYNC_READER_THREADS || backend == MFF_ASYNC_READER_IO_URING);
+	callbackCount = 0;
+	Check(reader, dir);
+	mffDestroyAsyncReader(reader);
+
+	// Reads are marked as done before their callbacks are called, but the reader waits for the callbacks when destroyed
+	TEST_REQUIRE_PASS(callbackCount == READ_COUNT);
+
+	// Thread pool only
+	mffAsyncReaderDesc desc;
+	desc.threadCount = 2;
+	desc.queueSize = 0;
+	desc.backend = MFF_ASYNC_READER_THREADS;
+	TEST_REQUIRE_PASS(mffCreateAsyncReader(&reader, &desc, NULL) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffGetAsyncReaderBackend(reader, &backend) == MF_ERROR_OKAY && backend == MFF_ASYNC_READER_THREADS);
+	callbackCount = 0;
+	Check(reader, dir);
+	mffDestroyAsyncReader(reader);
+	TEST_REQUIRE_PASS(callbackCount == READ_COUNT);
+}
+
+static void CheckPacked(mffArchive* source, mffEnum flags)
+{
+	mfsStringBuilder builder;
+	TEST_REQUIRE_PASS(mfsCreateLocalStringBuilder(&builder, NULL) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffWritePackedArchive(&builder.base, source, flags, NULL) == MF_ERROR_OKAY);
+
+	const mfsUTF8CodeUnit* data;
+	mfmU64 size;
+	TEST_REQUIRE_PASS(mfsGetStringBuilderData(&builder.base, &data, &size) == MF_ERROR_OKAY);
+	FILE* file = fopen(TEST_FILE_PATH, "wb");
+	TEST_REQUIRE_PASS(file != NULL);
+	TEST_REQUIRE_PASS(fwrite(data, 1, size, file) == size);
+	fclose(file);
+	mfsDestroyLocalStringBuilder(&builder);
+
+	mffArchive* archive;
+	TEST_REQUIRE_PASS(mffCreatePackedArchive(&archive, NULL, TEST_FILE_PATH) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffRegisterArchive(archive, u8"packed") == MF_ERROR_OKAY);
+	CheckReaders(u8"/packed");
+	TEST_REQUIRE_PASS(mffUnregisterArchive(archive) == MF_ERROR_OKAY);
+
+	remove(TEST_FILE_PATH);
+}
+
+int main(int argc, const char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	for (mfmU64 i = 0; i < BIG_FILE_SIZE; ++i)
+		bigData[i] = (mfmU8)((i * 31) % 251);
+
+	mfsUTF8CodeUnit archivePath[256];
+	{
+		mfsStringStream ss;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, archivePath, sizeof(archivePath)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(&ss, mffMagmaRootDirectory) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(&ss, u8"/resources/FileSystem-Example") == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+	}
+
+	mffArchive* source;
+	TEST_REQUIRE_PASS(mffCreateFolderArchive(&source, NULL, archivePath) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffRegisterArchive(source, u8"test") == MF_ERROR_OKAY);
+
+	mffDirectory* dir;
+	mffFile* bigFile;
+	TEST_REQUIRE_PASS(mffCreateDirectory(&dir, u8"/test/asyncReaderTest") == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffCreateFile(&bigFile, u8"/test/asyncReaderTest/big.bin") == MF_ERROR_OKAY);
+	{
+		mfsStream* stream;
+		TEST_REQUIRE_PASS(mffOpenFile(&stream, bigFile, MFF_FILE_WRITE) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsWrite(stream, bigData, BIG_FILE_SIZE, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+	}
+
+	// Folder archive
+	CheckReaders(u8"/test");
+
+	// Stored and compressed packed archives
+	CheckPacked(source, 0);
+	CheckPacked(source, MFF_PACKED_ARCHIVE_DEFLATE);
+
+	TEST_REQUIRE_PASS(mffDeleteFile(bigFile) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffDeleteDirectory(dir) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffUnregisterArchive(source) == MF_ERROR_OKAY);
+
+	mfTerminate();
+	EXIT_PASS();
+}
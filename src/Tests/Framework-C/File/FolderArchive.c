@@ -0,0 +1,123 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/File/FolderArchive.h>
+#include <Magma/Framework/File/Path.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.h>
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#define rmdir(path) _rmdir(path)
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define FILE_COUNT 300
+
+// The files created by the test go to a folder in the working directory, so the resources folder isn't touched
+#define TEST_FOLDER_PATH u8"FolderArchive.tmp"
+
+int main(int argc, const char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	mfsUTF8CodeUnit archivePath[256];
+	{
+		mfsStringStream ss;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, archivePath, sizeof(archivePath)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(&ss, mffMagmaRootDirectory) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(&ss, u8"/resources/FileSystem-Example") == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+	}
+
+	mffArchive* archive;
+	TEST_REQUIRE_PASS(mffCreateFolderArchive(&archive, NULL, archivePath) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffRegisterArchive(archive, u8"test") == MF_ERROR_OKAY);
+
+	// Files which already exist are indexed when the archive is created
+	mffFile* file = NULL;
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/test/dir/test.txt") == MF_ERROR_OKAY);
+	mffEnum type;
+	TEST_REQUIRE_PASS(mffGetFileType(file, &type) == MF_ERROR_OKAY && type == MFF_FILE);
+
+	// Open streams and file references may outlive the archive
+	{
+		mfsStream* stream;
+		TEST_REQUIRE_PASS(mfmAcquireObject(&file->object) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffOpenFile(&stream, file, MFF_FILE_READ) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffUnregisterArchive(archive) == MF_ERROR_OKAY);
+		mfmU8 byte;
+		TEST_REQUIRE_PASS(mfsRead(stream, &byte, 1, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmReleaseObject(&file->object) == MF_ERROR_OKAY);
+	}
+
+	// The folder may be left over from an interrupted run
+	mkdir(TEST_FOLDER_PATH, 0777);
+	TEST_REQUIRE_PASS(mffCreateFolderArchive(&archive, NULL, TEST_FOLDER_PATH) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffRegisterArchive(archive, u8"test") == MF_ERROR_OKAY);
+
+	mffDirectory* dir;
+	TEST_REQUIRE_PASS(mffCreateDirectory(&dir, u8"/test/folderArchiveTest") == MF_ERROR_OKAY);
+	TEST_REQUIRE_FAIL(mffCreateDirectory(NULL, u8"/test/folderArchiveTest") == MF_ERROR_OKAY);
+
+	// Create enough files to make the index grow
+	mffFile* files[FILE_COUNT];
+	mfsUTF8CodeUnit path[64];
+	for (mfmU32 i = 0; i < FILE_COUNT; ++i)
+	{
+		mfsStringStream ss;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, path, sizeof(path)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintFormat(&ss, u8"/test/folderArchiveTest/%d.txt", i) == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+		TEST_REQUIRE_PASS(mffCreateFile(&files[i], path) == MF_ERROR_OKAY);
+	}
+
+	for (mfmU32 i = 0; i < FILE_COUNT; ++i)
+	{
+		mfsStringStream ss;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, path, sizeof(path)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintFormat(&ss, u8"/test/folderArchiveTest/%d.txt", i) == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+
+		mffFile* file = NULL;
+		TEST_REQUIRE_PASS(mffGetFile(&file, path) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(file == files[i]);
+	}
+
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/test/folderArchiveTest") == MF_ERROR_OKAY && file == dir);
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/test/folderArchiveTest/missing.txt") == MFF_ERROR_FILE_NOT_FOUND);
+
+	// Write and read back through a mapped stream
+	{
+		mfsStream* stream;
+		TEST_REQUIRE_PASS(mffOpenFile(&stream, files[0], MFF_FILE_WRITE) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(stream, u8"test\n") == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+
+		TEST_REQUIRE_PASS(mffOpenFile(&stream, files[0], MFF_FILE_READ_MAPPED) == MF_ERROR_OKAY);
+		const mfmU8* span;
+		mfmU64 spanSize;
+		TEST_REQUIRE_PASS(mfsGetSpan(stream, MFM_U64_MAX, &span, &spanSize) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(spanSize == 5 && memcmp(span, u8"test\n", 5) == 0);
+		TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+	}
+
+	// The directory can only be deleted once it is empty
+	TEST_REQUIRE_PASS(mffDeleteDirectory(dir) == MFF_ERROR_MUST_BE_EMPTY);
+	for (mfmU32 i = 0; i < FILE_COUNT; ++i)
+		TEST_REQUIRE_PASS(mffDeleteFile(files[i]) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/test/folderArchiveTest/0.txt") == MFF_ERROR_FILE_NOT_FOUND);
+	TEST_REQUIRE_PASS(mffDeleteDirectory(dir) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/test/folderArchiveTest") == MFF_ERROR_FILE_NOT_FOUND);
+
+	TEST_REQUIRE_PASS(mffUnregisterArchive(archive) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(rmdir(TEST_FOLDER_PATH) == 0);
+
+	mfTerminate();
+	EXIT_PASS();
+}
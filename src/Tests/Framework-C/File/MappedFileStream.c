@@ -0,0 +1,83 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/File/MappedFileStream.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_FILE_PATH u8"MappedFileStream.tmp"
+
+int main()
+{
+	mfmU8 data[1000];
+	for (mfmU64 i = 0; i < sizeof(data); ++i)
+		data[i] = (mfmU8)(i * 7);
+
+	FILE* file = fopen(TEST_FILE_PATH, "wb");
+	TEST_REQUIRE_PASS(file != NULL);
+	TEST_REQUIRE_PASS(fwrite(data, 1, sizeof(data), file) == sizeof(data));
+	fclose(file);
+
+	// Reading and seeking
+	{
+		mffMappedFileStream mapped;
+		TEST_REQUIRE_PASS(mffCreateLocalMappedFileStream(&mapped, TEST_FILE_PATH) == MF_ERROR_OKAY);
+		mfsStream* stream = (mfsStream*)&mapped;
+
+		TEST_REQUIRE_FAIL(mfsWrite(stream, data, 1, NULL) == MF_ERROR_OKAY);
+
+		mfmU8 read[1000];
+		mfmU64 readSize = 0;
+		TEST_REQUIRE_PASS(mfsRead(stream, read, 600, &readSize) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(readSize == 600 && memcmp(read, data, 600) == 0);
+		TEST_REQUIRE_PASS(mfsRead(stream, read, 600, &readSize) == MFS_ERROR_EOF);
+		TEST_REQUIRE_PASS(readSize == 400 && memcmp(read, data + 600, 400) == 0);
+
+		mfmBool eof = MFM_FALSE;
+		TEST_REQUIRE_PASS(mfsEOF(stream, &eof) == MF_ERROR_OKAY && eof == MFM_TRUE);
+
+		mfmU64 position = 0;
+		TEST_REQUIRE_PASS(mfsSeekBegin(stream, 10) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsSeekHead(stream, 5) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsTell(stream, &position) == MF_ERROR_OKAY && position == 15);
+		TEST_REQUIRE_PASS(mfsSeekHead(stream, -15) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfsSeekHead(stream, -1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsSeekEnd(stream, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsTell(stream, &position) == MF_ERROR_OKAY && position == 999);
+		TEST_REQUIRE_FAIL(mfsSeekBegin(stream, 1001) == MF_ERROR_OKAY);
+
+		// Spans point into the mapping and advance the head
+		const mfmU8* span = NULL;
+		mfmU64 spanSize = 0;
+		TEST_REQUIRE_PASS(mfsSeekBegin(stream, 100) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsGetSpan(stream, 50, &span, &spanSize) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(spanSize == 50 && span == mapped.data + 100 && memcmp(span, data + 100, 50) == 0);
+		TEST_REQUIRE_PASS(mfsGetSpan(stream, MFM_U64_MAX, &span, &spanSize) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(spanSize == 850 && memcmp(span, data + 150, 850) == 0);
+		TEST_REQUIRE_PASS(mfsGetSpan(stream, MFM_U64_MAX, &span, &spanSize) == MFS_ERROR_EOF);
+
+		mffDestroyLocalMappedFileStream(&mapped);
+	}
+
+	// Empty files have no mapping
+	{
+		file = fopen(TEST_FILE_PATH, "wb");
+		TEST_REQUIRE_PASS(file != NULL);
+		fclose(file);
+
+		mffMappedFileStream mapped;
+		TEST_REQUIRE_PASS(mffCreateLocalMappedFileStream(&mapped, TEST_FILE_PATH) == MF_ERROR_OKAY);
+		mfmU8 read[4];
+		mfmU64 readSize = 1;
+		TEST_REQUIRE_PASS(mfsRead((mfsStream*)&mapped, read, sizeof(read), &readSize) == MFS_ERROR_EOF);
+		TEST_REQUIRE_PASS(readSize == 0);
+		mffDestroyLocalMappedFileStream(&mapped);
+	}
+
+	remove(TEST_FILE_PATH);
+
+	mffMappedFileStream mapped;
+	TEST_REQUIRE_PASS(mffCreateLocalMappedFileStream(&mapped, u8"MappedFileStream.missing") == MFF_ERROR_FILE_NOT_FOUND);
+
+	EXIT_PASS();
+}
@@ -0,0 +1,186 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/File/FolderArchive.h>
+#include <Magma/Framework/File/PackedArchive.h>
+#include <Magma/Framework/File/Path.h>
+#include <Magma/Framework/String/StringBuilder.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_FILE_PATH u8"PackedArchive.tmp"
+#define BIG_FILE_SIZE 10000
+
+static mfmU8 bigData[BIG_FILE_SIZE];
+
+static mfmU64 Pack(mffArchive* source, mffEnum flags)
+{
+	mfsStringBuilder builder;
+	TEST_REQUIRE_PASS(mfsCreateLocalStringBuilder(&builder, NULL) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffWritePackedArchive(&builder.base, source, flags, NULL) == MF_ERROR_OKAY);
+
+	const mfsUTF8CodeUnit* data;
+	mfmU64 size;
+	TEST_REQUIRE_PASS(mfsGetStringBuilderData(&builder.base, &data, &size) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(size % MFF_PACKED_ARCHIVE_ALIGNMENT == 0);
+
+	FILE* file = fopen(TEST_FILE_PATH, "wb");
+	TEST_REQUIRE_PASS(file != NULL);
+	TEST_REQUIRE_PASS(fwrite(data, 1, size, file) == size);
+	fclose(file);
+
+	mfsDestroyLocalStringBuilder(&builder);
+	return size;
+}
+
+static void Check(void)
+{
+	mffArchive* archive;
+	TEST_REQUIRE_PASS(mffCreatePackedArchive(&archive, NULL, TEST_FILE_PATH) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffRegisterArchive(archive, u8"packed") == MF_ERROR_OKAY);
+
+	// Lookups and navigation
+	mffFile* file;
+	mffDirectory* dir;
+	mffEnum type;
+	const mfsUTF8CodeUnit* path;
+	TEST_REQUIRE_PASS(mffGetFile(&dir, u8"/packed/dir") == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffGetFileType(dir, &type) == MF_ERROR_OKAY && type == MFF_DIRECTORY);
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/packed/dir/test.txt") == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffGetFileType(file, &type) == MF_ERROR_OKAY && type == MFF_FILE);
+	TEST_REQUIRE_PASS(mffGetFilePath(&path, file) == MF_ERROR_OKAY && strcmp(path, u8"/dir/test.txt") == 0);
+	mffDirectory* parent;
+	TEST_REQUIRE_PASS(mffGetParent(&parent, file) == MF_ERROR_OKAY && parent == dir);
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/packed/dir/missing.txt") == MFF_ERROR_FILE_NOT_FOUND);
+
+	mfmU32 count = 0;
+	TEST_REQUIRE_PASS(mffGetFirstFile(&file, dir) == MF_ERROR_OKAY);
+	while (file != NULL)
+	{
+		++count;
+		TEST_REQUIRE_PASS(mffGetNextFile(&file, file) == MF_ERROR_OKAY);
+	}
+	TEST_REQUIRE_PASS(count == 1);
+
+	// Packed archives are read only
+	TEST_REQUIRE_PASS(mffCreateFile(&file, u8"/packed/new.txt") == MFF_ERROR_NOT_SUPPORTED);
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/packed/packedArchiveTest/empty.txt") == MF_ERROR_OKAY);
+	mfsStream* stream;
+	TEST_REQUIRE_PASS(mffOpenFile(&stream, file, MFF_FILE_WRITE) == MFF_ERROR_INVALID_MODE);
+	TEST_REQUIRE_PASS(mffOpenFile(&stream, dir, MFF_FILE_READ) == MFF_ERROR_NOT_A_FILE);
+
+	// Empty files
+	mfmU8 read[BIG_FILE_SIZE + 1];
+	mfmU64 readSize = 1;
+	TEST_REQUIRE_PASS(mffOpenFile(&stream, file, MFF_FILE_READ) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mfsRead(stream, read, sizeof(read), &readSize) == MFS_ERROR_EOF && readSize == 0);
+	TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+
+	// File contents
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/packed/dir/test.txt") == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffOpenFile(&stream, file, MFF_FILE_READ) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mfsRead(stream, read, sizeof(read), &readSize) == MFS_ERROR_EOF);
+	TEST_REQUIRE_PASS(readSize == 5 && memcmp(read, u8"test\n", 5) == 0);
+	TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+
+	TEST_REQUIRE_PASS(mffGetFile(&file, u8"/packed/packedArchiveTest/big.bin") == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffOpenFile(&stream, file, MFF_FILE_READ_MAPPED) == MF_ERROR_OKAY);
+	const mfmU8* span;
+	mfmU64 spanSize;
+	TEST_REQUIRE_PASS(mfsGetSpan(stream, MFM_U64_MAX, &span, &spanSize) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(spanSize == BIG_FILE_SIZE && memcmp(span, bigData, BIG_FILE_SIZE) == 0);
+	TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+
+	TEST_REQUIRE_PASS(mffUnregisterArchive(archive) == MF_ERROR_OKAY);
+}
+
+int main(int argc, const char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	for (mfmU64 i = 0; i < BIG_FILE_SIZE; ++i)
+		bigData[i] = (mfmU8)(i % 7);
+
+	mfsUTF8CodeUnit archivePath[256];
+	{
+		mfsStringStream ss;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, archivePath, sizeof(archivePath)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(&ss, mffMagmaRootDirectory) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(&ss, u8"/resources/FileSystem-Example") == MF_ERROR_OKAY);
+		mfsDestroyLocalStringStream(&ss);
+	}
+
+	mffArchive* source;
+	TEST_REQUIRE_PASS(mffCreateFolderArchive(&source, NULL, archivePath) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffRegisterArchive(source, u8"test") == MF_ERROR_OKAY);
+
+	// Add an empty file and a file which can be compressed to the source archive
+	mffDirectory* dir;
+	mffFile* emptyFile;
+	mffFile* bigFile;
+	TEST_REQUIRE_PASS(mffCreateDirectory(&dir, u8"/test/packedArchiveTest") == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffCreateFile(&emptyFile, u8"/test/packedArchiveTest/empty.txt") == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffCreateFile(&bigFile, u8"/test/packedArchiveTest/big.bin") == MF_ERROR_OKAY);
+	{
+		mfsStream* stream;
+		TEST_REQUIRE_PASS(mffOpenFile(&stream, bigFile, MFF_FILE_WRITE) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsWrite(stream, bigData, BIG_FILE_SIZE, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mffCloseFile(stream) == MF_ERROR_OKAY);
+	}
+
+	// Stored
+	mfmU64 storedSize = Pack(source, 0);
+	Check();
+
+	// Compressed
+	mfmU64 compressedSize = Pack(source, MFF_PACKED_ARCHIVE_DEFLATE);
+	TEST_REQUIRE_PASS(compressedSize < storedSize);
+	Check();
+
+	// Compressed with the LZ codec
+	mfmU64 lzSize = Pack(source, MFF_PACKED_ARCHIVE_LZ);
+	TEST_REQUIRE_PASS(lzSize < storedSize);
+	Check();
+
+	// Corrupted archives are rejected
+	{
+		// Makes the first entry its own next sibling
+		FILE* file = fopen(TEST_FILE_PATH, "r+b");
+		TEST_REQUIRE_PASS(file != NULL);
+		mfmU8 footer[64];
+		TEST_REQUIRE_PASS(fseek(file, -64, SEEK_END) == 0);
+		TEST_REQUIRE_PASS(fread(footer, 1, sizeof(footer), file) == sizeof(footer));
+		long entriesOffset = 0;
+		for (mfmU64 i = 0; i < 4; ++i)
+			entriesOffset |= (long)footer[16 + i] << (8 * i);
+		const mfmU8 cycle[4] = { 0, 0, 0, 0 };
+		TEST_REQUIRE_PASS(fseek(file, entriesOffset + 52, SEEK_SET) == 0);
+		TEST_REQUIRE_PASS(fwrite(cycle, 1, sizeof(cycle), file) == sizeof(cycle));
+		fclose(file);
+
+		mffArchive* archive;
+		TEST_REQUIRE_PASS(mffCreatePackedArchive(&archive, NULL, TEST_FILE_PATH) == MFF_ERROR_INVALID_ARCHIVE);
+	}
+	{
+		FILE* file = fopen(TEST_FILE_PATH, "r+b");
+		TEST_REQUIRE_PASS(file != NULL);
+		TEST_REQUIRE_PASS(fseek(file, -64, SEEK_END) == 0);
+		TEST_REQUIRE_PASS(fputc('X', file) == 'X');
+		fclose(file);
+
+		mffArchive* archive;
+		TEST_REQUIRE_PASS(mffCreatePackedArchive(&archive, NULL, TEST_FILE_PATH) == MFF_ERROR_INVALID_ARCHIVE);
+	}
+
+	remove(TEST_FILE_PATH);
+
+	TEST_REQUIRE_PASS(mffDeleteFile(bigFile) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffDeleteFile(emptyFile) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffDeleteDirectory(dir) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mffUnregisterArchive(source) == MF_ERROR_OKAY);
+
+	mfTerminate();
+	EXIT_PASS();
+}
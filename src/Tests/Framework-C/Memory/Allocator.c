@@ -0,0 +1,62 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Memory/Allocator.h>
+#include <Magma/Framework/Memory/TrackingAllocator.h>
+#include <Magma/Framework/Entry.h>
+
+#include <string.h>
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	TEST_REQUIRE_PASS(mfmGetPageSize() != 0);
+	TEST_REQUIRE_PASS(mfmGetHugePageSize() >= mfmGetPageSize());
+
+	// Default allocator
+	{
+		void* mem = NULL;
+		TEST_REQUIRE_FAIL(mfmAllocateAligned(NULL, &mem, 64, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmAllocateAligned(NULL, &mem, 64, 48) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmAllocateAligned(NULL, &mem, 0, 64) == MF_ERROR_OKAY);
+
+		mfmU64 alignments[] = { 1, 2, 16, 64, 1024, mfmGetPageSize(), mfmGetHugePageSize() };
+		for (mfmU64 i = 0; i < sizeof(alignments) / sizeof(*alignments); ++i)
+		{
+			TEST_REQUIRE_PASS(mfmAllocateAligned(NULL, &mem, 100, alignments[i]) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS((mfmU64)mem % alignments[i] == 0);
+			memset(mem, 0xAB, 100);
+			TEST_REQUIRE_PASS(mfmDeallocateAligned(NULL, mem) == MF_ERROR_OKAY);
+		}
+	}
+
+	// Allocator without native aligned allocation
+	{
+		mfmTrackingAllocatorDesc desc;
+		desc.backingAllocator = NULL;
+		desc.traceStream = NULL;
+		desc.threadSafe = MFM_FALSE;
+
+		mfmTrackingAllocator* allocator = NULL;
+		TEST_REQUIRE_PASS(mfmCreateTrackingAllocator(&allocator, &desc) == MF_ERROR_OKAY);
+
+		void* mem = NULL;
+		mfmU64 alignments[] = { 1, 8, 256, 512, mfmGetPageSize() };
+		for (mfmU64 i = 0; i < sizeof(alignments) / sizeof(*alignments); ++i)
+		{
+			TEST_REQUIRE_PASS(mfmAllocateAligned(allocator, &mem, 100, alignments[i]) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS((mfmU64)mem % alignments[i] == 0);
+			memset(mem, 0xAB, 100);
+			TEST_REQUIRE_PASS(mfmDeallocateAligned(allocator, mem) == MF_ERROR_OKAY);
+		}
+
+		mfmTrackingStats stats;
+		TEST_REQUIRE_PASS(mfmTrackingGetStats(allocator, &stats) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(stats.liveAllocationCount == 0);
+
+		mfmDestroyTrackingAllocator(allocator);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
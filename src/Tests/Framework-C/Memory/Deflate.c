@@ -0,0 +1,250 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Memory/Deflate.h>
+#include <Magma/Framework/Memory/Inflate.h>
+#include <Magma/Framework/Thread/JobSystem.h>
+#include <Magma/Framework/Entry.h>
+
+#include <string.h>
+
+#define DATA_SIZE (256 * 1024)
+#define WRITE_SIZE 13
+
+static mfmU8 data[DATA_SIZE];
+static mfmU8 compressed[2 * DATA_SIZE];
+static mfmU8 decompressed[DATA_SIZE];
+
+// Reads all the data left on a stream to the end of a buffer
+static void Drain(mfsStream* stream, mfmU8* out, mfmU64 outSize, mfmU64* size)
+{
+	for (;;)
+	{
+		mfmU64 readSize = 0;
+		mfError err = mfsRead(stream, out + *size, outSize - *size, &readSize);
+		TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFS_ERROR_EOF);
+		*size += readSize;
+		if (readSize == 0)
+			break;
+	}
+}
+
+// Compresses the data with many small writes through a small buffer, and returns the compressed size
+static mfmU64 CompressWithStream(mfmU64 bufferSize)
+{
+	mfmU8 buffer[4096];
+	mfsStream* stream;
+	TEST_REQUIRE_PASS(mfmCreateDeflateStream(&stream, buffer, bufferSize, MFM_BEST_COMPRESSION, NULL) == MF_ERROR_OKAY);
+
+	mfmU64 size = 0;
+	mfmU64 offset = 0;
+	while (offset < DATA_SIZE)
+	{
+		mfmU64 writeSize;
+		mfError err = mfsWrite(stream, data + offset, DATA_SIZE - offset < WRITE_SIZE ? DATA_SIZE - offset : WRITE_SIZE, &writeSize);
+		if (err == MFM_ERROR_BUFFER_FULL)
+		{
+			TEST_REQUIRE_PASS(writeSize == 0);
+			Drain(stream, compressed, sizeof(compressed), &size);
+		}
+		else
+			TEST_REQUIRE_PASS(err == MF_ERROR_OKAY);
+		offset += writeSize;
+	}
+
+	// Finishing may need the buffer to be emptied more than once
+	mfError err;
+	while ((err = mfmFinishDeflateStream(stream)) == MFM_ERROR_BUFFER_FULL)
+		Drain(stream, compressed, sizeof(compressed), &size);
+	TEST_REQUIRE_PASS(err == MF_ERROR_OKAY);
+	Drain(stream, compressed, sizeof(compressed), &size);
+
+	// Nothing can be written after the stream is finished
+	TEST_REQUIRE_FAIL(mfsWrite(stream, data, 1, NULL) == MF_ERROR_OKAY);
+	mfmDestroyDeflateStream(stream);
+	return size;
+}
+
+static void DecompressWithStream(mfmU64 compressedSize, mfmU64 bufferSize)
+{
+	mfmU8 buffer[4096];
+	mfsStream* stream;
+	TEST_REQUIRE_PASS(mfmCreateInflateStream(&stream, buffer, bufferSize, NULL) == MF_ERROR_OKAY);
+
+	mfmU64 size = 0;
+	mfmU64 offset = 0;
+	mfmBool eof = MFM_FALSE;
+	while (offset < compressedSize)
+	{
+		mfmU64 writeSize;
+		mfError err = mfsWrite(stream, compressed + offset, compressedSize - offset < 100 ? compressedSize - offset : 100, &writeSize);
+		TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFM_ERROR_BUFFER_FULL);
+		offset += writeSize;
+
+		// Alternate between copying reads and zero copy spans
+		if ((offset / 100) % 2 == 0)
+			Drain(stream, decompressed, sizeof(decompressed), &size);
+		else
+			for (;;)
+			{
+				const mfmU8* span;
+				mfmU64 spanSize;
+				err = mfsGetSpan(stream, sizeof(decompressed) - size, &span, &spanSize);
+				TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFS_ERROR_EOF);
+				if (err == MFS_ERROR_EOF || spanSize == 0)
+					break;
+				memcpy(decompressed + size, span, spanSize);
+				size += spanSize;
+			}
+	}
+	Drain(stream, decompressed, sizeof(decompressed), &size);
+
+	TEST_REQUIRE_PASS(mfsEOF(stream, &eof) == MF_ERROR_OKAY && eof == MFM_TRUE);
+	TEST_REQUIRE_PASS(mfsRead(stream, decompressed, 1, NULL) == MFS_ERROR_EOF);
+	TEST_REQUIRE_PASS(mfsWrite(stream, compressed, 1, NULL) == MFS_ERROR_EOF);
+	TEST_REQUIRE_PASS(size == DATA_SIZE);
+	TEST_REQUIRE_PASS(memcmp(decompressed, data, DATA_SIZE) == 0);
+	mfmDestroyInflateStream(stream);
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	// Compressible data with some noise
+	mfmU32 seed = 1234;
+	for (mfmU64 i = 0; i < DATA_SIZE; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		data[i] = (i % 1000 < 900) ? (mfmU8)(i % 61) : (mfmU8)(seed >> 24);
+	}
+
+	mfmU64 oneShotSize;
+	TEST_REQUIRE_PASS(mfmDeflate(data, DATA_SIZE, compressed, sizeof(compressed), &oneShotSize, MFM_BEST_COMPRESSION, NULL) == MF_ERROR_OKAY);
+
+	// Small writes compress about as well as a single big one, since they aren't flushed
+	{
+		mfmU64 streamSize = CompressWithStream(4096);
+		TEST_REQUIRE_PASS(streamSize <= oneShotSize + oneShotSize / 20 + 64);
+
+		mfmU64 decompressedSize;
+		TEST_REQUIRE_PASS(mfmInflate(compressed, streamSize, decompressed, sizeof(decompressed), &decompressedSize, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(decompressedSize == DATA_SIZE && memcmp(decompressed, data, DATA_SIZE) == 0);
+
+		DecompressWithStream(streamSize, 4096);
+
+		// Buffers which are smaller than the writes wrap around constantly
+		memset(decompressed, 0, sizeof(decompressed));
+		DecompressWithStream(streamSize, 37);
+	}
+
+	// Small buffers fill up and wrap around
+	{
+		mfmU64 streamSize = CompressWithStream(61);
+		mfmU64 decompressedSize;
+		TEST_REQUIRE_PASS(mfmInflate(compressed, streamSize, decompressed, sizeof(decompressed), &decompressedSize, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(decompressedSize == DATA_SIZE && memcmp(decompressed, data, DATA_SIZE) == 0);
+	}
+
+	// Flushing makes the data written so far available, without ending the stream
+	{
+		mfmU8 buffer[1024];
+		mfmU8 inflateBuffer[1024];
+		mfsStream* deflateStream;
+		mfsStream* inflateStream;
+		TEST_REQUIRE_PASS(mfmCreateDeflateStream(&deflateStream, buffer, sizeof(buffer), MFM_BEST_COMPRESSION, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmCreateInflateStream(&inflateStream, inflateBuffer, sizeof(inflateBuffer), NULL) == MF_ERROR_OKAY);
+
+		for (mfmU64 i = 0; i < 4; ++i)
+		{
+			TEST_REQUIRE_PASS(mfsWrite(deflateStream, data + i * 100, 100, NULL) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mfsFlush(deflateStream) == MF_ERROR_OKAY);
+
+			mfmU64 size = 0;
+			Drain(deflateStream, compressed, sizeof(compressed), &size);
+			TEST_REQUIRE_PASS(size > 0);
+			TEST_REQUIRE_PASS(mfsWrite(inflateStream, compressed, size, NULL) == MF_ERROR_OKAY);
+
+			mfmU64 readSize;
+			TEST_REQUIRE_PASS(mfsRead(inflateStream, decompressed, sizeof(decompressed), &readSize) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(readSize == 100 && memcmp(decompressed, data + i * 100, 100) == 0);
+		}
+
+		mfmDestroyInflateStream(inflateStream);
+		mfmDestroyDeflateStream(deflateStream);
+	}
+
+	// Block compressed frames
+	{
+		mftJobSystemDesc desc;
+		desc.workerCount = 2;
+		desc.queueSize = 0;
+		desc.jobCapacity = 0;
+		mftJobSystem* jobSystem;
+		TEST_REQUIRE_PASS(mftCreateJobSystem(&jobSystem, &desc, NULL) == MF_ERROR_OKAY);
+
+		const mfmU64 blockSize = 10000;
+		mfmU64 bound = mfmGetDeflateBlocksBound(DATA_SIZE, blockSize);
+		TEST_REQUIRE_PASS(bound <= sizeof(compressed));
+
+		mfmU64 serialSize, parallelSize;
+		TEST_REQUIRE_PASS(mfmDeflateBlocks(data, DATA_SIZE, compressed, sizeof(compressed), &serialSize, blockSize, MFM_BEST_COMPRESSION, NULL, NULL) == MF_ERROR_OKAY);
+		static mfmU8 parallel[2 * DATA_SIZE];
+		TEST_REQUIRE_PASS(mfmDeflateBlocks(data, DATA_SIZE, parallel, sizeof(parallel), &parallelSize, blockSize, MFM_BEST_COMPRESSION, jobSystem, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(serialSize == parallelSize && memcmp(compressed, parallel, serialSize) == 0);
+		TEST_REQUIRE_PASS(mfmDeflateBlocks(data, DATA_SIZE, parallel, serialSize - 1, &parallelSize, blockSize, MFM_BEST_COMPRESSION, jobSystem, NULL) == MFM_ERROR_BUFFER_FULL);
+		TEST_REQUIRE_PASS(mfmDeflateBlocks(data, DATA_SIZE, parallel, sizeof(parallel), &parallelSize, MFM_DEFLATE_BLOCKS_MAX_BLOCK_SIZE + 1, MFM_BEST_COMPRESSION, NULL, NULL) == MFM_ERROR_INVALID_ARGUMENTS);
+
+		mfmU64 size;
+		TEST_REQUIRE_PASS(mfmGetInflateBlocksSize(compressed, serialSize, &size) == MF_ERROR_OKAY && size == DATA_SIZE);
+
+		memset(decompressed, 0, sizeof(decompressed));
+		TEST_REQUIRE_PASS(mfmInflateBlocks(compressed, serialSize, decompressed, sizeof(decompressed), &size, jobSystem, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(size == DATA_SIZE && memcmp(decompressed, data, DATA_SIZE) == 0);
+		memset(decompressed, 0, sizeof(decompressed));
+		TEST_REQUIRE_PASS(mfmInflateBlocks(compressed, serialSize, decompressed, sizeof(decompressed), &size, NULL, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(size == DATA_SIZE && memcmp(decompressed, data, DATA_SIZE) == 0);
+		TEST_REQUIRE_PASS(mfmInflateBlocks(compressed, serialSize, decompressed, DATA_SIZE - 1, &size, NULL, NULL) == MFM_ERROR_BUFFER_FULL);
+
+		// Ranges inside a block, across blocks, on block boundaries and at the end
+		const mfmU64 ranges[][2] = { { 0, 1 }, { 5, 100 }, { 9990, 20 }, { 10000, 10000 }, { 12345, 45678 }, { DATA_SIZE - 7, 7 }, { 0, DATA_SIZE } };
+		for (mfmU64 i = 0; i < sizeof(ranges) / sizeof(ranges[0]); ++i)
+		{
+			memset(decompressed, 0, sizeof(decompressed));
+			TEST_REQUIRE_PASS(mfmInflateBlocksRange(compressed, serialSize, ranges[i][0], decompressed, ranges[i][1], NULL) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(memcmp(decompressed, data + ranges[i][0], ranges[i][1]) == 0);
+		}
+		TEST_REQUIRE_PASS(mfmInflateBlocksRange(compressed, serialSize, DATA_SIZE - 7, decompressed, 8, NULL) == MFM_ERROR_INVALID_ARGUMENTS);
+
+		// Empty data
+		TEST_REQUIRE_PASS(mfmDeflateBlocks(data, 0, parallel, sizeof(parallel), &parallelSize, 0, MFM_BEST_COMPRESSION, jobSystem, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmInflateBlocks(parallel, parallelSize, decompressed, sizeof(decompressed), &size, jobSystem, NULL) == MF_ERROR_OKAY && size == 0);
+
+		// Corrupted and truncated frames are rejected
+		TEST_REQUIRE_PASS(mfmInflateBlocks(compressed, serialSize - 1, decompressed, sizeof(decompressed), &size, jobSystem, NULL) != MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmInflateBlocks(compressed, 40, decompressed, sizeof(decompressed), &size, NULL, NULL) == MFM_ERROR_INTERNAL);
+		memcpy(parallel, compressed, serialSize);
+		parallel[0] = 'X';
+		TEST_REQUIRE_PASS(mfmGetInflateBlocksSize(parallel, serialSize, &size) == MFM_ERROR_INTERNAL);
+		memcpy(parallel, compressed, serialSize);
+		parallel[MFM_DEFLATE_BLOCKS_HEADER_SIZE + 8] ^= 0x01;
+		TEST_REQUIRE_PASS(mfmInflateBlocks(parallel, serialSize, decompressed, sizeof(decompressed), &size, jobSystem, NULL) == MFM_ERROR_INTERNAL);
+
+		// A single empty block of 2^40 bytes, rejected before a temporary buffer of that size is allocated
+		{
+			mfmU64 fields[] = { (mfmU64)1 << 40, (mfmU64)1 << 40, 1, MFM_DEFLATE_BLOCKS_HEADER_SIZE + 16, MFM_DEFLATE_BLOCKS_HEADER_SIZE + 16 };
+			memset(parallel, 0, MFM_DEFLATE_BLOCKS_HEADER_SIZE + 16);
+			memcpy(parallel, u8"MFDB", 4);
+			parallel[4] = MFM_DEFLATE_BLOCKS_VERSION;
+			for (mfmU64 i = 0; i < sizeof(fields) / sizeof(fields[0]); ++i)
+				for (mfmU64 j = 0; j < 8; ++j)
+					parallel[8 + i * 8 + j] = (mfmU8)(fields[i] >> (j * 8));
+			TEST_REQUIRE_PASS(mfmInflateBlocksRange(parallel, MFM_DEFLATE_BLOCKS_HEADER_SIZE + 16, 1, decompressed, 1, NULL) == MFM_ERROR_INTERNAL);
+			TEST_REQUIRE_PASS(mfmGetInflateBlocksSize(parallel, MFM_DEFLATE_BLOCKS_HEADER_SIZE + 16, &size) == MFM_ERROR_INTERNAL);
+		}
+
+		TEST_REQUIRE_PASS(mftDestroyJobSystem(jobSystem) == MF_ERROR_OKAY);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
@@ -0,0 +1,60 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Memory/FrameAllocator.h>
+#include <Magma/Framework/Entry.h>
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	{
+		mfmFrameAllocator* frame = NULL;
+
+		TEST_REQUIRE_FAIL(mfmCreateFrameAllocator(&frame, 64, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmCreateFrameAllocator(&frame, 64, MFM_FRAME_ALLOCATOR_MAX_ARENAS + 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmCreateFrameAllocator(&frame, 64, 2) == MF_ERROR_OKAY);
+
+		// Frame 0
+		mfmU8* v0 = NULL;
+		mfmU8* v1 = NULL;
+		TEST_REQUIRE_PASS(mfmAllocate(frame, &v0, 3) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocate(frame, &v1, 3) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS((mfmU64)v0 % MFM_FRAME_ALLOCATOR_DEFAULT_ALIGNMENT == 0);
+		TEST_REQUIRE_PASS((mfmU64)v1 % MFM_FRAME_ALLOCATOR_DEFAULT_ALIGNMENT == 0);
+		TEST_REQUIRE_PASS(mfmDeallocate(frame, v1) == MF_ERROR_OKAY);
+		*v0 = 7;
+		TEST_REQUIRE_PASS(mfmFrameEnd(frame) == MF_ERROR_OKAY);
+
+		// Frame 1, the data from frame 0 is still alive
+		mfmU8* v2 = NULL;
+		TEST_REQUIRE_PASS(mfmFrameAllocateAligned(frame, &v2, 32, 32) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS((mfmU64)v2 % 32 == 0);
+		TEST_REQUIRE_FAIL(mfmFrameAllocate(frame, &v2, 64) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(*v0 == 7);
+		TEST_REQUIRE_PASS(mfmFrameEnd(frame) == MF_ERROR_OKAY);
+
+		// Frame 2 reuses the arena from frame 0
+		mfmU8* v3 = NULL;
+		TEST_REQUIRE_PASS(mfmAllocate(frame, &v3, 3) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(v3 == v0);
+
+		TEST_REQUIRE_PASS(mfmFrameGetHighWaterMark(frame, 0) == MFM_FRAME_ALLOCATOR_DEFAULT_ALIGNMENT + 3);
+		TEST_REQUIRE_PASS(mfmFrameGetHighWaterMark(frame, 1) >= 32);
+		TEST_REQUIRE_PASS(mfmFrameGetHighWaterMark(frame, 2) == 0);
+
+		mfmDestroyFrameAllocator(frame);
+	}
+
+	// Arena sizes which aren't multiples of 8 still leave every arena aligned, and the allocator is a valid object
+	{
+		mfmFrameAllocator* frame = NULL;
+		TEST_REQUIRE_PASS(mfmCreateFrameAllocator(&frame, 61, 3) == MF_ERROR_OKAY);
+		for (mfmU64 i = 0; i < 3; ++i)
+			TEST_REQUIRE_PASS((mfmU64)frame->arenas[i] % MFM_FRAME_ALLOCATOR_ARENA_ALIGNMENT == 0);
+		TEST_REQUIRE_PASS(mfmAcquireObject(&frame->base.object) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmReleaseObject(&frame->base.object) == MF_ERROR_OKAY);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
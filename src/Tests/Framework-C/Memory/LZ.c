@@ -0,0 +1,206 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Memory/LZ.h>
+#include <Magma/Framework/Memory/Deflate.h>
+#include <Magma/Framework/Memory/Inflate.h>
+#include <Magma/Framework/Entry.h>
+
+#include <string.h>
+
+#define DATA_SIZE (200 * 1000)
+
+static mfmU8 data[DATA_SIZE];
+static mfmU8 compressed[2 * DATA_SIZE];
+// Has a spare byte, so that reads at the end of a stream aren't empty (which always succeed)
+static mfmU8 decompressed[DATA_SIZE + 1];
+static mfmU32 seed = 1234;
+
+static mfmU32 Random(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static void CheckBlock(const mfmU8* block, mfmU64 size)
+{
+	mfmU64 compressedSize, decompressedSize;
+	TEST_REQUIRE_PASS(mfmLZCompressBlock(block, size, compressed, mfmGetLZBlockBound(size), &compressedSize) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(compressedSize <= mfmGetLZBlockBound(size));
+
+	TEST_REQUIRE_PASS(mfmLZDecompressBlock(compressed, compressedSize, decompressed, size, &decompressedSize) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(decompressedSize == size && memcmp(decompressed, block, size) == 0);
+
+	// The last 5 bytes of the output buffer are only written with data
+	memset(decompressed + size, 0xCD, 5);
+	TEST_REQUIRE_PASS(mfmLZDecompressBlock(compressed, compressedSize, decompressed, size + 5, &decompressedSize) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(decompressedSize == size && memcmp(decompressed, block, size) == 0);
+	for (mfmU64 i = 0; i < 5; ++i)
+		TEST_REQUIRE_PASS(decompressed[size + i] == 0xCD);
+	if (size > 0)
+		TEST_REQUIRE_PASS(mfmLZDecompressBlock(compressed, compressedSize, decompressed, size - 1, &decompressedSize) == MFM_ERROR_BUFFER_FULL);
+}
+
+// Writes the data to a stream in pieces of random sizes and reads it back through another stream with a small buffer
+static void CheckStreams(mfmEnum compression, mfmU64 bufferSize)
+{
+	static mfmU8 deflateBuffer[1000];
+	static mfmU8 inflateBuffer[1000];
+	mfsStream* deflateStream;
+	mfsStream* inflateStream;
+	TEST_REQUIRE_PASS(mfmCreateDeflateStream(&deflateStream, deflateBuffer, bufferSize, compression, NULL) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mfmCreateInflateStream(&inflateStream, inflateBuffer, bufferSize, NULL) == MF_ERROR_OKAY);
+
+	mfmU64 offset = 0;
+	mfmU64 compressedSize = 0;
+	mfmU64 size = 0;
+	mfmBool finished = MFM_FALSE;
+	while (finished == MFM_FALSE || compressedSize > 0)
+	{
+		mfError err;
+		if (offset < DATA_SIZE)
+		{
+			mfmU64 writeSize = Random() % 3000;
+			if (writeSize > DATA_SIZE - offset)
+				writeSize = DATA_SIZE - offset;
+			err = mfsWrite(deflateStream, data + offset, writeSize, &writeSize);
+			TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFM_ERROR_BUFFER_FULL);
+			offset += writeSize;
+			if (Random() % 16 == 0)
+			{
+				err = mfsFlush(deflateStream);
+				TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFM_ERROR_BUFFER_FULL);
+			}
+		}
+		else if (finished == MFM_FALSE)
+		{
+			err = mfmFinishDeflateStream(deflateStream);
+			TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFM_ERROR_BUFFER_FULL);
+			finished = err == MF_ERROR_OKAY ? MFM_TRUE : MFM_FALSE;
+		}
+
+		// Move the compressed data to the inflate stream, through the end of the compressed buffer
+		mfmU64 readSize = 0;
+		err = mfsRead(deflateStream, compressed + sizeof(compressed) / 2 + compressedSize, sizeof(compressed) / 2 - compressedSize, &readSize);
+		TEST_REQUIRE_PASS(err == MF_ERROR_OKAY);
+		compressedSize += readSize;
+
+		mfmU64 writeSize = 0;
+		if (compressedSize > 0)
+		{
+			err = mfsWrite(inflateStream, compressed + sizeof(compressed) / 2, compressedSize, &writeSize);
+			TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFM_ERROR_BUFFER_FULL);
+			memmove(compressed + sizeof(compressed) / 2, compressed + sizeof(compressed) / 2 + writeSize, compressedSize - writeSize);
+			compressedSize -= writeSize;
+		}
+
+		readSize = 0;
+		err = mfsRead(inflateStream, decompressed + size, sizeof(decompressed) - size, &readSize);
+		TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFS_ERROR_EOF);
+		size += readSize;
+	}
+
+	for (;;)
+	{
+		mfmU64 readSize = 0;
+		mfError err = mfsRead(inflateStream, decompressed + size, sizeof(decompressed) - size, &readSize);
+		if (err == MFS_ERROR_EOF)
+			break;
+		TEST_REQUIRE_PASS(err == MF_ERROR_OKAY && readSize > 0);
+		size += readSize;
+	}
+
+	TEST_REQUIRE_PASS(size == DATA_SIZE && memcmp(decompressed, data, DATA_SIZE) == 0);
+	mfmDestroyInflateStream(inflateStream);
+	mfmDestroyDeflateStream(deflateStream);
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	// Text-like data, with runs and incompressible parts
+	for (mfmU64 i = 0; i < DATA_SIZE; ++i)
+	{
+		if (i % 20000 < 2000)
+			data[i] = (mfmU8)Random();
+		else if (i % 20000 < 3000)
+			data[i] = 'x';
+		else
+			data[i] = (mfmU8)('a' + Random() % 8);
+	}
+
+	// Blocks of every kind and of sizes around the format's limits
+	{
+		CheckBlock(data, 0);
+		CheckBlock(data, 1);
+		CheckBlock(data, 12);
+		CheckBlock(data + 2500, 13);
+		CheckBlock(data + 2500, 100);
+		CheckBlock(data, 1000);
+		CheckBlock(data, MFM_LZ_BLOCK_SIZE);
+		CheckBlock(data + 1000, MFM_LZ_BLOCK_SIZE);
+
+		static mfmU8 zeros[MFM_LZ_BLOCK_SIZE];
+		CheckBlock(zeros, MFM_LZ_BLOCK_SIZE);
+
+		mfmU64 compressedSize;
+		TEST_REQUIRE_PASS(mfmLZCompressBlock(zeros, MFM_LZ_BLOCK_SIZE, compressed, 1000, &compressedSize) == MF_ERROR_OKAY && compressedSize < 1000);
+		TEST_REQUIRE_PASS(mfmLZCompressBlock(data, 1000, compressed, 10, &compressedSize) == MFM_ERROR_BUFFER_FULL);
+		TEST_REQUIRE_PASS(mfmLZCompressBlock(data, MFM_LZ_BLOCK_SIZE + 1, compressed, sizeof(compressed), &compressedSize) == MFM_ERROR_INVALID_ARGUMENTS);
+	}
+
+	// Corrupted blocks are rejected without reading or writing out of bounds
+	{
+		mfmU64 compressedSize, decompressedSize;
+		TEST_REQUIRE_PASS(mfmLZCompressBlock(data + 2000, 5000, compressed, sizeof(compressed), &compressedSize) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmLZDecompressBlock(compressed, 0, decompressed, 5000, &decompressedSize) == MFM_ERROR_INTERNAL);
+		for (mfmU32 i = 0; i < 2000; ++i)
+		{
+			static mfmU8 corrupted[2 * DATA_SIZE];
+			memcpy(corrupted, compressed, compressedSize);
+			corrupted[Random() % compressedSize] = (mfmU8)Random();
+			mfmU64 corruptedSize = Random() % 4 == 0 ? Random() % compressedSize : compressedSize;
+			mfError err = mfmLZDecompressBlock(corrupted, corruptedSize, decompressed, 5000, &decompressedSize);
+			TEST_REQUIRE_PASS(err == MF_ERROR_OKAY || err == MFM_ERROR_INTERNAL || err == MFM_ERROR_BUFFER_FULL);
+		}
+	}
+
+	// Frames written by mfmDeflate, which mfmInflate tells apart from zlib streams
+	{
+		mfmU64 compressedSize, decompressedSize;
+		TEST_REQUIRE_PASS(mfmGetLZFrameBound(DATA_SIZE) <= sizeof(compressed));
+		TEST_REQUIRE_PASS(mfmDeflate(data, DATA_SIZE, compressed, sizeof(compressed), &compressedSize, MFM_LZ_COMPRESSION, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(compressedSize < DATA_SIZE);
+		TEST_REQUIRE_PASS(memcmp(compressed, MFM_COMPRESSED_FRAME_MAGIC, 4) == 0 && compressed[4] == MFM_CODEC_LZ);
+		TEST_REQUIRE_PASS(mfmInflate(compressed, compressedSize, decompressed, sizeof(decompressed), &decompressedSize, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(decompressedSize == DATA_SIZE && memcmp(decompressed, data, DATA_SIZE) == 0);
+		TEST_REQUIRE_PASS(mfmInflate(compressed, compressedSize, decompressed, DATA_SIZE - 1, &decompressedSize, NULL) == MFM_ERROR_BUFFER_FULL);
+		TEST_REQUIRE_PASS(mfmInflate(compressed, compressedSize - 1, decompressed, sizeof(decompressed), &decompressedSize, NULL) == MFM_ERROR_INTERNAL);
+		TEST_REQUIRE_PASS(mfmDeflate(data, DATA_SIZE, compressed, compressedSize - 1, &compressedSize, MFM_LZ_COMPRESSION, NULL) == MFM_ERROR_BUFFER_FULL);
+
+		// Unknown codecs are rejected
+		TEST_REQUIRE_PASS(mfmDeflate(data, 100, compressed, sizeof(compressed), &compressedSize, MFM_LZ_COMPRESSION, NULL) == MF_ERROR_OKAY);
+		compressed[4] = 0xFF;
+		TEST_REQUIRE_PASS(mfmInflate(compressed, compressedSize, decompressed, sizeof(decompressed), &decompressedSize, NULL) == MFM_ERROR_INTERNAL);
+
+		// Empty data
+		TEST_REQUIRE_PASS(mfmDeflate(data, 0, compressed, sizeof(compressed), &compressedSize, MFM_LZ_COMPRESSION, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmInflate(compressed, compressedSize, decompressed, sizeof(decompressed), &decompressedSize, NULL) == MF_ERROR_OKAY && decompressedSize == 0);
+	}
+
+	// Streams, with buffers smaller and bigger than the writes
+	CheckStreams(MFM_LZ_COMPRESSION, 1000);
+	CheckStreams(MFM_LZ_COMPRESSION, 37);
+	CheckStreams(MFM_FAST_COMPRESSION, 37);
+
+	// Block compressed frames of LZ frames
+	{
+		mfmU64 compressedSize, decompressedSize;
+		TEST_REQUIRE_PASS(mfmDeflateBlocks(data, DATA_SIZE, compressed, sizeof(compressed), &compressedSize, 30000, MFM_LZ_COMPRESSION, NULL, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmInflateBlocks(compressed, compressedSize, decompressed, sizeof(decompressed), &decompressedSize, NULL, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(decompressedSize == DATA_SIZE && memcmp(decompressed, data, DATA_SIZE) == 0);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
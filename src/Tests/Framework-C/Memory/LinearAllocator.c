@@ -20,8 +20,33 @@ int main(int argc, char** argv)
 		TEST_REQUIRE_PASS(mfmDeallocate(linear, v1) == MFM_ERROR_UNSUPPORTED_FUNCTION);
 		TEST_REQUIRE_PASS(mfmDeallocate(linear, v0) == MFM_ERROR_UNSUPPORTED_FUNCTION);
 		TEST_REQUIRE_FAIL(mfmAllocate(linear, &v1, sizeof(mfmU8) * 3) == MF_ERROR_OKAY);
-		TEST_REQUIRE_PASS(mfmLinearReset(linear));
+		TEST_REQUIRE_PASS(mfmLinearReset(linear) == MF_ERROR_OKAY);
 		TEST_REQUIRE_PASS(mfmAllocate(linear, &v1, sizeof(mfmU8) * 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmLinearGetHighWaterMark(linear) == 3);
+
+		mfmDestroyLinearAllocator(linear);
+	}
+
+	{
+		mfmLinearAllocator* linear = NULL;
+
+		TEST_REQUIRE_PASS(mfmCreateLinearAllocator(&linear, 256) == MF_ERROR_OKAY);
+
+		mfmU8* v0 = NULL;
+		mfmU8* v1 = NULL;
+		TEST_REQUIRE_PASS(mfmLinearAllocateAligned(linear, &v0, 1, 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmLinearAllocateAligned(linear, &v1, 16, 64) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS((mfmU64)v1 % 64 == 0);
+		TEST_REQUIRE_FAIL(mfmLinearAllocateAligned(linear, &v1, 16, 48) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmLinearAllocateAligned(linear, &v1, 256, 1) == MF_ERROR_OKAY);
+
+		// Reallocating the last allocation keeps it in place, otherwise the data is copied
+		v1[0] = 42;
+		TEST_REQUIRE_PASS(mfmReallocate(linear, v1, 16, 32, &v0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(v0 == v1);
+		TEST_REQUIRE_PASS(mfmAllocate(linear, &v1, 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmReallocate(linear, v0, 32, 64, &v1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(v0 != v1 && v1[0] == 42);
 
 		mfmDestroyLinearAllocator(linear);
 	}
@@ -0,0 +1,149 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Memory/Object.h>
+#include <Magma/Framework/Thread/Thread.h>
+#include <Magma/Framework/Thread/Atomic.h>
+#include <Magma/Framework/Entry.h>
+
+#define THREAD_COUNT 4
+#define ITERATION_COUNT 200
+
+static mfmObject object;
+static volatile mfmI32 destroyCount = 0;
+static volatile mfmI32 ready = 0;
+static volatile mfmBool failed = MFM_FALSE;
+
+static void Destructor(void* obj)
+{
+	mftAtomic32Add(&destroyCount, 1);
+	if (mfmDeinitObject((mfmObject*)obj) != MF_ERROR_OKAY)
+		failed = MFM_TRUE;
+}
+
+static void ReleaseFunction(void* args)
+{
+	// Wait for every thread to start, so that the last references are released at the same time
+	mftAtomic32Add(&ready, 1);
+	mfmI32 value = 0;
+	while (value < THREAD_COUNT)
+		mftAtomic32Load(&ready, &value);
+
+	for (mfmU32 i = 0; i < 1000; ++i)
+		if (mfmAcquireObject(&object) != MF_ERROR_OKAY || mfmReleaseObject(&object) != MF_ERROR_OKAY)
+			failed = MFM_TRUE;
+	if (mfmReleaseObject(&object) != MF_ERROR_OKAY)
+		failed = MFM_TRUE;
+}
+
+static void UnreferencedReleaseFunction(void* args)
+{
+	// Releasing an object without references must fail without touching its count
+	for (mfmU32 i = 0; i < 1000; ++i)
+		if (mfmReleaseObject(&object) != MFM_ERROR_HAS_NO_REFERENCES)
+			failed = MFM_TRUE;
+	mftAtomic32Add(&ready, 1);
+}
+
+static void WatchCountFunction(void* args)
+{
+	// Watch the count until every other thread has finished releasing
+	mfmI32 finished = 0;
+	while (finished < THREAD_COUNT - 1)
+	{
+		mfmI32 refCount = 0;
+		if (mfmGetObjectRefCount(&object, &refCount) != MF_ERROR_OKAY || refCount != 0)
+			failed = MFM_TRUE;
+		mftAtomic32Load(&ready, &finished);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	// Single thread
+	{
+		TEST_REQUIRE_PASS(mfmInitObject(&object) == MF_ERROR_OKAY);
+		object.destructorFunc = &Destructor;
+		TEST_REQUIRE_PASS(mfmReleaseObject(&object) == MFM_ERROR_HAS_NO_REFERENCES);
+
+		mfmI32 refCount = -1;
+		TEST_REQUIRE_PASS(mfmGetObjectRefCount(&object, &refCount) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(refCount == 0);
+
+		TEST_REQUIRE_PASS(mfmAcquireObject(&object) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAcquireObject(&object) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmDeinitObject(&object) == MFM_ERROR_STILL_HAS_REFERENCES);
+		TEST_REQUIRE_PASS(mfmReleaseObject(&object) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(destroyCount == 0);
+		TEST_REQUIRE_PASS(mfmReleaseObject(&object) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(destroyCount == 1);
+	}
+
+	// Non atomic
+	{
+		destroyCount = 0;
+		TEST_REQUIRE_PASS(mfmInitObject(&object) == MF_ERROR_OKAY);
+		object.destructorFunc = &Destructor;
+		TEST_REQUIRE_PASS(mfmSetObjectNonAtomic(&object, MFM_TRUE) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmReleaseObject(&object) == MFM_ERROR_HAS_NO_REFERENCES);
+		for (mfmU32 i = 0; i < 3; ++i)
+			TEST_REQUIRE_PASS(mfmAcquireObject(&object) == MF_ERROR_OKAY);
+		for (mfmU32 i = 0; i < 3; ++i)
+		{
+			TEST_REQUIRE_PASS(destroyCount == 0);
+			TEST_REQUIRE_PASS(mfmReleaseObject(&object) == MF_ERROR_OKAY);
+		}
+		TEST_REQUIRE_PASS(destroyCount == 1);
+	}
+
+	// The last references are released concurrently, the object must be destroyed exactly once
+	for (mfmU32 iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+	{
+		destroyCount = 0;
+		ready = 0;
+		TEST_REQUIRE_PASS(mfmInitObject(&object) == MF_ERROR_OKAY);
+		object.destructorFunc = &Destructor;
+		for (mfmU32 i = 0; i < THREAD_COUNT; ++i)
+			TEST_REQUIRE_PASS(mfmAcquireObject(&object) == MF_ERROR_OKAY);
+
+		mftThread* threads[THREAD_COUNT];
+		for (mfmU32 i = 0; i < THREAD_COUNT; ++i)
+			TEST_REQUIRE_PASS(mftCreateThread(&threads[i], &ReleaseFunction, NULL, NULL) == MF_ERROR_OKAY);
+		for (mfmU32 i = 0; i < THREAD_COUNT; ++i)
+		{
+			TEST_REQUIRE_PASS(mftWaitForThread(threads[i], 0) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftDestroyThread(threads[i]) == MF_ERROR_OKAY);
+		}
+
+		TEST_REQUIRE_PASS(destroyCount == 1);
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+	}
+
+	// Failed releases never change the count, not even for a moment
+	for (mfmU32 iteration = 0; iteration < ITERATION_COUNT; ++iteration)
+	{
+		destroyCount = 0;
+		ready = 0;
+		TEST_REQUIRE_PASS(mfmInitObject(&object) == MF_ERROR_OKAY);
+		object.destructorFunc = &Destructor;
+
+		mftThread* threads[THREAD_COUNT];
+		for (mfmU32 i = 0; i < THREAD_COUNT; ++i)
+			TEST_REQUIRE_PASS(mftCreateThread(&threads[i], i == 0 ? &WatchCountFunction : &UnreferencedReleaseFunction, NULL, NULL) == MF_ERROR_OKAY);
+		for (mfmU32 i = 0; i < THREAD_COUNT; ++i)
+		{
+			TEST_REQUIRE_PASS(mftWaitForThread(threads[i], 0) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftDestroyThread(threads[i]) == MF_ERROR_OKAY);
+		}
+
+		mfmI32 refCount = -1;
+		TEST_REQUIRE_PASS(mfmGetObjectRefCount(&object, &refCount) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(refCount == 0);
+		TEST_REQUIRE_PASS(destroyCount == 0);
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
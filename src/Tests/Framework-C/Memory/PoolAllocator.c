@@ -28,6 +28,108 @@ int main(int argc, char** argv)
 		mfmDestroyPoolAllocator(pool);
 	}
 
+	{
+		mfmPoolAllocator* pool = NULL;
+		mfmPoolAllocatorDesc desc;
+
+		desc.expandable = MFM_TRUE;
+		desc.slotCount = 4;
+		desc.slotSize = 24;
+
+		TEST_REQUIRE_PASS(mfmCreatePoolAllocator(&pool, &desc) == MF_ERROR_OKAY);
+
+		void* values[64];
+		for (mfmU64 i = 0; i < 64; ++i)
+			TEST_REQUIRE_PASS(mfmAllocate(pool, &values[i], 24) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmPoolGetChunkCount(pool) == 16);
+		TEST_REQUIRE_PASS(mfmPoolGetOccupiedSlotCount(pool) == 64);
+		TEST_REQUIRE_PASS(mfmPoolGetFreeSlotCount(pool) == 0);
+
+		// Deallocate every other slot, twice to check double frees are rejected
+		for (mfmU64 i = 0; i < 64; i += 2)
+		{
+			TEST_REQUIRE_PASS(mfmDeallocate(pool, values[i]) == MF_ERROR_OKAY);
+			TEST_REQUIRE_FAIL(mfmDeallocate(pool, values[i]) == MF_ERROR_OKAY);
+		}
+		TEST_REQUIRE_PASS(mfmPoolGetFreeSlotCount(pool) == 32);
+
+		// Pointers which weren't returned by the pool must be rejected
+		mfmU8 local;
+		TEST_REQUIRE_FAIL(mfmDeallocate(pool, &local) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmDeallocate(pool, (mfmU8*)values[1] + 1) == MF_ERROR_OKAY);
+
+		// Freed slots must be reused before the pool expands again
+		for (mfmU64 i = 0; i < 64; i += 2)
+			TEST_REQUIRE_PASS(mfmAllocate(pool, &values[i], 24) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmPoolGetChunkCount(pool) == 16);
+		TEST_REQUIRE_PASS(mfmPoolGetFreeSlotCount(pool) == 0);
+
+		for (mfmU64 i = 0; i < 64; ++i)
+			TEST_REQUIRE_PASS(mfmDeallocate(pool, values[i]) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmPoolGetOccupiedSlotCount(pool) == 0);
+
+		mfmDestroyPoolAllocator(pool);
+	}
+
+	{
+		mfmPoolAllocator* pool = NULL;
+		mfmPoolAllocatorDesc desc;
+		mfmU8 memory[MFM_POOL_ALLOCATOR_SIZE(16, 3)];
+
+		desc.expandable = MFM_FALSE;
+		desc.slotCount = 16;
+		desc.slotSize = 3;
+
+		TEST_REQUIRE_PASS(mfmCreatePoolAllocatorOnMemory(&pool, &desc, memory + 1, sizeof(memory) - 1) == MF_ERROR_OKAY);
+
+		void* values[16];
+		for (mfmU64 i = 0; i < 16; ++i)
+			TEST_REQUIRE_PASS(mfmAllocate(pool, &values[i], 3) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmAllocate(pool, &values[0], 3) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmDeallocate(pool, values[7]) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocate(pool, &values[7], 3) == MF_ERROR_OKAY);
+
+		mfmDestroyPoolAllocator(pool);
+	}
+
+	{
+		mfmPoolAllocator* pool = NULL;
+		mfmPoolAllocatorDesc desc;
+		mfmU8 memory[MFM_POOL_ALLOCATOR_SIZE(4, 64)];
+
+		desc.expandable = MFM_FALSE;
+		desc.slotCount = 4;
+		desc.slotSize = 64;
+
+		// Slots are aligned to their size, up to the maximum slot alignment
+		TEST_REQUIRE_PASS(mfmCreatePoolAllocatorOnMemory(&pool, &desc, memory + 3, sizeof(memory) - 3) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmPoolGetSlotAlignment(pool) == 64);
+
+		void* values[4];
+		for (mfmU64 i = 0; i < 4; ++i)
+		{
+			TEST_REQUIRE_PASS(mfmAllocateAligned(pool, &values[i], 64, 64) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS((mfmU64)values[i] % 64 == 0);
+		}
+		TEST_REQUIRE_PASS(mfmDeallocateAligned(pool, values[0]) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmAllocateAligned(pool, &values[0], 64, 128) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocateAligned(pool, &values[0], 64, 32) == MF_ERROR_OKAY);
+
+		mfmDestroyPoolAllocator(pool);
+
+		desc.expandable = MFM_TRUE;
+		desc.slotSize = 48;
+		TEST_REQUIRE_PASS(mfmCreatePoolAllocator(&pool, &desc) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmPoolGetSlotAlignment(pool) == 16);
+		for (mfmU64 i = 0; i < 16; ++i)
+		{
+			void* value;
+			TEST_REQUIRE_PASS(mfmAllocateAligned(pool, &value, 48, 16) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS((mfmU64)value % 16 == 0);
+		}
+		mfmDestroyPoolAllocator(pool);
+	}
+
 	mfTerminate();
 	EXIT_PASS();
 }
\ No newline at end of file
@@ -25,6 +25,23 @@ int main(int argc, char** argv)
 		mfmDestroyStackAllocator(stack);
 	}
 
+	{
+		mfmStackAllocator* stack = NULL;
+
+		TEST_REQUIRE_PASS(mfmCreateStackAllocator(&stack, 256) == MF_ERROR_OKAY);
+
+		mfmU8* v0 = NULL;
+		mfmU8* v1 = NULL;
+		TEST_REQUIRE_PASS(mfmAllocate(stack, &v0, 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocateAligned(stack, &v1, 16, 64) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS((mfmU64)v1 % 64 == 0);
+		TEST_REQUIRE_FAIL(mfmAllocateAligned(stack, &v1, 16, 48) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfmAllocateAligned(stack, &v1, 256, 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmDeallocateAligned(stack, v1) == MF_ERROR_OKAY);
+
+		mfmDestroyStackAllocator(stack);
+	}
+
 	mfTerminate();
 	EXIT_PASS();
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Memory/ThreadCacheAllocator.h>
+#include <Magma/Framework/Thread/Thread.h>
+#include <Magma/Framework/Entry.h>
+
+#include <string.h>
+
+#define THREAD_COUNT 4
+#define BLOCK_COUNT 1024
+
+static mfmThreadCacheAllocator* allocator = NULL;
+static void* blocks[THREAD_COUNT][BLOCK_COUNT];
+static volatile mfmBool failed = MFM_FALSE;
+
+static void AllocateFunction(void* args)
+{
+	mfmU64 index = (mfmU64)args;
+	for (mfmU64 i = 0; i < BLOCK_COUNT; ++i)
+	{
+		mfmU64 size = 1 + (i * 37 + index * 11) % 3000;
+		if (mfmAllocate(allocator, &blocks[index][i], size) != MF_ERROR_OKAY)
+		{
+			failed = MFM_TRUE;
+			return;
+		}
+		memset(blocks[index][i], (int)index, (size_t)size);
+	}
+}
+
+static void DeallocateFunction(void* args)
+{
+	// Free the blocks allocated by another thread
+	mfmU64 index = ((mfmU64)args + 1) % THREAD_COUNT;
+	for (mfmU64 i = 0; i < BLOCK_COUNT; ++i)
+		if (mfmDeallocate(allocator, blocks[index][i]) != MF_ERROR_OKAY)
+		{
+			failed = MFM_TRUE;
+			return;
+		}
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	{
+		mfmThreadCacheAllocatorDesc desc;
+		desc.backingAllocator = NULL;
+		desc.batchSize = 0;
+		TEST_REQUIRE_FAIL(mfmCreateThreadCacheAllocator(&allocator, &desc) == MF_ERROR_OKAY);
+
+		desc.batchSize = 8;
+		TEST_REQUIRE_PASS(mfmCreateThreadCacheAllocator(&allocator, &desc) == MF_ERROR_OKAY);
+
+		// Single thread
+		mfmU8* v0 = NULL;
+		mfmU8* v1 = NULL;
+		TEST_REQUIRE_PASS(mfmAllocate(allocator, &v0, 24) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocate(allocator, &v1, 24) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(v0 != v1);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocate(allocator, &v0, 20) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v1) == MF_ERROR_OKAY);
+
+		// Reallocation keeps the data
+		for (mfmU8 i = 0; i < 20; ++i)
+			v0[i] = i;
+		TEST_REQUIRE_PASS(mfmReallocate(allocator, v0, 20, 5000, &v0) == MF_ERROR_OKAY);
+		for (mfmU8 i = 0; i < 20; ++i)
+			TEST_REQUIRE_PASS(v0[i] == i);
+		TEST_REQUIRE_PASS(mfmReallocate(allocator, v0, 5000, 100, &v0) == MF_ERROR_OKAY);
+		for (mfmU8 i = 0; i < 20; ++i)
+			TEST_REQUIRE_PASS(v0[i] == i);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v0) == MF_ERROR_OKAY);
+
+		// Reallocating NULL through the allocator functions allocates a new block
+		v0 = NULL;
+		TEST_REQUIRE_PASS(allocator->base.reallocate(allocator, NULL, 0, 24, &v0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(v0 != NULL);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v0) == MF_ERROR_OKAY);
+
+		// Allocate on some threads and deallocate on others
+		mftThread* threads[THREAD_COUNT];
+		for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+			TEST_REQUIRE_PASS(mftCreateThread(&threads[i], &AllocateFunction, (void*)i, NULL) == MF_ERROR_OKAY);
+		for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+		{
+			TEST_REQUIRE_PASS(mftWaitForThread(threads[i], 0) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftDestroyThread(threads[i]) == MF_ERROR_OKAY);
+		}
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+
+		for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+			for (mfmU64 j = 0; j < BLOCK_COUNT; ++j)
+				TEST_REQUIRE_PASS(((mfmU8*)blocks[i][j])[0] == (mfmU8)i);
+
+		for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+			TEST_REQUIRE_PASS(mftCreateThread(&threads[i], &DeallocateFunction, (void*)i, NULL) == MF_ERROR_OKAY);
+		for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+		{
+			TEST_REQUIRE_PASS(mftWaitForThread(threads[i], 0) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftDestroyThread(threads[i]) == MF_ERROR_OKAY);
+		}
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+
+		TEST_REQUIRE_PASS(mfmThreadCacheFlush(allocator) == MF_ERROR_OKAY);
+		mfmDestroyThreadCacheAllocator(allocator);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
@@ -0,0 +1,152 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Memory/TrackingAllocator.h>
+#include <Magma/Framework/Memory/Endianness.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/Entry.h>
+
+#include <string.h>
+
+static void ReadLittleEndian(const mfmU8* src, void* dst, mfmU64 size)
+{
+	// The trace fields aren't aligned
+	memcpy(dst, src, size);
+	if (size == 2)
+		mfmFromLittleEndian2(dst, dst);
+	else if (size == 4)
+		mfmFromLittleEndian4(dst, dst);
+	else
+		mfmFromLittleEndian8(dst, dst);
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	{
+		mfmU8 buffer[1024];
+		mfsStringStream stream;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&stream, buffer, sizeof(buffer)) == MF_ERROR_OKAY);
+
+		mfmTrackingAllocatorDesc desc;
+		desc.backingAllocator = NULL;
+		desc.traceStream = &stream;
+		desc.threadSafe = MFM_FALSE;
+
+		mfmTrackingAllocator* allocator = NULL;
+		TEST_REQUIRE_FAIL(mfmCreateTrackingAllocator(&allocator, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmCreateTrackingAllocator(&allocator, &desc) == MF_ERROR_OKAY);
+
+		// Untagged allocations
+		mfmU8* v0 = NULL;
+		mfmU8* v1 = NULL;
+		TEST_REQUIRE_FAIL(mfmAllocate(allocator, &v0, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocate(allocator, &v0, 100) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmAllocate(allocator, &v1, 1) == MF_ERROR_OKAY);
+
+		mfmTrackingStats stats;
+		TEST_REQUIRE_PASS(mfmTrackingGetStats(allocator, &stats) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(stats.liveBytes == 101);
+		TEST_REQUIRE_PASS(stats.peakBytes == 101);
+		TEST_REQUIRE_PASS(stats.liveAllocationCount == 2);
+		TEST_REQUIRE_PASS(stats.allocationCount == 2);
+		TEST_REQUIRE_PASS(stats.histogram[0] == 1);
+		TEST_REQUIRE_PASS(stats.histogram[6] == 1);
+
+		// Reallocation keeps the data
+		for (mfmU8 i = 0; i < 100; ++i)
+			v0[i] = i;
+		TEST_REQUIRE_PASS(mfmReallocate(allocator, v0, 100, 300, &v0) == MF_ERROR_OKAY);
+		for (mfmU8 i = 0; i < 100; ++i)
+			TEST_REQUIRE_PASS(v0[i] == i);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v1) == MF_ERROR_OKAY);
+
+		TEST_REQUIRE_PASS(mfmTrackingGetStats(allocator, &stats) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(stats.liveBytes == 0);
+		TEST_REQUIRE_PASS(stats.peakBytes == 301);
+		TEST_REQUIRE_PASS(stats.liveAllocationCount == 0);
+		TEST_REQUIRE_PASS(stats.allocationCount == 2);
+		TEST_REQUIRE_PASS(stats.deallocationCount == 2);
+		TEST_REQUIRE_PASS(stats.reallocationCount == 1);
+
+		// Tagged allocations
+		const mfsUTF8CodeUnit* tag = u8"Test";
+		TEST_REQUIRE_PASS(mfmTrackingSetTag(allocator, tag) == NULL);
+		TEST_REQUIRE_PASS(mfmAllocate(allocator, &v0, 16) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmTrackingSetTag(allocator, NULL) == tag);
+		TEST_REQUIRE_PASS(mfmTrackingAllocateTagged(allocator, &v1, 16, tag) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfmDeallocate(allocator, v1) == MF_ERROR_OKAY);
+
+		mfmDestroyTrackingAllocator(allocator);
+
+		// Check the trace
+		mfmU8* trace = buffer;
+		TEST_REQUIRE_PASS(memcmp(trace, "MFMT", 4) == 0);
+		TEST_REQUIRE_PASS(trace[4] == MFM_TRACKING_TRACE_VERSION);
+		trace += 5;
+
+		mfmU32 tagId;
+		mfmU64 address;
+		mfmU64 size;
+
+		// First allocation
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_ALLOCATE);
+		ReadLittleEndian(&trace[1], &tagId, sizeof(tagId));
+		ReadLittleEndian(&trace[13], &size, sizeof(size));
+		TEST_REQUIRE_PASS(tagId == 0);
+		TEST_REQUIRE_PASS(size == 100);
+		trace += 21;
+
+		// Second allocation, reallocation (deallocation + allocation) and two deallocations
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_ALLOCATE);
+		trace += 21;
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_DEALLOCATE);
+		ReadLittleEndian(&trace[13], &size, sizeof(size));
+		TEST_REQUIRE_PASS(size == 100);
+		trace += 21;
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_ALLOCATE);
+		ReadLittleEndian(&trace[5], &address, sizeof(address));
+		ReadLittleEndian(&trace[13], &size, sizeof(size));
+		TEST_REQUIRE_PASS(size == 300);
+		trace += 21;
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_DEALLOCATE);
+		ReadLittleEndian(&trace[5], &size, sizeof(size));
+		TEST_REQUIRE_PASS(size == address);
+		trace += 21;
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_DEALLOCATE);
+		trace += 21;
+
+		// Tag record is written before its first use
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_TAG);
+		mfmU32 testTagId;
+		mfmU16 tagSize;
+		ReadLittleEndian(&trace[1], &testTagId, sizeof(testTagId));
+		ReadLittleEndian(&trace[5], &tagSize, sizeof(tagSize));
+		TEST_REQUIRE_PASS(testTagId != 0);
+		TEST_REQUIRE_PASS(tagSize == 4);
+		TEST_REQUIRE_PASS(memcmp(&trace[7], "Test", 4) == 0);
+		trace += 11;
+
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_ALLOCATE);
+		ReadLittleEndian(&trace[1], &tagId, sizeof(tagId));
+		TEST_REQUIRE_PASS(tagId == testTagId);
+		trace += 21;
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_ALLOCATE);
+		ReadLittleEndian(&trace[1], &tagId, sizeof(tagId));
+		TEST_REQUIRE_PASS(tagId == testTagId);
+		trace += 21;
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_DEALLOCATE);
+		ReadLittleEndian(&trace[1], &tagId, sizeof(tagId));
+		TEST_REQUIRE_PASS(tagId == testTagId);
+		trace += 21;
+		TEST_REQUIRE_PASS(trace[0] == MFM_TRACKING_RECORD_DEALLOCATE);
+		trace += 21;
+
+		TEST_REQUIRE_PASS(trace - buffer == stream.head);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
@@ -2,8 +2,126 @@
 
 #include <Magma/Framework/String/Conversion.h>
 
+#include <string.h>
+
+static mfmBool PrintsF64(mfmF64 value, mfmU64 decimalPlaces, const mfsUTF8CodeUnit* expected)
+{
+	mfsUTF8CodeUnit buffer[64];
+	mfmU64 size = 0;
+	if (mfsPrintToBufferF64(buffer, sizeof(buffer), value, 10, decimalPlaces, &size) != MF_ERROR_OKAY)
+		return MFM_FALSE;
+	return (size == strlen(expected) && memcmp(buffer, expected, size) == 0) ? MFM_TRUE : MFM_FALSE;
+}
+
+static mfmBool PrintsF32(mfmF32 value, mfmU64 decimalPlaces, const mfsUTF8CodeUnit* expected)
+{
+	mfsUTF8CodeUnit buffer[64];
+	mfmU64 size = 0;
+	if (mfsPrintToBufferF32(buffer, sizeof(buffer), value, 10, decimalPlaces, &size) != MF_ERROR_OKAY)
+		return MFM_FALSE;
+	return (size == strlen(expected) && memcmp(buffer, expected, size) == 0) ? MFM_TRUE : MFM_FALSE;
+}
+
+static mfmBool ParsesF64(const mfsUTF8CodeUnit* str, mfmF64 expected)
+{
+	mfmF64 value = 0.0;
+	mfmU64 size = 0;
+	if (mfsParseFromBufferF64(str, strlen(str) + 1, &value, 10, &size) != MF_ERROR_OKAY)
+		return MFM_FALSE;
+	return (size == strlen(str) && memcmp(&value, &expected, sizeof(value)) == 0) ? MFM_TRUE : MFM_FALSE;
+}
+
 int main()
 {
+	// Fixed decimal places
+	{
+		TEST_REQUIRE_PASS(PrintsF64(1.5, 2, u8"1.50"));
+		TEST_REQUIRE_PASS(PrintsF64(-2.25, 1, u8"-2.3"));
+		TEST_REQUIRE_PASS(PrintsF64(0.999, 2, u8"1.00"));
+		TEST_REQUIRE_PASS(PrintsF64(1.05, 4, u8"1.0500"));
+		TEST_REQUIRE_PASS(PrintsF64(16.6667, 0, u8"17"));
+		TEST_REQUIRE_PASS(PrintsF64(1.0 / 3.0, 20, u8"0.33333333333333300000"));
+		TEST_REQUIRE_PASS(PrintsF32(0.1f, 3, u8"0.100"));
+		TEST_REQUIRE_PASS(PrintsF64(MFM_F64_INFINITY, 2, u8"INF"));
+		TEST_REQUIRE_PASS(PrintsF64(-MFM_F64_INFINITY, 2, u8"-INF"));
+		TEST_REQUIRE_PASS(PrintsF64(MFM_F64_NAN, 2, u8"NAN"));
+
+		// Rounding carries into the exponent
+		TEST_REQUIRE_PASS(PrintsF64(9.999999999999999e22, 0, u8"1E+23"));
+		TEST_REQUIRE_PASS(PrintsF64(9.999999999999999e22, 5, u8"1.00000E+23"));
+
+		// Buffer too small
+		mfsUTF8CodeUnit buffer[4];
+		mfmU64 size = 0;
+		TEST_REQUIRE_PASS(mfsPrintToBufferF64(buffer, sizeof(buffer), 12.345, 10, 2, &size) == MFS_ERROR_EOF);
+		TEST_REQUIRE_PASS(size == 4 && memcmp(buffer, u8"12.3", 4) == 0);
+		TEST_REQUIRE_FAIL(mfsPrintToBufferF64(buffer, sizeof(buffer), 1.0, 1, 2, &size) == MF_ERROR_OKAY);
+	}
+
+	// Shortest representation
+	{
+		TEST_REQUIRE_PASS(PrintsF64(0.1, MFS_SHORTEST_DECIMAL_PLACES, u8"0.1"));
+		TEST_REQUIRE_PASS(PrintsF64(-1.5, MFS_SHORTEST_DECIMAL_PLACES, u8"-1.5"));
+		TEST_REQUIRE_PASS(PrintsF64(0.0, MFS_SHORTEST_DECIMAL_PLACES, u8"0"));
+		TEST_REQUIRE_PASS(PrintsF64(123456789.0, MFS_SHORTEST_DECIMAL_PLACES, u8"123456789"));
+		TEST_REQUIRE_PASS(PrintsF64(0.001234, MFS_SHORTEST_DECIMAL_PLACES, u8"0.001234"));
+		TEST_REQUIRE_PASS(PrintsF64(1e21, MFS_SHORTEST_DECIMAL_PLACES, u8"1E+21"));
+		TEST_REQUIRE_PASS(PrintsF64(1.25e-7, MFS_SHORTEST_DECIMAL_PLACES, u8"1.25E-7"));
+		TEST_REQUIRE_PASS(PrintsF64(1.7976931348623157e308, MFS_SHORTEST_DECIMAL_PLACES, u8"1.7976931348623157E+308"));
+		TEST_REQUIRE_PASS(PrintsF64(5e-324, MFS_SHORTEST_DECIMAL_PLACES, u8"5E-324"));
+		TEST_REQUIRE_PASS(PrintsF64(4.0343820765405689e-223, MFS_SHORTEST_DECIMAL_PLACES, u8"4.034382076540569E-223"));
+		TEST_REQUIRE_PASS(PrintsF32(1.0f / 3.0f, MFS_SHORTEST_DECIMAL_PLACES, u8"0.33333334"));
+		TEST_REQUIRE_PASS(PrintsF32(16777216.0f, MFS_SHORTEST_DECIMAL_PLACES, u8"16777216"));
+
+		mfsUTF8CodeUnit buffer[8];
+		mfmU64 size = 0;
+		TEST_REQUIRE_FAIL(mfsPrintToBufferF64(buffer, sizeof(buffer), 0.1, 16, MFS_SHORTEST_DECIMAL_PLACES, &size) == MF_ERROR_OKAY);
+	}
+
+	// Parsing
+	{
+		TEST_REQUIRE_PASS(ParsesF64(u8"0.1", 0.1));
+		TEST_REQUIRE_PASS(ParsesF64(u8"-1.5E+3", -1500.0));
+		TEST_REQUIRE_PASS(ParsesF64(u8"1.7976931348623157E+308", 1.7976931348623157e308));
+		TEST_REQUIRE_PASS(ParsesF64(u8"2.2250738585072011e-308", 2.2250738585072011e-308));
+		TEST_REQUIRE_PASS(ParsesF64(u8"5E-324", 5e-324));
+		TEST_REQUIRE_PASS(ParsesF64(u8"1e-400", 0.0));
+
+		// Halfway between two floats, rounded to even unless a later digit breaks the tie
+		TEST_REQUIRE_PASS(ParsesF64(u8"9007199254740993", 9007199254740992.0));
+		TEST_REQUIRE_PASS(ParsesF64(u8"9007199254740993.000000000000000000000001", 9007199254740994.0));
+		TEST_REQUIRE_PASS(ParsesF64(u8"1.00000000000000011102230246251565404236316680908203125", 1.0));
+
+		mfmF64 value;
+		mfmF32 value32;
+		TEST_REQUIRE_PASS(mfsParseFromBufferF32(u8"1.00000005960464477539063", 64, &value32, 10, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(value32 == 1.00000011920928955078125f);
+		TEST_REQUIRE_PASS(mfsParseFromBufferF64(u8"1e400", 6, &value, 10, NULL) == MFS_ERROR_NUMBER_TOO_BIG);
+		TEST_REQUIRE_PASS(mfsParseFromBufferF32(u8"1e39", 5, &value32, 10, NULL) == MFS_ERROR_NUMBER_TOO_BIG);
+		TEST_REQUIRE_FAIL(mfsParseFromBufferF64(u8"1.5x", 5, &value, 10, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfsParseFromBufferF64(u8".", 2, &value, 10, NULL) == MF_ERROR_OKAY);
+	}
+
+	// Printed values are parsed back to the same value
+	{
+		mfmU64 state = 1;
+		for (mfmU64 i = 0; i < 10000; ++i)
+		{
+			state = state * 6364136223846793005 + 1442695040888963407;
+			mfmU64 bits = state ^ (state >> 29);
+			mfmF64 value;
+			memcpy(&value, &bits, sizeof(value));
+			if (value != value || value == MFM_F64_INFINITY || value == -MFM_F64_INFINITY)
+				continue;
+
+			mfsUTF8CodeUnit buffer[64];
+			mfmU64 size = 0;
+			TEST_REQUIRE_PASS(mfsPrintToBufferF64(buffer, sizeof(buffer), value, 10, MFS_SHORTEST_DECIMAL_PLACES, &size) == MF_ERROR_OKAY);
+			mfmF64 parsed = 0.0;
+			TEST_REQUIRE_PASS(mfsParseFromBufferF64(buffer, size, &parsed, 10, NULL) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(memcmp(&parsed, &value, sizeof(value)) == 0);
+		}
+	}
 
 	EXIT_PASS();
-}
\ No newline at end of file
+}
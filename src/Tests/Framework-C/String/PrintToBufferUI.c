@@ -108,6 +108,7 @@ int main()
 				u8"-127",
 				u8"10110",
 				u8"-101",
+				u8"-128",
 				NULL
 			};
 
@@ -120,6 +121,7 @@ int main()
 				10,
 				2,
 				2,
+				10,
 			};
 
 			mfmI8 i8e[] =
@@ -131,6 +133,7 @@ int main()
 				-127,
 				0b10110,
 				-0b101,
+				-128,
 			};
 
 			const mfsUTF8CodeUnit** s = i8s;
@@ -156,7 +159,7 @@ int main()
 				u8"",
 				u8"321",
 				u8"-124",
-				u8"-128",
+				u8"-129",
 				u8"ff",
 				u8"11111111",
 				NULL
@@ -290,6 +293,7 @@ int main()
 				u8"94",
 				u8"0fff",
 				u8"111111111111111",
+				u8"-32768",
 				NULL
 			};
 
@@ -302,6 +306,7 @@ int main()
 				10,
 				16,
 				2,
+				10,
 			};
 
 			mfmI16 i16e[] =
@@ -313,6 +318,7 @@ int main()
 				94,
 				0x0FFF,
 				0b111111111111111,
+				-32768,
 			};
 
 			const mfsUTF8CodeUnit** s = i16s;
@@ -470,6 +476,7 @@ int main()
 				u8"94",
 				u8"0fff",
 				u8"1111111111111111111111111111111",
+				u8"-2147483648",
 				NULL
 			};
 
@@ -482,6 +489,7 @@ int main()
 				10,
 				16,
 				2,
+				10,
 			};
 
 			mfmI32 i32e[] =
@@ -493,6 +501,7 @@ int main()
 				94,
 				0x0FFF,
 				0b1111111111111111111111111111111,
+				-2147483647 - 1,
 			};
 
 			const mfsUTF8CodeUnit** s = i32s;
@@ -650,6 +659,7 @@ int main()
 				u8"94",
 				u8"0fff",
 				u8"1111111111111111111111111111111",
+				u8"-9223372036854775808",
 				NULL
 			};
 
@@ -662,6 +672,7 @@ int main()
 				10,
 				16,
 				2,
+				10,
 			};
 
 			mfmI64 i64e[] =
@@ -673,6 +684,7 @@ int main()
 				94,
 				0x0FFF,
 				0b1111111111111111111111111111111,
+				-9223372036854775807 - 1,
 			};
 
 			const mfsUTF8CodeUnit** s = i64s;
@@ -0,0 +1,103 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/String/Stream.h>
+#include <Magma/Framework/String/StringStream.h>
+
+#include <string.h>
+
+static mfmU64 writeCount = 0;
+static mfsStreamWriteFunction stringStreamWrite = NULL;
+
+static mfError CountingWrite(void* stream, const mfmU8* data, mfmU64 dataSize, mfmU64* outSize)
+{
+	++writeCount;
+	return stringStreamWrite(stream, data, dataSize, outSize);
+}
+
+int main()
+{
+	// Printing
+	{
+		mfmU8 buffer[1024];
+		mfsStringStream ss;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, buffer, sizeof(buffer)) == MF_ERROR_OKAY);
+		stringStreamWrite = ss.base.write;
+		ss.base.write = &CountingWrite;
+
+		// The whole formatted string is written at once
+		TEST_REQUIRE_PASS(mfsPrintFormat((mfsStream*)&ss, u8"%d %s %%-bhul %%-d2f \\%c%c", -12, u8"abc", (mfmU64)0xFF, 2.5, 'x') == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(writeCount == 1);
+		TEST_REQUIRE_PASS(ss.head == strlen(u8"-12 abc ff 2.50 %cx"));
+		TEST_REQUIRE_PASS(memcmp(buffer, u8"-12 abc ff 2.50 %cx", ss.head) == 0);
+
+		writeCount = 0;
+		TEST_REQUIRE_PASS(mfsSeekBegin((mfsStream*)&ss, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString((mfsStream*)&ss, u8"Hello world") == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintU32((mfsStream*)&ss, 1234567, 10) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(writeCount == 2);
+		TEST_REQUIRE_PASS(ss.head == strlen(u8"Hello world1234567"));
+		TEST_REQUIRE_PASS(memcmp(buffer, u8"Hello world1234567", ss.head) == 0);
+
+		// Output longer than the print buffer
+		writeCount = 0;
+		mfsUTF8CodeUnit longString[601];
+		memset(longString, 'a', 600);
+		longString[600] = '\0';
+		TEST_REQUIRE_PASS(mfsSeekBegin((mfsStream*)&ss, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintFormat((mfsStream*)&ss, u8"%s%s", u8"bb", longString) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(ss.head == 602);
+		TEST_REQUIRE_PASS(buffer[1] == 'b' && buffer[2] == 'a' && buffer[601] == 'a');
+		TEST_REQUIRE_PASS(writeCount <= 3);
+
+		// Output which doesn't fit in the stream
+		mfsStringStream small;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&small, buffer, 4) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfsPrintFormat((mfsStream*)&small, u8"%d", 123456) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(memcmp(buffer, u8"1234", 4) == 0);
+	}
+
+	// Reading
+	{
+		mfmU8 buffer[1024];
+
+		for (int seekable = 0; seekable < 2; ++seekable)
+		{
+			// Streams which can't seek are read byte by byte
+			mfsStringStream ss;
+			TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, buffer, sizeof(buffer)) == MF_ERROR_OKAY);
+			if (seekable == 0)
+				ss.base.seekHead = NULL;
+
+			for (mfmU64 i = 0; i < sizeof(buffer); ++i)
+				buffer[i] = (mfmU8)('a' + i % 26);
+			memcpy(buffer + 300, u8"::", 2);
+			memcpy(buffer + 700, u8" \n", 2);
+
+			// The terminator is past the first chunk, the stream is left right after it
+			mfmU8 out[1024];
+			mfmU64 size = 0;
+			TEST_REQUIRE_PASS(mfsReadUntil((mfsStream*)&ss, out, sizeof(out), &size, u8"::") == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(size == 300);
+			TEST_REQUIRE_PASS(memcmp(out, buffer, 300) == 0 && out[300] == '\0');
+			TEST_REQUIRE_PASS(ss.head == 302);
+
+			// Whitespace separated
+			TEST_REQUIRE_PASS(mfsReadUntil((mfsStream*)&ss, out, sizeof(out), &size, NULL) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(size == 398);
+			TEST_REQUIRE_PASS(ss.head == 701);
+
+			// Output buffer full
+			TEST_REQUIRE_PASS(mfsReadUntil((mfsStream*)&ss, out, 11, &size, u8"::") == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(size == 10);
+			TEST_REQUIRE_PASS(memcmp(out, buffer + 701, 10) == 0);
+			TEST_REQUIRE_PASS(ss.head == 711);
+
+			// Stream end
+			TEST_REQUIRE_PASS(mfsReadUntil((mfsStream*)&ss, out, sizeof(out), &size, u8"::") == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(size == 1024 - 711);
+			TEST_REQUIRE_PASS(ss.head == 1024);
+		}
+	}
+
+	EXIT_PASS();
+}
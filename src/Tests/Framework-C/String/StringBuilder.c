@@ -0,0 +1,132 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/String/StringBuilder.h>
+#include <Magma/Framework/Memory/Allocator.h>
+#include <Magma/Framework/Memory/LinearAllocator.h>
+#include <Magma/Framework/Memory/StackAllocator.h>
+
+#include <string.h>
+
+// Clears the builder and writes numbered lines until it holds at least size bytes, then checks the data against the expected output
+static void WriteLines(mfsStream* stream, mfmU64 size)
+{
+	mfsUTF8CodeUnit expected[16384];
+	mfmU64 expectedSize = 0;
+
+	TEST_REQUIRE_PASS(mfsClearStringBuilder(stream) == MF_ERROR_OKAY);
+
+	for (mfmU32 i = 0; expectedSize < size; ++i)
+	{
+		TEST_REQUIRE_PASS(mfsPrintFormat(stream, u8"line %%u\n", i) == MF_ERROR_OKAY);
+		expectedSize += sprintf(expected + expectedSize, "line %u\n", i);
+	}
+
+	const mfsUTF8CodeUnit* data = NULL;
+	mfmU64 dataSize = 0;
+	TEST_REQUIRE_PASS(mfsGetStringBuilderData(stream, &data, &dataSize) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(dataSize == expectedSize);
+	TEST_REQUIRE_PASS(strcmp(data, expected) == 0);
+}
+
+int main()
+{
+	// Inline buffer and growth on the standard allocator
+	{
+		mfsStringBuilder sb;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringBuilder(&sb, NULL) == MF_ERROR_OKAY);
+		mfsStream* stream = (mfsStream*)&sb;
+
+		const mfsUTF8CodeUnit* data = NULL;
+		mfmU64 size = 1;
+		TEST_REQUIRE_PASS(mfsGetStringBuilderData(stream, &data, &size) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(size == 0 && data[0] == '\0');
+
+		WriteLines(stream, 100);
+		TEST_REQUIRE_PASS(sb.base.buffer == sb.inlineBuffer);
+		WriteLines(stream, 10000);
+		TEST_REQUIRE_PASS(sb.base.buffer != sb.inlineBuffer);
+
+		// Clearing keeps the allocated data
+		mfmU8* buffer = sb.base.buffer;
+		WriteLines(stream, 1000);
+		TEST_REQUIRE_PASS(sb.base.buffer == buffer);
+
+		mfsDestroyLocalStringBuilder(&sb);
+	}
+
+	// Seeking, overwriting and reading back
+	{
+		mfsStream* stream = NULL;
+		TEST_REQUIRE_PASS(mfsCreateStringBuilder(&stream, NULL) == MF_ERROR_OKAY);
+
+		TEST_REQUIRE_PASS(mfsPutString(stream, u8"Hello world") == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsSeekBegin(stream, 6) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(stream, u8"there") == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(stream, u8"!") == MF_ERROR_OKAY);
+
+		mfsUTF8CodeUnit read[16] = { 0 };
+		mfmU64 readSize = 0;
+		TEST_REQUIRE_PASS(mfsSeekBegin(stream, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsRead(stream, read, sizeof(read), &readSize) == MFS_ERROR_EOF);
+		TEST_REQUIRE_PASS(readSize == 12 && strcmp(read, u8"Hello there!") == 0);
+		TEST_REQUIRE_PASS(mfsSeekEnd(stream, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPutString(stream, u8"?") == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfsSeekBegin(stream, 13) == MF_ERROR_OKAY);
+
+		// The data is handed off, and the builder can still be used afterwards
+		mfsUTF8CodeUnit* data = NULL;
+		mfmU64 size = 0;
+		TEST_REQUIRE_PASS(mfsTakeStringBuilderData(stream, &data, &size) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(size == 12 && strcmp(data, u8"Hello there?") == 0);
+		TEST_REQUIRE_PASS(mfmDeallocate(NULL, data) == MF_ERROR_OKAY);
+
+		WriteLines(stream, 2000);
+		mfmU8* buffer = ((mfsStringBuilder*)stream)->base.buffer;
+		TEST_REQUIRE_PASS(mfsTakeStringBuilderData(stream, &data, &size) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS((mfmU8*)data == buffer && size >= 2000 && data[size] == '\0');
+		TEST_REQUIRE_PASS(mfmDeallocate(NULL, data) == MF_ERROR_OKAY);
+
+		mfsDestroyStringBuilder(stream);
+	}
+
+	// Growth on linear and stack allocators
+	{
+		mfmLinearAllocator* linear = NULL;
+		TEST_REQUIRE_PASS(mfmCreateLinearAllocator(&linear, 65536) == MF_ERROR_OKAY);
+		mfsStream* stream = NULL;
+		TEST_REQUIRE_PASS(mfsCreateStringBuilder(&stream, linear) == MF_ERROR_OKAY);
+		WriteLines(stream, 12000);
+		mfsDestroyStringBuilder(stream);
+		mfmDestroyLinearAllocator(linear);
+
+		mfmStackAllocator* stack = NULL;
+		TEST_REQUIRE_PASS(mfmCreateStackAllocator(&stack, 65536) == MF_ERROR_OKAY);
+		mfsStringBuilder sb;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringBuilder(&sb, stack) == MF_ERROR_OKAY);
+		WriteLines((mfsStream*)&sb, 12000);
+		mfsDestroyLocalStringBuilder(&sb);
+
+		// An allocation between two growths makes the data move
+		TEST_REQUIRE_PASS(mfsCreateLocalStringBuilder(&sb, stack) == MF_ERROR_OKAY);
+		WriteLines((mfsStream*)&sb, 300);
+		void* memory = NULL;
+		TEST_REQUIRE_PASS(mfmAllocate(stack, &memory, 16) == MF_ERROR_OKAY);
+		mfmU8* buffer = sb.base.buffer;
+		WriteLines((mfsStream*)&sb, 1000);
+		TEST_REQUIRE_PASS(sb.base.buffer != buffer);
+		mfsDestroyLocalStringBuilder(&sb);
+		mfmDestroyStackAllocator(stack);
+
+		// Growth fails when the allocator is full
+		TEST_REQUIRE_PASS(mfmCreateLinearAllocator(&linear, 1024) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsCreateLocalStringBuilder(&sb, linear) == MF_ERROR_OKAY);
+		mfsUTF8CodeUnit large[2048];
+		memset(large, 'a', sizeof(large) - 1);
+		large[sizeof(large) - 1] = '\0';
+		TEST_REQUIRE_FAIL(mfsPutString((mfsStream*)&sb, large) == MF_ERROR_OKAY);
+		mfsDestroyLocalStringBuilder(&sb);
+		mfmDestroyLinearAllocator(linear);
+	}
+
+	EXIT_PASS();
+}
@@ -0,0 +1,198 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/String/UTF8.h>
+
+#include <string.h>
+
+#define MAX_BUFFER_SIZE 512
+
+static mfmU64 state = 1;
+
+static mfmU32 Random(void)
+{
+	state = state * 6364136223846793005 + 1442695040888963407;
+	return (mfmU32)(state >> 33);
+}
+
+// Appends a random valid character, a run of ASCII, or an invalid sequence
+static mfmU64 AppendRandom(mfmU8* buffer, mfmU64 size)
+{
+	static const mfmU8 invalid[][4] =
+	{
+		{ 0x80 }, { 0xBF }, { 0xC0, 0x80 }, { 0xC1, 0xBF }, { 0xE0, 0x80, 0x80 }, { 0xE0, 0x9F, 0xBF },
+		{ 0xED, 0xA0, 0x80 }, { 0xED, 0xBF, 0xBF }, { 0xF0, 0x8F, 0xBF, 0xBF }, { 0xF4, 0x90, 0x80, 0x80 },
+		{ 0xF5, 0x80, 0x80, 0x80 }, { 0xFF }, { 0xFE }, { 0xC2 }, { 0xE2, 0x82 }, { 0xF0, 0x9F, 0x98 },
+	};
+
+	mfmU32 choice = Random() % 100;
+	if (choice < 40)
+	{
+		mfmU64 runSize = Random() % 64;
+		for (mfmU64 i = 0; i < runSize && size + i < MAX_BUFFER_SIZE; ++i)
+			buffer[size + i] = (mfmU8)(Random() % 0x80);
+		return size + runSize < MAX_BUFFER_SIZE ? size + runSize : MAX_BUFFER_SIZE;
+	}
+	else if (choice < 98)
+	{
+		mfsUnicodePoint up;
+		do
+		{
+			switch (Random() % 4)
+			{
+				case 0: up = Random() % 0x80; break;
+				case 1: up = Random() % 0x800; break;
+				case 2: up = Random() % 0x10000; break;
+				default: up = Random() % 0x110000; break;
+			}
+		} while (mfsIsValidUTF32Char(up) == MFM_FALSE);
+
+		mfmU64 chrSize = 0;
+		if (mfsSetUTF8Char(up, (mfsUTF8CodeUnit*)buffer + size, &chrSize, MAX_BUFFER_SIZE - size) != MF_ERROR_OKAY)
+			return size;
+		return size + chrSize;
+	}
+	else
+	{
+		const mfmU8* sequence = invalid[Random() % (sizeof(invalid) / sizeof(invalid[0]))];
+		for (mfmU64 i = 0; i < 4 && sequence[i] != 0 && size < MAX_BUFFER_SIZE; ++i)
+			buffer[size++] = sequence[i];
+		return size;
+	}
+}
+
+// Size of the valid part at the start of the buffer, found with the per character functions
+static mfmU64 ReferenceValidSize(const mfmU8* buffer, mfmU64 size)
+{
+	// The per character functions may read past the end of a cut sequence, which must not look like continuation bytes
+	mfmU8 padded[MAX_BUFFER_SIZE + 4] = { 0 };
+	memcpy(padded, buffer, size);
+
+	mfmU64 i = 0;
+	while (i < size)
+	{
+		const mfsUTF8CodeUnit* chr = (const mfsUTF8CodeUnit*)padded + i;
+		mfmU64 chrSize;
+		mfsUnicodePoint up;
+		mfmU64 expectedSize;
+		if (mfsGetUTF8CharSize(chr, &chrSize) != MF_ERROR_OKAY || i + chrSize > size ||
+			mfsIsValidUTF8Char(chr) == MFM_FALSE || mfsGetUTF8Char(chr, &up) != MF_ERROR_OKAY ||
+			mfsGetSizeAsUTF8(up, &expectedSize) != MF_ERROR_OKAY || expectedSize != chrSize) // Overlong encodings aren't checked per character
+			return i;
+		i += chrSize;
+	}
+	return size;
+}
+
+int main()
+{
+	// Fuzzing against the per character functions
+	for (mfmU64 iteration = 0; iteration < 20000; ++iteration)
+	{
+		mfmU8 buffer[MAX_BUFFER_SIZE];
+		mfmU64 size = 0;
+		mfmU64 targetSize = Random() % MAX_BUFFER_SIZE;
+		mfmBool onlyValid = (Random() % 4) == 0 ? MFM_TRUE : MFM_FALSE;
+		while (size < targetSize)
+		{
+			mfmU64 newSize = AppendRandom(buffer, size);
+			if (onlyValid == MFM_TRUE && ReferenceValidSize(buffer, newSize) != newSize)
+				continue;
+			size = newSize;
+		}
+
+		mfmU64 expectedValidSize = ReferenceValidSize(buffer, size);
+		mfmU64 validSize = 0;
+		mfError err = mfsValidateUTF8((const mfsUTF8CodeUnit*)buffer, size, &validSize);
+		TEST_REQUIRE_PASS(validSize == expectedValidSize);
+		TEST_REQUIRE_PASS(err == (expectedValidSize == size ? MF_ERROR_OKAY : MFS_ERROR_INVALID_UTF8));
+
+		// Decoding stops at the same place
+		mfsUTF32CodeUnit utf32[MAX_BUFFER_SIZE];
+		mfmU64 utf32Size = 0;
+		err = mfsUTF8ToUTF32((const mfsUTF8CodeUnit*)buffer, size, utf32, MAX_BUFFER_SIZE, &utf32Size);
+		TEST_REQUIRE_PASS(err == (expectedValidSize == size ? MF_ERROR_OKAY : MFS_ERROR_INVALID_UTF8));
+
+		mfmU64 countedSize = 0;
+		TEST_REQUIRE_PASS(mfsUTF8ToUTF32((const mfsUTF8CodeUnit*)buffer, size, NULL, 0, &countedSize) == err);
+		TEST_REQUIRE_PASS(countedSize == utf32Size);
+
+		// Same characters as the per character functions
+		mfmU64 offset = 0;
+		for (mfmU64 i = 0; i < utf32Size; ++i)
+		{
+			mfsUnicodePoint up;
+			mfmU64 chrSize;
+			TEST_REQUIRE_PASS(mfsGetUTF8Char((const mfsUTF8CodeUnit*)buffer + offset, &up) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mfsGetUTF8CharSize((const mfsUTF8CodeUnit*)buffer + offset, &chrSize) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(utf32[i] == up);
+			offset += chrSize;
+		}
+		TEST_REQUIRE_PASS(offset == expectedValidSize);
+
+		// And back
+		mfsUTF8CodeUnit utf8[MAX_BUFFER_SIZE];
+		mfmU64 utf8Size = 0;
+		TEST_REQUIRE_PASS(mfsUTF32ToUTF8(utf32, utf32Size, utf8, sizeof(utf8), &utf8Size) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(utf8Size == expectedValidSize && memcmp(utf8, buffer, utf8Size) == 0);
+		TEST_REQUIRE_PASS(mfsUTF32ToUTF8(utf32, utf32Size, NULL, 0, &countedSize) == MF_ERROR_OKAY && countedSize == utf8Size);
+	}
+
+	// Invalid unicode point values
+	for (mfmU64 iteration = 0; iteration < 20000; ++iteration)
+	{
+		mfsUTF32CodeUnit utf32[64];
+		mfmU64 size = Random() % 64;
+		mfmU64 expectedSize = 0;
+		mfmU64 expectedValidCount = size;
+		for (mfmU64 i = 0; i < size; ++i)
+		{
+			switch (Random() % 8)
+			{
+				case 0: utf32[i] = 0xD800 + Random() % 0x800; break;
+				case 1: utf32[i] = 0x110000 + Random(); break;
+				default: utf32[i] = Random() % 0x80; break;
+			}
+
+			mfmU64 chrSize;
+			if (expectedValidCount == size)
+			{
+				if (mfsIsValidUTF32Char(utf32[i]) == MFM_FALSE)
+					expectedValidCount = i;
+				else
+				{
+					TEST_REQUIRE_PASS(mfsGetSizeAsUTF8(utf32[i], &chrSize) == MF_ERROR_OKAY);
+					expectedSize += chrSize;
+				}
+			}
+		}
+
+		mfsUTF8CodeUnit utf8[256];
+		mfmU64 utf8Size = 0;
+		mfError err = mfsUTF32ToUTF8(utf32, size, utf8, sizeof(utf8), &utf8Size);
+		TEST_REQUIRE_PASS(err == (expectedValidCount == size ? MF_ERROR_OKAY : MFS_ERROR_INVALID_UNICODE));
+		TEST_REQUIRE_PASS(utf8Size == expectedSize);
+	}
+
+	// Destination buffers which are too small
+	{
+		const mfsUTF8CodeUnit* str = u8"abcdefghijklmnopqrstuvwxyzç€";
+		mfsUTF32CodeUnit utf32[28];
+		mfmU64 size = 0;
+		TEST_REQUIRE_PASS(mfsUTF8ToUTF32(str, strlen(str), utf32, 27, &size) == MFS_ERROR_EOF);
+		TEST_REQUIRE_PASS(size == 27 && utf32[26] == 0xE7);
+		TEST_REQUIRE_PASS(mfsUTF8ToUTF32(str, strlen(str), utf32, 28, &size) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(size == 28 && utf32[27] == 0x20AC);
+
+		mfsUTF8CodeUnit utf8[32];
+		TEST_REQUIRE_PASS(mfsUTF32ToUTF8(utf32, 28, utf8, strlen(str) - 1, &size) == MFS_ERROR_EOF);
+		TEST_REQUIRE_PASS(size == strlen(str) - 3);
+		TEST_REQUIRE_PASS(mfsUTF32ToUTF8(utf32, 28, utf8, strlen(str), &size) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(size == strlen(str) && memcmp(utf8, str, size) == 0);
+
+		TEST_REQUIRE_PASS(mfsValidateUTF8(NULL, 0, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfsValidateUTF8(NULL, 1, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mfsUTF8ToUTF32(str, 1, NULL, 0, NULL) == MF_ERROR_OKAY);
+	}
+
+	EXIT_PASS();
+}
@@ -0,0 +1,101 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Thread/Atomic.h>
+#include <Magma/Framework/Thread/Thread.h>
+#include <Magma/Framework/Entry.h>
+
+#define THREAD_COUNT 4
+#define ITERATION_COUNT 100000
+
+static volatile mfmI32 counter32 = 0;
+static volatile mfmI64 counter64 = 0;
+static volatile mfmI32 casCounter = 0;
+static volatile mfmBool failed = MFM_FALSE;
+
+static void IncrementFunction(void* args)
+{
+	for (mfmU64 i = 0; i < ITERATION_COUNT; ++i)
+	{
+		mfmI32 old32;
+		if (mftAtomic32FetchAdd(&counter32, 1, &old32) != MF_ERROR_OKAY ||
+			mftAtomic64Add(&counter64, 0x100000000) != MF_ERROR_OKAY)
+		{
+			failed = MFM_TRUE;
+			return;
+		}
+
+		// Increment using a compare exchange loop
+		mfmI32 expected;
+		mfmBool exchanged = MFM_FALSE;
+		if (mftAtomic32Load(&casCounter, &expected) != MF_ERROR_OKAY)
+		{
+			failed = MFM_TRUE;
+			return;
+		}
+		while (exchanged == MFM_FALSE)
+			if (mftAtomic32CompareExchange(&casCounter, &expected, expected + 1, &exchanged) != MF_ERROR_OKAY)
+			{
+				failed = MFM_TRUE;
+				return;
+			}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	// Single thread
+	{
+		mfmI32 value32 = 5;
+		mfmI32 out32;
+		mfmBool exchanged;
+		TEST_REQUIRE_PASS(mftAtomic32FetchAdd(&value32, 3, &out32) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(out32 == 5 && value32 == 8);
+
+		out32 = 7;
+		TEST_REQUIRE_PASS(mftAtomic32CompareExchange(&value32, &out32, 10, &exchanged) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(exchanged == MFM_FALSE && out32 == 8 && value32 == 8);
+		TEST_REQUIRE_PASS(mftAtomic32CompareExchange(&value32, &out32, 10, &exchanged) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(exchanged == MFM_TRUE && value32 == 10);
+
+		mfmI64 value64;
+		mfmI64 out64;
+		TEST_REQUIRE_PASS(mftAtomic64Store(&value64, 0x123456789) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftAtomic64Load(&value64, &out64) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(out64 == 0x123456789);
+		TEST_REQUIRE_PASS(mftAtomic64FetchAdd(&value64, -0x100000000, &out64) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(out64 == 0x123456789 && value64 == 0x23456789);
+		out64 = 0x23456789;
+		TEST_REQUIRE_PASS(mftAtomic64CompareExchange(&value64, &out64, -1, &exchanged) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(exchanged == MFM_TRUE && value64 == -1);
+
+		int a, b;
+		volatile void* pointer = &a;
+		void* expected = &b;
+		TEST_REQUIRE_PASS(mftAtomicPointerCompareExchange(&pointer, &expected, &b, &exchanged) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(exchanged == MFM_FALSE && expected == &a);
+		TEST_REQUIRE_PASS(mftAtomicPointerCompareExchange(&pointer, &expected, &b, &exchanged) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(exchanged == MFM_TRUE && pointer == &b);
+	}
+
+	// Multiple threads
+	{
+		mftThread* threads[THREAD_COUNT];
+		for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+			TEST_REQUIRE_PASS(mftCreateThread(&threads[i], &IncrementFunction, NULL, NULL) == MF_ERROR_OKAY);
+		for (mfmU64 i = 0; i < THREAD_COUNT; ++i)
+		{
+			TEST_REQUIRE_PASS(mftWaitForThread(threads[i], 0) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftDestroyThread(threads[i]) == MF_ERROR_OKAY);
+		}
+
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+		TEST_REQUIRE_PASS(counter32 == THREAD_COUNT * ITERATION_COUNT);
+		TEST_REQUIRE_PASS(counter64 == (mfmI64)THREAD_COUNT * ITERATION_COUNT * 0x100000000);
+		TEST_REQUIRE_PASS(casCounter == THREAD_COUNT * ITERATION_COUNT);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
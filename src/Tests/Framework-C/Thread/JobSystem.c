@@ -0,0 +1,179 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Thread/JobSystem.h>
+#include <Magma/Framework/Thread/Atomic.h>
+#include <Magma/Framework/Entry.h>
+
+#define JOB_COUNT 10000
+#define CHILD_COUNT 16
+
+static mftJobSystem* jobSystem = NULL;
+static volatile mfmI32 sum = 0;
+static volatile mfmI32 stage = 0;
+static volatile mfmBool failed = MFM_FALSE;
+static mfmI32 values[JOB_COUNT];
+
+static void AddFunction(void* args)
+{
+	if (mftAtomic32Add(&sum, *(mfmI32*)args) != MF_ERROR_OKAY)
+		failed = MFM_TRUE;
+}
+
+static void FirstStageFunction(void* args)
+{
+	mfmI32 value;
+	mftAtomic32Load(&stage, &value);
+	if (value != 0)
+		failed = MFM_TRUE;
+	mftAtomic32Add(&sum, 1);
+}
+
+static void SecondStageFunction(void* args)
+{
+	// All the first stage jobs must have finished
+	mfmI32 value;
+	mftAtomic32Load(&sum, &value);
+	if (value != CHILD_COUNT)
+		failed = MFM_TRUE;
+	mftAtomic32Store(&stage, 1);
+}
+
+static void AllDependenciesFunction(void* args)
+{
+	// The jobs of both dependencies must have finished
+	mfmI32 value;
+	mftAtomic32Load(&sum, &value);
+	if (value != 2 * CHILD_COUNT)
+		failed = MFM_TRUE;
+	mftAtomic32Store(&stage, 1);
+}
+
+static void ChildFunction(void* args)
+{
+	mftAtomic32Add(&sum, 1);
+}
+
+static void ParentFunction(void* args)
+{
+	// Submit jobs from inside a job and wait for them, running them on this worker if needed
+	mftJobCounter counter;
+	mftInitJobCounter(&counter);
+	for (mfmU32 i = 0; i < CHILD_COUNT; ++i)
+		if (mftSubmitJob(jobSystem, &ChildFunction, NULL, &counter) != MF_ERROR_OKAY)
+			failed = MFM_TRUE;
+	if (mftWaitForJobCounter(jobSystem, &counter) != MF_ERROR_OKAY || counter.value != 0)
+		failed = MFM_TRUE;
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	{
+		mftJobSystemDesc desc;
+		desc.workerCount = 4;
+		desc.queueSize = 100;
+		desc.jobCapacity = 256;
+		TEST_REQUIRE_FAIL(mftCreateJobSystem(&jobSystem, &desc, NULL) == MF_ERROR_OKAY);
+
+		desc.queueSize = 64;
+		TEST_REQUIRE_PASS(mftCreateJobSystem(&jobSystem, &desc, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftGetJobSystemWorkerCount(jobSystem) == 4);
+
+		mftJobCounter counter;
+		mftInitJobCounter(&counter);
+		TEST_REQUIRE_FAIL(mftSubmitJob(jobSystem, NULL, NULL, &counter) == MF_ERROR_OKAY);
+
+		// Fan out more jobs than the job capacity
+		mfmI32 expected = 0;
+		for (mfmI32 i = 0; i < JOB_COUNT; ++i)
+		{
+			values[i] = i % 7;
+			expected += values[i];
+			TEST_REQUIRE_PASS(mftSubmitJob(jobSystem, &AddFunction, &values[i], &counter) == MF_ERROR_OKAY);
+		}
+		TEST_REQUIRE_PASS(mftWaitForJobCounter(jobSystem, &counter) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(sum == expected);
+
+		// Batches
+		sum = 0;
+		TEST_REQUIRE_PASS(mftSubmitJobBatch(jobSystem, &AddFunction, values, sizeof(mfmI32), JOB_COUNT, &counter) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftWaitForJobCounter(jobSystem, &counter) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(sum == expected);
+
+		// Dependencies
+		for (mfmU32 run = 0; run < 100; ++run)
+		{
+			mftJobCounter firstStage, secondStage;
+			mftInitJobCounter(&firstStage);
+			mftInitJobCounter(&secondStage);
+			sum = 0;
+			stage = 0;
+			for (mfmU32 i = 0; i < CHILD_COUNT; ++i)
+				TEST_REQUIRE_PASS(mftSubmitJob(jobSystem, &FirstStageFunction, NULL, &firstStage) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftSubmitJobAfter(jobSystem, &SecondStageFunction, NULL, &firstStage, &secondStage) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftWaitForJobCounter(jobSystem, &secondStage) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(stage == 1);
+		}
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+
+		// A finished dependency doesn't hold the job back
+		{
+			mftJobCounter done, after;
+			mftInitJobCounter(&done);
+			mftInitJobCounter(&after);
+			sum = 0;
+			TEST_REQUIRE_PASS(mftSubmitJobAfter(jobSystem, &ChildFunction, NULL, &done, &after) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftWaitForJobCounter(jobSystem, &after) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(sum == 1);
+		}
+
+		// Multiple dependencies, the second one only starts after the first one finishes
+		for (mfmU32 run = 0; run < 100; ++run)
+		{
+			mftJobCounter first, second, after;
+			mftInitJobCounter(&first);
+			mftInitJobCounter(&second);
+			mftInitJobCounter(&after);
+			mftJobCounter* dependencies[2] = { &first, &second };
+			sum = 0;
+			stage = 0;
+			for (mfmU32 i = 0; i < CHILD_COUNT; ++i)
+			{
+				TEST_REQUIRE_PASS(mftSubmitJob(jobSystem, &ChildFunction, NULL, &first) == MF_ERROR_OKAY);
+				TEST_REQUIRE_PASS(mftSubmitJobAfter(jobSystem, &ChildFunction, NULL, &first, &second) == MF_ERROR_OKAY);
+			}
+			TEST_REQUIRE_PASS(mftSubmitJobAfterAll(jobSystem, &AllDependenciesFunction, NULL, dependencies, 2, &after) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftWaitForJobCounter(jobSystem, &after) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(stage == 1);
+		}
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+
+		{
+			mftJobCounter after;
+			mftInitJobCounter(&after);
+			mftJobCounter* dependencies[1] = { NULL };
+			TEST_REQUIRE_FAIL(mftSubmitJobAfterAll(jobSystem, &ChildFunction, NULL, NULL, 1, &after) == MF_ERROR_OKAY);
+			TEST_REQUIRE_FAIL(mftSubmitJobAfterAll(jobSystem, &ChildFunction, NULL, dependencies, 1, &after) == MF_ERROR_OKAY);
+
+			// Without dependencies the job is queued right away
+			sum = 0;
+			TEST_REQUIRE_PASS(mftSubmitJobAfterAll(jobSystem, &ChildFunction, NULL, NULL, 0, &after) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftWaitForJobCounter(jobSystem, &after) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(sum == 1);
+		}
+
+		// Nested jobs, with more waiting parents than workers
+		sum = 0;
+		for (mfmU32 i = 0; i < 64; ++i)
+			TEST_REQUIRE_PASS(mftSubmitJob(jobSystem, &ParentFunction, NULL, &counter) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftWaitForJobCounter(jobSystem, &counter) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(sum == 64 * CHILD_COUNT);
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+
+		TEST_REQUIRE_PASS(mftDestroyJobSystem(jobSystem) == MF_ERROR_OKAY);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
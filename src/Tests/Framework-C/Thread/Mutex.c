@@ -0,0 +1,70 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Thread/Mutex.h>
+#include <Magma/Framework/Thread/Thread.h>
+#include <Magma/Framework/Thread/Atomic.h>
+#include <Magma/Framework/Entry.h>
+
+static mftMutex* mutex = NULL;
+static volatile mfmI32 state = 0;
+static volatile mfmBool failed = MFM_FALSE;
+
+static void LockFunction(void* args)
+{
+	// The mutex is held by the main thread
+	if (mftTryLockMutex(mutex) != MFT_ERROR_MUTEX_LOCKED ||
+		mftLockMutex(mutex, 10) != MFT_ERROR_TIMEOUT)
+		failed = MFM_TRUE;
+	mftAtomic32Store(&state, 1);
+
+	// Wait for the main thread to unlock it
+	if (mftLockMutex(mutex, 0) != MF_ERROR_OKAY)
+		failed = MFM_TRUE;
+	mftAtomic32Store(&state, 2);
+	if (mftUnlockMutex(mutex) != MF_ERROR_OKAY)
+		failed = MFM_TRUE;
+}
+
+static void SleepFunction(void* args)
+{
+	mfmI32 value = 0;
+	while (value == 0)
+		mftAtomic32Load(&state, &value);
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	TEST_REQUIRE_PASS(mftCreateMutex(&mutex, NULL) == MF_ERROR_OKAY);
+
+	// Mutexes can be locked recursively by the same thread
+	TEST_REQUIRE_PASS(mftLockMutex(mutex, 0) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftTryLockMutex(mutex) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftUnlockMutex(mutex) == MF_ERROR_OKAY);
+
+	mftThread* thread;
+	TEST_REQUIRE_PASS(mftCreateThread(&thread, &LockFunction, NULL, NULL) == MF_ERROR_OKAY);
+	mfmI32 value = 0;
+	while (value == 0)
+		TEST_REQUIRE_PASS(mftAtomic32Load(&state, &value) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftUnlockMutex(mutex) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftWaitForThread(thread, 0) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftDestroyThread(thread) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(failed == MFM_FALSE);
+	TEST_REQUIRE_PASS(state == 2);
+
+	// Waiting for a thread with a timeout
+	TEST_REQUIRE_PASS(mftAtomic32Store(&state, 0) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftCreateThread(&thread, &SleepFunction, NULL, NULL) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftWaitForThread(thread, 10) == MFT_ERROR_TIMEOUT);
+	TEST_REQUIRE_PASS(mftDestroyThread(thread) == MFT_ERROR_STILL_RUNNING);
+	TEST_REQUIRE_PASS(mftAtomic32Store(&state, 1) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftWaitForThread(thread, 10000) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mftDestroyThread(thread) == MF_ERROR_OKAY);
+
+	TEST_REQUIRE_PASS(mftDestroyMutex(mutex) == MF_ERROR_OKAY);
+
+	mfTerminate();
+	EXIT_PASS();
+}
@@ -0,0 +1,205 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/Thread/Queue.h>
+#include <Magma/Framework/Thread/Thread.h>
+#include <Magma/Framework/Thread/Atomic.h>
+#include <Magma/Framework/Entry.h>
+
+#define ITEM_COUNT 100000
+#define PRODUCER_COUNT 3
+#define CONSUMER_COUNT 3
+
+static mftSPSCQueue* spsc = NULL;
+static mftMPMCQueue* mpmc = NULL;
+static volatile mfmBool failed = MFM_FALSE;
+static volatile mfmI64 consumedSum = 0;
+static volatile mfmI64 consumedCount = 0;
+
+static void SPSCProducerFunction(void* args)
+{
+	mfmU64 batch[5];
+	for (mfmU64 i = 0; i < ITEM_COUNT;)
+	{
+		// Alternate between single and batch pushes
+		if (i % 2 == 0)
+		{
+			if (mftPushSPSCQueue(spsc, &i, 0) != MF_ERROR_OKAY)
+				failed = MFM_TRUE;
+			++i;
+		}
+		else
+		{
+			mfmU64 count = ITEM_COUNT - i < 5 ? ITEM_COUNT - i : 5;
+			for (mfmU64 j = 0; j < count; ++j)
+				batch[j] = i + j;
+			mfmU64 pushed = 0;
+			if (mftPushSPSCQueueBatch(spsc, batch, count, &pushed) == MFT_ERROR_QUEUE_FULL)
+			{
+				if (mftPushSPSCQueue(spsc, batch, 0) != MF_ERROR_OKAY)
+					failed = MFM_TRUE;
+				pushed = 1;
+			}
+			i += pushed;
+		}
+	}
+}
+
+static void MPMCProducerFunction(void* args)
+{
+	mfmU64 batch[4];
+	for (mfmU64 i = 1; i <= ITEM_COUNT;)
+	{
+		if (i % 3 != 0)
+		{
+			if (mftPushMPMCQueue(mpmc, &i, 0) != MF_ERROR_OKAY)
+				failed = MFM_TRUE;
+			++i;
+		}
+		else
+		{
+			mfmU64 count = ITEM_COUNT + 1 - i < 4 ? ITEM_COUNT + 1 - i : 4;
+			for (mfmU64 j = 0; j < count; ++j)
+				batch[j] = i + j;
+			mfmU64 pushed = 0;
+			if (mftPushMPMCQueueBatch(mpmc, batch, count, &pushed) == MFT_ERROR_QUEUE_FULL)
+			{
+				if (mftPushMPMCQueue(mpmc, batch, 0) != MF_ERROR_OKAY)
+					failed = MFM_TRUE;
+				pushed = 1;
+			}
+			i += pushed;
+		}
+	}
+}
+
+static void MPMCConsumerFunction(void* args)
+{
+	mfmU64 batch[8];
+	for (;;)
+	{
+		mfmI64 count;
+		mftAtomic64Load(&consumedCount, &count);
+		if (count >= ITEM_COUNT * PRODUCER_COUNT)
+			break;
+
+		// When the queue is empty, wait for a single element so the producers get to run
+		mfmU64 popped = 0;
+		if (mftPopMPMCQueueBatch(mpmc, batch, 8, &popped) != MF_ERROR_OKAY)
+		{
+			if (mftPopMPMCQueue(mpmc, batch, 1) != MF_ERROR_OKAY)
+				continue;
+			popped = 1;
+		}
+		for (mfmU64 i = 0; i < popped; ++i)
+			mftAtomic64Add(&consumedSum, (mfmI64)batch[i]);
+		mftAtomic64Add(&consumedCount, (mfmI64)popped);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	// Single producer, single consumer
+	{
+		TEST_REQUIRE_FAIL(mftCreateSPSCQueue(&spsc, sizeof(mfmU64), 100, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_FAIL(mftCreateSPSCQueue(&spsc, 0, 64, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftCreateSPSCQueue(&spsc, sizeof(mfmU64), 4, NULL) == MF_ERROR_OKAY);
+
+		mfmU64 value = 0;
+		TEST_REQUIRE_PASS(mftTryPopSPSCQueue(spsc, &value) == MFT_ERROR_QUEUE_EMPTY);
+		TEST_REQUIRE_PASS(mftPopSPSCQueue(spsc, &value, 5) == MFT_ERROR_TIMEOUT);
+		for (mfmU64 i = 0; i < 4; ++i)
+			TEST_REQUIRE_PASS(mftTryPushSPSCQueue(spsc, &i) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftTryPushSPSCQueue(spsc, &value) == MFT_ERROR_QUEUE_FULL);
+		TEST_REQUIRE_PASS(mftPushSPSCQueue(spsc, &value, 5) == MFT_ERROR_TIMEOUT);
+		for (mfmU64 i = 0; i < 2; ++i)
+		{
+			TEST_REQUIRE_PASS(mftTryPopSPSCQueue(spsc, &value) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(value == i);
+		}
+
+		// Batches wrap around the end of the buffer and are cut to the free space
+		mfmU64 values[4] = { 10, 11, 12, 13 };
+		mfmU64 count = 0;
+		TEST_REQUIRE_PASS(mftPushSPSCQueueBatch(spsc, values, 4, &count) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(count == 2);
+		TEST_REQUIRE_PASS(mftPushSPSCQueueBatch(spsc, values, 4, &count) == MFT_ERROR_QUEUE_FULL);
+		TEST_REQUIRE_PASS(count == 0);
+		mfmU64 out[8];
+		TEST_REQUIRE_PASS(mftPopSPSCQueueBatch(spsc, out, 8, &count) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(count == 4);
+		TEST_REQUIRE_PASS(out[0] == 2 && out[1] == 3 && out[2] == 10 && out[3] == 11);
+		TEST_REQUIRE_PASS(mftPopSPSCQueueBatch(spsc, out, 8, &count) == MFT_ERROR_QUEUE_EMPTY);
+		TEST_REQUIRE_PASS(mftDestroySPSCQueue(spsc) == MF_ERROR_OKAY);
+
+		// Elements arrive in order across threads
+		TEST_REQUIRE_PASS(mftCreateSPSCQueue(&spsc, sizeof(mfmU64), 64, NULL) == MF_ERROR_OKAY);
+		mftThread* producer;
+		TEST_REQUIRE_PASS(mftCreateThread(&producer, &SPSCProducerFunction, NULL, NULL) == MF_ERROR_OKAY);
+		for (mfmU64 i = 0; i < ITEM_COUNT;)
+		{
+			if (i % 3 == 0)
+			{
+				TEST_REQUIRE_PASS(mftPopSPSCQueue(spsc, &value, 0) == MF_ERROR_OKAY);
+				TEST_REQUIRE_PASS(value == i);
+				++i;
+			}
+			else
+			{
+				if (mftPopSPSCQueueBatch(spsc, out, 8, &count) == MFT_ERROR_QUEUE_EMPTY)
+				{
+					TEST_REQUIRE_PASS(mftPopSPSCQueue(spsc, out, 0) == MF_ERROR_OKAY);
+					count = 1;
+				}
+				for (mfmU64 j = 0; j < count; ++j)
+					TEST_REQUIRE_PASS(out[j] == i + j);
+				i += count;
+			}
+		}
+		TEST_REQUIRE_PASS(mftWaitForThread(producer, 0) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftDestroyThread(producer) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+		TEST_REQUIRE_PASS(mftDestroySPSCQueue(spsc) == MF_ERROR_OKAY);
+	}
+
+	// Multiple producers, multiple consumers
+	{
+		TEST_REQUIRE_FAIL(mftCreateMPMCQueue(&mpmc, sizeof(mfmU64), 1, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftCreateMPMCQueue(&mpmc, sizeof(mfmU64), 4, NULL) == MF_ERROR_OKAY);
+
+		mfmU64 value = 0;
+		TEST_REQUIRE_PASS(mftTryPopMPMCQueue(mpmc, &value) == MFT_ERROR_QUEUE_EMPTY);
+		for (mfmU64 i = 0; i < 4; ++i)
+			TEST_REQUIRE_PASS(mftTryPushMPMCQueue(mpmc, &i) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mftTryPushMPMCQueue(mpmc, &value) == MFT_ERROR_QUEUE_FULL);
+		TEST_REQUIRE_PASS(mftPushMPMCQueue(mpmc, &value, 5) == MFT_ERROR_TIMEOUT);
+		for (mfmU64 i = 0; i < 4; ++i)
+		{
+			TEST_REQUIRE_PASS(mftPopMPMCQueue(mpmc, &value, 5) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(value == i);
+		}
+		TEST_REQUIRE_PASS(mftPopMPMCQueue(mpmc, &value, 5) == MFT_ERROR_TIMEOUT);
+		TEST_REQUIRE_PASS(mftDestroyMPMCQueue(mpmc) == MF_ERROR_OKAY);
+
+		// Every element is received exactly once
+		TEST_REQUIRE_PASS(mftCreateMPMCQueue(&mpmc, sizeof(mfmU64), 128, NULL) == MF_ERROR_OKAY);
+		mftThread* threads[PRODUCER_COUNT + CONSUMER_COUNT];
+		for (mfmU64 i = 0; i < PRODUCER_COUNT; ++i)
+			TEST_REQUIRE_PASS(mftCreateThread(&threads[i], &MPMCProducerFunction, NULL, NULL) == MF_ERROR_OKAY);
+		for (mfmU64 i = 0; i < CONSUMER_COUNT; ++i)
+			TEST_REQUIRE_PASS(mftCreateThread(&threads[PRODUCER_COUNT + i], &MPMCConsumerFunction, NULL, NULL) == MF_ERROR_OKAY);
+		for (mfmU64 i = 0; i < PRODUCER_COUNT + CONSUMER_COUNT; ++i)
+		{
+			TEST_REQUIRE_PASS(mftWaitForThread(threads[i], 0) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(mftDestroyThread(threads[i]) == MF_ERROR_OKAY);
+		}
+		TEST_REQUIRE_PASS(failed == MFM_FALSE);
+		TEST_REQUIRE_PASS(consumedCount == ITEM_COUNT * PRODUCER_COUNT);
+		TEST_REQUIRE_PASS(consumedSum == (mfmI64)ITEM_COUNT * (ITEM_COUNT + 1) / 2 * PRODUCER_COUNT);
+		TEST_REQUIRE_PASS(mftDestroyMPMCQueue(mpmc) == MF_ERROR_OKAY);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
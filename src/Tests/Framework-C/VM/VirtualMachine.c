@@ -0,0 +1,397 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/VM/VirtualMachine.h>
+#include <Magma/Framework/Entry.h>
+
+#include <string.h>
+
+#define U16(x) (mfmU8)((x) >> 8), (mfmU8)(x)
+#define U32(x) (mfmU8)((x) >> 24), (mfmU8)((x) >> 16), (mfmU8)((x) >> 8), (mfmU8)(x)
+#define V2_HEADER 0xFE, 0x02, 0x00
+
+static mfError Double8(mfvVirtualMachine* vm)
+{
+	mfmU8 value;
+	mfError err = mfvVirtualMachinePop8(vm, &value);
+	if (err != MF_ERROR_OKAY)
+		return err;
+	value *= 2;
+	return mfvVirtualMachinePush8(vm, &value);
+}
+
+static mfvVirtualMachine* CreateVM(const mfmU8* code, mfmU64 size)
+{
+	mfvVirtualMachine* vm;
+	mfvVirtualMachineDesc desc;
+	desc.callStackSize = 16;
+	desc.functionTableSize = 16;
+	desc.registerCount = 16;
+	desc.stackSize = 256;
+	TEST_REQUIRE_PASS(mfvCreateVirtualMachine(&vm, &desc, NULL) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mfvSetVirtualMachineFunction(vm, 1, &Double8) == MF_ERROR_OKAY);
+	if (code != NULL)
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, code, size) == MF_ERROR_OKAY);
+	return vm;
+}
+
+// Runs a program with mfvRunVirtualMachine and by stepping it, checks that both end the same way and returns the stack size
+static mfmU64 Check(const mfmU8* code, mfmU64 size, mfError expectedErr, mfvVirtualMachineState expectedState, mfmU8* stack)
+{
+	mfvVirtualMachine* runVM = CreateVM(code, size);
+	mfvVirtualMachine* stepVM = CreateVM(code, size);
+
+	mfmU64 executed;
+	mfvVirtualMachineState state;
+	TEST_REQUIRE_PASS(mfvRunVirtualMachine(runVM, NULL, &executed, &state) == expectedErr);
+	if (expectedErr == MF_ERROR_OKAY)
+		TEST_REQUIRE_PASS(state == expectedState);
+
+	mfmU64 stepped = 0;
+	mfError err;
+	for (;;)
+	{
+		mfvVirtualMachineState stepState;
+		err = mfvStepVirtualMachine(stepVM, &stepState);
+		if (err != MF_ERROR_OKAY)
+			break;
+		++stepped;
+		if (stepState == MFV_STATE_FINISHED || stepState == MFV_STATE_YIELD)
+			break;
+	}
+	TEST_REQUIRE_PASS(err == expectedErr && stepped == executed);
+
+	// Both stacks must hold the same values
+	mfmU8 values[256];
+	mfmU64 stackSize = 0;
+	for (;;)
+	{
+		mfmU8 runValue, stepValue;
+		err = mfvVirtualMachinePop8(runVM, &runValue);
+		TEST_REQUIRE_PASS(mfvVirtualMachinePop8(stepVM, &stepValue) == err);
+		if (err != MF_ERROR_OKAY)
+			break;
+		TEST_REQUIRE_PASS(runValue == stepValue);
+		values[stackSize++] = runValue;
+	}
+	if (stack != NULL)
+		for (mfmU64 i = 0; i < stackSize; ++i)
+			stack[i] = values[stackSize - i - 1];
+
+	mfvDestroyVirtualMachine(stepVM);
+	mfvDestroyVirtualMachine(runVM);
+	return stackSize;
+}
+
+int main(int argc, char** argv)
+{
+	TEST_REQUIRE_PASS(mfInit(argc, argv) == MF_ERROR_OKAY);
+
+	// Sums 1 to 100 with a loop
+	const mfmU8 sum[] =
+	{
+		MFV_BYTECODE_PUSH32, U32(0), MFV_BYTECODE_STORE32, U32(1),
+		MFV_BYTECODE_PUSH32, U32(100), MFV_BYTECODE_STORE32, U32(0),
+		// Loop (address 20)
+		MFV_BYTECODE_LOAD32, U32(1), MFV_BYTECODE_LOAD32, U32(0), MFV_BYTECODE_ADDU32, MFV_BYTECODE_STORE32, U32(1),
+		MFV_BYTECODE_PUSH32, U32(1), MFV_BYTECODE_LOAD32, U32(0), MFV_BYTECODE_SUBU32,
+		MFV_BYTECODE_PUSH_COPY, 4, MFV_BYTECODE_STORE32, U32(0),
+		MFV_BYTECODE_PUSH32, U32(20), MFV_BYTECODE_JUMP_I32_NOT_ZERO,
+		MFV_BYTECODE_LOAD32, U32(1),
+		MFV_BYTECODE_END,
+	};
+	{
+		mfmU8 stack[256];
+		mfmU32 result;
+		TEST_REQUIRE_PASS(Check(sum, sizeof(sum), MF_ERROR_OKAY, MFV_STATE_FINISHED, stack) == sizeof(result));
+		memcpy(&result, stack, sizeof(result));
+		TEST_REQUIRE_PASS(result == 5050);
+	}
+
+	// Runs limited by an instruction count continue where they stopped
+	{
+		mfvVirtualMachine* vm = CreateVM(sum, sizeof(sum));
+		mfmU64 count = 7, executed, total = 0;
+		mfvVirtualMachineState state;
+		do
+		{
+			TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, &count, &executed, &state) == MF_ERROR_OKAY);
+			TEST_REQUIRE_PASS(executed == count || state == MFV_STATE_FINISHED);
+			total += executed;
+		} while (state == MFV_STATE_UNFINISHED);
+		// The loop's first 4 instructions and the jump are run as 2 translated instructions
+		TEST_REQUIRE_PASS(state == MFV_STATE_FINISHED && total == 2 + 100 * 7 + 2);
+
+		mfmU32 result;
+		TEST_REQUIRE_PASS(mfvVirtualMachinePop32(vm, &result) == MF_ERROR_OKAY && result == 5050);
+		count = 0;
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, &count, &executed, &state) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(executed == 0 && state == MFV_STATE_UNFINISHED);
+		mfvDestroyVirtualMachine(vm);
+	}
+
+	// Every kind of operation
+	{
+		const mfmU8 arithmetic[] =
+		{
+			MFV_BYTECODE_PUSH8, 3, MFV_BYTECODE_PUSH8, 200, MFV_BYTECODE_ADDU8,
+			MFV_BYTECODE_PUSH8, 7, MFV_BYTECODE_PUSH8, (mfmU8)-100, MFV_BYTECODE_DIVS8,
+			MFV_BYTECODE_PUSH16, U16(1000), MFV_BYTECODE_PUSH16, U16(30000), MFV_BYTECODE_MODU16,
+			MFV_BYTECODE_PUSH16, U16(3), MFV_BYTECODE_PUSH16, U16(-7), MFV_BYTECODE_MULS16,
+			MFV_BYTECODE_PUSH32, U32(10), MFV_BYTECODE_PUSH32, U32(3), MFV_BYTECODE_SUBS32,
+			MFV_BYTECODE_PUSH32, U32(0x40000000), MFV_BYTECODE_PUSH32, U32(0x40300000), MFV_BYTECODE_DIVF32,
+			MFV_BYTECODE_PUSH32, U32(0x40300000), MFV_BYTECODE_FRACTF32,
+			MFV_BYTECODE_PUSH32, U32(0xC0300000), MFV_BYTECODE_FLOORF32, MFV_BYTECODE_ADDF32,
+			MFV_BYTECODE_END,
+		};
+		Check(arithmetic, sizeof(arithmetic), MF_ERROR_OKAY, MFV_STATE_FINISHED, NULL);
+
+		const mfmU8 registers[] =
+		{
+			MFV_BYTECODE_PUSH8, 42, MFV_BYTECODE_STORE8, U32(63),
+			MFV_BYTECODE_PUSH16, U16(4242), MFV_BYTECODE_PUSH32, U32(5), MFV_BYTECODE_STORES16,
+			MFV_BYTECODE_PUSH32, U32(63), MFV_BYTECODE_LOADS8,
+			MFV_BYTECODE_LOAD16, U32(5), MFV_BYTECODE_PUSH8, 7, MFV_BYTECODE_PUSH32, U32(15), MFV_BYTECODE_STORES32,
+			MFV_BYTECODE_LOAD32, U32(15), MFV_BYTECODE_POP, 2,
+			MFV_BYTECODE_END,
+		};
+		Check(registers, sizeof(registers), MF_ERROR_OKAY, MFV_STATE_FINISHED, NULL);
+
+		const mfmU8 calls[] =
+		{
+			MFV_BYTECODE_PUSH32, U32(16), MFV_BYTECODE_CALL,
+			MFV_BYTECODE_PUSH8, 21, MFV_BYTECODE_PUSH16, U16(1), MFV_BYTECODE_CALL_BUILTIN,
+			MFV_BYTECODE_YIELD,
+			MFV_BYTECODE_PUSH8, 0, MFV_BYTECODE_END,
+			// Function (address 16)
+			MFV_BYTECODE_PUSH8, 1, MFV_BYTECODE_PUSH32, U32(25), MFV_BYTECODE_JUMP_I8_NOT_ZERO,
+			MFV_BYTECODE_END,
+			MFV_BYTECODE_RETURN,
+		};
+		mfmU8 stack[256];
+		TEST_REQUIRE_PASS(Check(calls, sizeof(calls), MF_ERROR_OKAY, MFV_STATE_YIELD, stack) == 1 && stack[0] == 42);
+	}
+
+	// Version 2 code, with the same loop written with register instructions
+	{
+		const mfmU8 sumV2[] =
+		{
+			V2_HEADER,
+			MFV_BYTECODE_SET_R, U16(0), U32(100), MFV_BYTECODE_SET_R, U16(1), U32(0), MFV_BYTECODE_SET_R, U16(2), U32(0),
+			// Loop (address 24)
+			MFV_BYTECODE_ADDU32_R, U16(1), U16(1), U16(0),
+			MFV_BYTECODE_ADDI_R, U16(0), U16(0), U32(-1),
+			MFV_BYTECODE_JUMP_NOT_EQUAL_R, U16(0), U16(2), U32(24),
+			MFV_BYTECODE_LOAD32, U32(1),
+			MFV_BYTECODE_END,
+		};
+		mfmU8 stack[256];
+		mfmU32 result;
+		TEST_REQUIRE_PASS(Check(sumV2, sizeof(sumV2), MF_ERROR_OKAY, MFV_STATE_FINISHED, stack) == sizeof(result));
+		memcpy(&result, stack, sizeof(result));
+		TEST_REQUIRE_PASS(result == 5050);
+
+		mfvVirtualMachine* vm = CreateVM(sumV2, sizeof(sumV2));
+		mfmU64 executed;
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, NULL, &executed, NULL) == MF_ERROR_OKAY && executed == 3 + 100 * 3 + 2);
+		mfvDestroyVirtualMachine(vm);
+
+		// Computes -3 / 2 in a function, after checking that 2.0 * 0.5 == 1.0
+		const mfmU8 operations[] =
+		{
+			V2_HEADER,
+			MFV_BYTECODE_SET_R, U16(0), U32(0x40000000), MFV_BYTECODE_SET_R, U16(1), U32(0x3F000000),
+			MFV_BYTECODE_MULF32_R, U16(2), U16(0), U16(1), MFV_BYTECODE_SET_R, U16(3), U32(0x3F800000),
+			MFV_BYTECODE_JUMP_LESS_F32_R, U16(2), U16(3), U32(60), MFV_BYTECODE_JUMP_LESS_F32_R, U16(3), U16(2), U32(60),
+			MFV_BYTECODE_CALL_TO, U32(63), MFV_BYTECODE_LOAD32, U32(4), MFV_BYTECODE_END,
+			// Failure (address 60)
+			MFV_BYTECODE_PUSH8, 0xEE, MFV_BYTECODE_END,
+			// Function (address 63)
+			MFV_BYTECODE_SET_R, U16(5), U32(-3), MFV_BYTECODE_SET_R, U16(6), U32(2),
+			MFV_BYTECODE_DIVS32_R, U16(4), U16(5), U16(6), MFV_BYTECODE_MOVE_R, U16(7), U16(4),
+			MFV_BYTECODE_JUMP_LESS_U32_R, U16(7), U16(6), U32(60), MFV_BYTECODE_JUMP_LESS_S32_R, U16(7), U16(6), U32(112),
+			MFV_BYTECODE_JUMP_TO, U32(60),
+			// Return (address 112)
+			MFV_BYTECODE_RETURN,
+		};
+		TEST_REQUIRE_PASS(Check(operations, sizeof(operations), MF_ERROR_OKAY, MFV_STATE_FINISHED, stack) == sizeof(result));
+		memcpy(&result, stack, sizeof(result));
+		TEST_REQUIRE_PASS(result == (mfmU32)-1);
+	}
+
+	// Version 1 sequences translated to register instructions, including a jump into the middle of one
+	{
+		const mfmU8 translated[] =
+		{
+			MFV_BYTECODE_PUSH32, U32(7), MFV_BYTECODE_PUSH32, U32(16), MFV_BYTECODE_JUMP,
+			MFV_BYTECODE_PUSH32, U32(1000),
+			// Address 16
+			MFV_BYTECODE_STORE32, U32(0),
+			MFV_BYTECODE_LOAD32, U32(0), MFV_BYTECODE_LOAD32, U32(0), MFV_BYTECODE_MULU32, MFV_BYTECODE_STORE32, U32(1),
+			MFV_BYTECODE_PUSH32, U32(9), MFV_BYTECODE_LOAD32, U32(1), MFV_BYTECODE_SUBU32, MFV_BYTECODE_STORE32, U32(2),
+			MFV_BYTECODE_LOAD32, U32(2), MFV_BYTECODE_STORE32, U32(3),
+			MFV_BYTECODE_LOAD32, U32(3), MFV_BYTECODE_PUSH32, U32(75), MFV_BYTECODE_JUMP_I32_NOT_ZERO,
+			MFV_BYTECODE_END,
+			// Address 75
+			MFV_BYTECODE_LOAD32, U32(3),
+			MFV_BYTECODE_END,
+		};
+		mfmU8 stack[256];
+		mfmU32 result;
+		TEST_REQUIRE_PASS(Check(translated, sizeof(translated), MF_ERROR_OKAY, MFV_STATE_FINISHED, stack) == sizeof(result));
+		memcpy(&result, stack, sizeof(result));
+		TEST_REQUIRE_PASS(result == 7 * 7 - 9);
+
+		mfvVirtualMachine* vm = CreateVM(translated, sizeof(translated));
+		mfmU64 executed;
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, NULL, &executed, NULL) == MF_ERROR_OKAY && executed == 9);
+		mfvDestroyVirtualMachine(vm);
+	}
+
+	// Overflowing integer operations wrap around
+	{
+		const mfmU8 overflow[] =
+		{
+			MFV_BYTECODE_PUSH32, U32(1), MFV_BYTECODE_PUSH32, U32(0x7FFFFFFF), MFV_BYTECODE_ADDS32,
+			MFV_BYTECODE_PUSH16, U16(0xFFFF), MFV_BYTECODE_PUSH16, U16(0xFFFF), MFV_BYTECODE_MULU16,
+			MFV_BYTECODE_END,
+		};
+		mfmU8 stack[256];
+		mfmU32 result32;
+		mfmU16 result16;
+		TEST_REQUIRE_PASS(Check(overflow, sizeof(overflow), MF_ERROR_OKAY, MFV_STATE_FINISHED, stack) == sizeof(result32) + sizeof(result16));
+		memcpy(&result32, stack, sizeof(result32));
+		memcpy(&result16, stack + sizeof(result32), sizeof(result16));
+		TEST_REQUIRE_PASS(result32 == 0x80000000 && result16 == 1);
+
+		const mfmU8 registerOverflow[] =
+		{
+			V2_HEADER,
+			MFV_BYTECODE_SET_R, U16(0), U32(0x7FFFFFFF), MFV_BYTECODE_SET_R, U16(1), U32(2), MFV_BYTECODE_SET_R, U16(2), U32(0x80000000),
+			MFV_BYTECODE_MULS32_R, U16(3), U16(0), U16(1), MFV_BYTECODE_SUBS32_R, U16(4), U16(2), U16(1),
+			MFV_BYTECODE_LOAD32, U32(3), MFV_BYTECODE_LOAD32, U32(4),
+			MFV_BYTECODE_END,
+		};
+		mfmU32 results[2];
+		TEST_REQUIRE_PASS(Check(registerOverflow, sizeof(registerOverflow), MF_ERROR_OKAY, MFV_STATE_FINISHED, stack) == sizeof(results));
+		memcpy(results, stack, sizeof(results));
+		TEST_REQUIRE_PASS(results[0] == 0xFFFFFFFE && results[1] == 0x7FFFFFFE);
+	}
+
+	// Errors
+	{
+		const mfmU8 underflow[] = { MFV_BYTECODE_PUSH16, U16(1), MFV_BYTECODE_ADDU32, MFV_BYTECODE_END };
+		Check(underflow, sizeof(underflow), MFV_ERROR_STACK_UNDERFLOW, 0, NULL);
+
+		const mfmU8 outOfCode[] = { MFV_BYTECODE_PUSH8, 1 };
+		Check(outOfCode, sizeof(outOfCode), MFV_ERROR_INVALID_INSTRUCTION, 0, NULL);
+
+		const mfmU8 badJump[] = { MFV_BYTECODE_PUSH32, U32(1), MFV_BYTECODE_JUMP };
+		Check(badJump, sizeof(badJump), MFV_ERROR_INVALID_ADDRESS, 0, NULL);
+
+		const mfmU8 badCall[] = { MFV_BYTECODE_PUSH32, U32(100), MFV_BYTECODE_CALL };
+		Check(badCall, sizeof(badCall), MFV_ERROR_INVALID_ADDRESS, 0, NULL);
+
+		const mfmU8 undefined[] = { MFV_BYTECODE_PUSH16, U16(2), MFV_BYTECODE_CALL_BUILTIN, MFV_BYTECODE_END };
+		Check(undefined, sizeof(undefined), MFV_ERROR_FUNCTION_NOT_DEFINED, 0, NULL);
+
+		// Integer divisions by zero and divisions of the minimum value by -1
+		const mfmU8 divideByZero[] = { MFV_BYTECODE_PUSH32, U32(0), MFV_BYTECODE_PUSH32, U32(7), MFV_BYTECODE_DIVS32, MFV_BYTECODE_END };
+		Check(divideByZero, sizeof(divideByZero), MFV_ERROR_INVALID_DIVISION, 0, NULL);
+
+		const mfmU8 moduloByZero[] = { MFV_BYTECODE_PUSH8, 0, MFV_BYTECODE_PUSH8, 7, MFV_BYTECODE_MODU8, MFV_BYTECODE_END };
+		Check(moduloByZero, sizeof(moduloByZero), MFV_ERROR_INVALID_DIVISION, 0, NULL);
+
+		const mfmU8 divideOverflow[] = { MFV_BYTECODE_PUSH16, U16(-1), MFV_BYTECODE_PUSH16, U16(0x8000), MFV_BYTECODE_DIVS16, MFV_BYTECODE_END };
+		Check(divideOverflow, sizeof(divideOverflow), MFV_ERROR_INVALID_DIVISION, 0, NULL);
+
+		const mfmU8 registerDivideByZero[] =
+		{
+			V2_HEADER,
+			MFV_BYTECODE_SET_R, U16(0), U32(7), MFV_BYTECODE_SET_R, U16(1), U32(0),
+			MFV_BYTECODE_DIVU32_R, U16(2), U16(0), U16(1), MFV_BYTECODE_END,
+		};
+		Check(registerDivideByZero, sizeof(registerDivideByZero), MFV_ERROR_INVALID_DIVISION, 0, NULL);
+
+		const mfmU8 registerModuloOverflow[] =
+		{
+			V2_HEADER,
+			MFV_BYTECODE_SET_R, U16(0), U32(0x80000000), MFV_BYTECODE_SET_R, U16(1), U32(-1),
+			MFV_BYTECODE_MODS32_R, U16(2), U16(0), U16(1), MFV_BYTECODE_END,
+		};
+		Check(registerModuloOverflow, sizeof(registerModuloOverflow), MFV_ERROR_INVALID_DIVISION, 0, NULL);
+
+		// Translated into a register division
+		const mfmU8 translatedDivideByZero[] =
+		{
+			MFV_BYTECODE_PUSH32, U32(0), MFV_BYTECODE_STORE32, U32(0), MFV_BYTECODE_PUSH32, U32(5), MFV_BYTECODE_STORE32, U32(1),
+			MFV_BYTECODE_LOAD32, U32(0), MFV_BYTECODE_LOAD32, U32(1), MFV_BYTECODE_DIVS32, MFV_BYTECODE_STORE32, U32(2),
+			MFV_BYTECODE_END,
+		};
+		Check(translatedDivideByZero, sizeof(translatedDivideByZero), MFV_ERROR_INVALID_DIVISION, 0, NULL);
+
+		const mfmU8 ret[] = { MFV_BYTECODE_RETURN };
+		Check(ret, sizeof(ret), MFV_ERROR_CALL_STACK_UNDERFLOW, 0, NULL);
+
+		const mfmU8 error[] = { MFV_BYTECODE_PUSH8, '\0', MFV_BYTECODE_PUSH8, 'i', MFV_BYTECODE_PUSH8, 'H', MFV_BYTECODE_THROW_ERROR };
+		Check(error, sizeof(error), MFV_ERROR_ERROR_THROWN, 0, NULL);
+
+		mfvVirtualMachine* vm = CreateVM(error, sizeof(error));
+		const mfsUTF8CodeUnit* msg;
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, NULL, NULL, NULL) == MFV_ERROR_ERROR_THROWN);
+		TEST_REQUIRE_PASS(mfvVirtualMachineGetError(vm, &msg) == MF_ERROR_OKAY && strcmp(msg, u8"Hi") == 0);
+		mfvDestroyVirtualMachine(vm);
+
+		const mfmU8 warning[] = { MFV_BYTECODE_PUSH8, '\0', MFV_BYTECODE_PUSH8, 'o', MFV_BYTECODE_PUSH8, 'H', MFV_BYTECODE_THROW_WARNING, MFV_BYTECODE_END };
+		vm = CreateVM(warning, sizeof(warning));
+		TEST_REQUIRE_PASS(mfvVirtualMachineGetWarning(vm, &msg) == MF_ERROR_OKAY && strcmp(msg, u8"[No warning message]") == 0);
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, NULL, NULL, NULL) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfvVirtualMachineGetWarning(vm, &msg) == MF_ERROR_OKAY && strcmp(msg, u8"Ho") == 0);
+		mfvDestroyVirtualMachine(vm);
+
+		// Setting new code from inside a call drops the return addresses into the old code
+		const mfmU8 yieldInCall[] = { MFV_BYTECODE_PUSH32, U32(7), MFV_BYTECODE_CALL, MFV_BYTECODE_END, MFV_BYTECODE_YIELD, MFV_BYTECODE_RETURN };
+		mfvVirtualMachineState state;
+		vm = CreateVM(yieldInCall, sizeof(yieldInCall));
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, NULL, NULL, &state) == MF_ERROR_OKAY && state == MFV_STATE_YIELD);
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, ret, sizeof(ret)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, NULL, NULL, &state) == MFV_ERROR_CALL_STACK_UNDERFLOW);
+		mfvDestroyVirtualMachine(vm);
+	}
+
+	// Malformed code is rejected when it is set
+	{
+		mfvVirtualMachine* vm = CreateVM(NULL, 0);
+		const mfmU8 invalid[] = { MFV_BYTECODE_PUSH8, 1, 0xFF, MFV_BYTECODE_END };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, invalid, sizeof(invalid)) == MFV_ERROR_INVALID_INSTRUCTION);
+		const mfmU8 truncated[] = { MFV_BYTECODE_PUSH8, 1, MFV_BYTECODE_PUSH32, 0, 0 };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, truncated, sizeof(truncated)) == MFV_ERROR_INVALID_INSTRUCTION);
+		const mfmU8 outOfBounds[] = { MFV_BYTECODE_PUSH32, U32(1), MFV_BYTECODE_STORE32, U32(16), MFV_BYTECODE_END };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, outOfBounds, sizeof(outOfBounds)) == MFV_ERROR_REGISTER_OUT_OF_BOUNDS);
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, sum, 0) == MFV_ERROR_INVALID_ARGUMENTS);
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 3, sum, sizeof(sum)) == MFV_ERROR_INVALID_ADDRESS);
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, sizeof(sum), sum, sizeof(sum)) == MFV_ERROR_INVALID_ADDRESS);
+
+		// Version 2 instructions are only accepted after the version 2 header
+		const mfmU8 notV2[] = { MFV_BYTECODE_JUMP_TO, U32(0) };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, notV2, sizeof(notV2)) == MFV_ERROR_INVALID_INSTRUCTION);
+		const mfmU8 badHeader[] = { 0xFE, 0x03, 0x00, MFV_BYTECODE_END };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, badHeader, sizeof(badHeader)) == MFV_ERROR_INVALID_INSTRUCTION);
+		const mfmU8 badRegister[] = { V2_HEADER, MFV_BYTECODE_MOVE_R, U16(0), U16(16), MFV_BYTECODE_END };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, badRegister, sizeof(badRegister)) == MFV_ERROR_REGISTER_OUT_OF_BOUNDS);
+		const mfmU8 badAddress[] = { V2_HEADER, MFV_BYTECODE_JUMP_TO, U32(4), MFV_BYTECODE_END };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, badAddress, sizeof(badAddress)) == MFV_ERROR_INVALID_ADDRESS);
+		const mfmU8 headerAddress[] = { V2_HEADER, MFV_BYTECODE_JUMP_TO, U32(1), MFV_BYTECODE_END };
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, 0, headerAddress, sizeof(headerAddress)) == MFV_ERROR_INVALID_ADDRESS);
+
+		// The code can start anywhere (here, on the last 2 instructions)
+		mfmU64 executed;
+		mfmU32 value;
+		TEST_REQUIRE_PASS(mfvSetVirtualMachineCode(vm, sizeof(sum) - 6, sum, sizeof(sum)) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfvRunVirtualMachine(vm, NULL, &executed, NULL) == MF_ERROR_OKAY && executed == 2);
+		TEST_REQUIRE_PASS(mfvVirtualMachinePop32(vm, &value) == MF_ERROR_OKAY);
+		mfvDestroyVirtualMachine(vm);
+	}
+
+	mfTerminate();
+	EXIT_PASS();
+}
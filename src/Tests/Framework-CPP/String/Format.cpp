@@ -0,0 +1,95 @@
+#include "../../Test.h"
+
+#include <Magma/Framework/String/StringStream.hpp>
+
+#include <cstring>
+
+using namespace Magma::Framework;
+
+static mfmU64 writeCount = 0;
+static mfsStreamWriteFunction stringStreamWrite = NULL;
+
+static mfError CountingWrite(void* stream, const mfmU8* data, mfmU64 dataSize, mfmU64* outSize)
+{
+	++writeCount;
+	return stringStreamWrite(stream, data, dataSize, outSize);
+}
+
+int main()
+{
+	mfmU8 buffer[4096];
+	mfsStringStream ss;
+	TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&ss, buffer, sizeof(buffer)) == MF_ERROR_OKAY);
+	TEST_REQUIRE_PASS(mfmAcquireObject(&ss.base.object) == MF_ERROR_OKAY);
+	stringStreamWrite = ss.base.write;
+	ss.base.write = &CountingWrite;
+
+	String::HStream stream = &ss;
+	auto printed = [&](const mfsUTF8CodeUnit* expected)
+	{
+		bool equal = ss.head == strlen(expected) && memcmp(buffer, expected, ss.head) == 0;
+		ss.head = 0;
+		writeCount = 0;
+		return equal;
+	};
+
+	// The whole formatted string is written at once
+	stream.PrintFormat(MFS_FORMAT(u8"%d %s %%-bhul %%-d2f \\%c%c"), -12, u8"abc", (mfmU64)0xFF, 2.5, 'x');
+	TEST_REQUIRE_PASS(writeCount == 1);
+	TEST_REQUIRE_PASS(printed(u8"-12 abc ff 2.50 %cx"));
+
+	// Every type, with implicit widening of smaller integers and floats
+	stream.PrintFormat(MFS_FORMAT(u8"%%u %%ul %%i %%il %%-d1f %%f %%c %%s"),
+					   (mfmU8)200, (mfmU32)4000000000, (mfmI16)-300, (mfmI64)-1099511627776, 1.25f, 0.5, 'y', u8"end");
+	TEST_REQUIRE_PASS(printed(u8"200 4000000000 -300 -1099511627776 1.3 0.5000 y end"));
+
+	// Bases
+	stream.PrintFormat(MFS_FORMAT(u8"%%-bbu %%-bfu %%-bou %%-bdu %%-bhu %x"), 5u, 5u, 8u, 10u, 255u, 255);
+	TEST_REQUIRE_PASS(printed(u8"101 11 10 10 ff ff"));
+
+	// Escaped characters and a format without arguments
+	stream.PrintFormat(MFS_FORMAT(u8"100\\% \\\\ done"));
+	TEST_REQUIRE_PASS(printed(u8"100% \\ done"));
+
+	// Same output as mfsPrintFormat
+	{
+		mfsUTF8CodeUnit expected[256];
+		mfsStringStream expectedSS;
+		TEST_REQUIRE_PASS(mfsCreateLocalStringStream(&expectedSS, reinterpret_cast<mfmU8*>(expected), sizeof(expected) - 1) == MF_ERROR_OKAY);
+		TEST_REQUIRE_PASS(mfsPrintFormat(reinterpret_cast<mfsStream*>(&expectedSS), u8"[%%-bhp] [%%p]", &ss, &ss) == MF_ERROR_OKAY);
+		expected[expectedSS.head] = '\0';
+		mfsDestroyLocalStringStream(&expectedSS);
+
+		stream.PrintFormat(MFS_FORMAT(u8"[%%-bhp] [%%p]"), &ss, &ss);
+		TEST_REQUIRE_PASS(printed(expected));
+	}
+
+	// Output larger than the format buffer
+	{
+		mfsUTF8CodeUnit large[1500];
+		memset(large, 'a', sizeof(large) - 1);
+		large[sizeof(large) - 1] = '\0';
+		for (mfmU64 i = 0; i < 100; ++i)
+			stream.PrintFormat(MFS_FORMAT(u8"%%-d2f;"), 1.0 / 3.0);
+		for (mfmU64 i = 0; i < 2; ++i)
+			stream.PrintFormat(MFS_FORMAT(u8"<%%s>"), large);
+		TEST_REQUIRE_PASS(ss.head == 100 * 5 + 2 * (sizeof(large) + 1));
+		TEST_REQUIRE_PASS(memcmp(buffer + 495, u8"0.33;<aaa", 9) == 0);
+		TEST_REQUIRE_PASS(memcmp(buffer + ss.head - 4, u8"aaa>", 4) == 0);
+		ss.head = 0;
+	}
+
+	// The stream fails when it is full
+	{
+		static mfsUTF8CodeUnit large[5000];
+		memset(large, 'a', sizeof(large) - 1);
+		TEST_REQUIRE_FAIL((stream.PrintFormat(MFS_FORMAT(u8"%%s"), large), true));
+		TEST_REQUIRE_PASS(ss.head == sizeof(buffer));
+	}
+
+	stream.Release();
+	mfmReleaseObject(&ss.base.object);
+	mfsDestroyLocalStringStream(&ss);
+
+	EXIT_PASS();
+}
@@ -0,0 +1,118 @@
+#include <Magma/Framework/File/FolderArchive.h>
+#include <Magma/Framework/File/PackedArchive.h>
+#include <Magma/Framework/String/StringStream.h>
+#include <Magma/Framework/ErrorString.h>
+#include <Magma/Framework/Entry.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+	Packs a folder into a single packed archive file, which can then be loaded with mffCreatePackedArchive.
+	Usage: Magma-Packer <source folder> <output file> [-deflate | -lz]
+	-deflate compresses the files with DEFLATE, and -lz with the faster to decompress LZ codec.
+*/
+
+static int Fail(const char* message, mfError err)
+{
+	const mfsUTF8CodeUnit* errorString = mfErrorToString(err);
+	fprintf(stderr, "%s: %s\n", message, errorString != NULL ? errorString : u8"Unknown error");
+	mfTerminate();
+	return 1;
+}
+
+int main(int argc, const char** argv)
+{
+	mffEnum flags = 0;
+	if (argc == 4 && strcmp(argv[3], "-deflate") == 0)
+		flags = MFF_PACKED_ARCHIVE_DEFLATE;
+	else if (argc == 4 && strcmp(argv[3], "-lz") == 0)
+		flags = MFF_PACKED_ARCHIVE_LZ;
+	else if (argc != 3)
+	{
+		fprintf(stderr, "Usage: %s <source folder> <output file> [-deflate | -lz]\n", argv[0]);
+		return 1;
+	}
+
+	mfError err = mfInit(argc, argv);
+	if (err != MF_ERROR_OKAY)
+	{
+		fprintf(stderr, "Failed to init the framework\n");
+		return 1;
+	}
+
+	// Split the output path into the folder where the file is written and its name
+	mfsUTF8CodeUnit outputFolder[MFF_MAX_FILE_PATH_SIZE];
+	mfsUTF8CodeUnit outputName[MFF_MAX_FILE_PATH_SIZE];
+	{
+		const mfsUTF8CodeUnit* separator = NULL;
+		for (const mfsUTF8CodeUnit* it = argv[2]; *it != '\0'; ++it)
+			if (*it == '/' || *it == '\\')
+				separator = it;
+
+		mfsStringStream ss;
+		err = mfsCreateLocalStringStream(&ss, outputFolder, sizeof(outputFolder));
+		if (err == MF_ERROR_OKAY)
+		{
+			if (separator == NULL)
+				err = mfsPutString(&ss, u8".");
+			else if (separator == argv[2])
+				err = mfsPutString(&ss, u8"/");
+			else
+				err = mfsWrite(&ss, (const mfmU8*)argv[2], separator - argv[2], NULL);
+			mfsDestroyLocalStringStream(&ss);
+		}
+		if (err != MF_ERROR_OKAY)
+			return Fail("Output path is too big", err);
+
+		err = mfsCreateLocalStringStream(&ss, outputName, sizeof(outputName));
+		if (err == MF_ERROR_OKAY)
+		{
+			err = mfsPrintFormat(&ss, u8"/%s", separator == NULL ? argv[2] : separator + 1);
+			mfsDestroyLocalStringStream(&ss);
+		}
+		if (err != MF_ERROR_OKAY)
+			return Fail("Output path is too big", err);
+	}
+
+	mffArchive* source;
+	err = mffCreateFolderArchive(&source, NULL, argv[1]);
+	if (err != MF_ERROR_OKAY)
+		return Fail("Failed to open the source folder", err);
+
+	mffArchive* output;
+	err = mffCreateFolderArchive(&output, NULL, outputFolder);
+	if (err != MF_ERROR_OKAY)
+	{
+		mffDestroyFolderArchive(source);
+		return Fail("Failed to open the output folder", err);
+	}
+
+	// Replace the output file if it already exists
+	mffFile* file;
+	err = output->getFile(output, &file, outputName);
+	if (err == MF_ERROR_OKAY)
+		err = output->deleteFile(output, file);
+	else if (err == MFF_ERROR_FILE_NOT_FOUND)
+		err = MF_ERROR_OKAY;
+	if (err == MF_ERROR_OKAY)
+		err = output->createFile(output, &file, outputName);
+
+	mfsStream* stream = NULL;
+	if (err == MF_ERROR_OKAY)
+		err = output->openFile(output, &stream, file, MFF_FILE_WRITE);
+	if (err == MF_ERROR_OKAY)
+	{
+		err = mffWritePackedArchive(stream, source, flags, NULL);
+		mffCloseFile(stream);
+	}
+
+	mffDestroyFolderArchive(output);
+	mffDestroyFolderArchive(source);
+
+	if (err != MF_ERROR_OKAY)
+		return Fail("Failed to write the packed archive", err);
+
+	mfTerminate();
+	return 0;
+}